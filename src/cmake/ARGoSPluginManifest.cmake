@@ -0,0 +1,20 @@
+#
+# Writes and installs the manifest of a plugin library.
+#
+# The manifest lists the labels the library registers in the factories
+# (entities, sensors, actuators, physics engines, media, visualizations,
+# ...). When an experiment is loaded, ARGoS loads only the libraries
+# whose manifest lists a label used in the .argos file. Libraries without
+# a manifest are always loaded.
+#
+# Usage: argos3_plugin_manifest(TARGET)
+#
+function(argos3_plugin_manifest TARGET)
+  if(ARGOS_BUILD_FOR_SIMULATOR)
+    add_dependencies(${TARGET} argos3_plugin_manifest)
+    add_custom_command(TARGET ${TARGET} POST_BUILD
+      COMMAND argos3_plugin_manifest $<TARGET_FILE:${TARGET}>
+      COMMENT "Writing the manifest of ${TARGET}")
+    install(FILES $<TARGET_FILE:${TARGET}>.manifest DESTINATION lib/argos3)
+  endif(ARGOS_BUILD_FOR_SIMULATOR)
+endfunction(argos3_plugin_manifest)
@@ -12,6 +12,7 @@ namespace argos {
 }
 
 #include <argos3/core/utility/configuration/base_configurable_resource.h>
+#include <argos3/core/utility/configuration/memento.h>
 #include <argos3/core/utility/datatypes/datatypes.h>
 #include <argos3/core/control_interface/ci_sensor.h>
 #include <argos3/core/control_interface/ci_actuator.h>
@@ -27,7 +28,8 @@ namespace argos {
    /**
     * The basic interface for a robot controller.
     */
-   class CCI_Controller : public CBaseConfigurableResource {
+   class CCI_Controller : public CBaseConfigurableResource,
+                          public CMemento {
 
    public:
 
@@ -71,6 +73,26 @@ namespace argos {
        */
       virtual void Destroy() {}
 
+      /**
+       * Saves the state of the controller.
+       * This method is called when a checkpoint of the simulation is taken. Override it,
+       * along with LoadState(), if your controller has a state that must survive a restore.
+       * The default implementation of this method does nothing.
+       * @param c_buffer The target buffer.
+       * @see LoadState()
+       */
+      virtual void SaveState(CByteArray& c_buffer) {}
+
+      /**
+       * Restores the state of the controller.
+       * This method is called when a simulation is restored from a checkpoint, after Init().
+       * It must read exactly the data written by SaveState().
+       * The default implementation of this method does nothing.
+       * @param c_buffer The source buffer.
+       * @see SaveState()
+       */
+      virtual void LoadState(CByteArray& c_buffer) {}
+
       /**
        * Returns the id of the robot associated to this controller.
        * @return The id of the robot associated to this controller.
@@ -12,6 +12,7 @@ namespace argos {
 }
 
 #include <argos3/core/utility/plugins/factory.h>
+#include <argos3/core/utility/configuration/memento.h>
 
 namespace argos {
 
@@ -21,7 +22,7 @@ namespace argos {
     * that inherits from both the control interface and this class.
     * @see CCI_Actuator
     */
-   class CSimulatedActuator {
+   class CSimulatedActuator : public CMemento {
 
    public:
 
@@ -47,6 +48,22 @@ namespace argos {
        */
       virtual void Update() = 0;
 
+      /**
+       * Saves the state of the actuator.
+       * The commands received in the last control step are applied to the entity
+       * at the beginning of the next step, so they must be saved in a checkpoint.
+       * The default implementation of this method does nothing.
+       * @param c_buffer The target buffer.
+       */
+      virtual void SaveState(CByteArray& c_buffer) {}
+
+      /**
+       * Restores the state of the actuator.
+       * The default implementation of this method does nothing.
+       * @param c_buffer The source buffer.
+       */
+      virtual void LoadState(CByteArray& c_buffer) {}
+
    };
 
 }
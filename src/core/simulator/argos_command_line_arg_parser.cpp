@@ -6,6 +6,8 @@
 
 #include "argos_command_line_arg_parser.h"
 #include <argos3/core/config.h>
+#include <algorithm>
+#include <thread>
 
 namespace argos {
 
@@ -15,7 +17,10 @@ namespace argos {
    CARGoSCommandLineArgParser::CARGoSCommandLineArgParser() :
       m_eAction(ACTION_UNKNOWN),
       m_pcInitLogStream(nullptr),
-      m_pcInitLogErrStream(nullptr) {
+      m_pcInitLogErrStream(nullptr),
+      m_unCheckpointClock(0),
+      m_strCheckpointFile("argos3.checkpoint"),
+      m_unBatchJobs(std::max(1u, std::thread::hardware_concurrency())) {
       AddFlag(
          'h',
          "help",
@@ -64,6 +69,42 @@ namespace argos {
          "output logerr to file [OPTIONAL]",
          m_strLogErrFileName
          );
+      AddArgument<UInt32>(
+         'k',
+         "checkpoint-at",
+         "save a checkpoint at the given step [OPTIONAL]",
+         m_unCheckpointClock
+         );
+      AddArgument<std::string>(
+         'K',
+         "checkpoint-file",
+         "the file to save the checkpoint to [OPTIONAL]",
+         m_strCheckpointFile
+         );
+      AddArgument<std::string>(
+         'r',
+         "restore",
+         "restore the experiment from a checkpoint [OPTIONAL]",
+         m_strRestoreFile
+         );
+      AddArgument<std::string>(
+         'b',
+         "batch",
+         "run the jobs listed in the given sweep file",
+         m_strBatchFile
+         );
+      AddArgument<UInt32>(
+         'j',
+         "jobs",
+         "the maximum number of batch jobs running at the same time [OPTIONAL]",
+         m_unBatchJobs
+         );
+      AddArgument<std::string>(
+         'o',
+         "batch-summary",
+         "the file to write the batch summary to [OPTIONAL]",
+         m_strBatchSummaryFile
+         );
    }
 
    /****************************************/
@@ -120,17 +161,24 @@ namespace argos {
       }
 
 
-      /* Check that either -h, -v, -c or -q was passed (strictly one of them) */
+      /* Check that either -h, -v, -c, -q or -b was passed (strictly one of them) */
       UInt32 nOptionsOn = 0;
       if(m_strExperimentConfigFile != "") ++nOptionsOn;
       if(m_strQuery != "") ++nOptionsOn;
+      if(m_strBatchFile != "") ++nOptionsOn;
       if(m_bHelpWanted) ++nOptionsOn;
       if(m_bVersionWanted) ++nOptionsOn;
       if(nOptionsOn == 0) {
-         THROW_ARGOSEXCEPTION("No --help, --version, --config-file or --query options specified.");
+         THROW_ARGOSEXCEPTION("No --help, --version, --config-file, --query or --batch options specified.");
       }
       if(nOptionsOn > 1) {
-         THROW_ARGOSEXCEPTION("Options --help, --version, --config-file and --query are mutually exclusive.");
+         THROW_ARGOSEXCEPTION("Options --help, --version, --config-file, --query and --batch are mutually exclusive.");
+      }
+
+      /* Checkpoints make sense only when running an experiment */
+      if((m_unCheckpointClock > 0 || m_strRestoreFile != "") &&
+         m_strExperimentConfigFile == "") {
+         THROW_ARGOSEXCEPTION("Options --checkpoint-at and --restore require --config-file.");
       }
 
       if(m_strExperimentConfigFile != "") {
@@ -141,6 +189,13 @@ namespace argos {
          m_eAction = ACTION_QUERY;
       }
 
+      if(m_strBatchFile != "") {
+         m_eAction = ACTION_RUN_BATCH;
+         if(m_strBatchSummaryFile == "") {
+            m_strBatchSummaryFile = m_strBatchFile + ".summary";
+         }
+      }
+
       if(m_bHelpWanted) {
          m_eAction = ACTION_SHOW_HELP;
       }
@@ -167,13 +222,44 @@ namespace argos {
       c_log << "   -n       | --no-color              do not use colored output [OPTIONAL]" << std::endl;
       c_log << "   -l       | --log-file FILE         redirect LOG to FILE [OPTIONAL]" << std::endl;
       c_log << "   -e       | --logerr-file FILE      redirect LOGERR to FILE [OPTIONAL]" << std::endl;
-      c_log << "   -z       | --no-visualization      ignore the <visualization> tag [OPTIONAL]" << std::endl << std::endl;
-      c_log << "The options --config-file and --query are mutually exclusive. Either you use" << std::endl;
-      c_log << "the first, and thus you run an experiment, or you use the second to query the" << std::endl;
-      c_log << "plugins." << std::endl << std::endl;
+      c_log << "   -z       | --no-visualization      ignore the <visualization> tag [OPTIONAL]" << std::endl;
+      c_log << "   -k STEP  | --checkpoint-at STEP    save a checkpoint at STEP [OPTIONAL]" << std::endl;
+      c_log << "   -K FILE  | --checkpoint-file FILE  save the checkpoint to FILE [OPTIONAL]" << std::endl;
+      c_log << "                                      (default: argos3.checkpoint)" << std::endl;
+      c_log << "   -r FILE  | --restore FILE          restore the experiment from FILE [OPTIONAL]" << std::endl;
+      c_log << "   -b FILE  | --batch FILE            run the jobs listed in the sweep FILE" << std::endl;
+      c_log << "   -j N     | --jobs N                run at most N batch jobs at a time [OPTIONAL]" << std::endl;
+      c_log << "                                      (default: number of processors)" << std::endl;
+      c_log << "   -o FILE  | --batch-summary FILE    write the batch summary to FILE [OPTIONAL]" << std::endl;
+      c_log << "                                      (default: the sweep file name + .summary)" << std::endl << std::endl;
+      c_log << "The options --config-file, --query and --batch are mutually exclusive. Either" << std::endl;
+      c_log << "you use the first, and thus you run an experiment, or the second to query the" << std::endl;
+      c_log << "plugins, or the third to run a batch of experiments." << std::endl << std::endl;
       c_log << "EXAMPLES" << std::endl << std::endl;
       c_log << "To run an experiment, type:" << std::endl << std::endl;
       c_log << "   argos3 -c /path/to/myconfig.argos" << std::endl << std::endl;
+      c_log << "To save a checkpoint at step 1000 and resume the experiment from it later, type:" << std::endl << std::endl;
+      c_log << "   argos3 -c /path/to/myconfig.argos --checkpoint-at 1000 --checkpoint-file run.ckp" << std::endl;
+      c_log << "   argos3 -c /path/to/myconfig.argos --restore run.ckp" << std::endl << std::endl;
+      c_log << "The experiment must be restored with the configuration file it was saved with." << std::endl << std::endl;
+      c_log << "To run a batch of experiments on 8 processors, type:" << std::endl << std::endl;
+      c_log << "   argos3 --batch sweep.txt -j 8" << std::endl << std::endl;
+      c_log << "Each line of the sweep file is a job: a configuration file followed by" << std::endl;
+      c_log << "attribute overrides in the form path@attribute=value, for instance:" << std::endl << std::endl;
+      c_log << "   myconfig.argos framework/experiment@random_seed=3 arena/distribute[2]/entity@quantity=20" << std::endl << std::endl;
+      c_log << "A line per job is appended to the summary file as soon as the job is over." << std::endl << std::endl;
+      c_log << "LOGGING" << std::endl << std::endl;
+      c_log << "The logs are configured in the <system> tag of the experiment file:" << std::endl << std::endl;
+      c_log << "   <framework>" << std::endl;
+      c_log << "     <system log_level=\"all\" log_sampling_period=\"10\" async_log=\"true\" />" << std::endl;
+      c_log << "     ..." << std::endl;
+      c_log << "   </framework>" << std::endl << std::endl;
+      c_log << "   log_level            \"all\" (the default) shows LOG and LOGERR; \"errors\" and" << std::endl;
+      c_log << "                        \"none\" hide LOG. LOGERR is always shown" << std::endl;
+      c_log << "   log_sampling_period  during the steps, keep the LOG messages of one step" << std::endl;
+      c_log << "                        every this many (default: 1, i.e., all). The messages" << std::endl;
+      c_log << "                        sent outside the steps are always kept" << std::endl;
+      c_log << "   async_log            write the logs from a separate thread (default: false)" << std::endl << std::endl;
       c_log << "To query the plugins, type:" << std::endl << std::endl;
       c_log << "   argos3 -q QUERY" << std::endl << std::endl;
       c_log << "where QUERY can have the following values:" << std::endl << std::endl;
@@ -34,7 +34,8 @@ namespace argos {
          ACTION_SHOW_HELP,
          ACTION_SHOW_VERSION,
          ACTION_RUN_EXPERIMENT,
-         ACTION_QUERY
+         ACTION_QUERY,
+         ACTION_RUN_BATCH
       };
 
    public:
@@ -136,6 +137,58 @@ namespace argos {
          return m_bForceNoViz;
       }
 
+      /**
+       * Returns the simulation clock at which a checkpoint must be saved.
+       * The returned value is 0 if no checkpoint was requested.
+       * @see GetCheckpointFile()
+       */
+      inline UInt32 GetCheckpointClock() {
+         return m_unCheckpointClock;
+      }
+
+      /**
+       * Returns the name of the file to save the checkpoint to.
+       * @see GetCheckpointClock()
+       */
+      inline const std::string& GetCheckpointFile() {
+         return m_strCheckpointFile;
+      }
+
+      /**
+       * Returns the name of the checkpoint file to restore the experiment from.
+       * The returned value is empty if no restore was requested.
+       */
+      inline const std::string& GetRestoreFile() {
+         return m_strRestoreFile;
+      }
+
+      /**
+       * Returns the sweep file listing the jobs of a batch as parsed by Parse().
+       * The returned value is meaningful only if GetAction() returns ACTION_RUN_BATCH.
+       * @see CBatchRunner
+       */
+      inline const std::string& GetBatchFile() {
+         return m_strBatchFile;
+      }
+
+      /**
+       * Returns the maximum number of batch jobs running at the same time.
+       * By default, it is the number of available processors.
+       * @see CBatchRunner
+       */
+      inline UInt32 GetBatchJobs() {
+         return m_unBatchJobs;
+      }
+
+      /**
+       * Returns the file the batch summary is written to.
+       * By default, it is the sweep file name followed by <tt>.summary</tt>.
+       * @see CBatchRunner
+       */
+      inline const std::string& GetBatchSummaryFile() {
+         return m_strBatchSummaryFile;
+      }
+
    private:
 
       EAction m_eAction;
@@ -151,6 +204,12 @@ namespace argos {
       bool m_bHelpWanted;
       bool m_bVersionWanted;
       bool m_bForceNoViz;
+      UInt32 m_unCheckpointClock;
+      std::string m_strCheckpointFile;
+      std::string m_strRestoreFile;
+      std::string m_strBatchFile;
+      UInt32 m_unBatchJobs;
+      std::string m_strBatchSummaryFile;
 
    };
 
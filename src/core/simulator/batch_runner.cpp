@@ -0,0 +1,374 @@
+/**
+ * @file <argos3/core/simulator/batch_runner.cpp>
+ */
+
+#include "batch_runner.h"
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/simulator/loop_functions.h>
+#include <argos3/core/utility/logging/argos_log.h>
+#include <argos3/core/utility/string_utilities.h>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <poll.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   /*
+    * Replaces the characters that would break the summary file format.
+    */
+   static std::string SanitizeField(const std::string& str_field) {
+      std::string strResult(str_field);
+      for(size_t i = 0; i < strResult.size(); ++i) {
+         if(strResult[i] == '\t' || strResult[i] == '\n' || strResult[i] == '\r') {
+            strResult[i] = ' ';
+         }
+      }
+      return strResult;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   /*
+    * Removes the <visualization> section, as jobs never open a window.
+    */
+   static void RemoveVisualization(TConfigurationNode& t_root) {
+      ticpp::Element* ptVisualization = t_root.FirstChildElement("visualization", false);
+      if(ptVisualization != nullptr) {
+         t_root.RemoveChild(ptVisualization);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   static Real SecondsSince(const std::chrono::steady_clock::time_point& t_start) {
+      return std::chrono::duration<Real>(std::chrono::steady_clock::now() - t_start).count();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CBatchRunner::CBatchRunner(const std::string& str_sweep_file,
+                              UInt32 un_workers,
+                              const std::string& str_summary_file) :
+      m_unWorkers(un_workers > 0 ? un_workers : 1),
+      m_strSummaryFile(str_summary_file) {
+      std::ifstream cSweep(str_sweep_file.c_str());
+      if(!cSweep) {
+         THROW_ARGOSEXCEPTION("Error opening sweep file \"" << str_sweep_file << "\"");
+      }
+      std::string strLine;
+      UInt32 unLine = 0;
+      while(std::getline(cSweep, strLine)) {
+         ++unLine;
+         /* Skip empty lines and comments */
+         size_t unStart = strLine.find_first_not_of(" \t\r");
+         if(unStart == std::string::npos || strLine[unStart] == '#') continue;
+         strLine = strLine.substr(unStart, strLine.find_last_not_of(" \t\r") - unStart + 1);
+         try {
+            m_vecJobs.push_back(SJob());
+            ParseJob(strLine, m_vecJobs.back());
+         }
+         catch(CARGoSException& ex) {
+            THROW_ARGOSEXCEPTION_NESTED("Error parsing line " << unLine << " of sweep file \"" << str_sweep_file << "\"", ex);
+         }
+      }
+      if(m_vecJobs.empty()) {
+         THROW_ARGOSEXCEPTION("Sweep file \"" << str_sweep_file << "\" contains no jobs");
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CBatchRunner::ParseJob(const std::string& str_line,
+                               SJob& s_job) {
+      s_job.Line = str_line;
+      s_job.Overrides.clear();
+      std::istringstream cTokens(str_line);
+      cTokens >> s_job.ConfigFile;
+      std::string strToken;
+      while(cTokens >> strToken) {
+         /* Split path@attribute=value */
+         size_t unAt = strToken.find('@');
+         size_t unEq = strToken.find('=', unAt);
+         if(unAt == std::string::npos || unEq == std::string::npos ||
+            unAt == 0 || unEq == unAt + 1) {
+            THROW_ARGOSEXCEPTION("Override \"" << strToken << "\" is not in the form path@attribute=value");
+         }
+         SOverride sOverride;
+         sOverride.Attribute = strToken.substr(unAt + 1, unEq - unAt - 1);
+         sOverride.Value = strToken.substr(unEq + 1);
+         /* Parse the path */
+         std::vector<std::string> vecElements;
+         Tokenize(strToken.substr(0, unAt), vecElements, "/");
+         for(size_t i = 0; i < vecElements.size(); ++i) {
+            std::string strName = vecElements[i];
+            UInt32 unIndex = 1;
+            size_t unBracket = strName.find('[');
+            if(unBracket != std::string::npos) {
+               if(strName.back() != ']') {
+                  THROW_ARGOSEXCEPTION("Malformed element \"" << strName << "\" in override \"" << strToken << "\"");
+               }
+               unIndex = FromString<UInt32>(strName.substr(unBracket + 1, strName.size() - unBracket - 2));
+               if(unIndex == 0) {
+                  THROW_ARGOSEXCEPTION("Element indices start from 1 in override \"" << strToken << "\"");
+               }
+               strName = strName.substr(0, unBracket);
+            }
+            sOverride.Path.push_back(std::make_pair(strName, unIndex));
+         }
+         s_job.Overrides.push_back(sOverride);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CBatchRunner::ApplyOverrides(TConfigurationNode& t_root,
+                                     const std::vector<SOverride>& vec_overrides) {
+      for(size_t i = 0; i < vec_overrides.size(); ++i) {
+         const SOverride& sOverride = vec_overrides[i];
+         TConfigurationNode* ptNode = &t_root;
+         for(size_t j = 0; j < sOverride.Path.size(); ++j) {
+            TConfigurationNodeIterator itChild(sOverride.Path[j].first);
+            UInt32 unIndex = 1;
+            for(itChild = itChild.begin(ptNode);
+                itChild != itChild.end() && unIndex < sOverride.Path[j].second;
+                ++itChild, ++unIndex);
+            if(itChild == itChild.end()) {
+               THROW_ARGOSEXCEPTION("Element \"" << sOverride.Path[j].first << "[" << sOverride.Path[j].second <<
+                                    "]\" not found while applying override of attribute \"" << sOverride.Attribute << "\"");
+            }
+            ptNode = &(*itChild);
+         }
+         SetNodeAttribute(*ptNode, sOverride.Attribute, sOverride.Value);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CBatchRunner::LoadLibraries() {
+      std::set<std::string> setConfigFiles;
+      for(size_t i = 0; i < m_vecJobs.size(); ++i) {
+         if(setConfigFiles.insert(m_vecJobs[i].ConfigFile).second) {
+            /* A configuration that can't be loaded makes its jobs fail, not the batch */
+            try {
+               ticpp::Document tConfiguration;
+               tConfiguration.LoadFile(m_vecJobs[i].ConfigFile);
+               TConfigurationNode& tRoot = *tConfiguration.FirstChildElement();
+               RemoveVisualization(tRoot);
+               CSimulator::GetInstance().LoadPlugins(tRoot);
+            }
+            catch(std::exception& ex) {
+               LOGERR << "[WARNING] Can't load the libraries of \"" << m_vecJobs[i].ConfigFile
+                      << "\": " << ex.what() << std::endl;
+            }
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CBatchRunner::RunJob(const SJob& s_job,
+                             int n_report_fd) {
+      std::ostringstream cReport;
+      int nExitCode = 0;
+      try {
+         /* Prepare the configuration */
+         ticpp::Document tConfiguration;
+         tConfiguration.LoadFile(s_job.ConfigFile);
+         TConfigurationNode& tRoot = *tConfiguration.FirstChildElement();
+         ApplyOverrides(tRoot, s_job.Overrides);
+         RemoveVisualization(tRoot);
+         /* Run the experiment */
+         CSimulator& cSimulator = CSimulator::GetInstance();
+         std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+         cSimulator.SetExperimentFileName(s_job.ConfigFile);
+         cSimulator.SetBatchJob(true);
+         cSimulator.Load(tConfiguration);
+         Real fInitTime = SecondsSince(tStart);
+         tStart = std::chrono::steady_clock::now();
+         cSimulator.Execute();
+         Real fRunTime = SecondsSince(tStart);
+         cReport << "OK\t"
+                 << cSimulator.GetSpace().GetSimulationClock() << '\t'
+                 << fInitTime << '\t'
+                 << fRunTime << '\t'
+                 << SanitizeField(cSimulator.GetLoopFunctions().GetResult());
+         cSimulator.Destroy();
+      }
+      catch(std::exception& ex) {
+         cReport.str("");
+         cReport << "ERROR\t" << SanitizeField(ex.what());
+         nExitCode = 1;
+      }
+      /* Send the report to the runner */
+      std::string strReport = cReport.str();
+      size_t unWritten = 0;
+      while(unWritten < strReport.size()) {
+         ssize_t nRet = ::write(n_report_fd, strReport.data() + unWritten, strReport.size() - unWritten);
+         if(nRet < 0) {
+            if(errno == EINTR) continue;
+            break;
+         }
+         unWritten += nRet;
+      }
+      ::close(n_report_fd);
+      LOG.Flush();
+      LOGERR.Flush();
+      /* Don't run the destructors of the runner's objects */
+      ::_exit(nExitCode);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   UInt32 CBatchRunner::Run() {
+      /* Open the summary file */
+      std::ofstream cSummary(m_strSummaryFile.c_str(), std::ios::out | std::ios::trunc);
+      if(!cSummary) {
+         THROW_ARGOSEXCEPTION("Error opening summary file \"" << m_strSummaryFile << "\"");
+      }
+      cSummary << "# job\tstatus\tsteps\tinit_time\trun_time\twall_time\tresult\tjob_line" << std::endl;
+      /* Load the libraries once, so that the workers inherit them */
+      LoadLibraries();
+      LOG << "[INFO] Running " << m_vecJobs.size() << " jobs with up to "
+          << m_unWorkers << " workers" << std::endl;
+      LOG.Flush();
+      LOGERR.Flush();
+      /* The running workers */
+      struct SWorker {
+         pid_t Pid;
+         int Fd;
+         size_t Job;
+         std::string Report;
+         std::chrono::steady_clock::time_point Start;
+      };
+      std::vector<SWorker> vecWorkers;
+      std::vector<pollfd> vecPollFds;
+      size_t unNextJob = 0;
+      UInt32 unFailed = 0;
+      char pchBuffer[4096];
+      try {
+         while(unNextJob < m_vecJobs.size() || !vecWorkers.empty()) {
+            /* Start as many workers as allowed */
+            while(vecWorkers.size() < m_unWorkers && unNextJob < m_vecJobs.size()) {
+               int pnFds[2];
+               if(::pipe(pnFds) != 0) {
+                  THROW_ARGOSEXCEPTION("Error creating pipe for batch job: " << ::strerror(errno));
+               }
+               pid_t tPid = ::fork();
+               if(tPid < 0) {
+                  int nError = errno;
+                  ::close(pnFds[0]);
+                  ::close(pnFds[1]);
+                  THROW_ARGOSEXCEPTION("Error forking batch worker: " << ::strerror(nError));
+               }
+               if(tPid == 0) {
+                  /* Worker: the read ends of the other workers are not needed */
+                  ::close(pnFds[0]);
+                  for(size_t i = 0; i < vecWorkers.size(); ++i) {
+                     ::close(vecWorkers[i].Fd);
+                  }
+                  RunJob(m_vecJobs[unNextJob], pnFds[1]);
+               }
+               ::close(pnFds[1]);
+               SWorker sWorker;
+               sWorker.Pid = tPid;
+               sWorker.Fd = pnFds[0];
+               sWorker.Job = unNextJob;
+               sWorker.Start = std::chrono::steady_clock::now();
+               vecWorkers.push_back(sWorker);
+               ++unNextJob;
+            }
+            /* Wait for the reports */
+            vecPollFds.resize(vecWorkers.size());
+            for(size_t i = 0; i < vecWorkers.size(); ++i) {
+               vecPollFds[i].fd = vecWorkers[i].Fd;
+               vecPollFds[i].events = POLLIN;
+               vecPollFds[i].revents = 0;
+            }
+            if(::poll(vecPollFds.data(), vecPollFds.size(), -1) < 0) {
+               if(errno == EINTR) continue;
+               THROW_ARGOSEXCEPTION("Error waiting for batch workers: " << ::strerror(errno));
+            }
+            for(size_t i = vecWorkers.size(); i > 0; --i) {
+               SWorker& sWorker = vecWorkers[i-1];
+               if(vecPollFds[i-1].revents == 0) continue;
+               ssize_t nRead = ::read(sWorker.Fd, pchBuffer, sizeof(pchBuffer));
+               if(nRead > 0) {
+                  sWorker.Report.append(pchBuffer, nRead);
+                  continue;
+               }
+               if(nRead < 0 && errno == EINTR) continue;
+               /* The worker closed its end: collect it */
+               ::close(sWorker.Fd);
+               int nStatus = 0;
+               while(::waitpid(sWorker.Pid, &nStatus, 0) < 0 && errno == EINTR);
+               Real fWallTime = SecondsSince(sWorker.Start);
+               /* Write the summary line */
+               cSummary << sWorker.Job << '\t';
+               if(WIFEXITED(nStatus) && WEXITSTATUS(nStatus) == 0 &&
+                  sWorker.Report.compare(0, 3, "OK\t") == 0) {
+                  std::vector<std::string> vecFields;
+                  Tokenize(sWorker.Report.substr(3), vecFields, "\t");
+                  vecFields.resize(4);
+                  cSummary << "ok\t"
+                           << vecFields[0] << '\t'
+                           << vecFields[1] << '\t'
+                           << vecFields[2] << '\t'
+                           << fWallTime << '\t'
+                           << vecFields[3] << '\t';
+               }
+               else {
+                  ++unFailed;
+                  if(sWorker.Report.compare(0, 6, "ERROR\t") == 0) {
+                     cSummary << "error: " << sWorker.Report.substr(6);
+                  }
+                  else if(WIFSIGNALED(nStatus)) {
+                     cSummary << "killed by signal " << WTERMSIG(nStatus);
+                  }
+                  else {
+                     cSummary << "exited with code " << WEXITSTATUS(nStatus);
+                  }
+                  cSummary << "\t-\t-\t-\t" << fWallTime << "\t\t";
+               }
+               cSummary << m_vecJobs[sWorker.Job].Line << std::endl;
+               vecWorkers.erase(vecWorkers.begin() + (i-1));
+            }
+         }
+      }
+      catch(CARGoSException& ex) {
+         /* Don't leave the running workers behind */
+         for(size_t i = 0; i < vecWorkers.size(); ++i) {
+            ::kill(vecWorkers[i].Pid, SIGKILL);
+            ::close(vecWorkers[i].Fd);
+            while(::waitpid(vecWorkers[i].Pid, nullptr, 0) < 0 && errno == EINTR);
+         }
+         throw;
+      }
+      LOG << "[INFO] Batch done: " << (m_vecJobs.size() - unFailed) << " jobs succeeded, "
+          << unFailed << " failed. Summary written to \"" << m_strSummaryFile << "\"" << std::endl;
+      return unFailed;
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
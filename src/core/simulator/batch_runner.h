@@ -0,0 +1,136 @@
+/**
+ * @file <argos3/core/simulator/batch_runner.h>
+ */
+
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+namespace argos {
+   class CBatchRunner;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+#include <argos3/core/utility/configuration/argos_configuration.h>
+#include <string>
+#include <vector>
+
+namespace argos {
+
+   /**
+    * Runs a batch of experiments listed in a sweep file.
+    * <p>
+    * The sweep file lists one job per line. Empty lines and lines starting
+    * with <tt>#</tt> are ignored. A job is the path of an XML configuration
+    * file, followed by any number of attribute overrides in the form
+    * <tt>path\@attribute=value</tt>. The path is a list of element names
+    * separated by <tt>/</tt>, starting from the children of the root
+    * element. An element name can be followed by a 1-based index in square
+    * brackets to select among siblings with the same name. For instance:
+    * </p>
+    * <pre>
+    * # seed and swarm size sweep
+    * exp.argos framework/experiment\@random_seed=1 arena/distribute[2]/entity\@quantity=10
+    * exp.argos framework/experiment\@random_seed=2 arena/distribute[2]/entity\@quantity=20
+    * exp.argos controllers/footbot_diffusion/params\@velocity=7.5
+    * </pre>
+    * <p>
+    * The plugin and user libraries the jobs refer to are loaded once, before
+    * any job is started. Then, each job is run in a worker process forked from
+    * the runner, which inherits the loaded libraries. At most the given number
+    * of workers run at the same time. The <tt>&lt;visualization&gt;</tt>
+    * section of the jobs is ignored. A job can't be branched with
+    * CSimulator::Branch().
+    * </p>
+    * <p>
+    * As soon as a job is over, a line is appended to the summary file. The
+    * line reports, separated by tabs: the job index, the exit status, the
+    * final simulation clock, the time spent initializing the experiment, the
+    * time spent running it, the wall-clock time of the worker, the result
+    * returned by CLoopFunctions::GetResult(), and the job line.
+    * </p>
+    * @see CLoopFunctions::GetResult()
+    */
+   class CBatchRunner {
+
+   public:
+
+      /**
+       * An attribute override.
+       */
+      struct SOverride {
+         /** The path of the element, as a list of names and 1-based indices */
+         std::vector<std::pair<std::string, UInt32> > Path;
+         /** The attribute */
+         std::string Attribute;
+         /** The value */
+         std::string Value;
+      };
+
+      /**
+       * A job in the sweep file.
+       */
+      struct SJob {
+         /** The job line, as written in the sweep file */
+         std::string Line;
+         /** The XML configuration file */
+         std::string ConfigFile;
+         /** The attribute overrides */
+         std::vector<SOverride> Overrides;
+      };
+
+   public:
+
+      /**
+       * Class constructor.
+       * @param str_sweep_file The sweep file.
+       * @param un_workers The maximum number of workers running at the same time.
+       * @param str_summary_file The summary file.
+       * @throws CARGoSException if the sweep file can't be parsed.
+       */
+      CBatchRunner(const std::string& str_sweep_file,
+                   UInt32 un_workers,
+                   const std::string& str_summary_file);
+
+      /**
+       * Runs all the jobs.
+       * @return The number of jobs that failed.
+       * @throws CARGoSException if the libraries or the summary file can't be loaded.
+       */
+      UInt32 Run();
+
+      /**
+       * Applies the given overrides to an XML configuration.
+       * @param t_root The root of the XML configuration.
+       * @param vec_overrides The overrides.
+       * @throws CARGoSException if an element in a path does not exist.
+       */
+      static void ApplyOverrides(TConfigurationNode& t_root,
+                                 const std::vector<SOverride>& vec_overrides);
+
+      /**
+       * Parses a job line.
+       * @param str_line The job line.
+       * @param s_job The parsed job.
+       * @throws CARGoSException if the line can't be parsed.
+       */
+      static void ParseJob(const std::string& str_line,
+                           SJob& s_job);
+
+   private:
+
+      void LoadLibraries();
+
+      void RunJob(const SJob& s_job,
+                  int n_report_fd);
+
+   private:
+
+      std::vector<SJob> m_vecJobs;
+      UInt32 m_unWorkers;
+      std::string m_strSummaryFile;
+
+   };
+
+}
+
+#endif
@@ -37,6 +37,33 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CComposableEntity::SaveState(CByteArray& c_buffer) {
+      CEntity::SaveState(c_buffer);
+      c_buffer << static_cast<UInt32>(m_vecComponents.size());
+      for(size_t i = 0; i < m_vecComponents.size(); ++i) {
+         m_vecComponents[i]->SaveState(c_buffer);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CComposableEntity::LoadState(CByteArray& c_buffer) {
+      CEntity::LoadState(c_buffer);
+      UInt32 unNumComponents;
+      c_buffer >> unNumComponents;
+      if(unNumComponents != m_vecComponents.size()) {
+         THROW_ARGOSEXCEPTION("Entity \"" << GetId() << "\" has " << m_vecComponents.size()
+                              << " components, but the saved state has " << unNumComponents);
+      }
+      for(size_t i = 0; i < m_vecComponents.size(); ++i) {
+         m_vecComponents[i]->LoadState(c_buffer);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CComposableEntity::Update() {
       UpdateComponents();
    }
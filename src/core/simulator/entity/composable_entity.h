@@ -66,6 +66,21 @@ namespace argos {
        */
       virtual void Reset();
 
+      /**
+       * Saves the state of the entity.
+       * Internally calls SaveState() for all the component entities.
+       * @param c_buffer the target buffer
+       */
+      virtual void SaveState(CByteArray& c_buffer);
+
+      /**
+       * Restores the state of the entity.
+       * Internally calls LoadState() for all the component entities.
+       * @param c_buffer the source buffer
+       * @throws CARGoSException if the saved components do not match
+       */
+      virtual void LoadState(CByteArray& c_buffer);
+
       /**
        * Updates the status of this entity.
        * Internally calls UpdateComponents(). If you plan to overload this method, don't forget to call
@@ -89,6 +89,46 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CControllableEntity::SaveState(CByteArray& c_buffer) {
+      CEntity::SaveState(c_buffer);
+      /* Save the commands not yet applied by the actuators */
+      c_buffer << static_cast<UInt32>(m_mapActuators.size());
+      for(auto it = m_mapActuators.begin();
+          it != m_mapActuators.end(); ++it) {
+         it->second->SaveState(c_buffer);
+      }
+      /* The controller state is user-defined, keep it in a block of its own */
+      if(m_pcController != nullptr) {
+         SaveMementoBlock(c_buffer, *m_pcController);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CControllableEntity::LoadState(CByteArray& c_buffer) {
+      CEntity::LoadState(c_buffer);
+      UInt32 unNumActuators;
+      c_buffer >> unNumActuators;
+      if(unNumActuators != m_mapActuators.size()) {
+         THROW_ARGOSEXCEPTION("Controllable entity \"" << GetContext() + GetId() << "\" has "
+                              << m_mapActuators.size() << " actuators, but the saved state has "
+                              << unNumActuators);
+      }
+      for(auto it = m_mapActuators.begin();
+          it != m_mapActuators.end(); ++it) {
+         it->second->LoadState(c_buffer);
+      }
+      if(m_pcController != nullptr) {
+         CMementoBlockReader cReader(c_buffer);
+         cReader.LoadNextBlock(*m_pcController);
+         cReader.Finish();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CControllableEntity::Destroy() {
       /* Clear rays */
       m_vecCheckedRays.clear();
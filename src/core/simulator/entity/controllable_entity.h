@@ -86,6 +86,24 @@ namespace argos {
        */
       virtual void Destroy();
 
+      /**
+       * Saves the state of the entity.
+       * The state includes the state of the actuators and of the controller.
+       * @param c_buffer the target buffer
+       * @see CSimulatedActuator::SaveState()
+       * @see CCI_Controller::SaveState()
+       */
+      virtual void SaveState(CByteArray& c_buffer);
+
+      /**
+       * Restores the state of the entity.
+       * @param c_buffer the source buffer
+       * @throws CARGoSException if the saved actuators do not match
+       * @see CSimulatedActuator::LoadState()
+       * @see CCI_Controller::LoadState()
+       */
+      virtual void LoadState(CByteArray& c_buffer);
+
       /**
        * Returns a reference to the associated controller.
        * @return A reference to the associated controller.
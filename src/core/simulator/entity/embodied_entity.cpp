@@ -118,6 +118,35 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CEmbodiedEntity::SaveState(CByteArray& c_buffer) {
+      CEntity::SaveState(c_buffer);
+      c_buffer << static_cast<UInt32>(m_mapAnchors.size());
+      for(auto it = m_mapAnchors.begin();
+          it != m_mapAnchors.end(); ++it) {
+         c_buffer << it->second->Position << it->second->Orientation;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CEmbodiedEntity::LoadState(CByteArray& c_buffer) {
+      CEntity::LoadState(c_buffer);
+      UInt32 unNumAnchors;
+      c_buffer >> unNumAnchors;
+      if(unNumAnchors != m_mapAnchors.size()) {
+         THROW_ARGOSEXCEPTION("Embodied entity \"" << GetContext() + GetId() << "\" has " << m_mapAnchors.size()
+                              << " anchors, but the saved state has " << unNumAnchors);
+      }
+      for(auto it = m_mapAnchors.begin();
+          it != m_mapAnchors.end(); ++it) {
+         c_buffer >> it->second->Position >> it->second->Orientation;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    SAnchor& CEmbodiedEntity::AddAnchor(const std::string& str_id,
                                        const CVector3& c_offset_position,
                                        const CQuaternion& c_offset_orientation) {
@@ -94,6 +94,21 @@ namespace argos {
 
       virtual void Reset();
 
+      /**
+       * Saves the state of the entity.
+       * The state includes the position and orientation of all the anchors.
+       * The state of the physics models is saved by the physics engines.
+       * @param c_buffer the target buffer
+       */
+      virtual void SaveState(CByteArray& c_buffer);
+
+      /**
+       * Restores the state of the entity.
+       * @param c_buffer the source buffer
+       * @throws CARGoSException if the saved anchors do not match
+       */
+      virtual void LoadState(CByteArray& c_buffer);
+
       /**
        * Returns <tt>true</tt> if the entity is movable.
        * @return <tt>true</tt> if the entity is movable.
@@ -143,6 +143,29 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CEntity::SaveState(CByteArray& c_buffer) {
+      c_buffer << m_strId << static_cast<UInt8>(m_bEnabled);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CEntity::LoadState(CByteArray& c_buffer) {
+      std::string strId;
+      UInt8 unEnabled;
+      c_buffer >> strId >> unEnabled;
+      if(strId != m_strId) {
+         THROW_ARGOSEXCEPTION("The saved state of entity \"" << strId
+                              << "\" can't be restored into entity \"" << m_strId << "\"");
+      }
+      if((unEnabled != 0) != m_bEnabled) {
+         SetEnabled(unEnabled != 0);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    INIT_VTABLE_FOR(CEntity);
 
    REGISTER_STANDARD_SPACE_OPERATIONS_ON_ENTITY(CEntity);
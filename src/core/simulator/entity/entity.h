@@ -22,6 +22,7 @@ namespace argos {
 #include <argos3/core/utility/datatypes/datatypes.h>
 #include <argos3/core/utility/configuration/argos_configuration.h>
 #include <argos3/core/utility/configuration/base_configurable_resource.h>
+#include <argos3/core/utility/configuration/memento.h>
 #include <argos3/core/utility/plugins/factory.h>
 #include <argos3/core/utility/plugins/vtable.h>
 
@@ -87,6 +88,7 @@ namespace argos {
     * @see CSpaceHash
     */
    class CEntity : public CBaseConfigurableResource,
+                   public CMemento,
                    public EnableVTableFor<CEntity> {
 
    public:
@@ -150,6 +152,24 @@ namespace argos {
        */
       virtual void Destroy() {}
 
+      /**
+       * Saves the state of the entity.
+       * The default implementation saves the id of the entity and whether it is enabled.
+       * Entities that override this method must call it first.
+       * @param c_buffer the target buffer
+       */
+      virtual void SaveState(CByteArray& c_buffer);
+
+      /**
+       * Restores the state of the entity.
+       * The default implementation checks that the saved id matches the id of the entity
+       * and restores whether it is enabled.
+       * Entities that override this method must call it first.
+       * @param c_buffer the source buffer
+       * @throws CARGoSException if the saved state belongs to another entity
+       */
+      virtual void LoadState(CByteArray& c_buffer);
+
       /**
        * Returns the id of this entity.
        * @return The id of this entity.
@@ -62,6 +62,22 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CPositionalEntity::SaveState(CByteArray& c_buffer) {
+      CEntity::SaveState(c_buffer);
+      c_buffer << m_cPosition << m_cOrientation;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CPositionalEntity::LoadState(CByteArray& c_buffer) {
+      CEntity::LoadState(c_buffer);
+      c_buffer >> m_cPosition >> m_cOrientation;
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CPositionalEntity::MoveTo(const CVector3& c_position,
                                   const CQuaternion& c_orientation) {
       SetPosition(c_position);
@@ -19,6 +19,7 @@ namespace argos {
 #include <functional>
 
 #include <argos3/core/utility/configuration/base_configurable_resource.h>
+#include <argos3/core/utility/configuration/memento.h>
 #include <argos3/core/simulator/simulator.h>
 #include <argos3/core/simulator/space/space.h>
 #include <argos3/core/utility/datatypes/color.h>
@@ -67,7 +68,8 @@ namespace argos {
     * they are promoted to the core ARGoS code.
     * </p>
     */
-   class CLoopFunctions : public CBaseConfigurableResource {
+   class CLoopFunctions : public CBaseConfigurableResource,
+                          public CMemento {
 
    public:
 
@@ -110,6 +112,22 @@ namespace argos {
        */
       virtual void Destroy() {}
 
+      /**
+       * Saves the user-defined state of the loop functions.
+       * This method is called when a checkpoint of the simulation is taken.
+       * The default implementation of this method does nothing.
+       * @see LoadState()
+       */
+      virtual void SaveState(CByteArray& c_buffer) {}
+
+      /**
+       * Restores the user-defined state of the loop functions.
+       * This method is called when a simulation is restored from a checkpoint, after Init().
+       * The default implementation of this method does nothing.
+       * @see SaveState()
+       */
+      virtual void LoadState(CByteArray& c_buffer) {}
+
       /**
        * Executes user-defined logic right before a control step is executed.
        * This function is executed before the sensors are updated for the current time step.
@@ -151,6 +169,21 @@ namespace argos {
       virtual void PostExperiment() {
       }
 
+      /**
+       * Returns a summary of the outcome of the experiment.
+       * This method is called after the experiment is finished, when
+       * ARGoS runs in batch mode or in a branch forked by
+       * CSimulator::Branch(). The returned string is reported next to the
+       * timing of the run. It should fit in a single line.
+       * The default implementation of this method returns an empty string.
+       * @return A summary of the outcome of the experiment.
+       * @see CBatchRunner
+       * @see CSimulator::Branch()
+       */
+      virtual std::string GetResult() {
+         return "";
+      }
+
       /**
        * Returns the color of the floor in the specified point.
        * This function is called if the floor entity was configured to take the loop functions
@@ -8,6 +8,7 @@
 #include <argos3/core/utility/plugins/dynamic_loading.h>
 #include <argos3/core/simulator/query_plugins.h>
 #include <argos3/core/simulator/argos_command_line_arg_parser.h>
+#include <argos3/core/simulator/batch_runner.h>
 
 using namespace argos;
 
@@ -23,6 +24,8 @@ using namespace argos;
  * @return 0 if everything OK; 1 in case of errors.
  */
 int main(int n_argc, char** ppch_argv) {
+   /* The number of failed batch jobs */
+   UInt32 unFailedJobs = 0;
    try {
       /* Create a new instance of the simulator */
       CSimulator& cSimulator = CSimulator::GetInstance();
@@ -32,15 +35,28 @@ int main(int n_argc, char** ppch_argv) {
       cACLAP.Parse(n_argc, ppch_argv);
       switch(cACLAP.GetAction()) {
          case CARGoSCommandLineArgParser::ACTION_RUN_EXPERIMENT:
-            CDynamicLoading::LoadAllLibraries();
+            /* The plugins are loaded when the experiment is loaded */
             cSimulator.SetExperimentFileName(cACLAP.GetExperimentConfigFile());
             cSimulator.LoadExperiment(cACLAP.IsForceNoViz());
+            cSimulator.SetCheckpoint(cACLAP.GetCheckpointClock(),
+                                     cACLAP.GetCheckpointFile());
+            if(cACLAP.GetRestoreFile() != "") {
+               cSimulator.LoadCheckpoint(cACLAP.GetRestoreFile());
+            }
             cSimulator.Execute();
             break;
          case CARGoSCommandLineArgParser::ACTION_QUERY:
             CDynamicLoading::LoadAllLibraries();
             QueryPlugins(cACLAP.GetQuery());
             break;
+         case CARGoSCommandLineArgParser::ACTION_RUN_BATCH: {
+            /* The plugins are loaded once by the batch runner */
+            CBatchRunner cBatchRunner(cACLAP.GetBatchFile(),
+                                      cACLAP.GetBatchJobs(),
+                                      cACLAP.GetBatchSummaryFile());
+            unFailedJobs = cBatchRunner.Run();
+            break;
+         }
          case CARGoSCommandLineArgParser::ACTION_SHOW_HELP:
             cACLAP.PrintUsage(LOG);
             break;
@@ -64,5 +80,5 @@ int main(int n_argc, char** ppch_argv) {
       return 1;
    }
    /* Everything's ok, exit */
-   return 0;
+   return (unFailedJobs == 0) ? 0 : 1;
 }
@@ -14,12 +14,14 @@ namespace argos {
 
 #include <argos3/core/utility/configuration/base_configurable_resource.h>
 #include <argos3/core/utility/configuration/argos_configuration.h>
+#include <argos3/core/utility/configuration/memento.h>
 #include <argos3/core/utility/datatypes/datatypes.h>
 #include <argos3/core/utility/plugins/factory.h>
 
 namespace argos {
 
-   class CMedium : public CBaseConfigurableResource {
+   class CMedium : public CBaseConfigurableResource,
+                   public CMemento {
 
    public:
 
@@ -28,7 +30,9 @@ namespace argos {
 
    public:
 
-      CMedium() {}
+      CMedium() :
+         m_pcSpace(nullptr),
+         m_bUpdateParallel(false) {}
       virtual ~CMedium() {}
 
       /**
@@ -69,6 +73,61 @@ namespace argos {
        */
       virtual void Update() = 0;
 
+      /**
+       * Saves the state of this medium.
+       * Media are usually rebuilt from the state of the entities, so by
+       * default this method saves nothing.
+       * @param c_buffer the target buffer
+       * @see LoadState()
+       */
+      virtual void SaveState(CByteArray& c_buffer) {}
+
+      /**
+       * Restores the state of this medium.
+       * This method is called after the entities have been restored. By
+       * default, it calls Reset(), so the medium is in the same state as
+       * after a reset of the experiment.
+       * @param c_buffer the source buffer
+       * @see SaveState()
+       */
+      virtual void LoadState(CByteArray& c_buffer) {
+         Reset();
+      }
+
+      /**
+       * Returns <tt>true</tt> if part of the update of this medium is run in parallel.
+       * In this case, before the media are updated, the space calls
+       * PrepareUpdateTasks() and then spreads the calls to ExecuteUpdateTask()
+       * across its threads. Update() is called afterwards as usual, and must
+       * cope with the tasks not having been executed (e.g., when it is
+       * called by PostSpaceInit()).
+       * @return <tt>true</tt> if part of the update of this medium is run in parallel.
+       * @see PrepareUpdateTasks()
+       * @see ExecuteUpdateTask()
+       */
+      inline bool IsUpdateParallel() const {
+         return m_bUpdateParallel;
+      }
+
+      /**
+       * Prepares the tasks of the parallel part of the update.
+       * This method is called serially. By default, this method does nothing.
+       * @return The number of tasks to execute.
+       * @see IsUpdateParallel()
+       */
+      virtual size_t PrepareUpdateTasks() {
+         return 0;
+      }
+
+      /**
+       * Executes a task of the parallel part of the update.
+       * This method is called concurrently on different tasks.
+       * By default, this method does nothing.
+       * @param un_task The index of the task, in [0, PrepareUpdateTasks()).
+       * @see IsUpdateParallel()
+       */
+      virtual void ExecuteUpdateTask(size_t un_task) {}
+
       /**
        * Returns the id of this medium.
        * @return The id of this medium.
@@ -93,6 +152,19 @@ namespace argos {
          return *m_pcSpace;
       }
 
+   protected:
+
+      /**
+       * Sets whether part of the update of this medium is run in parallel.
+       * Media that implement PrepareUpdateTasks() and ExecuteUpdateTask()
+       * call this method in Init().
+       * @param b_parallel <tt>true</tt> to run part of the update in parallel.
+       * @see IsUpdateParallel()
+       */
+      inline void SetUpdateParallel(bool b_parallel) {
+         m_bUpdateParallel = b_parallel;
+      }
+
    private:
                
       /** The medium's id. */
@@ -101,6 +173,9 @@ namespace argos {
       /** Pointer to the ARGoS space */
       CSpace* m_pcSpace;
 
+      /** True if part of the update of this medium is run in parallel */
+      bool m_bUpdateParallel;
+
    };
 
 }
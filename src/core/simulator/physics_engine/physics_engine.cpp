@@ -29,8 +29,21 @@ namespace argos {
       /* Ask each engine to perform the ray query */
       for(size_t i = 0; i < vecEngines.size(); ++i)
          vecEngines[i]->CheckIntersectionWithRay(t_data, c_ray);
-      /* Remove duplicates */
-      // TODO
+      /* Remove duplicates, which appear when an entity is made of several
+         shapes or is seen by several engines. Keep the closest intersection
+         of each entity, in order of first appearance. */
+      size_t unKept = 0;
+      for(size_t i = 0; i < t_data.size(); ++i) {
+         size_t j = 0;
+         while(j < unKept && t_data[j].IntersectedEntity != t_data[i].IntersectedEntity) ++j;
+         if(j == unKept) {
+            t_data[unKept++] = t_data[i];
+         }
+         else if(t_data[j].TOnRay > t_data[i].TOnRay) {
+            t_data[j].TOnRay = t_data[i].TOnRay;
+         }
+      }
+      t_data.resize(unKept);
       /* Return true if an intersection was found */
       return !t_data.empty();
    }
@@ -40,16 +53,15 @@ namespace argos {
 
    bool GetClosestEmbodiedEntityIntersectedByRay(SEmbodiedEntityIntersectionItem& s_item,
                                                  const CRay3& c_ray) {
+      /* This variable is instantiated at the first call of this function, once and forever */
+      static CSimulator& cSimulator = CSimulator::GetInstance();
       /* Initialize s_item */
       s_item.IntersectedEntity = nullptr;
       s_item.TOnRay = 1.0f;
-      /* Perform full ray query */
-      TEmbodiedEntityIntersectionData tData;
-      GetEmbodiedEntitiesIntersectedByRay(tData, c_ray);
-      /* Go through intersections and find the closest */
-      for(size_t i = 0; i < tData.size(); ++i) {
-         if(s_item.TOnRay > tData[i].TOnRay)
-            s_item = tData[i];
+      /* Let each engine refine the closest intersection */
+      CPhysicsEngine::TVector& vecEngines = cSimulator.GetPhysicsEngines();
+      for(size_t i = 0; i < vecEngines.size(); ++i) {
+         vecEngines[i]->CheckClosestIntersectionWithRay(s_item, c_ray);
       }
       /* Return true if an intersection was found */
       return (s_item.IntersectedEntity != nullptr);
@@ -61,18 +73,15 @@ namespace argos {
    bool GetClosestEmbodiedEntityIntersectedByRay(SEmbodiedEntityIntersectionItem& s_item,
                                                  const CRay3& c_ray,
                                                  CEmbodiedEntity& c_entity) {
+      /* This variable is instantiated at the first call of this function, once and forever */
+      static CSimulator& cSimulator = CSimulator::GetInstance();
       /* Initialize s_item */
       s_item.IntersectedEntity = nullptr;
       s_item.TOnRay = 1.0f;
-      /* Perform full ray query */
-      TEmbodiedEntityIntersectionData tData;
-      GetEmbodiedEntitiesIntersectedByRay(tData, c_ray);
-      /* Go through intersections and find the closest */
-      for(size_t i = 0; i < tData.size(); ++i) {
-         if(s_item.TOnRay > tData[i].TOnRay &&
-            &c_entity != tData[i].IntersectedEntity) {
-            s_item = tData[i];
-         }
+      /* Let each engine refine the closest intersection */
+      CPhysicsEngine::TVector& vecEngines = cSimulator.GetPhysicsEngines();
+      for(size_t i = 0; i < vecEngines.size(); ++i) {
+         vecEngines[i]->CheckClosestIntersectionWithRay(s_item, c_ray, &c_entity);
       }
       /* Return true if an intersection was found */
       return (s_item.IntersectedEntity != nullptr);
@@ -81,6 +90,31 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   size_t GetClosestEmbodiedEntitiesIntersectedByRays(TEmbodiedEntityRayQueries& t_queries) {
+      /* This variable is instantiated at the first call of this function, once and forever */
+      static CSimulator& cSimulator = CSimulator::GetInstance();
+      /* Reset the results */
+      for(size_t i = 0; i < t_queries.size(); ++i) {
+         t_queries[i].Closest = SEmbodiedEntityIntersectionItem();
+      }
+      /* Let each engine refine the closest intersections */
+      CPhysicsEngine::TVector& vecEngines = cSimulator.GetPhysicsEngines();
+      for(size_t i = 0; i < vecEngines.size(); ++i) {
+         vecEngines[i]->CheckClosestIntersectionsWithRays(t_queries);
+      }
+      /* Count the rays that hit something */
+      size_t unHits = 0;
+      for(size_t i = 0; i < t_queries.size(); ++i) {
+         if(t_queries[i].Closest.IntersectedEntity != nullptr) {
+            ++unHits;
+         }
+      }
+      return unHits;
+   }
+
+   /****************************************/
+   /****************************************/
+
    /* The default value of the simulation clock tick */
    Real CPhysicsEngine::m_fSimulationClockTick = 0.1f;
    Real CPhysicsEngine::m_fInverseSimulationClockTick = 1.0f / CPhysicsEngine::m_fSimulationClockTick;
@@ -168,6 +202,25 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CPhysicsEngine::SVolume::SetSides(const std::vector<CVector2>& vec_vertices) {
+      if(vec_vertices.size() < 3) {
+         THROW_ARGOSEXCEPTION("A volume needs at least 3 vertices to define its sides");
+      }
+      while(!SideFaces.empty()) {
+         delete SideFaces.back();
+         SideFaces.pop_back();
+      }
+      for(size_t i = 0; i < vec_vertices.size(); ++i) {
+         auto* psFace = new SVerticalFace;
+         psFace->BaseSegment.SetStart(vec_vertices[i]);
+         psFace->BaseSegment.SetEnd(vec_vertices[(i + 1) % vec_vertices.size()]);
+         SideFaces.push_back(psFace);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    bool CPhysicsEngine::SVolume::IsActive() const {
       return TopFace || BottomFace || (!SideFaces.empty());
    }
@@ -177,7 +230,8 @@ namespace argos {
 
    CPhysicsEngine::CPhysicsEngine() :
       m_unIterations(10),
-      m_fPhysicsClockTick(m_fSimulationClockTick) {}
+      m_fPhysicsClockTick(m_fSimulationClockTick),
+      m_bModelUpdateParallel(false) {}
 
    /****************************************/
    /****************************************/
@@ -244,7 +298,13 @@ namespace argos {
    /****************************************/
 
    void CPhysicsEngine::ScheduleEntityForTransfer(CEmbodiedEntity& c_entity) {
-      m_vecTransferData.push_back(&c_entity);
+      if(m_bModelUpdateParallel) {
+         std::lock_guard<std::mutex> cLock(m_cTransferDataMutex);
+         m_vecTransferData.push_back(&c_entity);
+      }
+      else {
+         m_vecTransferData.push_back(&c_entity);
+      }
    }
 
    /****************************************/
@@ -261,6 +321,36 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   bool CPhysicsEngine::CheckClosestIntersectionWithRay(SEmbodiedEntityIntersectionItem& s_item,
+                                                        const CRay3& c_ray,
+                                                        const CEmbodiedEntity* pc_ignored_entity) const {
+      TEmbodiedEntityIntersectionData tData;
+      CheckIntersectionWithRay(tData, c_ray);
+      bool bFound = false;
+      for(size_t i = 0; i < tData.size(); ++i) {
+         if(s_item.TOnRay > tData[i].TOnRay &&
+            pc_ignored_entity != tData[i].IntersectedEntity) {
+            s_item = tData[i];
+            bFound = true;
+         }
+      }
+      return bFound;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CPhysicsEngine::CheckClosestIntersectionsWithRays(TEmbodiedEntityRayQueries& t_queries) const {
+      for(size_t i = 0; i < t_queries.size(); ++i) {
+         CheckClosestIntersectionWithRay(t_queries[i].Closest,
+                                         t_queries[i].Ray,
+                                         t_queries[i].IgnoredEntity);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    Real CPhysicsEngine::GetSimulationClockTick() {
       return m_fSimulationClockTick;
    }
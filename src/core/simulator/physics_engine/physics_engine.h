@@ -17,10 +17,13 @@ namespace argos {
 }
 
 #include <map>
+#include <mutex>
 #include <argos3/core/utility/logging/argos_log.h>
 #include <argos3/core/utility/math/ray2.h>
+#include <argos3/core/utility/math/ray3.h>
 #include <argos3/core/utility/configuration/base_configurable_resource.h>
 #include <argos3/core/utility/configuration/argos_configuration.h>
+#include <argos3/core/utility/configuration/memento.h>
 #include <argos3/core/utility/datatypes/datatypes.h>
 #include <argos3/core/utility/plugins/factory.h>
 
@@ -57,6 +60,32 @@ namespace argos {
 
    typedef std::vector<SEmbodiedEntityIntersectionItem> TEmbodiedEntityIntersectionData;
 
+   /**
+    * A single ray query for the batched closest-intersection API.
+    * The physics engines refine the Closest field in place, so a query
+    * can be handed from one engine to the next and the engines can use
+    * the closest hit found so far to cut their search short.
+    * @see GetClosestEmbodiedEntitiesIntersectedByRays
+    */
+   struct SEmbodiedEntityRayQuery {
+      /** The ray to test */
+      CRay3 Ray;
+      /** An entity to exclude from the intersection check (e.g., the sensing robot), or nullptr */
+      const CEmbodiedEntity* IgnoredEntity;
+      /** The closest intersection found so far */
+      SEmbodiedEntityIntersectionItem Closest;
+
+      SEmbodiedEntityRayQuery() :
+         IgnoredEntity(nullptr) {}
+
+      SEmbodiedEntityRayQuery(const CRay3& c_ray,
+                              const CEmbodiedEntity* pc_ignored_entity = nullptr) :
+         Ray(c_ray),
+         IgnoredEntity(pc_ignored_entity) {}
+   };
+
+   typedef std::vector<SEmbodiedEntityRayQuery> TEmbodiedEntityRayQueries;
+
    /**
     * Checks whether the given ray intersects any entity.
     * The t_data parameter is cleared.
@@ -88,10 +117,25 @@ namespace argos {
                                                         const CRay3& c_ray,
                                                         CEmbodiedEntity& c_entity);
 
+   /**
+    * Finds the closest intersection with an embodied entity for a batch of rays.
+    * The Closest field of each query is reset and then filled with the
+    * closest intersection found for its ray, ignoring the query's
+    * IgnoredEntity. A query without intersections has a null
+    * Closest.IntersectedEntity.
+    * Prefer this function to GetClosestEmbodiedEntityIntersectedByRay()
+    * when a sensor casts several rays per step, as it lets the physics
+    * engines process all the rays in one go.
+    * @param t_queries The ray queries.
+    * @return The number of rays that intersect an entity.
+    */
+   extern size_t GetClosestEmbodiedEntitiesIntersectedByRays(TEmbodiedEntityRayQueries& t_queries);
+
    /****************************************/
    /****************************************/
 
-   class CPhysicsEngine : public CBaseConfigurableResource {
+   class CPhysicsEngine : public CBaseConfigurableResource,
+                          public CMemento {
 
    public:
 
@@ -126,6 +170,12 @@ namespace argos {
          SVolume();
          ~SVolume();
          void Init(TConfigurationNode& t_node);
+         /**
+          * Sets the side faces as the closed polygon with the given vertices.
+          * The vertices must be in counter-clockwise order.
+          * @param vec_vertices The vertices of the polygon.
+          */
+         void SetSides(const std::vector<CVector2>& vec_vertices);
          bool IsActive() const;
       };
       
@@ -145,6 +195,39 @@ namespace argos {
 
       virtual void Update() = 0;
 
+      /**
+       * Returns <tt>true</tt> if the space updates the models of this engine in parallel.
+       * In this case, Update() steps the physics and leaves the per-model updates
+       * to the space. Before Update(), the space
+       * calls UpdateFromEntityStatus(size_t) for each model; after Update(), it
+       * calls UpdateEntityStatus(size_t) for each model. The calls are spread
+       * across the threads of the space.
+       * @return <tt>true</tt> if the space updates the models of this engine in parallel.
+       * @see UpdateFromEntityStatus(size_t)
+       * @see UpdateEntityStatus(size_t)
+       */
+      inline bool IsModelUpdateParallel() const {
+         return m_bModelUpdateParallel;
+      }
+
+      /**
+       * Updates the model with the given index from the status of its entity.
+       * When IsModelUpdateParallel() is <tt>true</tt>, this method is called
+       * concurrently on different models. By default, this method does nothing:
+       * engines whose models modify the shared physics world while reading their
+       * entities keep this update in Update().
+       * @param un_model The index of the model, in [0, GetNumPhysicsModels()).
+       */
+      virtual void UpdateFromEntityStatus(size_t un_model) {}
+
+      /**
+       * Updates the status of the entity of the model with the given index.
+       * When IsModelUpdateParallel() is <tt>true</tt>, this method is called
+       * concurrently on different models. By default, this method does nothing.
+       * @param un_model The index of the model, in [0, GetNumPhysicsModels()).
+       */
+      virtual void UpdateEntityStatus(size_t un_model) {}
+
       /**
        * Executes extra initialization activities after the space has been initialized.
        * By default, this method does nothing.
@@ -199,6 +282,8 @@ namespace argos {
 
       /**
        * Schedules an entity of transfer.
+       * When IsModelUpdateParallel() is <tt>true</tt>, this method can be
+       * called concurrently.
        * @param c_entity The entity to transfer.
        * @param str_engine_id The id if the destination engine.
        */
@@ -209,6 +294,33 @@ namespace argos {
        */
       virtual void TransferEntities();
 
+      /**
+       * Executed once all the physics engines have been updated and the
+       * entities have been transferred.
+       * This method is always executed serially, so it is the place to
+       * exchange data with other physics engines.
+       */
+      virtual void PostUpdate() {}
+
+      /**
+       * Saves the state of the physics models of this engine.
+       * By default, this method saves nothing.
+       * @param c_buffer the target buffer
+       * @see LoadState()
+       */
+      virtual void SaveState(CByteArray& c_buffer) {}
+
+      /**
+       * Restores the state of the physics models of this engine.
+       * This method is called after the entities have been restored and
+       * moved to the engines that house their restored positions. Models
+       * whose entity is no longer in this engine must be skipped.
+       * By default, this method does nothing.
+       * @param c_buffer the source buffer
+       * @see SaveState()
+       */
+      virtual void LoadState(CByteArray& c_buffer) {}
+
       /**
        * Returns the boundary faces for the volume associated to this engine.
        */
@@ -231,6 +343,35 @@ namespace argos {
       virtual void CheckIntersectionWithRay(TEmbodiedEntityIntersectionData& t_data,
                                             const CRay3& c_ray) const = 0;
 
+      /**
+       * Refines the closest intersection with the given ray.
+       * If this engine contains an entity that is hit closer than
+       * s_item.TOnRay and is not pc_ignored_entity, s_item is replaced
+       * with it.
+       * The default implementation is based on CheckIntersectionWithRay();
+       * engines that can stop a ray query at the first hit should override it.
+       * This method is called concurrently by the sensors, so it must not
+       * modify the state of the engine.
+       * @param s_item The closest intersection found so far.
+       * @param c_ray The test ray.
+       * @param pc_ignored_entity The entity to exclude from the check, or nullptr.
+       * @return <tt>true</tt> if s_item was replaced.
+       */
+      virtual bool CheckClosestIntersectionWithRay(SEmbodiedEntityIntersectionItem& s_item,
+                                                   const CRay3& c_ray,
+                                                   const CEmbodiedEntity* pc_ignored_entity = nullptr) const;
+
+      /**
+       * Refines the closest intersection of each of the given ray queries.
+       * The default implementation calls CheckClosestIntersectionWithRay()
+       * on each query; engines that can process rays in batches should
+       * override it.
+       * Like CheckClosestIntersectionWithRay(), this method must not
+       * modify the state of the engine.
+       * @param t_queries The ray queries.
+       */
+      virtual void CheckClosestIntersectionsWithRays(TEmbodiedEntityRayQueries& t_queries) const;
+
       /**
        * Returns the simulation clock tick.
        * The clock tick is the time elapsed between two control steps
@@ -296,6 +437,19 @@ namespace argos {
       void SetId(const std::string& str_id) {
          m_strId = str_id;
       }
+
+   protected:
+
+      /**
+       * Sets whether the space updates the models of this engine in parallel.
+       * Engines that implement UpdateFromEntityStatus(size_t) and
+       * UpdateEntityStatus(size_t) call this method in Init().
+       * @param b_parallel <tt>true</tt> to update the models in parallel.
+       * @see IsModelUpdateParallel()
+       */
+      inline void SetModelUpdateParallel(bool b_parallel) {
+         m_bModelUpdateParallel = b_parallel;
+      }
                
    private:
 
@@ -319,6 +473,12 @@ namespace argos {
 
       /** Entity transfer data */
       std::vector<CEmbodiedEntity*> m_vecTransferData;
+
+      /** Protects the entity transfer data when the models are updated in parallel */
+      std::mutex m_cTransferDataMutex;
+
+      /** True if the space updates the models of this engine in parallel */
+      bool m_bModelUpdateParallel;
    };
 
 }
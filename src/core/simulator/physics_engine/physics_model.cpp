@@ -74,6 +74,16 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CPhysicsModel::LoadState(CByteArray& c_buffer) {
+      if(m_cEmbodiedEntity.IsMovable()) {
+         MoveTo(m_cEmbodiedEntity.GetOriginAnchor().Position,
+                m_cEmbodiedEntity.GetOriginAnchor().Orientation);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CPhysicsModel::CalculateAnchors() {
       std::vector<SAnchor*>& vecAnchors = m_cEmbodiedEntity.GetEnabledAnchors();
       for(size_t i = 0; i < vecAnchors.size(); ++i) {
@@ -16,6 +16,7 @@ namespace argos {
    struct SAnchor;
 }
 
+#include <argos3/core/utility/configuration/memento.h>
 #include <argos3/core/utility/datatypes/datatypes.h>
 #include <argos3/core/utility/math/vector3.h>
 #include <argos3/core/utility/math/quaternion.h>
@@ -99,7 +100,7 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   class CPhysicsModel {
+   class CPhysicsModel : public CMemento {
 
    public:
 
@@ -206,6 +207,24 @@ namespace argos {
       virtual void MoveTo(const CVector3& c_position,
                           const CQuaternion& c_orientation) = 0;
 
+      /**
+       * Saves the dynamic state of this model, such as the speeds of its bodies.
+       * By default, this method saves nothing.
+       * @param c_buffer the target buffer
+       * @see LoadState()
+       */
+      virtual void SaveState(CByteArray& c_buffer) {}
+
+      /**
+       * Restores the dynamic state of this model.
+       * This method is called after the state of the embodied entity has been
+       * restored. By default, it moves a movable entity to the restored position
+       * of its origin anchor, losing the speeds of its bodies.
+       * @param c_buffer the source buffer
+       * @see SaveState()
+       */
+      virtual void LoadState(CByteArray& c_buffer);
+
       /**
        * Returns an axis-aligned box that contains the physics model.
        * The bounding box is often called AABB.
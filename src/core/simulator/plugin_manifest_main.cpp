@@ -0,0 +1,40 @@
+/**
+ * @file <argos3/core/simulator/plugin_manifest_main.cpp>
+ */
+
+#include <argos3/core/utility/plugins/dynamic_loading.h>
+
+using namespace argos;
+
+/**
+ * @brief Writes the manifests of the given plugin libraries.
+ *
+ * The manifest of a library lists the labels the library registers in the
+ * factories. The simulator uses it to load only the libraries an experiment
+ * needs. This program is run at build time, see the CMake function
+ * argos3_plugin_manifest().
+ *
+ * @param n_argc the number of command line arguments given at the shell.
+ * @param ppch_argv the paths of the libraries.
+ * @return 0 if everything OK; 1 in case of errors.
+ */
+int main(int n_argc, char** ppch_argv) {
+   if(n_argc < 2) {
+      LOGERR << "Usage: " << ppch_argv[0] << " LIBRARY [LIBRARY ...]" << std::endl;
+      LOGERR.Flush();
+      return 1;
+   }
+   try {
+      /* Loading the libraries is not interesting at build time */
+      LOG.SetEnabled(false);
+      for(int i = 1; i < n_argc; ++i) {
+         CDynamicLoading::WriteManifest(ppch_argv[i]);
+      }
+   }
+   catch(std::exception& ex) {
+      LOGERR << ex.what() << std::endl;
+      LOGERR.Flush();
+      return 1;
+   }
+   return 0;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file <argos3/core/simulator/recorder/pose_trajectory_channel.cpp>
+ */
+
+#include "pose_trajectory_channel.h"
+#include <argos3/core/simulator/entity/composable_entity.h>
+#include <argos3/core/simulator/entity/embodied_entity.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   CEntity* CPoseTrajectoryChannel::GetSource(CComposableEntity& c_entity) {
+      if(!c_entity.HasComponent("body")) {
+         return nullptr;
+      }
+      return dynamic_cast<CEmbodiedEntity*>(&c_entity.GetComponent("body"));
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CPoseTrajectoryChannel::Sample(CEntity& c_source,
+                                       void* pt_values) {
+      const SAnchor& sAnchor = static_cast<CEmbodiedEntity&>(c_source).GetOriginAnchor();
+      auto* pfValues = static_cast<float*>(pt_values);
+      pfValues[0] = sAnchor.Position.GetX();
+      pfValues[1] = sAnchor.Position.GetY();
+      pfValues[2] = sAnchor.Position.GetZ();
+      pfValues[3] = sAnchor.Orientation.GetW();
+      pfValues[4] = sAnchor.Orientation.GetX();
+      pfValues[5] = sAnchor.Orientation.GetY();
+      pfValues[6] = sAnchor.Orientation.GetZ();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_TRAJECTORY_CHANNEL(CPoseTrajectoryChannel,
+                               "pose",
+                               "Carlo Pinciroli [ilpincy@gmail.com]",
+                               "1.0",
+                               "Records the position and orientation of an entity.",
+                               "This channel records the origin anchor of the body of an entity, as seven\n"
+                               "32-bit floats: the position (x, y, z) and the orientation quaternion\n"
+                               "(w, x, y, z).\n\n"
+                               "REQUIRED XML CONFIGURATION\n\n"
+                               "  <recording file=\"trajectory.argostrj\">\n"
+                               "    <entities type=\"foot-bot\">\n"
+                               "      <pose />\n"
+                               "    </entities>\n"
+                               "  </recording>\n",
+                               "Usable"
+      );
+
+}
@@ -0,0 +1,44 @@
+/**
+ * @file <argos3/core/simulator/recorder/pose_trajectory_channel.h>
+ */
+
+#ifndef POSE_TRAJECTORY_CHANNEL_H
+#define POSE_TRAJECTORY_CHANNEL_H
+
+namespace argos {
+   class CPoseTrajectoryChannel;
+}
+
+#include <argos3/core/simulator/recorder/trajectory_channel.h>
+
+namespace argos {
+
+   /**
+    * Records the origin anchor of the body of an entity.
+    * The values are the position (x, y, z) and the orientation quaternion
+    * (w, x, y, z), as 32-bit floats.
+    */
+   class CPoseTrajectoryChannel : public CTrajectoryChannel {
+
+   public:
+
+      virtual ~CPoseTrajectoryChannel() {}
+
+      virtual ETrajectoryValueType GetValueType() const {
+         return TRAJECTORY_FLOAT32;
+      }
+
+      virtual CEntity* GetSource(CComposableEntity& c_entity);
+
+      virtual UInt32 GetNumValues(CEntity& c_source) {
+         return 7;
+      }
+
+      virtual void Sample(CEntity& c_source,
+                          void* pt_values);
+
+   };
+
+}
+
+#endif
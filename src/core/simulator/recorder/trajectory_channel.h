@@ -0,0 +1,109 @@
+/**
+ * @file <argos3/core/simulator/recorder/trajectory_channel.h>
+ */
+
+#ifndef TRAJECTORY_CHANNEL_H
+#define TRAJECTORY_CHANNEL_H
+
+namespace argos {
+   class CTrajectoryChannel;
+   class CEntity;
+   class CComposableEntity;
+}
+
+#include <argos3/core/utility/configuration/base_configurable_resource.h>
+#include <argos3/core/utility/datatypes/datatypes.h>
+#include <argos3/core/utility/plugins/factory.h>
+#include <argos3/core/simulator/recorder/trajectory_format.h>
+
+namespace argos {
+
+   /**
+    * A channel of the trajectory recorder.
+    * <p>
+    * A channel samples a fixed number of 32-bit values per entity and per
+    * recorded step, such as the pose of the entity or the color of its LEDs.
+    * Channels are created by the recorder only when they are listed in the
+    * <tt>&lt;recording&gt;</tt> section of the experiment, so a channel that
+    * is not listed costs nothing.
+    * </p>
+    * <p>
+    * When recording starts, the recorder calls GetSource() to find out the
+    * component of each entity the channel samples, and GetNumValues() to
+    * fix the number of values of that entity. Then, at each recorded step,
+    * it calls Sample() for each entity.
+    * </p>
+    * @see CTrajectoryRecorder
+    */
+   class CTrajectoryChannel : public CBaseConfigurableResource {
+
+   public:
+
+      virtual ~CTrajectoryChannel() {}
+
+      /**
+       * Initializes the channel.
+       * The default implementation of this method does nothing.
+       * @param t_tree The XML node of the channel.
+       */
+      virtual void Init(TConfigurationNode& t_tree) {}
+
+      virtual void Reset() {}
+
+      virtual void Destroy() {}
+
+      /**
+       * Returns the type of the values of this channel.
+       * @return The type of the values of this channel.
+       */
+      virtual ETrajectoryValueType GetValueType() const = 0;
+
+      /**
+       * Returns the component of the given entity this channel samples.
+       * @param c_entity The recorded entity.
+       * @return The sampled component, or <tt>nullptr</tt> if the entity does not provide this channel.
+       */
+      virtual CEntity* GetSource(CComposableEntity& c_entity) = 0;
+
+      /**
+       * Returns the number of values sampled from the given source.
+       * The recorder calls this method once, when recording starts.
+       * @param c_source A component returned by GetSource().
+       * @return The number of values sampled from the given source.
+       */
+      virtual UInt32 GetNumValues(CEntity& c_source) = 0;
+
+      /**
+       * Samples the given source.
+       * This method is called at each recorded step and must be fast.
+       * @param c_source A component returned by GetSource().
+       * @param pt_values The buffer to fill with GetNumValues() values of type GetValueType().
+       */
+      virtual void Sample(CEntity& c_source,
+                          void* pt_values) = 0;
+
+   };
+
+}
+
+/**
+ * Registers a trajectory channel inside ARGoS.
+ * The label is the name of the XML node that enables the channel.
+ */
+#define REGISTER_TRAJECTORY_CHANNEL(CLASSNAME,          \
+                                    LABEL,              \
+                                    AUTHOR,             \
+                                    VERSION,            \
+                                    BRIEF_DESCRIPTION,  \
+                                    LONG_DESCRIPTION,   \
+                                    STATUS)             \
+   REGISTER_SYMBOL(CTrajectoryChannel,                  \
+                   CLASSNAME,                           \
+                   LABEL,                               \
+                   AUTHOR,                              \
+                   VERSION,                             \
+                   BRIEF_DESCRIPTION,                   \
+                   LONG_DESCRIPTION,                    \
+                   STATUS)
+
+#endif
@@ -0,0 +1,70 @@
+/**
+ * @file <argos3/core/simulator/recorder/trajectory_format.h>
+ *
+ * @brief This file defines the constants of the trajectory file format.
+ *
+ * A trajectory file is made of a header followed by a sequence of chunks.
+ *
+ * The header is encoded with CByteArray, i.e., numbers are in network byte
+ * order and strings are terminated by a 0 byte. It contains:
+ * <ul>
+ * <li>the magic string <tt>ARGOSTRJ</tt>, without terminator;
+ * <li>the format version (UInt32);
+ * <li>the size of the header in bytes, a multiple of 8 (UInt32);
+ * <li>the byte order mark TRAJECTORY_BYTE_ORDER_MARK, in the byte order of the chunks (UInt32);
+ * <li>the length of a simulation step in seconds (double);
+ * <li>the number of steps between two recorded steps (UInt32);
+ * <li>the maximum number of recorded steps in a chunk (UInt32);
+ * <li>the number of entities (UInt32), then the id and the type of each entity (string, string);
+ * <li>the number of channels (UInt32), then, for each channel, its name
+ *     (string), its value type (UInt32) and the number of values of each
+ *     entity (UInt32 per entity).
+ * </ul>
+ *
+ * The chunks are stored in the byte order of the machine that wrote the
+ * file, so that they can be used directly once the file is mapped in
+ * memory. A chunk contains:
+ * <ul>
+ * <li>the number of recorded steps <em>n</em> in the chunk (UInt32);
+ * <li>the size of the chunk in bytes, including these two fields (UInt32);
+ * <li>the clock column: the simulation clock of each recorded step (<em>n</em> UInt32);
+ * <li>one column per channel: <em>n</em> rows, each containing the values of
+ *     all the entities in the order of the header.
+ * </ul>
+ * All the values are 32 bits wide, so every column is aligned to 4 bytes.
+ */
+
+#ifndef TRAJECTORY_FORMAT_H
+#define TRAJECTORY_FORMAT_H
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+namespace argos {
+
+   /** The magic string at the start of a trajectory file */
+   static const char TRAJECTORY_MAGIC[] = "ARGOSTRJ";
+
+   /** The length of the magic string */
+   static const size_t TRAJECTORY_MAGIC_LENGTH = 8;
+
+   /** The version of the trajectory file format */
+   static const UInt32 TRAJECTORY_VERSION = 1;
+
+   /** The byte order mark, used to detect files written on a machine with a different byte order */
+   static const UInt32 TRAJECTORY_BYTE_ORDER_MARK = 0x01020304;
+
+   /** The size of the fields at the start of a chunk */
+   static const size_t TRAJECTORY_CHUNK_HEADER_SIZE = 2 * sizeof(UInt32);
+
+   /**
+    * The type of the values of a trajectory channel.
+    * Values are always 32 bits wide.
+    */
+   enum ETrajectoryValueType {
+      TRAJECTORY_FLOAT32 = 0,
+      TRAJECTORY_UINT32
+   };
+
+}
+
+#endif
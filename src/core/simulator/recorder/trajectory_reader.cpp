@@ -0,0 +1,226 @@
+/**
+ * @file <argos3/core/simulator/recorder/trajectory_reader.cpp>
+ */
+
+#include "trajectory_reader.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <argos3/core/utility/configuration/argos_exception.h>
+#include <argos3/core/utility/datatypes/byte_array.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   CTrajectoryReader::CTrajectoryReader() :
+      m_ptMap(nullptr),
+      m_unMapSize(0),
+      m_fStepLength(0.0),
+      m_unPeriod(0),
+      m_unNumSteps(0) {}
+
+   /****************************************/
+   /****************************************/
+
+   CTrajectoryReader::~CTrajectoryReader() {
+      Close();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTrajectoryReader::Open(const std::string& str_file_name) {
+      Close();
+      m_strFileName = str_file_name;
+      /* Map the file */
+      int nFd = ::open(str_file_name.c_str(), O_RDONLY);
+      if(nFd < 0) {
+         THROW_ARGOSEXCEPTION("Error opening trajectory file \"" << str_file_name << "\": " << ::strerror(errno));
+      }
+      struct stat sStat;
+      if(::fstat(nFd, &sStat) != 0) {
+         std::string strError(::strerror(errno));
+         ::close(nFd);
+         THROW_ARGOSEXCEPTION("Error reading trajectory file \"" << str_file_name << "\": " << strError);
+      }
+      m_unMapSize = sStat.st_size;
+      if(m_unMapSize < TRAJECTORY_MAGIC_LENGTH + 3 * sizeof(UInt32)) {
+         ::close(nFd);
+         THROW_ARGOSEXCEPTION("\"" << str_file_name << "\" is not a trajectory file");
+      }
+      m_ptMap = ::mmap(nullptr, m_unMapSize, PROT_READ, MAP_SHARED, nFd, 0);
+      ::close(nFd);
+      if(m_ptMap == MAP_FAILED) {
+         m_ptMap = nullptr;
+         THROW_ARGOSEXCEPTION("Error mapping trajectory file \"" << str_file_name << "\": " << ::strerror(errno));
+      }
+      const UInt8* punFile = static_cast<const UInt8*>(m_ptMap);
+      try {
+         /* Check the fixed fields */
+         if(::memcmp(punFile, TRAJECTORY_MAGIC, TRAJECTORY_MAGIC_LENGTH) != 0) {
+            THROW_ARGOSEXCEPTION("\"" << str_file_name << "\" is not a trajectory file");
+         }
+         CByteArray cFixed(punFile + TRAJECTORY_MAGIC_LENGTH, 2 * sizeof(UInt32));
+         UInt32 unVersion, unHeaderSize;
+         cFixed >> unVersion >> unHeaderSize;
+         if(unVersion != TRAJECTORY_VERSION) {
+            THROW_ARGOSEXCEPTION("Trajectory file \"" << str_file_name << "\" has version " << unVersion
+                                 << ", expected " << TRAJECTORY_VERSION);
+         }
+         if(unHeaderSize > m_unMapSize || unHeaderSize % 8 != 0) {
+            THROW_ARGOSEXCEPTION("Trajectory file \"" << str_file_name << "\" is truncated");
+         }
+         if(::memcmp(punFile + TRAJECTORY_MAGIC_LENGTH + 2 * sizeof(UInt32),
+                     &TRAJECTORY_BYTE_ORDER_MARK,
+                     sizeof(UInt32)) != 0) {
+            THROW_ARGOSEXCEPTION("Trajectory file \"" << str_file_name << "\" was written on a machine with a different byte order");
+         }
+         /* Parse the rest of the header */
+         size_t unParsed = TRAJECTORY_MAGIC_LENGTH + 3 * sizeof(UInt32);
+         CByteArray cHeader(punFile + unParsed, unHeaderSize - unParsed);
+         double fStepLength;
+         UInt32 unChunkSteps, unNumEntities, unNumChannels, unValueType;
+         cHeader >> fStepLength >> m_unPeriod >> unChunkSteps;
+         m_fStepLength = fStepLength;
+         cHeader >> unNumEntities;
+         m_vecEntityIds.resize(unNumEntities);
+         m_vecEntityTypes.resize(unNumEntities);
+         for(UInt32 e = 0; e < unNumEntities; ++e) {
+            cHeader >> m_vecEntityIds[e] >> m_vecEntityTypes[e];
+         }
+         cHeader >> unNumChannels;
+         m_vecChannels.resize(unNumChannels);
+         size_t unRowSize = 0;
+         for(UInt32 c = 0; c < unNumChannels; ++c) {
+            SChannel& sChannel = m_vecChannels[c];
+            cHeader >> sChannel.Name >> unValueType;
+            sChannel.ValueType = static_cast<ETrajectoryValueType>(unValueType);
+            sChannel.NumValues.resize(unNumEntities);
+            sChannel.Offsets.resize(unNumEntities);
+            sChannel.RowSize = 0;
+            for(UInt32 e = 0; e < unNumEntities; ++e) {
+               cHeader >> sChannel.NumValues[e];
+               sChannel.Offsets[e] = sChannel.RowSize;
+               sChannel.RowSize += sChannel.NumValues[e];
+            }
+            sChannel.PrecedingRowSize = unRowSize;
+            unRowSize += sChannel.RowSize;
+         }
+         /* Index the chunks, ignoring an incomplete one at the end */
+         size_t unOffset = unHeaderSize;
+         while(unOffset + TRAJECTORY_CHUNK_HEADER_SIZE <= m_unMapSize) {
+            const UInt32* punChunk = reinterpret_cast<const UInt32*>(punFile + unOffset);
+            size_t unSteps = punChunk[0];
+            size_t unSize = punChunk[1];
+            if(unSize == 0) {
+               /* The file was extended, but the chunk was never written */
+               break;
+            }
+            if(unSize != TRAJECTORY_CHUNK_HEADER_SIZE + unSteps * (1 + unRowSize) * sizeof(UInt32)) {
+               THROW_ARGOSEXCEPTION("Trajectory file \"" << str_file_name << "\" is corrupted at offset " << unOffset);
+            }
+            if(unOffset + unSize > m_unMapSize) {
+               break;
+            }
+            SChunk sChunk;
+            sChunk.Clocks = punChunk + 2;
+            sChunk.FirstStep = m_unNumSteps;
+            sChunk.Steps = unSteps;
+            m_vecChunks.push_back(sChunk);
+            m_unNumSteps += unSteps;
+            unOffset += unSize;
+         }
+      }
+      catch(CARGoSException& ex) {
+         Close();
+         THROW_ARGOSEXCEPTION_NESTED("Error reading trajectory file \"" << str_file_name << "\"", ex);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTrajectoryReader::Close() {
+      if(m_ptMap != nullptr) {
+         ::munmap(m_ptMap, m_unMapSize);
+         m_ptMap = nullptr;
+      }
+      m_unMapSize = 0;
+      m_vecEntityIds.clear();
+      m_vecEntityTypes.clear();
+      m_vecChannels.clear();
+      m_vecChunks.clear();
+      m_unNumSteps = 0;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CTrajectoryReader::HasChannel(const std::string& str_name) const {
+      for(size_t c = 0; c < m_vecChannels.size(); ++c) {
+         if(m_vecChannels[c].Name == str_name) {
+            return true;
+         }
+      }
+      return false;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   size_t CTrajectoryReader::GetChannelIndex(const std::string& str_name) const {
+      for(size_t c = 0; c < m_vecChannels.size(); ++c) {
+         if(m_vecChannels[c].Name == str_name) {
+            return c;
+         }
+      }
+      THROW_ARGOSEXCEPTION("Trajectory file \"" << m_strFileName << "\" has no channel \"" << str_name << "\"");
+   }
+
+   /****************************************/
+   /****************************************/
+
+   UInt32 CTrajectoryReader::GetClock(size_t un_step) const {
+      const SChunk& sChunk = FindChunk(un_step);
+      return sChunk.Clocks[un_step - sChunk.FirstStep];
+   }
+
+   /****************************************/
+   /****************************************/
+
+   const UInt32* CTrajectoryReader::GetRow(size_t un_channel,
+                                           size_t un_step) const {
+      const SChunk& sChunk = FindChunk(un_step);
+      const SChannel& sChannel = m_vecChannels[un_channel];
+      /* The clock column is followed by the columns of the channels */
+      return sChunk.Clocks +
+         sChunk.Steps * (1 + sChannel.PrecedingRowSize) +
+         (un_step - sChunk.FirstStep) * sChannel.RowSize;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   const CTrajectoryReader::SChunk& CTrajectoryReader::FindChunk(size_t un_step) const {
+      if(un_step >= m_unNumSteps) {
+         THROW_ARGOSEXCEPTION("Step " << un_step << " out of range [0:" << m_unNumSteps << ")");
+      }
+      /* Find the last chunk that starts at or before the wanted step */
+      auto itChunk = std::upper_bound(m_vecChunks.begin(), m_vecChunks.end(), un_step,
+                                      [](size_t un_s, const SChunk& s_chunk) {
+                                         return un_s < s_chunk.FirstStep;
+                                      });
+      return *(itChunk - 1);
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
@@ -0,0 +1,254 @@
+/**
+ * @file <argos3/core/simulator/recorder/trajectory_reader.h>
+ */
+
+#ifndef TRAJECTORY_READER_H
+#define TRAJECTORY_READER_H
+
+namespace argos {
+   class CTrajectoryReader;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+#include <argos3/core/simulator/recorder/trajectory_format.h>
+#include <string>
+#include <vector>
+
+namespace argos {
+
+   /**
+    * Reads a file written by CTrajectoryRecorder.
+    * <p>
+    * The file is mapped in memory, and the values are returned as pointers
+    * into the mapping: reading a channel does not touch the other channels.
+    * The pointers are valid until the reader is closed. A chunk that was
+    * not completely written, e.g., because the simulation crashed, is
+    * ignored.
+    * </p>
+    * <pre>
+    * CTrajectoryReader cReader;
+    * cReader.Open("trajectory.argostrj");
+    * size_t unPose = cReader.GetChannelIndex("pose");
+    * for(size_t s = 0; s < cReader.GetNumSteps(); ++s) {
+    *    for(size_t e = 0; e < cReader.GetNumEntities(); ++e) {
+    *       const float* pfPose = cReader.GetFloats(unPose, s, e);
+    *       ...
+    *    }
+    * }
+    * </pre>
+    * @see CTrajectoryRecorder
+    */
+   class CTrajectoryReader {
+
+   public:
+
+      /**
+       * A channel of the file.
+       */
+      struct SChannel {
+         /** The name of the channel */
+         std::string Name;
+         /** The type of the values */
+         ETrajectoryValueType ValueType;
+         /** The number of values of each entity */
+         std::vector<UInt32> NumValues;
+         /** The offset of the values of each entity in a row */
+         std::vector<UInt32> Offsets;
+         /** The number of values in a row */
+         UInt32 RowSize;
+         /** The number of values in the rows of the previous channels */
+         size_t PrecedingRowSize;
+      };
+
+   public:
+
+      /**
+       * Class constructor.
+       */
+      CTrajectoryReader();
+
+      /**
+       * Class destructor.
+       * Closes the file, if needed.
+       */
+      ~CTrajectoryReader();
+
+      /**
+       * Opens a trajectory file.
+       * @param str_file_name The name of the file.
+       * @throws CARGoSException if the file can't be read or is not a trajectory file.
+       */
+      void Open(const std::string& str_file_name);
+
+      /**
+       * Closes the file.
+       * The pointers returned so far are not valid anymore.
+       */
+      void Close();
+
+      /**
+       * Returns the length of a simulation step, in seconds.
+       * @return The length of a simulation step, in seconds.
+       */
+      inline Real GetStepLength() const {
+         return m_fStepLength;
+      }
+
+      /**
+       * Returns the number of simulation steps between two recorded steps.
+       * @return The number of simulation steps between two recorded steps.
+       */
+      inline UInt32 GetPeriod() const {
+         return m_unPeriod;
+      }
+
+      /**
+       * Returns the number of recorded entities.
+       * @return The number of recorded entities.
+       */
+      inline size_t GetNumEntities() const {
+         return m_vecEntityIds.size();
+      }
+
+      /**
+       * Returns the id of a recorded entity.
+       * @param un_entity The index of the entity.
+       * @return The id of the entity.
+       */
+      inline const std::string& GetEntityId(size_t un_entity) const {
+         return m_vecEntityIds[un_entity];
+      }
+
+      /**
+       * Returns the type of a recorded entity.
+       * @param un_entity The index of the entity.
+       * @return The type of the entity, as returned by CEntity::GetTypeDescription().
+       */
+      inline const std::string& GetEntityType(size_t un_entity) const {
+         return m_vecEntityTypes[un_entity];
+      }
+
+      /**
+       * Returns the number of channels.
+       * @return The number of channels.
+       */
+      inline size_t GetNumChannels() const {
+         return m_vecChannels.size();
+      }
+
+      /**
+       * Returns a channel.
+       * @param un_channel The index of the channel.
+       * @return The channel.
+       */
+      inline const SChannel& GetChannel(size_t un_channel) const {
+         return m_vecChannels[un_channel];
+      }
+
+      /**
+       * Returns <tt>true</tt> if the file contains the given channel.
+       * @param str_name The name of the channel.
+       * @return <tt>true</tt> if the file contains the given channel.
+       */
+      bool HasChannel(const std::string& str_name) const;
+
+      /**
+       * Returns the index of a channel.
+       * @param str_name The name of the channel.
+       * @return The index of the channel.
+       * @throws CARGoSException if the file does not contain the channel.
+       */
+      size_t GetChannelIndex(const std::string& str_name) const;
+
+      /**
+       * Returns the number of recorded steps.
+       * @return The number of recorded steps.
+       */
+      inline size_t GetNumSteps() const {
+         return m_unNumSteps;
+      }
+
+      /**
+       * Returns the simulation clock of a recorded step.
+       * @param un_step The index of the recorded step.
+       * @return The simulation clock of the recorded step.
+       */
+      UInt32 GetClock(size_t un_step) const;
+
+      /**
+       * Returns the number of values of an entity in a channel.
+       * @param un_channel The index of the channel.
+       * @param un_entity The index of the entity.
+       * @return The number of values; 0 if the entity is not recorded in the channel.
+       */
+      inline UInt32 GetNumValues(size_t un_channel,
+                                 size_t un_entity) const {
+         return m_vecChannels[un_channel].NumValues[un_entity];
+      }
+
+      /**
+       * Returns the values of all the entities in a channel at a recorded step.
+       * @param un_channel The index of the channel.
+       * @param un_step The index of the recorded step.
+       * @return The values of all the entities, in the order of the entities.
+       */
+      const UInt32* GetRow(size_t un_channel,
+                           size_t un_step) const;
+
+      /**
+       * Returns the values of an entity in a channel of floats.
+       * @param un_channel The index of the channel.
+       * @param un_step The index of the recorded step.
+       * @param un_entity The index of the entity.
+       * @return The GetNumValues() values of the entity.
+       */
+      inline const float* GetFloats(size_t un_channel,
+                                    size_t un_step,
+                                    size_t un_entity) const {
+         return reinterpret_cast<const float*>(GetRow(un_channel, un_step) +
+                                               m_vecChannels[un_channel].Offsets[un_entity]);
+      }
+
+      /**
+       * Returns the values of an entity in a channel of unsigned integers.
+       * @param un_channel The index of the channel.
+       * @param un_step The index of the recorded step.
+       * @param un_entity The index of the entity.
+       * @return The GetNumValues() values of the entity.
+       */
+      inline const UInt32* GetUInt32s(size_t un_channel,
+                                      size_t un_step,
+                                      size_t un_entity) const {
+         return GetRow(un_channel, un_step) +
+            m_vecChannels[un_channel].Offsets[un_entity];
+      }
+
+   private:
+
+      /** A chunk of the file */
+      struct SChunk {
+         const UInt32* Clocks;
+         size_t FirstStep;
+         size_t Steps;
+      };
+
+      const SChunk& FindChunk(size_t un_step) const;
+
+   private:
+
+      std::string m_strFileName;
+      void* m_ptMap;
+      size_t m_unMapSize;
+      Real m_fStepLength;
+      UInt32 m_unPeriod;
+      std::vector<std::string> m_vecEntityIds;
+      std::vector<std::string> m_vecEntityTypes;
+      std::vector<SChannel> m_vecChannels;
+      std::vector<SChunk> m_vecChunks;
+      size_t m_unNumSteps;
+
+   };
+
+}
+
+#endif
@@ -0,0 +1,529 @@
+/**
+ * @file <argos3/core/simulator/recorder/trajectory_recorder.cpp>
+ */
+
+#include "trajectory_recorder.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <set>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <argos3/core/utility/datatypes/byte_array.h>
+#include <argos3/core/utility/logging/argos_log.h>
+#include <argos3/core/simulator/entity/composable_entity.h>
+#include <argos3/core/simulator/physics_engine/physics_engine.h>
+#include <argos3/core/simulator/space/space.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   CTrajectoryRecorder::CTrajectoryRecorder() :
+      m_unPeriod(1),
+      m_unChunkSteps(256),
+      m_unBuffers(3),
+      m_pcSpace(nullptr),
+      m_unChunkSize(0),
+      m_nFd(-1),
+      m_unFileSize(0),
+      m_bRecording(false),
+      m_psChunk(nullptr),
+      m_bWriting(false),
+      m_bStopWriter(false) {
+      pthread_mutex_init(&m_tMutex, nullptr);
+      pthread_cond_init(&m_tWriterCond, nullptr);
+      pthread_cond_init(&m_tFreeCond, nullptr);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CTrajectoryRecorder::~CTrajectoryRecorder() {
+      if(m_bRecording) {
+         try {
+            Stop();
+         }
+         catch(CARGoSException& ex) {
+            LOGERR << "[WARNING] " << ex.what() << std::endl;
+         }
+      }
+      for(size_t i = 0; i < m_vecGroups.size(); ++i) {
+         for(size_t j = 0; j < m_vecGroups[i].Channels.size(); ++j) {
+            m_vecGroups[i].Channels[j].second->Destroy();
+            delete m_vecGroups[i].Channels[j].second;
+         }
+      }
+      pthread_cond_destroy(&m_tFreeCond);
+      pthread_cond_destroy(&m_tWriterCond);
+      pthread_mutex_destroy(&m_tMutex);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTrajectoryRecorder::Init(TConfigurationNode& t_tree) {
+      try {
+         GetNodeAttribute(t_tree, "file", m_strFileName);
+         GetNodeAttributeOrDefault(t_tree, "period", m_unPeriod, m_unPeriod);
+         if(m_unPeriod == 0) {
+            THROW_ARGOSEXCEPTION("The recording period must be greater than 0");
+         }
+         GetNodeAttributeOrDefault(t_tree, "chunk_steps", m_unChunkSteps, m_unChunkSteps);
+         if(m_unChunkSteps == 0) {
+            THROW_ARGOSEXCEPTION("The number of steps in a chunk must be greater than 0");
+         }
+         GetNodeAttributeOrDefault(t_tree, "buffers", m_unBuffers, m_unBuffers);
+         if(m_unBuffers < 2) {
+            THROW_ARGOSEXCEPTION("At least 2 buffers are needed to record in the background");
+         }
+         /* Create the channels of each entity type */
+         std::set<std::string> setTypes;
+         TConfigurationNodeIterator itEntities("entities");
+         for(itEntities = itEntities.begin(&t_tree);
+             itEntities != itEntities.end();
+             ++itEntities) {
+            m_vecGroups.push_back(SGroup());
+            SGroup& sGroup = m_vecGroups.back();
+            GetNodeAttribute(*itEntities, "type", sGroup.Type);
+            if(!setTypes.insert(sGroup.Type).second) {
+               THROW_ARGOSEXCEPTION("Entity type \"" << sGroup.Type << "\" is listed more than once");
+            }
+            TConfigurationNodeIterator itChannel;
+            for(itChannel = itChannel.begin(&*itEntities);
+                itChannel != itChannel.end();
+                ++itChannel) {
+               CTrajectoryChannel* pcChannel = CFactory<CTrajectoryChannel>::New(itChannel->Value());
+               sGroup.Channels.push_back(std::make_pair(itChannel->Value(), pcChannel));
+               pcChannel->Init(*itChannel);
+            }
+         }
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("Error initializing the trajectory recorder", ex);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   static bool CompareEntitiesById(CComposableEntity* pc_a,
+                                   CComposableEntity* pc_b) {
+      return pc_a->GetId() < pc_b->GetId();
+   }
+
+   void CTrajectoryRecorder::Start(CSpace& c_space) {
+      m_pcSpace = &c_space;
+      /* Select the entities: by group, then by id */
+      std::vector<CComposableEntity*> vecEntities;
+      std::vector<size_t> vecGroups;
+      CEntity::TVector& vecRoots = c_space.GetRootEntityVector();
+      for(size_t g = 0; g < m_vecGroups.size(); ++g) {
+         std::vector<CComposableEntity*> vecGroupEntities;
+         for(size_t i = 0; i < vecRoots.size(); ++i) {
+            auto* pcEntity = dynamic_cast<CComposableEntity*>(vecRoots[i]);
+            if(pcEntity != nullptr &&
+               pcEntity->GetTypeDescription() == m_vecGroups[g].Type) {
+               vecGroupEntities.push_back(pcEntity);
+            }
+         }
+         std::sort(vecGroupEntities.begin(), vecGroupEntities.end(), CompareEntitiesById);
+         vecEntities.insert(vecEntities.end(), vecGroupEntities.begin(), vecGroupEntities.end());
+         vecGroups.insert(vecGroups.end(), vecGroupEntities.size(), g);
+      }
+      for(size_t e = 0; e < vecEntities.size(); ++e) {
+         m_vecEntityIds.push_back(vecEntities[e]->GetId());
+         m_vecEntityTypes.push_back(vecEntities[e]->GetTypeDescription());
+      }
+      /* Lay out the channels, in the order in which they appear first */
+      std::map<std::string, size_t> mapChannels;
+      for(size_t g = 0; g < m_vecGroups.size(); ++g) {
+         for(size_t c = 0; c < m_vecGroups[g].Channels.size(); ++c) {
+            const std::string& strName = m_vecGroups[g].Channels[c].first;
+            ETrajectoryValueType eType = m_vecGroups[g].Channels[c].second->GetValueType();
+            auto itChannel = mapChannels.find(strName);
+            if(itChannel == mapChannels.end()) {
+               mapChannels[strName] = m_vecChannels.size();
+               m_vecChannels.push_back(SChannel());
+               SChannel& sChannel = m_vecChannels.back();
+               sChannel.Name = strName;
+               sChannel.ValueType = eType;
+               sChannel.NumValues.resize(vecEntities.size(), 0);
+               sChannel.RowSize = 0;
+               if(eType == TRAJECTORY_FLOAT32) {
+                  float fNaN = std::numeric_limits<float>::quiet_NaN();
+                  ::memcpy(&sChannel.MissingValue, &fNaN, sizeof(UInt32));
+               }
+               else {
+                  sChannel.MissingValue = 0;
+               }
+            }
+         }
+      }
+      for(size_t e = 0; e < vecEntities.size(); ++e) {
+         const SGroup& sGroup = m_vecGroups[vecGroups[e]];
+         for(size_t c = 0; c < sGroup.Channels.size(); ++c) {
+            SChannel& sChannel = m_vecChannels[mapChannels[sGroup.Channels[c].first]];
+            CTrajectoryChannel* pcChannel = sGroup.Channels[c].second;
+            CEntity* pcSource = pcChannel->GetSource(*vecEntities[e]);
+            if(pcSource == nullptr) continue;
+            UInt32 unNumValues = pcChannel->GetNumValues(*pcSource);
+            if(unNumValues == 0) continue;
+            SSlot sSlot;
+            sSlot.Entity = e;
+            sSlot.Channel = pcChannel;
+            sSlot.Source = pcSource;
+            sSlot.Offset = sChannel.RowSize;
+            sSlot.NumValues = unNumValues;
+            sChannel.Slots.push_back(sSlot);
+            sChannel.NumValues[e] = unNumValues;
+            sChannel.RowSize += unNumValues;
+         }
+      }
+      /* The clock column comes first, then a column per channel */
+      m_unChunkSize = m_unChunkSteps;
+      for(size_t c = 0; c < m_vecChannels.size(); ++c) {
+         m_vecChannels[c].ColumnOffset = m_unChunkSize;
+         m_unChunkSize += static_cast<size_t>(m_unChunkSteps) * m_vecChannels[c].RowSize;
+      }
+      if(TRAJECTORY_CHUNK_HEADER_SIZE + m_unChunkSize * sizeof(UInt32) > std::numeric_limits<UInt32>::max()) {
+         THROW_ARGOSEXCEPTION("Trajectory chunks of " << m_unChunkSteps << " steps are too large, reduce chunk_steps");
+      }
+      /* Open the file and write the header */
+      m_nFd = ::open(m_strFileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+      if(m_nFd < 0) {
+         THROW_ARGOSEXCEPTION("Error opening trajectory file \"" << m_strFileName << "\": " << ::strerror(errno));
+      }
+      m_unFileSize = 0;
+      WriteHeader();
+      /* Allocate the chunks */
+      for(UInt32 i = 0; i < m_unBuffers; ++i) {
+         SChunk* psChunk = new SChunk;
+         psChunk->Values.resize(m_unChunkSize);
+         psChunk->Steps = 0;
+         m_vecAllChunks.push_back(psChunk);
+         m_vecFreeChunks.push_back(psChunk);
+      }
+      m_psChunk = m_vecFreeChunks.back();
+      m_vecFreeChunks.pop_back();
+      /* Start the writer thread */
+      m_bStopWriter = false;
+      m_strWriterError.clear();
+      if(pthread_create(&m_tWriterThread, nullptr, &WriterThread, this) != 0) {
+         THROW_ARGOSEXCEPTION("Error creating the trajectory writer thread: " << ::strerror(errno));
+      }
+      m_bRecording = true;
+      m_vecRootEntities = vecRoots;
+      LOG << "[INFO] Recording " << vecEntities.size()
+          << " entities to \"" << m_strFileName << "\"" << std::endl;
+      Sample();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTrajectoryRecorder::Update() {
+      if(m_bRecording && m_pcSpace->GetSimulationClock() % m_unPeriod == 0) {
+         Sample();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTrajectoryRecorder::Reset() {
+      for(size_t i = 0; i < m_vecGroups.size(); ++i) {
+         for(size_t j = 0; j < m_vecGroups[i].Channels.size(); ++j) {
+            m_vecGroups[i].Channels[j].second->Reset();
+         }
+      }
+      /* Record the state after the reset */
+      if(m_bRecording) {
+         Sample();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTrajectoryRecorder::Flush() {
+      if(!m_bRecording) return;
+      if(m_psChunk->Steps > 0) {
+         HandChunk();
+      }
+      pthread_mutex_lock(&m_tMutex);
+      while(!m_dqPendingChunks.empty() || m_bWriting) {
+         pthread_cond_wait(&m_tFreeCond, &m_tMutex);
+      }
+      pthread_mutex_unlock(&m_tMutex);
+      CheckWriterError();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTrajectoryRecorder::Stop() {
+      if(!m_bRecording) return;
+      /* Write the last steps, even when the writer thread failed */
+      std::string strError;
+      try {
+         Flush();
+      }
+      catch(CARGoSException& ex) {
+         strError = ex.what();
+      }
+      pthread_mutex_lock(&m_tMutex);
+      m_bStopWriter = true;
+      pthread_cond_signal(&m_tWriterCond);
+      pthread_mutex_unlock(&m_tMutex);
+      pthread_join(m_tWriterThread, nullptr);
+      ::close(m_nFd);
+      m_nFd = -1;
+      for(size_t i = 0; i < m_vecAllChunks.size(); ++i) {
+         delete m_vecAllChunks[i];
+      }
+      m_vecAllChunks.clear();
+      m_vecFreeChunks.clear();
+      m_dqPendingChunks.clear();
+      m_psChunk = nullptr;
+      m_bRecording = false;
+      if(!strError.empty()) {
+         THROW_ARGOSEXCEPTION(strError);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTrajectoryRecorder::Sample() {
+      /* Look the entities up again if entities were added or removed */
+      if(m_pcSpace->GetRootEntityVector() != m_vecRootEntities) {
+         Bind();
+      }
+      UInt32 unStep = m_psChunk->Steps;
+      UInt32* punValues = m_psChunk->Values.data();
+      punValues[unStep] = m_pcSpace->GetSimulationClock();
+      for(size_t c = 0; c < m_vecChannels.size(); ++c) {
+         SChannel& sChannel = m_vecChannels[c];
+         UInt32* punRow = punValues + sChannel.ColumnOffset + static_cast<size_t>(unStep) * sChannel.RowSize;
+         for(size_t s = 0; s < sChannel.Slots.size(); ++s) {
+            SSlot& sSlot = sChannel.Slots[s];
+            if(sSlot.Source != nullptr) {
+               sSlot.Channel->Sample(*sSlot.Source, punRow + sSlot.Offset);
+            }
+            else {
+               std::fill(punRow + sSlot.Offset,
+                         punRow + sSlot.Offset + sSlot.NumValues,
+                         sChannel.MissingValue);
+            }
+         }
+      }
+      if(++m_psChunk->Steps == m_unChunkSteps) {
+         HandChunk();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTrajectoryRecorder::Bind() {
+      m_vecRootEntities = m_pcSpace->GetRootEntityVector();
+      std::vector<CComposableEntity*> vecEntities(m_vecEntityIds.size(), nullptr);
+      CEntity::TMap& tEntities = m_pcSpace->GetEntityMapPerId();
+      for(size_t e = 0; e < m_vecEntityIds.size(); ++e) {
+         auto itEntity = tEntities.find(m_vecEntityIds[e]);
+         if(itEntity != tEntities.end()) {
+            auto* pcEntity = dynamic_cast<CComposableEntity*>(itEntity->second);
+            if(pcEntity != nullptr &&
+               !pcEntity->HasParent() &&
+               pcEntity->GetTypeDescription() == m_vecEntityTypes[e]) {
+               vecEntities[e] = pcEntity;
+            }
+         }
+      }
+      for(size_t c = 0; c < m_vecChannels.size(); ++c) {
+         for(size_t s = 0; s < m_vecChannels[c].Slots.size(); ++s) {
+            SSlot& sSlot = m_vecChannels[c].Slots[s];
+            sSlot.Source = nullptr;
+            if(vecEntities[sSlot.Entity] != nullptr) {
+               CEntity* pcSource = sSlot.Channel->GetSource(*vecEntities[sSlot.Entity]);
+               if(pcSource != nullptr &&
+                  sSlot.Channel->GetNumValues(*pcSource) == sSlot.NumValues) {
+                  sSlot.Source = pcSource;
+               }
+            }
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTrajectoryRecorder::WriteHeader() {
+      CByteArray cHeader;
+      cHeader.AddBuffer(reinterpret_cast<const UInt8*>(TRAJECTORY_MAGIC), TRAJECTORY_MAGIC_LENGTH);
+      cHeader << TRAJECTORY_VERSION;
+      /* Placeholder for the header size */
+      size_t unSizePos = cHeader.Size();
+      cHeader << static_cast<UInt32>(0);
+      cHeader.AddBuffer(reinterpret_cast<const UInt8*>(&TRAJECTORY_BYTE_ORDER_MARK), sizeof(UInt32));
+      cHeader << static_cast<double>(CPhysicsEngine::GetSimulationClockTick());
+      cHeader << m_unPeriod;
+      cHeader << m_unChunkSteps;
+      cHeader << static_cast<UInt32>(m_vecEntityIds.size());
+      for(size_t e = 0; e < m_vecEntityIds.size(); ++e) {
+         cHeader << m_vecEntityIds[e] << m_vecEntityTypes[e];
+      }
+      cHeader << static_cast<UInt32>(m_vecChannels.size());
+      for(size_t c = 0; c < m_vecChannels.size(); ++c) {
+         cHeader << m_vecChannels[c].Name;
+         cHeader << static_cast<UInt32>(m_vecChannels[c].ValueType);
+         for(size_t e = 0; e < m_vecEntityIds.size(); ++e) {
+            cHeader << m_vecChannels[c].NumValues[e];
+         }
+      }
+      /* Keep the chunks aligned */
+      while(cHeader.Size() % 8 != 0) {
+         cHeader << static_cast<UInt8>(0);
+      }
+      UInt32 unSize = htonl(static_cast<UInt32>(cHeader.Size()));
+      ::memcpy(cHeader.ToCArray() + unSizePos, &unSize, sizeof(UInt32));
+      void* ptMap;
+      size_t unMapSize;
+      UInt8* punDest = MapForAppend(cHeader.Size(), ptMap, unMapSize);
+      ::memcpy(punDest, cHeader.ToCArray(), cHeader.Size());
+      ::munmap(ptMap, unMapSize);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTrajectoryRecorder::HandChunk() {
+      pthread_mutex_lock(&m_tMutex);
+      if(!m_strWriterError.empty()) {
+         pthread_mutex_unlock(&m_tMutex);
+         CheckWriterError();
+      }
+      m_dqPendingChunks.push_back(m_psChunk);
+      pthread_cond_signal(&m_tWriterCond);
+      /* Wait for the writer thread if it fell behind */
+      while(m_vecFreeChunks.empty()) {
+         pthread_cond_wait(&m_tFreeCond, &m_tMutex);
+      }
+      m_psChunk = m_vecFreeChunks.back();
+      m_vecFreeChunks.pop_back();
+      pthread_mutex_unlock(&m_tMutex);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   UInt8* CTrajectoryRecorder::MapForAppend(size_t un_size,
+                                            void*& pt_map,
+                                            size_t& un_map_size) {
+      size_t unOffset = m_unFileSize;
+      if(::ftruncate(m_nFd, unOffset + un_size) != 0) {
+         THROW_ARGOSEXCEPTION("Error extending trajectory file \"" << m_strFileName << "\": " << ::strerror(errno));
+      }
+      /* The mapping must start at a page boundary */
+      size_t unPageSize = ::sysconf(_SC_PAGESIZE);
+      size_t unMapStart = unOffset - unOffset % unPageSize;
+      un_map_size = unOffset + un_size - unMapStart;
+      pt_map = ::mmap(nullptr, un_map_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_nFd, unMapStart);
+      if(pt_map == MAP_FAILED) {
+         THROW_ARGOSEXCEPTION("Error mapping trajectory file \"" << m_strFileName << "\": " << ::strerror(errno));
+      }
+      m_unFileSize += un_size;
+      return static_cast<UInt8*>(pt_map) + (unOffset - unMapStart);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTrajectoryRecorder::WriteChunk(const SChunk& s_chunk) {
+      /* The first rows of each column are contiguous, so each column is copied at once */
+      size_t unSteps = s_chunk.Steps;
+      size_t unSize = unSteps;
+      for(size_t c = 0; c < m_vecChannels.size(); ++c) {
+         unSize += unSteps * m_vecChannels[c].RowSize;
+      }
+      unSize = TRAJECTORY_CHUNK_HEADER_SIZE + unSize * sizeof(UInt32);
+      void* ptMap;
+      size_t unMapSize;
+      auto* punDest = reinterpret_cast<UInt32*>(MapForAppend(unSize, ptMap, unMapSize));
+      *(punDest++) = static_cast<UInt32>(unSteps);
+      *(punDest++) = static_cast<UInt32>(unSize);
+      ::memcpy(punDest, s_chunk.Values.data(), unSteps * sizeof(UInt32));
+      punDest += unSteps;
+      for(size_t c = 0; c < m_vecChannels.size(); ++c) {
+         size_t unColumn = unSteps * m_vecChannels[c].RowSize;
+         ::memcpy(punDest, s_chunk.Values.data() + m_vecChannels[c].ColumnOffset, unColumn * sizeof(UInt32));
+         punDest += unColumn;
+      }
+      ::munmap(ptMap, unMapSize);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTrajectoryRecorder::CheckWriterError() {
+      pthread_mutex_lock(&m_tMutex);
+      std::string strError = m_strWriterError;
+      pthread_mutex_unlock(&m_tMutex);
+      if(!strError.empty()) {
+         THROW_ARGOSEXCEPTION("Error recording the trajectories: " << strError);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void* CTrajectoryRecorder::WriterThread(void* pt_recorder) {
+      CTrajectoryRecorder& cRecorder = *reinterpret_cast<CTrajectoryRecorder*>(pt_recorder);
+      pthread_mutex_lock(&cRecorder.m_tMutex);
+      while(true) {
+         while(cRecorder.m_dqPendingChunks.empty() && !cRecorder.m_bStopWriter) {
+            pthread_cond_wait(&cRecorder.m_tWriterCond, &cRecorder.m_tMutex);
+         }
+         if(cRecorder.m_dqPendingChunks.empty()) {
+            /* Stop requested and nothing left to write */
+            break;
+         }
+         /* Take the chunk and write it without holding the lock */
+         SChunk* psChunk = cRecorder.m_dqPendingChunks.front();
+         cRecorder.m_dqPendingChunks.pop_front();
+         cRecorder.m_bWriting = true;
+         bool bFailed = !cRecorder.m_strWriterError.empty();
+         pthread_mutex_unlock(&cRecorder.m_tMutex);
+         std::string strError;
+         if(!bFailed) {
+            try {
+               cRecorder.WriteChunk(*psChunk);
+            }
+            catch(CARGoSException& ex) {
+               strError = ex.what();
+            }
+         }
+         pthread_mutex_lock(&cRecorder.m_tMutex);
+         if(!strError.empty()) {
+            cRecorder.m_strWriterError = strError;
+         }
+         cRecorder.m_bWriting = false;
+         psChunk->Steps = 0;
+         cRecorder.m_vecFreeChunks.push_back(psChunk);
+         pthread_cond_broadcast(&cRecorder.m_tFreeCond);
+      }
+      pthread_mutex_unlock(&cRecorder.m_tMutex);
+      return nullptr;
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
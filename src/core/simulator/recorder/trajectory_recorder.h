@@ -0,0 +1,209 @@
+/**
+ * @file <argos3/core/simulator/recorder/trajectory_recorder.h>
+ */
+
+#ifndef TRAJECTORY_RECORDER_H
+#define TRAJECTORY_RECORDER_H
+
+namespace argos {
+   class CTrajectoryRecorder;
+   class CSpace;
+}
+
+#include <argos3/core/utility/configuration/argos_configuration.h>
+#include <argos3/core/utility/datatypes/datatypes.h>
+#include <argos3/core/simulator/entity/entity.h>
+#include <argos3/core/simulator/recorder/trajectory_channel.h>
+#include <deque>
+#include <string>
+#include <vector>
+#include <pthread.h>
+
+namespace argos {
+
+   /**
+    * Records the trajectories of the entities into a binary file.
+    * <p>
+    * The recorder is configured in the <tt>&lt;framework&gt;</tt> section of
+    * the experiment:
+    * </p>
+    * <pre>
+    * &lt;recording file="trajectory.argostrj" period="1" chunk_steps="256"&gt;
+    *   &lt;entities type="foot-bot"&gt;
+    *     &lt;pose /&gt;
+    *     &lt;leds /&gt;
+    *   &lt;/entities&gt;
+    *   &lt;entities type="box"&gt;
+    *     &lt;pose /&gt;
+    *   &lt;/entities&gt;
+    * &lt;/recording&gt;
+    * </pre>
+    * <p>
+    * Each <tt>&lt;entities&gt;</tt> node selects the root entities of a type,
+    * as returned by CEntity::GetTypeDescription(), and lists the channels to
+    * record for them. A channel is a CTrajectoryChannel registered with
+    * REGISTER_TRAJECTORY_CHANNEL(); the name of its node is its label. The
+    * entities are selected when recording starts: entities added later are
+    * not recorded, and the values of the entities removed later are NaN or
+    * 0, depending on the type of the channel.
+    * </p>
+    * <p>
+    * The state is recorded when recording starts and then every
+    * <tt>period</tt> steps. The values are copied into an in-memory chunk of
+    * <tt>chunk_steps</tt> steps, organized in columns. Full chunks are handed
+    * to a writer thread, which appends them to the file through a memory
+    * mapping. The file format is described in trajectory_format.h; use
+    * CTrajectoryReader to read it.
+    * </p>
+    * @see CTrajectoryChannel
+    * @see CTrajectoryReader
+    */
+   class CTrajectoryRecorder {
+
+   public:
+
+      /**
+       * Class constructor.
+       */
+      CTrajectoryRecorder();
+
+      /**
+       * Class destructor.
+       * Stops recording, if needed.
+       */
+      ~CTrajectoryRecorder();
+
+      /**
+       * Parses the <tt>&lt;recording&gt;</tt> XML node and creates the channels.
+       * @param t_tree The <tt>&lt;recording&gt;</tt> XML node.
+       * @throws CARGoSException if the configuration is not valid.
+       */
+      void Init(TConfigurationNode& t_tree);
+
+      /**
+       * Selects the entities, writes the file header and records the current state.
+       * @param c_space The space.
+       * @throws CARGoSException if the file can't be written.
+       */
+      void Start(CSpace& c_space);
+
+      /**
+       * Records the current state, if the simulation clock is a multiple of the period.
+       * Call this method at the end of every step.
+       */
+      void Update();
+
+      /**
+       * Resets the channels.
+       * The recording goes on; the simulation clock stored in the file starts over.
+       */
+      void Reset();
+
+      /**
+       * Writes all the recorded steps to the file and waits for the writer thread to finish.
+       * @throws CARGoSException if the writer thread failed to write the file.
+       */
+      void Flush();
+
+      /**
+       * Writes all the recorded steps to the file, stops the writer thread and closes the file.
+       * @throws CARGoSException if the writer thread failed to write the file.
+       */
+      void Stop();
+
+      /**
+       * Returns the name of the file.
+       * @return The name of the file.
+       */
+      inline const std::string& GetFileName() const {
+         return m_strFileName;
+      }
+
+   private:
+
+      /** A chunk of recorded steps, laid out for the maximum number of steps */
+      struct SChunk {
+         std::vector<UInt32> Values;
+         UInt32 Steps;
+      };
+
+      /** An entity sampled by a channel */
+      struct SSlot {
+         size_t Entity;
+         CTrajectoryChannel* Channel;
+         CEntity* Source;
+         UInt32 Offset;
+         UInt32 NumValues;
+      };
+
+      /** A channel, as stored in the file */
+      struct SChannel {
+         std::string Name;
+         ETrajectoryValueType ValueType;
+         std::vector<UInt32> NumValues;
+         std::vector<SSlot> Slots;
+         UInt32 MissingValue;
+         UInt32 RowSize;
+         size_t ColumnOffset;
+      };
+
+      /** The channels configured for an entity type */
+      struct SGroup {
+         std::string Type;
+         std::vector<std::pair<std::string, CTrajectoryChannel*> > Channels;
+      };
+
+   private:
+
+      void Sample();
+
+      void Bind();
+
+      void WriteHeader();
+
+      void HandChunk();
+
+      UInt8* MapForAppend(size_t un_size,
+                          void*& pt_map,
+                          size_t& un_map_size);
+
+      void WriteChunk(const SChunk& s_chunk);
+
+      void CheckWriterError();
+
+      static void* WriterThread(void* pt_recorder);
+
+   private:
+
+      std::string m_strFileName;
+      UInt32 m_unPeriod;
+      UInt32 m_unChunkSteps;
+      UInt32 m_unBuffers;
+      std::vector<SGroup> m_vecGroups;
+      std::vector<SChannel> m_vecChannels;
+      std::vector<std::string> m_vecEntityIds;
+      std::vector<std::string> m_vecEntityTypes;
+      CSpace* m_pcSpace;
+      CEntity::TVector m_vecRootEntities;
+      size_t m_unChunkSize;
+      int m_nFd;
+      size_t m_unFileSize;
+      bool m_bRecording;
+
+      SChunk* m_psChunk;
+      std::vector<SChunk*> m_vecFreeChunks;
+      std::deque<SChunk*> m_dqPendingChunks;
+      std::vector<SChunk*> m_vecAllChunks;
+      pthread_t m_tWriterThread;
+      pthread_mutex_t m_tMutex;
+      pthread_cond_t m_tWriterCond;
+      pthread_cond_t m_tFreeCond;
+      bool m_bWriting;
+      bool m_bStopWriter;
+      std::string m_strWriterError;
+
+   };
+
+}
+
+#endif
@@ -6,22 +6,36 @@
 
 #include "simulator.h"
 
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #include <argos3/core/utility/logging/argos_log.h>
 #include <argos3/core/utility/profiler/profiler.h>
 #include <argos3/core/utility/string_utilities.h>
 #include <argos3/core/utility/plugins/dynamic_loading.h>
 #include <argos3/core/utility/math/rng.h>
+#include <argos3/core/utility/math/general.h>
 #include <argos3/core/simulator/space/space_no_threads.h>
 #include <argos3/core/simulator/space/space_multi_thread_balance_quantity.h>
 #include <argos3/core/simulator/space/space_multi_thread_balance_length.h>
+#include <argos3/core/simulator/space/space_multi_thread_work_stealing.h>
 #include <argos3/core/simulator/visualization/default_visualization.h>
 #include <argos3/core/simulator/physics_engine/physics_engine.h>
 #include <argos3/core/simulator/loop_functions.h>
+#include <argos3/core/simulator/recorder/trajectory_recorder.h>
 #include <argos3/core/simulator/entity/composable_entity.h>
+#include <argos3/core/simulator/entity/controllable_entity.h>
 #include <argos3/core/simulator/entity/embodied_entity.h>
 
 namespace argos {
@@ -36,9 +50,19 @@ namespace argos {
       m_unMaxSimulationClock(0),
       m_bWasRandomSeedSet(false),
       m_pcProfiler(nullptr),
-      m_bHumanReadableProfile(true),
+      m_eProfileFormat(CProfiler::FORMAT_HUMAN_READABLE),
+      m_pcRecorder(nullptr),
       m_bRealTimeClock(false),
-      m_bTerminated(false) {}
+      m_bTerminated(false),
+      m_bForceNoViz(false),
+      m_bFastReset(false),
+      m_unCheckpointClock(0),
+      m_unBranchClock(0),
+      m_unBranches(0),
+      m_unBranch(0),
+      m_nBranchReportFd(-1),
+      m_fBranchStartTime(0.0),
+      m_bBatchJob(false) {}
 
    /****************************************/
    /****************************************/
@@ -47,6 +71,9 @@ namespace argos {
       if(IsProfiling()) {
          delete m_pcProfiler;
       }
+      if(IsRecording()) {
+         delete m_pcRecorder;
+      }
       /* Delete the visualization */
       if(m_pcVisualization != nullptr) delete m_pcVisualization;
       /* Delete all the media */
@@ -106,6 +133,8 @@ namespace argos {
       /* Build configuration tree */
       m_tConfiguration = t_tree;
       m_tConfigurationRoot = *m_tConfiguration.FirstChildElement();
+      /* Load the plugins the experiment refers to */
+      LoadPlugins(m_tConfigurationRoot);
       /* Init the experiment */
       Init();
       LOG.Flush();
@@ -119,8 +148,10 @@ namespace argos {
       /* Build configuration tree */
       m_tConfiguration.LoadFile(m_strExperimentConfigFileName);
       m_tConfigurationRoot = *m_tConfiguration.FirstChildElement();
-      /* Init the experiment */
+      /* Load the plugins the experiment refers to */
       m_bForceNoViz = b_force_no_viz;
+      LoadPlugins(m_tConfigurationRoot);
+      /* Init the experiment */
       Init();
       LOG.Flush();
       LOGERR.Flush();
@@ -129,6 +160,72 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   /*
+    * Collects the labels a configuration node and its descendants may refer to:
+    * the name of each node and, for sensors and actuators, the name followed
+    * by the implementation.
+    */
+   static void CollectPluginLabels(TConfigurationNode& t_node,
+                                   std::set<std::string>& set_labels) {
+      set_labels.insert(t_node.Value());
+      if(NodeAttributeExists(t_node, "implementation")) {
+         std::string strImpl;
+         GetNodeAttribute(t_node, "implementation", strImpl);
+         set_labels.insert(t_node.Value() + " (" + strImpl + ")");
+      }
+      TConfigurationNodeIterator itChild;
+      for(itChild = itChild.begin(&t_node);
+          itChild != itChild.end();
+          ++itChild) {
+         CollectPluginLabels(*itChild, set_labels);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSimulator::LoadPlugins(TConfigurationNode& t_root) {
+      std::set<std::string> setLabels;
+      std::vector<std::string> vecUserLibraries;
+      std::string strLibrary;
+      TConfigurationNodeIterator itSection;
+      for(itSection = itSection.begin(&t_root);
+          itSection != itSection.end();
+          ++itSection) {
+         /* Skip the visualization if it is not going to be used */
+         if(m_bForceNoViz && itSection->Value() == "visualization") {
+            continue;
+         }
+         CollectPluginLabels(*itSection, setLabels);
+         /* Collect the user libraries of the loop functions and the controllers */
+         if(itSection->Value() == "loop_functions" &&
+            NodeAttributeExists(*itSection, "library")) {
+            GetNodeAttribute(*itSection, "library", strLibrary);
+            if(! strLibrary.empty()) {
+               vecUserLibraries.push_back(strLibrary);
+            }
+         }
+         else if(itSection->Value() == "controllers") {
+            TConfigurationNodeIterator itController;
+            for(itController = itController.begin(&*itSection);
+                itController != itController.end();
+                ++itController) {
+               if(NodeAttributeExists(*itController, "library")) {
+                  GetNodeAttribute(*itController, "library", strLibrary);
+                  vecUserLibraries.push_back(strLibrary);
+               }
+            }
+         }
+      }
+      CDynamicLoading::LoadLibrariesProviding(setLabels);
+      for(size_t i = 0; i < vecUserLibraries.size(); ++i) {
+         CDynamicLoading::LoadLibrary(vecUserLibraries[i]);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CSimulator::Init() {
       /* General configuration */
       InitFramework(GetNode(m_tConfigurationRoot, "framework"));
@@ -157,6 +254,16 @@ namespace argos {
       InitPhysics2();
       /* Media */
       InitMedia2();
+      /* Start recording, if needed */
+      if(IsRecording()) {
+         m_pcRecorder->Start(*m_pcSpace);
+      }
+      /* Take the snapshot restored by Reset(), if requested */
+      if(m_bFastReset) {
+         m_cResetSnapshot.Clear();
+         SaveSimulationState(m_cResetSnapshot);
+         m_vecResetSnapshotEntities = m_pcSpace->GetRootEntityVector();
+      }
       /* Initialise visualization */
       TConfigurationNodeIterator itVisualization;
       if((!m_bForceNoViz) && NodeExists(m_tConfigurationRoot, "visualization") &&
@@ -167,8 +274,21 @@ namespace argos {
          LOG << "[INFO] No visualization selected." << std::endl;
          m_pcVisualization = new CDefaultVisualization();
       }
+      /* Check that the experiment can be branched as scheduled */
+      if(m_unBranchClock > 0) {
+         CheckBranching();
+      }
       /* Start profiling, if needed */
       if(IsProfiling()) {
+         std::vector<std::string> vecPhysicsEngines;
+         for(size_t i = 0; i < m_vecPhysicsEngines.size(); ++i) {
+            vecPhysicsEngines.push_back(m_vecPhysicsEngines[i]->GetId());
+         }
+         std::vector<std::string> vecMedia;
+         for(size_t i = 0; i < m_vecMedia.size(); ++i) {
+            vecMedia.push_back(m_vecMedia[i]->GetId());
+         }
+         m_pcProfiler->InitPhaseProfiling(m_unThreads, vecPhysicsEngines, vecMedia);
          m_pcProfiler->Start();
       }
    }
@@ -177,6 +297,7 @@ namespace argos {
    /****************************************/
 
    void CSimulator::Reset() {
+      double fStart = CProfiler::GetTime();
       /* Reset terminated flag */
       m_bTerminated = false;
       /* if random seed is 0 or is not specified, init with the current timeval */
@@ -193,20 +314,31 @@ namespace argos {
          LOG << "[INFO] Using random seed = " << m_unRandomSeed << std::endl;
       }
       CRandom::GetCategory("argos").ResetRNGs();
-      /* Reset the space */
-      m_pcSpace->Reset();
-      /* Reset the media */
-      for(auto it = m_mapMedia.begin();
-          it != m_mapMedia.end(); ++it) {
-         it->second->Reset();
-      }
-      /* Reset the physics engines */
-      for(auto it = m_mapPhysicsEngines.begin();
-          it != m_mapPhysicsEngines.end(); ++it) {
-         it->second->Reset();
+      bool bFast = m_bFastReset && FastReset();
+      if(!bFast) {
+         /* Reset the space */
+         m_pcSpace->Reset();
+         /* Reset the media */
+         for(auto it = m_mapMedia.begin();
+             it != m_mapMedia.end(); ++it) {
+            it->second->Reset();
+         }
+         /* Reset the physics engines */
+         for(auto it = m_mapPhysicsEngines.begin();
+             it != m_mapPhysicsEngines.end(); ++it) {
+            it->second->Reset();
+         }
       }
       /* Reset the loop functions */
       m_pcLoopFunctions->Reset();
+      /* Record the state after the reset */
+      if(IsRecording()) {
+         m_pcRecorder->Reset();
+      }
+      if(IsProfiling()) {
+         m_pcProfiler->CollectResetTime(bFast ? "fast" : "full",
+                                        CProfiler::GetTime() - fStart);
+      }
       LOG.Flush();
       LOGERR.Flush();
    }
@@ -214,6 +346,175 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   bool CSimulator::FastReset() {
+      /* The snapshot is valid as long as the same entities are in the space */
+      if(m_cResetSnapshot.Empty()) {
+         return false;
+      }
+      if(m_pcSpace->GetRootEntityVector() != m_vecResetSnapshotEntities) {
+         LOGERR << "[WARNING] Entities were added or removed since Init(), falling back to full resets" << std::endl;
+         m_cResetSnapshot.Clear();
+         return false;
+      }
+      /*
+       * Reset the space and the entities, including the controllers, as
+       * usual: part of their state, such as the turret of the foot-bot, is
+       * not in the snapshot
+       */
+      m_pcSpace->Reset();
+      /* Restore the state of the entities, physics engines and media */
+      CByteArray cSnapshot(m_cResetSnapshot);
+      LoadSimulationState(cSnapshot);
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   static const char  CHECKPOINT_MAGIC[]  = "ARGOSCKP";
+   static const UInt32 CHECKPOINT_VERSION = 3;
+
+   void CSimulator::SaveSimulationState(CByteArray& c_buffer) {
+      /* Space and entities */
+      SaveMementoBlock(c_buffer, *m_pcSpace);
+      /* Physics engines */
+      c_buffer << static_cast<UInt32>(m_vecPhysicsEngines.size());
+      for(size_t i = 0; i < m_vecPhysicsEngines.size(); ++i) {
+         CByteArray cBlock;
+         cBlock << m_vecPhysicsEngines[i]->GetId();
+         m_vecPhysicsEngines[i]->SaveState(cBlock);
+         AddMementoBlock(c_buffer, cBlock);
+      }
+      /* Media */
+      c_buffer << static_cast<UInt32>(m_vecMedia.size());
+      for(size_t i = 0; i < m_vecMedia.size(); ++i) {
+         CByteArray cBlock;
+         cBlock << m_vecMedia[i]->GetId();
+         m_vecMedia[i]->SaveState(cBlock);
+         AddMementoBlock(c_buffer, cBlock);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSimulator::LoadSimulationState(CByteArray& c_buffer) {
+      /* Space and entities */
+      CMementoBlockReader cReader(c_buffer);
+      cReader.LoadNextBlock(*m_pcSpace);
+      cReader.Finish();
+      /* Move the entities that crossed an engine boundary to the engine that houses them */
+      CSpace::TMapPerTypePerId::iterator itBodies = m_pcSpace->GetEntityMapPerTypePerId().find("body");
+      if(itBodies != m_pcSpace->GetEntityMapPerTypePerId().end()) {
+         for(auto it = itBodies->second.begin(); it != itBodies->second.end(); ++it) {
+            auto& cBody = *any_cast<CEmbodiedEntity*>(it->second);
+            if(cBody.IsMovable() && cBody.GetPhysicsModelsNum() > 0) {
+               CPhysicsEngine& cEngine = cBody.GetPhysicsModel(0).GetEngine();
+               if(!cEngine.IsPointContained(cBody.GetOriginAnchor().Position)) {
+                  cEngine.RemoveEntity(cBody.GetRootEntity());
+                  m_pcSpace->AddEntityToPhysicsEngine(cBody);
+               }
+            }
+         }
+      }
+      /* Physics engines */
+      UInt32 unNum;
+      CByteArray cBlock;
+      std::string strId;
+      c_buffer >> unNum;
+      for(UInt32 i = 0; i < unNum; ++i) {
+         cReader.NextBlock(cBlock);
+         cBlock >> strId;
+         GetPhysicsEngine(strId).LoadState(cBlock);
+      }
+      cReader.Finish();
+      for(size_t i = 0; i < m_vecPhysicsEngines.size(); ++i) {
+         m_vecPhysicsEngines[i]->PostUpdate();
+      }
+      /* Media */
+      c_buffer >> unNum;
+      for(UInt32 i = 0; i < unNum; ++i) {
+         cReader.NextBlock(cBlock);
+         cBlock >> strId;
+         GetMedium<CMedium>(strId).LoadState(cBlock);
+      }
+      cReader.Finish();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSimulator::SaveCheckpoint(const std::string& str_file_name) {
+      CByteArray cData;
+      /* Header */
+      cData.AddBuffer(reinterpret_cast<const UInt8*>(CHECKPOINT_MAGIC),
+                      sizeof(CHECKPOINT_MAGIC) - 1);
+      cData << CHECKPOINT_VERSION;
+      /* Space, entities, physics engines and media */
+      SaveSimulationState(cData);
+      /* Loop functions */
+      SaveMementoBlock(cData, *m_pcLoopFunctions);
+      /* Random number generators */
+      CByteArray cRandom;
+      CRandom::SaveState(cRandom);
+      AddMementoBlock(cData, cRandom);
+      /* Write the file */
+      std::ofstream cFile(str_file_name.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+      if(!cFile.write(reinterpret_cast<const char*>(cData.ToCArray()), cData.Size())) {
+         THROW_ARGOSEXCEPTION("Error writing checkpoint file \"" << str_file_name << "\"");
+      }
+      LOG << "[INFO] Checkpoint saved to \"" << str_file_name
+          << "\" at step " << m_pcSpace->GetSimulationClock() << std::endl;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSimulator::LoadCheckpoint(const std::string& str_file_name) {
+      /* Read the file */
+      std::ifstream cFile(str_file_name.c_str(), std::ios::in | std::ios::binary);
+      if(!cFile) {
+         THROW_ARGOSEXCEPTION("Error opening checkpoint file \"" << str_file_name << "\"");
+      }
+      std::vector<char> vecFile((std::istreambuf_iterator<char>(cFile)),
+                                std::istreambuf_iterator<char>());
+      /* Check the header */
+      const size_t unHeaderSize = sizeof(CHECKPOINT_MAGIC) - 1;
+      if(vecFile.size() < unHeaderSize + sizeof(UInt32) ||
+         ::memcmp(vecFile.data(), CHECKPOINT_MAGIC, unHeaderSize) != 0) {
+         THROW_ARGOSEXCEPTION("File \"" << str_file_name << "\" is not an ARGoS checkpoint");
+      }
+      CByteArray cData(reinterpret_cast<const UInt8*>(vecFile.data()) + unHeaderSize,
+                       vecFile.size() - unHeaderSize);
+      vecFile.clear();
+      UInt32 unVersion;
+      cData >> unVersion;
+      if(unVersion != CHECKPOINT_VERSION) {
+         THROW_ARGOSEXCEPTION("Checkpoint file \"" << str_file_name << "\" has version " << unVersion <<
+                              ", expected " << CHECKPOINT_VERSION);
+      }
+      try {
+         /* Space, entities, physics engines and media */
+         LoadSimulationState(cData);
+         CMementoBlockReader cReader(cData);
+         CByteArray cBlock;
+         /* Loop functions */
+         cReader.LoadNextBlock(*m_pcLoopFunctions);
+         /* Random number generators, last, so that nothing above perturbs them */
+         cReader.NextBlock(cBlock);
+         CRandom::LoadState(cBlock);
+         cReader.Finish();
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("Error restoring checkpoint file \"" << str_file_name << "\"", ex);
+      }
+      LOG << "[INFO] Checkpoint restored from \"" << str_file_name
+          << "\" at step " << m_pcSpace->GetSimulationClock() << std::endl;
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CSimulator::Destroy() {
       /* Call user destroy function */
       if (m_pcLoopFunctions != nullptr) {
@@ -221,6 +522,17 @@ namespace argos {
          delete m_pcLoopFunctions;
          m_pcLoopFunctions = nullptr;
       }
+      /* Write the last recorded steps */
+      if(IsRecording()) {
+         try {
+            m_pcRecorder->Stop();
+         }
+         catch(CARGoSException& ex) {
+            LOGERR << "[ERROR] " << ex.what() << std::endl;
+         }
+         delete m_pcRecorder;
+         m_pcRecorder = nullptr;
+      }
       /* Destroy the visualization */
       if(m_pcVisualization != nullptr) {
          m_pcVisualization->Destroy();
@@ -261,8 +573,11 @@ namespace argos {
       /* Stop profiling and flush the data */
       if(IsProfiling()) {
          m_pcProfiler->Stop();
-         m_pcProfiler->Flush(m_bHumanReadableProfile);
+         m_pcProfiler->Flush(m_eProfileFormat);
       }
+      /* Write the pending log output and stop the writer threads */
+      LOG.DisableAsyncWriter();
+      LOGERR.DisableAsyncWriter();
       LOG.Flush();
       LOGERR.Flush();
    }
@@ -272,6 +587,10 @@ namespace argos {
 
    void CSimulator::Execute() {
       m_pcVisualization->Execute();
+      /* A branch reports its outcome to the process that forked it */
+      if(m_nBranchReportFd >= 0) {
+         ReportBranch();
+      }
    }
 
    /****************************************/
@@ -280,6 +599,227 @@ namespace argos {
    void CSimulator::UpdateSpace() {
       /* Update the space */
       m_pcSpace->Update();
+      /* Record the new state */
+      if(IsRecording()) {
+         m_pcRecorder->Update();
+      }
+      /* Save the checkpoint, if scheduled for this step */
+      if(m_unCheckpointClock > 0 &&
+         m_pcSpace->GetSimulationClock() == m_unCheckpointClock) {
+         SaveCheckpoint(m_strCheckpointFileName);
+      }
+      /* Fork the branches, if scheduled for this step */
+      if(m_unBranchClock > 0 && m_unBranch == 0 &&
+         m_pcSpace->GetSimulationClock() == m_unBranchClock) {
+         Branch(m_unBranches);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   /*
+    * Returns the time elapsed on a monotonic clock, in seconds.
+    */
+   static Real MonotonicSeconds() {
+      return std::chrono::duration<Real>(std::chrono::steady_clock::now().time_since_epoch()).count();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   UInt32 CSimulator::Branch(UInt32 un_branches) {
+      if(un_branches == 0) {
+         THROW_ARGOSEXCEPTION("The number of branches must be greater than 0");
+      }
+      /* A scheduled branching was checked by Init() */
+      if(m_unBranchClock == 0) {
+         CheckBranching();
+      }
+      /* The log writer threads do not survive fork() either: stop them until the branches are forked */
+      bool bAsyncLog = LOG.IsAsyncWriter();
+      bool bAsyncLogErr = LOGERR.IsAsyncWriter();
+      LOG.DisableAsyncWriter();
+      LOGERR.DisableAsyncWriter();
+      LOG << "[INFO] Branching the experiment into " << un_branches
+          << " branches at step " << m_pcSpace->GetSimulationClock() << std::endl;
+      LOG.Flush();
+      LOGERR.Flush();
+      std::fflush(nullptr);
+      /* Fork the branches */
+      std::vector<pid_t> vecPids;
+      std::vector<int> vecFds;
+      for(UInt32 i = 1; i <= un_branches; ++i) {
+         int pnFds[2];
+         pid_t tPid = -1;
+         if(::pipe(pnFds) == 0) {
+            tPid = ::fork();
+            if(tPid < 0) {
+               ::close(pnFds[0]);
+               ::close(pnFds[1]);
+            }
+         }
+         if(tPid < 0) {
+            /* Don't leave half of the branches running */
+            std::string strError(::strerror(errno));
+            for(size_t j = 0; j < vecPids.size(); ++j) {
+               ::kill(vecPids[j], SIGKILL);
+               ::close(vecFds[j]);
+               while(::waitpid(vecPids[j], nullptr, 0) < 0 && errno == EINTR);
+            }
+            if(bAsyncLog) LOG.EnableAsyncWriter();
+            if(bAsyncLogErr) LOGERR.EnableAsyncWriter();
+            THROW_ARGOSEXCEPTION("Error forking branch " << i << ": " << strError);
+         }
+         if(tPid == 0) {
+            /* Branch: keep only the write end of its own pipe */
+            ::close(pnFds[0]);
+            for(size_t j = 0; j < vecFds.size(); ++j) {
+               ::close(vecFds[j]);
+            }
+            m_unBranch = i;
+            m_nBranchReportFd = pnFds[1];
+            m_fBranchStartTime = MonotonicSeconds();
+            m_vecBranchResults.clear();
+            /* Give the branch its own random streams */
+            CRandom::ReseedAll(i);
+            m_unRandomSeed = CRandom::GetSeedOf("argos");
+            if(bAsyncLog) LOG.EnableAsyncWriter();
+            if(bAsyncLogErr) LOGERR.EnableAsyncWriter();
+            return i;
+         }
+         ::close(pnFds[1]);
+         vecPids.push_back(tPid);
+         vecFds.push_back(pnFds[0]);
+      }
+      /*
+       * Collect the reports. A branch writes its report once, at the end, so
+       * reading the pipes one after the other does not block the others.
+       */
+      m_vecBranchResults.clear();
+      char pchBuffer[1024];
+      for(size_t i = 0; i < vecPids.size(); ++i) {
+         std::string strReport;
+         ssize_t nRead;
+         while((nRead = ::read(vecFds[i], pchBuffer, sizeof(pchBuffer))) != 0) {
+            if(nRead > 0) {
+               strReport.append(pchBuffer, nRead);
+            }
+            else if(errno != EINTR) {
+               break;
+            }
+         }
+         ::close(vecFds[i]);
+         int nStatus = 0;
+         while(::waitpid(vecPids[i], &nStatus, 0) < 0 && errno == EINTR);
+         /* Parse the report: seed, steps, run time, result */
+         SBranchResult sResult;
+         sResult.Branch = i + 1;
+         sResult.Seed = 0;
+         sResult.Steps = 0;
+         sResult.RunTime = 0.0;
+         sResult.Success = WIFEXITED(nStatus) && WEXITSTATUS(nStatus) == 0 && !strReport.empty();
+         std::istringstream cReport(strReport);
+         std::string strField;
+         if(std::getline(cReport, strField, '\t')) sResult.Seed = FromString<UInt32>(strField);
+         if(std::getline(cReport, strField, '\t')) sResult.Steps = FromString<UInt32>(strField);
+         if(std::getline(cReport, strField, '\t')) sResult.RunTime = FromString<Real>(strField);
+         std::getline(cReport, sResult.Result);
+         if(!sResult.Success) {
+            if(WIFSIGNALED(nStatus)) {
+               sResult.Result = "killed by signal " + ToString(WTERMSIG(nStatus));
+            }
+            else {
+               sResult.Result = "exited with code " + ToString(WEXITSTATUS(nStatus));
+            }
+         }
+         m_vecBranchResults.push_back(sResult);
+      }
+      if(bAsyncLog) LOG.EnableAsyncWriter();
+      if(bAsyncLogErr) LOGERR.EnableAsyncWriter();
+      /* Log the results and write the summary */
+      std::ofstream cSummary;
+      if(!m_strBranchSummaryFileName.empty()) {
+         cSummary.open(m_strBranchSummaryFileName.c_str(), std::ios::out | std::ios::trunc);
+         if(!cSummary) {
+            THROW_ARGOSEXCEPTION("Error opening branch summary file \"" << m_strBranchSummaryFileName << "\"");
+         }
+         cSummary << "# branch\tstatus\tseed\tsteps\trun_time\tresult" << std::endl;
+      }
+      for(size_t i = 0; i < m_vecBranchResults.size(); ++i) {
+         const SBranchResult& sResult = m_vecBranchResults[i];
+         if(sResult.Success) {
+            LOG << "[INFO] Branch " << sResult.Branch
+                << " finished at step " << sResult.Steps
+                << " (seed " << sResult.Seed << ")";
+            if(!sResult.Result.empty()) {
+               LOG << ": " << sResult.Result;
+            }
+            LOG << std::endl;
+         }
+         else {
+            LOGERR << "[WARNING] Branch " << sResult.Branch
+                   << " failed: " << sResult.Result << std::endl;
+         }
+         if(cSummary.is_open()) {
+            cSummary << sResult.Branch << '\t'
+                     << (sResult.Success ? "ok" : "failed") << '\t'
+                     << sResult.Seed << '\t'
+                     << sResult.Steps << '\t'
+                     << sResult.RunTime << '\t'
+                     << sResult.Result << std::endl;
+         }
+      }
+      /* The branches carried the experiment on */
+      Terminate();
+      return 0;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSimulator::CheckBranching() const {
+      if(m_unThreads > 0) {
+         THROW_ARGOSEXCEPTION("Branching the experiment requires threads=\"0\", as threads do not survive fork()");
+      }
+      if(dynamic_cast<CDefaultVisualization*>(m_pcVisualization) == nullptr) {
+         THROW_ARGOSEXCEPTION("Branching the experiment is not possible with a visualization");
+      }
+      if(IsRecording()) {
+         THROW_ARGOSEXCEPTION("Branching the experiment is not possible while recording the trajectories, as the branches would write the same file");
+      }
+      if(m_bBatchJob) {
+         THROW_ARGOSEXCEPTION("Branching the experiment is not possible in a batch job, as the branches would share the report of the job");
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSimulator::ReportBranch() {
+      std::string strResult = m_pcLoopFunctions->GetResult();
+      for(size_t i = 0; i < strResult.size(); ++i) {
+         if(strResult[i] == '\t' || strResult[i] == '\n' || strResult[i] == '\r') {
+            strResult[i] = ' ';
+         }
+      }
+      std::ostringstream cReport;
+      cReport << m_unRandomSeed << '\t'
+              << m_pcSpace->GetSimulationClock() << '\t'
+              << (MonotonicSeconds() - m_fBranchStartTime) << '\t'
+              << strResult;
+      std::string strReport = cReport.str();
+      size_t unWritten = 0;
+      while(unWritten < strReport.size()) {
+         ssize_t nRet = ::write(m_nBranchReportFd, strReport.data() + unWritten, strReport.size() - unWritten);
+         if(nRet < 0) {
+            if(errno == EINTR) continue;
+            break;
+         }
+         unWritten += nRet;
+      }
+      ::close(m_nBranchReportFd);
+      m_nBranchReportFd = -1;
    }
 
    /****************************************/
@@ -346,6 +886,15 @@ namespace argos {
                                          fExpLength,
                                          0.0f);
          m_unMaxSimulationClock = static_cast<UInt32>(fExpLength * unTicksPerSec);
+         /* Set the fast reset, if requested */
+         GetNodeAttributeOrDefault(tExperiment, "fast_reset", m_bFastReset, m_bFastReset);
+         /* Set the branching, if requested */
+         GetNodeAttributeOrDefault(tExperiment, "branch_at", m_unBranchClock, m_unBranchClock);
+         GetNodeAttributeOrDefault(tExperiment, "branches", m_unBranches, m_unBranches);
+         GetNodeAttributeOrDefault(tExperiment, "branch_summary", m_strBranchSummaryFileName, m_strBranchSummaryFileName);
+         if(m_unBranchClock > 0 && m_unBranches == 0) {
+            THROW_ARGOSEXCEPTION("Attribute \"branch_at\" requires \"branches\" to be greater than 0");
+         }
          LOG << "[INFO] Total experiment length in clock ticks = "
              << (m_unMaxSimulationClock ? ToString(m_unMaxSimulationClock) : "unlimited")
              << std::endl;
@@ -362,18 +911,29 @@ namespace argos {
             std::string strFormat;
             GetNodeAttribute(tProfiling, "format", strFormat);
             if(strFormat == "human_readable") {
-               m_bHumanReadableProfile = true;
+               m_eProfileFormat = CProfiler::FORMAT_HUMAN_READABLE;
             }
             else if(strFormat == "table") {
-               m_bHumanReadableProfile = false;
+               m_eProfileFormat = CProfiler::FORMAT_TABLE;
+            }
+            else if(strFormat == "csv") {
+               m_eProfileFormat = CProfiler::FORMAT_CSV;
+            }
+            else if(strFormat == "json") {
+               m_eProfileFormat = CProfiler::FORMAT_JSON;
             }
             else {
-               THROW_ARGOSEXCEPTION("Unrecognized profile format \"" << strFormat << "\". Accepted values are \"human_readable\" and \"table\".");
+               THROW_ARGOSEXCEPTION("Unrecognized profile format \"" << strFormat << "\". Accepted values are \"human_readable\", \"table\", \"csv\", and \"json\".");
             }
             bool bTrunc = true;
             GetNodeAttributeOrDefault(tProfiling, "truncate_file", bTrunc, bTrunc);
             m_pcProfiler = new CProfiler(strFile, bTrunc);
          }
+         /* Get the recording tag, if present */
+         if(NodeExists(t_tree, "recording")) {
+            m_pcRecorder = new CTrajectoryRecorder;
+            m_pcRecorder->Init(GetNode(t_tree, "recording"));
+         }
       }
       catch(CARGoSException& ex) {
          THROW_ARGOSEXCEPTION_NESTED("Failed to initialize the simulator. Parse error inside the <framework> tag.", ex);
@@ -382,11 +942,48 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CSimulator::InitFrameworkSystemLog(TConfigurationNode& t_tree) {
+      /* Is LOG enabled? LOGERR is never disabled, so that errors are always shown */
+      std::string strLogLevel = "all";
+      GetNodeAttributeOrDefault(t_tree, "log_level", strLogLevel, strLogLevel);
+      if(strLogLevel == "all") {
+         LOG.SetEnabled(true);
+      }
+      else if(strLogLevel == "errors" || strLogLevel == "none") {
+         LOG.SetEnabled(false);
+      }
+      else {
+         THROW_ARGOSEXCEPTION("Error parsing the <system> tag. Unknown log level \"" << strLogLevel << "\". Available levels: \"all\", \"errors\", and \"none\".");
+      }
+      /* Keep the LOG messages of one tick every log_sampling_period */
+      UInt32 unSamplingPeriod = 1;
+      GetNodeAttributeOrDefault(t_tree, "log_sampling_period", unSamplingPeriod, unSamplingPeriod);
+      if(unSamplingPeriod == 0) {
+         THROW_ARGOSEXCEPTION("Error parsing the <system> tag. The log sampling period must be greater than zero.");
+      }
+      LOG.SetSamplingPeriod(unSamplingPeriod);
+      /* Write the logs from a separate thread? */
+      bool bAsyncLog = false;
+      GetNodeAttributeOrDefault(t_tree, "async_log", bAsyncLog, bAsyncLog);
+      if(bAsyncLog) {
+         LOG.EnableAsyncWriter();
+         LOGERR.EnableAsyncWriter();
+      }
+      else {
+         LOG.DisableAsyncWriter();
+         LOGERR.DisableAsyncWriter();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CSimulator::InitFrameworkSystem(TConfigurationNode& t_tree) {
      if(NodeExists(t_tree, "system")) {
        TConfigurationNode tSystem;
        tSystem = GetNode(t_tree, "system");
       GetNodeAttributeOrDefault(tSystem, "threads", m_unThreads, m_unThreads);
+      InitFrameworkSystemLog(tSystem);
 
        if(m_unThreads == 0) {
          m_pcSpace = new CSpaceNoThreads();
@@ -401,10 +998,17 @@ namespace argos {
            m_pcSpace = new CSpaceMultiThreadBalanceQuantity(m_unThreads, bPinThreadsToCores);
          }
          else if(strThreadingMethod == "balance_length") {
-           m_pcSpace = new CSpaceMultiThreadBalanceLength(m_unThreads, bPinThreadsToCores);
+           UInt32 unRepartitionPeriod = 0;
+           GetNodeAttributeOrDefault(tSystem, "repartition_period", unRepartitionPeriod, unRepartitionPeriod);
+           m_pcSpace = new CSpaceMultiThreadBalanceLength(m_unThreads, bPinThreadsToCores, unRepartitionPeriod);
+         }
+         else if(strThreadingMethod == "work_stealing") {
+           UInt32 unChunkSize = 0;
+           GetNodeAttributeOrDefault(tSystem, "chunk_size", unChunkSize, unChunkSize);
+           m_pcSpace = new CSpaceMultiThreadWorkStealing(m_unThreads, bPinThreadsToCores, unChunkSize);
          }
          else {
-           THROW_ARGOSEXCEPTION("Error parsing the <system> tag. Unknown threading method \"" << strThreadingMethod << "\". Available methods: \"balance_quantity\" and \"balance_length\".");
+           THROW_ARGOSEXCEPTION("Error parsing the <system> tag. Unknown threading method \"" << strThreadingMethod << "\". Available methods: \"balance_quantity\", \"balance_length\", and \"work_stealing\".");
          }
        }
      }
@@ -491,6 +1095,62 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   /**
+    * Splits the XY projection of the arena in a grid of tiles. Among the
+    * grids with the wanted number of tiles, the one whose tiles are the
+    * closest to squares is chosen. The tiles on the border of the arena
+    * are extended outwards, so entities slightly outside the arena still
+    * belong to a tile.
+    */
+   static void CalculateArenaTiles(std::vector<std::vector<CVector2> >& vec_tiles,
+                                   UInt32 un_count,
+                                   const CVector3& c_arena_center,
+                                   const CVector3& c_arena_size) {
+      /* Pick the grid layout */
+      UInt32 unCols = 1;
+      Real fBestScore = -1.0;
+      for(UInt32 unC = 1; unC <= un_count; ++unC) {
+         if(un_count % unC != 0) continue;
+         UInt32 unR = un_count / unC;
+         Real fScore = Abs(Log((c_arena_size.GetX() / unC) /
+                               (c_arena_size.GetY() / unR)));
+         if(fBestScore < 0.0 || fScore < fBestScore) {
+            fBestScore = fScore;
+            unCols = unC;
+         }
+      }
+      UInt32 unRows = un_count / unCols;
+      /* Calculate the tiles */
+      Real fMargin = Max(c_arena_size.GetX(), c_arena_size.GetY());
+      CVector2 cMin(c_arena_center.GetX() - c_arena_size.GetX() / 2.0,
+                    c_arena_center.GetY() - c_arena_size.GetY() / 2.0);
+      Real fTileX = c_arena_size.GetX() / unCols;
+      Real fTileY = c_arena_size.GetY() / unRows;
+      vec_tiles.clear();
+      for(UInt32 unR = 0; unR < unRows; ++unR) {
+         for(UInt32 unC = 0; unC < unCols; ++unC) {
+            Real fMinX = cMin.GetX() + unC * fTileX;
+            Real fMaxX = fMinX + fTileX;
+            Real fMinY = cMin.GetY() + unR * fTileY;
+            Real fMaxY = fMinY + fTileY;
+            if(unC == 0)          fMinX -= fMargin;
+            if(unC == unCols - 1) fMaxX += fMargin;
+            if(unR == 0)          fMinY -= fMargin;
+            if(unR == unRows - 1) fMaxY += fMargin;
+            /* Counter-clockwise order */
+            std::vector<CVector2> vecTile;
+            vecTile.emplace_back(fMinX, fMinY);
+            vecTile.emplace_back(fMaxX, fMinY);
+            vecTile.emplace_back(fMaxX, fMaxY);
+            vecTile.emplace_back(fMinX, fMaxY);
+            vec_tiles.push_back(vecTile);
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CSimulator::InitPhysics(TConfigurationNode& t_tree) {
       try {
          /* Cycle through the physics engines */
@@ -498,27 +1158,43 @@ namespace argos {
          for(itEngines = itEngines.begin(&t_tree);
              itEngines != itEngines.end();
              ++itEngines) {
-            /* Create the physics engine */
-            CPhysicsEngine* pcEngine = CFactory<CPhysicsEngine>::New(itEngines->Value());
-            try {
-               /* Initialize the engine */
-               pcEngine->Init(*itEngines);
-               /* Check that an engine with that ID does not exist yet */
-               if(m_mapPhysicsEngines.find(pcEngine->GetId()) == m_mapPhysicsEngines.end()) {
-                  /* Add it to the lists */
-                  m_mapPhysicsEngines[pcEngine->GetId()] = pcEngine;
-                  m_vecPhysicsEngines.push_back(pcEngine);
+            /* Check whether the engine must be split in spatial partitions */
+            std::string strPartitions;
+            GetNodeAttributeOrDefault(*itEngines, "partitions", strPartitions, strPartitions);
+            if(strPartitions.empty()) {
+               /* Create the physics engine */
+               InitPhysicsEngine(*itEngines);
+            }
+            else if(strPartitions == "auto") {
+               /* By default, make one partition per thread */
+               UInt32 unCount = Max<UInt32>(1, m_unThreads);
+               GetNodeAttributeOrDefault(*itEngines, "count", unCount, unCount);
+               if(unCount == 0) {
+                  THROW_ARGOSEXCEPTION("The number of partitions of physics engine type \"" << itEngines->Value() << "\" must be greater than 0");
                }
-               else {
-                  /* Duplicate id -> error */
-                  THROW_ARGOSEXCEPTION("A physics engine with id \"" << pcEngine->GetId() << "\" exists already. The ids must be unique!");
+               if(NodeExists(*itEngines, "boundaries")) {
+                  THROW_ARGOSEXCEPTION("Physics engine type \"" << itEngines->Value() << "\" cannot have both partitions=\"auto\" and <boundaries>");
+               }
+               /* Tile the arena */
+               TConfigurationNode& tArena = GetNode(m_tConfigurationRoot, "arena");
+               CVector3 cArenaCenter, cArenaSize;
+               GetNodeAttributeOrDefault(tArena, "center", cArenaCenter, cArenaCenter);
+               GetNodeAttribute(tArena, "size", cArenaSize);
+               std::vector<std::vector<CVector2> > vecTiles;
+               CalculateArenaTiles(vecTiles, unCount, cArenaCenter, cArenaSize);
+               /* Create one engine per tile */
+               for(size_t i = 0; i < vecTiles.size(); ++i) {
+                  InitPhysicsEngine(*itEngines, "_" + ToString(i), &vecTiles[i]);
                }
+               LOG << "[INFO] The arena has been split in "
+                   << vecTiles.size()
+                   << " partitions for physics engine type \""
+                   << itEngines->Value()
+                   << "\""
+                   << std::endl;
             }
-            catch(CARGoSException& ex) {
-               /* Error while executing engine init, destroy what done to prevent memory leaks */
-               pcEngine->Destroy();
-               delete pcEngine;
-               THROW_ARGOSEXCEPTION_NESTED("Error initializing physics engine type \"" << itEngines->Value() << "\"", ex);
+            else {
+               THROW_ARGOSEXCEPTION("Unrecognized value \"" << strPartitions << "\" for attribute 'partitions' of physics engine type \"" << itEngines->Value() << "\". The only accepted value is \"auto\".");
             }
          }
       }
@@ -530,6 +1206,41 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CSimulator::InitPhysicsEngine(TConfigurationNode& t_tree,
+                                      const std::string& str_id_suffix,
+                                      const std::vector<CVector2>* pvec_sides) {
+      /* Create the physics engine */
+      CPhysicsEngine* pcEngine = CFactory<CPhysicsEngine>::New(t_tree.Value());
+      try {
+         /* Initialize the engine */
+         pcEngine->Init(t_tree);
+         /* Set the partition id and volume, if any */
+         pcEngine->SetId(pcEngine->GetId() + str_id_suffix);
+         if(pvec_sides != nullptr) {
+            pcEngine->GetVolume().SetSides(*pvec_sides);
+         }
+         /* Check that an engine with that ID does not exist yet */
+         if(m_mapPhysicsEngines.find(pcEngine->GetId()) == m_mapPhysicsEngines.end()) {
+            /* Add it to the lists */
+            m_mapPhysicsEngines[pcEngine->GetId()] = pcEngine;
+            m_vecPhysicsEngines.push_back(pcEngine);
+         }
+         else {
+            /* Duplicate id -> error */
+            THROW_ARGOSEXCEPTION("A physics engine with id \"" << pcEngine->GetId() << "\" exists already. The ids must be unique!");
+         }
+      }
+      catch(CARGoSException& ex) {
+         /* Error while executing engine init, destroy what done to prevent memory leaks */
+         pcEngine->Destroy();
+         delete pcEngine;
+         THROW_ARGOSEXCEPTION_NESTED("Error initializing physics engine type \"" << t_tree.Value() << "\"", ex);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CSimulator::InitPhysics2() {
       try {
          /* Cycle through the physics engines */
@@ -31,16 +31,20 @@ namespace argos {
    class CMedium;
    class CSpace;
    class CProfiler;
+   class CEntity;
+   class CTrajectoryRecorder;
 }
 
 #include <argos3/core/config.h>
 #include <argos3/core/utility/math/rng.h>
 #include <argos3/core/utility/configuration/argos_configuration.h>
 #include <argos3/core/utility/datatypes/datatypes.h>
+#include <argos3/core/utility/profiler/profiler.h>
 #include <argos3/core/simulator/physics_engine/physics_engine.h>
 #include <argos3/core/simulator/medium/medium.h>
 #include <string>
 #include <map>
+#include <vector>
 
 /**
  * @brief The namespace containing all the ARGoS related code.
@@ -82,6 +86,26 @@ namespace argos {
          return *this;
       }
 
+   public:
+
+      /**
+       * The outcome of a branch forked by Branch().
+       */
+      struct SBranchResult {
+         /** The index of the branch, from 1 */
+         UInt32 Branch;
+         /** The seed of the "argos" CRandom category in the branch */
+         UInt32 Seed;
+         /** <tt>true</tt> if the branch ran to completion */
+         bool Success;
+         /** The simulation clock at the end of the branch */
+         UInt32 Steps;
+         /** The time spent running the branch, in seconds */
+         Real RunTime;
+         /** The result returned by CLoopFunctions::GetResult(), or the error */
+         std::string Result;
+      };
+
    public:
 
       /**
@@ -183,6 +207,23 @@ namespace argos {
          return m_pcProfiler != NULL;
       }
 
+      /**
+       * Returns a reference to the trajectory recorder.
+       * @return A reference to the trajectory recorder.
+       * @see CTrajectoryRecorder
+       */
+      inline CTrajectoryRecorder& GetRecorder() {
+         return *m_pcRecorder;
+      }
+
+      /**
+       * Returns <tt>true</tt> if the trajectories are being recorded.
+       * @return <tt>true</tt> if the trajectories are being recorded.
+       */
+      inline bool IsRecording() const {
+         return m_pcRecorder != nullptr;
+      }
+
       /**
        * Returns the random seed of the "argos" category of the random seed.
        * @return the random seed of the "argos" category of the random seed.
@@ -261,6 +302,26 @@ namespace argos {
          return m_unThreads;
       }
 
+      /**
+       * Returns <tt>true</tt> if Reset() restores the snapshot taken at the end of Init().
+       * By default, this flag is <tt>false</tt>.
+       */
+      inline bool IsFastReset() const {
+         return m_bFastReset;
+      }
+
+      /**
+       * When passed <tt>true</tt>, Reset() restores the snapshot taken at the end of Init().
+       * The snapshot is taken only if the <tt>fast_reset</tt> attribute of
+       * <tt>&lt;experiment&gt;</tt> is <tt>true</tt>; without a snapshot, Reset()
+       * performs the full reset.
+       * @param b_fast_reset <tt>true</tt> to restore the snapshot; <tt>false</tt> to perform the full reset.
+       * @see Reset()
+       */
+      inline void SetFastReset(bool b_fast_reset) {
+         m_bFastReset = b_fast_reset;
+      }
+
       /**
        * Returns <tt>true</tt> if the clock tick follows the real time.
        * By default, this flag is <tt>false</tt>.
@@ -305,6 +366,14 @@ namespace argos {
        */
       void Load(ticpp::Document& t_tree);
 
+      /**
+       * Loads the plugin and user libraries an XML configuration refers to.
+       * Libraries that are already loaded are not loaded again. This method is
+       * called by Load() and LoadExperiment(); it is exposed so that processes
+       * forked from this one can inherit the libraries of several experiments.
+       * @param t_root The root of the XML configuration.
+       */
+      void LoadPlugins(TConfigurationNode& t_root);
 
       /**
        * Loads the XML configuration file.
@@ -323,6 +392,15 @@ namespace argos {
       /**
        * Resets the experiment.
        * Restores the state of the experiment right after Init() and before any step is executed.
+       * <p>
+       * When the <tt>fast_reset</tt> attribute of <tt>&lt;experiment&gt;</tt> is
+       * <tt>true</tt>, the state of the entities, physics engines and media is taken
+       * at the end of Init(). This method resets the entities and the loop functions
+       * as usual, and then restores the snapshot instead of resetting the physics
+       * engines. If entities were added or removed since Init(), the full reset is
+       * performed instead.
+       * </p>
+       * @see SetFastReset()
        */
       void Reset();
 
@@ -340,6 +418,112 @@ namespace argos {
          Reset();
       }
 
+      /**
+       * Saves the complete state of the experiment to a binary file.
+       * The checkpoint contains the state of the space and of its entities
+       * (including the controllers that support it), of the physics engines,
+       * of the media, of the loop functions, and of the random number
+       * generators.
+       * @param str_file_name The name of the checkpoint file.
+       * @throws CARGoSException if the file can't be written.
+       * @see LoadCheckpoint()
+       */
+      void SaveCheckpoint(const std::string& str_file_name);
+
+      /**
+       * Restores the state of the experiment from a binary file.
+       * It works on the assumption that the experiment has been initialized
+       * from the same XML configuration file that was used when the
+       * checkpoint was saved.
+       * @param str_file_name The name of the checkpoint file.
+       * @throws CARGoSException if the file can't be read or does not match the experiment.
+       * @see SaveCheckpoint()
+       */
+      void LoadCheckpoint(const std::string& str_file_name);
+
+      /**
+       * Schedules a checkpoint at the given simulation clock.
+       * The checkpoint is saved at the end of the step that brings the
+       * simulation clock to the given value.
+       * @param un_clock The simulation clock; 0 disables the checkpoint.
+       * @param str_file_name The name of the checkpoint file.
+       * @see SaveCheckpoint()
+       */
+      inline void SetCheckpoint(UInt32 un_clock,
+                                const std::string& str_file_name) {
+         m_unCheckpointClock = un_clock;
+         m_strCheckpointFileName = str_file_name;
+      }
+
+      /**
+       * Forks the experiment into the given number of branches.
+       * <p>
+       * Each branch is a child process that continues the experiment from its
+       * current state, sharing the memory of this process until it modifies
+       * it. In each branch, all the CRandom categories get new seeds derived
+       * from the index of the branch. The branches run at the same time until
+       * the experiment is finished, and report the final simulation clock and
+       * the result of CLoopFunctions::GetResult() back to this process.
+       * </p>
+       * <p>
+       * This process waits for all the branches to be over, and then
+       * terminates the experiment. The results are returned by
+       * GetBranchResults(), logged, and written to the branch summary file if
+       * one was set in the XML. This method can be called by the loop
+       * functions, or scheduled with the <tt>branch_at</tt> and
+       * <tt>branches</tt> attributes of <tt>&lt;experiment&gt;</tt>.
+       * </p>
+       * <p>
+       * Branching requires <tt>threads="0"</tt> and no visualization, and it
+       * is not possible in a batch job. When the branching is scheduled in
+       * the XML, these requirements are checked by Init().
+       * </p>
+       * @param un_branches The number of branches.
+       * @return In a branch, its index, from 1 to <tt>un_branches</tt>. In this process, 0 once all the branches are over.
+       * @throws CARGoSException if the experiment can't be forked.
+       * @see GetBranch()
+       * @see GetBranchResults()
+       */
+      UInt32 Branch(UInt32 un_branches);
+
+      /**
+       * Returns the index of the branch this process runs.
+       * @return The index of the branch, or 0 if this process was not forked by Branch().
+       * @see Branch()
+       */
+      inline UInt32 GetBranch() const {
+         return m_unBranch;
+      }
+
+      /**
+       * Returns the outcome of the branches forked by the last call to Branch().
+       * @return The outcome of the branches.
+       * @see Branch()
+       */
+      inline const std::vector<SBranchResult>& GetBranchResults() const {
+         return m_vecBranchResults;
+      }
+
+      /**
+       * Returns <tt>true</tt> if the experiment runs as a batch job.
+       * @return <tt>true</tt> if the experiment runs as a batch job.
+       * @see SetBatchJob()
+       */
+      inline bool IsBatchJob() const {
+         return m_bBatchJob;
+      }
+
+      /**
+       * Sets whether the experiment runs as a batch job.
+       * A batch job reports its outcome to the batch runner once, so it
+       * can't be branched.
+       * @param b_batch_job <tt>true</tt> if the experiment runs as a batch job.
+       * @see Branch()
+       */
+      inline void SetBatchJob(bool b_batch_job) {
+         m_bBatchJob = b_batch_job;
+      }
+
       /**
        * Undoes whatever was done by Init().
        */
@@ -375,14 +559,23 @@ namespace argos {
 
       void InitFramework(TConfigurationNode& t_tree);
       void InitFrameworkSystem(TConfigurationNode& t_tree);
+      void InitFrameworkSystemLog(TConfigurationNode& t_tree);
       void InitLoopFunctions(TConfigurationNode& t_tree);
       void InitControllers(TConfigurationNode& t_tree);
       void InitSpace(TConfigurationNode& t_tree);
       void InitPhysics(TConfigurationNode& t_tree);
+      void InitPhysicsEngine(TConfigurationNode& t_tree,
+                             const std::string& str_id_suffix = "",
+                             const std::vector<CVector2>* pvec_sides = nullptr);
       void InitPhysics2();
       void InitMedia(TConfigurationNode& t_tree);
       void InitMedia2();
       void InitVisualization(TConfigurationNode& t_tree);
+      void CheckBranching() const;
+      void ReportBranch();
+      bool FastReset();
+      void SaveSimulationState(CByteArray& c_buffer);
+      void LoadSimulationState(CByteArray& c_buffer);
 
    private:
 
@@ -478,9 +671,14 @@ namespace argos {
       CProfiler* m_pcProfiler;
 
       /**
-       * Profiler output format: <tt>true</tt> human readable, <tt>false</tt> table format.
+       * Profiler output format.
+       */
+      CProfiler::EFormat m_eProfileFormat;
+
+      /**
+       * Pointer to the trajectory recorder (nullptr when recording is off).
        */
-      bool m_bHumanReadableProfile;
+      CTrajectoryRecorder* m_pcRecorder;
 
       /**
        * <tt>true</tt> when ARGoS must run in real-time; <tt>false</tt> otherwise.
@@ -497,6 +695,71 @@ namespace argos {
        */
       bool m_bForceNoViz;
 
+      /**
+       * <tt>true</tt> if Reset() restores the snapshot taken at the end of Init().
+       */
+      bool m_bFastReset;
+
+      /**
+       * The state of the entities, physics engines and media at the end of Init().
+       */
+      CByteArray m_cResetSnapshot;
+
+      /**
+       * The root entities in the space when the reset snapshot was taken.
+       */
+      std::vector<CEntity*> m_vecResetSnapshotEntities;
+
+      /**
+       * The simulation clock at which a checkpoint is saved; 0 if disabled.
+       */
+      UInt32 m_unCheckpointClock;
+
+      /**
+       * The name of the checkpoint file.
+       */
+      std::string m_strCheckpointFileName;
+
+      /**
+       * The simulation clock at which the experiment is branched; 0 if disabled.
+       */
+      UInt32 m_unBranchClock;
+
+      /**
+       * The number of branches forked at m_unBranchClock.
+       */
+      UInt32 m_unBranches;
+
+      /**
+       * The name of the branch summary file; empty if disabled.
+       */
+      std::string m_strBranchSummaryFileName;
+
+      /**
+       * The index of the branch this process runs; 0 if not a branch.
+       */
+      UInt32 m_unBranch;
+
+      /**
+       * The pipe a branch reports its outcome through; -1 if not a branch.
+       */
+      int m_nBranchReportFd;
+
+      /**
+       * The time at which this branch was forked, in seconds.
+       */
+      Real m_fBranchStartTime;
+
+      /**
+       * The outcome of the branches forked by this process.
+       */
+      std::vector<SBranchResult> m_vecBranchResults;
+
+      /**
+       * <tt>true</tt> if the experiment runs as a batch job.
+       */
+      bool m_bBatchJob;
+
    };
 
 }
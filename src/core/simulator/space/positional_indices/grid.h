@@ -5,6 +5,7 @@
 #include <argos3/core/utility/math/range.h>
 #include <argos3/core/utility/math/ray3.h>
 #include <argos3/core/simulator/space/positional_indices/positional_index.h>
+#include <vector>
 
 namespace argos {
 
@@ -15,6 +16,11 @@ namespace argos {
 
       typedef typename CPositionalIndex<ENTITY>::COperation CEntityOperation;
 
+      /**
+       * A cell of the grid.
+       * When the grid uses flat storage, the entity set is left empty and the
+       * cell contents are kept in a compact array indexed by cell instead.
+       */
       struct SCell {
          CSet<ENTITY*,SEntityComparator> Entities;
          size_t Timestamp;
@@ -41,7 +47,8 @@ namespace argos {
             const CVector3& c_area_max_corner,
             SInt32 n_size_i,
             SInt32 n_size_j,
-            SInt32 n_size_k);
+            SInt32 n_size_k,
+            bool b_flat_storage = false);
 
       virtual ~CGrid();
 
@@ -53,6 +60,22 @@ namespace argos {
 
       virtual void RemoveEntity(ENTITY& c_entity);
 
+      /**
+       * Adds an entity to the grid and stores it in its cells.
+       * The other entities are not updated. If the grid has not been
+       * updated yet, the entity is stored in its cells at the first Update(),
+       * so that adding many entities at startup builds the grid only once.
+       * @param c_entity The entity to add.
+       */
+      virtual void AddEntityAndUpdate(ENTITY& c_entity);
+
+      /**
+       * Removes an entity from the grid and from its cells.
+       * The other entities are not updated.
+       * @param c_entity The entity to remove.
+       */
+      virtual void RemoveEntityAndUpdate(ENTITY& c_entity);
+
       virtual void Update();
 
       virtual void GetEntitiesAt(CSet<ENTITY*,SEntityComparator>& c_entities,
@@ -144,8 +167,38 @@ namespace argos {
                                     SInt32 n_j,
                                     SInt32 n_k) const;
 
+      inline bool IsFlatStorage() const {
+         return m_bFlatStorage;
+      }
+
    protected:
 
+      inline UInt32 GetCellIndex(SInt32 n_i,
+                                 SInt32 n_j,
+                                 SInt32 n_k) const {
+         return m_nSizeI * m_nSizeJ * n_k + m_nSizeI * n_j + n_i;
+      }
+
+      /**
+       * Rebuilds the flat cell storage from the (cell,entity) pairs
+       * collected by UpdateCell() during the last update.
+       * The pairs are counting-sorted by cell, so the entities of cell c
+       * end up in m_vecFlatEntities[m_vecFlatOffsets[c]..m_vecFlatOffsets[c+1]).
+       * All the buffers are reused across updates.
+       */
+      void BuildFlatCells();
+
+      /**
+       * The range of cells an entity was stored in at the last update.
+       */
+      struct SCellBox {
+         size_t Timestamp;
+         SInt32 Min[3];
+         SInt32 Max[3];
+
+         SCellBox() : Timestamp(0) {}
+      };
+
       CVector3 m_cAreaMinCorner;
       CVector3 m_cAreaMaxCorner;
       SInt32 m_nSizeI;
@@ -160,6 +213,15 @@ namespace argos {
       size_t m_unCurTimestamp;
       CSet<ENTITY*,SEntityComparator> m_cEntities;
       CEntityOperation* m_pcUpdateEntityOperation;
+      /* The cells of each entity, indexed by entity index (tree storage only) */
+      std::vector<SCellBox> m_vecEntityCells;
+      /* Flat (CSR) storage */
+      bool m_bFlatStorage;
+      std::vector<UInt32> m_vecFlatPendingCells;
+      std::vector<ENTITY*> m_vecFlatPendingEntities;
+      std::vector<UInt32> m_vecFlatOffsets;
+      std::vector<UInt32> m_vecFlatCursors;
+      std::vector<ENTITY*> m_vecFlatEntities;
 
    };
 
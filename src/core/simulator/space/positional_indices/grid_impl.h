@@ -10,28 +10,51 @@ namespace argos {
 
 #define APPLY_ENTITY_OPERATION_TO_CELL(nI,nJ,nK)                        \
    {                                                                    \
-      SCell& sCell = GetCellAt((nI), (nJ), (nK));                       \
-      if((sCell.Timestamp == m_unCurTimestamp) &&                       \
-         (! sCell.Entities.empty())) {                                  \
-         for(typename CSet<ENTITY*,SEntityComparator>::iterator it = sCell.Entities.begin(); \
-             it != sCell.Entities.end();                                \
-             ++it) {                                                    \
-            if(!c_operation(**it)) return;                              \
+      if(m_bFlatStorage) {                                              \
+         UInt32 unCell = GetCellIndex((nI), (nJ), (nK));                \
+         for(UInt32 unE = m_vecFlatOffsets[unCell];                     \
+             unE < m_vecFlatOffsets[unCell + 1];                        \
+             ++unE) {                                                   \
+            if(!c_operation(*m_vecFlatEntities[unE])) return;           \
+         }                                                              \
+      }                                                                 \
+      else {                                                            \
+         SCell& sCell = GetCellAt((nI), (nJ), (nK));                    \
+         if((sCell.Timestamp == m_unCurTimestamp) &&                    \
+            (! sCell.Entities.empty())) {                               \
+            for(typename CSet<ENTITY*,SEntityComparator>::iterator it = sCell.Entities.begin(); \
+                it != sCell.Entities.end();                             \
+                ++it) {                                                 \
+               if(!c_operation(**it)) return;                           \
+            }                                                           \
          }                                                              \
       }                                                                 \
    }
 
 #define APPLY_ENTITY_OPERATION_TO_CELL_ALONG_RAY(nI,nJ,nK)              \
    {                                                                    \
-      SCell& sCell = GetCellAt(nI, nJ, nK);                             \
-      if((sCell.Timestamp == m_unCurTimestamp) &&                       \
-         (! sCell.Entities.empty())) {                                  \
-         for(typename CSet<ENTITY*,SEntityComparator>::iterator it = sCell.Entities.begin(); \
-             it != sCell.Entities.end();                                \
-             ++it) {                                                    \
-            if(!c_operation(**it)) return;                              \
+      if(m_bFlatStorage) {                                              \
+         UInt32 unCell = GetCellIndex(nI, nJ, nK);                      \
+         if(m_vecFlatOffsets[unCell] < m_vecFlatOffsets[unCell + 1]) {  \
+            for(UInt32 unE = m_vecFlatOffsets[unCell];                  \
+                unE < m_vecFlatOffsets[unCell + 1];                     \
+                ++unE) {                                                \
+               if(!c_operation(*m_vecFlatEntities[unE])) return;        \
+            }                                                           \
+            if(b_stop_at_closest_match) return;                         \
+         }                                                              \
+      }                                                                 \
+      else {                                                            \
+         SCell& sCell = GetCellAt(nI, nJ, nK);                          \
+         if((sCell.Timestamp == m_unCurTimestamp) &&                    \
+            (! sCell.Entities.empty())) {                               \
+            for(typename CSet<ENTITY*,SEntityComparator>::iterator it = sCell.Entities.begin(); \
+                it != sCell.Entities.end();                             \
+                ++it) {                                                 \
+               if(!c_operation(**it)) return;                           \
+            }                                                           \
+            if(b_stop_at_closest_match) return;                         \
          }                                                              \
-         if(b_stop_at_closest_match) return;                            \
       }                                                                 \
    }
 
@@ -49,7 +72,8 @@ CGrid<ENTITY>::CGrid(const CVector3& c_area_min_corner,
                      const CVector3& c_area_max_corner,
                      SInt32 n_size_i,
                      SInt32 n_size_j,
-                     SInt32 n_size_k) :
+                     SInt32 n_size_k,
+                     bool b_flat_storage) :
    m_cAreaMinCorner(c_area_min_corner),
    m_cAreaMaxCorner(c_area_max_corner),
    m_nSizeI(n_size_i),
@@ -59,7 +83,8 @@ CGrid<ENTITY>::CGrid(const CVector3& c_area_min_corner,
    m_cRangeY(m_cAreaMinCorner.GetY(), m_cAreaMaxCorner.GetY()),
    m_cRangeZ(m_cAreaMinCorner.GetZ(), m_cAreaMaxCorner.GetZ()),
    m_unCurTimestamp(0),
-   m_pcUpdateEntityOperation(NULL) {
+   m_pcUpdateEntityOperation(NULL),
+   m_bFlatStorage(b_flat_storage) {
    m_cCellSize.Set(m_cRangeX.GetSpan() / m_nSizeI,
                    m_cRangeY.GetSpan() / m_nSizeJ,
                    m_cRangeZ.GetSpan() / m_nSizeK);
@@ -67,6 +92,9 @@ CGrid<ENTITY>::CGrid(const CVector3& c_area_min_corner,
                       1.0f / m_cCellSize.GetY(),
                       1.0f / m_cCellSize.GetZ());
    m_psCells = new SCell[m_nSizeI * m_nSizeJ * m_nSizeK];
+   if(m_bFlatStorage) {
+      m_vecFlatOffsets.assign(m_nSizeI * m_nSizeJ * m_nSizeK + 1, 0);
+   }
 }
 
    /****************************************/
@@ -90,6 +118,7 @@ CGrid<ENTITY>::CGrid(const CVector3& c_area_min_corner,
    template<class ENTITY>
    void CGrid<ENTITY>::Reset() {
       m_unCurTimestamp = 0;
+      m_vecEntityCells.clear();
       for(SInt32 i = 0; i < m_nSizeI; ++i) {
          for(SInt32 j = 0; j < m_nSizeJ; ++j) {
             for(SInt32 k = 0; k < m_nSizeK; ++k) {
@@ -97,6 +126,10 @@ CGrid<ENTITY>::CGrid(const CVector3& c_area_min_corner,
             }
          }
       }
+      if(m_bFlatStorage) {
+         m_vecFlatEntities.clear();
+         std::fill(m_vecFlatOffsets.begin(), m_vecFlatOffsets.end(), 0);
+      }
       Update();
    }
 
@@ -126,10 +159,96 @@ CGrid<ENTITY>::CGrid(const CVector3& c_area_min_corner,
    /****************************************/
    /****************************************/
 
+   template<class ENTITY>
+   void CGrid<ENTITY>::AddEntityAndUpdate(ENTITY& c_entity) {
+      m_cEntities.insert(&c_entity);
+      /* Before the first update, the grid is built for all entities at once */
+      if(m_unCurTimestamp == 0) return;
+      /* Store the entity in its cells, as of the last update */
+      (*m_pcUpdateEntityOperation)(c_entity);
+      if(m_bFlatStorage) {
+         BuildFlatCells();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<class ENTITY>
+   void CGrid<ENTITY>::RemoveEntityAndUpdate(ENTITY& c_entity) {
+      m_cEntities.erase(&c_entity);
+      if(m_unCurTimestamp == 0) return;
+      if(m_bFlatStorage) {
+         /* Drop the (cell,entity) pairs of the entity and rebuild the cells */
+         size_t j = 0;
+         for(size_t i = 0; i < m_vecFlatPendingEntities.size(); ++i) {
+            if(m_vecFlatPendingEntities[i] != &c_entity) {
+               m_vecFlatPendingCells[j] = m_vecFlatPendingCells[i];
+               m_vecFlatPendingEntities[j] = m_vecFlatPendingEntities[i];
+               ++j;
+            }
+         }
+         m_vecFlatPendingCells.resize(j);
+         m_vecFlatPendingEntities.resize(j);
+         BuildFlatCells();
+      }
+      else if(c_entity.GetIndex() >= 0 &&
+              static_cast<size_t>(c_entity.GetIndex()) < m_vecEntityCells.size()) {
+         /* The entity might have moved since the last update, so erase it
+            from the cells it was stored in, rather than from the cells of
+            its current position */
+         SCellBox& sBox = m_vecEntityCells[c_entity.GetIndex()];
+         if(sBox.Timestamp == m_unCurTimestamp) {
+            for(SInt32 k = sBox.Min[2]; k <= sBox.Max[2]; ++k) {
+               for(SInt32 j = sBox.Min[1]; j <= sBox.Max[1]; ++j) {
+                  for(SInt32 i = sBox.Min[0]; i <= sBox.Max[0]; ++i) {
+                     GetCellAt(i, j, k).Entities.erase(&c_entity);
+                  }
+               }
+            }
+         }
+         sBox.Timestamp = 0;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    template<class ENTITY>
    void CGrid<ENTITY>::Update() {
       ++m_unCurTimestamp;
-      ForAllEntities(*m_pcUpdateEntityOperation);
+      if(m_bFlatStorage) {
+         m_vecFlatPendingCells.clear();
+         m_vecFlatPendingEntities.clear();
+         ForAllEntities(*m_pcUpdateEntityOperation);
+         BuildFlatCells();
+      }
+      else {
+         ForAllEntities(*m_pcUpdateEntityOperation);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<class ENTITY>
+   void CGrid<ENTITY>::BuildFlatCells() {
+      /* Count the entities in each cell */
+      std::fill(m_vecFlatOffsets.begin(), m_vecFlatOffsets.end(), 0);
+      for(size_t i = 0; i < m_vecFlatPendingCells.size(); ++i) {
+         ++m_vecFlatOffsets[m_vecFlatPendingCells[i] + 1];
+      }
+      /* Turn the counts into offsets */
+      for(size_t i = 1; i < m_vecFlatOffsets.size(); ++i) {
+         m_vecFlatOffsets[i] += m_vecFlatOffsets[i - 1];
+      }
+      /* Scatter the entities into their cells, keeping the update order */
+      m_vecFlatCursors.assign(m_vecFlatOffsets.begin(), m_vecFlatOffsets.end() - 1);
+      m_vecFlatEntities.resize(m_vecFlatPendingEntities.size());
+      for(size_t i = 0; i < m_vecFlatPendingCells.size(); ++i) {
+         m_vecFlatEntities[m_vecFlatCursors[m_vecFlatPendingCells[i]]++] =
+            m_vecFlatPendingEntities[i];
+      }
    }
 
    /****************************************/
@@ -141,6 +260,16 @@ CGrid<ENTITY>::CGrid(const CVector3& c_area_min_corner,
       try {
          SInt32 i, j, k;
          PositionToCell(i, j, k, c_position);
+         if(m_bFlatStorage) {
+            UInt32 unCell = GetCellIndex(i, j, k);
+            c_entities.clear();
+            for(UInt32 unE = m_vecFlatOffsets[unCell];
+                unE < m_vecFlatOffsets[unCell + 1];
+                ++unE) {
+               c_entities.insert(m_vecFlatEntities[unE]);
+            }
+            return;
+         }
          const SCell& sCell = GetCellAt(i, j, k);
          if(sCell.Timestamp < m_unCurTimestamp) {
             c_entities.clear();
@@ -304,7 +433,7 @@ CGrid<ENTITY>::CGrid(const CVector3& c_area_min_corner,
       }
       /* Check rest of the circle */
       for(SInt32 i = nID; i > 0; --i) {
-         nJD = Floor(Sqrt(f_radius * f_radius - i * m_cCellSize.GetX() * i * m_cCellSize.GetX()) * m_cInvCellSize.GetY() + 0.5f);
+         nJD = Floor(Sqrt(Max<Real>(0.0f, f_radius * f_radius - i * m_cCellSize.GetX() * i * m_cCellSize.GetX())) * m_cInvCellSize.GetY() + 0.5f);
          for(SInt32 j = nJD; j > 0; --j) {
             if((nI + i >= 0 && nI + i < m_nSizeI) && (nJ + j >= 0 && nJ + j < m_nSizeJ)) APPLY_ENTITY_OPERATION_TO_CELL(nI + i, nJ + j, nK);
             if((nI + i >= 0 && nI + i < m_nSizeI) && (nJ - j >= 0 && nJ - j < m_nSizeJ)) APPLY_ENTITY_OPERATION_TO_CELL(nI + i, nJ - j, nK);
@@ -668,7 +797,7 @@ CGrid<ENTITY>::CGrid(const CVector3& c_area_min_corner,
       }
       /* Check rest of the circle */
       for(SInt32 i = nID; i > 0; --i) {
-         nJD = Floor(Sqrt(f_radius * f_radius - i * m_cCellSize.GetX() * i * m_cCellSize.GetX()) * m_cInvCellSize.GetY() + 0.5f);
+         nJD = Floor(Sqrt(Max<Real>(0.0f, f_radius * f_radius - i * m_cCellSize.GetX() * i * m_cCellSize.GetX())) * m_cInvCellSize.GetY() + 0.5f);
          for(SInt32 j = nJD; j > 0; --j) {
             if((nI + i >= 0 && nI + i < m_nSizeI) && (nJ + j >= 0 && nJ + j < m_nSizeJ)) APPLY_CELL_OPERATION_TO_CELL(nI + i, nJ + j, nK);
             if((nI + i >= 0 && nI + i < m_nSizeI) && (nJ - j >= 0 && nJ - j < m_nSizeJ)) APPLY_CELL_OPERATION_TO_CELL(nI + i, nJ - j, nK);
@@ -888,12 +1017,37 @@ CGrid<ENTITY>::CGrid(const CVector3& c_area_min_corner,
       if((n_i >= 0) && (n_i < m_nSizeI) &&
          (n_j >= 0) && (n_j < m_nSizeJ) &&
          (n_k >= 0) && (n_k < m_nSizeK)) {
+         if(m_bFlatStorage) {
+            /* Just record the pair, the cells are built at the end of Update() */
+            m_vecFlatPendingCells.push_back(GetCellIndex(n_i, n_j, n_k));
+            m_vecFlatPendingEntities.push_back(&c_entity);
+            return;
+         }
          SCell& sCell = GetCellAt(n_i, n_j, n_k);
          if(sCell.Timestamp < m_unCurTimestamp) {
             sCell.Entities.clear();
             sCell.Timestamp = m_unCurTimestamp;
          }
          sCell.Entities.insert(&c_entity);
+         /* Track the cells of the entity, to remove it without an update */
+         if(c_entity.GetIndex() >= 0) {
+            size_t unIdx = c_entity.GetIndex();
+            if(unIdx >= m_vecEntityCells.size()) {
+               m_vecEntityCells.resize(unIdx + 1);
+            }
+            SCellBox& sBox = m_vecEntityCells[unIdx];
+            if(sBox.Timestamp < m_unCurTimestamp) {
+               sBox.Timestamp = m_unCurTimestamp;
+               sBox.Min[0] = sBox.Max[0] = n_i;
+               sBox.Min[1] = sBox.Max[1] = n_j;
+               sBox.Min[2] = sBox.Max[2] = n_k;
+            }
+            else {
+               sBox.Min[0] = Min(sBox.Min[0], n_i); sBox.Max[0] = Max(sBox.Max[0], n_i);
+               sBox.Min[1] = Min(sBox.Min[1], n_j); sBox.Max[1] = Max(sBox.Max[1], n_j);
+               sBox.Min[2] = Min(sBox.Min[2], n_k); sBox.Max[2] = Max(sBox.Max[2], n_k);
+            }
+         }
       }
       else {
          THROW_ARGOSEXCEPTION("CGrid<ENTITY>::UpdateCell() : index (" << n_i << "," << n_j << "," << n_k << ") out of bounds (" << m_nSizeI-1 << "," << m_nSizeJ-1 << "," << m_nSizeK-1 << ")");
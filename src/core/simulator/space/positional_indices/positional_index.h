@@ -84,6 +84,32 @@ namespace argos {
        */
       virtual void RemoveEntity(ENTITY& c_entity) = 0;
 
+      /**
+       * Adds an entity to this index and makes it visible to the queries.
+       * This is equivalent to calling AddEntity() and then Update(), which
+       * is what this method does by default. Implementations can override
+       * it to index the new entity without rebuilding the whole index.
+       * @param c_entity The entity to add.
+       * @see AddEntity()
+       */
+      virtual void AddEntityAndUpdate(ENTITY& c_entity) {
+         AddEntity(c_entity);
+         Update();
+      }
+
+      /**
+       * Removes an entity from this index and from the results of the queries.
+       * This is equivalent to calling RemoveEntity() and then Update(), which
+       * is what this method does by default. Implementations can override
+       * it to drop the entity without rebuilding the whole index.
+       * @param c_entity The entity to remove.
+       * @see RemoveEntity()
+       */
+      virtual void RemoveEntityAndUpdate(ENTITY& c_entity) {
+         RemoveEntity(c_entity);
+         Update();
+      }
+
       /**
        * Updates this positional index.
        */
@@ -12,6 +12,7 @@
 #include <argos3/core/utility/math/range.h>
 #include <argos3/core/utility/logging/argos_log.h>
 #include <argos3/core/utility/math/rng.h>
+#include <argos3/core/utility/profiler/profiler.h>
 #include <argos3/core/simulator/simulator.h>
 #include <argos3/core/simulator/entity/composable_entity.h>
 #include <argos3/core/simulator/entity/positional_entity.h>
@@ -24,12 +25,19 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   thread_local UInt32 CSpace::m_unThreadIndex = 0;
+
+   /****************************************/
+   /****************************************/
+
    CSpace::CSpace() :
       m_cSimulator(CSimulator::GetInstance()),
       m_unSimulationClock(0),
       m_pcFloorEntity(nullptr),
       m_ptPhysicsEngines(nullptr),
-      m_ptMedia(nullptr) {}
+      m_ptMedia(nullptr),
+      m_bParallelPhysicsModels(false),
+      m_bParallelMedia(false) {}
 
    /****************************************/
    /****************************************/
@@ -38,6 +46,18 @@ namespace argos {
       /* Get reference to physics engine and media vectors */
       m_ptPhysicsEngines = &(m_cSimulator.GetPhysicsEngines());
       m_ptMedia = &(m_cSimulator.GetMedia());
+      /* Check whether any engine delegates the update of its models */
+      for(size_t i = 0; i < m_ptPhysicsEngines->size(); ++i) {
+         if((*m_ptPhysicsEngines)[i]->IsModelUpdateParallel()) {
+            m_bParallelPhysicsModels = true;
+         }
+      }
+      /* Check whether any medium has a parallel part in its update */
+      for(size_t i = 0; i < m_ptMedia->size(); ++i) {
+         if((*m_ptMedia)[i]->IsUpdateParallel()) {
+            m_bParallelMedia = true;
+         }
+      }
       /* Get the arena center and size */
       GetNodeAttributeOrDefault(t_tree, "center", m_cArenaCenter, m_cArenaCenter);
       GetNodeAttribute(t_tree, "size", m_cArenaSize);
@@ -92,6 +112,34 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CSpace::SaveState(CByteArray& c_buffer) {
+      c_buffer << m_unSimulationClock
+               << static_cast<UInt32>(m_vecRootEntities.size());
+      for(size_t i = 0; i < m_vecRootEntities.size(); ++i) {
+         SaveMementoBlock(c_buffer, *m_vecRootEntities[i]);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpace::LoadState(CByteArray& c_buffer) {
+      UInt32 unNumRootEntities;
+      c_buffer >> m_unSimulationClock >> unNumRootEntities;
+      if(unNumRootEntities != m_vecRootEntities.size()) {
+         THROW_ARGOSEXCEPTION("The saved state contains " << unNumRootEntities <<
+                              " root entities, but the space contains " << m_vecRootEntities.size());
+      }
+      CMementoBlockReader cReader(c_buffer);
+      for(size_t i = 0; i < m_vecRootEntities.size(); ++i) {
+         cReader.LoadNextBlock(*m_vecRootEntities[i]);
+      }
+      cReader.Finish();
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CSpace::GetEntitiesMatching(CEntity::TVector& t_buffer,
                                     const std::string& str_pattern) {
       for(auto it = m_vecEntities.begin();
@@ -116,16 +164,39 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+#define PROFILER_START_PHASE(PHASE)                               \
+   if(pcProfiler != nullptr) {                                     \
+      pcProfiler->StartPhase(CProfiler::PHASE_ ## PHASE);          \
+   }
+
+#define PROFILER_STOP_PHASE                                        \
+   if(pcProfiler != nullptr) {                                     \
+      pcProfiler->StopPhase();                                     \
+   }
+
    void CSpace::Update() {
+      /* Get the profiler, if profiling is active */
+      CProfiler* pcProfiler =
+         m_cSimulator.IsProfiling() ? &m_cSimulator.GetProfiler() : nullptr;
       /* Increase the simulation clock */
       IncreaseSimulationClock();
+      /* Tell the logs that a new tick started, for sampling */
+      LOG.SetTick(GetSimulationClock());
+      LOGERR.SetTick(GetSimulationClock());
       /* Perform the 'act' phase for controllable entities */
+      PROFILER_START_PHASE(ACT);
       UpdateControllableEntitiesAct();
+      PROFILER_STOP_PHASE;
       /* Update the physics engines */
+      PROFILER_START_PHASE(PHYSICS);
       UpdatePhysics();
+      PROFILER_STOP_PHASE;
       /* Update media */
+      PROFILER_START_PHASE(MEDIA);
       UpdateMedia();
+      PROFILER_STOP_PHASE;
       /* Call loop functions */
+      PROFILER_START_PHASE(PRESTEP);
       m_cSimulator.GetLoopFunctions().PreStep();
       /*
        * If the loop functions did not use ARGoS threads during PreStep(), tell
@@ -134,14 +205,18 @@ namespace argos {
       if (!ControllableEntityIterationEnabled()) {
         ControllableEntityIterationWaitAbort();
       }
+      PROFILER_STOP_PHASE;
       /*
        * Reset callback to NULL to disable entity iteration for PostStep()
        * unless enabled again by the loop functions.
        */
       m_cbControllableEntityIter = nullptr;
       /* Perform the 'sense+step' phase for controllable entities */
+      PROFILER_START_PHASE(SENSE_CONTROL);
       UpdateControllableEntitiesSenseStep();
+      PROFILER_STOP_PHASE;
       /* Call loop functions */
+      PROFILER_START_PHASE(POSTSTEP);
       m_cSimulator.GetLoopFunctions().PostStep();
 
       /*
@@ -151,11 +226,15 @@ namespace argos {
       if (!ControllableEntityIterationEnabled()) {
         ControllableEntityIterationWaitAbort();
       }
+      PROFILER_STOP_PHASE;
       /*
        * Reset callback to NULL to disable entity iteration for next PreStep()
        * unless enabled again by the loop functions.
        */
       m_cbControllableEntityIter = nullptr;
+      /* Keep the messages sent until the next step */
+      LOG.EndTick();
+      LOGERR.EndTick();
       /* Flush logs */
       LOG.Flush();
       LOGERR.Flush();
@@ -164,6 +243,120 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CSpace::UpdatePhysicsEngine(size_t un_idx) {
+      if(m_cSimulator.IsProfiling()) {
+         double fStart = CProfiler::GetTime();
+         (*m_ptPhysicsEngines)[un_idx]->Update();
+         m_cSimulator.GetProfiler().CollectPhysicsEngineTime(
+            un_idx, CProfiler::GetTime() - fStart);
+      }
+      else {
+         (*m_ptPhysicsEngines)[un_idx]->Update();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpace::CalculatePhysicsModelTasks() {
+      /* Maximum number of models per task */
+      static const size_t MODELS_PER_TASK = 64;
+      m_vecPhysicsModelTasks.clear();
+      for(size_t i = 0; i < m_ptPhysicsEngines->size(); ++i) {
+         CPhysicsEngine* pcEngine = (*m_ptPhysicsEngines)[i];
+         if(pcEngine->IsModelUpdateParallel()) {
+            size_t unModels = pcEngine->GetNumPhysicsModels();
+            for(size_t unBegin = 0; unBegin < unModels; unBegin += MODELS_PER_TASK) {
+               SPhysicsModelTask sTask = {
+                  pcEngine,
+                  unBegin,
+                  Min(unBegin + MODELS_PER_TASK, unModels)
+               };
+               m_vecPhysicsModelTasks.push_back(sTask);
+            }
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpace::UpdatePhysicsModelsFromEntities(size_t un_task) {
+      const SPhysicsModelTask& sTask = m_vecPhysicsModelTasks[un_task];
+      for(size_t i = sTask.Begin; i < sTask.End; ++i) {
+         sTask.Engine->UpdateFromEntityStatus(i);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpace::UpdateEntitiesFromPhysicsModels(size_t un_task) {
+      const SPhysicsModelTask& sTask = m_vecPhysicsModelTasks[un_task];
+      for(size_t i = sTask.Begin; i < sTask.End; ++i) {
+         sTask.Engine->UpdateEntityStatus(i);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpace::CalculateMediumTasks() {
+      m_vecMediumTasks.clear();
+      for(size_t i = 0; i < m_ptMedia->size(); ++i) {
+         CMedium* pcMedium = (*m_ptMedia)[i];
+         if(pcMedium->IsUpdateParallel()) {
+            size_t unTasks = pcMedium->PrepareUpdateTasks();
+            for(size_t j = 0; j < unTasks; ++j) {
+               SMediumTask sTask = { pcMedium, j };
+               m_vecMediumTasks.push_back(sTask);
+            }
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpace::UpdateMediumTask(size_t un_task) {
+      m_vecMediumTasks[un_task].Medium->ExecuteUpdateTask(
+         m_vecMediumTasks[un_task].Task);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpace::UpdateMedium(size_t un_idx) {
+      if(m_cSimulator.IsProfiling()) {
+         double fStart = CProfiler::GetTime();
+         (*m_ptMedia)[un_idx]->Update();
+         m_cSimulator.GetProfiler().CollectMediumTime(
+            un_idx, CProfiler::GetTime() - fStart);
+      }
+      else {
+         (*m_ptMedia)[un_idx]->Update();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpace::PostUpdatePhysics() {
+      /* Perform entity transfer from engine to engine, if needed */
+      for(size_t i = 0; i < m_ptPhysicsEngines->size(); ++i) {
+         if((*m_ptPhysicsEngines)[i]->IsEntityTransferNeeded()) {
+            (*m_ptPhysicsEngines)[i]->TransferEntities();
+         }
+      }
+      /* Let the engines exchange data */
+      for(size_t i = 0; i < m_ptPhysicsEngines->size(); ++i) {
+         (*m_ptPhysicsEngines)[i]->PostUpdate();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CSpace::AddControllableEntity(CControllableEntity& c_entity) {
       m_vecControllableEntities.push_back(&c_entity);
    }
@@ -29,7 +29,8 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   class CSpace : public CBaseConfigurableResource {
+   class CSpace : public CBaseConfigurableResource,
+                  public CMemento {
 
    public:
 
@@ -120,6 +121,23 @@ namespace argos {
        */
       virtual void Destroy();
 
+      /**
+       * Saves the simulation clock and the state of all the entities.
+       * Each root entity is saved as a separate block, in the order in which
+       * it was added to the space.
+       * @param c_buffer the target buffer
+       */
+      virtual void SaveState(CByteArray& c_buffer);
+
+      /**
+       * Restores the simulation clock and the state of all the entities.
+       * The space must contain the same root entities it had when the state
+       * was saved.
+       * @param c_buffer the source buffer
+       * @throws CARGoSException if the saved entities do not match
+       */
+      virtual void LoadState(CByteArray& c_buffer);
+
       /**
        * Returns the number of entities contained in the space.
        */
@@ -422,6 +440,40 @@ namespace argos {
       virtual void IterateOverControllableEntities(
           const TControllableEntityIterCBType& c_cb) = 0;
 
+      /**
+       * Returns <tt>true</tt> if each controllable entity is always stepped by
+       * the same thread, as long as no controllable entity is removed.
+       * The default implementation returns <tt>true</tt>.
+       * @see GetThreadIndex()
+       */
+      virtual bool HasStaticControllableEntityAssignment() const {
+         return true;
+      }
+
+      /**
+       * Returns the index of the space thread that will step the next
+       * controllable entity added to the space.
+       * Since an entity is initialized before being added to the space, its
+       * controller can use this method in CCI_Controller::Init() to know the
+       * thread it will be stepped by. The result is only meaningful if
+       * HasStaticControllableEntityAssignment() returns <tt>true</tt>.
+       * The default implementation returns zero.
+       * @see GetThreadIndex()
+       */
+      virtual UInt32 GetThreadIndexOfNextControllableEntity() const {
+         return 0;
+      }
+
+      /**
+       * Returns the index of the space thread that executes the caller.
+       * The index is between zero and the number of threads minus one. Outside
+       * the space threads, e.g., in the main thread, the index is zero.
+       * @see HasStaticControllableEntityAssignment()
+       */
+      static UInt32 GetThreadIndex() {
+         return m_unThreadIndex;
+      }
+
    protected:
 
       virtual void UpdateControllableEntitiesAct() = 0;
@@ -442,6 +494,65 @@ namespace argos {
        */
       virtual void ControllableEntityIterationWaitAbort() {}
 
+      /**
+       * Updates the physics engine with the given index.
+       * When profiling, the time taken by the update is recorded.
+       * @param un_idx The index of the physics engine.
+       */
+      void UpdatePhysicsEngine(size_t un_idx);
+
+      /**
+       * Splits the models of the physics engines that are updated in parallel into tasks.
+       * This method must be called before each physics phase, as models may have been
+       * added or removed.
+       * @see CPhysicsEngine::IsModelUpdateParallel()
+       */
+      void CalculatePhysicsModelTasks();
+
+      /**
+       * Updates the models of the given task from the status of their entities.
+       * This is executed before the physics engines are updated.
+       * @param un_task The index of the task.
+       * @see CalculatePhysicsModelTasks()
+       */
+      void UpdatePhysicsModelsFromEntities(size_t un_task);
+
+      /**
+       * Updates the status of the entities of the given task from their models.
+       * This is executed after the physics engines are updated.
+       * @param un_task The index of the task.
+       * @see CalculatePhysicsModelTasks()
+       */
+      void UpdateEntitiesFromPhysicsModels(size_t un_task);
+
+      /**
+       * Prepares the parallel tasks of the media that have them.
+       * This method must be called before each media phase.
+       * @see CMedium::IsUpdateParallel()
+       */
+      void CalculateMediumTasks();
+
+      /**
+       * Executes the given parallel task of a medium.
+       * @param un_task The index of the task.
+       * @see CalculateMediumTasks()
+       */
+      void UpdateMediumTask(size_t un_task);
+
+      /**
+       * Updates the medium with the given index.
+       * When profiling, the time taken by the update is recorded.
+       * @param un_idx The index of the medium.
+       */
+      void UpdateMedium(size_t un_idx);
+
+      /**
+       * Finishes the physics phase, once all the physics engines have been updated.
+       * Transfers the entities that changed engine and calls
+       * CPhysicsEngine::PostUpdate() on each engine.
+       */
+      void PostUpdatePhysics();
+
       void Distribute(TConfigurationNode& t_tree);
 
       void AddBoxStrip(TConfigurationNode& t_tree);
@@ -450,6 +561,15 @@ namespace argos {
         return nullptr != m_cbControllableEntityIter;
       }
 
+      /**
+       * Sets the index returned by GetThreadIndex() in the calling thread.
+       * Each space thread must call this method when it starts.
+       * @param un_index The index of the calling thread.
+       */
+      static void SetThreadIndex(UInt32 un_index) {
+         m_unThreadIndex = un_index;
+      }
+
    protected:
 
       friend class CSpaceOperationAddControllableEntity;
@@ -502,9 +622,37 @@ namespace argos {
       /** Callback for iterating over entities from within the loop functions */
       TControllableEntityIterCBType m_cbControllableEntityIter{nullptr};
 
+      /** A range of models of a physics engine, updated as a single task */
+      struct SPhysicsModelTask {
+         CPhysicsEngine* Engine;
+         size_t Begin;
+         size_t End;
+      };
+
+      /** True if at least one physics engine has its models updated in parallel */
+      bool m_bParallelPhysicsModels;
+
+      /** The per-model tasks of the physics engines updated in parallel */
+      std::vector<SPhysicsModelTask> m_vecPhysicsModelTasks;
+
+      /** A parallel task of a medium */
+      struct SMediumTask {
+         CMedium* Medium;
+         size_t Task;
+      };
+
+      /** True if at least one medium has a parallel part in its update */
+      bool m_bParallelMedia;
+
+      /** The parallel tasks of the media */
+      std::vector<SMediumTask> m_vecMediumTasks;
+
   private:
       TMapPerType& GetEntitiesByTypeImpl(const std::string& str_type) const;
 
+      /** The index of the space thread executing the caller */
+      static thread_local UInt32 m_unThreadIndex;
+
    };
 
    /****************************************/
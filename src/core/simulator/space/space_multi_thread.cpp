@@ -5,6 +5,8 @@
  */
 
 #include <argos3/core/simulator/space/space_multi_thread.h>
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/utility/profiler/profiler.h>
 
 namespace argos {
 
@@ -79,4 +81,25 @@ namespace argos {
      }
    }
 
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThread::CollectThreadPhaseDone(UInt32 un_id) {
+     if(m_cSimulator.IsProfiling()) {
+       m_cSimulator.GetProfiler().CollectThreadPhaseDone(un_id);
+     }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThread::CollectPhaseDone() {
+     if(m_cSimulator.IsProfiling()) {
+       m_cSimulator.GetProfiler().StopSubPhase();
+     }
+   }
+
+   /****************************************/
+   /****************************************/
+
 }
@@ -57,6 +57,20 @@ namespace argos {
                              void *(*start_routine) (void *),
                              void *arg);
 
+     /**
+      * @brief When profiling, record that a slave thread is done with the
+      * current phase, to measure how long it idles at the barrier.
+      *
+      * @param un_id The index/ID of the thread.
+      */
+     void CollectThreadPhaseDone(UInt32 un_id);
+
+     /**
+      * @brief When profiling, record that all the slave threads are done with
+      * the current barrier. Called by the main thread.
+      */
+     void CollectPhaseDone();
+
     private:
 
      /** Should threads be pinned to cores ? */
@@ -7,16 +7,41 @@
 #include "space_multi_thread_balance_length.h"
 #include <argos3/core/simulator/simulator.h>
 #include <argos3/core/utility/profiler/profiler.h>
+#include <argos3/core/utility/math/general.h>
+#include <ctime>
+#if defined(__x86_64__) || defined(__i386__)
+#  include <x86intrin.h>
+#endif
 
 namespace argos {
 
    /****************************************/
    /****************************************/
 
+   /**
+    * Returns a cheap, monotonically increasing timestamp used to measure
+    * the cost of a task. The unit is irrelevant, as costs are only
+    * compared with each other.
+    */
+   static inline UInt64 ReadTimestamp() {
+#if defined(__x86_64__) || defined(__i386__)
+      return __rdtsc();
+#else
+      ::timespec tTime;
+      ::clock_gettime(CLOCK_MONOTONIC, &tTime);
+      return static_cast<UInt64>(tTime.tv_sec) * 1000000000ull + tTime.tv_nsec;
+#endif
+   }
+
+   /****************************************/
+   /****************************************/
+
    struct SCleanupThreadData {
       pthread_mutex_t* StartSenseControlPhaseMutex;
       pthread_mutex_t* StartActPhaseMutex;
       pthread_mutex_t* StartPhysicsPhaseMutex;
+      pthread_mutex_t* StartPhysicsModelsPhaseMutex;
+      pthread_mutex_t* StartMediaTasksPhaseMutex;
       pthread_mutex_t* StartMediaPhaseMutex;
       pthread_mutex_t* StartEntityIterPhaseMutex;
       pthread_mutex_t* FetchTaskMutex;
@@ -33,6 +58,8 @@ namespace argos {
       pthread_mutex_unlock(sData.StartSenseControlPhaseMutex);
       pthread_mutex_unlock(sData.StartActPhaseMutex);
       pthread_mutex_unlock(sData.StartPhysicsPhaseMutex);
+      pthread_mutex_unlock(sData.StartPhysicsModelsPhaseMutex);
+      pthread_mutex_unlock(sData.StartMediaTasksPhaseMutex);
       pthread_mutex_unlock(sData.StartMediaPhaseMutex);
       pthread_mutex_unlock(sData.StartEntityIterPhaseMutex);
    }
@@ -51,11 +78,13 @@ namespace argos {
       sCancelData.StartSenseControlPhaseMutex = &(psData->Space->m_tStartSenseControlPhaseMutex);
       sCancelData.StartActPhaseMutex = &(psData->Space->m_tStartActPhaseMutex);
       sCancelData.StartPhysicsPhaseMutex = &(psData->Space->m_tStartPhysicsPhaseMutex);
+      sCancelData.StartPhysicsModelsPhaseMutex = &(psData->Space->m_tStartPhysicsModelsPhaseMutex);
+      sCancelData.StartMediaTasksPhaseMutex = &(psData->Space->m_tStartMediaTasksPhaseMutex);
       sCancelData.StartMediaPhaseMutex = &(psData->Space->m_tStartMediaPhaseMutex);
       sCancelData.StartEntityIterPhaseMutex = &(psData->Space->m_tStartEntityIterPhaseMutex);
       sCancelData.FetchTaskMutex = &(psData->Space->m_tFetchTaskMutex);
       pthread_cleanup_push(CleanupThread, &sCancelData);
-      psData->Space->SlaveThread();
+      psData->Space->SlaveThread(psData->ThreadId);
       /* Dispose of cancellation data */
       pthread_cleanup_pop(1);
       return nullptr;
@@ -65,12 +94,21 @@ namespace argos {
    /****************************************/
 
    CSpaceMultiThreadBalanceLength::CSpaceMultiThreadBalanceLength(UInt32 un_n_threads,
-                                                                  bool b_pin_threads_to_cores) :
-       CSpaceMultiThread(un_n_threads, b_pin_threads_to_cores) {
+                                                                  bool b_pin_threads_to_cores,
+                                                                  UInt32 un_repartition_period) :
+       CSpaceMultiThread(un_n_threads, b_pin_threads_to_cores),
+       m_unRepartitionPeriod(un_repartition_period),
+       m_unTicksSinceRepartition(0),
+       m_bRepartitionNeeded(false) {
      LOG << "[INFO]   Chosen method \"balance_length\": threads will be assigned different"
          << std::endl
          << "[INFO]   numbers of tasks, depending on the task length."
          << std::endl;
+     if(m_unRepartitionPeriod > 0) {
+        LOG << "[INFO]   Controllable entities will be repartitioned by measured cost every "
+            << m_unRepartitionPeriod << " ticks."
+            << std::endl;
+     }
    }
 
    /****************************************/
@@ -85,6 +123,8 @@ namespace argos {
       if((nErrors = pthread_mutex_init(&m_tStartSenseControlPhaseMutex, nullptr)) ||
          (nErrors = pthread_mutex_init(&m_tStartActPhaseMutex, nullptr)) ||
          (nErrors = pthread_mutex_init(&m_tStartPhysicsPhaseMutex, nullptr)) ||
+         (nErrors = pthread_mutex_init(&m_tStartPhysicsModelsPhaseMutex, nullptr)) ||
+         (nErrors = pthread_mutex_init(&m_tStartMediaTasksPhaseMutex, nullptr)) ||
          (nErrors = pthread_mutex_init(&m_tStartMediaPhaseMutex, nullptr)) ||
          (nErrors = pthread_mutex_init(&m_tStartEntityIterPhaseMutex, nullptr)) ||
          (nErrors = pthread_mutex_init(&m_tFetchTaskMutex, nullptr))) {
@@ -94,6 +134,8 @@ namespace argos {
       if((nErrors = pthread_cond_init(&m_tStartSenseControlPhaseCond, nullptr)) ||
          (nErrors = pthread_cond_init(&m_tStartActPhaseCond, nullptr)) ||
          (nErrors = pthread_cond_init(&m_tStartPhysicsPhaseCond, nullptr)) ||
+         (nErrors = pthread_cond_init(&m_tStartPhysicsModelsPhaseCond, nullptr)) ||
+         (nErrors = pthread_cond_init(&m_tStartMediaTasksPhaseCond, nullptr)) ||
          (nErrors = pthread_cond_init(&m_tStartMediaPhaseCond, nullptr)) ||
          (nErrors = pthread_cond_init(&m_tStartEntityIterPhaseCond, nullptr)) ||
          (nErrors = pthread_cond_init(&m_tFetchTaskCond, nullptr))) {
@@ -103,6 +145,8 @@ namespace argos {
       m_unSenseControlPhaseIdleCounter = GetNumThreads();
       m_unActPhaseIdleCounter = GetNumThreads();
       m_unPhysicsPhaseIdleCounter = GetNumThreads();
+      m_unPhysicsModelsPhaseIdleCounter = GetNumThreads();
+      m_unMediaTasksPhaseIdleCounter = GetNumThreads();
       m_unMediaPhaseIdleCounter = GetNumThreads();
       m_unEntityIterPhaseIdleCounter = GetNumThreads();
       /* Start threads */
@@ -126,6 +170,8 @@ namespace argos {
       pthread_mutex_destroy(&m_tStartSenseControlPhaseMutex);
       pthread_mutex_destroy(&m_tStartActPhaseMutex);
       pthread_mutex_destroy(&m_tStartPhysicsPhaseMutex);
+      pthread_mutex_destroy(&m_tStartPhysicsModelsPhaseMutex);
+      pthread_mutex_destroy(&m_tStartMediaTasksPhaseMutex);
       pthread_mutex_destroy(&m_tStartMediaPhaseMutex);
       pthread_mutex_destroy(&m_tStartEntityIterPhaseMutex);
       pthread_mutex_destroy(&m_tFetchTaskMutex);
@@ -133,6 +179,8 @@ namespace argos {
       pthread_cond_destroy(&m_tStartSenseControlPhaseCond);
       pthread_cond_destroy(&m_tStartActPhaseCond);
       pthread_cond_destroy(&m_tStartPhysicsPhaseCond);
+      pthread_cond_destroy(&m_tStartPhysicsModelsPhaseCond);
+      pthread_cond_destroy(&m_tStartMediaTasksPhaseCond);
       pthread_cond_destroy(&m_tStartMediaPhaseCond);
       pthread_cond_destroy(&m_tStartEntityIterPhaseCond);
       pthread_cond_destroy(&m_tFetchTaskCond);
@@ -149,8 +197,16 @@ namespace argos {
       m_unSenseControlPhaseIdleCounter = GetNumThreads();
       m_unActPhaseIdleCounter = GetNumThreads();
       m_unPhysicsPhaseIdleCounter = GetNumThreads();
+      m_unPhysicsModelsPhaseIdleCounter = GetNumThreads();
+      m_unMediaTasksPhaseIdleCounter = GetNumThreads();
       m_unMediaPhaseIdleCounter = GetNumThreads();
       m_unEntityIterPhaseIdleCounter = GetNumThreads();
+      /* Is it time to repartition the entities by cost? */
+      if(m_unRepartitionPeriod > 0 &&
+         ++m_unTicksSinceRepartition >= m_unRepartitionPeriod) {
+         m_bRepartitionNeeded = true;
+         m_unTicksSinceRepartition = 0;
+      }
       /* Update the space */
       CSpace::Update();
    }
@@ -170,9 +226,14 @@ namespace argos {
    while(m_un ## PHASE ## PhaseIdleCounter < GetNumThreads()) {   \
       pthread_cond_wait(&m_tStart ## PHASE ## PhaseCond, &m_tStart ## PHASE ## PhaseMutex); \
    }                                                                                        \
-   pthread_mutex_unlock(&m_tStart ## PHASE ## PhaseMutex);
+   pthread_mutex_unlock(&m_tStart ## PHASE ## PhaseMutex);                                  \
+   CollectPhaseDone();
 
    void CSpaceMultiThreadBalanceLength::UpdateControllableEntitiesAct() {
+      /* Calculate the entity ranges, if needed */
+      if(m_unRepartitionPeriod > 0) {
+         UpdateCostPartition(m_vecActCosts, m_vecActPartition);
+      }
       /* Act phase */
       MAIN_START_PHASE(Act);
       MAIN_WAIT_FOR_END_OF(Act);
@@ -182,21 +243,34 @@ namespace argos {
    /****************************************/
 
    void CSpaceMultiThreadBalanceLength::UpdatePhysics() {
+      /* Update the models whose engines delegate it to the space */
+      if(m_bParallelPhysicsModels) {
+         CalculatePhysicsModelTasks();
+         MAIN_START_PHASE(PhysicsModels);
+         MAIN_WAIT_FOR_END_OF(PhysicsModels);
+      }
       /* Physics phase */
       MAIN_START_PHASE(Physics);
       MAIN_WAIT_FOR_END_OF(Physics);
-      /* Perform entity transfer from engine to engine, if needed */
-      for(size_t i = 0; i < m_ptPhysicsEngines->size(); ++i) {
-         if((*m_ptPhysicsEngines)[i]->IsEntityTransferNeeded()) {
-            (*m_ptPhysicsEngines)[i]->TransferEntities();
-         }
+      /* Update the entities whose engines delegate it to the space */
+      if(m_bParallelPhysicsModels) {
+         MAIN_START_PHASE(PhysicsModels);
+         MAIN_WAIT_FOR_END_OF(PhysicsModels);
       }
+      /* Transfer entities among engines and let the engines synchronize */
+      PostUpdatePhysics();
    }
 
    /****************************************/
    /****************************************/
 
    void CSpaceMultiThreadBalanceLength::UpdateMedia() {
+      /* Parallel tasks of the media */
+      if(m_bParallelMedia) {
+         CalculateMediumTasks();
+         MAIN_START_PHASE(MediaTasks);
+         MAIN_WAIT_FOR_END_OF(MediaTasks);
+      }
       /* Media phase */
       MAIN_START_PHASE(Media);
       MAIN_WAIT_FOR_END_OF(Media);
@@ -213,11 +287,23 @@ namespace argos {
      MAIN_WAIT_FOR_END_OF(EntityIter);
    } /* IterateOverControllableEntities() */
 
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadBalanceLength::ControllableEntityIterationWaitAbort() {
+     IterateOverControllableEntities(nullptr);
+   } /* ControllableEntityIterationWaitAbort() */
 
    /****************************************/
    /****************************************/
 
    void CSpaceMultiThreadBalanceLength::UpdateControllableEntitiesSenseStep() {
+      /* Calculate the entity ranges, if needed */
+      if(m_unRepartitionPeriod > 0) {
+         UpdateCostPartition(m_vecSenseControlCosts, m_vecSenseControlPartition);
+         /* Both phases have been repartitioned now */
+         m_bRepartitionNeeded = false;
+      }
       /* Sense/control phase */
       MAIN_START_PHASE(SenseControl);
       MAIN_WAIT_FOR_END_OF(SenseControl);
@@ -226,6 +312,50 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CSpaceMultiThreadBalanceLength::UpdateCostPartition(std::vector<UInt64>& vec_costs,
+                                                            std::vector<size_t>& vec_partition) {
+      size_t unEntities = m_vecControllableEntities.size();
+      vec_partition.resize(GetNumThreads() + 1);
+      if(vec_costs.size() != unEntities) {
+         /* Entities were added or removed: no cost information, split evenly */
+         vec_costs.assign(unEntities, 0);
+         for(UInt32 i = 0; i <= GetNumThreads(); ++i) {
+            vec_partition[i] = (unEntities * i) / GetNumThreads();
+         }
+      }
+      else if(m_bRepartitionNeeded) {
+         /* Calculate the total cost; every entity costs at least 1 */
+         UInt64 unTotalCost = 0;
+         for(size_t i = 0; i < unEntities; ++i) {
+            unTotalCost += Max<UInt64>(vec_costs[i], 1);
+         }
+         /*
+          * Walk through the entities, closing the range of thread t when the
+          * accumulated cost crosses t/N of the total. An entity is assigned
+          * to the range that contains the middle of its cost.
+          */
+         vec_partition[0] = 0;
+         UInt64 unAccumulatedCost = 0;
+         size_t unEntity = 0;
+         for(UInt32 t = 1; t < GetNumThreads(); ++t) {
+            UInt64 unTarget = (unTotalCost * t) / GetNumThreads();
+            while(unEntity < unEntities) {
+               UInt64 unCost = Max<UInt64>(vec_costs[unEntity], 1);
+               if(unAccumulatedCost + unCost / 2 > unTarget) break;
+               unAccumulatedCost += unCost;
+               ++unEntity;
+            }
+            vec_partition[t] = unEntity;
+         }
+         vec_partition[GetNumThreads()] = unEntities;
+         /* Start measuring anew */
+         vec_costs.assign(unEntities, 0);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CSpaceMultiThreadBalanceLength::StartThreads() {
       m_psThreadData = new SThreadLaunchData*[GetNumThreads()];
       /* Create the threads */
@@ -250,6 +380,27 @@ namespace argos {
    pthread_mutex_unlock(&m_tStart ## PHASE ## PhaseMutex);                                  \
    pthread_testcancel();
 
+#define THREAD_SIGNAL_IDLE(PHASE)                                   \
+   CollectThreadPhaseDone(un_id);                                   \
+   pthread_mutex_lock(&m_tStart ## PHASE ## PhaseMutex);            \
+   ++m_un ## PHASE ## PhaseIdleCounter;                             \
+   pthread_cond_broadcast(&m_tStart ## PHASE ## PhaseCond);         \
+   pthread_mutex_unlock(&m_tStart ## PHASE ## PhaseMutex);          \
+   pthread_testcancel();
+
+#define THREAD_PERFORM_TASK_RANGE(PHASE, PARTITION, COSTS, SNIPPET) \
+   for(unTaskIndex = (PARTITION)[un_id];                            \
+       unTaskIndex < (PARTITION)[un_id + 1];                        \
+       ++unTaskIndex) {                                             \
+      unStartTime = ReadTimestamp();                                \
+      {                                                             \
+         SNIPPET;                                                   \
+      }                                                             \
+      (COSTS)[unTaskIndex] += ReadTimestamp() - unStartTime;        \
+   }                                                                \
+   pthread_testcancel();                                            \
+   THREAD_SIGNAL_IDLE(PHASE);
+
 #define THREAD_PERFORM_TASK(PHASE, TASKVEC, CONDITION, SNIPPET)     \
    while(1) {                                                       \
       pthread_mutex_lock(&m_tFetchTaskMutex);                       \
@@ -266,40 +417,76 @@ namespace argos {
       else {                                                        \
          pthread_mutex_unlock(&m_tFetchTaskMutex);                  \
          pthread_testcancel();                                      \
-         pthread_mutex_lock(&m_tStart ## PHASE ## PhaseMutex);      \
-         ++m_un ## PHASE ## PhaseIdleCounter;                       \
-         pthread_cond_broadcast(&m_tStart ## PHASE ## PhaseCond);   \
-         pthread_mutex_unlock(&m_tStart ## PHASE ## PhaseMutex);    \
-         pthread_testcancel();                                      \
+         THREAD_SIGNAL_IDLE(PHASE);                                 \
          break;                                                     \
       }                                                             \
    }                                                                \
    pthread_testcancel();
 
-   void CSpaceMultiThreadBalanceLength::SlaveThread() {
+   void CSpaceMultiThreadBalanceLength::SlaveThread(UInt32 un_id) {
+      SetThreadIndex(un_id);
       /* Task index */
       size_t unTaskIndex;
+      /* Task start time, to measure task cost */
+      UInt64 unStartTime;
       while(1) {
          THREAD_WAIT_FOR_START_OF(Act);
-         THREAD_PERFORM_TASK(
-            Act,
-            m_vecControllableEntities,
-            true,
-            if(m_vecControllableEntities[unTaskIndex]->IsEnabled()) m_vecControllableEntities[unTaskIndex]->Act();
-            );
+         if(m_unRepartitionPeriod > 0) {
+            THREAD_PERFORM_TASK_RANGE(
+               Act,
+               m_vecActPartition,
+               m_vecActCosts,
+               if(m_vecControllableEntities[unTaskIndex]->IsEnabled()) m_vecControllableEntities[unTaskIndex]->Act();
+               );
+         }
+         else {
+            THREAD_PERFORM_TASK(
+               Act,
+               m_vecControllableEntities,
+               true,
+               if(m_vecControllableEntities[unTaskIndex]->IsEnabled()) m_vecControllableEntities[unTaskIndex]->Act();
+               );
+         }
+         if(m_bParallelPhysicsModels) {
+            THREAD_WAIT_FOR_START_OF(PhysicsModels);
+            THREAD_PERFORM_TASK(
+               PhysicsModels,
+               m_vecPhysicsModelTasks,
+               true,
+               UpdatePhysicsModelsFromEntities(unTaskIndex);
+               );
+         }
          THREAD_WAIT_FOR_START_OF(Physics);
          THREAD_PERFORM_TASK(
             Physics,
             *m_ptPhysicsEngines,
             true,
-            (*m_ptPhysicsEngines)[unTaskIndex]->Update();
+            UpdatePhysicsEngine(unTaskIndex);
             );
+         if(m_bParallelPhysicsModels) {
+            THREAD_WAIT_FOR_START_OF(PhysicsModels);
+            THREAD_PERFORM_TASK(
+               PhysicsModels,
+               m_vecPhysicsModelTasks,
+               true,
+               UpdateEntitiesFromPhysicsModels(unTaskIndex);
+               );
+         }
+         if(m_bParallelMedia) {
+            THREAD_WAIT_FOR_START_OF(MediaTasks);
+            THREAD_PERFORM_TASK(
+               MediaTasks,
+               m_vecMediumTasks,
+               true,
+               UpdateMediumTask(unTaskIndex);
+               );
+         }
          THREAD_WAIT_FOR_START_OF(Media);
          THREAD_PERFORM_TASK(
             Media,
             *m_ptMedia,
             true,
-            (*m_ptMedia)[unTaskIndex]->Update();
+            UpdateMedium(unTaskIndex);
             );
          /* loop functions PreStep() */
          THREAD_WAIT_FOR_START_OF(EntityIter);
@@ -309,15 +496,28 @@ namespace argos {
              ControllableEntityIterationEnabled(),
              m_cbControllableEntityIter(m_vecControllableEntities[unTaskIndex]));
          THREAD_WAIT_FOR_START_OF(SenseControl);
-         THREAD_PERFORM_TASK(
-            SenseControl,
-            m_vecControllableEntities,
-            true,
-            if(m_vecControllableEntities[unTaskIndex]->IsEnabled()) {
-               m_vecControllableEntities[unTaskIndex]->Sense();
-               m_vecControllableEntities[unTaskIndex]->ControlStep();
-            }
-            );
+         if(m_unRepartitionPeriod > 0) {
+            THREAD_PERFORM_TASK_RANGE(
+               SenseControl,
+               m_vecSenseControlPartition,
+               m_vecSenseControlCosts,
+               if(m_vecControllableEntities[unTaskIndex]->IsEnabled()) {
+                  m_vecControllableEntities[unTaskIndex]->Sense();
+                  m_vecControllableEntities[unTaskIndex]->ControlStep();
+               }
+               );
+         }
+         else {
+            THREAD_PERFORM_TASK(
+               SenseControl,
+               m_vecControllableEntities,
+               true,
+               if(m_vecControllableEntities[unTaskIndex]->IsEnabled()) {
+                  m_vecControllableEntities[unTaskIndex]->Sense();
+                  m_vecControllableEntities[unTaskIndex]->ControlStep();
+               }
+               );
+         }
          /* loop functions PostStep() */
          THREAD_WAIT_FOR_START_OF(EntityIter);
          THREAD_PERFORM_TASK(
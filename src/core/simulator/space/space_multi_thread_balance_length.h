@@ -23,8 +23,19 @@ namespace argos {
 
    public:
 
+      /**
+       * Class constructor.
+       * @param un_n_threads The number of slave threads.
+       * @param b_pin_threads_to_cores Whether to pin the threads to cores.
+       * @param un_repartition_period If greater than 0, the act and
+       * sense/control phases do not fetch controllable entities one by one;
+       * rather, each thread is assigned a contiguous range of entities
+       * whose measured cost is balanced across threads. The ranges are
+       * recalculated every <tt>un_repartition_period</tt> ticks.
+       */
       CSpaceMultiThreadBalanceLength(UInt32 un_n_threads,
-                                     bool b_pin_threads_to_cores);
+                                     bool b_pin_threads_to_cores,
+                                     UInt32 un_repartition_period = 0);
       virtual ~CSpaceMultiThreadBalanceLength() {}
 
       virtual void Init(TConfigurationNode& t_tree);
@@ -37,13 +48,31 @@ namespace argos {
       virtual void UpdateControllableEntitiesSenseStep();
       virtual void IterateOverControllableEntities(
           const TControllableEntityIterCBType& c_cb);
+      virtual void ControllableEntityIterationWaitAbort();
+
+      /* the threads pick the controllable entities as they become idle */
+      virtual bool HasStaticControllableEntityAssignment() const {
+         return false;
+      }
 
    private:
 
       void StartThreads();
-      void SlaveThread();
+      void SlaveThread(UInt32 un_id);
       friend void* LaunchThreadBalanceLength(void* p_data);
 
+      /**
+       * Calculates the entity range assigned to each thread for a phase.
+       * If the number of entities has changed, the costs are reset and the
+       * entities are split evenly. Otherwise, if a repartition is due, the
+       * entities are split so that the accumulated cost of each range is
+       * balanced, and the costs are reset.
+       * @param vec_costs The accumulated cost of each entity in the phase.
+       * @param vec_partition The range boundaries, one per thread plus one.
+       */
+      void UpdateCostPartition(std::vector<UInt64>& vec_costs,
+                               std::vector<size_t>& vec_partition);
+
    private:
 
       /** Thread date */
@@ -76,6 +105,10 @@ namespace argos {
       pthread_mutex_t m_tStartEntityIterPhaseMutex;
       /** Mutex to fetch a task from the dispatcher */
       pthread_mutex_t m_tFetchTaskMutex;
+      /** Mutex for the start of the physics models phase */
+      pthread_mutex_t m_tStartPhysicsModelsPhaseMutex;
+      /** Mutex for the start of the media tasks phase */
+      pthread_mutex_t m_tStartMediaTasksPhaseMutex;
 
       /** Conditional for the start of the sense/control phase */
       pthread_cond_t m_tStartSenseControlPhaseCond;
@@ -89,6 +122,10 @@ namespace argos {
       pthread_cond_t m_tStartEntityIterPhaseCond;
       /** Conditional controlling task fetching from the dispatcher */
       pthread_cond_t m_tFetchTaskCond;
+      /** Conditional for the start of the physics models phase */
+      pthread_cond_t m_tStartPhysicsModelsPhaseCond;
+      /** Conditional for the start of the media tasks phase */
+      pthread_cond_t m_tStartMediaTasksPhaseCond;
 
       /** How many threads are idle in the sense/control phase */
       UInt32 m_unSenseControlPhaseIdleCounter;
@@ -100,6 +137,25 @@ namespace argos {
       UInt32 m_unMediaPhaseIdleCounter;
       /** How many threads are idle in the media phase */
       UInt32 m_unEntityIterPhaseIdleCounter;
+      /** How many threads are idle in the physics models phase */
+      UInt32 m_unPhysicsModelsPhaseIdleCounter;
+      /** How many threads are idle in the media tasks phase */
+      UInt32 m_unMediaTasksPhaseIdleCounter;
+
+      /** How often (in ticks) entities are repartitioned by cost; 0 to disable */
+      UInt32 m_unRepartitionPeriod;
+      /** Ticks elapsed since the last repartition */
+      UInt32 m_unTicksSinceRepartition;
+      /** Whether the entities must be repartitioned at the next phase */
+      bool m_bRepartitionNeeded;
+      /** Accumulated cost of the act phase, per entity */
+      std::vector<UInt64> m_vecActCosts;
+      /** Accumulated cost of the sense/control phase, per entity */
+      std::vector<UInt64> m_vecSenseControlCosts;
+      /** Entity range boundaries of each thread in the act phase */
+      std::vector<size_t> m_vecActPartition;
+      /** Entity range boundaries of each thread in the sense/control phase */
+      std::vector<size_t> m_vecSenseControlPartition;
 
    };
 
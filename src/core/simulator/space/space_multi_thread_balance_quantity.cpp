@@ -19,6 +19,8 @@ namespace argos {
       pthread_mutex_t* SenseControlStepConditionalMutex;
       pthread_mutex_t* ActConditionalMutex;
       pthread_mutex_t* PhysicsConditionalMutex;
+      pthread_mutex_t* PhysicsModelsConditionalMutex;
+      pthread_mutex_t* MediaTasksConditionalMutex;
       pthread_mutex_t* MediaConditionalMutex;
       pthread_mutex_t* EntityIterConditionalMutex;
    };
@@ -33,6 +35,8 @@ namespace argos {
       pthread_mutex_unlock(sData.SenseControlStepConditionalMutex);
       pthread_mutex_unlock(sData.ActConditionalMutex);
       pthread_mutex_unlock(sData.PhysicsConditionalMutex);
+      pthread_mutex_unlock(sData.PhysicsModelsConditionalMutex);
+      pthread_mutex_unlock(sData.MediaTasksConditionalMutex);
       pthread_mutex_unlock(sData.MediaConditionalMutex);
       pthread_mutex_unlock(sData.EntityIterConditionalMutex);
    }
@@ -51,8 +55,7 @@ namespace argos {
    CSpaceMultiThreadBalanceQuantity::CSpaceMultiThreadBalanceQuantity(UInt32 un_n_threads,
                                                                       bool b_pin_threads_to_cores) :
          CSpaceMultiThread(un_n_threads, b_pin_threads_to_cores),
-         m_psUpdateThreadData(nullptr),
-         m_bIsControllableEntityAssignmentRecalculationNeeded(true) {
+         m_psUpdateThreadData(nullptr) {
      LOG << "[INFO]   Chosen method \"balance_quantity\": threads will be assigned the same"
          << std::endl
          << "[INFO]   number of tasks, independently of the task length."
@@ -71,6 +74,8 @@ namespace argos {
       m_unSenseControlStepPhaseDoneCounter = CSimulator::GetInstance().GetNumThreads();
       m_unActPhaseDoneCounter = CSimulator::GetInstance().GetNumThreads();
       m_unPhysicsPhaseDoneCounter = CSimulator::GetInstance().GetNumThreads();
+      m_unPhysicsModelsPhaseDoneCounter = CSimulator::GetInstance().GetNumThreads();
+      m_unMediaTasksPhaseDoneCounter = CSimulator::GetInstance().GetNumThreads();
       m_unMediaPhaseDoneCounter = CSimulator::GetInstance().GetNumThreads();
       m_unEntityIterPhaseDoneCounter = CSimulator::GetInstance().GetNumThreads();
 
@@ -78,6 +83,8 @@ namespace argos {
       if((nErrors = pthread_mutex_init(&m_tSenseControlStepConditionalMutex, nullptr)) ||
          (nErrors = pthread_mutex_init(&m_tActConditionalMutex, nullptr)) ||
          (nErrors = pthread_mutex_init(&m_tPhysicsConditionalMutex, nullptr)) ||
+         (nErrors = pthread_mutex_init(&m_tPhysicsModelsConditionalMutex, nullptr)) ||
+         (nErrors = pthread_mutex_init(&m_tMediaTasksConditionalMutex, nullptr)) ||
          (nErrors = pthread_mutex_init(&m_tMediaConditionalMutex, nullptr)) ||
          (nErrors = pthread_mutex_init(&m_tEntityIterConditionalMutex, nullptr))) {
          THROW_ARGOSEXCEPTION("Error creating thread mutexes " << ::strerror(nErrors));
@@ -86,6 +93,8 @@ namespace argos {
       if((nErrors = pthread_cond_init(&m_tSenseControlStepConditional, nullptr)) ||
          (nErrors = pthread_cond_init(&m_tActConditional, nullptr)) ||
          (nErrors = pthread_cond_init(&m_tPhysicsConditional, nullptr)) ||
+         (nErrors = pthread_cond_init(&m_tPhysicsModelsConditional, nullptr)) ||
+         (nErrors = pthread_cond_init(&m_tMediaTasksConditional, nullptr)) ||
          (nErrors = pthread_cond_init(&m_tMediaConditional, nullptr)) ||
          (nErrors = pthread_cond_init(&m_tEntityIterConditional, nullptr))) {
          THROW_ARGOSEXCEPTION("Error creating thread conditionals " << ::strerror(nErrors));
@@ -127,12 +136,16 @@ namespace argos {
       pthread_mutex_destroy(&m_tSenseControlStepConditionalMutex);
       pthread_mutex_destroy(&m_tActConditionalMutex);
       pthread_mutex_destroy(&m_tPhysicsConditionalMutex);
+      pthread_mutex_destroy(&m_tPhysicsModelsConditionalMutex);
+      pthread_mutex_destroy(&m_tMediaTasksConditionalMutex);
       pthread_mutex_destroy(&m_tMediaConditionalMutex);
       pthread_mutex_destroy(&m_tEntityIterConditionalMutex);
 
       pthread_cond_destroy(&m_tSenseControlStepConditional);
       pthread_cond_destroy(&m_tActConditional);
       pthread_cond_destroy(&m_tPhysicsConditional);
+      pthread_cond_destroy(&m_tPhysicsModelsConditional);
+      pthread_cond_destroy(&m_tMediaTasksConditional);
       pthread_cond_destroy(&m_tMediaConditional);
       pthread_cond_destroy(&m_tEntityIterConditional);
 
@@ -143,17 +156,9 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   void CSpaceMultiThreadBalanceQuantity::AddControllableEntity(CControllableEntity& c_entity) {
-      m_bIsControllableEntityAssignmentRecalculationNeeded = true;
-      CSpace::AddControllableEntity(c_entity);
-   }
-
-   /****************************************/
-   /****************************************/
-
-   void CSpaceMultiThreadBalanceQuantity::RemoveControllableEntity(CControllableEntity& c_entity) {
-      m_bIsControllableEntityAssignmentRecalculationNeeded = true;
-      CSpace::RemoveControllableEntity(c_entity);
+   UInt32 CSpaceMultiThreadBalanceQuantity::GetThreadIndexOfNextControllableEntity() const {
+      /* The entities are dealt to the threads in turn */
+      return m_vecControllableEntities.size() % CSimulator::GetInstance().GetNumThreads();
    }
 
    /****************************************/
@@ -172,34 +177,46 @@ namespace argos {
    while(m_un ## PHASE ## PhaseDoneCounter < CSimulator::GetInstance().GetNumThreads()) { \
       pthread_cond_wait(&m_t ## PHASE ## Conditional, &m_t ## PHASE ## ConditionalMutex); \
    }                                                                    \
-   pthread_mutex_unlock(&m_t ## PHASE ## ConditionalMutex);
+   pthread_mutex_unlock(&m_t ## PHASE ## ConditionalMutex);             \
+   CollectPhaseDone();
 
    void CSpaceMultiThreadBalanceQuantity::UpdateControllableEntitiesAct() {
       MAIN_SEND_GO_FOR_PHASE(Act);
       MAIN_WAIT_FOR_PHASE_END(Act);
-      /* Avoid recalculation at the next time step */
-      m_bIsControllableEntityAssignmentRecalculationNeeded = false;
    }
 
    /****************************************/
    /****************************************/
 
    void CSpaceMultiThreadBalanceQuantity::UpdatePhysics() {
+      /* Update the models whose engines delegate it to the space */
+      if(m_bParallelPhysicsModels) {
+         CalculatePhysicsModelTasks();
+         MAIN_SEND_GO_FOR_PHASE(PhysicsModels);
+         MAIN_WAIT_FOR_PHASE_END(PhysicsModels);
+      }
       /* Update the physics engines */
       MAIN_SEND_GO_FOR_PHASE(Physics);
       MAIN_WAIT_FOR_PHASE_END(Physics);
-      /* Perform entity transfer from engine to engine, if needed */
-      for(size_t i = 0; i < m_ptPhysicsEngines->size(); ++i) {
-         if((*m_ptPhysicsEngines)[i]->IsEntityTransferNeeded()) {
-            (*m_ptPhysicsEngines)[i]->TransferEntities();
-         }
+      /* Update the entities whose engines delegate it to the space */
+      if(m_bParallelPhysicsModels) {
+         MAIN_SEND_GO_FOR_PHASE(PhysicsModels);
+         MAIN_WAIT_FOR_PHASE_END(PhysicsModels);
       }
+      /* Transfer entities among engines and let the engines synchronize */
+      PostUpdatePhysics();
    }
 
    /****************************************/
    /****************************************/
 
    void CSpaceMultiThreadBalanceQuantity::UpdateMedia() {
+      /* Execute the parallel tasks of the media */
+      if(m_bParallelMedia) {
+         CalculateMediumTasks();
+         MAIN_SEND_GO_FOR_PHASE(MediaTasks);
+         MAIN_WAIT_FOR_PHASE_END(MediaTasks);
+      }
       /* Update the media */
       MAIN_SEND_GO_FOR_PHASE(Media);
       MAIN_WAIT_FOR_PHASE_END(Media);
@@ -231,8 +248,6 @@ namespace argos {
    void CSpaceMultiThreadBalanceQuantity::UpdateControllableEntitiesSenseStep() {
       MAIN_SEND_GO_FOR_PHASE(SenseControlStep);
       MAIN_WAIT_FOR_PHASE_END(SenseControlStep);
-      /* Avoid recalculation at the next time step */
-      m_bIsControllableEntityAssignmentRecalculationNeeded = false;
    }
 
    /****************************************/
@@ -247,6 +262,7 @@ namespace argos {
    pthread_testcancel();
 
 #define THREAD_SIGNAL_PHASE_DONE(PHASE)                     \
+   CollectThreadPhaseDone(un_id);                           \
    pthread_mutex_lock(&m_t ## PHASE ## ConditionalMutex);   \
    ++m_un ## PHASE ## PhaseDoneCounter;                     \
    pthread_cond_broadcast(&m_t ## PHASE ## Conditional);    \
@@ -287,6 +303,7 @@ namespace argos {
    }
 
    void CSpaceMultiThreadBalanceQuantity::UpdateThread(UInt32 un_id) {
+      SetThreadIndex(un_id);
       /* Copy the id */
       UInt32 unId = un_id;
       /* Create cancellation data */
@@ -294,6 +311,8 @@ namespace argos {
       sCancelData.SenseControlStepConditionalMutex = &m_tSenseControlStepConditionalMutex;
       sCancelData.ActConditionalMutex = &m_tActConditionalMutex;
       sCancelData.PhysicsConditionalMutex = &m_tPhysicsConditionalMutex;
+      sCancelData.PhysicsModelsConditionalMutex = &m_tPhysicsModelsConditionalMutex;
+      sCancelData.MediaTasksConditionalMutex = &m_tMediaTasksConditionalMutex;
       sCancelData.MediaConditionalMutex = &m_tMediaConditionalMutex;
       sCancelData.EntityIterConditionalMutex = &m_tEntityIterConditionalMutex;
 
@@ -306,32 +325,39 @@ namespace argos {
       CRange<size_t> cMediaRange = CalculatePluginRangeForThread(unId,
                                                                  m_ptMedia->size());
 
-      /*
-       * Id range for the entities to update assigned to this thread. Can change
-       * as simulation progressesso periodic re-calculation may be necessary
-       * before *ANY* phase which iterates over the entities, as the
-       * CLoopFunctions::PreStep()/CLoopFunctions::PostStep() may have
-       * added/removed entities.
-       */
-      CRange<size_t> cEntityRange;
       while (1) {
         /* Actuate entities assigned to this thread */
-        UpdateThreadEntityAct(un_id, cEntityRange);
+        UpdateThreadEntityAct(un_id);
+
+        /* Update physics models assigned to this thread (maybe) */
+        if(m_bParallelPhysicsModels) {
+          UpdateThreadPhysicsModels(un_id, true);
+        }
 
         /* Update physics engines assigned to this thread */
-        UpdateThreadPhysics(cPhysicsRange);
+        UpdateThreadPhysics(un_id, cPhysicsRange);
+
+        /* Update entities of the physics models assigned to this thread (maybe) */
+        if(m_bParallelPhysicsModels) {
+          UpdateThreadPhysicsModels(un_id, false);
+        }
+
+        /* Execute media tasks assigned to this thread (maybe) */
+        if(m_bParallelMedia) {
+          UpdateThreadMediaTasks(un_id);
+        }
 
         /* Update media assigned to this thread */
-        UpdateThreadMedia(cMediaRange);
+        UpdateThreadMedia(un_id, cMediaRange);
 
         /* loop functions PreStep() iteration (maybe) */
-        UpdateThreadIterateOverEntities(un_id, cEntityRange);
+        UpdateThreadIterateOverEntities(un_id);
 
         /* Update sensor readings/execute control step for entities */
-        UpdateThreadEntitySenseControl(un_id, cEntityRange);
+        UpdateThreadEntitySenseControl(un_id);
 
         /* loop functions PostStep() iteration (maybe) */
-        UpdateThreadIterateOverEntities(un_id, cEntityRange);
+        UpdateThreadIterateOverEntities(un_id);
       } /* while(1) */
 
       pthread_cleanup_pop(1);
@@ -340,42 +366,30 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   void CSpaceMultiThreadBalanceQuantity::UpdateThreadEntityAct(UInt32 un_id,
-                                                                CRange<size_t>& c_range) {
+   void CSpaceMultiThreadBalanceQuantity::UpdateThreadEntityAct(UInt32 un_id) {
      THREAD_WAIT_FOR_GO_SIGNAL(Act);
-     /* Calculate the portion of entities to update, if needed */
-     if (m_bIsControllableEntityAssignmentRecalculationNeeded) {
-       c_range = CalculatePluginRangeForThread(un_id,
-                                               m_vecControllableEntities.size());
-     }
-     /* Cope with the fact that there may be less entities than threads */
-     if (c_range.GetSpan() > 0) {
-       /* This thread has entities */
-       /* Actuate control choices */
-       for(size_t i = c_range.GetMin(); i < c_range.GetMax(); ++i) {
-         if(m_vecControllableEntities[i]->IsEnabled())
-           m_vecControllableEntities[i]->Act();
-       }
-       pthread_testcancel();
-       THREAD_SIGNAL_PHASE_DONE(Act);
-     }
-     else {
-       /* This thread has no entities -> dummy computation */
-       THREAD_SIGNAL_PHASE_DONE(Act);
+     /* Actuate control choices */
+     for(size_t i = un_id;
+         i < m_vecControllableEntities.size();
+         i += CSimulator::GetInstance().GetNumThreads()) {
+       if(m_vecControllableEntities[i]->IsEnabled())
+         m_vecControllableEntities[i]->Act();
      }
+     pthread_testcancel();
+     THREAD_SIGNAL_PHASE_DONE(Act);
    } /* UpdateThreadEntityAct() */
 
    /****************************************/
    /****************************************/
 
    void CSpaceMultiThreadBalanceQuantity::UpdateThreadPhysics(
-       const CRange<size_t>& c_range) {
+       UInt32 un_id, const CRange<size_t>& c_range) {
      /* Update physics engines, if this thread has been assigned to them */
      THREAD_WAIT_FOR_GO_SIGNAL(Physics);
      if (c_range.GetSpan() > 0) {
        /* This thread has engines, update them */
        for (size_t i = c_range.GetMin(); i < c_range.GetMax(); ++i) {
-         (*m_ptPhysicsEngines)[i]->Update();
+         UpdatePhysicsEngine(i);
        }
        pthread_testcancel();
        THREAD_SIGNAL_PHASE_DONE(Physics);
@@ -389,14 +403,50 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CSpaceMultiThreadBalanceQuantity::UpdateThreadPhysicsModels(
+       UInt32 un_id, bool b_from_entities) {
+     THREAD_WAIT_FOR_GO_SIGNAL(PhysicsModels);
+     /* The number of tasks changes as models are added and removed */
+     CRange<size_t> cRange = CalculatePluginRangeForThread(un_id,
+                                                           m_vecPhysicsModelTasks.size());
+     for(size_t i = cRange.GetMin(); i < cRange.GetMax(); ++i) {
+       if(b_from_entities) {
+         UpdatePhysicsModelsFromEntities(i);
+       }
+       else {
+         UpdateEntitiesFromPhysicsModels(i);
+       }
+     }
+     pthread_testcancel();
+     THREAD_SIGNAL_PHASE_DONE(PhysicsModels);
+   } /* UpdateThreadPhysicsModels() */
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadBalanceQuantity::UpdateThreadMediaTasks(UInt32 un_id) {
+     THREAD_WAIT_FOR_GO_SIGNAL(MediaTasks);
+     /* The number of tasks changes at every step */
+     CRange<size_t> cRange = CalculatePluginRangeForThread(un_id,
+                                                           m_vecMediumTasks.size());
+     for(size_t i = cRange.GetMin(); i < cRange.GetMax(); ++i) {
+       UpdateMediumTask(i);
+     }
+     pthread_testcancel();
+     THREAD_SIGNAL_PHASE_DONE(MediaTasks);
+   } /* UpdateThreadMediaTasks() */
+
+   /****************************************/
+   /****************************************/
+
    void CSpaceMultiThreadBalanceQuantity::UpdateThreadMedia(
-       const CRange<size_t>& c_range) {
+       UInt32 un_id, const CRange<size_t>& c_range) {
      /* Update media, if this thread has been assigned to them */
      THREAD_WAIT_FOR_GO_SIGNAL(Media);
      if(c_range.GetSpan() > 0) {
        /* This thread has media, update them */
        for(size_t i = c_range.GetMin(); i < c_range.GetMax(); ++i) {
-         (*m_ptMedia)[i]->Update();
+         UpdateMedium(i);
        }
        pthread_testcancel();
        THREAD_SIGNAL_PHASE_DONE(Media);
@@ -410,57 +460,35 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   void CSpaceMultiThreadBalanceQuantity::UpdateThreadIterateOverEntities(UInt32 un_id,
-                                                                          CRange<size_t>& c_range) {
+   void CSpaceMultiThreadBalanceQuantity::UpdateThreadIterateOverEntities(UInt32 un_id) {
      THREAD_WAIT_FOR_GO_SIGNAL(EntityIter);
-     /* Calculate the portion of entities to update, if needed */
-     if (m_bIsControllableEntityAssignmentRecalculationNeeded) {
-       c_range = CalculatePluginRangeForThread(un_id,
-                                               m_vecControllableEntities.size());
-     }
-     /* Cope with the fact that there may be less entities than threads */
-     if (c_range.GetSpan() > 0 && ControllableEntityIterationEnabled()) {
-       /* This thread has entities */
-       for (size_t i = c_range.GetMin(); i < c_range.GetMax(); ++i) {
+     if (ControllableEntityIterationEnabled()) {
+       for (size_t i = un_id;
+            i < m_vecControllableEntities.size();
+            i += CSimulator::GetInstance().GetNumThreads()) {
          m_cbControllableEntityIter(m_vecControllableEntities[i]);
        } /* for(i...) */
-       pthread_testcancel();
-       THREAD_SIGNAL_PHASE_DONE(EntityIter);
-     }
-     else {
-       THREAD_SIGNAL_PHASE_DONE(EntityIter);
      }
+     pthread_testcancel();
+     THREAD_SIGNAL_PHASE_DONE(EntityIter);
    } /* UpdateThreadIterateOverEntities() */
 
    /****************************************/
    /****************************************/
 
-   void CSpaceMultiThreadBalanceQuantity::UpdateThreadEntitySenseControl(UInt32 un_id,
-                                                                         CRange<size_t>& c_range) {
+   void CSpaceMultiThreadBalanceQuantity::UpdateThreadEntitySenseControl(UInt32 un_id) {
      /* Update sensor readings and call controllers */
      THREAD_WAIT_FOR_GO_SIGNAL(SenseControlStep);
-
-     /* Calculate the portion of entities to update, if needed */
-     if (m_bIsControllableEntityAssignmentRecalculationNeeded) {
-       c_range = CalculatePluginRangeForThread(un_id,
-                                               m_vecControllableEntities.size());
-     }
-     /* Cope with the fact that there may be less entities than threads */
-     if (c_range.GetSpan() > 0) {
-       /* This thread has entities */
-       for (size_t i = c_range.GetMin(); i < c_range.GetMax(); ++i) {
-         if (m_vecControllableEntities[i]->IsEnabled()) {
-           m_vecControllableEntities[i]->Sense();
-           m_vecControllableEntities[i]->ControlStep();
-         }
+     for (size_t i = un_id;
+          i < m_vecControllableEntities.size();
+          i += CSimulator::GetInstance().GetNumThreads()) {
+       if (m_vecControllableEntities[i]->IsEnabled()) {
+         m_vecControllableEntities[i]->Sense();
+         m_vecControllableEntities[i]->ControlStep();
        }
-       pthread_testcancel();
-       THREAD_SIGNAL_PHASE_DONE(SenseControlStep);
-     }
-     else {
-       /* This thread has no entities -> dummy computation */
-       THREAD_SIGNAL_PHASE_DONE(SenseControlStep);
      }
+     pthread_testcancel();
+     THREAD_SIGNAL_PHASE_DONE(SenseControlStep);
    } /* UpdateThreadEntitySenseControl() */
 
    /****************************************/
@@ -41,6 +41,8 @@ namespace argos {
       UInt32 m_unSenseControlStepPhaseDoneCounter;
       UInt32 m_unActPhaseDoneCounter;
       UInt32 m_unPhysicsPhaseDoneCounter;
+      UInt32 m_unPhysicsModelsPhaseDoneCounter;
+      UInt32 m_unMediaTasksPhaseDoneCounter;
       UInt32 m_unMediaPhaseDoneCounter;
       UInt32 m_unEntityIterPhaseDoneCounter;
 
@@ -48,6 +50,8 @@ namespace argos {
       pthread_mutex_t m_tSenseControlStepConditionalMutex;
       pthread_mutex_t m_tActConditionalMutex;
       pthread_mutex_t m_tPhysicsConditionalMutex;
+      pthread_mutex_t m_tPhysicsModelsConditionalMutex;
+      pthread_mutex_t m_tMediaTasksConditionalMutex;
       pthread_mutex_t m_tMediaConditionalMutex;
       pthread_mutex_t m_tEntityIterConditionalMutex;
 
@@ -55,13 +59,11 @@ namespace argos {
       pthread_cond_t m_tSenseControlStepConditional;
       pthread_cond_t m_tActConditional;
       pthread_cond_t m_tPhysicsConditional;
+      pthread_cond_t m_tPhysicsModelsConditional;
+      pthread_cond_t m_tMediaTasksConditional;
       pthread_cond_t m_tMediaConditional;
       pthread_cond_t m_tEntityIterConditional;
 
-      /** Flag to know whether the assignment of controllable
-          entities to threads must be recalculated */
-      bool m_bIsControllableEntityAssignmentRecalculationNeeded;
-
    public:
 
       CSpaceMultiThreadBalanceQuantity(UInt32 un_n_threads,
@@ -78,10 +80,7 @@ namespace argos {
       virtual void IterateOverControllableEntities(
           const TControllableEntityIterCBType& c_cb);
 
-   protected:
-
-      virtual void AddControllableEntity(CControllableEntity& c_entity);
-      virtual void RemoveControllableEntity(CControllableEntity& c_entity);
+      virtual UInt32 GetThreadIndexOfNextControllableEntity() const;
 
    private:
 
@@ -89,39 +88,54 @@ namespace argos {
       void UpdateThread(UInt32 un_id);
 
      /**
-      * \brief Actuate entities assigned to this thread, possibly updating the
-      * entity range assigned to this thread before doing so.
+      * \brief Actuate entities assigned to this thread. The controllable
+      * entities are dealt to the threads in turn, so adding an entity does not
+      * change the thread of the others.
       */
-      void UpdateThreadEntityAct(UInt32 un_id, CRange<size_t>& c_range);
+      void UpdateThreadEntityAct(UInt32 un_id);
 
      /**
       * \brief Update the physics engines assigned to this thread (static
       * assignment throughout simulation).
       */
-      void UpdateThreadPhysics(const CRange<size_t>& c_range);
+      void UpdateThreadPhysics(UInt32 un_id, const CRange<size_t>& c_range);
+
+     /**
+      * \brief Update the physics models assigned to this thread, for the
+      * engines that delegate the update of their models to the space. The
+      * assignment is recalculated at every call.
+      *
+      * @param b_from_entities <tt>true</tt> to update the models from their
+      * entities, <tt>false</tt> to update the entities from their models.
+      */
+      void UpdateThreadPhysicsModels(UInt32 un_id, bool b_from_entities);
+
+     /**
+      * \brief Execute the parallel tasks of the media assigned to this
+      * thread. The assignment is recalculated at every call.
+      */
+      void UpdateThreadMediaTasks(UInt32 un_id);
 
      /**
       * \brief Update the media engines assigned to this thread (static
       * assignment throughout simulation).
       */
-     void UpdateThreadMedia(const CRange<size_t>& c_range);
+     void UpdateThreadMedia(UInt32 un_id, const CRange<size_t>& c_range);
 
      /**
       * \brief (Maybe) iterate over entities as called from
-      * CLoopFunctions::PreStep()/CLoopFunctions::PostStep(), possibly
-      * recalculating entity range assigned to this thread before doing so.
+      * CLoopFunctions::PreStep()/CLoopFunctions::PostStep().
       *
       * @see CLoopFunctions::PreStep()
       * @see CLoopFunctions::PostStep()
       */
-      void UpdateThreadIterateOverEntities(UInt32 un_id, CRange<size_t>& c_range);
+      void UpdateThreadIterateOverEntities(UInt32 un_id);
 
      /**
       * \brief Update sensor readings and call controllers assigned to a
-      * particular thread, possibly recalculating entity range assigned to this
-      * thread before doing so.
+      * particular thread.
       */
-      void UpdateThreadEntitySenseControl(UInt32 un_id, CRange<size_t>& c_range);
+      void UpdateThreadEntitySenseControl(UInt32 un_id);
 
       virtual void ControllableEntityIterationWaitAbort();
 
@@ -0,0 +1,428 @@
+/**
+ * @file <argos3/core/simulator/space/space_multi_thread_work_stealing.cpp>
+ */
+
+#include "space_multi_thread_work_stealing.h"
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/utility/profiler/profiler.h>
+#include <argos3/core/utility/math/general.h>
+#include <cstring>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   /** How many times a thread polls before parking */
+   static const UInt32 SPIN_ITERATIONS = 4096;
+
+   /** Hint to the processor that we are in a spin-wait loop */
+   static inline void CPURelax() {
+#if defined(__x86_64__) || defined(__i386__)
+      __asm__ __volatile__("pause");
+#elif defined(__aarch64__) || defined(__arm__)
+      __asm__ __volatile__("yield");
+#endif
+   }
+
+   static inline UInt64 PackRange(UInt32 un_begin, UInt32 un_end) {
+      return (static_cast<UInt64>(un_begin) << 32) | un_end;
+   }
+
+   static inline UInt32 RangeBegin(UInt64 un_range) {
+      return static_cast<UInt32>(un_range >> 32);
+   }
+
+   static inline UInt32 RangeEnd(UInt64 un_range) {
+      return static_cast<UInt32>(un_range & 0xFFFFFFFF);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   static void CleanupThread(void*) {
+      CSimulator& cSimulator = CSimulator::GetInstance();
+      if(cSimulator.IsProfiling()) {
+         cSimulator.GetProfiler().CollectThreadResourceUsage();
+      }
+   }
+
+   static void CleanupParkedThread(void* p_data) {
+      pthread_mutex_unlock(reinterpret_cast<pthread_mutex_t*>(p_data));
+   }
+
+   void* LaunchThreadWorkStealing(void* p_data) {
+      /* Set up thread-safe buffers for this new thread */
+      LOG.AddThreadSafeBuffer();
+      LOGERR.AddThreadSafeBuffer();
+      /* Make this thread cancellable */
+      pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, nullptr);
+      pthread_setcanceltype(PTHREAD_CANCEL_DEFERRED, nullptr);
+      /* Get a handle to the thread launch data */
+      auto* psData = reinterpret_cast<CSpaceMultiThreadWorkStealing::SThreadLaunchData*>(p_data);
+      pthread_cleanup_push(CleanupThread, nullptr);
+      psData->Space->SlaveThread(psData->ThreadId);
+      pthread_cleanup_pop(1);
+      return nullptr;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CSpaceMultiThreadWorkStealing::CSpaceMultiThreadWorkStealing(UInt32 un_n_threads,
+                                                                bool b_pin_threads_to_cores,
+                                                                UInt32 un_chunk_size) :
+      CSpaceMultiThread(un_n_threads, b_pin_threads_to_cores),
+      m_psThreadData(nullptr),
+      m_psTaskQueues(nullptr),
+      m_unChunkSize(un_chunk_size),
+      m_unCurrentChunkSize(1),
+      m_eCurrentPhase(PHASE_ACT),
+      m_unPhaseEpoch(0),
+      m_unPhaseDoneCounter(0),
+      m_unParkedThreads(0),
+      m_bMainParked(false) {
+      LOG << "[INFO]   Chosen method \"work_stealing\": threads will take tasks from their"
+          << std::endl
+          << "[INFO]   own queue, and steal tasks from other threads when idle."
+          << std::endl;
+      if(m_unChunkSize > 0) {
+         LOG << "[INFO]   Tasks are taken in chunks of " << m_unChunkSize << std::endl;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadWorkStealing::Init(TConfigurationNode& t_tree) {
+      /* Initialize the space */
+      CSpace::Init(t_tree);
+      /* Initialize thread related structures */
+      int nErrors;
+      /* Init mutexes */
+      if((nErrors = pthread_mutex_init(&m_tStartPhaseMutex, nullptr)) ||
+         (nErrors = pthread_mutex_init(&m_tEndPhaseMutex, nullptr))) {
+         THROW_ARGOSEXCEPTION("Error creating thread mutexes " << ::strerror(nErrors));
+      }
+      /* Init conditionals */
+      if((nErrors = pthread_cond_init(&m_tStartPhaseCond, nullptr)) ||
+         (nErrors = pthread_cond_init(&m_tEndPhaseCond, nullptr))) {
+         THROW_ARGOSEXCEPTION("Error creating thread conditionals " << ::strerror(nErrors));
+      }
+      /* Create the task queues */
+      m_psTaskQueues = new STaskQueue[GetNumThreads()];
+      /* Start threads */
+      StartThreads();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadWorkStealing::Destroy() {
+      /* Destroy the threads */
+      DestroyAllThreads();
+      /* Destroy the thread launch info */
+      if(m_psThreadData != nullptr) {
+         for(UInt32 i = 0; i < GetNumThreads(); ++i) {
+            delete m_psThreadData[i];
+         }
+      }
+      delete[] m_psThreadData;
+      delete[] m_psTaskQueues;
+      pthread_mutex_destroy(&m_tStartPhaseMutex);
+      pthread_mutex_destroy(&m_tEndPhaseMutex);
+      pthread_cond_destroy(&m_tStartPhaseCond);
+      pthread_cond_destroy(&m_tEndPhaseCond);
+      /* Destroy the base space */
+      CSpace::Destroy();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadWorkStealing::StartThreads() {
+      m_psThreadData = new SThreadLaunchData*[GetNumThreads()];
+      /* Create the threads */
+      for(UInt32 i = 0; i < GetNumThreads(); ++i) {
+         /* Create the struct with the info to launch the thread */
+         m_psThreadData[i] = new SThreadLaunchData(i, this);
+         /* Create the thread */
+         CreateSingleThread(i,
+                            LaunchThreadWorkStealing,
+                            reinterpret_cast<void*>(m_psThreadData[i]));
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadWorkStealing::UpdateControllableEntitiesAct() {
+      RunPhase(PHASE_ACT, m_vecControllableEntities.size());
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadWorkStealing::UpdatePhysics() {
+      /* Update the models whose engines delegate it to the space */
+      if(m_bParallelPhysicsModels) {
+         CalculatePhysicsModelTasks();
+         RunPhase(PHASE_PHYSICS_MODELS_FROM_ENTITIES, m_vecPhysicsModelTasks.size());
+      }
+      /* Update the physics engines */
+      RunPhase(PHASE_PHYSICS, m_ptPhysicsEngines->size());
+      /* Update the entities whose engines delegate it to the space */
+      if(m_bParallelPhysicsModels) {
+         RunPhase(PHASE_PHYSICS_MODELS_TO_ENTITIES, m_vecPhysicsModelTasks.size());
+      }
+      /* Transfer entities among engines and let the engines synchronize */
+      PostUpdatePhysics();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadWorkStealing::UpdateMedia() {
+      /* Execute the parallel tasks of the media */
+      if(m_bParallelMedia) {
+         CalculateMediumTasks();
+         RunPhase(PHASE_MEDIA_TASKS, m_vecMediumTasks.size());
+      }
+      RunPhase(PHASE_MEDIA, m_ptMedia->size());
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadWorkStealing::IterateOverControllableEntities(
+      const TControllableEntityIterCBType& c_cb) {
+      m_cbControllableEntityIter = c_cb;
+      /*
+       * The slave threads do not wait for this phase unless asked to, so
+       * there is nothing to do when iteration is disabled. This makes
+       * ControllableEntityIterationWaitAbort() unnecessary.
+       */
+      if(ControllableEntityIterationEnabled()) {
+         RunPhase(PHASE_ENTITY_ITER, m_vecControllableEntities.size());
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadWorkStealing::UpdateControllableEntitiesSenseStep() {
+      RunPhase(PHASE_SENSE_CONTROL, m_vecControllableEntities.size());
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadWorkStealing::RunPhase(EPhase e_phase,
+                                                size_t un_num_tasks) {
+      /* Nothing to do? Then don't wake up the threads */
+      if(un_num_tasks == 0) return;
+      /* Set the phase */
+      m_eCurrentPhase = e_phase;
+      /* Calculate the chunk size; by default, aim at ~8 chunks per thread */
+      if(m_unChunkSize > 0) {
+         m_unCurrentChunkSize = m_unChunkSize;
+      }
+      else {
+         m_unCurrentChunkSize = Max<UInt32>(1, un_num_tasks / (8 * GetNumThreads()));
+      }
+      /* Distribute the tasks evenly among the queues */
+      UInt32 unTasks = un_num_tasks;
+      UInt32 unMinPortion = unTasks / GetNumThreads();
+      UInt32 unExtraPortion = unTasks % GetNumThreads();
+      UInt32 unBegin = 0;
+      for(UInt32 i = 0; i < GetNumThreads(); ++i) {
+         UInt32 unEnd = unBegin + unMinPortion + (i < unExtraPortion ? 1 : 0);
+         m_psTaskQueues[i].Range.store(PackRange(unBegin, unEnd),
+                                       std::memory_order_relaxed);
+         unBegin = unEnd;
+      }
+      m_unPhaseDoneCounter.store(0, std::memory_order_relaxed);
+      /* Start the phase; this publishes all the data written above */
+      m_unPhaseEpoch.fetch_add(1, std::memory_order_seq_cst);
+      /* Wake up the parked threads, if any */
+      if(m_unParkedThreads.load(std::memory_order_seq_cst) > 0) {
+         pthread_mutex_lock(&m_tStartPhaseMutex);
+         pthread_cond_broadcast(&m_tStartPhaseCond);
+         pthread_mutex_unlock(&m_tStartPhaseMutex);
+      }
+      /* Wait for the threads to finish */
+      WaitForPhaseEnd();
+      CollectPhaseDone();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadWorkStealing::WaitForPhaseEnd() {
+      /* Spin for a while */
+      for(UInt32 i = 0; i < SPIN_ITERATIONS; ++i) {
+         if(m_unPhaseDoneCounter.load(std::memory_order_acquire) == GetNumThreads()) {
+            return;
+         }
+         CPURelax();
+      }
+      /* The phase is long, park */
+      pthread_mutex_lock(&m_tEndPhaseMutex);
+      m_bMainParked.store(true, std::memory_order_seq_cst);
+      while(m_unPhaseDoneCounter.load(std::memory_order_seq_cst) < GetNumThreads()) {
+         pthread_cond_wait(&m_tEndPhaseCond, &m_tEndPhaseMutex);
+      }
+      m_bMainParked.store(false, std::memory_order_relaxed);
+      pthread_mutex_unlock(&m_tEndPhaseMutex);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadWorkStealing::WaitForPhaseStart(UInt32 un_last_epoch) {
+      /* Spin for a while */
+      for(UInt32 i = 0; i < SPIN_ITERATIONS; ++i) {
+         if(m_unPhaseEpoch.load(std::memory_order_acquire) != un_last_epoch) {
+            return;
+         }
+         pthread_testcancel();
+         CPURelax();
+      }
+      /* The wait is long, park */
+      pthread_mutex_lock(&m_tStartPhaseMutex);
+      pthread_cleanup_push(CleanupParkedThread, &m_tStartPhaseMutex);
+      m_unParkedThreads.fetch_add(1, std::memory_order_seq_cst);
+      while(m_unPhaseEpoch.load(std::memory_order_seq_cst) == un_last_epoch) {
+         pthread_cond_wait(&m_tStartPhaseCond, &m_tStartPhaseMutex);
+      }
+      m_unParkedThreads.fetch_sub(1, std::memory_order_relaxed);
+      pthread_cleanup_pop(1);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CSpaceMultiThreadWorkStealing::PopChunk(UInt32 un_id,
+                                                UInt32& un_begin,
+                                                UInt32& un_end) {
+      std::atomic<UInt64>& cRange = m_psTaskQueues[un_id].Range;
+      UInt64 unCur = cRange.load(std::memory_order_acquire);
+      UInt32 unNewBegin;
+      do {
+         un_begin = RangeBegin(unCur);
+         un_end = RangeEnd(unCur);
+         if(un_begin >= un_end) return false;
+         unNewBegin = Min<UInt32>(un_begin + m_unCurrentChunkSize, un_end);
+      }
+      while(!cRange.compare_exchange_weak(unCur,
+                                          PackRange(unNewBegin, un_end),
+                                          std::memory_order_acq_rel,
+                                          std::memory_order_acquire));
+      un_end = unNewBegin;
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CSpaceMultiThreadWorkStealing::Steal(UInt32 un_id) {
+      for(UInt32 i = 1; i < GetNumThreads(); ++i) {
+         std::atomic<UInt64>& cVictim = m_psTaskQueues[(un_id + i) % GetNumThreads()].Range;
+         UInt64 unCur = cVictim.load(std::memory_order_acquire);
+         UInt32 unBegin, unEnd, unSplit;
+         do {
+            unBegin = RangeBegin(unCur);
+            unEnd = RangeEnd(unCur);
+            if(unBegin >= unEnd) break;
+            /* Take the back half, rounding up */
+            unSplit = unBegin + (unEnd - unBegin) / 2;
+         }
+         while(!cVictim.compare_exchange_weak(unCur,
+                                              PackRange(unBegin, unSplit),
+                                              std::memory_order_acq_rel,
+                                              std::memory_order_acquire));
+         if(unBegin < unEnd) {
+            /*
+             * Our queue is empty, so nobody else can modify it: just
+             * store the stolen range, which becomes stealable in turn
+             */
+            m_psTaskQueues[un_id].Range.store(PackRange(unSplit, unEnd),
+                                              std::memory_order_release);
+            return true;
+         }
+      }
+      return false;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadWorkStealing::ExecuteTask(size_t un_task) {
+      switch(m_eCurrentPhase) {
+         case PHASE_ACT:
+            if(m_vecControllableEntities[un_task]->IsEnabled())
+               m_vecControllableEntities[un_task]->Act();
+            break;
+         case PHASE_PHYSICS_MODELS_FROM_ENTITIES:
+            UpdatePhysicsModelsFromEntities(un_task);
+            break;
+         case PHASE_PHYSICS:
+            UpdatePhysicsEngine(un_task);
+            break;
+         case PHASE_PHYSICS_MODELS_TO_ENTITIES:
+            UpdateEntitiesFromPhysicsModels(un_task);
+            break;
+         case PHASE_MEDIA_TASKS:
+            UpdateMediumTask(un_task);
+            break;
+         case PHASE_MEDIA:
+            UpdateMedium(un_task);
+            break;
+         case PHASE_ENTITY_ITER:
+            m_cbControllableEntityIter(m_vecControllableEntities[un_task]);
+            break;
+         case PHASE_SENSE_CONTROL:
+            if(m_vecControllableEntities[un_task]->IsEnabled()) {
+               m_vecControllableEntities[un_task]->Sense();
+               m_vecControllableEntities[un_task]->ControlStep();
+            }
+            break;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadWorkStealing::SlaveThread(UInt32 un_id) {
+      SetThreadIndex(un_id);
+      UInt32 unEpoch = 0;
+      UInt32 unBegin, unEnd;
+      while(1) {
+         /* Wait for the next phase */
+         WaitForPhaseStart(unEpoch);
+         unEpoch = m_unPhaseEpoch.load(std::memory_order_acquire);
+         /* Consume own queue, then steal until there's nothing left */
+         do {
+            while(PopChunk(un_id, unBegin, unEnd)) {
+               for(UInt32 i = unBegin; i < unEnd; ++i) {
+                  ExecuteTask(i);
+               }
+            }
+         }
+         while(Steal(un_id));
+         /* Signal the end of the phase */
+         CollectThreadPhaseDone(un_id);
+         if(m_unPhaseDoneCounter.fetch_add(1, std::memory_order_seq_cst) + 1 == GetNumThreads() &&
+            m_bMainParked.load(std::memory_order_seq_cst)) {
+            pthread_mutex_lock(&m_tEndPhaseMutex);
+            pthread_cond_signal(&m_tEndPhaseCond);
+            pthread_mutex_unlock(&m_tEndPhaseMutex);
+         }
+         pthread_testcancel();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
@@ -0,0 +1,194 @@
+/**
+ * @file <argos3/core/simulator/space/space_multi_thread_work_stealing.h>
+ *
+ * @brief This file provides the definition of a multi-threaded space
+ * that dispatches tasks through per-thread work-stealing queues.
+ */
+
+#ifndef SPACE_MULTI_THREAD_WORK_STEALING_H
+#define SPACE_MULTI_THREAD_WORK_STEALING_H
+
+namespace argos {
+   class CSpace;
+}
+
+#include <argos3/core/simulator/space/space_multi_thread.h>
+#include <atomic>
+#include <pthread.h>
+
+namespace argos {
+
+   /**
+    * A multi-threaded space that dispatches tasks without locks.
+    * <p>
+    * At the beginning of each phase, the tasks (controllable entities,
+    * physics engines, or media) are split evenly in contiguous ranges,
+    * one per thread. Each thread consumes its own range in chunks from
+    * the front; when its range is exhausted, it steals half of the
+    * remaining range of another thread from the back. Both operations
+    * are a single compare-and-swap on a packed 64-bit word.
+    * </p>
+    * <p>
+    * Between phases, threads spin for a short while waiting for the next
+    * phase to start, and park on a condition variable only if the wait
+    * becomes long. The main thread waits for the end of a phase in the
+    * same way. As the slave threads execute whatever phase the main
+    * thread dispatches, the phase ordering of CSpace::Update() is
+    * preserved, and phases with no tasks are skipped altogether.
+    * </p>
+    */
+   class CSpaceMultiThreadWorkStealing : public CSpaceMultiThread {
+
+   public:
+
+      /**
+       * Class constructor.
+       * @param un_n_threads The number of slave threads.
+       * @param b_pin_threads_to_cores Whether to pin the threads to cores.
+       * @param un_chunk_size The number of tasks a thread takes from its queue
+       * at once. If 0, the chunk size is computed automatically at each phase.
+       */
+      CSpaceMultiThreadWorkStealing(UInt32 un_n_threads,
+                                    bool b_pin_threads_to_cores,
+                                    UInt32 un_chunk_size = 0);
+      virtual ~CSpaceMultiThreadWorkStealing() {}
+
+      virtual void Init(TConfigurationNode& t_tree);
+      virtual void Destroy();
+
+      virtual void UpdateControllableEntitiesAct();
+      virtual void UpdatePhysics();
+      virtual void UpdateMedia();
+      virtual void UpdateControllableEntitiesSenseStep();
+      virtual void IterateOverControllableEntities(
+          const TControllableEntityIterCBType& c_cb);
+
+      /* the threads pick the controllable entities as they become idle */
+      virtual bool HasStaticControllableEntityAssignment() const {
+         return false;
+      }
+
+   private:
+
+      /** The phases the slave threads can be asked to perform */
+      enum EPhase {
+         PHASE_ACT = 0,
+         PHASE_PHYSICS_MODELS_FROM_ENTITIES,
+         PHASE_PHYSICS,
+         PHASE_PHYSICS_MODELS_TO_ENTITIES,
+         PHASE_MEDIA_TASKS,
+         PHASE_MEDIA,
+         PHASE_ENTITY_ITER,
+         PHASE_SENSE_CONTROL
+      };
+
+      /**
+       * The task queue of a thread.
+       * The queue is a range of task indices [begin,end), packed in a single
+       * 64-bit word as (begin << 32 | end). The owner pops chunks from the
+       * front, thieves steal from the back. The structure is aligned to a
+       * cache line to avoid false sharing between threads.
+       */
+      struct alignas(64) STaskQueue {
+         std::atomic<UInt64> Range;
+
+         STaskQueue() : Range(0) {}
+      };
+
+      /** Thread data */
+      struct SThreadLaunchData {
+         UInt32 ThreadId;
+         CSpaceMultiThreadWorkStealing* Space;
+
+         SThreadLaunchData(UInt32 un_thread_id,
+                           CSpaceMultiThreadWorkStealing* pc_space) :
+            ThreadId(un_thread_id),
+            Space(pc_space) {}
+      };
+
+   private:
+
+      void StartThreads();
+      void SlaveThread(UInt32 un_id);
+      friend void* LaunchThreadWorkStealing(void* p_data);
+
+      /**
+       * Executes a phase on the slave threads and waits for its end.
+       * @param e_phase The phase to execute.
+       * @param un_num_tasks The number of tasks in the phase.
+       */
+      void RunPhase(EPhase e_phase, size_t un_num_tasks);
+
+      /**
+       * Executes a task of the current phase.
+       * @param un_task The index of the task.
+       */
+      void ExecuteTask(size_t un_task);
+
+      /**
+       * Pops a chunk of tasks from the front of the queue of the given thread.
+       * @return <tt>false</tt> if the queue is empty.
+       */
+      bool PopChunk(UInt32 un_id, UInt32& un_begin, UInt32& un_end);
+
+      /**
+       * Steals half of the remaining tasks of another thread and moves them
+       * into the queue of the given thread.
+       * @return <tt>false</tt> if no work could be stolen.
+       */
+      bool Steal(UInt32 un_id);
+
+      /**
+       * Waits until the main thread starts a new phase.
+       * @param un_last_epoch The epoch of the last phase executed by the thread.
+       */
+      void WaitForPhaseStart(UInt32 un_last_epoch);
+
+      /**
+       * Waits until all the slave threads have finished the current phase.
+       */
+      void WaitForPhaseEnd();
+
+   private:
+
+      /** Data structure needed to launch the threads */
+      SThreadLaunchData** m_psThreadData;
+
+      /** The task queues, one per thread */
+      STaskQueue* m_psTaskQueues;
+
+      /** The chunk size set by the user (0 means automatic) */
+      UInt32 m_unChunkSize;
+
+      /** The chunk size used in the current phase */
+      UInt32 m_unCurrentChunkSize;
+
+      /** The current phase */
+      EPhase m_eCurrentPhase;
+
+      /** The phase counter, increased by the main thread to start a phase */
+      std::atomic<UInt32> m_unPhaseEpoch;
+
+      /** How many threads have finished the current phase */
+      std::atomic<UInt32> m_unPhaseDoneCounter;
+
+      /** How many slave threads are parked waiting for a phase to start */
+      std::atomic<UInt32> m_unParkedThreads;
+
+      /** Whether the main thread is parked waiting for a phase to end */
+      std::atomic<bool> m_bMainParked;
+
+      /** Mutex for the parked slave threads */
+      pthread_mutex_t m_tStartPhaseMutex;
+      /** Conditional for the parked slave threads */
+      pthread_cond_t m_tStartPhaseCond;
+      /** Mutex for the parked main thread */
+      pthread_mutex_t m_tEndPhaseMutex;
+      /** Conditional for the parked main thread */
+      pthread_cond_t m_tEndPhaseCond;
+
+   };
+
+}
+
+#endif
@@ -34,16 +34,24 @@ namespace argos {
    /****************************************/
 
    void CSpaceNoThreads::UpdatePhysics() {
+      /* Update the models whose engines delegate it to the space */
+      if(m_bParallelPhysicsModels) {
+         CalculatePhysicsModelTasks();
+         for(size_t i = 0; i < m_vecPhysicsModelTasks.size(); ++i) {
+            UpdatePhysicsModelsFromEntities(i);
+         }
+      }
       /* Update the physics engines */
       for(size_t i = 0; i < m_ptPhysicsEngines->size(); ++i) {
-         (*m_ptPhysicsEngines)[i]->Update();
+         UpdatePhysicsEngine(i);
       }
-      /* Perform entity transfer from engine to engine, if needed */
-      for(size_t i = 0; i < m_ptPhysicsEngines->size(); ++i) {
-         if((*m_ptPhysicsEngines)[i]->IsEntityTransferNeeded()) {
-            (*m_ptPhysicsEngines)[i]->TransferEntities();
+      if(m_bParallelPhysicsModels) {
+         for(size_t i = 0; i < m_vecPhysicsModelTasks.size(); ++i) {
+            UpdateEntitiesFromPhysicsModels(i);
          }
       }
+      /* Transfer entities among engines and let the engines synchronize */
+      PostUpdatePhysics();
    }
 
    /****************************************/
@@ -51,7 +59,7 @@ namespace argos {
 
    void CSpaceNoThreads::UpdateMedia() {
       for(size_t i = 0; i < m_ptMedia->size(); ++i) {
-         (*m_ptMedia)[i]->Update();
+         UpdateMedium(i);
       }
    }
 
@@ -0,0 +1,85 @@
+/**
+ * @file <argos3/core/simulator/trajectory_dump_main.cpp>
+ */
+
+#include <argos3/core/simulator/recorder/trajectory_reader.h>
+#include <argos3/core/utility/logging/argos_log.h>
+#include <iostream>
+
+using namespace argos;
+
+/**
+ * @brief Prints a trajectory file as a tab-separated table.
+ *
+ * Without channel names, the program prints the content of the header.
+ * Otherwise, it prints a line per recorded step and per entity, with the
+ * simulation clock, the entity id and the values of the given channels.
+ *
+ * @param n_argc the number of command line arguments given at the shell.
+ * @param ppch_argv the trajectory file, followed by the channel names.
+ * @return 0 if everything OK; 1 in case of errors.
+ */
+int main(int n_argc, char** ppch_argv) {
+   if(n_argc < 2) {
+      LOGERR << "Usage: " << ppch_argv[0] << " FILE [CHANNEL ...]" << std::endl;
+      LOGERR.Flush();
+      return 1;
+   }
+   /* The output is meant to be parsed: no escape sequences */
+   LOG.DisableColoredOutput();
+   LOGERR.DisableColoredOutput();
+   try {
+      CTrajectoryReader cReader;
+      cReader.Open(ppch_argv[1]);
+      if(n_argc == 2) {
+         std::cout << "steps\t" << cReader.GetNumSteps() << std::endl
+                   << "step_length\t" << cReader.GetStepLength() << std::endl
+                   << "period\t" << cReader.GetPeriod() << std::endl;
+         for(size_t e = 0; e < cReader.GetNumEntities(); ++e) {
+            std::cout << "entity\t" << cReader.GetEntityId(e)
+                      << '\t' << cReader.GetEntityType(e) << std::endl;
+         }
+         for(size_t c = 0; c < cReader.GetNumChannels(); ++c) {
+            const CTrajectoryReader::SChannel& sChannel = cReader.GetChannel(c);
+            std::cout << "channel\t" << sChannel.Name
+                      << '\t' << (sChannel.ValueType == TRAJECTORY_FLOAT32 ? "float32" : "uint32")
+                      << '\t' << sChannel.RowSize << std::endl;
+         }
+         return 0;
+      }
+      std::vector<size_t> vecChannels;
+      for(int i = 2; i < n_argc; ++i) {
+         vecChannels.push_back(cReader.GetChannelIndex(ppch_argv[i]));
+      }
+      for(size_t s = 0; s < cReader.GetNumSteps(); ++s) {
+         UInt32 unClock = cReader.GetClock(s);
+         for(size_t e = 0; e < cReader.GetNumEntities(); ++e) {
+            std::cout << unClock << '\t' << cReader.GetEntityId(e);
+            for(size_t c = 0; c < vecChannels.size(); ++c) {
+               size_t unChannel = vecChannels[c];
+               UInt32 unNumValues = cReader.GetNumValues(unChannel, e);
+               if(cReader.GetChannel(unChannel).ValueType == TRAJECTORY_FLOAT32) {
+                  const float* pfValues = cReader.GetFloats(unChannel, s, e);
+                  for(UInt32 v = 0; v < unNumValues; ++v) {
+                     std::cout << '\t' << pfValues[v];
+                  }
+               }
+               else {
+                  const UInt32* punValues = cReader.GetUInt32s(unChannel, s, e);
+                  for(UInt32 v = 0; v < unNumValues; ++v) {
+                     std::cout << '\t' << punValues[v];
+                  }
+               }
+            }
+            std::cout << '\n';
+         }
+      }
+      std::cout.flush();
+   }
+   catch(std::exception& ex) {
+      LOGERR << ex.what() << std::endl;
+      LOGERR.Flush();
+      return 1;
+   }
+   return 0;
+}
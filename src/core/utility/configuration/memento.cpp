@@ -0,0 +1,81 @@
+/**
+ * @file <argos3/core/utility/configuration/memento.cpp>
+ */
+
+#include "memento.h"
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   void AddMementoBlock(CByteArray& c_buffer,
+                        const CByteArray& c_block) {
+      c_buffer << static_cast<UInt32>(c_block.Size());
+      if(!c_block.Empty()) {
+         c_buffer.AddBuffer(c_block.ToCArray(), c_block.Size());
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void SaveMementoBlock(CByteArray& c_buffer,
+                         CMemento& c_memento) {
+      CByteArray cBlock;
+      c_memento.SaveState(cBlock);
+      AddMementoBlock(c_buffer, cBlock);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CMementoBlockReader::NextBlock(CByteArray& c_block) {
+      /* Read the size of the block */
+      if(m_unOffset + sizeof(UInt32) > m_cBuffer.Size()) {
+         THROW_ARGOSEXCEPTION("Attempting to read a state block beyond the end of the buffer");
+      }
+      CByteArray cSize(m_cBuffer.ToCArray() + m_unOffset, sizeof(UInt32));
+      UInt32 unSize;
+      cSize >> unSize;
+      m_unOffset += sizeof(UInt32);
+      /* Copy the block */
+      if(m_unOffset + unSize > m_cBuffer.Size()) {
+         THROW_ARGOSEXCEPTION("State block of " << unSize << " bytes exceeds the buffer ("
+                              << (m_cBuffer.Size() - m_unOffset) << " bytes available)");
+      }
+      c_block.Clear();
+      if(unSize > 0) {
+         c_block.AddBuffer(m_cBuffer.ToCArray() + m_unOffset, unSize);
+      }
+      m_unOffset += unSize;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CMementoBlockReader::LoadNextBlock(CMemento& c_memento) {
+      CByteArray cBlock;
+      NextBlock(cBlock);
+      c_memento.LoadState(cBlock);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CMementoBlockReader::Finish() {
+      if(m_unOffset >= m_cBuffer.Size()) {
+         m_cBuffer.Clear();
+      }
+      else if(m_unOffset > 0) {
+         CByteArray cRest(m_cBuffer.ToCArray() + m_unOffset,
+                          m_cBuffer.Size() - m_unOffset);
+         m_cBuffer.Swap(cRest);
+      }
+      m_unOffset = 0;
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
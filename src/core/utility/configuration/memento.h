@@ -15,9 +15,14 @@
 
 namespace argos {
    class CMemento;
+   class CMementoBlockReader;
 }
 
 #include <argos3/core/utility/datatypes/byte_array.h>
+#include <argos3/core/utility/datatypes/color.h>
+#include <argos3/core/utility/math/angles.h>
+#include <argos3/core/utility/math/vector3.h>
+#include <argos3/core/utility/math/quaternion.h>
 
 namespace argos {
 
@@ -49,6 +54,129 @@ namespace argos {
 
    };
 
+   /****************************************/
+   /****************************************/
+
+   /**
+    * Appends a block to the given buffer.
+    * The block is preceded by its size, so that it can be read back with a CMementoBlockReader.
+    * @param c_buffer the target buffer
+    * @param c_block the block to append
+    * @see CMementoBlockReader
+    */
+   void AddMementoBlock(CByteArray& c_buffer,
+                        const CByteArray& c_block);
+
+   /**
+    * Saves the state of an object to the given buffer as a block.
+    * @param c_buffer the target buffer
+    * @param c_memento the object whose state must be saved
+    * @see CMementoBlockReader
+    */
+   void SaveMementoBlock(CByteArray& c_buffer,
+                         CMemento& c_memento);
+
+   /**
+    * Reads the blocks written by AddMementoBlock() and SaveMementoBlock().
+    * <p>
+    * Reading data from a CByteArray removes it from the front of the array,
+    * which costs as much as the data that follows. When the state of many
+    * objects is stored in the same buffer, restoring them one after the other
+    * would take quadratic time. This class, instead, walks the buffer and
+    * copies each block into a small array of its own. The blocks read so far
+    * are removed from the buffer in one go by Finish().
+    * </p>
+    * @see AddMementoBlock()
+    * @see SaveMementoBlock()
+    */
+   class CMementoBlockReader {
+
+   public:
+
+      /**
+       * Class constructor.
+       * @param c_buffer the buffer whose first bytes are blocks
+       */
+      CMementoBlockReader(CByteArray& c_buffer) :
+         m_cBuffer(c_buffer),
+         m_unOffset(0) {}
+
+      /**
+       * Reads the next block.
+       * @param c_block the array to store the block into
+       * @throws CARGoSException if the buffer holds no complete block
+       */
+      void NextBlock(CByteArray& c_block);
+
+      /**
+       * Restores the state of an object from the next block.
+       * @param c_memento the object whose state must be restored
+       * @throws CARGoSException if the buffer holds no complete block
+       */
+      void LoadNextBlock(CMemento& c_memento);
+
+      /**
+       * Removes the blocks read so far from the buffer.
+       */
+      void Finish();
+
+   private:
+
+      CByteArray& m_cBuffer;
+      size_t m_unOffset;
+
+   };
+
+   /****************************************/
+   /****************************************/
+
+   /**
+    * Serialization of the common math and datatypes, used to save and restore states.
+    */
+   inline CByteArray& operator<<(CByteArray& c_buffer, const CRadians& c_angle) {
+      return c_buffer << c_angle.GetValue();
+   }
+
+   inline CByteArray& operator>>(CByteArray& c_buffer, CRadians& c_angle) {
+      Real fValue;
+      c_buffer >> fValue;
+      c_angle.SetValue(fValue);
+      return c_buffer;
+   }
+
+   inline CByteArray& operator<<(CByteArray& c_buffer, const CVector3& c_vector) {
+      return c_buffer << c_vector.GetX() << c_vector.GetY() << c_vector.GetZ();
+   }
+
+   inline CByteArray& operator>>(CByteArray& c_buffer, CVector3& c_vector) {
+      Real fX, fY, fZ;
+      c_buffer >> fX >> fY >> fZ;
+      c_vector.Set(fX, fY, fZ);
+      return c_buffer;
+   }
+
+   inline CByteArray& operator<<(CByteArray& c_buffer, const CQuaternion& c_quaternion) {
+      return c_buffer << c_quaternion.GetW() << c_quaternion.GetX() << c_quaternion.GetY() << c_quaternion.GetZ();
+   }
+
+   inline CByteArray& operator>>(CByteArray& c_buffer, CQuaternion& c_quaternion) {
+      Real fW, fX, fY, fZ;
+      c_buffer >> fW >> fX >> fY >> fZ;
+      c_quaternion.Set(fW, fX, fY, fZ);
+      return c_buffer;
+   }
+
+   inline CByteArray& operator<<(CByteArray& c_buffer, const CColor& c_color) {
+      return c_buffer << c_color.GetRed() << c_color.GetGreen() << c_color.GetBlue() << c_color.GetAlpha();
+   }
+
+   inline CByteArray& operator>>(CByteArray& c_buffer, CColor& c_color) {
+      UInt8 unRed, unGreen, unBlue, unAlpha;
+      c_buffer >> unRed >> unGreen >> unBlue >> unAlpha;
+      c_color.Set(unRed, unGreen, unBlue, unAlpha);
+      return c_buffer;
+   }
+
 }
 
 #endif
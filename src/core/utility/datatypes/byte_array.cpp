@@ -95,6 +95,17 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   CByteArray& CByteArray::operator=(CByteArray&& c_byte_array) noexcept {
+      if(this != &c_byte_array) {
+         m_vecBuffer = std::move(c_byte_array.m_vecBuffer);
+         c_byte_array.m_vecBuffer.clear();
+      }
+      return *this;
+   }
+
+   /****************************************/
+   /****************************************/
+
    bool CByteArray::operator==(const CByteArray& c_byte_array) const {
       return m_vecBuffer == c_byte_array.m_vecBuffer;
    }
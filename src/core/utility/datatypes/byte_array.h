@@ -40,6 +40,14 @@ namespace argos {
       CByteArray(const CByteArray& c_byte_array) :
          m_vecBuffer(c_byte_array.m_vecBuffer) {}
 
+      /**
+       * Class move constructor.
+       * The given byte array is left empty. The constructor does not throw,
+       * so containers of byte arrays move them when they grow.
+       */
+      CByteArray(CByteArray&& c_byte_array) noexcept :
+         m_vecBuffer(std::move(c_byte_array.m_vecBuffer)) {}
+
       /**
        * Class constructor.
        * Copies the given buffer into the byte array. The original
@@ -148,6 +156,12 @@ namespace argos {
        */
       CByteArray& operator=(const CByteArray& c_byte_array);
 
+      /**
+       * Move assignment operator.
+       * Takes over the contents of the given byte array, which is left empty.
+       */
+      CByteArray& operator=(CByteArray&& c_byte_array) noexcept;
+
       /**
        * Read/write index operator.
        * @param un_index the index of the wanted element.
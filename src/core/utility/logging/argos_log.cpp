@@ -12,4 +12,203 @@ namespace argos {
    CARGoSLog LOG(std::cout, SLogColor(ARGOS_LOG_ATTRIBUTE_BRIGHT, ARGOS_LOG_COLOR_GREEN));
    CARGoSLog LOGERR(std::cerr, SLogColor(ARGOS_LOG_ATTRIBUTE_BRIGHT, ARGOS_LOG_COLOR_RED));
 
+   /****************************************/
+   /****************************************/
+
+#ifdef ARGOS_THREADSAFE_LOG
+   thread_local std::vector<std::ostringstream*>* CARGoSLog::m_pvecThreadStreams = nullptr;
+
+   /* The number of logs created so far, used to index the per-thread stream table */
+   static size_t LOG_COUNT = 0;
+
+   /* Deletes the per-thread stream table when its thread exits */
+   static pthread_key_t THREAD_STREAMS_KEY;
+   static pthread_once_t THREAD_STREAMS_KEY_ONCE = PTHREAD_ONCE_INIT;
+
+   static void DeleteThreadStreams(void* pt_streams) {
+      delete reinterpret_cast<std::vector<std::ostringstream*>*>(pt_streams);
+   }
+
+   static void CreateThreadStreamsKey() {
+      pthread_key_create(&THREAD_STREAMS_KEY, &DeleteThreadStreams);
+   }
+#endif
+
+   /****************************************/
+   /****************************************/
+
+   CARGoSLog::CARGoSLog(std::ostream& c_stream,
+                        const SLogColor& s_log_color,
+                        bool b_colored_output_enabled) :
+      m_cStream(c_stream),
+      m_sLogColor(s_log_color),
+      m_bColoredOutput(b_colored_output_enabled),
+      m_bEnabled(true),
+      m_unSamplingPeriod(1),
+      m_bActive(true) {
+#ifdef ARGOS_THREADSAFE_LOG
+      m_unIndex = LOG_COUNT++;
+      m_bAsyncWriter = false;
+      m_bStopWriter = false;
+      pthread_mutex_init(&m_tMutex, NULL);
+      pthread_cond_init(&m_tWriterCond, NULL);
+      AddThreadSafeBuffer();
+#endif
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CARGoSLog::~CARGoSLog() {
+#ifdef ARGOS_THREADSAFE_LOG
+      DisableAsyncWriter();
+      pthread_cond_destroy(&m_tWriterCond);
+      pthread_mutex_destroy(&m_tMutex);
+      while(!m_vecStreams.empty()) {
+         delete m_vecStreams.back();
+         m_vecStreams.pop_back();
+      }
+#endif
+      if(m_bColoredOutput) {
+         reset(m_cStream);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CARGoSLog::SetSamplingPeriod(size_t un_period) {
+      m_unSamplingPeriod = (un_period > 0) ? un_period : 1;
+   }
+
+   /****************************************/
+   /****************************************/
+
+#ifdef ARGOS_THREADSAFE_LOG
+
+   void CARGoSLog::Flush() {
+      pthread_mutex_lock(&m_tMutex);
+      if(m_bAsyncWriter) {
+         MergeStreams(m_strPending);
+         if(!m_strPending.empty()) {
+            pthread_cond_signal(&m_tWriterCond);
+         }
+      }
+      else {
+         for(size_t i = 0; i < m_vecStreams.size(); ++i) {
+            if(m_vecStreams[i]->tellp() > 0) {
+               m_cStream << m_vecStreams[i]->str();
+               m_vecStreams[i]->str("");
+            }
+         }
+      }
+      pthread_mutex_unlock(&m_tMutex);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CARGoSLog::AddThreadSafeBuffer() {
+      if(m_pvecThreadStreams == nullptr ||
+         m_unIndex >= m_pvecThreadStreams->size() ||
+         (*m_pvecThreadStreams)[m_unIndex] == nullptr) {
+         AddThreadStream();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CARGoSLog::EnableAsyncWriter() {
+      if(m_bAsyncWriter) return;
+      /* Write what was buffered so far, to keep the output ordered */
+      Flush();
+      pthread_mutex_lock(&m_tMutex);
+      m_bStopWriter = false;
+      if(pthread_create(&m_tWriterThread, NULL, &WriterThread, this) == 0) {
+         m_bAsyncWriter = true;
+      }
+      pthread_mutex_unlock(&m_tMutex);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CARGoSLog::DisableAsyncWriter() {
+      if(!m_bAsyncWriter) return;
+      /* Hand the last buffered output to the writer thread */
+      Flush();
+      pthread_mutex_lock(&m_tMutex);
+      m_bStopWriter = true;
+      pthread_cond_signal(&m_tWriterCond);
+      pthread_mutex_unlock(&m_tMutex);
+      /* The writer thread writes the pending output before terminating */
+      pthread_join(m_tWriterThread, NULL);
+      m_bAsyncWriter = false;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   std::ostringstream& CARGoSLog::AddThreadStream() {
+      std::ostringstream* pcStream = new std::ostringstream;
+      pthread_mutex_lock(&m_tMutex);
+      m_vecStreams.push_back(pcStream);
+      pthread_mutex_unlock(&m_tMutex);
+      if(m_pvecThreadStreams == nullptr) {
+         m_pvecThreadStreams = new std::vector<std::ostringstream*>;
+         pthread_once(&THREAD_STREAMS_KEY_ONCE, &CreateThreadStreamsKey);
+         pthread_setspecific(THREAD_STREAMS_KEY, m_pvecThreadStreams);
+      }
+      if(m_unIndex >= m_pvecThreadStreams->size()) {
+         m_pvecThreadStreams->resize(m_unIndex + 1, nullptr);
+      }
+      (*m_pvecThreadStreams)[m_unIndex] = pcStream;
+      return *pcStream;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CARGoSLog::MergeStreams(std::string& str_output) {
+      for(size_t i = 0; i < m_vecStreams.size(); ++i) {
+         if(m_vecStreams[i]->tellp() > 0) {
+            str_output += m_vecStreams[i]->str();
+            m_vecStreams[i]->str("");
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void* CARGoSLog::WriterThread(void* pt_log) {
+      CARGoSLog& cLog = *reinterpret_cast<CARGoSLog*>(pt_log);
+      std::string strOutput;
+      pthread_mutex_lock(&cLog.m_tMutex);
+      while(true) {
+         while(cLog.m_strPending.empty() && !cLog.m_bStopWriter) {
+            pthread_cond_wait(&cLog.m_tWriterCond, &cLog.m_tMutex);
+         }
+         if(cLog.m_strPending.empty()) {
+            /* Stop requested and nothing left to write */
+            break;
+         }
+         /* Take the pending output and write it without holding the lock */
+         strOutput.swap(cLog.m_strPending);
+         pthread_mutex_unlock(&cLog.m_tMutex);
+         cLog.m_cStream << strOutput;
+         cLog.m_cStream.flush();
+         strOutput.clear();
+         pthread_mutex_lock(&cLog.m_tMutex);
+      }
+      pthread_mutex_unlock(&cLog.m_tMutex);
+      return NULL;
+   }
+
+#endif
+
+   /****************************************/
+   /****************************************/
+
 }
@@ -28,7 +28,6 @@
 #ifdef ARGOS_THREADSAFE_LOG
 #include <pthread.h>
 #include <sstream>
-#include <map>
 #include <vector>
 #endif
 
@@ -69,43 +68,56 @@ namespace argos {
       /** True when we want to use color */
       bool m_bColoredOutput;
 
+      /** True when the log is enabled */
+      bool m_bEnabled;
+
+      /** The log keeps the messages of one tick every this many */
+      size_t m_unSamplingPeriod;
+
+      /** True when the messages of the current tick are kept */
+      bool m_bActive;
+
 #ifdef ARGOS_THREADSAFE_LOG
-      /** Maps a thread to its visualization order */
-      std::map<pthread_t, size_t> m_mapStreamOrder;
+      /** The index of this log in the per-thread stream table */
+      size_t m_unIndex;
 
-      /** Contains the buffer streams */
-      std::vector<std::stringstream*> m_vecStreams;
+      /** The buffer streams, in the order in which the threads registered */
+      std::vector<std::ostringstream*> m_vecStreams;
 
       /** The mutex to protect the operations on the buffers */
       pthread_mutex_t m_tMutex;
+
+      /** True when the buffers are written by the writer thread */
+      bool m_bAsyncWriter;
+
+      /** True when the writer thread must terminate */
+      bool m_bStopWriter;
+
+      /** The writer thread */
+      pthread_t m_tWriterThread;
+
+      /** Signals the writer thread that there is output to write */
+      pthread_cond_t m_tWriterCond;
+
+      /** Output merged by Flush() and waiting for the writer thread */
+      std::string m_strPending;
+
+      /**
+       * The buffer streams of the calling thread, indexed by log.
+       * This way, a thread finds its buffer without any lookup or locking.
+       * It is a plain pointer, so it stays valid while the static objects
+       * are destroyed; the table is deleted when its thread exits.
+       */
+      static thread_local std::vector<std::ostringstream*>* m_pvecThreadStreams;
 #endif
 
    public:
 
       CARGoSLog(std::ostream& c_stream,
                 const SLogColor& s_log_color,
-                bool b_colored_output_enabled = true) :
-         m_cStream(c_stream),
-         m_sLogColor(s_log_color),
-         m_bColoredOutput(b_colored_output_enabled) {
-#ifdef ARGOS_THREADSAFE_LOG
-         pthread_mutex_init(&m_tMutex, NULL);
-         AddThreadSafeBuffer();
-#endif
-      }
+                bool b_colored_output_enabled = true);
 
-      ~CARGoSLog() {
-#ifdef ARGOS_THREADSAFE_LOG
-         pthread_mutex_destroy(&m_tMutex);
-         while(!m_vecStreams.empty()) {
-            delete m_vecStreams.back();
-            m_vecStreams.pop_back();
-         }
-#endif
-         if(m_bColoredOutput) {
-            reset(m_cStream);
-         }
-      }
+      ~CARGoSLog();
 
       inline void EnableColoredOutput() {
          m_bColoredOutput = true;
@@ -127,52 +139,135 @@ namespace argos {
          m_cStream.rdbuf(std::ofstream(str_fname.c_str(), std::ios::out | std::ios::trunc).rdbuf());
       }
 
-#ifdef ARGOS_THREADSAFE_LOG
-      inline void Flush() {
-         pthread_mutex_lock(&m_tMutex);
-         for(size_t i = 0; i < m_vecStreams.size(); ++i) {
-            m_cStream << m_vecStreams[i]->str();
-            m_vecStreams[i]->str("");
-         }
-         pthread_mutex_unlock(&m_tMutex);
+      /**
+       * Enables or disables the log.
+       * The messages sent to a disabled log are discarded without being formatted.
+       */
+      inline void SetEnabled(bool b_enabled) {
+         m_bEnabled = b_enabled;
+         m_bActive = b_enabled;
+      }
+
+      inline bool IsEnabled() const {
+         return m_bEnabled;
+      }
+
+      /**
+       * Sets the sampling period of the log.
+       * Only the messages of one tick every <tt>un_period</tt> are kept; 1 keeps them all.
+       * @see SetTick()
+       */
+      void SetSamplingPeriod(size_t un_period);
+
+      inline size_t GetSamplingPeriod() const {
+         return m_unSamplingPeriod;
+      }
+
+      /**
+       * Tells the log that a new tick has started.
+       * Called by the space at each step, before the controllers run.
+       * @see EndTick()
+       */
+      inline void SetTick(size_t un_tick) {
+         m_bActive = m_bEnabled && (un_tick % m_unSamplingPeriod == 0);
       }
 
-      inline void AddThreadSafeBuffer() {
-         pthread_mutex_lock(&m_tMutex);
-         m_mapStreamOrder.insert(std::make_pair<pthread_t, size_t>(pthread_self(), m_vecStreams.size()));
-         m_vecStreams.push_back(new std::stringstream);
-         pthread_mutex_unlock(&m_tMutex);
+      /**
+       * Tells the log that the current tick is over.
+       * Called by the space at the end of each step. The messages sent between
+       * the steps, e.g., by CLoopFunctions::PostExperiment(), are not sampled.
+       * @see SetTick()
+       */
+      inline void EndTick() {
+         m_bActive = m_bEnabled;
+      }
+
+      /**
+       * Returns <tt>true</tt> if the messages sent now are kept.
+       * Check this before building expensive messages; the RLOG and
+       * RLOGERR macros do it for you.
+       */
+      inline bool IsActive() const {
+         return m_bActive;
+      }
+
+#ifdef ARGOS_THREADSAFE_LOG
+      /**
+       * Writes the content of the thread buffers to the stream.
+       * The buffers are merged in the order in which their threads registered.
+       * When the writer thread is running, the merged output is handed to it and
+       * this method returns without waiting for the stream.
+       */
+      void Flush();
+
+      /**
+       * Registers a buffer for the calling thread.
+       * Threads that log without calling this method are registered at their first message.
+       */
+      void AddThreadSafeBuffer();
+
+      /**
+       * Starts a thread that writes the flushed output to the stream.
+       * Do not use it when the stream is not thread-safe, e.g., a GUI widget.
+       */
+      void EnableAsyncWriter();
+
+      /**
+       * Writes the pending output and stops the writer thread.
+       */
+      void DisableAsyncWriter();
+
+      inline bool IsAsyncWriter() const {
+         return m_bAsyncWriter;
       }
 #else
       void Flush() {}
+      void EnableAsyncWriter() {}
+      void DisableAsyncWriter() {}
+      bool IsAsyncWriter() const { return false; }
 #endif
-      
+
       inline CARGoSLog& operator<<(std::ostream& (*c_stream)(std::ostream&)) {
-#ifdef ARGOS_THREADSAFE_LOG
-         *(m_vecStreams[m_mapStreamOrder.find(pthread_self())->second]) << c_stream;
-#else
-         m_cStream << c_stream;
-#endif
+         if(m_bActive) {
+            GetOutputStream() << c_stream;
+         }
          return *this;
       }
 
-      template <typename T> CARGoSLog& operator<<(const T t_msg) {
-         if(m_bColoredOutput) {
-#ifdef ARGOS_THREADSAFE_LOG
-            *(m_vecStreams[m_mapStreamOrder.find(pthread_self())->second]) << m_sLogColor << t_msg << reset;
-#else
-            m_cStream << m_sLogColor << t_msg << reset;
-#endif
+      template <typename T> CARGoSLog& operator<<(const T& t_msg) {
+         if(m_bActive) {
+            if(m_bColoredOutput) {
+               GetOutputStream() << m_sLogColor << t_msg << reset;
+            }
+            else {
+               GetOutputStream() << t_msg;
+            }
          }
-         else {
+         return *this;
+      }
+
+   private:
+
 #ifdef ARGOS_THREADSAFE_LOG
-            *(m_vecStreams[m_mapStreamOrder.find(pthread_self())->second]) << t_msg;
-#else
-            m_cStream << m_sLogColor << t_msg << reset;
-#endif
+      inline std::ostream& GetOutputStream() {
+         if(m_pvecThreadStreams != nullptr &&
+            m_unIndex < m_pvecThreadStreams->size() &&
+            (*m_pvecThreadStreams)[m_unIndex] != nullptr) {
+            return *(*m_pvecThreadStreams)[m_unIndex];
          }
-         return *this;
+         return AddThreadStream();
+      }
+
+      std::ostringstream& AddThreadStream();
+
+      void MergeStreams(std::string& str_output);
+
+      static void* WriterThread(void* pt_log);
+#else
+      inline std::ostream& GetOutputStream() {
+         return m_cStream;
       }
+#endif
 
    };
 
@@ -184,8 +279,14 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-#define RLOG    LOG    << "[" << GetId() << "] "
-#define RLOGERR LOGERR << "[" << GetId() << "] "
+/**
+ * Sends a message to a log only if the log is active.
+ * When the log is not active, the message is not even evaluated.
+ */
+#define ARGOS_LOG_IF_ACTIVE(LOGGER) if(!(LOGGER).IsActive()) {} else LOGGER
+
+#define RLOG    ARGOS_LOG_IF_ACTIVE(LOG)    << "[" << GetId() << "] "
+#define RLOGERR ARGOS_LOG_IF_ACTIVE(LOGERR) << "[" << GetId() << "] "
 
    /****************************************/
    /****************************************/
@@ -26,6 +26,13 @@ namespace argos {
    static const UInt32 LOWER_MASK = 0x7fffffffUL; /* least significant r bits */
    static const CRange<UInt32> INT_RANGE = CRange<UInt32>(0, 0xFFFFFFFFUL);
 
+   /* Philox4x32-10 parameters */
+   static const UInt32 PHILOX_M0 = 0xD2511F53UL;  /* multipliers */
+   static const UInt32 PHILOX_M1 = 0xCD9E8D57UL;
+   static const UInt32 PHILOX_W0 = 0x9E3779B9UL;  /* key increments (golden ratio, sqrt(3)-1) */
+   static const UInt32 PHILOX_W1 = 0xBB67AE85UL;
+   static const UInt32 PHILOX_ROUNDS = 10;
+
    std::map<std::string, CRandom::CCategory*> CRandom::m_mapCategories;
 
    /* Checks that a category exists. It internally creates an iterator that points to the category, if found.  */
@@ -73,6 +80,26 @@ namespace argos {
          m_punState[m_nIndex] &= 0xffffffffUL;
       }
    }
+
+   /****************************************/
+   /****************************************/
+
+   void CRandom::CRNG::SaveState(CByteArray& c_buffer) {
+      c_buffer << m_unSeed << m_nIndex;
+      for(SInt32 i = 0; i < N; ++i) {
+         c_buffer << m_punState[i];
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRandom::CRNG::LoadState(CByteArray& c_buffer) {
+      c_buffer >> m_unSeed >> m_nIndex;
+      for(SInt32 i = 0; i < N; ++i) {
+         c_buffer >> m_punState[i];
+      }
+   }
    
    /****************************************/
    /****************************************/
@@ -233,6 +260,194 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   CRandom::CCounterRNG::CCounterRNG(UInt32 un_seed,
+                                     UInt32 un_stream,
+                                     UInt32 un_substream) :
+      m_arrKey{un_seed, un_stream},
+      m_unSubstream(un_substream),
+      m_unTick(0),
+      m_unBlock(0),
+      m_arrBuffer{0, 0, 0, 0},
+      m_unBuffered(0) {}
+
+   /****************************************/
+   /****************************************/
+
+   void CRandom::CCounterRNG::Reset() {
+      SetTick(0);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRandom::CCounterRNG::SetTick(UInt32 un_tick) {
+      m_unTick = un_tick;
+      m_unBlock = 0;
+      m_unBuffered = 0;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRandom::CCounterRNG::SaveState(CByteArray& c_buffer) {
+      c_buffer << m_arrKey[0] << m_arrKey[1]
+               << m_unSubstream << m_unTick << m_unBlock
+               << m_arrBuffer[0] << m_arrBuffer[1] << m_arrBuffer[2] << m_arrBuffer[3]
+               << m_unBuffered;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRandom::CCounterRNG::LoadState(CByteArray& c_buffer) {
+      c_buffer >> m_arrKey[0] >> m_arrKey[1]
+               >> m_unSubstream >> m_unTick >> m_unBlock
+               >> m_arrBuffer[0] >> m_arrBuffer[1] >> m_arrBuffer[2] >> m_arrBuffer[3]
+               >> m_unBuffered;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CRandom::CCounterRNG::Bernoulli(Real f_true) {
+      return Uniform32bit() < f_true * INT_RANGE.GetMax();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CRadians CRandom::CCounterRNG::Uniform(const CRange<CRadians>& c_range) {
+      CRadians cRetVal;
+      INT_RANGE.MapValueIntoRange(cRetVal, Uniform32bit(), c_range);
+      return cRetVal;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   Real CRandom::CCounterRNG::Uniform(const CRange<Real>& c_range) {
+      Real fRetVal;
+      INT_RANGE.MapValueIntoRange(fRetVal, Uniform32bit(), c_range);
+      return fRetVal;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   SInt32 CRandom::CCounterRNG::Uniform(const CRange<SInt32>& c_range) {
+      SInt32 nRetVal;
+      INT_RANGE.MapValueIntoRange(nRetVal, Uniform32bit(), c_range);
+      return nRetVal;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   UInt32 CRandom::CCounterRNG::Uniform(const CRange<UInt32>& c_range) {
+      UInt32 unRetVal;
+      INT_RANGE.MapValueIntoRange(unRetVal, Uniform32bit(), c_range);
+      return unRetVal;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRandom::CCounterRNG::Uniform(Real* pf_values,
+                                      size_t un_count,
+                                      const CRange<Real>& c_range) {
+      Real fScale = c_range.GetSpan() / static_cast<Real>(INT_RANGE.GetMax());
+      size_t i = 0;
+      /* whole blocks are generated directly, the blocks are independent so
+         this loop can be vectorized */
+      for(; i + 4 <= un_count; i += 4) {
+         UInt32 arrBlock[4] = { m_unBlock++, m_unSubstream, m_unTick, 0 };
+         Philox(m_arrKey, arrBlock);
+         for(size_t j = 0; j < 4; ++j) {
+            pf_values[i + j] = arrBlock[j] * fScale + c_range.GetMin();
+         }
+      }
+      /* the remaining values are drawn one by one */
+      for(; i < un_count; ++i) {
+         pf_values[i] = Uniform(c_range);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   Real CRandom::CCounterRNG::Gaussian(Real f_std_dev,
+                                       Real f_mean) {
+      Real fValue;
+      Gaussian(&fValue, 1, f_std_dev, f_mean);
+      return fValue;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRandom::CCounterRNG::Gaussian(Real* pf_values,
+                                       size_t un_count,
+                                       Real f_std_dev,
+                                       Real f_mean) {
+      /* This is the Box-Muller method in its trigonometric variant. Unlike
+         the polar variant used by CRNG, it does not reject any number, so
+         every pair of random numbers yields a pair of values */
+      for(size_t i = 0; i < un_count; i += 2) {
+         /* (0,1] to avoid the logarithm of zero */
+         Real fU1 = (static_cast<Real>(Uniform32bit()) + 1.0) / 4294967296.0;
+         Real fU2 = static_cast<Real>(Uniform32bit()) / 4294967296.0;
+         Real fRadius = f_std_dev * Sqrt(-2.0 * Log(fU1));
+         CRadians cAngle = CRadians::TWO_PI * fU2;
+         pf_values[i] = f_mean + fRadius * Cos(cAngle);
+         if(i + 1 < un_count) {
+            pf_values[i + 1] = f_mean + fRadius * Sin(cAngle);
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   UInt32 CRandom::CCounterRNG::Uniform32bit() {
+      if(m_unBuffered == 0) {
+         m_arrBuffer[0] = m_unBlock++;
+         m_arrBuffer[1] = m_unSubstream;
+         m_arrBuffer[2] = m_unTick;
+         m_arrBuffer[3] = 0;
+         Philox(m_arrKey, m_arrBuffer);
+         m_unBuffered = 4;
+      }
+      return m_arrBuffer[4 - m_unBuffered--];
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRandom::CCounterRNG::Philox(const UInt32 (&arr_key)[2],
+                                     UInt32 (&arr_counter)[4]) {
+      UInt32 unKey0 = arr_key[0];
+      UInt32 unKey1 = arr_key[1];
+      for(UInt32 i = 0; i < PHILOX_ROUNDS; ++i) {
+         UInt64 unProduct0 = static_cast<UInt64>(PHILOX_M0) * arr_counter[0];
+         UInt64 unProduct1 = static_cast<UInt64>(PHILOX_M1) * arr_counter[2];
+         UInt32 arrRound[4] = {
+            static_cast<UInt32>(unProduct1 >> 32) ^ arr_counter[1] ^ unKey0,
+            static_cast<UInt32>(unProduct1),
+            static_cast<UInt32>(unProduct0 >> 32) ^ arr_counter[3] ^ unKey1,
+            static_cast<UInt32>(unProduct0)
+         };
+         arr_counter[0] = arrRound[0];
+         arr_counter[1] = arrRound[1];
+         arr_counter[2] = arrRound[2];
+         arr_counter[3] = arrRound[3];
+         unKey0 += PHILOX_W0;
+         unKey1 += PHILOX_W1;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    CRandom::CCategory::CCategory(const std::string& str_id,
                                  UInt32 un_seed) :
       m_strId(str_id),
@@ -248,6 +463,10 @@ namespace argos {
          delete m_vecRNGList.back();
          m_vecRNGList.pop_back();
       }
+      while(! m_vecCounterRNGList.empty()) {
+         delete m_vecCounterRNGList.back();
+         m_vecCounterRNGList.pop_back();
+      }
    }
 
    /****************************************/
@@ -272,6 +491,16 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   CRandom::CCounterRNG* CRandom::CCategory::CreateCounterRNG() {
+      /* The stream is the creation index, so no seed is drawn from the internal RNG */
+      m_vecCounterRNGList.push_back(
+         new CCounterRNG(m_unSeed, m_vecCounterRNGList.size()));
+      return m_vecCounterRNGList.back();
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CRandom::CCategory::ResetRNGs() {
       /* Reset internal RNG */
       m_cSeeder.Reset();
@@ -280,6 +509,9 @@ namespace argos {
       for(size_t i = 0; i < m_vecRNGList.size(); ++i) {
          m_vecRNGList[i]->Reset();
       }
+      for(size_t i = 0; i < m_vecCounterRNGList.size(); ++i) {
+         m_vecCounterRNGList[i]->Reset();
+      }
    }
 
    /****************************************/
@@ -290,6 +522,53 @@ namespace argos {
          /* Get seed from internal RNG */
          m_vecRNGList[i]->SetSeed(m_cSeeder.Uniform(m_cSeedRange));
       }
+      for(size_t i = 0; i < m_vecCounterRNGList.size(); ++i) {
+         m_vecCounterRNGList[i]->SetSeed(m_unSeed);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRandom::CCategory::SaveState(CByteArray& c_buffer) {
+      c_buffer << m_unSeed;
+      m_cSeeder.SaveState(c_buffer);
+      /* The RNGs go in separate blocks, as a category may hold thousands of them */
+      c_buffer << static_cast<UInt32>(m_vecRNGList.size());
+      for(size_t i = 0; i < m_vecRNGList.size(); ++i) {
+         SaveMementoBlock(c_buffer, *m_vecRNGList[i]);
+      }
+      c_buffer << static_cast<UInt32>(m_vecCounterRNGList.size());
+      for(size_t i = 0; i < m_vecCounterRNGList.size(); ++i) {
+         m_vecCounterRNGList[i]->SaveState(c_buffer);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRandom::CCategory::LoadState(CByteArray& c_buffer) {
+      c_buffer >> m_unSeed;
+      m_cSeeder.LoadState(c_buffer);
+      UInt32 unNumRNGs;
+      c_buffer >> unNumRNGs;
+      if(unNumRNGs != m_vecRNGList.size()) {
+         THROW_ARGOSEXCEPTION("CRandom:: category \"" << m_strId << "\" has " << m_vecRNGList.size()
+                              << " RNGs, but the saved state has " << unNumRNGs << ".");
+      }
+      CMementoBlockReader cReader(c_buffer);
+      for(size_t i = 0; i < m_vecRNGList.size(); ++i) {
+         cReader.LoadNextBlock(*m_vecRNGList[i]);
+      }
+      cReader.Finish();
+      c_buffer >> unNumRNGs;
+      if(unNumRNGs != m_vecCounterRNGList.size()) {
+         THROW_ARGOSEXCEPTION("CRandom:: category \"" << m_strId << "\" has " << m_vecCounterRNGList.size()
+                              << " counter-based RNGs, but the saved state has " << unNumRNGs << ".");
+      }
+      for(size_t i = 0; i < m_vecCounterRNGList.size(); ++i) {
+         m_vecCounterRNGList[i]->LoadState(c_buffer);
+      }
    }
 
    /****************************************/
@@ -352,6 +631,14 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   CRandom::CCounterRNG* CRandom::CreateCounterRNG(const std::string& str_category) {
+      CHECK_CATEGORY(str_category);
+      return itCategory->second->CreateCounterRNG();
+   }
+
+   /****************************************/
+   /****************************************/
+
    UInt32 CRandom::GetSeedOf(const std::string& str_category) {
       CHECK_CATEGORY(str_category);
       return itCategory->second->GetSeed();
@@ -380,4 +667,56 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CRandom::ReseedAll(UInt32 un_value) {
+      for(auto itCategory = m_mapCategories.begin();
+          itCategory != m_mapCategories.end();
+          ++itCategory) {
+         /* Mix the seed with the value (MurmurHash3 finalizer) */
+         UInt32 unSeed = itCategory->second->GetSeed() ^ (un_value * 0x9E3779B9u);
+         unSeed ^= unSeed >> 16;
+         unSeed *= 0x85EBCA6Bu;
+         unSeed ^= unSeed >> 13;
+         unSeed *= 0xC2B2AE35u;
+         unSeed ^= unSeed >> 16;
+         itCategory->second->SetSeed(unSeed);
+         itCategory->second->ResetRNGs();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRandom::SaveState(CByteArray& c_buffer) {
+      c_buffer << static_cast<UInt32>(m_mapCategories.size());
+      for(auto itCategory = m_mapCategories.begin();
+          itCategory != m_mapCategories.end();
+          ++itCategory) {
+         CByteArray cBlock;
+         cBlock << itCategory->first;
+         itCategory->second->SaveState(cBlock);
+         AddMementoBlock(c_buffer, cBlock);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRandom::LoadState(CByteArray& c_buffer) {
+      UInt32 unNumCategories;
+      c_buffer >> unNumCategories;
+      CMementoBlockReader cReader(c_buffer);
+      CByteArray cBlock;
+      std::string strCategory;
+      for(UInt32 i = 0; i < unNumCategories; ++i) {
+         cReader.NextBlock(cBlock);
+         cBlock >> strCategory;
+         CHECK_CATEGORY(strCategory);
+         itCategory->second->LoadState(cBlock);
+      }
+      cReader.Finish();
+   }
+
+   /****************************************/
+   /****************************************/
+
 }
@@ -15,6 +15,7 @@ namespace argos {
 
 #include <argos3/core/utility/math/angles.h>
 #include <argos3/core/utility/math/range.h>
+#include <argos3/core/utility/configuration/memento.h>
 #include <map>
 
 namespace argos {
@@ -87,7 +88,7 @@ namespace argos {
        * This class is the real random number generator. You need an instance of this class
        * to be able to generate random numbers.
        */
-      class CRNG {
+      class CRNG : public CMemento {
 
       public:
 
@@ -134,6 +135,18 @@ namespace argos {
           */
          void Reset();
 
+         /**
+          * Saves the seed and the internal state of the RNG.
+          * @param c_buffer the target buffer
+          */
+         virtual void SaveState(CByteArray& c_buffer);
+
+         /**
+          * Restores the seed and the internal state of the RNG.
+          * @param c_buffer the source buffer
+          */
+         virtual void LoadState(CByteArray& c_buffer);
+
          /**
           * Returns a random value from a Bernoulli distribution.
           * @param f_true the probability to return a 1.
@@ -237,11 +250,177 @@ namespace argos {
 
       };
 
+      /**
+       * A counter-based RNG.
+       * This generator implements Philox4x32-10. Unlike CRNG, it has no sequential state:
+       * each block of four random numbers is a function of a key and a counter. The key is
+       * made of the seed and a stream index, the counter of a substream index, the current
+       * tick and the number of blocks drawn in the tick. Therefore, the numbers drawn in a
+       * tick depend neither on the draws of the previous ticks nor on the order in which
+       * the RNGs are used, which makes them reproducible regardless of the number of threads.
+       * The state is a few bytes, and arrays can be filled at once with the bulk versions
+       * of Uniform() and Gaussian().
+       */
+      class CCounterRNG : public CMemento {
+
+      public:
+
+         /**
+          * Class constructor.
+          * To create a new RNG from user code, never use this method. Use CreateCounterRNG() instead.
+          * @param un_seed the seed of the RNG.
+          * @param un_stream the index of the stream, typically one per device.
+          * @param un_substream the index of the substream.
+          */
+         CCounterRNG(UInt32 un_seed,
+                     UInt32 un_stream,
+                     UInt32 un_substream = 0);
+
+         /**
+          * Returns the seed of this RNG.
+          * @return the seed of this RNG.
+          */
+         inline UInt32 GetSeed() const {
+            return m_arrKey[0];
+         }
+
+         /**
+          * Sets the seed of this RNG.
+          * This method does not reset the RNG. You must call Reset() explicitly.
+          * @param un_seed the new seed for this RNG.
+          * @see Reset()
+          */
+         inline void SetSeed(UInt32 un_seed) {
+            m_arrKey[0] = un_seed;
+         }
+
+         /**
+          * Returns the index of the stream of this RNG.
+          * @return the index of the stream of this RNG.
+          */
+         inline UInt32 GetStream() const {
+            return m_arrKey[1];
+         }
+
+         /**
+          * Reset the RNG.
+          * Sets the tick to zero.
+          */
+         void Reset();
+
+         /**
+          * Saves the key, the counter and the buffered numbers of the RNG.
+          * @param c_buffer the target buffer
+          */
+         virtual void SaveState(CByteArray& c_buffer);
+
+         /**
+          * Restores the key, the counter and the buffered numbers of the RNG.
+          * @param c_buffer the source buffer
+          */
+         virtual void LoadState(CByteArray& c_buffer);
+
+         /**
+          * Sets the current tick.
+          * The numbers drawn after this call depend only on the key, the substream and the tick.
+          * @param un_tick the current tick.
+          */
+         void SetTick(UInt32 un_tick);
+
+         /**
+          * Returns a random value from a Bernoulli distribution.
+          * @param f_true the probability to return a 1.
+          * @returns a random value from a Bernoulli distribution (<tt>true</tt>/<tt>false</tt>).
+          */
+         bool Bernoulli(Real f_true = 0.5);
+
+         /**
+          * Returns a random value from a uniform distribution.
+          * @param c_range the range of values to draw one from.
+          * @return a random value from the range [min,max).
+          */
+         CRadians Uniform(const CRange<CRadians>& c_range);
+
+         /**
+          * Returns a random value from a uniform distribution.
+          * @param c_range the range of values to draw one from.
+          * @return a random value from the range [min,max).
+          */
+         Real Uniform(const CRange<Real>& c_range);
+
+         /**
+          * Returns a random value from a uniform distribution.
+          * @param c_range the range of values to draw one from.
+          * @return a random value from the range [min,max).
+          */
+         SInt32 Uniform(const CRange<SInt32>& c_range);
+
+         /**
+          * Returns a random value from a uniform distribution.
+          * @param c_range the range of values to draw one from.
+          * @return a random value from the range [min,max).
+          */
+         UInt32 Uniform(const CRange<UInt32>& c_range);
+
+         /**
+          * Fills an array with random values from a uniform distribution.
+          * @param pf_values the array to fill.
+          * @param un_count the number of values to draw.
+          * @param c_range the range of values to draw from.
+          */
+         void Uniform(Real* pf_values,
+                      size_t un_count,
+                      const CRange<Real>& c_range);
+
+         /**
+          * Returns a random value from a Gaussian distribution.
+          * @param f_std_dev the standard deviation of the Gaussian distribution.
+          * @param f_mean the mean of the Gaussian distribution.
+          * @return a random value from the Gaussian distribution.
+          */
+         Real Gaussian(Real f_std_dev, Real f_mean = 0.0f);
+
+         /**
+          * Fills an array with random values from a Gaussian distribution.
+          * @param pf_values the array to fill.
+          * @param un_count the number of values to draw.
+          * @param f_std_dev the standard deviation of the Gaussian distribution.
+          * @param f_mean the mean of the Gaussian distribution.
+          */
+         void Gaussian(Real* pf_values,
+                       size_t un_count,
+                       Real f_std_dev,
+                       Real f_mean = 0.0f);
+
+         /**
+          * Generates a random 32bit unsigned integer.
+          */
+         UInt32 Uniform32bit();
+
+         /**
+          * Computes a block of the Philox4x32-10 generator.
+          * @param arr_key the key.
+          * @param arr_counter the counter, which is replaced by the random block.
+          */
+         static void Philox(const UInt32 (&arr_key)[2],
+                            UInt32 (&arr_counter)[4]);
+
+      private:
+
+         UInt32 m_arrKey[2];
+         UInt32 m_unSubstream;
+         UInt32 m_unTick;
+         UInt32 m_unBlock;
+         UInt32 m_arrBuffer[4];
+         UInt32 m_unBuffered;
+
+      };
+
       /**
        * The RNG category.
        * This class stores a specific category of RNGs.
        */
-      class CCategory {
+      class CCategory : public CMemento {
 
       public:
 
@@ -294,6 +473,13 @@ namespace argos {
           */
          CRNG* CreateRNG();
 
+         /**
+          * Creates a new counter-based RNG inside this category.
+          * The RNGs are assigned consecutive streams in the order of creation.
+          * @return the pointer to a new counter-based RNG inside this category.
+          */
+         CCounterRNG* CreateCounterRNG();
+
          /**
           * Resets the RNGs in this category.
           */
@@ -306,10 +492,25 @@ namespace argos {
           */
          void ReseedRNGs();
 
+         /**
+          * Saves the state of the category and of its RNGs.
+          * @param c_buffer the target buffer
+          */
+         virtual void SaveState(CByteArray& c_buffer);
+
+         /**
+          * Restores the state of the category and of its RNGs.
+          * The category must contain as many RNGs as when the state was saved.
+          * @param c_buffer the source buffer
+          * @throws CARGoSException if the number of RNGs does not match
+          */
+         virtual void LoadState(CByteArray& c_buffer);
+
       private:
 
          std::string m_strId;
          std::vector<CRNG*> m_vecRNGList;
+         std::vector<CCounterRNG*> m_vecCounterRNGList;
          UInt32 m_unSeed;
          CRNG m_cSeeder;
          CRange<UInt32> m_cSeedRange;
@@ -352,6 +553,13 @@ namespace argos {
        */
       static CRNG* CreateRNG(const std::string& str_category);
 
+      /**
+       * Creates a new counter-based RNG inside the given category.
+       * @param str_category the id of the category.
+       * @return the pointer to a new counter-based RNG inside this category.
+       */
+      static CCounterRNG* CreateCounterRNG(const std::string& str_category);
+
       /**
        * Returns the seed of the wanted category.
        * @param str_category the id of the category.
@@ -374,6 +582,31 @@ namespace argos {
        */
       static void Reset();
 
+      /**
+       * Gives all the RNG categories new seeds and resets them.
+       * The new seed of each category is derived from its current seed and
+       * the given value. Different values yield unrelated sequences. This is
+       * used to give processes forked from the same experiment independent
+       * random streams.
+       * @param un_value the value the new seeds are derived from.
+       * @see CSimulator::Branch()
+       */
+      static void ReseedAll(UInt32 un_value);
+
+      /**
+       * Saves the state of all the RNG categories.
+       * @param c_buffer the target buffer
+       */
+      static void SaveState(CByteArray& c_buffer);
+
+      /**
+       * Restores the state of the RNG categories.
+       * The categories must exist and contain as many RNGs as when the state was saved.
+       * @param c_buffer the source buffer
+       * @throws CARGoSException if a category is missing or does not match
+       */
+      static void LoadState(CByteArray& c_buffer);
+
    private:
 
       static std::map<std::string, CCategory*> m_mapCategories;
@@ -8,6 +8,8 @@
 
 #include <dirent.h>
 #include <cerrno>
+#include <climits>
+#include <fstream>
 
 namespace argos {
 
@@ -16,6 +18,7 @@ namespace argos {
 
    CDynamicLoading::TDLHandleMap CDynamicLoading::m_tOpenLibs;
    const std::string CDynamicLoading::DEFAULT_PLUGIN_PATH = ARGOS_INSTALL_PREFIX "/lib/argos3/";
+   const std::string CDynamicLoading::MANIFEST_EXTENSION = ".manifest";
 
    /****************************************/
    /****************************************/
@@ -178,9 +181,108 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   void CDynamicLoading::LoadAllLibraries() {      
-      /* String to store the full path to a library */
-      std::string strLibPath;
+   void CDynamicLoading::LoadAllLibraries() {
+      std::vector<std::string> vecLibs = GetLibrariesInPluginPath();
+      for(size_t i = 0; i < vecLibs.size(); ++i) {
+         LoadLibrary(vecLibs[i]);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamicLoading::LoadLibrariesProviding(const std::set<std::string>& set_labels) {
+      std::vector<std::string> vecLibs = GetLibrariesInPluginPath();
+      std::string strLabel;
+      for(size_t i = 0; i < vecLibs.size(); ++i) {
+         /* Without a manifest, there is no way to know what the library provides */
+         std::ifstream cManifest(vecLibs[i] + MANIFEST_EXTENSION);
+         if(!cManifest) {
+            LoadLibrary(vecLibs[i]);
+            continue;
+         }
+         /* Go through the labels in the manifest */
+         bool bEmpty = true;
+         bool bNeeded = false;
+         while(std::getline(cManifest, strLabel)) {
+            if(strLabel.empty() || strLabel[0] == '#') {
+               continue;
+            }
+            bEmpty = false;
+            if(set_labels.count(strLabel) > 0) {
+               bNeeded = true;
+               break;
+            }
+         }
+         if(bEmpty || bNeeded) {
+            LoadLibrary(vecLibs[i]);
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamicLoading::WriteManifest(const std::string& str_lib) {
+      /* Load the library, this registers its labels */
+      LoadLibrary(str_lib);
+      /* Get the real path of the library, to compare it with the files the symbols come from */
+      char pchPath[PATH_MAX];
+      if(::realpath(str_lib.c_str(), pchPath) == nullptr) {
+         THROW_ARGOSEXCEPTION("Can't resolve the path of library \""
+                              << str_lib
+                              << "\": "
+                              << ::strerror(errno));
+      }
+      std::string strLibPath(pchPath);
+      /* Write the labels whose symbols are defined in the library */
+      std::string strManifest = str_lib + MANIFEST_EXTENSION;
+      std::ofstream cManifest(strManifest, std::ios::out | std::ios::trunc);
+      if(!cManifest) {
+         THROW_ARGOSEXCEPTION("Can't open manifest file \""
+                              << strManifest
+                              << "\" for writing");
+      }
+      cManifest << "# Labels provided by " << strLibPath << std::endl;
+      std::vector<std::pair<std::string, void*> >& vecLabels = GetRecordedLabels();
+      std::set<std::string> setWritten;
+      Dl_info tInfo;
+      for(size_t i = 0; i < vecLabels.size(); ++i) {
+         if(::dladdr(vecLabels[i].second, &tInfo) != 0 &&
+            tInfo.dli_fname != nullptr &&
+            ::realpath(tInfo.dli_fname, pchPath) != nullptr &&
+            strLibPath == pchPath &&
+            setWritten.insert(vecLabels[i].first).second) {
+            cManifest << vecLabels[i].first << std::endl;
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamicLoading::RecordLabel(const std::string& str_label,
+                                     void* pt_symbol) {
+      GetRecordedLabels().emplace_back(str_label, pt_symbol);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamicLoading::UnloadAllLibraries() {
+      for(auto it = m_tOpenLibs.begin();
+          it != m_tOpenLibs.end();
+          ++it) {
+         UnloadLibrary(it->first);
+      }
+      m_tOpenLibs.clear();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   std::vector<std::string> CDynamicLoading::GetLibrariesInPluginPath() {
+      std::vector<std::string> vecLibs;
       /* String to store the list of paths to search */
       std::string strPluginPath = DEFAULT_PLUGIN_PATH;
       /* Get variable ARGOS_PLUGIN_PATH from the environment */
@@ -193,7 +295,7 @@ namespace argos {
          strPluginPath.append(":");
       }
       /*
-       * Go through paths and load all the libraries
+       * Go through paths and list all the libraries
        */
       /* Directory info */
       DIR* ptDir;
@@ -215,15 +317,15 @@ namespace argos {
                if(strlen(ptDirData->d_name) > strlen(ARGOS_SHARED_LIBRARY_EXTENSION) &&
                   std::string(ptDirData->d_name).rfind("." ARGOS_SHARED_LIBRARY_EXTENSION) +
                   strlen(ARGOS_SHARED_LIBRARY_EXTENSION) + 1 == strlen(ptDirData->d_name)) {
-                  /* It's a library file, load it */
-                  LoadLibrary(strDir + ptDirData->d_name);
+                  /* It's a library file, add it */
+                  vecLibs.push_back(strDir + ptDirData->d_name);
                }
                if(strcmp(ARGOS_SHARED_LIBRARY_EXTENSION, ARGOS_MODULE_LIBRARY_EXTENSION) != 0) {
                   if(strlen(ptDirData->d_name) > strlen(ARGOS_MODULE_LIBRARY_EXTENSION) &&
                      std::string(ptDirData->d_name).rfind("." ARGOS_MODULE_LIBRARY_EXTENSION) +
                      strlen(ARGOS_MODULE_LIBRARY_EXTENSION) + 1 == strlen(ptDirData->d_name)) {
-                     /* It's a library file, load it */
-                     LoadLibrary(strDir + ptDirData->d_name);
+                     /* It's a library file, add it */
+                     vecLibs.push_back(strDir + ptDirData->d_name);
                   }
                }
             }
@@ -240,18 +342,16 @@ namespace argos {
             LOGERR.Flush();
          }
       }
+      return vecLibs;
    }
 
    /****************************************/
    /****************************************/
 
-   void CDynamicLoading::UnloadAllLibraries() {
-      for(auto it = m_tOpenLibs.begin();
-          it != m_tOpenLibs.end();
-          ++it) {
-         UnloadLibrary(it->first);
-      }
-      m_tOpenLibs.clear();
+   std::vector<std::pair<std::string, void*> >& CDynamicLoading::GetRecordedLabels() {
+      /* Function-local, as labels are recorded during static initialization */
+      static std::vector<std::pair<std::string, void*> > vecLabels;
+      return vecLabels;
    }
 
    /****************************************/
@@ -11,7 +11,9 @@
 #include <argos3/core/utility/logging/argos_log.h>
 
 #include <map>
+#include <set>
 #include <string>
+#include <vector>
 
 #include <dlfcn.h>
 #include <cstdlib>
@@ -72,6 +74,39 @@ namespace argos {
        */
       static void LoadAllLibraries();
 
+      /**
+       * Loads the dynamic libraries in the current ARGOS_PLUGIN_PATH that provide the given labels.
+       * <p>
+       * The labels provided by a library are listed in its manifest, a text file
+       * with the same path as the library and the <tt>.manifest</tt> extension
+       * appended (e.g., <tt>libfoo.so.manifest</tt>). A library is loaded if its
+       * manifest lists at least one of the given labels. Libraries without a
+       * manifest, or with an empty one, are always loaded.
+       * </p>
+       * @param set_labels The labels the libraries must provide
+       * @throws CARGoSException in case of error
+       * @see WriteManifest()
+       */
+      static void LoadLibrariesProviding(const std::set<std::string>& set_labels);
+
+      /**
+       * Loads a dynamic library and writes its manifest.
+       * The manifest lists the factory labels whose symbols are defined in the library.
+       * @param str_lib The path of the dynamic library
+       * @throws CARGoSException in case of error
+       * @see LoadLibrariesProviding()
+       */
+      static void WriteManifest(const std::string& str_lib);
+
+      /**
+       * Records that a symbol was registered under the given label.
+       * Called by CFactory when a type is registered.
+       * @param str_label The label
+       * @param pt_symbol The registered symbol
+       */
+      static void RecordLabel(const std::string& str_label,
+                              void* pt_symbol);
+
       /**
        * Unloads all the dynamic libraries.
        * @throws CARGoSException in case of error
@@ -94,6 +129,21 @@ namespace argos {
        * Default plugin paths
        */
       static const std::string DEFAULT_PLUGIN_PATH;
+
+      /**
+       * Extension of the manifest files
+       */
+      static const std::string MANIFEST_EXTENSION;
+
+      /**
+       * Returns the paths of the dynamic libraries in the current ARGOS_PLUGIN_PATH.
+       */
+      static std::vector<std::string> GetLibrariesInPluginPath();
+
+      /**
+       * Returns the recorded labels, along with the symbols registered under them.
+       */
+      static std::vector<std::pair<std::string, void*> >& GetRecordedLabels();
    };
 
 }
@@ -44,7 +44,11 @@
 #ifndef FACTORY_H
 #define FACTORY_H
 
+#include <argos3/core/config.h>
 #include <argos3/core/utility/configuration/argos_exception.h>
+#ifdef ARGOS_DYNAMIC_LIBRARY_LOADING
+#include <argos3/core/utility/plugins/dynamic_loading.h>
+#endif
 #include <map>
 #include <iostream>
 #include <string>
@@ -39,6 +39,10 @@ void CFactory<TYPE>::Register(const std::string& str_label,
    psTypeInfo->Status = str_status;
    psTypeInfo->Creator = pc_creator;
    GetTypeMap()[str_label] = psTypeInfo;
+#ifdef ARGOS_DYNAMIC_LIBRARY_LOADING
+   /* Keep track of the label to find out which library provides it */
+   CDynamicLoading::RecordLabel(str_label, reinterpret_cast<void*>(pc_creator));
+#endif
 }
 
 /****************************************/
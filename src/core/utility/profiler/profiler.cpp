@@ -7,12 +7,27 @@
 #include "profiler.h"
 #include <argos3/core/utility/logging/argos_log.h>
 #include <argos3/core/utility/configuration/argos_configuration.h>
+#include <algorithm>
+#include <cmath>
+#include <ctime>
 
 namespace argos {
 
    /****************************************/
    /****************************************/
 
+   static const char* PHASE_NAMES[CProfiler::PHASE_NUM] = {
+      "act",
+      "physics",
+      "media",
+      "prestep",
+      "sense_control",
+      "poststep"
+   };
+
+   /****************************************/
+   /****************************************/
+
    static double TV2Sec(const ::timeval& t_timeval) {
       return
          static_cast<double>(t_timeval.tv_sec) +
@@ -113,8 +128,108 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   static std::string JSONEscape(const std::string& str_text) {
+      std::string strResult;
+      for(char c : str_text) {
+         if(c == '"' || c == '\\') strResult += '\\';
+         strResult += c;
+      }
+      return strResult;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   /* The smallest time the histogram tells apart, in seconds */
+   static const double TIMING_HISTOGRAM_MIN = 1e-9;
+
+   CProfiler::STimingStats::STimingStats(const std::string& str_name) :
+      Name(str_name),
+      Count(0),
+      Total(0.0),
+      Min(0.0),
+      Max(0.0),
+      Histogram(BINS_PER_OCTAVE * OCTAVES, 0) {}
+
+   /****************************************/
+   /****************************************/
+
+   void CProfiler::STimingStats::Add(double f_sample) {
+      if(Count == 0 || f_sample < Min) Min = f_sample;
+      if(Count == 0 || f_sample > Max) Max = f_sample;
+      ++Count;
+      Total += f_sample;
+      /* Bin i holds the samples in [MIN * 2^(i/B), MIN * 2^((i+1)/B)) */
+      size_t unBin = 0;
+      if(f_sample > TIMING_HISTOGRAM_MIN) {
+         unBin = std::min(static_cast<size_t>(std::log2(f_sample / TIMING_HISTOGRAM_MIN) * BINS_PER_OCTAVE),
+                          Histogram.size() - 1);
+      }
+      ++Histogram[unBin];
+   }
+
+   /****************************************/
+   /****************************************/
+
+   double CProfiler::STimingStats::GetTotal() const {
+      return Total;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   double CProfiler::STimingStats::GetMin() const {
+      return Min;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   double CProfiler::STimingStats::GetMean() const {
+      if(Count == 0) return 0.0;
+      return Total / Count;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   double CProfiler::STimingStats::GetPercentile(double f_percentile) const {
+      if(Count == 0) return 0.0;
+      /* The rank of the wanted sample, as in the nearest-rank method */
+      size_t unRank = static_cast<size_t>(std::ceil(f_percentile * Count));
+      if(unRank == 0) unRank = 1;
+      size_t unSeen = 0;
+      for(size_t i = 0; i < Histogram.size(); ++i) {
+         unSeen += Histogram[i];
+         if(unSeen >= unRank) {
+            /* Return the geometric center of the bin, within the observed range */
+            double fValue = TIMING_HISTOGRAM_MIN *
+               std::exp2((i + 0.5) / BINS_PER_OCTAVE);
+            return std::max(Min, std::min(Max, fValue));
+         }
+      }
+      return Max;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CProfiler::SThreadTiming::SThreadTiming() :
+      PhaseDone(0.0) {
+      for(size_t i = 0; i < PHASE_NUM; ++i) {
+         Idle[i] = 0.0;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    CProfiler::CProfiler(const std::string& str_file_name,
-                        bool b_trunc) {
+                        bool b_trunc) :
+      m_eCurrentPhase(PHASE_ACT),
+      m_fCurrentPhaseStart(0.0),
+      m_fCurrentSubPhaseStart(0.0),
+      m_bPhaseRunning(false) {
       if(b_trunc) {
          m_cOutFile.open(str_file_name.c_str(),
                          std::ios::trunc | std::ios::out);
@@ -128,6 +243,9 @@ namespace argos {
       if(nError) {
          THROW_ARGOSEXCEPTION("Error creating thread profiler mutex " << ::strerror(nError));
       }
+      for(size_t i = 0; i < PHASE_NUM; ++i) {
+         m_vecPhases.emplace_back(PHASE_NAMES[i]);
+      }
    }
 
    /****************************************/
@@ -158,11 +276,26 @@ namespace argos {
    /****************************************/
 
    void CProfiler::Flush(bool b_human_readable) {
-      if(b_human_readable) {
-         FlushHumanReadable();
-      }
-      else {
-         FlushAsTable();
+      Flush(b_human_readable ? FORMAT_HUMAN_READABLE : FORMAT_TABLE);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CProfiler::Flush(EFormat e_format) {
+      switch(e_format) {
+         case FORMAT_HUMAN_READABLE:
+            FlushHumanReadable();
+            break;
+         case FORMAT_TABLE:
+            FlushAsTable();
+            break;
+         case FORMAT_CSV:
+            FlushAsCSV();
+            break;
+         case FORMAT_JSON:
+            FlushAsJSON();
+            break;
       }
    }
 
@@ -186,6 +319,112 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CProfiler::InitPhaseProfiling(size_t un_num_threads,
+                                      const std::vector<std::string>& vec_physics_engines,
+                                      const std::vector<std::string>& vec_media) {
+      m_vecThreads.assign(un_num_threads, SThreadTiming());
+      m_vecPhysicsEngines.clear();
+      for(size_t i = 0; i < vec_physics_engines.size(); ++i) {
+         m_vecPhysicsEngines.emplace_back(vec_physics_engines[i]);
+      }
+      m_vecMedia.clear();
+      for(size_t i = 0; i < vec_media.size(); ++i) {
+         m_vecMedia.emplace_back(vec_media[i]);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CProfiler::StartPhase(EPhase e_phase) {
+      m_eCurrentPhase = e_phase;
+      m_fCurrentPhaseStart = GetTime();
+      m_fCurrentSubPhaseStart = m_fCurrentPhaseStart;
+      m_bPhaseRunning = true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CProfiler::StopPhase() {
+      StopSubPhase();
+      m_vecPhases[m_eCurrentPhase].Add(m_fCurrentSubPhaseStart - m_fCurrentPhaseStart);
+      m_bPhaseRunning = false;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CProfiler::StopSubPhase() {
+      /* Barriers outside the profiled phases are not accounted */
+      if(!m_bPhaseRunning) {
+         return;
+      }
+      double fEnd = GetTime();
+      /* Account for the time each thread spent waiting for the others */
+      for(size_t i = 0; i < m_vecThreads.size(); ++i) {
+         if(m_vecThreads[i].PhaseDone >= m_fCurrentSubPhaseStart) {
+            m_vecThreads[i].Idle[m_eCurrentPhase] += fEnd - m_vecThreads[i].PhaseDone;
+         }
+      }
+      m_fCurrentSubPhaseStart = fEnd;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CProfiler::CollectThreadPhaseDone(size_t un_thread) {
+      if(un_thread < m_vecThreads.size()) {
+         m_vecThreads[un_thread].PhaseDone = GetTime();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CProfiler::CollectPhysicsEngineTime(size_t un_engine, double f_time) {
+      if(un_engine < m_vecPhysicsEngines.size()) {
+         m_vecPhysicsEngines[un_engine].Add(f_time);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CProfiler::CollectMediumTime(size_t un_medium, double f_time) {
+      if(un_medium < m_vecMedia.size()) {
+         m_vecMedia[un_medium].Add(f_time);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CProfiler::CollectResetTime(const std::string& str_kind, double f_time) {
+      for(size_t i = 0; i < m_vecResets.size(); ++i) {
+         if(m_vecResets[i].Name == str_kind) {
+            m_vecResets[i].Add(f_time);
+            return;
+         }
+      }
+      m_vecResets.emplace_back(str_kind);
+      m_vecResets.back().Add(f_time);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   double CProfiler::GetTime() {
+      ::timespec tTime;
+      ::clock_gettime(CLOCK_MONOTONIC, &tTime);
+      return
+         static_cast<double>(tTime.tv_sec) +
+         static_cast<double>(tTime.tv_nsec) * 0.000000001;
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CProfiler::FlushHumanReadable() {
       m_cOutFile << "[profiled portion overall]" << std::endl << std::endl;
       double fStartTime = TV2Sec(m_tWallClockStart);
@@ -214,6 +453,70 @@ namespace argos {
             DumpResourceUsageHumanReadable(m_cOutFile, m_vecThreadResourceUsage[i]);
          }
       }
+      FlushPhasesHumanReadable();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   static void DumpTimingHumanReadable(std::ostream& c_os,
+                                       const std::string& str_title,
+                                       double f_total,
+                                       double f_min,
+                                       double f_mean,
+                                       double f_p99,
+                                       const std::string& str_unit = "step") {
+      c_os << std::endl << "[" << str_title << "]" << std::endl << std::endl;
+      c_os << "Total time: " << f_total << std::endl;
+      c_os << "Minimum time per " << str_unit << ": " << f_min << std::endl;
+      c_os << "Mean time per " << str_unit << ": " << f_mean << std::endl;
+      c_os << "99th percentile time per " << str_unit << ": " << f_p99 << std::endl;
+   }
+
+   void CProfiler::FlushPhasesHumanReadable() {
+      for(size_t i = 0; i < m_vecPhases.size(); ++i) {
+         const STimingStats& sPhase = m_vecPhases[i];
+         DumpTimingHumanReadable(m_cOutFile,
+                                 "phase " + sPhase.Name,
+                                 sPhase.GetTotal(),
+                                 sPhase.GetMin(),
+                                 sPhase.GetMean(),
+                                 sPhase.GetPercentile(0.99));
+      }
+      for(size_t i = 0; i < m_vecPhysicsEngines.size(); ++i) {
+         const STimingStats& sEngine = m_vecPhysicsEngines[i];
+         DumpTimingHumanReadable(m_cOutFile,
+                                 "physics engine " + sEngine.Name,
+                                 sEngine.GetTotal(),
+                                 sEngine.GetMin(),
+                                 sEngine.GetMean(),
+                                 sEngine.GetPercentile(0.99));
+      }
+      for(size_t i = 0; i < m_vecMedia.size(); ++i) {
+         const STimingStats& sMedium = m_vecMedia[i];
+         DumpTimingHumanReadable(m_cOutFile,
+                                 "medium " + sMedium.Name,
+                                 sMedium.GetTotal(),
+                                 sMedium.GetMin(),
+                                 sMedium.GetMean(),
+                                 sMedium.GetPercentile(0.99));
+      }
+      for(size_t i = 0; i < m_vecResets.size(); ++i) {
+         const STimingStats& sReset = m_vecResets[i];
+         DumpTimingHumanReadable(m_cOutFile,
+                                 sReset.Name + " reset",
+                                 sReset.GetTotal(),
+                                 sReset.GetMin(),
+                                 sReset.GetMean(),
+                                 sReset.GetPercentile(0.99),
+                                 "reset");
+      }
+      for(size_t i = 0; i < m_vecThreads.size(); ++i) {
+         m_cOutFile << std::endl << "[thread #" << i << " idle at barrier]" << std::endl << std::endl;
+         for(size_t j = 0; j < PHASE_NUM; ++j) {
+            m_cOutFile << PHASE_NAMES[j] << ": " << m_vecThreads[i].Idle[j] << std::endl;
+         }
+      }
    }
 
    /****************************************/
@@ -247,6 +550,165 @@ namespace argos {
          }
       }
       m_cOutFile << std::endl;
+      FlushPhasesAsTable();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   static void DumpTimingAsTableRow(std::ostream& c_os,
+                                    const std::string& str_label,
+                                    double f_total,
+                                    double f_min,
+                                    double f_mean,
+                                    double f_p99) {
+      c_os << str_label << " "
+           << f_total << " "
+           << f_min << " "
+           << f_mean << " "
+           << f_p99 << std::endl;
+   }
+
+   void CProfiler::FlushPhasesAsTable() {
+      for(size_t i = 0; i < m_vecPhases.size(); ++i) {
+         const STimingStats& sPhase = m_vecPhases[i];
+         DumpTimingAsTableRow(m_cOutFile,
+                              "phase_" + sPhase.Name,
+                              sPhase.GetTotal(),
+                              sPhase.GetMin(),
+                              sPhase.GetMean(),
+                              sPhase.GetPercentile(0.99));
+      }
+      for(size_t i = 0; i < m_vecPhysicsEngines.size(); ++i) {
+         const STimingStats& sEngine = m_vecPhysicsEngines[i];
+         DumpTimingAsTableRow(m_cOutFile,
+                              "engine_" + sEngine.Name,
+                              sEngine.GetTotal(),
+                              sEngine.GetMin(),
+                              sEngine.GetMean(),
+                              sEngine.GetPercentile(0.99));
+      }
+      for(size_t i = 0; i < m_vecMedia.size(); ++i) {
+         const STimingStats& sMedium = m_vecMedia[i];
+         DumpTimingAsTableRow(m_cOutFile,
+                              "medium_" + sMedium.Name,
+                              sMedium.GetTotal(),
+                              sMedium.GetMin(),
+                              sMedium.GetMean(),
+                              sMedium.GetPercentile(0.99));
+      }
+      for(size_t i = 0; i < m_vecResets.size(); ++i) {
+         const STimingStats& sReset = m_vecResets[i];
+         DumpTimingAsTableRow(m_cOutFile,
+                              "reset_" + sReset.Name,
+                              sReset.GetTotal(),
+                              sReset.GetMin(),
+                              sReset.GetMean(),
+                              sReset.GetPercentile(0.99));
+      }
+      for(size_t i = 0; i < m_vecThreads.size(); ++i) {
+         m_cOutFile << "idle_thread_" << i;
+         for(size_t j = 0; j < PHASE_NUM; ++j) {
+            m_cOutFile << " " << m_vecThreads[i].Idle[j];
+         }
+         m_cOutFile << std::endl;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CProfiler::FlushAsCSV() {
+      double fElapsedTime = TV2Sec(m_tWallClockEnd) - TV2Sec(m_tWallClockStart);
+      ::rusage tDiffResourceUsage = m_tResourceUsageEnd - m_tResourceUsageStart;
+      m_cOutFile << "scope,name,metric,value" << std::endl;
+      m_cOutFile << "overall,,wall_clock," << fElapsedTime << std::endl;
+      m_cOutFile << "overall,,cpu_usage," << CPUUsage(tDiffResourceUsage, fElapsedTime) << std::endl;
+      m_cOutFile << "overall,,user_time," << TV2Sec(tDiffResourceUsage.ru_utime) << std::endl;
+      m_cOutFile << "overall,,system_time," << TV2Sec(tDiffResourceUsage.ru_stime) << std::endl;
+      const std::vector<STimingStats>* pvecGroups[] = {
+         &m_vecPhases, &m_vecPhysicsEngines, &m_vecMedia, &m_vecResets
+      };
+      const char* pchScopes[] = { "phase", "physics_engine", "medium", "reset" };
+      for(size_t g = 0; g < 4; ++g) {
+         for(size_t i = 0; i < pvecGroups[g]->size(); ++i) {
+            const STimingStats& sTiming = (*pvecGroups[g])[i];
+            m_cOutFile << pchScopes[g] << "," << sTiming.Name << ",total," << sTiming.GetTotal() << std::endl;
+            m_cOutFile << pchScopes[g] << "," << sTiming.Name << ",min," << sTiming.GetMin() << std::endl;
+            m_cOutFile << pchScopes[g] << "," << sTiming.Name << ",mean," << sTiming.GetMean() << std::endl;
+            m_cOutFile << pchScopes[g] << "," << sTiming.Name << ",p99," << sTiming.GetPercentile(0.99) << std::endl;
+         }
+      }
+      for(size_t i = 0; i < m_vecThreadResourceUsage.size(); ++i) {
+         m_cOutFile << "thread," << i << ",cpu_usage,"
+                    << CPUUsage(m_vecThreadResourceUsage[i], fElapsedTime) << std::endl;
+      }
+      for(size_t i = 0; i < m_vecThreads.size(); ++i) {
+         for(size_t j = 0; j < PHASE_NUM; ++j) {
+            m_cOutFile << "thread," << i << ",idle_" << PHASE_NAMES[j] << ","
+                       << m_vecThreads[i].Idle[j] << std::endl;
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   static void DumpTimingAsJSON(std::ostream& c_os,
+                                const std::string& str_indent,
+                                const std::string& str_name,
+                                double f_total,
+                                double f_min,
+                                double f_mean,
+                                double f_p99) {
+      c_os << str_indent << "\"" << JSONEscape(str_name) << "\": { "
+           << "\"total\": " << f_total << ", "
+           << "\"min\": " << f_min << ", "
+           << "\"mean\": " << f_mean << ", "
+           << "\"p99\": " << f_p99 << " }";
+   }
+
+   void CProfiler::FlushAsJSON() {
+      double fElapsedTime = TV2Sec(m_tWallClockEnd) - TV2Sec(m_tWallClockStart);
+      ::rusage tDiffResourceUsage = m_tResourceUsageEnd - m_tResourceUsageStart;
+      m_cOutFile << "{" << std::endl;
+      m_cOutFile << "  \"wall_clock\": " << fElapsedTime << "," << std::endl;
+      m_cOutFile << "  \"cpu_usage\": " << CPUUsage(tDiffResourceUsage, fElapsedTime) << "," << std::endl;
+      m_cOutFile << "  \"user_time\": " << TV2Sec(tDiffResourceUsage.ru_utime) << "," << std::endl;
+      m_cOutFile << "  \"system_time\": " << TV2Sec(tDiffResourceUsage.ru_stime) << "," << std::endl;
+      const std::vector<STimingStats>* pvecGroups[] = {
+         &m_vecPhases, &m_vecPhysicsEngines, &m_vecMedia, &m_vecResets
+      };
+      const char* pchGroups[] = { "phases", "physics_engines", "media", "resets" };
+      for(size_t g = 0; g < 4; ++g) {
+         m_cOutFile << "  \"" << pchGroups[g] << "\": {";
+         for(size_t i = 0; i < pvecGroups[g]->size(); ++i) {
+            const STimingStats& sTiming = (*pvecGroups[g])[i];
+            m_cOutFile << (i > 0 ? "," : "") << std::endl;
+            DumpTimingAsJSON(m_cOutFile, "    ",
+                             sTiming.Name,
+                             sTiming.GetTotal(),
+                             sTiming.GetMin(),
+                             sTiming.GetMean(),
+                             sTiming.GetPercentile(0.99));
+         }
+         m_cOutFile << std::endl << "  }," << std::endl;
+      }
+      m_cOutFile << "  \"threads\": [";
+      for(size_t i = 0; i < m_vecThreads.size(); ++i) {
+         m_cOutFile << (i > 0 ? "," : "") << std::endl << "    { ";
+         if(i < m_vecThreadResourceUsage.size()) {
+            m_cOutFile << "\"cpu_usage\": "
+                       << CPUUsage(m_vecThreadResourceUsage[i], fElapsedTime) << ", ";
+         }
+         m_cOutFile << "\"idle\": { ";
+         for(size_t j = 0; j < PHASE_NUM; ++j) {
+            m_cOutFile << (j > 0 ? ", " : "")
+                       << "\"" << PHASE_NAMES[j] << "\": " << m_vecThreads[i].Idle[j];
+         }
+         m_cOutFile << " } }";
+      }
+      m_cOutFile << std::endl << "  ]" << std::endl << "}" << std::endl;
    }
 
    /****************************************/
@@ -19,6 +19,31 @@ namespace argos {
 
    class CProfiler {
 
+   public:
+
+      /**
+       * The output formats of the profiler.
+       */
+      enum EFormat {
+         FORMAT_HUMAN_READABLE = 0,
+         FORMAT_TABLE,
+         FORMAT_CSV,
+         FORMAT_JSON
+      };
+
+      /**
+       * The phases of a simulation step, as executed by CSpace::Update().
+       */
+      enum EPhase {
+         PHASE_ACT = 0,
+         PHASE_PHYSICS,
+         PHASE_MEDIA,
+         PHASE_PRESTEP,
+         PHASE_SENSE_CONTROL,
+         PHASE_POSTSTEP,
+         PHASE_NUM
+      };
+
    public:
 
       CProfiler(const std::string& str_file_name,
@@ -28,8 +53,118 @@ namespace argos {
       void Start();
       void Stop();
       void Flush(bool b_human_readable);
+      void Flush(EFormat e_format);
       void CollectThreadResourceUsage();
 
+      /**
+       * Sets up the per-phase timing collection.
+       * Must be called before Start().
+       * @param un_num_threads The number of slave threads (0 if none).
+       * @param vec_physics_engines The ids of the physics engines.
+       * @param vec_media The ids of the media.
+       */
+      void InitPhaseProfiling(size_t un_num_threads,
+                              const std::vector<std::string>& vec_physics_engines,
+                              const std::vector<std::string>& vec_media);
+
+      /**
+       * Marks the beginning of a phase.
+       * Called by the main thread.
+       */
+      void StartPhase(EPhase e_phase);
+
+      /**
+       * Marks the end of the phase started by StartPhase().
+       * Called by the main thread, when all the slave threads are done.
+       */
+      void StopPhase();
+
+      /**
+       * Marks the end of a barrier of the slave threads within the current phase.
+       * A phase can have several barriers, e.g., the physics phase when the
+       * space also updates the physics models. Called by the main thread,
+       * when all the slave threads are done.
+       */
+      void StopSubPhase();
+
+      /**
+       * Records that a slave thread is done with the current phase.
+       * The time between this call and the following StopSubPhase() or
+       * StopPhase() is accounted as time spent by the thread idling at the
+       * barrier.
+       * @param un_thread The id of the slave thread.
+       */
+      void CollectThreadPhaseDone(size_t un_thread);
+
+      /**
+       * Records the time spent updating a physics engine in this step.
+       * @param un_engine The index of the physics engine.
+       * @param f_time The time in seconds.
+       */
+      void CollectPhysicsEngineTime(size_t un_engine, double f_time);
+
+      /**
+       * Records the time spent updating a medium in this step.
+       * @param un_medium The index of the medium.
+       * @param f_time The time in seconds.
+       */
+      void CollectMediumTime(size_t un_medium, double f_time);
+
+      /**
+       * Records the time spent resetting the experiment.
+       * @param str_kind The kind of reset, e.g., "fast" or "full".
+       * @param f_time The time in seconds.
+       */
+      void CollectResetTime(const std::string& str_kind, double f_time);
+
+      /**
+       * Returns the current time of a monotonic clock, in seconds.
+       */
+      static double GetTime();
+
+   private:
+
+      /**
+       * The running statistics of the per-step timings of a phase, physics
+       * engine, or medium.
+       * The memory used does not depend on the number of samples: the
+       * percentiles are estimated from a histogram with logarithmic bins,
+       * whose relative error is below 5%.
+       */
+      struct STimingStats {
+         /** Number of histogram bins per doubling of the time */
+         static const size_t BINS_PER_OCTAVE = 16;
+         /** Number of doublings covered by the histogram, from 1ns on */
+         static const size_t OCTAVES = 40;
+
+         std::string Name;
+         size_t Count;
+         double Total;
+         double Min;
+         double Max;
+         std::vector<size_t> Histogram;
+
+         STimingStats(const std::string& str_name = "");
+
+         void Add(double f_sample);
+         double GetTotal() const;
+         double GetMin() const;
+         double GetMean() const;
+         double GetPercentile(double f_percentile) const;
+      };
+
+      /**
+       * The timing data of a slave thread.
+       * Each structure is written only by its thread, and it is aligned to
+       * a cache line to avoid false sharing.
+       */
+      struct alignas(64) SThreadTiming {
+         double PhaseDone;
+         double Idle[PHASE_NUM];
+
+         SThreadTiming();
+      };
+
    private:
 
       void StartWallClock();
@@ -40,6 +175,11 @@ namespace argos {
 
       void FlushHumanReadable();
       void FlushAsTable();
+      void FlushAsCSV();
+      void FlushAsJSON();
+
+      void FlushPhasesHumanReadable();
+      void FlushPhasesAsTable();
 
    private:
 
@@ -51,6 +191,25 @@ namespace argos {
       std::vector< ::rusage > m_vecThreadResourceUsage;
       pthread_mutex_t m_tThreadResourceUsageMutex;
 
+      /** The per-step duration of each phase */
+      std::vector<STimingStats> m_vecPhases;
+      /** The per-step update time of each physics engine */
+      std::vector<STimingStats> m_vecPhysicsEngines;
+      /** The per-step update time of each medium */
+      std::vector<STimingStats> m_vecMedia;
+      /** The duration of each reset, per kind of reset */
+      std::vector<STimingStats> m_vecResets;
+      /** The timing data of each slave thread */
+      std::vector<SThreadTiming> m_vecThreads;
+      /** The phase being executed */
+      EPhase m_eCurrentPhase;
+      /** When the phase being executed was started */
+      double m_fCurrentPhaseStart;
+      /** When the last barrier of the phase being executed was passed */
+      double m_fCurrentSubPhaseStart;
+      /** Whether a phase is being executed */
+      bool m_bPhaseRunning;
+
    };
 
 }
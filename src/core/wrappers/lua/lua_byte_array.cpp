@@ -0,0 +1,175 @@
+/**
+ * @file <argos3/core/wrappers/lua/lua_byte_array.cpp>
+ */
+
+#include "lua_byte_array.h"
+
+#include <argos3/core/wrappers/lua/lua_utility.h>
+
+#include <sstream>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   const std::string CLuaByteArray::m_strTypeId("argos3.byte_array");
+
+   /****************************************/
+   /****************************************/
+
+   void CLuaByteArray::RegisterType(lua_State* pt_state) {
+      /* create a metatable for byte arrays */
+      luaL_newmetatable(pt_state, m_strTypeId.c_str());
+      /* register metamethods */
+      CLuaUtility::AddToTable(pt_state, "__index", Index);
+      CLuaUtility::AddToTable(pt_state, "__newindex", NewIndex);
+      CLuaUtility::AddToTable(pt_state, "__len", Length);
+      CLuaUtility::AddToTable(pt_state, "__pairs", Pairs);
+      CLuaUtility::AddToTable(pt_state, "__tostring", ToString);
+      CLuaUtility::AddToTable(pt_state, "__eq", Equal);
+      CLuaUtility::AddToTable(pt_state, "__gc", GarbageCollect);
+      lua_pop(pt_state, 1);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLuaByteArray::SetInTable(lua_State* pt_state,
+                                  int n_key,
+                                  const CByteArray& c_data) {
+      CLuaUtility::PushInternedKey(pt_state, n_key);
+      lua_rawget(pt_state, -2);
+      void* pvUserdatum =
+         luaL_testudata(pt_state, -1, m_strTypeId.c_str());
+      lua_pop(pt_state, 1);
+      if(pvUserdatum != nullptr) {
+         /* the byte array is still referenced by the table, reuse its buffer */
+         *static_cast<CByteArray*>(pvUserdatum) = c_data;
+      }
+      else {
+         CLuaUtility::PushInternedKey(pt_state, n_key);
+         PushByteArray(pt_state, c_data);
+         lua_rawset(pt_state, -3);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CByteArray& CLuaByteArray::ToByteArray(lua_State* pt_state,
+                                          int n_index) {
+      /* check type */
+      void* pvUserdatum =
+         luaL_checkudata(pt_state, n_index, m_strTypeId.c_str());
+      /* raise error if required */
+      if(pvUserdatum == nullptr) {
+         lua_pushstring(pt_state, "byte_array not found at requested index");
+         lua_error(pt_state);
+      }
+      /* return byte array */
+      CByteArray* pcByteArray = static_cast<CByteArray*>(pvUserdatum);
+      return *pcByteArray;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   int CLuaByteArray::Index(lua_State* pt_state) {
+      const CByteArray& cByteArray = ToByteArray(pt_state, 1);
+      if(lua_isinteger(pt_state, 2)) {
+         lua_Integer nIndex = lua_tointeger(pt_state, 2);
+         /* like in tables, the elements are indexed from one and missing elements are nil */
+         if(nIndex >= 1 && static_cast<size_t>(nIndex) <= cByteArray.Size()) {
+            lua_pushnumber(pt_state, cByteArray[nIndex - 1]);
+         }
+         else {
+            lua_pushnil(pt_state);
+         }
+         return 1;
+      }
+      lua_pushnil(pt_state);
+      return 1;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   int CLuaByteArray::NewIndex(lua_State* pt_state) {
+      lua_pushstring(pt_state, "byte_array is read-only");
+      lua_error(pt_state);
+      return 0;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   int CLuaByteArray::Length(lua_State* pt_state) {
+      lua_pushinteger(pt_state, ToByteArray(pt_state, 1).Size());
+      return 1;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   int CLuaByteArray::Pairs(lua_State* pt_state) {
+      ToByteArray(pt_state, 1);
+      lua_pushcfunction(pt_state, Next);
+      lua_pushvalue(pt_state, 1);
+      lua_pushinteger(pt_state, 0);
+      return 3;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   int CLuaByteArray::Next(lua_State* pt_state) {
+      const CByteArray& cByteArray = ToByteArray(pt_state, 1);
+      lua_Integer nIndex = luaL_optinteger(pt_state, 2, 0) + 1;
+      if(nIndex >= 1 && static_cast<size_t>(nIndex) <= cByteArray.Size()) {
+         lua_pushinteger(pt_state, nIndex);
+         lua_pushnumber(pt_state, cByteArray[nIndex - 1]);
+         return 2;
+      }
+      lua_pushnil(pt_state);
+      return 1;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   int CLuaByteArray::ToString(lua_State* pt_state) {
+      /* get a reference to the operand from the stack */
+      const CByteArray& cByteArray = ToByteArray(pt_state, 1);
+      /* convert it to a string */
+      std::ostringstream ossOutput;
+      ossOutput << cByteArray;
+      /* push the string onto the stack and return it */
+      lua_pushstring(pt_state, ossOutput.str().c_str());
+      return 1;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   int CLuaByteArray::Equal(lua_State* pt_state) {
+      bool bEqual =
+         (ToByteArray(pt_state, 1) == ToByteArray(pt_state, 2));
+      /* push the result onto the stack and return it */
+      lua_pushboolean(pt_state, bEqual);
+      return 1;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   int CLuaByteArray::GarbageCollect(lua_State* pt_state) {
+      /* run the destructor to release the buffer */
+      ToByteArray(pt_state, 1).~CByteArray();
+      return 0;
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
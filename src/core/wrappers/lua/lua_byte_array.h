@@ -0,0 +1,92 @@
+#ifndef LUA_BYTE_ARRAY_H
+#define LUA_BYTE_ARRAY_H
+
+/**
+ * @file <argos3/core/wrappers/lua/lua_byte_array.h>
+ */
+
+extern "C" {
+#include <lua.h>
+#include <lualib.h>
+#include <lauxlib.h>
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+#include <argos3/core/utility/datatypes/byte_array.h>
+
+#include <string>
+#include <utility>
+
+namespace argos {
+
+   /**
+    * A read-only view of a byte array in Lua.
+    * The view behaves like an array of numbers: it supports indexing, the
+    * length operator, ipairs() and pairs(). It is used to expose large
+    * payloads to the scripts without creating a table entry per byte.
+    * The sensors use it only if reading reuse is enabled in the Lua state.
+    * @see CLuaUtility::SetReuseReadings()
+    */
+   class CLuaByteArray {
+
+   public:
+
+      static void RegisterType(lua_State* pt_state);
+
+      static const std::string& GetTypeId() {
+         return m_strTypeId;
+      }
+
+      template<class... TArguments>
+      static void PushByteArray(lua_State* pt_state, TArguments&&... t_arguments) {
+         /* allocate memory for a CByteArray */
+         void* pvUserdatum =
+            lua_newuserdata(pt_state, sizeof(CByteArray));
+         /* run the constructor on the allocated memory */
+         new (pvUserdatum) CByteArray(std::forward<TArguments>(t_arguments)...);
+         /* set the metatable for the userdatum */
+         luaL_getmetatable(pt_state, m_strTypeId.c_str());
+         lua_setmetatable(pt_state, -2);
+      }
+
+      /**
+       * Sets a byte array with the given string key in the table located at the top of the stack.
+       * If the table already contains a byte array with that key, its content is
+       * overwritten, which does not allocate memory once the buffer is large enough.
+       * At the end of the execution, the stack is in the same state as it was
+       * before this function was called.
+       * @param pt_state The Lua state.
+       * @param n_key The reference to the key, as returned by CLuaUtility::InternKey().
+       * @param c_data The data to set.
+       */
+      static void SetInTable(lua_State* pt_state,
+                             int n_key,
+                             const CByteArray& c_data);
+
+      static CByteArray& ToByteArray(lua_State* pt_state, int n_index);
+
+      static int Index(lua_State* pt_state);
+
+      static int NewIndex(lua_State* pt_state);
+
+      static int Length(lua_State* pt_state);
+
+      static int Pairs(lua_State* pt_state);
+
+      static int Next(lua_State* pt_state);
+
+      static int ToString(lua_State* pt_state);
+
+      static int Equal(lua_State* pt_state);
+
+      static int GarbageCollect(lua_State* pt_state);
+
+   private:
+
+      static const std::string m_strTypeId;
+
+   };
+
+}
+
+#endif
@@ -7,11 +7,17 @@
 #include "lua_controller.h"
 #include <argos3/core/utility/logging/argos_log.h>
 
+#include <argos3/core/wrappers/lua/lua_byte_array.h>
 #include <argos3/core/wrappers/lua/lua_quaternion.h>
 #include <argos3/core/wrappers/lua/lua_utility.h>
 #include <argos3/core/wrappers/lua/lua_vector2.h>
 #include <argos3/core/wrappers/lua/lua_vector3.h>
 
+#ifdef ARGOS_simulator_BUILD
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#endif
+
 namespace argos {
 
    /****************************************/
@@ -19,8 +25,14 @@ namespace argos {
 
    CLuaController::CLuaController() :
       m_ptLuaState(NULL),
+      m_psSharedState(NULL),
+      m_nEnvironment(LUA_NOREF),
+      m_nRobotTable(LUA_NOREF),
       m_bScriptActive(false),
       m_bIsOK(true),
+      m_bSharedState(false),
+      m_unThreadIndex(0),
+      m_bReuseReadings(false),
       m_pcRNG(NULL) {
    }
 
@@ -40,13 +52,27 @@ namespace argos {
          /* Load script */
          std::string strScriptFileName;
          GetNodeAttributeOrDefault(t_tree, "script", strScriptFileName, strScriptFileName);
+         GetNodeAttributeOrDefault(t_tree, "shared_state", m_bSharedState, m_bSharedState);
+         GetNodeAttributeOrDefault(t_tree, "reuse_readings", m_bReuseReadings, m_bReuseReadings);
          if(strScriptFileName != "") {
+            if(m_bSharedState) {
+#ifdef ARGOS_simulator_BUILD
+               /* Each shared state belongs to a space thread, so a robot must not change thread */
+               if(!CSimulator::GetInstance().GetSpace().HasStaticControllableEntityAssignment()) {
+                  THROW_ARGOSEXCEPTION("Lua controllers with shared_state=\"true\" require the \"balance_quantity\" threading method");
+               }
+#endif
+               /* Host the robot in the state of the thread that will step it */
+               JoinSharedState();
+            }
             SetLuaScript(strScriptFileName, t_tree);
             if(! m_bIsOK) {
                THROW_ARGOSEXCEPTION("Error setting Lua script");
             }
          }
          else {
+            /* Without a script, the robot has its own state */
+            m_bSharedState = false;
             /* Create a new Lua stack */
             m_ptLuaState = luaL_newstate();
             /* Load the Lua libraries */
@@ -65,11 +91,22 @@ namespace argos {
    /****************************************/
 
    void CLuaController::ControlStep() {
+#ifdef ARGOS_simulator_BUILD
+      if(m_psSharedState != NULL && m_bIsOK &&
+         m_unThreadIndex != CSpace::GetThreadIndex()) {
+         /* The state is used without locks, so it must not be shared across threads */
+         m_strErrorMessage = "the robot was moved to another thread, which happens when robots are removed";
+         LOGERR << "[FATAL] Error stepping Lua robot \"" << GetId()
+                << "\": " << m_strErrorMessage << std::endl;
+         m_bIsOK = false;
+      }
+#endif
       if(m_bScriptActive && m_bIsOK) {
+         SelectRobot();
          /* Update Lua state through sensor readings */
          SensorReadingsToLuaState();
          /* Execute script step function */
-         if(! CLuaUtility::CallLuaFunction(m_ptLuaState, "step")) {
+         if(! CallLuaFunction("step")) {
             m_bIsOK = false;
          }
       }
@@ -81,7 +118,8 @@ namespace argos {
    void CLuaController::Reset() {
       if(m_bScriptActive) {
          if(m_bIsOK) {
-            m_bIsOK = CLuaUtility::CallLuaFunction(m_ptLuaState, "reset");
+            SelectRobot();
+            m_bIsOK = CallLuaFunction("reset");
          }
          else {
             SetLuaScript(m_strScriptFileName);
@@ -94,11 +132,21 @@ namespace argos {
 
    void CLuaController::Destroy() {
       if(m_bScriptActive && m_bIsOK) {
+         SelectRobot();
          /* Execute script destroy function */
-         CLuaUtility::CallLuaFunction(m_ptLuaState, "destroy");
+         CallLuaFunction("destroy");
+      }
+      if(m_psSharedState != NULL) {
+         /* Remove the robot from the shared Lua state */
+         ReleaseEnvironment();
+         CLuaStatePool::GetInstance().Release(*m_psSharedState);
+         m_psSharedState = NULL;
+         m_ptLuaState = NULL;
+      }
+      else if(m_ptLuaState != NULL) {
+         /* Close Lua */
+         lua_close(m_ptLuaState);
       }
-      /* Close Lua */
-      lua_close(m_ptLuaState);
    }
 
    /****************************************/
@@ -107,15 +155,23 @@ namespace argos {
    void CLuaController::SetLuaScript(const std::string& str_script,
                                      TConfigurationNode& t_tree) {
       /* First, delete old script */
+      if(m_psSharedState != NULL) {
+         /* Also done if the old script failed to load */
+         ReleaseEnvironment();
+      }
       if(m_bScriptActive) {
-         lua_close(m_ptLuaState);
+         if(m_psSharedState == NULL) {
+            lua_close(m_ptLuaState);
+         }
          m_bScriptActive = false;
          m_strScriptFileName = "";
       }
-      /* Create a new Lua stack */
-      m_ptLuaState = luaL_newstate();
-      /* Load the Lua libraries */
-      luaL_openlibs(m_ptLuaState);
+      if(m_psSharedState == NULL) {
+         /* Create a new Lua stack */
+         m_ptLuaState = luaL_newstate();
+         /* Load the Lua libraries */
+         luaL_openlibs(m_ptLuaState);
+      }
       /* Create and set variables */
       CreateLuaState();
       SensorReadingsToLuaState();
@@ -128,19 +184,56 @@ namespace argos {
       strPackagePath += (strScriptPath + "/?/init.lua;");
       lua_getglobal(m_ptLuaState, "package");
       lua_getfield(m_ptLuaState, -1, "path");
-      strPackagePath += lua_tostring(m_ptLuaState, -1);
+      std::string strCurrentPackagePath = lua_tostring(m_ptLuaState, -1);
       lua_pop(m_ptLuaState, 1);
-      lua_pushstring(m_ptLuaState, strPackagePath.c_str());
-      lua_setfield(m_ptLuaState, -2, "path");
+      /* In a shared state, the path might have been added by another robot */
+      if(strCurrentPackagePath.find(strPackagePath) == std::string::npos) {
+         strPackagePath += strCurrentPackagePath;
+         lua_pushstring(m_ptLuaState, strPackagePath.c_str());
+         lua_setfield(m_ptLuaState, -2, "path");
+      }
       lua_pop(m_ptLuaState, 1);
       /* Load script */
-      if(!CLuaUtility::LoadScript(m_ptLuaState, str_script)) {
+      if(m_psSharedState != NULL) {
+         /* Keep a reference to the robot table, which is made global when the robot is executed */
+         lua_getglobal(m_ptLuaState, "robot");
+         m_nRobotTable = luaL_ref(m_ptLuaState, LUA_REGISTRYINDEX);
+         /* Create the environment of the robot, which falls back to the global table */
+         lua_newtable(m_ptLuaState);
+         lua_rawgeti(m_ptLuaState, LUA_REGISTRYINDEX, m_nRobotTable);
+         lua_setfield(m_ptLuaState, -2, "robot");
+         lua_newtable(m_ptLuaState);
+         lua_pushglobaltable(m_ptLuaState);
+         lua_setfield(m_ptLuaState, -2, "__index");
+         lua_setmetatable(m_ptLuaState, -2);
+         m_nEnvironment = luaL_ref(m_ptLuaState, LUA_REGISTRYINDEX);
+         /* Execute the precompiled script in the environment of the robot */
+         if(!m_psSharedState->LoadChunk(str_script)) {
+            m_strErrorMessage = lua_tostring(m_ptLuaState, -1);
+            lua_pop(m_ptLuaState, 1);
+            m_bIsOK = false;
+            return;
+         }
+         lua_rawgeti(m_ptLuaState, LUA_REGISTRYINDEX, m_nEnvironment);
+         lua_setupvalue(m_ptLuaState, -2, 1);
+         if(lua_pcall(m_ptLuaState, 0, 0, 0)) {
+            LOGERR << "[FATAL] Error executing \"" << str_script
+                   << "\"" << std::endl;
+            LOGERR << "[FATAL] " << lua_tostring(m_ptLuaState, -1)
+                   << std::endl;
+            m_strErrorMessage = lua_tostring(m_ptLuaState, -1);
+            lua_pop(m_ptLuaState, 1);
+            m_bIsOK = false;
+            return;
+         }
+      }
+      else if(!CLuaUtility::LoadScript(m_ptLuaState, str_script)) {
          m_bIsOK = false;
          return;
       }
       m_strScriptFileName = str_script;
       /* Execute script init function */
-      if(!CLuaUtility::CallLuaFunction(m_ptLuaState, "init")) {
+      if(!CallLuaFunction("init")) {
          m_bIsOK = false;
          return;
       }
@@ -160,12 +253,16 @@ namespace argos {
    /****************************************/
 
    void CLuaController::CreateLuaState() {
-      /* Register functions */
-      CLuaUtility::RegisterLoggerWrapper(m_ptLuaState);
-      /* Register metatables */
-      CLuaVector2::RegisterType(m_ptLuaState);
-      CLuaVector3::RegisterType(m_ptLuaState);
-      CLuaQuaternion::RegisterType(m_ptLuaState);
+      /* A shared state already contains the functions and the metatables */
+      if(m_psSharedState == NULL) {
+         /* Register functions */
+         CLuaUtility::RegisterLoggerWrapper(m_ptLuaState);
+         /* Register metatables */
+         CLuaVector2::RegisterType(m_ptLuaState);
+         CLuaVector3::RegisterType(m_ptLuaState);
+         CLuaQuaternion::RegisterType(m_ptLuaState);
+         CLuaByteArray::RegisterType(m_ptLuaState);
+      }
       /* Create a table that will contain the state of the robot */
       lua_newtable(m_ptLuaState);
       /* Set the id of the robot */
@@ -193,6 +290,8 @@ namespace argos {
    /****************************************/
 
    void CLuaController::SensorReadingsToLuaState() {
+      /* A shared state can host robots with different settings */
+      CLuaUtility::SetReuseReadings(m_ptLuaState, m_bReuseReadings);
       /* Put the robot state table on top */
       lua_getglobal(m_ptLuaState, "robot");
       /* Go through the sensors */
@@ -233,6 +332,10 @@ namespace argos {
       if(m_bIsOK) {
          return "OK";
       }
+      else if(m_psSharedState != NULL) {
+         /* In a shared state, the stack does not belong to this robot */
+         return m_strErrorMessage;
+      }
       else {
          SInt32 i = 1;
          while(i <= lua_gettop(m_ptLuaState) && lua_type(m_ptLuaState, i) != LUA_TSTRING) {
@@ -247,6 +350,55 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CLuaController::JoinSharedState() {
+      /* The robot is always stepped by the same thread, which owns the state */
+#ifdef ARGOS_simulator_BUILD
+      m_unThreadIndex = CSimulator::GetInstance().GetSpace().GetThreadIndexOfNextControllableEntity();
+#endif
+      m_psSharedState = &CLuaStatePool::GetInstance().Acquire(m_unThreadIndex);
+      m_ptLuaState = m_psSharedState->State;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLuaController::SelectRobot() {
+      /* The functions of the devices look up the global robot table */
+      if(m_nRobotTable != LUA_NOREF) {
+         lua_rawgeti(m_ptLuaState, LUA_REGISTRYINDEX, m_nRobotTable);
+         lua_setglobal(m_ptLuaState, "robot");
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CLuaController::CallLuaFunction(const std::string& str_function) {
+      if(m_psSharedState == NULL) {
+         return CLuaUtility::CallLuaFunction(m_ptLuaState, str_function);
+      }
+      if(CLuaUtility::CallLuaFunction(m_ptLuaState, str_function, m_nEnvironment)) {
+         return true;
+      }
+      /* Keep the error message, the stack is shared with the other robots */
+      m_strErrorMessage = lua_tostring(m_ptLuaState, -1);
+      lua_pop(m_ptLuaState, 1);
+      return false;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLuaController::ReleaseEnvironment() {
+      luaL_unref(m_ptLuaState, LUA_REGISTRYINDEX, m_nEnvironment);
+      luaL_unref(m_ptLuaState, LUA_REGISTRYINDEX, m_nRobotTable);
+      m_nEnvironment = LUA_NOREF;
+      m_nRobotTable = LUA_NOREF;
+   }
+
+   /****************************************/
+   /****************************************/
+
    REGISTER_CONTROLLER(CLuaController, "lua_controller");
 
 }
@@ -6,6 +6,7 @@
 
 #include <argos3/core/control_interface/ci_controller.h>
 #include <argos3/core/utility/math/rng.h>
+#include <argos3/core/wrappers/lua/lua_state_pool.h>
 
 extern "C" {
 #include <lua.h>
@@ -13,6 +14,34 @@ extern "C" {
 
 namespace argos {
 
+   /**
+    * A controller that executes a Lua script.
+    * By default, each robot has its own Lua state. If the parameters contain
+    * <tt>shared_state="true"</tt>, the robots are instead hosted in a pool of
+    * Lua states, one per space thread. In a shared state, each robot executes
+    * its script in its own environment table, while the standard libraries and
+    * the modules loaded with <tt>require</tt> are shared.
+    * <p>
+    * A shared state is only used by the thread it belongs to, so it is not
+    * locked. In Init(), the script of a robot is loaded in the state of the
+    * thread that will step the robot, and the robot must be stepped by that
+    * thread from then on. Shared states therefore require the
+    * <tt>balance_quantity</tt> threading method, and a robot stops with an
+    * error if removing robots moves it to another thread.
+    * </p>
+    * <p>
+    * By default, the sensor readings are written into new tables at every
+    * step. If the parameters contain <tt>reuse_readings="true"</tt>, the tables
+    * of the last step are updated in place and the range and bearing payloads
+    * are exposed as read-only byte array views instead of tables of numbers.
+    * This avoids most of the allocations, but a script that keeps a reference
+    * to a reading across steps sees it change, and a payload is no longer a
+    * table (indexing, <tt>#</tt>, <tt>ipairs()</tt> and <tt>pairs()</tt> still
+    * work).
+    * </p>
+    * @see CLuaStatePool
+    * @see CLuaByteArray
+    */
    class CLuaController : public CCI_Controller {
 
    public:
@@ -50,12 +79,40 @@ namespace argos {
 
       std::string GetErrorMessage();
 
+   private:
+
+      /**
+       * Hosts the robot in the shared Lua state of the thread that will step it.
+       */
+      void JoinSharedState();
+
+      /**
+       * Makes <tt>robot</tt> refer to this robot in a shared Lua state.
+       * If the robot has its own Lua state, nothing is done.
+       */
+      void SelectRobot();
+
+      bool CallLuaFunction(const std::string& str_function);
+
+      void ReleaseEnvironment();
+
    private:
 
       lua_State* m_ptLuaState;
+      /* the shared state hosting the robot, or NULL if the robot has its own state */
+      CLuaStatePool::SState* m_psSharedState;
+      /* registry references to the environment and the robot table in the shared state */
+      int m_nEnvironment;
+      int m_nRobotTable;
+      std::string m_strErrorMessage;
       std::string m_strScriptFileName;
       bool m_bScriptActive;
       bool m_bIsOK;
+      /* whether the robot is hosted in a shared state */
+      bool m_bSharedState;
+      /* the index of the space thread owning the shared state */
+      UInt32 m_unThreadIndex;
+      bool m_bReuseReadings;
       CRandom::CRNG* m_pcRNG;
 
    };
@@ -0,0 +1,144 @@
+/**
+ * @file <argos3/core/wrappers/lua/lua_state_pool.cpp>
+ */
+
+#include "lua_state_pool.h"
+
+#include <argos3/core/utility/logging/argos_log.h>
+#include <argos3/core/wrappers/lua/lua_byte_array.h>
+#include <argos3/core/wrappers/lua/lua_quaternion.h>
+#include <argos3/core/wrappers/lua/lua_utility.h>
+#include <argos3/core/wrappers/lua/lua_vector2.h>
+#include <argos3/core/wrappers/lua/lua_vector3.h>
+
+#include <fstream>
+#include <sstream>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   static int WriteChunk(lua_State* pt_state,
+                         const void* pv_data,
+                         size_t un_size,
+                         void* pv_chunk) {
+      static_cast<std::string*>(pv_chunk)->append(static_cast<const char*>(pv_data), un_size);
+      return 0;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CLuaStatePool::SState::SState() :
+      State(luaL_newstate()),
+      Users(0) {
+      /* Load the Lua libraries */
+      luaL_openlibs(State);
+      /* Register the functions and the metatables shared by all the robots */
+      CLuaUtility::RegisterLoggerWrapper(State);
+      CLuaVector2::RegisterType(State);
+      CLuaVector3::RegisterType(State);
+      CLuaQuaternion::RegisterType(State);
+      CLuaByteArray::RegisterType(State);
+      lua_settop(State, 0);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CLuaStatePool::SState::~SState() {
+      lua_close(State);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CLuaStatePool::SState::LoadChunk(const std::string& str_filename) {
+      /* Read the script, so that changes to the file are detected */
+      std::ifstream cFile(str_filename.c_str(), std::ios::binary);
+      if(!cFile) {
+         LOGERR << "[FATAL] Error loading \"" << str_filename
+                << "\"" << std::endl;
+         lua_pushfstring(State, "cannot open %s", str_filename.c_str());
+         return false;
+      }
+      std::ostringstream ossSource;
+      ossSource << cFile.rdbuf();
+      std::string strChunkName = "@" + str_filename;
+      SChunk& sChunk = m_mapChunks[str_filename];
+      if(sChunk.Bytecode.empty() || sChunk.Source != ossSource.str()) {
+         /* Compile the script and keep its bytecode */
+         sChunk.Source = ossSource.str();
+         sChunk.Bytecode.clear();
+         if(luaL_loadbuffer(State,
+                            sChunk.Source.data(),
+                            sChunk.Source.size(),
+                            strChunkName.c_str())) {
+            LOGERR << "[FATAL] Error loading \"" << str_filename
+                   << "\"" << std::endl;
+            LOGERR << "[FATAL] " << lua_tostring(State, -1)
+                   << std::endl;
+            m_mapChunks.erase(str_filename);
+            return false;
+         }
+         lua_dump(State, WriteChunk, &sChunk.Bytecode, 0);
+         return true;
+      }
+      /* Instantiate the precompiled chunk */
+      if(luaL_loadbuffer(State,
+                         sChunk.Bytecode.data(),
+                         sChunk.Bytecode.size(),
+                         strChunkName.c_str())) {
+         LOGERR << "[FATAL] Error loading \"" << str_filename
+                << "\"" << std::endl;
+         LOGERR << "[FATAL] " << lua_tostring(State, -1)
+                << std::endl;
+         return false;
+      }
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CLuaStatePool& CLuaStatePool::GetInstance() {
+      static CLuaStatePool cInstance;
+      return cInstance;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CLuaStatePool::SState& CLuaStatePool::Acquire(size_t un_thread) {
+      std::lock_guard<std::mutex> cLock(m_cMutex);
+      if(m_vecStates.size() <= un_thread) {
+         m_vecStates.resize(un_thread + 1);
+      }
+      if(!m_vecStates[un_thread]) {
+         m_vecStates[un_thread].reset(new SState);
+      }
+      SState& sState = *m_vecStates[un_thread];
+      ++sState.Users;
+      return sState;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLuaStatePool::Release(SState& s_state) {
+      std::lock_guard<std::mutex> cLock(m_cMutex);
+      if(--s_state.Users == 0) {
+         /* Close the state */
+         for(std::unique_ptr<SState>& psState : m_vecStates) {
+            if(psState.get() == &s_state) {
+               psState.reset();
+            }
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
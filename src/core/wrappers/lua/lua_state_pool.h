@@ -0,0 +1,100 @@
+#ifndef LUA_STATE_POOL_H
+#define LUA_STATE_POOL_H
+
+/**
+ * @file <argos3/core/wrappers/lua/lua_state_pool.h>
+ */
+
+extern "C" {
+#include <lua.h>
+}
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace argos {
+
+   /**
+    * A pool of Lua states shared by the Lua controllers.
+    * Instead of creating a Lua state per robot, the controllers that request
+    * a shared state use the state of the space thread that steps them. In a
+    * shared state, each robot runs its script in its own environment table,
+    * which falls back to the global table for the standard libraries.
+    * @see CLuaController
+    */
+   class CLuaStatePool {
+
+   public:
+
+      /**
+       * A Lua state of the pool.
+       * The state is not locked, because it is only used by the thread it
+       * belongs to, or by the main thread while the space threads are idle.
+       */
+      struct SState {
+         lua_State* State;
+         size_t Users;
+
+         SState();
+
+         ~SState();
+
+         /**
+          * Pushes a new instance of the main chunk of the given script.
+          * The script is compiled the first time it is loaded and the
+          * resulting bytecode is reused as long as the file does not change.
+          * In case of errors, the error message is pushed instead.
+          * @param str_filename The script file name.
+          * @return <tt>false</tt> in case of errors, <tt>true</tt> otherwise.
+          */
+         bool LoadChunk(const std::string& str_filename);
+
+      private:
+
+         struct SChunk {
+            std::string Source;
+            std::string Bytecode;
+         };
+
+         std::map<std::string, SChunk> m_mapChunks;
+      };
+
+   public:
+
+      static CLuaStatePool& GetInstance();
+
+      /**
+       * Returns the state of the given space thread.
+       * The state is created if the thread does not have one yet.
+       * @param un_thread The index of the space thread.
+       * @return The state.
+       * @see CSpace::GetThreadIndex()
+       * @see Release()
+       */
+      SState& Acquire(size_t un_thread);
+
+      /**
+       * Releases a state acquired with Acquire().
+       * The state is closed when it has no users left.
+       * @param s_state The state.
+       * @see Acquire()
+       */
+      void Release(SState& s_state);
+
+   private:
+
+      CLuaStatePool() {}
+
+      /* protects the vector of states, which is changed when robots join or leave */
+      std::mutex m_cMutex;
+      /* the states indexed by space thread, empty for the threads without robots */
+      std::vector<std::unique_ptr<SState> > m_vecStates;
+
+   };
+
+}
+
+#endif
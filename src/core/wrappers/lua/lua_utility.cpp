@@ -215,6 +215,25 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   bool CLuaUtility::CallLuaFunction(lua_State* pt_state,
+                                     const std::string& str_function,
+                                     int n_environment) {
+      lua_rawgeti(pt_state, LUA_REGISTRYINDEX, n_environment);
+      lua_getfield(pt_state, -1, str_function.c_str());
+      lua_remove(pt_state, -2);
+      if(lua_pcall(pt_state, 0, 0, 0)) {
+         LOGERR << "[FATAL] Error calling \"" << str_function
+                << "\"" << std::endl;
+         LOGERR << "[FATAL] " << lua_tostring(pt_state, -1)
+                << std::endl;
+         return false;
+      }
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
    void PrintStackEntry(CARGoSLog& c_log, lua_State* pt_state, SInt32 n_index) {
       switch(lua_type(pt_state, n_index)) {
          case LUA_TBOOLEAN: c_log << lua_toboolean(pt_state, n_index); break;
@@ -372,6 +391,113 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CLuaUtility::OpenTable(lua_State* pt_state,
+                               const std::string& str_key) {
+      if(IsReusingReadings(pt_state)) {
+         lua_pushstring(pt_state, str_key.c_str());
+         lua_rawget(pt_state, -2);
+         if(lua_istable(pt_state, -1)) {
+            return;
+         }
+         lua_pop(pt_state, 1);
+      }
+      lua_newtable(pt_state);
+      lua_pushstring(pt_state, str_key.c_str());
+      lua_pushvalue(pt_state, -2);
+      lua_rawset(pt_state, -4);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLuaUtility::OpenTable(lua_State* pt_state,
+                               int n_key) {
+      if(IsReusingReadings(pt_state)) {
+         lua_rawgeti(pt_state, -1, n_key);
+         if(lua_istable(pt_state, -1)) {
+            return;
+         }
+         lua_pop(pt_state, 1);
+      }
+      lua_newtable(pt_state);
+      lua_pushvalue(pt_state, -1);
+      lua_rawseti(pt_state, -3, n_key);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   /* the address of this variable is the registry key of the reading reuse flag */
+   static const char REUSE_READINGS_KEY = 0;
+
+   void CLuaUtility::SetReuseReadings(lua_State* pt_state,
+                                      bool b_reuse) {
+      lua_pushboolean(pt_state, b_reuse);
+      lua_rawsetp(pt_state, LUA_REGISTRYINDEX, &REUSE_READINGS_KEY);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CLuaUtility::IsReusingReadings(lua_State* pt_state) {
+      lua_rawgetp(pt_state, LUA_REGISTRYINDEX, &REUSE_READINGS_KEY);
+      bool bReuse = lua_toboolean(pt_state, -1);
+      lua_pop(pt_state, 1);
+      return bReuse;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLuaUtility::CloseTable(lua_State* pt_state) {
+      lua_pop(pt_state, 1);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLuaUtility::TruncateTable(lua_State* pt_state,
+                                   size_t un_size) {
+      for(size_t i = lua_rawlen(pt_state, -1); i > un_size; --i) {
+         lua_pushnil(pt_state);
+         lua_rawseti(pt_state, -2, i);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLuaUtility::ClearTable(lua_State* pt_state) {
+      /* assigning nil to an existing field is allowed while traversing a table */
+      lua_pushnil(pt_state);
+      while(lua_next(pt_state, -2)) {
+         lua_pop(pt_state, 1);
+         lua_pushvalue(pt_state, -1);
+         lua_pushnil(pt_state);
+         lua_rawset(pt_state, -4);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   int CLuaUtility::InternKey(lua_State* pt_state,
+                              const std::string& str_key) {
+      lua_pushstring(pt_state, str_key.c_str());
+      return luaL_ref(pt_state, LUA_REGISTRYINDEX);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLuaUtility::PushInternedKey(lua_State* pt_state,
+                                     int n_key) {
+      lua_rawgeti(pt_state, LUA_REGISTRYINDEX, n_key);
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CLuaUtility::SetMetatable(lua_State* pt_state,
                                   const std::string& str_key) {
       luaL_getmetatable(pt_state, str_key.c_str());
@@ -578,6 +704,10 @@ namespace argos {
 
    int CLuaUtility::LoggerWrapper(CARGoSLog& c_log,
                                   lua_State* pt_state) {
+      /* Nothing to do if the log discards the message */
+      if(!c_log.IsActive()) {
+         return 0;
+      }
       /* Get number of arguments */
       UInt32 unArgc = lua_gettop(pt_state);
       /* Send arguments to log one by one */
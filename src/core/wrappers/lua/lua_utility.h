@@ -51,6 +51,19 @@ namespace argos {
       static bool CallLuaFunction(lua_State* pt_state,
                                   const std::string& str_function);
 
+      /**
+       * Calls a parameter-less function stored in an environment table.
+       * This is used when several scripts share the same Lua state, each one
+       * with its own environment.
+       * @param pt_state The Lua state.
+       * @param str_function The function name.
+       * @param n_environment The registry reference to the environment table.
+       * @return <tt>false</tt> in case of errors, <tt>true</tt> otherwise.
+       */
+      static bool CallLuaFunction(lua_State* pt_state,
+                                  const std::string& str_function,
+                                  int n_environment);
+
       /**
        * Prints the global Lua symbols on the specified log.
        * @param c_log The output log.
@@ -147,6 +160,105 @@ namespace argos {
        */
       static void EndTable(lua_State* pt_state);
 
+      /**
+       * Opens a table with the given string key in the table located at the top of the stack.
+       * If reading reuse is enabled in the Lua state, the table is reused if it already
+       * exists, so that readings can be updated without allocating new tables at every
+       * step. Otherwise, a new table is created, like StartTable() does.
+       * This method pushes the table itself on the stack.
+       * To close the table call CloseTable().
+       * @param pt_state The Lua state.
+       * @param str_key The string key for the parent table.
+       * @see CloseTable()
+       */
+      static void OpenTable(lua_State* pt_state,
+                            const std::string& str_key);
+
+      /**
+       * Opens a table with the given numeric key in the table located at the top of the stack.
+       * If reading reuse is enabled in the Lua state, the table is reused if it already
+       * exists, so that readings can be updated without allocating new tables at every
+       * step. Otherwise, a new table is created, like StartTable() does.
+       * This method pushes the table itself on the stack.
+       * To close the table call CloseTable().
+       * @param pt_state The Lua state.
+       * @param n_key The numeric key for the parent table.
+       * @see CloseTable()
+       */
+      static void OpenTable(lua_State* pt_state,
+                            int n_key);
+
+      /**
+       * Enables or disables reading reuse in the given Lua state.
+       * When reading reuse is enabled, OpenTable() updates the tables of the last
+       * update in place, and the sensors may expose their readings through views
+       * such as CLuaByteArray. A script that keeps a reference to a reading across
+       * steps then sees it change. Reading reuse is disabled by default.
+       * @param pt_state The Lua state.
+       * @param b_reuse <tt>true</tt> to enable reading reuse.
+       * @see IsReusingReadings()
+       */
+      static void SetReuseReadings(lua_State* pt_state,
+                                   bool b_reuse);
+
+      /**
+       * Returns <tt>true</tt> if reading reuse is enabled in the given Lua state.
+       * @param pt_state The Lua state.
+       * @return <tt>true</tt> if reading reuse is enabled.
+       * @see SetReuseReadings()
+       */
+      static bool IsReusingReadings(lua_State* pt_state);
+
+      /**
+       * Closes a table opened with OpenTable().
+       * This method expects the table itself to be at the top of the stack (-1).
+       * @param pt_state The Lua state.
+       * @see OpenTable()
+       */
+      static void CloseTable(lua_State* pt_state);
+
+      /**
+       * Removes the elements after the given size from the table located at the top of the stack.
+       * This method is used to remove the readings left over from the last update from
+       * a table that is being reused.
+       * At the end of the execution, the stack is in the same state as it was
+       * before this function was called.
+       * @param pt_state The Lua state.
+       * @param un_size The number of elements to keep.
+       */
+      static void TruncateTable(lua_State* pt_state,
+                                size_t un_size);
+
+      /**
+       * Removes all the entries from the table located at the top of the stack.
+       * At the end of the execution, the stack is in the same state as it was
+       * before this function was called.
+       * @param pt_state The Lua state.
+       */
+      static void ClearTable(lua_State* pt_state);
+
+      /**
+       * Interns a string key in the registry of the Lua state.
+       * The returned reference is pushed with PushInternedKey(), which is an
+       * array lookup in the registry and avoids constructing and hashing the
+       * key string at every update.
+       * @param pt_state The Lua state.
+       * @param str_key The string key.
+       * @return The reference to the interned key.
+       * @see PushInternedKey()
+       */
+      static int InternKey(lua_State* pt_state,
+                           const std::string& str_key);
+
+      /**
+       * Pushes a key interned with InternKey() on the stack.
+       * @param pt_state The Lua state.
+       * @param n_key The reference to the interned key.
+       * @see InternKey()
+       */
+      static void PushInternedKey(lua_State* pt_state,
+                                  int n_key);
+
 
       /**
        * Sets the metatable with the given string key to the table located at the top of the stack.
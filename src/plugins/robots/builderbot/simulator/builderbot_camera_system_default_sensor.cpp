@@ -41,19 +41,6 @@ namespace argos {
       m_bShowFrustum(false),
       m_bShowTagRays(false),
       m_bShowLEDRays(false) {
-      /* set up the project matrix */
-      m_cProjectionMatrix.SetIdentityMatrix();
-      m_cProjectionMatrix(0,0) = CAMERA_FOCAL_LENGTH_X;
-      m_cProjectionMatrix(1,1) = CAMERA_FOCAL_LENGTH_Y;
-      m_cProjectionMatrix(0,2) = CAMERA_PRINCIPAL_POINT_X;
-      m_cProjectionMatrix(1,2) = CAMERA_PRINCIPAL_POINT_Y;
-      /* calculate fustrum constants */
-      Real fWidthToDepthRatio = (0.5 * CAMERA_RESOLUTION_X) / CAMERA_FOCAL_LENGTH_X;
-      Real fHeightToDepthRatio = (0.5 * CAMERA_RESOLUTION_Y) / CAMERA_FOCAL_LENGTH_Y;
-      m_fNearPlaneHeight = fHeightToDepthRatio * CAMERA_RANGE_MIN;
-      m_fNearPlaneWidth = fWidthToDepthRatio * CAMERA_RANGE_MIN;
-      m_fFarPlaneHeight = fHeightToDepthRatio * CAMERA_RANGE_MAX;
-      m_fFarPlaneWidth = fWidthToDepthRatio * CAMERA_RANGE_MAX;
       /* set the resolution of the camera in the control interface */
       m_cResolution.Set(CAMERA_RESOLUTION_X, CAMERA_RESOLUTION_Y);
       /* set the offset from end effector anchor in the control interface */
@@ -63,8 +50,12 @@ namespace argos {
                                             0.00f * CRadians::PI);
       /* export the name of the anchor to the control interface */
       m_strAnchor.assign("end_effector");
-      /* transformation matrix */
-      m_cOffset.SetFromComponents(m_cOffsetOrientation, m_cOffsetPosition);
+      /* set up the camera */
+      m_cFrustum.SetIntrinsics(CVector2(CAMERA_FOCAL_LENGTH_X, CAMERA_FOCAL_LENGTH_Y),
+                               CVector2(CAMERA_PRINCIPAL_POINT_X, CAMERA_PRINCIPAL_POINT_Y),
+                               m_cResolution,
+                               CRange<Real>(CAMERA_RANGE_MIN, CAMERA_RANGE_MAX));
+      m_cFrustum.SetOffset(m_cOffsetOrientation, m_cOffsetPosition);
    }
 
    /****************************************/
@@ -123,107 +114,75 @@ namespace argos {
          /* get a reference to the checked rays for the controller */
          std::vector<std::pair<bool, CRay3> >& vecCheckedRays =
             m_pcControllableEntity->GetCheckedRays();
-         /* sensor parameters */
-         CTransformationMatrix3 cWorldToAnchorTransform;
-         CTransformationMatrix3 cWorldToCameraTransform;
-         CVector3 cLookAt, cUp;
-         CVector3 cX, cY, cZ;
-         CVector3 cNearCenter, cNearTopLeft, cNearTopRight, cNearBottomLeft, cNearBottomRight;
-         CVector3 cFarCenter, cFarTopLeft, cFarTopRight, cFarBottomLeft, cFarBottomRight;
-         CVector3 cBoundingBoxMinCorner, cBoundingBoxMaxCorner;
-         CVector3 cBoundingBoxPosition, cBoundingBoxHalfExtents;
-         /* calculate transform matrices */
-         cWorldToAnchorTransform.SetFromComponents(m_psEndEffectorAnchor->Orientation, m_psEndEffectorAnchor->Position);
-         cWorldToCameraTransform = cWorldToAnchorTransform * m_cOffset;
-         m_cCameraToWorldTransform = cWorldToCameraTransform.GetInverse();
-         /* calculate camera direction vectors */
-         m_cCameraPosition = cWorldToCameraTransform.GetTranslationVector();
-         m_cCameraOrientation = m_psEndEffectorAnchor->Orientation * m_cOffsetOrientation;
-
-         cLookAt = cWorldToCameraTransform * CVector3::Z;
-         cUp = -CVector3::Y;
-         cUp.Rotate(cWorldToCameraTransform.GetRotationMatrix());
-         /* calculate direction vectors */
-         cZ = m_cCameraPosition - cLookAt;
-         cZ.Normalize();
-         cX = cUp;
-         cX.CrossProduct(cZ);
-         cX.Normalize();
-         cY = cZ;
-         cY.CrossProduct(cX);
-         /* calculate frustum coordinates */
-         cNearCenter = m_cCameraPosition - cZ * CAMERA_RANGE_MIN;
-         cFarCenter = m_cCameraPosition - cZ * CAMERA_RANGE_MAX;
-         cNearTopLeft = cNearCenter + (cY * m_fNearPlaneHeight) - (cX * m_fNearPlaneWidth);
-         cNearTopRight = cNearCenter + (cY * m_fNearPlaneHeight) + (cX * m_fNearPlaneWidth);
-         cNearBottomLeft = cNearCenter - (cY * m_fNearPlaneHeight) - (cX * m_fNearPlaneWidth);
-         cNearBottomRight = cNearCenter - (cY * m_fNearPlaneHeight) + (cX * m_fNearPlaneWidth);
-         cFarTopLeft = cFarCenter + (cY * m_fFarPlaneHeight) - (cX * m_fFarPlaneWidth);
-         cFarTopRight = cFarCenter + (cY * m_fFarPlaneHeight) + (cX * m_fFarPlaneWidth);
-         cFarBottomLeft = cFarCenter - (cY * m_fFarPlaneHeight) - (cX * m_fFarPlaneWidth);
-         cFarBottomRight = cFarCenter - (cY * m_fFarPlaneHeight) + (cX * m_fFarPlaneWidth);
+         /* place the camera and calculate its frustum */
+         m_cFrustum.Update(*m_psEndEffectorAnchor);
          /* show frustum if enabled by adding outline to the checked rays vector */
          if(m_bShowFrustum) {
-            vecCheckedRays.emplace_back(false, CRay3(cNearTopLeft, cNearTopRight));
-            vecCheckedRays.emplace_back(false, CRay3(cNearTopRight, cNearBottomRight));
-            vecCheckedRays.emplace_back(false, CRay3(cNearBottomRight, cNearBottomLeft));
-            vecCheckedRays.emplace_back(false, CRay3(cNearBottomLeft, cNearTopLeft));
-            vecCheckedRays.emplace_back(false, CRay3(cFarTopLeft, cFarTopRight));
-            vecCheckedRays.emplace_back(false, CRay3(cFarTopRight, cFarBottomRight));
-            vecCheckedRays.emplace_back(false, CRay3(cFarBottomRight, cFarBottomLeft));
-            vecCheckedRays.emplace_back(false, CRay3(cFarBottomLeft, cFarTopLeft));
-            vecCheckedRays.emplace_back(false, CRay3(cNearTopLeft, cFarTopLeft));
-            vecCheckedRays.emplace_back(false, CRay3(cNearTopRight, cFarTopRight));
-            vecCheckedRays.emplace_back(false, CRay3(cNearBottomRight, cFarBottomRight));
-            vecCheckedRays.emplace_back(false, CRay3(cNearBottomLeft, cFarBottomLeft));
+            m_cFrustum.AddFrustumRays(vecCheckedRays);
          }
-         /* generate a bounding box for the frustum */
-         cBoundingBoxMinCorner = cNearCenter;
-         cBoundingBoxMaxCorner = cNearCenter;
-         for(const CVector3& c_point : {
-            cNearTopLeft, cNearTopRight, cNearBottomLeft, cNearBottomRight,
-            cFarTopLeft, cFarTopRight, cFarBottomLeft, cFarBottomRight
-         }) {
-            if(c_point.GetX() > cBoundingBoxMaxCorner.GetX()) {
-               cBoundingBoxMaxCorner.SetX(c_point.GetX());
+         /* collect the tags and the LEDs inside the frustum */
+         m_vecTagCandidates.clear();
+         m_vecLedCandidates.clear();
+         m_pcTagIndex->ForEntitiesInBoxRange(m_cFrustum.GetBoundingBoxPosition(),
+                                             m_cFrustum.GetBoundingBoxHalfExtents(),
+                                             *this);
+         m_pcDirectionalLEDIndex->ForEntitiesInBoxRange(m_cFrustum.GetBoundingBoxPosition(),
+                                                        m_cFrustum.GetBoundingBoxHalfExtents(),
+                                                        *this);
+         /* check the occlusions of all the candidates at once */
+         m_cFrustum.CheckOcclusions();
+         /* detect tags, a tag is detected only if none of its corners is occluded */
+         for(const STagCandidate& s_candidate : m_vecTagCandidates) {
+            bool bOccluded = false;
+            for(size_t i = 0; i < 4; ++i) {
+               bOccluded = m_cFrustum.IsOccluded(s_candidate.OcclusionCheck + i);
+               if(m_bShowTagRays) {
+                  vecCheckedRays.emplace_back(bOccluded,
+                                              m_cFrustum.GetOcclusionCheckRay(s_candidate.OcclusionCheck + i));
+               }
+               if(bOccluded) {
+                  break;
+               }
             }
-            if(c_point.GetX() < cBoundingBoxMinCorner.GetX()) {
-               cBoundingBoxMinCorner.SetX(c_point.GetX());
+            if(bOccluded) {
+               continue;
             }
-            if(c_point.GetY() > cBoundingBoxMaxCorner.GetY()) {
-               cBoundingBoxMaxCorner.SetY(c_point.GetY());
+            const CTagEntity& cTag = *s_candidate.Tag;
+            std::transform(std::begin(s_candidate.Corners),
+                           std::end(s_candidate.Corners),
+                           std::begin(m_arrTagCornerPixels),
+                           [this] (const CVector3& c_tag_corner) {
+               return m_cFrustum.ProjectOntoSensor(c_tag_corner);
+            });
+            const CVector2& cCenterPixel = m_cFrustum.ProjectOntoSensor(cTag.GetPosition());
+            /* try to convert tag payload to an unsigned integer */
+            UInt32 unId = 0;
+            try {
+               unId = std::stoul(cTag.GetPayload());
             }
-            if(c_point.GetY() < cBoundingBoxMinCorner.GetY()) {
-               cBoundingBoxMinCorner.SetY(c_point.GetY());
+            catch(const std::logic_error& err_logic) {
+               THROW_ARGOSEXCEPTION("Tag payload \"" << cTag.GetPayload() << "\" can not be converted to an unsigned integer");
             }
-            if(c_point.GetZ() > cBoundingBoxMaxCorner.GetZ()) {
-               cBoundingBoxMaxCorner.SetZ(c_point.GetZ());
+            CVector3 cTagPosition = m_cFrustum.ToCameraFrame(cTag.GetPosition());
+            /* Direction of the tag should be pointing inside of the tag */
+            CQuaternion cTagOrientation = m_cFrustum.GetOrientation().Inverse() * cTag.GetOrientation() * CQuaternion(CRadians::PI, CVector3::X);
+            /* transfer readings to the control interface */
+            m_tTags.emplace_back(unId, cTagPosition, cTagOrientation, cCenterPixel, m_arrTagCornerPixels);
+         }
+         /* detect directional LEDs */
+         for(const SLedCandidate& s_candidate : m_vecLedCandidates) {
+            bool bOccluded = m_cFrustum.IsOccluded(s_candidate.OcclusionCheck);
+            if(!bOccluded) {
+               const CVector3& cLedPosition = s_candidate.Led->GetPosition();
+               m_vecLedCache.emplace_back(s_candidate.Led->GetColor(),
+                                          cLedPosition,
+                                          m_cFrustum.ProjectOntoSensor(cLedPosition));
             }
-            if(c_point.GetZ() < cBoundingBoxMinCorner.GetZ()) {
-               cBoundingBoxMinCorner.SetZ(c_point.GetZ());
+            if(m_bShowLEDRays) {
+               vecCheckedRays.emplace_back(bOccluded,
+                                           m_cFrustum.GetOcclusionCheckRay(s_candidate.OcclusionCheck));
             }
          }
-         cBoundingBoxMaxCorner *= 0.5f;
-         cBoundingBoxMinCorner *= 0.5f;
-         cBoundingBoxPosition = (cBoundingBoxMaxCorner + cBoundingBoxMinCorner);
-         cBoundingBoxHalfExtents = (cBoundingBoxMaxCorner - cBoundingBoxMinCorner);
-         /* generate frustum planes */
-         m_arrFrustumPlanes[0].SetFromThreePoints(cNearTopRight, cNearTopLeft, cFarTopLeft);
-         m_arrFrustumPlanes[1].SetFromThreePoints(cNearBottomLeft, cNearBottomRight, cFarBottomRight);
-         m_arrFrustumPlanes[2].SetFromThreePoints(cNearTopLeft, cNearBottomLeft, cFarBottomLeft);
-         m_arrFrustumPlanes[3].SetFromThreePoints(cNearBottomRight, cNearTopRight, cFarBottomRight);
-         m_arrFrustumPlanes[4].SetFromThreePoints(cNearTopLeft, cNearTopRight, cNearBottomRight);
-         m_arrFrustumPlanes[5].SetFromThreePoints(cFarTopRight, cFarTopLeft, cFarBottomLeft);
-         /* set the start of the ray for checking occlusions to the camera's location */
-         m_cOcclusionCheckRay.SetStart(m_cCameraPosition);
-         /* detect tags */
-         m_pcTagIndex->ForEntitiesInBoxRange(cBoundingBoxPosition,
-                                             cBoundingBoxHalfExtents,
-                                             *this);
-         /* detect directional LEDs */
-         m_pcDirectionalLEDIndex->ForEntitiesInBoxRange(cBoundingBoxPosition,
-                                                        cBoundingBoxHalfExtents,
-                                                        *this);
       }
    }
 
@@ -241,7 +200,7 @@ namespace argos {
    /****************************************/
 
    bool CBuilderBotCameraSystemDefaultSensor::operator()(CTagEntity& c_tag) {
-      if(GetAngleWithCamera(c_tag) > c_tag.GetObservableAngle()) {
+      if(m_cFrustum.GetAngleWithCamera(c_tag) > c_tag.GetObservableAngle()) {
          return true;
       }
       std::transform(std::begin(m_arrTagCornerOffsets),
@@ -252,54 +211,17 @@ namespace argos {
          cCorner.Rotate(c_tag.GetOrientation());
          return (cCorner + c_tag.GetPosition());
       });
-      for(const CVector3& c_corner : m_arrTagCorners) {
-         if(IsInsideFrustum(c_corner) == false) {
-            /* no more checks necessary, move on to the next tag */
-            return true;
-         }
+      if(m_cFrustum.IsInsideFrustum(m_arrTagCorners) == false) {
+         /* no more checks necessary, move on to the next tag */
+         return true;
       }
+      /* occlusions are checked for all the candidates at once, see Update() */
+      CEntity& cEntityWithTag = c_tag.GetRootEntity();
+      size_t unOcclusionCheck = m_cFrustum.GetNumOcclusionChecks();
       for(const CVector3& c_corner : m_arrTagCorners) {
-         m_cOcclusionCheckRay.SetEnd(c_corner);
-         if(GetEmbodiedEntitiesIntersectedByRay(m_vecIntersections, m_cOcclusionCheckRay)) {
-            CEntity& cEntityWithTag = c_tag.GetRootEntity();
-            for(const SEmbodiedEntityIntersectionItem& s_item : m_vecIntersections) {
-               CEntity& cIntersectionEntity = s_item.IntersectedEntity->GetRootEntity();
-               if(&cIntersectionEntity != &cEntityWithTag) {
-                  /* corner is occluded */
-                  if(m_bShowTagRays) {
-                     m_pcControllableEntity->GetCheckedRays().emplace_back(true, m_cOcclusionCheckRay);
-                  }
-                  /* no more checks necessary, move on to the next tag */
-                  return true;
-               }
-            }
-         }
-         /* corner not occluded */
-         if(m_bShowTagRays) {
-            m_pcControllableEntity->GetCheckedRays().emplace_back(false, m_cOcclusionCheckRay);
-         }
+         m_cFrustum.AddOcclusionCheck(c_corner, &cEntityWithTag);
       }
-      std::transform(std::begin(m_arrTagCorners),
-                     std::end(m_arrTagCorners),
-                     std::begin(m_arrTagCornerPixels),
-                     [this] (const CVector3& c_tag_corner) {
-         return ProjectOntoSensor(c_tag_corner);
-      });
-      const CVector2& cCenterPixel = ProjectOntoSensor(c_tag.GetPosition());
-      /* try to convert tag payload to an unsigned integer */
-      UInt32 unId = 0;
-      try {
-         unId = std::stoul(c_tag.GetPayload());
-      }
-      catch(const std::logic_error& err_logic) {
-         THROW_ARGOSEXCEPTION("Tag payload \"" << c_tag.GetPayload() << "\" can not be converted to an unsigned integer");
-      }
-      /* TODO: Update the position and orientation calculations to avoid the use of matrices */
-      CVector3 cTagPosition = m_cCameraToWorldTransform * c_tag.GetPosition();
-      /* Direction of the tag should be pointing inside of the tag */
-      CQuaternion cTagOrientation = m_cCameraOrientation.Inverse() * c_tag.GetOrientation() * CQuaternion(CRadians::PI, CVector3::X);
-      /* transfer readings to the control interface */
-      m_tTags.emplace_back(unId, cTagPosition, cTagOrientation, cCenterPixel, m_arrTagCornerPixels);
+      m_vecTagCandidates.push_back(STagCandidate{&c_tag, m_arrTagCorners, unOcclusionCheck});
       return true;
    }
 
@@ -310,33 +232,17 @@ namespace argos {
       if(c_led.GetColor() == CColor::BLACK) {
          return true;
       }
-      if(GetAngleWithCamera(c_led) > c_led.GetObservableAngle()) {
+      if(m_cFrustum.GetAngleWithCamera(c_led) > c_led.GetObservableAngle()) {
          return true;
       }
       const CVector3& cLedPosition = c_led.GetPosition();
-      if(IsInsideFrustum(cLedPosition) == false) {
+      if(m_cFrustum.IsInsideFrustum(cLedPosition) == false) {
          return true;
       }
-      m_cOcclusionCheckRay.SetEnd(cLedPosition);
-      if(GetEmbodiedEntitiesIntersectedByRay(m_vecIntersections, m_cOcclusionCheckRay)) {
-         CEntity& cEntityWithTag = c_led.GetRootEntity();
-         for(const SEmbodiedEntityIntersectionItem& s_item : m_vecIntersections) {
-            CEntity& cIntersectionEntity = s_item.IntersectedEntity->GetRootEntity();
-            if(&cIntersectionEntity != &cEntityWithTag) {
-               /* led is occluded */
-               if(m_bShowLEDRays) {
-                  m_pcControllableEntity->GetCheckedRays().emplace_back(true, m_cOcclusionCheckRay);
-               }
-               return true;
-            }
-         }
-      }
-      /* led not occluded */
-      m_vecLedCache.emplace_back(c_led.GetColor(), cLedPosition, ProjectOntoSensor(cLedPosition));
-      if(m_bShowLEDRays) {
-         m_pcControllableEntity->GetCheckedRays().emplace_back(false, m_cOcclusionCheckRay);
-      }
-
+      /* occlusions are checked for all the candidates at once, see Update() */
+      size_t unOcclusionCheck =
+         m_cFrustum.AddOcclusionCheck(cLedPosition, &c_led.GetRootEntity());
+      m_vecLedCandidates.push_back(SLedCandidate{&c_led, unOcclusionCheck});
       return true;
    }
 
@@ -348,8 +254,8 @@ namespace argos {
       /* c_position is the led in camera's coordinate system, 
          transfer it to global coordinate system */
       CVector3 cLedPosition(c_position);
-      cLedPosition.Rotate(m_cCameraOrientation);
-      cLedPosition += m_cCameraPosition;
+      cLedPosition.Rotate(m_cFrustum.GetOrientation());
+      cLedPosition += m_cFrustum.GetPosition();
       /* find the closest LED */
       std::vector<SLed>::iterator itClosestLed =
          std::min_element(std::begin(m_vecLedCache),
@@ -393,47 +299,6 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   CRadians CBuilderBotCameraSystemDefaultSensor::GetAngleWithCamera(const CPositionalEntity& c_entity) const {
-      CVector3 cEntityToCamera(m_cCameraPosition - c_entity.GetPosition());
-      CVector3 cEntityDirection(CVector3::Z);
-      cEntityDirection.Rotate(c_entity.GetOrientation());
-      Real fDotProduct = cEntityDirection.DotProduct(cEntityToCamera);
-      return ACos(fDotProduct / (cEntityDirection.Length() * cEntityToCamera.Length()));
-   }
-
-   /****************************************/
-   /****************************************/
-
-   CVector2 CBuilderBotCameraSystemDefaultSensor::ProjectOntoSensor(const CVector3& c_point) const {
-      CVector3 cCameraToEntityTranslation(m_cCameraToWorldTransform * c_point);
-      /* this could be avoided if CVector3 inherited from CMatrix<3,1> */
-      CMatrix<3,1> cCameraToEntityTranslationMatrix;
-      cCameraToEntityTranslationMatrix(0,0) =
-         cCameraToEntityTranslation.GetX() / cCameraToEntityTranslation.GetZ();
-      cCameraToEntityTranslationMatrix(1,0) =
-         cCameraToEntityTranslation.GetY() / cCameraToEntityTranslation.GetZ();
-      cCameraToEntityTranslationMatrix(2,0) = 1.0f;
-      /* get image coordinates */
-      CMatrix<3,1> cImageCoordinates(m_cProjectionMatrix * cCameraToEntityTranslationMatrix);
-      /* return as vector2 */
-      return CVector2(cImageCoordinates(0,0), cImageCoordinates(1,0));
-   }
-
-   /****************************************/
-   /****************************************/
-
-   bool CBuilderBotCameraSystemDefaultSensor::IsInsideFrustum(const CVector3& c_point) const {
-      for(const CPlane& c_plane : m_arrFrustumPlanes) {
-         if(c_plane.GetNormal().DotProduct(c_point - c_plane.GetPosition()) < 0.0) {
-            return false;
-         }
-      }
-      return true;
-   }
-
-   /****************************************/
-   /****************************************/
-
    REGISTER_SENSOR(CBuilderBotCameraSystemDefaultSensor,
                    "builderbot_camera_system", "default",
                    "Michael Allwright [allsey87@gmail.com]",
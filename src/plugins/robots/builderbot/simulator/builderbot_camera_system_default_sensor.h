@@ -16,13 +16,12 @@ namespace argos {
 #include <argos3/core/simulator/physics_engine/physics_engine.h>
 #include <argos3/core/simulator/sensor.h>
 #include <argos3/core/simulator/space/positional_indices/positional_index.h>
-#include <argos3/core/utility/math/matrix/transformationmatrix3.h>
 #include <argos3/core/utility/math/ray3.h>
 #include <argos3/core/utility/math/rng.h>
-#include <argos3/core/utility/math/plane.h>
 
 #include <argos3/plugins/simulator/entities/tag_entity.h>
 #include <argos3/plugins/simulator/entities/directional_led_entity.h>
+#include <argos3/plugins/robots/generic/simulator/camera_sensor_frustum.h>
 #include <argos3/plugins/robots/builderbot/control_interface/ci_builderbot_camera_system_sensor.h>
 
 #include <vector>
@@ -74,14 +73,6 @@ namespace argos {
 
       CVector2 GetResolution() const;
 
-   private:
-
-      CRadians GetAngleWithCamera(const CPositionalEntity& c_entity) const;
-
-      CVector2 ProjectOntoSensor(const CVector3& c_point) const;
-
-      bool IsInsideFrustum(const CVector3& c_point) const;
-
    private:
       CControllableEntity* m_pcControllableEntity;
       CEmbodiedEntity* m_pcEmbodiedEntity;
@@ -94,27 +85,25 @@ namespace argos {
       bool m_bShowTagRays;
       bool m_bShowLEDRays;
 
-      /* cached data for operator() */
-      /* TODO: remove dependency on m_cOffset */
-      CTransformationMatrix3 m_cOffset;
-
-      CVector3 m_cCameraPosition;
-      CQuaternion m_cCameraOrientation;
-      CTransformationMatrix3 m_cCameraToWorldTransform;
-      CSquareMatrix<3> m_cProjectionMatrix;
-      std::array<CPlane, 6> m_arrFrustumPlanes;
+      /* the geometry of the camera, updated once per step */
+      CCameraSensorFrustum m_cFrustum;
 
-      /* for generating the fustrum */
-      Real m_fNearPlaneWidth;
-      Real m_fNearPlaneHeight;
-      Real m_fFarPlaneWidth;
-      Real m_fFarPlaneHeight;
+      /* the tags and LEDs inside the frustum, waiting for the occlusion checks */
+      struct STagCandidate {
+         CTagEntity* Tag;
+         std::array<CVector3, 4> Corners;
+         size_t OcclusionCheck;
+      };
+      struct SLedCandidate {
+         CDirectionalLEDEntity* Led;
+         size_t OcclusionCheck;
+      };
+      std::vector<STagCandidate> m_vecTagCandidates;
+      std::vector<SLedCandidate> m_vecLedCandidates;
 
       /* shared buffers */
       std::array<CVector3, 4> m_arrTagCorners;
       std::array<CVector2, 4> m_arrTagCornerPixels;
-      CRay3 m_cOcclusionCheckRay;
-      std::vector<SEmbodiedEntityIntersectionItem> m_vecIntersections;
 
       /* AprilTag corner offsets / ordering */
       const std::array<CVector3, 4> m_arrTagCornerOffsets = {{
@@ -111,32 +111,24 @@ namespace argos {
          CLuaUtility::AddToTable(pt_lua_state, "timestamp", s_interface.Timestamp);
          /* update the tag readings */
          lua_getfield(pt_lua_state, -1, "tags");
-         /* get the tag count from last time */
-         size_t unLastTagCount = lua_rawlen(pt_lua_state, -1);     
          for(size_t i = 0; i < s_interface.Tags.size(); ++i) {
             const STag& s_tag = s_interface.Tags[i];
-            CLuaUtility::StartTable(pt_lua_state, i + 1);
+            CLuaUtility::OpenTable(pt_lua_state, i + 1);
             CLuaUtility::AddToTable(pt_lua_state, "id", s_tag.Id);
             CLuaUtility::AddToTable(pt_lua_state, "position", s_tag.Position);
             CLuaUtility::AddToTable(pt_lua_state, "orientation", s_tag.Orientation);
             CLuaUtility::AddToTable(pt_lua_state, "center", s_tag.Center);
-            /* start corners */
-            CLuaUtility::StartTable(pt_lua_state, "corners");
+            /* open corners */
+            CLuaUtility::OpenTable(pt_lua_state, "corners");
             for(size_t j = 0; j < s_tag.Corners.size(); ++j) {
                CLuaUtility::AddToTable(pt_lua_state, j + 1, s_tag.Corners[j]);
             }
-            CLuaUtility::EndTable(pt_lua_state);
-            /* end corners */
-            CLuaUtility::EndTable(pt_lua_state);
-         }
-         if(s_interface.Tags.size() < unLastTagCount) {
-            /* Remove extra tags from the last update by setting them to nil */
-            for(size_t i = s_interface.Tags.size() + 1; i <= unLastTagCount; ++i) {
-               lua_pushnumber(pt_lua_state,  i);
-               lua_pushnil   (pt_lua_state    );
-               lua_settable  (pt_lua_state, -3);
-            }
+            CLuaUtility::CloseTable(pt_lua_state);
+            /* close corners */
+            CLuaUtility::CloseTable(pt_lua_state);
          }
+         /* Remove extra tags from the last update */
+         CLuaUtility::TruncateTable(pt_lua_state, s_interface.Tags.size());
          lua_pop(pt_lua_state, 1);
          lua_pop(pt_lua_state, 1);
       });
@@ -50,6 +50,32 @@ namespace argos {
       m_fTargetYawAngle = CRadians::ZERO;
    }
 
+   /****************************************/
+   /****************************************/
+
+   void CDroneFlightSystemEntity::SaveState(CByteArray& c_buffer) {
+      CEntity::SaveState(c_buffer);
+      c_buffer << m_cPositionReading
+               << m_cOrientationReading
+               << m_cVelocityReading
+               << m_cAngularVelocityReading
+               << m_cTargetPosition
+               << m_fTargetYawAngle;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDroneFlightSystemEntity::LoadState(CByteArray& c_buffer) {
+      CEntity::LoadState(c_buffer);
+      c_buffer >> m_cPositionReading
+               >> m_cOrientationReading
+               >> m_cVelocityReading
+               >> m_cAngularVelocityReading
+               >> m_cTargetPosition
+               >> m_fTargetYawAngle;
+   }
+
    /****************************************/
    /****************************************/
    
@@ -39,6 +39,10 @@ namespace argos {
 
       virtual void Reset();
 
+      virtual void SaveState(CByteArray& c_buffer);
+
+      virtual void LoadState(CByteArray& c_buffer);
+
       void SetPositionReading(const CVector3& c_reading) {
          m_cPositionReading = c_reading;
       }
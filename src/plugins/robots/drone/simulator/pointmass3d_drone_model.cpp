@@ -78,6 +78,39 @@ namespace argos
    /****************************************/
    /****************************************/
 
+   void CPointMass3DDroneModel::SaveState(CByteArray& c_buffer) {
+      c_buffer << m_fInputYawAngle << m_cInputPosition
+               << m_cHomePosition << m_fHomeYawAngle
+               << m_cPosition << m_cOrientation
+               << m_cVelocity << m_cVelocityPrev
+               << m_cAngularVelocity << m_cAngularVelocityPrev
+               << m_cAccelerationPrev << m_cAngularAccelerationPrev
+               << m_cOrientationTargetPrev << m_cAngularVelocityCumulativeError
+               << m_fAltitudeCumulativeError << m_fTargetPositionZPrev
+               << m_fGyroBias << m_fAccelBias
+               << m_fAngleRandomWalk << m_fVelocityRandomWalk;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CPointMass3DDroneModel::LoadState(CByteArray& c_buffer) {
+      c_buffer >> m_fInputYawAngle >> m_cInputPosition
+               >> m_cHomePosition >> m_fHomeYawAngle
+               >> m_cPosition >> m_cOrientation
+               >> m_cVelocity >> m_cVelocityPrev
+               >> m_cAngularVelocity >> m_cAngularVelocityPrev
+               >> m_cAccelerationPrev >> m_cAngularAccelerationPrev
+               >> m_cOrientationTargetPrev >> m_cAngularVelocityCumulativeError
+               >> m_fAltitudeCumulativeError >> m_fTargetPositionZPrev
+               >> m_fGyroBias >> m_fAccelBias
+               >> m_fAngleRandomWalk >> m_fVelocityRandomWalk;
+      UpdateEntityStatus();
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CPointMass3DDroneModel::UpdateEntityStatus() {
       /* calculate the readings */
       CVector3 cPositionReading(m_cPosition - m_cHomePosition);
@@ -55,7 +55,8 @@ namespace argos {
       m_pcGrippable(nullptr),
       m_fMass(1.6f),
       m_fCurrentWheelVelocity(m_cWheeledEntity.GetWheelVelocities()),
-      m_unLastTurretMode(m_cFootBotEntity.GetTurretEntity().GetMode()) {
+      m_unLastTurretMode(m_cFootBotEntity.GetTurretEntity().GetMode()),
+      m_fPreviousTurretAngleError(0.0) {
       RegisterAnchorMethod<CDynamics2DFootBotModel>(
          GetEmbodiedEntity().GetOriginAnchor(),
          &CDynamics2DFootBotModel::UpdateOriginAnchor);
@@ -192,6 +193,7 @@ namespace argos {
          m_unLastTurretMode = MODE_OFF;
          GetEmbodiedEntity().DisableAnchor("turret");
       }
+      m_fPreviousTurretAngleError = 0.0;
       /* Reset the rest */
       CDynamics2DMultiBodyObjectModel::Reset();
    }
@@ -199,6 +201,46 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CDynamics2DFootBotModel::SaveState(CByteArray& c_buffer) {
+      CDynamics2DMultiBodyObjectModel::SaveState(c_buffer);
+      c_buffer << m_unLastTurretMode
+               << m_fPreviousTurretAngleError;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics2DFootBotModel::LoadState(CByteArray& c_buffer) {
+      CDynamics2DMultiBodyObjectModel::LoadState(c_buffer);
+      UInt8 unTurretMode;
+      c_buffer >> unTurretMode
+               >> m_fPreviousTurretAngleError;
+      /* Switch the turret constraints to the restored mode */
+      bool bWasActive = (m_unLastTurretMode == MODE_SPEED_CONTROL ||
+                         m_unLastTurretMode == MODE_POSITION_CONTROL);
+      bool bIsActive = (unTurretMode == MODE_SPEED_CONTROL ||
+                        unTurretMode == MODE_POSITION_CONTROL);
+      if(bWasActive && !bIsActive) {
+         TurretActiveToPassive();
+      }
+      else if(!bWasActive && bIsActive) {
+         TurretPassiveToActive();
+      }
+      /* Enable or disable the anchor as UpdateFromEntityStatus() does */
+      if(unTurretMode != m_unLastTurretMode) {
+         if(unTurretMode != MODE_OFF) {
+            GetEmbodiedEntity().EnableAnchor("turret");
+         }
+         else {
+            GetEmbodiedEntity().DisableAnchor("turret");
+         }
+      }
+      m_unLastTurretMode = unTurretMode;
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CDynamics2DFootBotModel::CalculateBoundingBox() {
       GetBoundingBox().MinCorner.SetX(m_ptBaseShape->bb.l);
       GetBoundingBox().MinCorner.SetY(m_ptBaseShape->bb.b);
@@ -32,6 +32,10 @@ namespace argos {
 
       virtual void Reset();
 
+      virtual void SaveState(CByteArray& c_buffer);
+
+      virtual void LoadState(CByteArray& c_buffer);
+
       virtual void CalculateBoundingBox();
 
       virtual void UpdateFromEntityStatus();
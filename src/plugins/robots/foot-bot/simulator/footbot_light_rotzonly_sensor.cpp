@@ -9,6 +9,7 @@
 #include <argos3/core/simulator/entity/composable_entity.h>
 #include <argos3/plugins/simulator/entities/light_entity.h>
 #include <argos3/plugins/simulator/entities/light_sensor_equipped_entity.h>
+#include <argos3/plugins/simulator/media/light_medium.h>
 
 #include "footbot_light_rotzonly_sensor.h"
 
@@ -56,7 +57,8 @@ namespace argos {
       m_bShowRays(false),
       m_pcRNG(nullptr),
       m_bAddNoise(false),
-      m_cSpace(CSimulator::GetInstance().GetSpace()) {}
+      m_cSpace(CSimulator::GetInstance().GetSpace()),
+      m_pcLightMedium(nullptr) {}
 
    /****************************************/
    /****************************************/
@@ -92,6 +94,12 @@ namespace argos {
             m_pcRNG = CRandom::CreateRNG("argos");
          }
          m_tReadings.resize(m_pcLightEntity->GetNumSensors());
+         /* Get the light medium, if any */
+         if(NodeAttributeExists(t_tree, "medium")) {
+            std::string strMedium;
+            GetNodeAttribute(t_tree, "medium", strMedium);
+            m_pcLightMedium = &CSimulator::GetInstance().GetMedium<CLightMedium>(strMedium);
+         }
 
          /* sensor is enabled by default */
          Enable();
@@ -116,109 +124,109 @@ namespace argos {
       /* Get foot-bot orientation */
       CRadians cTmp1, cTmp2, cOrientationZ;
       m_pcEmbodiedEntity->GetOriginAnchor().Orientation.ToEulerAngles(cOrientationZ, cTmp1, cTmp2);
-      /* Ray used for scanning the environment for obstacles */
-      CRay3 cOcclusionCheckRay;
-      cOcclusionCheckRay.SetStart(m_pcEmbodiedEntity->GetOriginAnchor().Position);
+      /* Collect the lights to consider */
+      if(m_pcLightMedium != nullptr) {
+         /* Only the lights in range of the foot-bot */
+         m_pcLightMedium->GetLightsInRange(m_vecLights,
+                                           m_pcEmbodiedEntity->GetOriginAnchor().Position);
+      }
+      else {
+         /* All the lights in the arena */
+         m_vecLights.clear();
+         auto itLights = m_cSpace.GetEntityMapPerTypePerId().find("light");
+         if (itLights != m_cSpace.GetEntityMapPerTypePerId().end()) {
+            CSpace::TMapPerType& mapLights = itLights->second;
+            for(auto it = mapLights.begin();
+                it != mapLights.end();
+                ++it) {
+               CLightEntity* pcLight = any_cast<CLightEntity*>(it->second);
+               /* Consider the light only if it has non zero intensity */
+               if(pcLight->GetIntensity() > 0.0f) {
+                  m_vecLights.push_back(pcLight);
+               }
+            }
+         }
+      }
+      /* Check occlusion between the foot-bot and the lights, all in one go */
+      m_tOcclusionChecks.resize(m_vecLights.size());
+      for(size_t i = 0; i < m_vecLights.size(); ++i) {
+         m_tOcclusionChecks[i] = SEmbodiedEntityRayQuery(
+            CRay3(m_pcEmbodiedEntity->GetOriginAnchor().Position,
+                  m_vecLights[i]->GetPosition()),
+            m_pcEmbodiedEntity);
+      }
+      GetClosestEmbodiedEntitiesIntersectedByRays(m_tOcclusionChecks);
       CVector3 cRobotToLight;
       /* Buffer for the angle of the light wrt to the foot-bot */
       CRadians cAngleLightWrtFootbot;
-      /* Buffers to contain data about the intersection */
-      SEmbodiedEntityIntersectionItem sIntersection;
-      /* List of light entities */
-      auto itLights = m_cSpace.GetEntityMapPerTypePerId().find("light");
-      if (itLights != m_cSpace.GetEntityMapPerTypePerId().end()) {
-         CSpace::TMapPerType& mapLights = itLights->second;
-         /*
-       * 1. go through the list of light entities in the scene
+      /*
+       * 1. go through the list of light entities to consider
        * 2. check if a light is occluded
        * 3. if it isn't, distribute the reading across the sensors
        *    NOTE: the readings are additive
        * 4. go through the sensors and clamp their values
        */
-         for(auto it = mapLights.begin();
-             it != mapLights.end();
-             ++it) {
-            /* Get a reference to the light */
-            CLightEntity& cLight = *(any_cast<CLightEntity*>(it->second));
-            /* Consider the light only if it has non zero intensity */
-            if(cLight.GetIntensity() > 0.0f) {
-               /* Set the ray end */
-               cOcclusionCheckRay.SetEnd(cLight.GetPosition());
-               /* Check occlusion between the foot-bot and the light */
-               if(! GetClosestEmbodiedEntityIntersectedByRay(sIntersection,
-                                                             cOcclusionCheckRay,
-                                                             *m_pcEmbodiedEntity)) {
-                  /* The light is not occluded */
-                  if(m_bShowRays) {
-                     m_pcControllableEntity->AddCheckedRay(false, cOcclusionCheckRay);
-                  }
-                  /* Get the distance between the light and the foot-bot */
-                  cOcclusionCheckRay.ToVector(cRobotToLight);
-                  /*
-                   * Linearly scale the distance with the light intensity
-                   * The greater the intensity, the smaller the distance
-                   */
-                  cRobotToLight /= cLight.GetIntensity();
-                  /* Get the angle wrt to foot-bot rotation */
-                  cAngleLightWrtFootbot = cRobotToLight.GetZAngle();
-                  cAngleLightWrtFootbot -= cOrientationZ;
-                  /*
-                   * Find closest sensor index to point at which ray hits footbot body
-                   * Rotate whole body by half a sensor spacing (corresponding to placement of first sensor)
-                   * Division says how many sensor spacings there are between first sensor and point at which ray hits footbot body
-                   * Increase magnitude of result of division to ensure correct rounding
-                   */
-                  Real fIdx = (cAngleLightWrtFootbot - SENSOR_HALF_SPACING) / SENSOR_SPACING;
-                  SInt32 nReadingIdx = static_cast<SInt32>((fIdx > 0) ? fIdx + 0.5f : fIdx - 0.5f);
-                  /* Set the actual readings */
-                  Real fReading = cRobotToLight.Length();
-                  /*
-                   * Take 6 readings before closest sensor and 6 readings after - thus we
-                   * process sensors that are with 180 degrees of intersection of light
-                   * ray with robot body
-                   */
-                  for(SInt32 nIndexOffset = -6; nIndexOffset < 7; ++nIndexOffset) {
-                     UInt32 unIdx = Modulo(nReadingIdx + nIndexOffset, 24);
-                     CRadians cAngularDistanceFromOptimalLightReceptionPoint = Abs((cAngleLightWrtFootbot - m_tReadings[unIdx].Angle).SignedNormalize());
-                     /*
-                      * ComputeReading gives value as if sensor was perfectly in line with
-                      * light ray. We then linearly decrease actual reading from 1 (dist
-                      * 0) to 0 (dist PI/2)
-                      */
-                     m_tReadings[unIdx].Value += ComputeReading(fReading) * ScaleReading(cAngularDistanceFromOptimalLightReceptionPoint);
-                  }
-               }
-               else {
-                  /* The ray is occluded */
-                  if(m_bShowRays) {
-                     m_pcControllableEntity->AddCheckedRay(true, cOcclusionCheckRay);
-                     m_pcControllableEntity->AddIntersectionPoint(cOcclusionCheckRay, sIntersection.TOnRay);
-                  }
-               }
+      for(size_t i = 0; i < m_vecLights.size(); ++i) {
+         /* Get a reference to the light */
+         CLightEntity& cLight = *m_vecLights[i];
+         const SEmbodiedEntityRayQuery& sOcclusionCheck = m_tOcclusionChecks[i];
+         if(sOcclusionCheck.Closest.IntersectedEntity == nullptr) {
+            /* The light is not occluded */
+            if(m_bShowRays) {
+               m_pcControllableEntity->AddCheckedRay(false, sOcclusionCheck.Ray);
             }
-         }
-         /* Apply noise to the sensors */
-         if(m_bAddNoise) {
-            for(size_t i = 0; i < 24; ++i) {
-               m_tReadings[i].Value += m_pcRNG->Uniform(m_cNoiseRange);
+            /* Get the distance between the light and the foot-bot */
+            sOcclusionCheck.Ray.ToVector(cRobotToLight);
+            /*
+             * Linearly scale the distance with the light intensity
+             * The greater the intensity, the smaller the distance
+             */
+            cRobotToLight /= cLight.GetIntensity();
+            /* Get the angle wrt to foot-bot rotation */
+            cAngleLightWrtFootbot = cRobotToLight.GetZAngle();
+            cAngleLightWrtFootbot -= cOrientationZ;
+            /*
+             * Find closest sensor index to point at which ray hits footbot body
+             * Rotate whole body by half a sensor spacing (corresponding to placement of first sensor)
+             * Division says how many sensor spacings there are between first sensor and point at which ray hits footbot body
+             * Increase magnitude of result of division to ensure correct rounding
+             */
+            Real fIdx = (cAngleLightWrtFootbot - SENSOR_HALF_SPACING) / SENSOR_SPACING;
+            SInt32 nReadingIdx = static_cast<SInt32>((fIdx > 0) ? fIdx + 0.5f : fIdx - 0.5f);
+            /* Set the actual readings */
+            Real fReading = cRobotToLight.Length();
+            /*
+             * Take 6 readings before closest sensor and 6 readings after - thus we
+             * process sensors that are with 180 degrees of intersection of light
+             * ray with robot body
+             */
+            for(SInt32 nIndexOffset = -6; nIndexOffset < 7; ++nIndexOffset) {
+               UInt32 unIdx = Modulo(nReadingIdx + nIndexOffset, 24);
+               CRadians cAngularDistanceFromOptimalLightReceptionPoint = Abs((cAngleLightWrtFootbot - m_tReadings[unIdx].Angle).SignedNormalize());
+               /*
+                * ComputeReading gives value as if sensor was perfectly in line with
+                * light ray. We then linearly decrease actual reading from 1 (dist
+                * 0) to 0 (dist PI/2)
+                */
+               m_tReadings[unIdx].Value += ComputeReading(fReading) * ScaleReading(cAngularDistanceFromOptimalLightReceptionPoint);
             }
          }
-         /* Trunc the reading between 0 and 1 */
-         for(size_t i = 0; i < 24; ++i) {
-            SENSOR_RANGE.TruncValue(m_tReadings[i].Value);
+         else {
+            /* The ray is occluded */
+            if(m_bShowRays) {
+               m_pcControllableEntity->AddCheckedRay(true, sOcclusionCheck.Ray);
+               m_pcControllableEntity->AddIntersectionPoint(sOcclusionCheck.Ray, sOcclusionCheck.Closest.TOnRay);
+            }
          }
       }
-      else {
-         /* There are no lights in the environment */
+      /* Go through the sensors */
+      for(UInt32 i = 0; i < m_tReadings.size(); ++i) {
+         /* Apply noise to the sensor */
          if(m_bAddNoise) {
-            /* Go through the sensors */
-            for(UInt32 i = 0; i < m_tReadings.size(); ++i) {
-               /* Apply noise to the sensor */
-               m_tReadings[i].Value += m_pcRNG->Uniform(m_cNoiseRange);
-               /* Trunc the reading between 0 and 1 */
-               SENSOR_RANGE.TruncValue(m_tReadings[i].Value);
-            }
+            m_tReadings[i].Value += m_pcRNG->Uniform(m_cNoiseRange);
          }
+         /* Trunc the reading between 0 and 1 */
+         SENSOR_RANGE.TruncValue(m_tReadings[i].Value);
       }
    }
       
@@ -305,8 +313,25 @@ namespace argos {
                    "    </my_controller>\n"
                    "    ...\n"
                    "  </controllers>\n\n"
-                   "OPTIONAL XML CONFIGURATION\n\n"
-                   "None.\n",
+                   "In arenas with many lights, the sensor can use a light medium to consider\n"
+                   "only the lights within range of the foot-bot. A light of intensity I is not\n"
+                   "perceived beyond a distance of 2.5*I, so the readings do not change as long as\n"
+                   "the range of the light medium is at least 2.5. To use a light medium, set the\n"
+                   "\"medium\" attribute to its id, and add the lights to the same light medium:\n\n"
+                   "  <controllers>\n"
+                   "    ...\n"
+                   "    <my_controller ...>\n"
+                   "      ...\n"
+                   "      <sensors>\n"
+                   "        ...\n"
+                   "        <footbot_light implementation=\"rot_z_only\"\n"
+                   "                       medium=\"lights\" />\n"
+                   "        ...\n"
+                   "      </sensors>\n"
+                   "      ...\n"
+                   "    </my_controller>\n"
+                   "    ...\n"
+                   "  </controllers>\n\n",
                    "Usable"
       );
 
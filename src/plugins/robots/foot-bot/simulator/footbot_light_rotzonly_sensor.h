@@ -13,6 +13,8 @@
 namespace argos {
    class CFootBotLightRotZOnlySensor;
    class CLightSensorEquippedEntity;
+   class CLightEntity;
+   class CLightMedium;
 }
 
 #include <argos3/plugins/robots/foot-bot/control_interface/ci_footbot_light_sensor.h>
@@ -20,6 +22,7 @@ namespace argos {
 #include <argos3/core/utility/math/rng.h>
 #include <argos3/core/simulator/space/space.h>
 #include <argos3/core/simulator/sensor.h>
+#include <argos3/core/simulator/physics_engine/physics_engine.h>
 
 namespace argos {
 
@@ -81,6 +84,15 @@ namespace argos {
 
       /** Reference to the space */
       CSpace& m_cSpace;
+
+      /** The light medium, or nullptr if the sensor goes through all the lights */
+      CLightMedium* m_pcLightMedium;
+
+      /** The lights considered in the current step */
+      std::vector<CLightEntity*> m_vecLights;
+
+      /** The occlusion checks between the foot-bot and the lights */
+      TEmbodiedEntityRayQueries m_tOcclusionChecks;
    };
 
 }
@@ -0,0 +1,75 @@
+/**
+ * @file <argos3/plugins/robots/foot-bot/simulator/footbot_proximity_trajectory_channel.cpp>
+ */
+
+#include "footbot_proximity_trajectory_channel.h"
+#include <argos3/core/simulator/entity/composable_entity.h>
+#include <argos3/core/simulator/entity/controllable_entity.h>
+#include <argos3/plugins/robots/foot-bot/control_interface/ci_footbot_proximity_sensor.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   CEntity* CFootBotProximityTrajectoryChannel::GetSource(CComposableEntity& c_entity) {
+      if(!c_entity.HasComponent("controller")) {
+         return nullptr;
+      }
+      auto* pcControllable = dynamic_cast<CControllableEntity*>(&c_entity.GetComponent("controller"));
+      if(pcControllable == nullptr ||
+         !pcControllable->GetController().HasSensor("footbot_proximity")) {
+         return nullptr;
+      }
+      return pcControllable;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   static const CCI_FootBotProximitySensor::TReadings& GetReadings(CEntity& c_source) {
+      return static_cast<CControllableEntity&>(c_source).GetController().
+         GetSensor<CCI_FootBotProximitySensor>("footbot_proximity")->GetReadings();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   UInt32 CFootBotProximityTrajectoryChannel::GetNumValues(CEntity& c_source) {
+      return GetReadings(c_source).size();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CFootBotProximityTrajectoryChannel::Sample(CEntity& c_source,
+                                                   void* pt_values) {
+      const CCI_FootBotProximitySensor::TReadings& tReadings = GetReadings(c_source);
+      auto* pfValues = static_cast<float*>(pt_values);
+      for(size_t i = 0; i < tReadings.size(); ++i) {
+         pfValues[i] = tReadings[i].Value;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_TRAJECTORY_CHANNEL(CFootBotProximityTrajectoryChannel,
+                               "footbot_proximity",
+                               "Carlo Pinciroli [ilpincy@gmail.com]",
+                               "1.0",
+                               "Records the readings of the foot-bot proximity sensor.",
+                               "This channel records the 24 readings of the foot-bot proximity sensor, as\n"
+                               "32-bit floats. The readings are those the controller saw in the last step.\n"
+                               "Only the foot-bots whose controller uses the footbot_proximity sensor are\n"
+                               "recorded.\n\n"
+                               "REQUIRED XML CONFIGURATION\n\n"
+                               "  <recording file=\"trajectory.argostrj\">\n"
+                               "    <entities type=\"foot-bot\">\n"
+                               "      <footbot_proximity />\n"
+                               "    </entities>\n"
+                               "  </recording>\n",
+                               "Usable"
+      );
+
+}
@@ -0,0 +1,43 @@
+/**
+ * @file <argos3/plugins/robots/foot-bot/simulator/footbot_proximity_trajectory_channel.h>
+ */
+
+#ifndef FOOTBOT_PROXIMITY_TRAJECTORY_CHANNEL_H
+#define FOOTBOT_PROXIMITY_TRAJECTORY_CHANNEL_H
+
+namespace argos {
+   class CFootBotProximityTrajectoryChannel;
+}
+
+#include <argos3/core/simulator/recorder/trajectory_channel.h>
+
+namespace argos {
+
+   /**
+    * Records the readings of the foot-bot proximity sensor.
+    * The readings are the values the controller saw in the last step, as
+    * 32-bit floats. Only the foot-bots whose controller uses the
+    * <tt>footbot_proximity</tt> sensor are recorded.
+    */
+   class CFootBotProximityTrajectoryChannel : public CTrajectoryChannel {
+
+   public:
+
+      virtual ~CFootBotProximityTrajectoryChannel() {}
+
+      virtual ETrajectoryValueType GetValueType() const {
+         return TRAJECTORY_FLOAT32;
+      }
+
+      virtual CEntity* GetSource(CComposableEntity& c_entity);
+
+      virtual UInt32 GetNumValues(CEntity& c_source);
+
+      virtual void Sample(CEntity& c_source,
+                          void* pt_values);
+
+   };
+
+}
+
+#endif
@@ -37,8 +37,8 @@ namespace argos {
       CLuaUtility::AddToTable(pt_lua_state, "_instance", this);
       CLuaUtility::AddToTable(pt_lua_state, "enable", &LuaEnableOmnidirectionalCamera);
       CLuaUtility::AddToTable(pt_lua_state, "disable", &LuaDisableOmnidirectionalCamera);
-      for(size_t i = 0; i < m_sReadings.BlobList.size(); ++i) {
-         SBlob& sBlob = *(m_sReadings.BlobList[i]);
+      for(size_t i = 0; i < m_sReadings.Blobs.size(); ++i) {
+         const SBlob& sBlob = m_sReadings.Blobs[i];
          CLuaUtility::StartTable(pt_lua_state, i+1);
          CLuaUtility::AddToTable(pt_lua_state, "distance", sBlob.Distance);
          CLuaUtility::AddToTable(pt_lua_state, "angle", sBlob.Angle);
@@ -58,8 +58,8 @@ namespace argos {
       /* Save the number of elements in the blob list */
       size_t unLastBlobNum = lua_rawlen(pt_lua_state, -1);
       /* Overwrite the table with the new messages */
-      for(size_t i = 0; i < m_sReadings.BlobList.size(); ++i) {
-         SBlob& sBlob = *(m_sReadings.BlobList[i]);
+      for(size_t i = 0; i < m_sReadings.Blobs.size(); ++i) {
+         const SBlob& sBlob = m_sReadings.Blobs[i];
          CLuaUtility::StartTable(pt_lua_state, i+1);
          CLuaUtility::AddToTable(pt_lua_state, "distance", sBlob.Distance);
          CLuaUtility::AddToTable(pt_lua_state, "angle", sBlob.Angle);
@@ -67,9 +67,9 @@ namespace argos {
          CLuaUtility::EndTable(pt_lua_state);
       }
       /* Are the new messages less than the old ones? */
-      if(m_sReadings.BlobList.size() < unLastBlobNum) {
+      if(m_sReadings.Blobs.size() < unLastBlobNum) {
          /* Yes, set to nil all the extra entries */
-         for(size_t i = m_sReadings.BlobList.size()+1; i <= unLastBlobNum; ++i) {
+         for(size_t i = m_sReadings.Blobs.size()+1; i <= unLastBlobNum; ++i) {
             lua_pushnumber(pt_lua_state,  i);
             lua_pushnil   (pt_lua_state    );
             lua_settable  (pt_lua_state, -3);
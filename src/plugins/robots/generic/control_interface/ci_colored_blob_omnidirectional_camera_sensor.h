@@ -72,6 +72,11 @@ namespace argos {
          }
       };
 
+      /**
+       * Vector of colored blobs.
+       */
+      typedef std::vector<SBlob> TBlobs;
+
       /**
        * Vector of pointers to colored blobs.
        */
@@ -79,10 +84,14 @@ namespace argos {
 
       /**
        * It represents the readings collected through the camera at a specific time step.
-       * It consists of two members, the vector of colored blobs detected and a counter which stores the time step
+       * It consists of the colored blobs detected and a counter which stores the time step
        * at which the blobs became available.
+       * The blobs are stored by value in Blobs, whose memory is reused across time steps.
+       * BlobList points to the elements of Blobs, for the controllers that access the blobs
+       * through pointers.
        */
       struct SReadings {
+         TBlobs Blobs;
          TBlobList BlobList;
          UInt64 Counter;
 
@@ -90,10 +99,44 @@ namespace argos {
             Counter(0) {
          }
 
+         SReadings(const SReadings& s_readings) :
+            Blobs(s_readings.Blobs),
+            Counter(s_readings.Counter) {
+            UpdateBlobList();
+         }
+
+         SReadings& operator=(const SReadings& s_readings) {
+            if(&s_readings != this) {
+               Blobs = s_readings.Blobs;
+               Counter = s_readings.Counter;
+               UpdateBlobList();
+            }
+            return *this;
+         }
+
+         /**
+          * Makes BlobList point to the elements of Blobs.
+          * This method must be called whenever Blobs changes.
+          */
+         void UpdateBlobList() {
+            BlobList.resize(Blobs.size());
+            for(size_t i = 0; i < Blobs.size(); ++i) {
+               BlobList[i] = &Blobs[i];
+            }
+         }
+
+         /**
+          * Erases the blobs, keeping the allocated memory.
+          */
+         void Clear() {
+            Blobs.clear();
+            BlobList.clear();
+         }
+
          friend std::ostream& operator<<(std::ostream& c_os, const SReadings& s_reading) {
             c_os << "Counter: " <<  s_reading.Counter << std::endl;
             for (size_t i = 0; i < s_reading.BlobList.size(); i++) {
-               c_os << "Blob[" << i << "]: " << s_reading.BlobList[i] << std::endl;
+               c_os << "Blob[" << i << "]: " << s_reading.Blobs[i] << std::endl;
             }
             return c_os;
          }
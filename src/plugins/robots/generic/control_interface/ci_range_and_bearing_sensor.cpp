@@ -8,6 +8,7 @@
 
 #ifdef ARGOS_WITH_LUA
 #include <argos3/core/wrappers/lua/lua_utility.h>
+#include <argos3/core/wrappers/lua/lua_byte_array.h>
 #endif
 
 namespace argos {
@@ -24,20 +25,12 @@ namespace argos {
 
 #ifdef ARGOS_WITH_LUA
    void CCI_RangeAndBearingSensor::CreateLuaState(lua_State* pt_lua_state) {
+      m_nLuaKeyRange = CLuaUtility::InternKey(pt_lua_state, "range");
+      m_nLuaKeyHorizontalBearing = CLuaUtility::InternKey(pt_lua_state, "horizontal_bearing");
+      m_nLuaKeyVerticalBearing = CLuaUtility::InternKey(pt_lua_state, "vertical_bearing");
+      m_nLuaKeyData = CLuaUtility::InternKey(pt_lua_state, "data");
+      /* the readings are added by ReadingsToLuaState() */
       CLuaUtility::OpenRobotStateTable(pt_lua_state, "range_and_bearing");
-      for(size_t i = 0; i < m_tReadings.size(); ++i) {
-         CLuaUtility::StartTable(pt_lua_state, i+1);
-         CLuaUtility::AddToTable(pt_lua_state, "range", m_tReadings[i].Range);
-         CLuaUtility::AddToTable(pt_lua_state, "horizontal_bearing", m_tReadings[i].HorizontalBearing);
-         CLuaUtility::AddToTable(pt_lua_state, "vertical_bearing", m_tReadings[i].VerticalBearing);
-         CLuaUtility::StartTable(pt_lua_state, "data");
-         const CByteArray& cData = m_tReadings[i].Data;
-         for(size_t j = 0; j < cData.Size(); ++j) {
-            CLuaUtility::AddToTable(pt_lua_state, j+1, cData[j]);
-         }
-         CLuaUtility::EndTable(pt_lua_state);
-         CLuaUtility::EndTable(pt_lua_state);
-      }
       CLuaUtility::CloseRobotStateTable(pt_lua_state);
    }
 #endif
@@ -48,31 +41,37 @@ namespace argos {
 #ifdef ARGOS_WITH_LUA
    void CCI_RangeAndBearingSensor::ReadingsToLuaState(lua_State* pt_lua_state) {
       lua_getfield(pt_lua_state, -1, "range_and_bearing");
-      /* Save the number of elements in the RAB table */
-      size_t unLastMsgNum = lua_rawlen(pt_lua_state, -1);
+      bool bReuseReadings = CLuaUtility::IsReusingReadings(pt_lua_state);
       /* Overwrite the table with the new messages */
       for(size_t i = 0; i < m_tReadings.size(); ++i) {
-         CLuaUtility::StartTable(pt_lua_state, i+1);
-         CLuaUtility::AddToTable(pt_lua_state, "range", m_tReadings[i].Range);
-         CLuaUtility::AddToTable(pt_lua_state, "horizontal_bearing", m_tReadings[i].HorizontalBearing);
-         CLuaUtility::AddToTable(pt_lua_state, "vertical_bearing", m_tReadings[i].VerticalBearing);
-         CLuaUtility::StartTable(pt_lua_state, "data");
-         const CByteArray& cData = m_tReadings[i].Data;
-         for(size_t j = 0; j < cData.Size(); ++j) {
-            CLuaUtility::AddToTable(pt_lua_state, j+1, cData[j]);
+         const SPacket& sPacket = m_tReadings[i];
+         CLuaUtility::OpenTable(pt_lua_state, i + 1);
+         CLuaUtility::PushInternedKey(pt_lua_state, m_nLuaKeyRange);
+         lua_pushnumber(pt_lua_state, sPacket.Range);
+         lua_rawset(pt_lua_state, -3);
+         CLuaUtility::PushInternedKey(pt_lua_state, m_nLuaKeyHorizontalBearing);
+         lua_pushnumber(pt_lua_state, sPacket.HorizontalBearing.GetValue());
+         lua_rawset(pt_lua_state, -3);
+         CLuaUtility::PushInternedKey(pt_lua_state, m_nLuaKeyVerticalBearing);
+         lua_pushnumber(pt_lua_state, sPacket.VerticalBearing.GetValue());
+         lua_rawset(pt_lua_state, -3);
+         if(bReuseReadings) {
+            /* The payload is exposed as a read-only view rather than a table of bytes */
+            CLuaByteArray::SetInTable(pt_lua_state, m_nLuaKeyData, sPacket.Data);
          }
-         CLuaUtility::EndTable(pt_lua_state);
-         CLuaUtility::EndTable(pt_lua_state);
-      }
-      /* Are the new messages less than the old ones? */
-      if(m_tReadings.size() < unLastMsgNum) {
-         /* Yes, set to nil all the extra entries */
-         for(size_t i = m_tReadings.size()+1; i <= unLastMsgNum; ++i) {
-            lua_pushnumber(pt_lua_state,  i);
-            lua_pushnil   (pt_lua_state    );
-            lua_settable  (pt_lua_state, -3);
+         else {
+            CLuaUtility::PushInternedKey(pt_lua_state, m_nLuaKeyData);
+            lua_createtable(pt_lua_state, sPacket.Data.Size(), 0);
+            for(size_t j = 0; j < sPacket.Data.Size(); ++j) {
+               lua_pushnumber(pt_lua_state, sPacket.Data[j]);
+               lua_rawseti(pt_lua_state, -2, j + 1);
+            }
+            lua_rawset(pt_lua_state, -3);
          }
+         CLuaUtility::CloseTable(pt_lua_state);
       }
+      /* Remove the extra messages from the last update */
+      CLuaUtility::TruncateTable(pt_lua_state, m_tReadings.size());
       lua_pop(pt_lua_state, 1);
    }
 #endif
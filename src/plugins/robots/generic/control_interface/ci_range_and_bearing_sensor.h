@@ -59,6 +59,16 @@ namespace argos {
 
       TReadings m_tReadings;
 
+#ifdef ARGOS_WITH_LUA
+   private:
+
+      /* the keys of the reading tables, interned in the Lua state */
+      int m_nLuaKeyRange;
+      int m_nLuaKeyHorizontalBearing;
+      int m_nLuaKeyVerticalBearing;
+      int m_nLuaKeyData;
+#endif
+
    };
 
    /****************************************/
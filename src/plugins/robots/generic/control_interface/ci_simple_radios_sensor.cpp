@@ -36,25 +36,21 @@ namespace argos {
       lua_getfield(pt_lua_state, -1, "simple_radios"); // radios
       for(size_t i = 0; i < m_vecInterfaces.size(); i++) {
          const std::string& strId = m_vecInterfaces[i].Id;
-         std::vector<CByteArray>& vecMessages = m_vecInterfaces[i].Messages;
+         std::vector<TMessage>& vecMessages = m_vecInterfaces[i].Messages;
          lua_getfield(pt_lua_state, -1, strId.c_str()); // interface
          lua_getfield(pt_lua_state, -1, "recv"); // messages
-         size_t unLastMessageCount = lua_rawlen(pt_lua_state, -1);
          for(size_t j = 0; j < vecMessages.size(); ++j) {
-            CLuaUtility::StartTable(pt_lua_state, j + 1);
-            /* Copy CByteArray here since it consumes itself during deserialization */
-            CByteArray cMessage(vecMessages[j]);
-            CLuaUtility::LuaDeserializeTable(cMessage, pt_lua_state);
-            CLuaUtility::EndTable(pt_lua_state);
-         }
-         if(vecMessages.size() < unLastMessageCount) {
-            /* Remove the extra entries from the table */
-            for(size_t j = vecMessages.size() + 1; j <= unLastMessageCount; ++j) {
-               lua_pushnumber(pt_lua_state, j);
-               lua_pushnil(pt_lua_state);
-               lua_settable(pt_lua_state, -3);
-            }
+            /* Reuse the table of the last update, clearing the fields of the old message */
+            CLuaUtility::OpenTable(pt_lua_state, j + 1);
+            CLuaUtility::ClearTable(pt_lua_state);
+            /* Copy CByteArray here since it consumes itself during deserialization,
+               the buffer is reused so that this does not allocate at every update */
+            m_cLuaMessage = *vecMessages[j];
+            CLuaUtility::LuaDeserializeTable(m_cLuaMessage, pt_lua_state);
+            CLuaUtility::CloseTable(pt_lua_state);
          }
+         /* Remove the extra entries from the table */
+         CLuaUtility::TruncateTable(pt_lua_state, vecMessages.size());
          lua_pop(pt_lua_state, 1); // messages
          lua_pop(pt_lua_state, 1); // interface       
       }
@@ -13,6 +13,7 @@ namespace argos {
 
 #include <argos3/core/control_interface/ci_sensor.h>
 #include <argos3/core/utility/datatypes/byte_array.h>
+#include <memory>
 
 namespace argos {
    
@@ -20,13 +21,28 @@ namespace argos {
       
    public:
       
+      /**
+       * A received message.
+       * The payload is shared with the sender and the other receivers,
+       * so it cannot be modified.
+       * <p>
+       * SInterface::Messages used to hold CByteArray objects. Code written
+       * for that interface must now dereference the messages, e.g.,
+       * <tt>*Messages[i]</tt> instead of <tt>Messages[i]</tt> and
+       * <tt>Messages[i]-&gt;Size()</tt> instead of <tt>Messages[i].Size()</tt>.
+       * To modify a message, e.g., to deserialize it with
+       * <tt>operator&gt;&gt;</tt>, copy it first.
+       * </p>
+       */
+      using TMessage = std::shared_ptr<const CByteArray>;
+
       struct SInterface {
          SInterface(const std::string& str_id,
-                    const std::vector<CByteArray>& vec_messages = {}) :
+                    const std::vector<TMessage>& vec_messages = {}) :
             Id(str_id),
             Messages(vec_messages) {}
          std::string Id;
-         std::vector<CByteArray> Messages;
+         std::vector<TMessage> Messages;
          using TVector = std::vector<SInterface>;
       };
 
@@ -61,6 +77,13 @@ namespace argos {
    protected:
  
       SInterface::TVector m_vecInterfaces;
+
+#ifdef ARGOS_WITH_LUA
+   private:
+
+      /* buffer reused to deserialize the messages into the Lua state */
+      CByteArray m_cLuaMessage;
+#endif
       
    };
    
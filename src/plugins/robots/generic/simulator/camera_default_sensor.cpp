@@ -54,7 +54,6 @@ namespace argos {
             CQuaternion cOffsetOrientation;
             GetNodeAttribute(*itCamera, "position", cOffsetPosition);
             GetNodeAttribute(*itCamera, "orientation", cOffsetOrientation);
-            CTransformationMatrix3 cOffset(cOffsetOrientation, cOffsetPosition);
             /* parse the range */
             CRange<Real> cRange;
             GetNodeAttribute(*itCamera, "range", cRange);
@@ -109,8 +108,8 @@ namespace argos {
                vecAlgorithms.push_back(pcCIAlgorithm);
             }
             /* create the simulated sensor */
-            m_vecSensors.emplace_back(sAnchor, cOffset, cRange, cProjectionMatrix,
-                                      cResolution, vecSimulatedAlgorithms);
+            m_vecSensors.emplace_back(sAnchor, cOffsetOrientation, cOffsetPosition, cRange,
+                                      cProjectionMatrix, cResolution, vecSimulatedAlgorithms);
             /* create the sensor's control interface */
             m_vecInterfaces.emplace_back(strId, vecAlgorithms);
          }
@@ -133,108 +132,27 @@ namespace argos {
       /* vector of controller rays */
       std::vector<std::pair<bool, CRay3> >& vecCheckedRays =
          m_pcControllableEntity->GetCheckedRays();
-      /* sensor parameters */
-      CTransformationMatrix3 cWorldToAnchorTransform;
-      CTransformationMatrix3 cWorldToCameraTransform;
+      /* the algorithms expect a matrix that transforms points into the frame of the camera */
       CTransformationMatrix3 cCameraToWorldTransform;
-      CVector3 cCameraLocation, cLookAt, cUp;
-      CVector3 cX, cY, cZ;
-      CVector3 cNearCenter, cNearTopLeft, cNearTopRight, cNearBottomLeft, cNearBottomRight;
-      CVector3 cFarCenter, cFarTopLeft, cFarTopRight, cFarBottomLeft, cFarBottomRight;
-      std::array<CPlane, 6> arrFrustumPlanes;
-      CVector3 cBoundingBoxMinCorner, cBoundingBoxMaxCorner;
-      CVector3 cBoundingBoxPosition, cBoundingBoxHalfExtents;
       /* for each camera sensor */
       for(SSensor& s_sensor : m_vecSensors) {
-         /* calculate transform matrices */
-         cWorldToAnchorTransform.SetFromComponents(s_sensor.Anchor.Orientation, s_sensor.Anchor.Position);
-         cWorldToCameraTransform = cWorldToAnchorTransform * s_sensor.Offset;
-         cCameraToWorldTransform = cWorldToCameraTransform.GetInverse();
-         /* calculate camera direction vectors */
-         cCameraLocation = cWorldToCameraTransform.GetTranslationVector();
-         cLookAt = cWorldToCameraTransform * CVector3::Z;
-         cUp = CVector3(0,-1,0); // -Y
-         cUp.Rotate(cWorldToCameraTransform.GetRotationMatrix());
-         /* calculate direction vectors */
-         cZ = cCameraLocation - cLookAt;
-         cZ.Normalize();
-         cX = cUp;
-         cX.CrossProduct(cZ);
-         cX.Normalize();
-         cY = cZ;
-         cY.CrossProduct(cX);
-         /* calculate frustum coordinates */
-         cNearCenter = cCameraLocation - cZ * s_sensor.Range.GetMin();
-         cFarCenter = cCameraLocation - cZ * s_sensor.Range.GetMax();
-         cNearTopLeft = cNearCenter + (cY * s_sensor.NearPlaneHeight) - (cX * s_sensor.NearPlaneWidth);
-         cNearTopRight = cNearCenter + (cY * s_sensor.NearPlaneHeight) + (cX * s_sensor.NearPlaneWidth);
-         cNearBottomLeft = cNearCenter - (cY * s_sensor.NearPlaneHeight) - (cX * s_sensor.NearPlaneWidth);
-         cNearBottomRight = cNearCenter - (cY * s_sensor.NearPlaneHeight) + (cX * s_sensor.NearPlaneWidth);
-         cFarTopLeft = cFarCenter + (cY * s_sensor.FarPlaneHeight) - (cX * s_sensor.FarPlaneWidth);
-         cFarTopRight = cFarCenter + (cY * s_sensor.FarPlaneHeight) + (cX * s_sensor.FarPlaneWidth);
-         cFarBottomLeft = cFarCenter - (cY * s_sensor.FarPlaneHeight) - (cX * s_sensor.FarPlaneWidth);
-         cFarBottomRight = cFarCenter - (cY * s_sensor.FarPlaneHeight) + (cX * s_sensor.FarPlaneWidth);
+         /* place the camera and calculate its frustum */
+         s_sensor.Frustum.Update(s_sensor.Anchor);
+         cCameraToWorldTransform.SetFromComponents(s_sensor.Frustum.GetOrientation(),
+                                                   s_sensor.Frustum.GetPosition());
+         cCameraToWorldTransform = cCameraToWorldTransform.GetInverse();
          /* show frustum if enabled by adding outline to the checked rays vector */
          if(m_bShowFrustum) {
-            vecCheckedRays.emplace_back(false, CRay3(cNearTopLeft, cNearTopRight));
-            vecCheckedRays.emplace_back(false, CRay3(cNearTopRight, cNearBottomRight));
-            vecCheckedRays.emplace_back(false, CRay3(cNearBottomRight, cNearBottomLeft));
-            vecCheckedRays.emplace_back(false, CRay3(cNearBottomLeft, cNearTopLeft));
-            vecCheckedRays.emplace_back(false, CRay3(cFarTopLeft, cFarTopRight));
-            vecCheckedRays.emplace_back(false, CRay3(cFarTopRight, cFarBottomRight));
-            vecCheckedRays.emplace_back(false, CRay3(cFarBottomRight, cFarBottomLeft));
-            vecCheckedRays.emplace_back(false, CRay3(cFarBottomLeft, cFarTopLeft));
-            vecCheckedRays.emplace_back(false, CRay3(cNearTopLeft, cFarTopLeft));
-            vecCheckedRays.emplace_back(false, CRay3(cNearTopRight, cFarTopRight));
-            vecCheckedRays.emplace_back(false, CRay3(cNearBottomRight, cFarBottomRight));
-            vecCheckedRays.emplace_back(false, CRay3(cNearBottomLeft, cFarBottomLeft));
+            s_sensor.Frustum.AddFrustumRays(vecCheckedRays);
          }
-         //std::cerr << cFarBottomRight.GetZ() << "\t" << cFarBottomLeft.GetZ() << std::endl; TODO
-         /* generate a bounding box for the frustum */
-         cBoundingBoxMinCorner = cNearCenter;
-         cBoundingBoxMaxCorner = cNearCenter;
-         for(const CVector3& c_point : {
-               cNearTopLeft, cNearTopRight, cNearBottomLeft, cNearBottomRight, 
-               cFarTopLeft, cFarTopRight, cFarBottomLeft, cFarBottomRight
-            }) {
-            if(c_point.GetX() > cBoundingBoxMaxCorner.GetX()) {
-               cBoundingBoxMaxCorner.SetX(c_point.GetX());
-            }
-            if(c_point.GetX() < cBoundingBoxMinCorner.GetX()) {
-               cBoundingBoxMinCorner.SetX(c_point.GetX());
-            }
-            if(c_point.GetY() > cBoundingBoxMaxCorner.GetY()) {
-               cBoundingBoxMaxCorner.SetY(c_point.GetY());
-            }
-            if(c_point.GetY() < cBoundingBoxMinCorner.GetY()) {
-               cBoundingBoxMinCorner.SetY(c_point.GetY());
-            }
-            if(c_point.GetZ() > cBoundingBoxMaxCorner.GetZ()) {
-               cBoundingBoxMaxCorner.SetZ(c_point.GetZ());
-            }
-            if(c_point.GetZ() < cBoundingBoxMinCorner.GetZ()) {
-               cBoundingBoxMinCorner.SetZ(c_point.GetZ());
-            }
-         }
-         cBoundingBoxMaxCorner *= 0.5;
-         cBoundingBoxMinCorner *= 0.5;
-         cBoundingBoxPosition = (cBoundingBoxMaxCorner + cBoundingBoxMinCorner);
-         cBoundingBoxHalfExtents = (cBoundingBoxMaxCorner - cBoundingBoxMinCorner);
-         /* generate frustum planes */
-         arrFrustumPlanes[0].SetFromThreePoints(cNearTopRight, cNearTopLeft, cFarTopLeft);
-         arrFrustumPlanes[1].SetFromThreePoints(cNearBottomLeft, cNearBottomRight, cFarBottomRight);
-         arrFrustumPlanes[2].SetFromThreePoints(cNearTopLeft, cNearBottomLeft, cFarBottomLeft);
-         arrFrustumPlanes[3].SetFromThreePoints(cNearBottomRight, cNearTopRight, cFarBottomRight);
-         arrFrustumPlanes[4].SetFromThreePoints(cNearTopLeft, cNearTopRight, cNearBottomRight);
-         arrFrustumPlanes[5].SetFromThreePoints(cFarTopRight, cFarTopLeft, cFarBottomLeft);
          /* execute each algorithm */
          for(CCameraSensorSimulatedAlgorithm* pc_algorithm : s_sensor.Algorithms) {
             pc_algorithm->Update(s_sensor.ProjectionMatrix,
-                                 arrFrustumPlanes,
+                                 s_sensor.Frustum.GetPlanes(),
                                  cCameraToWorldTransform,
-                                 cCameraLocation,
-                                 cBoundingBoxPosition,
-                                 cBoundingBoxHalfExtents);
+                                 s_sensor.Frustum.GetPosition(),
+                                 s_sensor.Frustum.GetBoundingBoxPosition(),
+                                 s_sensor.Frustum.GetBoundingBoxHalfExtents());
             /* transfer any rays to the controllable entity for rendering */
             vecCheckedRays.insert(std::end(vecCheckedRays),
                                   std::begin(pc_algorithm->GetCheckedRays()),
@@ -17,6 +17,7 @@ namespace argos {
 #include <argos3/core/simulator/sensor.h>
 #include <argos3/plugins/robots/generic/control_interface/ci_camera_sensor.h>
 #include <argos3/plugins/robots/generic/simulator/camera_sensor_algorithm.h>
+#include <argos3/plugins/robots/generic/simulator/camera_sensor_frustum.h>
 
 namespace argos {
 
@@ -26,30 +27,25 @@ namespace argos {
    public:
       struct SSensor {
          SAnchor& Anchor;
-         CTransformationMatrix3 Offset;
-         CRange<Real> Range;
          CSquareMatrix<3> ProjectionMatrix;
+         CCameraSensorFrustum Frustum;
          std::vector<CCameraSensorSimulatedAlgorithm*> Algorithms;
-         Real NearPlaneWidth, NearPlaneHeight;
-         Real FarPlaneWidth, FarPlaneHeight;
          /* constructor */
          SSensor(SAnchor& s_anchor,
-                 const CTransformationMatrix3& c_offset,
+                 const CQuaternion& c_offset_orientation,
+                 const CVector3& c_offset_position,
                  const CRange<Real>& c_range,
                  const CSquareMatrix<3>& c_projection_matrix,
                  const CVector2& c_resolution,
                  const std::vector<CCameraSensorSimulatedAlgorithm*>& vec_algorithms) :
             Anchor(s_anchor),
-            Offset(c_offset),
-            Range(c_range),
             ProjectionMatrix(c_projection_matrix),
             Algorithms(vec_algorithms) {
-            Real fWidthToDepthRatio = (0.5 * c_resolution.GetX()) / c_projection_matrix(0,0);
-            Real fHeightToDepthRatio = (0.5 * c_resolution.GetY()) / c_projection_matrix(1,1);
-            NearPlaneHeight = fHeightToDepthRatio * c_range.GetMin();
-            NearPlaneWidth = fWidthToDepthRatio * c_range.GetMin();
-            FarPlaneHeight = fHeightToDepthRatio * c_range.GetMax();
-            FarPlaneWidth = fWidthToDepthRatio * c_range.GetMax();
+            Frustum.SetIntrinsics(CVector2(c_projection_matrix(0,0), c_projection_matrix(1,1)),
+                                  CVector2(c_projection_matrix(0,2), c_projection_matrix(1,2)),
+                                  c_resolution,
+                                  c_range);
+            Frustum.SetOffset(c_offset_orientation, c_offset_position);
          }
       };
 
@@ -58,10 +58,24 @@ namespace argos {
       m_vecReadings.clear();
       /* Clear out checked rays from last update */
       m_vecCheckedRays.clear();
+      /* Clear out the candidates from last update */
+      m_tOcclusionChecks.clear();
+      m_vecCandidates.clear();
       /* Run the operation */
       m_pcLEDIndex->ForEntitiesInBoxRange(c_bounding_box_position,
                                           c_bounding_box_half_extents,
                                           cUpdateOperation);
+      /* Check the occlusions of all the candidate LEDs at once */
+      GetClosestEmbodiedEntitiesIntersectedByRays(m_tOcclusionChecks);
+      for(size_t i = 0; i < m_vecCandidates.size(); ++i) {
+         if(m_tOcclusionChecks[i].Closest.IntersectedEntity != nullptr) {
+            AddCheckedRay(true, m_tOcclusionChecks[i].Ray);
+         }
+         else {
+            AddCheckedRay(false, m_tOcclusionChecks[i].Ray);
+            m_vecReadings.push_back(m_vecCandidates[i]);
+         }
+      }
    }
 
    /****************************************/
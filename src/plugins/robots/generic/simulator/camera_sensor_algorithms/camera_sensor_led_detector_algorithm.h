@@ -60,18 +60,13 @@ namespace argos {
                return true;
             }
             m_cOcclusionCheckRay.SetEnd(cLedPosition);
-            if(GetClosestEmbodiedEntityIntersectedByRay(m_sIntersectionItem, m_cOcclusionCheckRay)) {
-               m_cAlgorithm.AddCheckedRay(true, m_cOcclusionCheckRay);
-               return true;
-            }
-            m_cAlgorithm.AddCheckedRay(false, m_cOcclusionCheckRay);
-            m_cAlgorithm.AddReading(c_led.GetColor(), ProjectOntoSensor(cLedPosition));
+            /* Occlusions are checked for all the candidates at once, see Update() */
+            m_cAlgorithm.AddCandidate(m_cOcclusionCheckRay, c_led.GetColor(), ProjectOntoSensor(cLedPosition));
             return true;
          }
 
       private:
          CRay3 m_cOcclusionCheckRay;
-         SEmbodiedEntityIntersectionItem m_sIntersectionItem;
          CCameraSensorLEDDetectorAlgorithm& m_cAlgorithm;
       };
 
@@ -100,6 +95,13 @@ namespace argos {
          m_vecReadings.emplace_back(c_color, c_center);
       }
 
+      void AddCandidate(const CRay3& c_occlusion_check_ray,
+                        const CColor& c_color,
+                        const CVector2& c_center) {
+         m_tOcclusionChecks.emplace_back(c_occlusion_check_ray);
+         m_vecCandidates.emplace_back(c_color, c_center);
+      }
+
       /**
        * Returns true if the rays must be shown in the GUI.
        * @return true if the rays must be shown in the GUI.
@@ -119,6 +121,9 @@ namespace argos {
    private:
       bool                           m_bShowRays;
       CPositionalIndex<CLEDEntity>*  m_pcLEDIndex;
+      /* Occlusion checks and readings of the LEDs in the frustum */
+      TEmbodiedEntityRayQueries      m_tOcclusionChecks;
+      std::vector<SReading>          m_vecCandidates;
    };
 }         
 
@@ -58,10 +58,27 @@ namespace argos {
       m_vecReadings.clear();
       /* Clear out checked rays from last update */
       m_vecCheckedRays.clear();
+      /* Clear out the candidates from last update */
+      m_tOcclusionChecks.clear();
+      m_vecCandidates.clear();
       /* Run the operation */
       m_pcTagIndex->ForEntitiesInBoxRange(c_bounding_box_position,
                                           c_bounding_box_half_extents,
                                           cUpdateOperation);
+      /* Check the occlusions of all the candidate tag corners at once */
+      GetClosestEmbodiedEntitiesIntersectedByRays(m_tOcclusionChecks);
+      for(size_t i = 0; i < m_vecCandidates.size(); ++i) {
+         /* A tag is detected only if none of its corners is occluded */
+         bool bOccluded = false;
+         for(size_t j = 4 * i; j < 4 * i + 4; ++j) {
+            bOccluded = (m_tOcclusionChecks[j].Closest.IntersectedEntity != nullptr);
+            AddCheckedRay(bOccluded, m_tOcclusionChecks[j].Ray);
+            if(bOccluded) break;
+         }
+         if(!bOccluded) {
+            m_vecReadings.push_back(m_vecCandidates[i]);
+         }
+      }
    }
 
    /****************************************/
@@ -69,16 +69,8 @@ namespace argos {
                   return true;
                }
             }
-            for(const CVector3& c_corner : m_arrTagCorners) {
-               m_cOcclusionCheckRay.SetEnd(c_corner);
-               if(GetClosestEmbodiedEntityIntersectedByRay(m_sIntersectionItem, m_cOcclusionCheckRay)) {
-                  /* corner is occluded */
-                  m_cAlgorithm.AddCheckedRay(true, m_cOcclusionCheckRay);
-                  return true;
-               }
-               else {
-                  m_cAlgorithm.AddCheckedRay(false, m_cOcclusionCheckRay);
-               }
+            for(size_t i = 0; i < m_arrTagCorners.size(); ++i) {
+               m_arrOcclusionCheckRays[i].Set(m_cOcclusionCheckRay.GetStart(), m_arrTagCorners[i]);
             }
             std::transform(std::begin(m_arrTagCorners),
                            std::end(m_arrTagCorners),
@@ -88,7 +80,8 @@ namespace argos {
             });
             const CVector2& cCenterPixel = ProjectOntoSensor(c_tag.GetPosition());
             const std::string& strPayload = c_tag.GetPayload();
-            m_cAlgorithm.AddReading(strPayload, cCenterPixel, m_arrTagCornerPixels);
+            /* Occlusions are checked for all the candidates at once, see Update() */
+            m_cAlgorithm.AddCandidate(m_arrOcclusionCheckRays, strPayload, cCenterPixel, m_arrTagCornerPixels);
             return true;
          }
 
@@ -102,8 +95,8 @@ namespace argos {
          }};
          std::array<CVector3, 4> m_arrTagCorners;
          std::array<CVector2, 4> m_arrTagCornerPixels;
+         std::array<CRay3, 4> m_arrOcclusionCheckRays;
          CRay3 m_cOcclusionCheckRay;
-         SEmbodiedEntityIntersectionItem m_sIntersectionItem;
          CCameraSensorTagDetectorAlgorithm& m_cAlgorithm;
       };
 
@@ -134,6 +127,16 @@ namespace argos {
          m_vecReadings.emplace_back(str_payload, c_center_pixel, arr_corner_pixels);
       }
 
+      void AddCandidate(const std::array<CRay3, 4>& arr_occlusion_check_rays,
+                        const std::string& str_payload,
+                        const CVector2& c_center_pixel,
+                        const std::array<CVector2, 4>& arr_corner_pixels) {
+         for(const CRay3& c_ray : arr_occlusion_check_rays) {
+            m_tOcclusionChecks.emplace_back(c_ray);
+         }
+         m_vecCandidates.emplace_back(str_payload, c_center_pixel, arr_corner_pixels);
+      }
+
       /**
        * Returns true if the rays must be shown in the GUI.
        * @return true if the rays must be shown in the GUI.
@@ -153,6 +156,9 @@ namespace argos {
    private:
       bool                           m_bShowRays;
       CPositionalIndex<CTagEntity>*  m_pcTagIndex;
+      /* Occlusion checks (four per tag, one per corner) and readings of the tags in the frustum */
+      TEmbodiedEntityRayQueries      m_tOcclusionChecks;
+      std::vector<SReading>          m_vecCandidates;
    };
 }         
 
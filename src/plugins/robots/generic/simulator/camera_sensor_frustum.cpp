@@ -0,0 +1,236 @@
+/**
+ * @file <argos3/plugins/robots/generic/simulator/camera_sensor_frustum.cpp>
+ */
+
+#include "camera_sensor_frustum.h"
+
+#include <argos3/core/simulator/entity/composable_entity.h>
+#include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/core/simulator/entity/positional_entity.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   CCameraSensorFrustum::CCameraSensorFrustum() :
+      m_fNearPlaneWidth(0.0),
+      m_fNearPlaneHeight(0.0),
+      m_fFarPlaneWidth(0.0),
+      m_fFarPlaneHeight(0.0),
+      m_pcLastRoot(nullptr),
+      m_pcLastBody(nullptr) {}
+
+   /****************************************/
+   /****************************************/
+
+   void CCameraSensorFrustum::SetIntrinsics(const CVector2& c_focal_length,
+                                            const CVector2& c_principal_point,
+                                            const CVector2& c_resolution,
+                                            const CRange<Real>& c_range) {
+      m_cFocalLength = c_focal_length;
+      m_cPrincipalPoint = c_principal_point;
+      m_cRange = c_range;
+      /* calculate fustrum constants */
+      Real fWidthToDepthRatio = (0.5 * c_resolution.GetX()) / c_focal_length.GetX();
+      Real fHeightToDepthRatio = (0.5 * c_resolution.GetY()) / c_focal_length.GetY();
+      m_fNearPlaneHeight = fHeightToDepthRatio * c_range.GetMin();
+      m_fNearPlaneWidth = fWidthToDepthRatio * c_range.GetMin();
+      m_fFarPlaneHeight = fHeightToDepthRatio * c_range.GetMax();
+      m_fFarPlaneWidth = fWidthToDepthRatio * c_range.GetMax();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CCameraSensorFrustum::SetOffset(const CQuaternion& c_orientation,
+                                        const CVector3& c_position) {
+      m_cOffsetOrientation = c_orientation;
+      m_cOffsetPosition = c_position;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CCameraSensorFrustum::Update(const SAnchor& s_anchor) {
+      /* clear out the occlusion checks from the last update */
+      m_tOcclusionChecks.clear();
+      m_vecOcclusionCheckRoots.clear();
+      m_vecOccluded.clear();
+      m_pcLastRoot = nullptr;
+      m_pcLastBody = nullptr;
+      /* calculate the pose of the camera */
+      m_cPosition = m_cOffsetPosition;
+      m_cPosition.Rotate(s_anchor.Orientation);
+      m_cPosition += s_anchor.Position;
+      m_cOrientation = s_anchor.Orientation * m_cOffsetOrientation;
+      /* calculate the axes of the camera, the camera looks along its Z axis
+         and the Y axis points to the bottom of the image */
+      m_cAxisX = CVector3::X;
+      m_cAxisX.Rotate(m_cOrientation);
+      m_cAxisY = CVector3::Y;
+      m_cAxisY.Rotate(m_cOrientation);
+      m_cAxisZ = CVector3::Z;
+      m_cAxisZ.Rotate(m_cOrientation);
+      /* calculate frustum coordinates */
+      CVector3 cNearCenter(m_cPosition + m_cAxisZ * m_cRange.GetMin());
+      CVector3 cFarCenter(m_cPosition + m_cAxisZ * m_cRange.GetMax());
+      CVector3& cNearTopLeft = m_arrCorners[0];
+      CVector3& cNearTopRight = m_arrCorners[1];
+      CVector3& cNearBottomLeft = m_arrCorners[2];
+      CVector3& cNearBottomRight = m_arrCorners[3];
+      CVector3& cFarTopLeft = m_arrCorners[4];
+      CVector3& cFarTopRight = m_arrCorners[5];
+      CVector3& cFarBottomLeft = m_arrCorners[6];
+      CVector3& cFarBottomRight = m_arrCorners[7];
+      cNearTopLeft = cNearCenter - (m_cAxisY * m_fNearPlaneHeight) - (m_cAxisX * m_fNearPlaneWidth);
+      cNearTopRight = cNearCenter - (m_cAxisY * m_fNearPlaneHeight) + (m_cAxisX * m_fNearPlaneWidth);
+      cNearBottomLeft = cNearCenter + (m_cAxisY * m_fNearPlaneHeight) - (m_cAxisX * m_fNearPlaneWidth);
+      cNearBottomRight = cNearCenter + (m_cAxisY * m_fNearPlaneHeight) + (m_cAxisX * m_fNearPlaneWidth);
+      cFarTopLeft = cFarCenter - (m_cAxisY * m_fFarPlaneHeight) - (m_cAxisX * m_fFarPlaneWidth);
+      cFarTopRight = cFarCenter - (m_cAxisY * m_fFarPlaneHeight) + (m_cAxisX * m_fFarPlaneWidth);
+      cFarBottomLeft = cFarCenter + (m_cAxisY * m_fFarPlaneHeight) - (m_cAxisX * m_fFarPlaneWidth);
+      cFarBottomRight = cFarCenter + (m_cAxisY * m_fFarPlaneHeight) + (m_cAxisX * m_fFarPlaneWidth);
+      /* generate a bounding box for the frustum */
+      CVector3 cBoundingBoxMinCorner(cNearCenter);
+      CVector3 cBoundingBoxMaxCorner(cNearCenter);
+      for(const CVector3& c_point : m_arrCorners) {
+         if(c_point.GetX() > cBoundingBoxMaxCorner.GetX()) cBoundingBoxMaxCorner.SetX(c_point.GetX());
+         if(c_point.GetX() < cBoundingBoxMinCorner.GetX()) cBoundingBoxMinCorner.SetX(c_point.GetX());
+         if(c_point.GetY() > cBoundingBoxMaxCorner.GetY()) cBoundingBoxMaxCorner.SetY(c_point.GetY());
+         if(c_point.GetY() < cBoundingBoxMinCorner.GetY()) cBoundingBoxMinCorner.SetY(c_point.GetY());
+         if(c_point.GetZ() > cBoundingBoxMaxCorner.GetZ()) cBoundingBoxMaxCorner.SetZ(c_point.GetZ());
+         if(c_point.GetZ() < cBoundingBoxMinCorner.GetZ()) cBoundingBoxMinCorner.SetZ(c_point.GetZ());
+      }
+      m_cBoundingBoxPosition = (cBoundingBoxMaxCorner + cBoundingBoxMinCorner) * 0.5;
+      m_cBoundingBoxHalfExtents = (cBoundingBoxMaxCorner - cBoundingBoxMinCorner) * 0.5;
+      /* generate frustum planes */
+      m_arrPlanes[0].SetFromThreePoints(cNearTopRight, cNearTopLeft, cFarTopLeft);
+      m_arrPlanes[1].SetFromThreePoints(cNearBottomLeft, cNearBottomRight, cFarBottomRight);
+      m_arrPlanes[2].SetFromThreePoints(cNearTopLeft, cNearBottomLeft, cFarBottomLeft);
+      m_arrPlanes[3].SetFromThreePoints(cNearBottomRight, cNearTopRight, cFarBottomRight);
+      m_arrPlanes[4].SetFromThreePoints(cNearTopLeft, cNearTopRight, cNearBottomRight);
+      m_arrPlanes[5].SetFromThreePoints(cFarTopRight, cFarTopLeft, cFarBottomLeft);
+      /* store the planes as normals and offsets for IsInsideFrustum() */
+      for(size_t i = 0; i < 6; ++i) {
+         const CVector3& cNormal = m_arrPlanes[i].GetNormal();
+         m_arrPlaneNormalX[i] = cNormal.GetX();
+         m_arrPlaneNormalY[i] = cNormal.GetY();
+         m_arrPlaneNormalZ[i] = cNormal.GetZ();
+         m_arrPlaneOffset[i] = cNormal.DotProduct(m_arrPlanes[i].GetPosition());
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CRadians CCameraSensorFrustum::GetAngleWithCamera(const CPositionalEntity& c_entity) const {
+      CVector3 cEntityToCamera(m_cPosition - c_entity.GetPosition());
+      CVector3 cEntityDirection(CVector3::Z);
+      cEntityDirection.Rotate(c_entity.GetOrientation());
+      Real fDotProduct = cEntityDirection.DotProduct(cEntityToCamera);
+      return ACos(fDotProduct / (cEntityDirection.Length() * cEntityToCamera.Length()));
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CCameraSensorFrustum::AddFrustumRays(std::vector<std::pair<bool, CRay3> >& vec_rays) const {
+      const CVector3& cNearTopLeft = m_arrCorners[0];
+      const CVector3& cNearTopRight = m_arrCorners[1];
+      const CVector3& cNearBottomLeft = m_arrCorners[2];
+      const CVector3& cNearBottomRight = m_arrCorners[3];
+      const CVector3& cFarTopLeft = m_arrCorners[4];
+      const CVector3& cFarTopRight = m_arrCorners[5];
+      const CVector3& cFarBottomLeft = m_arrCorners[6];
+      const CVector3& cFarBottomRight = m_arrCorners[7];
+      vec_rays.emplace_back(false, CRay3(cNearTopLeft, cNearTopRight));
+      vec_rays.emplace_back(false, CRay3(cNearTopRight, cNearBottomRight));
+      vec_rays.emplace_back(false, CRay3(cNearBottomRight, cNearBottomLeft));
+      vec_rays.emplace_back(false, CRay3(cNearBottomLeft, cNearTopLeft));
+      vec_rays.emplace_back(false, CRay3(cFarTopLeft, cFarTopRight));
+      vec_rays.emplace_back(false, CRay3(cFarTopRight, cFarBottomRight));
+      vec_rays.emplace_back(false, CRay3(cFarBottomRight, cFarBottomLeft));
+      vec_rays.emplace_back(false, CRay3(cFarBottomLeft, cFarTopLeft));
+      vec_rays.emplace_back(false, CRay3(cNearTopLeft, cFarTopLeft));
+      vec_rays.emplace_back(false, CRay3(cNearTopRight, cFarTopRight));
+      vec_rays.emplace_back(false, CRay3(cNearBottomRight, cFarBottomRight));
+      vec_rays.emplace_back(false, CRay3(cNearBottomLeft, cFarBottomLeft));
+   }
+
+   /****************************************/
+   /****************************************/
+
+   size_t CCameraSensorFrustum::AddOcclusionCheck(const CVector3& c_target,
+                                                  CEntity* pc_target_root) {
+      m_tOcclusionChecks.emplace_back(CRay3(m_cPosition, c_target));
+      m_vecOcclusionCheckRoots.push_back(pc_target_root);
+      return m_tOcclusionChecks.size() - 1;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CCameraSensorFrustum::CheckOcclusions(CEntity* pc_camera_root) {
+      /* each query can ignore one body: ignore the camera's, since every ray
+         starts at the camera, otherwise ignore the body of the target */
+      CEmbodiedEntity* pcCameraBody =
+         (pc_camera_root != nullptr) ? GetBody(*pc_camera_root) : nullptr;
+      for(size_t i = 0; i < m_tOcclusionChecks.size(); ++i) {
+         if(pcCameraBody != nullptr) {
+            m_tOcclusionChecks[i].IgnoredEntity = pcCameraBody;
+         }
+         else if(m_vecOcclusionCheckRoots[i] != nullptr) {
+            m_tOcclusionChecks[i].IgnoredEntity = GetBody(*m_vecOcclusionCheckRoots[i]);
+         }
+      }
+      GetClosestEmbodiedEntitiesIntersectedByRays(m_tOcclusionChecks);
+      m_vecOccluded.resize(m_tOcclusionChecks.size());
+      for(size_t i = 0; i < m_tOcclusionChecks.size(); ++i) {
+         const SEmbodiedEntityRayQuery& sCheck = m_tOcclusionChecks[i];
+         if(sCheck.Closest.IntersectedEntity == nullptr) {
+            m_vecOccluded[i] = false;
+            continue;
+         }
+         CEntity* pcTargetRoot = m_vecOcclusionCheckRoots[i];
+         CEntity* pcIntersectionRoot = &(sCheck.Closest.IntersectedEntity->GetRootEntity());
+         if(pcIntersectionRoot != pcTargetRoot &&
+            pcIntersectionRoot != pc_camera_root) {
+            m_vecOccluded[i] = true;
+            continue;
+         }
+         /* the closest body does not occlude the target, so another body
+            might be behind it: look at all the intersections of the ray */
+         m_vecOccluded[i] = false;
+         GetEmbodiedEntitiesIntersectedByRay(m_tIntersections, sCheck.Ray);
+         for(const SEmbodiedEntityIntersectionItem& s_item : m_tIntersections) {
+            pcIntersectionRoot = &(s_item.IntersectedEntity->GetRootEntity());
+            if(pcIntersectionRoot != pcTargetRoot &&
+               pcIntersectionRoot != pc_camera_root) {
+               m_vecOccluded[i] = true;
+               break;
+            }
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CEmbodiedEntity* CCameraSensorFrustum::GetBody(CEntity& c_root) {
+      /* the targets of consecutive checks often share their root */
+      if(&c_root != m_pcLastRoot) {
+         m_pcLastRoot = &c_root;
+         m_pcLastBody = nullptr;
+         CComposableEntity* pcComposable = dynamic_cast<CComposableEntity*>(&c_root);
+         if(pcComposable != nullptr && pcComposable->HasComponent("body")) {
+            m_pcLastBody = &(pcComposable->GetComponent<CEmbodiedEntity>("body"));
+         }
+      }
+      return m_pcLastBody;
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
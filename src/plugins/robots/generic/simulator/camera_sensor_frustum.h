@@ -0,0 +1,262 @@
+/**
+ * @file <argos3/plugins/robots/generic/simulator/camera_sensor_frustum.h>
+ */
+
+#ifndef CAMERA_SENSOR_FRUSTUM_H
+#define CAMERA_SENSOR_FRUSTUM_H
+
+namespace argos {
+   class CCameraSensorFrustum;
+   class CEntity;
+   class CEmbodiedEntity;
+   class CPositionalEntity;
+   struct SAnchor;
+}
+
+#include <argos3/core/utility/math/vector2.h>
+#include <argos3/core/utility/math/vector3.h>
+#include <argos3/core/utility/math/quaternion.h>
+#include <argos3/core/utility/math/range.h>
+#include <argos3/core/utility/math/plane.h>
+#include <argos3/core/utility/math/ray3.h>
+#include <argos3/core/simulator/physics_engine/physics_engine.h>
+
+#include <array>
+#include <vector>
+
+namespace argos {
+
+   /**
+    * The geometry of a simulated pinhole camera, shared by the camera sensors.
+    * <p>
+    * Update() places the camera at the given anchor and calculates the frustum
+    * once per step. The sensors then use this class to discard the entities
+    * outside the frustum, to project points onto the image, and to check
+    * occlusions. The occlusion checks are collected with AddOcclusionCheck()
+    * and run in a single batched query by CheckOcclusions().
+    * </p>
+    * <p>
+    * Points are transformed using the camera axes directly, rather than
+    * using 4x4 transformation matrices.
+    * </p>
+    */
+   class CCameraSensorFrustum {
+
+   public:
+
+      CCameraSensorFrustum();
+
+      /**
+       * Sets the intrinsic parameters of the camera.
+       * @param c_focal_length The focal length in pixels.
+       * @param c_principal_point The principal point in pixels.
+       * @param c_resolution The resolution in pixels.
+       * @param c_range The distances of the near and far planes.
+       */
+      void SetIntrinsics(const CVector2& c_focal_length,
+                         const CVector2& c_principal_point,
+                         const CVector2& c_resolution,
+                         const CRange<Real>& c_range);
+
+      /**
+       * Sets the pose of the camera with respect to its anchor.
+       * @param c_orientation The orientation offset.
+       * @param c_position The position offset.
+       */
+      void SetOffset(const CQuaternion& c_orientation,
+                     const CVector3& c_position);
+
+      /**
+       * Places the camera at the given anchor and calculates the frustum.
+       * This also clears the occlusion checks.
+       * @param s_anchor The anchor the camera is attached to.
+       */
+      void Update(const SAnchor& s_anchor);
+
+      /**
+       * Returns the position of the camera in the global coordinate system.
+       */
+      inline const CVector3& GetPosition() const {
+         return m_cPosition;
+      }
+
+      /**
+       * Returns the orientation of the camera in the global coordinate system.
+       */
+      inline const CQuaternion& GetOrientation() const {
+         return m_cOrientation;
+      }
+
+      /**
+       * Returns the planes of the frustum, with their normals pointing inwards.
+       */
+      inline const std::array<CPlane, 6>& GetPlanes() const {
+         return m_arrPlanes;
+      }
+
+      /**
+       * Returns the center of the axis-aligned bounding box of the frustum.
+       */
+      inline const CVector3& GetBoundingBoxPosition() const {
+         return m_cBoundingBoxPosition;
+      }
+
+      /**
+       * Returns the half extents of the axis-aligned bounding box of the frustum.
+       */
+      inline const CVector3& GetBoundingBoxHalfExtents() const {
+         return m_cBoundingBoxHalfExtents;
+      }
+
+      /**
+       * Returns <tt>true</tt> if the given point is inside the frustum.
+       * @param c_point The point in the global coordinate system.
+       */
+      inline bool IsInsideFrustum(const CVector3& c_point) const {
+         /* no early exit, so that the compiler can vectorize the plane tests */
+         bool bInside = true;
+         for(size_t i = 0; i < 6; ++i) {
+            bInside &= (m_arrPlaneNormalX[i] * c_point.GetX() +
+                        m_arrPlaneNormalY[i] * c_point.GetY() +
+                        m_arrPlaneNormalZ[i] * c_point.GetZ() >= m_arrPlaneOffset[i]);
+         }
+         return bInside;
+      }
+
+      /**
+       * Returns <tt>true</tt> if all the given points are inside the frustum.
+       * @param arr_points The points in the global coordinate system.
+       */
+      template <size_t N>
+      bool IsInsideFrustum(const std::array<CVector3, N>& arr_points) const {
+         bool bInside = true;
+         for(const CVector3& c_point : arr_points) {
+            bInside &= IsInsideFrustum(c_point);
+         }
+         return bInside;
+      }
+
+      /**
+       * Returns the given point in the coordinate system of the camera.
+       * @param c_point The point in the global coordinate system.
+       */
+      inline CVector3 ToCameraFrame(const CVector3& c_point) const {
+         CVector3 cOffset(c_point - m_cPosition);
+         return CVector3(cOffset.DotProduct(m_cAxisX),
+                         cOffset.DotProduct(m_cAxisY),
+                         cOffset.DotProduct(m_cAxisZ));
+      }
+
+      /**
+       * Returns the pixel onto which the given point is projected.
+       * @param c_point The point in the global coordinate system.
+       */
+      inline CVector2 ProjectOntoSensor(const CVector3& c_point) const {
+         CVector3 cPoint(ToCameraFrame(c_point));
+         return CVector2(m_cFocalLength.GetX() * cPoint.GetX() / cPoint.GetZ() + m_cPrincipalPoint.GetX(),
+                         m_cFocalLength.GetY() * cPoint.GetY() / cPoint.GetZ() + m_cPrincipalPoint.GetY());
+      }
+
+      /**
+       * Returns the angle between the Z axis of the entity and the direction to the camera.
+       * @param c_entity The entity.
+       */
+      CRadians GetAngleWithCamera(const CPositionalEntity& c_entity) const;
+
+      /**
+       * Adds the edges of the frustum to the given vector of rays.
+       * @param vec_rays The rays to draw.
+       */
+      void AddFrustumRays(std::vector<std::pair<bool, CRay3> >& vec_rays) const;
+
+      /**
+       * Adds a check of whether the given target is occluded.
+       * @param c_target The target in the global coordinate system.
+       * @param pc_target_root The root entity of the target, whose bodies do
+       * not occlude the target. If <tt>nullptr</tt>, every body occludes the target.
+       * @return The index of the check.
+       * @see CheckOcclusions
+       */
+      size_t AddOcclusionCheck(const CVector3& c_target,
+                               CEntity* pc_target_root = nullptr);
+
+      /**
+       * Runs all the occlusion checks added since the last Update().
+       * @param pc_camera_root The root entity of the robot carrying the
+       * camera, whose bodies do not occlude the targets. If <tt>nullptr</tt>,
+       * the robot can occlude the targets.
+       */
+      void CheckOcclusions(CEntity* pc_camera_root = nullptr);
+
+      /**
+       * Returns the number of occlusion checks.
+       */
+      inline size_t GetNumOcclusionChecks() const {
+         return m_tOcclusionChecks.size();
+      }
+
+      /**
+       * Returns <tt>true</tt> if the target of the given check is occluded.
+       * Only valid after CheckOcclusions().
+       * @param un_index The index of the check.
+       */
+      inline bool IsOccluded(size_t un_index) const {
+         return m_vecOccluded[un_index];
+      }
+
+      /**
+       * Returns the ray of the given check, from the camera to the target.
+       * @param un_index The index of the check.
+       */
+      inline const CRay3& GetOcclusionCheckRay(size_t un_index) const {
+         return m_tOcclusionChecks[un_index].Ray;
+      }
+
+   private:
+
+      CEmbodiedEntity* GetBody(CEntity& c_root);
+
+   private:
+
+      /* intrinsic parameters */
+      CVector2 m_cFocalLength;
+      CVector2 m_cPrincipalPoint;
+      CRange<Real> m_cRange;
+      Real m_fNearPlaneWidth;
+      Real m_fNearPlaneHeight;
+      Real m_fFarPlaneWidth;
+      Real m_fFarPlaneHeight;
+
+      /* offset from the anchor */
+      CQuaternion m_cOffsetOrientation;
+      CVector3 m_cOffsetPosition;
+
+      /* pose and axes of the camera, calculated in Update() */
+      CVector3 m_cPosition;
+      CQuaternion m_cOrientation;
+      CVector3 m_cAxisX;
+      CVector3 m_cAxisY;
+      CVector3 m_cAxisZ;
+
+      /* frustum, calculated in Update() */
+      std::array<CVector3, 8> m_arrCorners;
+      std::array<CPlane, 6> m_arrPlanes;
+      std::array<Real, 6> m_arrPlaneNormalX;
+      std::array<Real, 6> m_arrPlaneNormalY;
+      std::array<Real, 6> m_arrPlaneNormalZ;
+      std::array<Real, 6> m_arrPlaneOffset;
+      CVector3 m_cBoundingBoxPosition;
+      CVector3 m_cBoundingBoxHalfExtents;
+
+      /* occlusion checks */
+      TEmbodiedEntityRayQueries m_tOcclusionChecks;
+      std::vector<CEntity*> m_vecOcclusionCheckRoots;
+      std::vector<bool> m_vecOccluded;
+      TEmbodiedEntityIntersectionData m_tIntersections;
+      CEntity* m_pcLastRoot;
+      CEmbodiedEntity* m_pcLastBody;
+   };
+
+}
+
+#endif
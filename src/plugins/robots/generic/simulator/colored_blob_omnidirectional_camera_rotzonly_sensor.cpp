@@ -6,6 +6,7 @@
 #include <argos3/plugins/simulator/entities/led_entity.h>
 #include <argos3/plugins/simulator/entities/omnidirectional_camera_equipped_entity.h>
 #include <argos3/plugins/simulator/media/led_medium.h>
+#include <algorithm>
 
 namespace argos {
 
@@ -17,30 +18,27 @@ namespace argos {
    public:
 
       COmnidirectionalCameraLEDCheckOperation(
-         CCI_ColoredBlobOmnidirectionalCameraSensor::TBlobList& t_blobs,
+         CCI_ColoredBlobOmnidirectionalCameraSensor::SReadings& s_readings,
          COmnidirectionalCameraEquippedEntity& c_omnicam_entity,
          CEmbodiedEntity& c_embodied_entity,
          CControllableEntity& c_controllable_entity,
          bool b_show_rays,
-         Real f_noise_std_dev) :
-         m_tBlobs(t_blobs),
+         Real f_noise_std_dev,
+         UInt32 un_max_blobs) :
+         m_sReadings(s_readings),
          m_cOmnicamEntity(c_omnicam_entity),
          m_cEmbodiedEntity(c_embodied_entity),
          m_cControllableEntity(c_controllable_entity),
          m_bShowRays(b_show_rays),
          m_fDistanceNoiseStdDev(f_noise_std_dev),
-         m_pcRNG(nullptr) {
+         m_pcRNG(nullptr),
+         m_unMaxBlobs(un_max_blobs) {
          m_pcRootSensingEntity = &m_cEmbodiedEntity.GetParent();
          if(m_fDistanceNoiseStdDev > 0.0f) {
             m_pcRNG = CRandom::CreateRNG("argos");
          }
       }
-      virtual ~COmnidirectionalCameraLEDCheckOperation() {
-         while(! m_tBlobs.empty()) {
-            delete m_tBlobs.back();
-            m_tBlobs.pop_back();
-         }
-      }
+      virtual ~COmnidirectionalCameraLEDCheckOperation() {}
 
       virtual bool operator()(CLEDEntity& c_led) {
          /* Process this LED only if it's lit */
@@ -61,43 +59,77 @@ namespace argos {
                                     m_cLEDRelativePos.GetY());
             if(Abs(m_cLEDRelativePos.GetX()) < m_fGroundHalfRange &&
                Abs(m_cLEDRelativePos.GetY()) < m_fGroundHalfRange &&
-               m_cLEDRelativePos.GetZ() < m_cCameraPos.GetZ() &&
-               !GetClosestEmbodiedEntityIntersectedByRay(m_sIntersectionItem,
-                                                         m_cOcclusionCheckRay,
-                                                         m_cEmbodiedEntity)) {
-               /* If noise was setup, add it */
-               if(m_fDistanceNoiseStdDev > 0.0f) {
-                  m_cLEDRelativePosXY += CVector2(
-                     m_cLEDRelativePosXY.Length() * m_pcRNG->Gaussian(m_fDistanceNoiseStdDev),
-                     m_pcRNG->Uniform(CRadians::UNSIGNED_RANGE));
-               }
-               m_tBlobs.push_back(new CCI_ColoredBlobOmnidirectionalCameraSensor::SBlob(
-                                     c_led.GetColor(),
-                                     NormalizedDifference(m_cLEDRelativePosXY.Angle(), m_cCameraOrient),
-                                     m_cLEDRelativePosXY.Length() * 100.0f));
-               if(m_bShowRays) {
-                  m_cControllableEntity.AddCheckedRay(false, CRay3(m_cCameraPos, c_led.GetPosition()));
-               }
+               m_cLEDRelativePos.GetZ() < m_cCameraPos.GetZ()) {
+               /* The LED is in range, check for occlusions later in a single batch */
+               m_tOcclusionChecks.push_back(
+                  SEmbodiedEntityRayQuery(m_cOcclusionCheckRay, &m_cEmbodiedEntity));
+               m_vecCandidates.push_back(
+                  SCandidate(c_led.GetColor(), m_cLEDRelativePosXY));
             }
          }
          return true;
       }
 
-      void Setup(Real f_ground_half_range) {
-         while(! m_tBlobs.empty()) {
-            delete m_tBlobs.back();
-            m_tBlobs.pop_back();
+      void Finish() {
+         /* Check occlusions for all the candidate LEDs at once */
+         GetClosestEmbodiedEntitiesIntersectedByRays(m_tOcclusionChecks);
+         for(size_t i = 0; i < m_vecCandidates.size(); ++i) {
+            if(m_tOcclusionChecks[i].Closest.IntersectedEntity != nullptr) continue;
+            CVector2& cLEDRelativePosXY = m_vecCandidates[i].RelativePosXY;
+            /* If noise was setup, add it */
+            if(m_fDistanceNoiseStdDev > 0.0f) {
+               cLEDRelativePosXY += CVector2(
+                  cLEDRelativePosXY.Length() * m_pcRNG->Gaussian(m_fDistanceNoiseStdDev),
+                  m_pcRNG->Uniform(CRadians::UNSIGNED_RANGE));
+            }
+            m_sReadings.Blobs.emplace_back(
+               m_vecCandidates[i].Color,
+               NormalizedDifference(cLEDRelativePosXY.Angle(), m_cCameraOrient),
+               cLEDRelativePosXY.Length() * 100.0f);
+            if(m_bShowRays) {
+               m_cControllableEntity.AddCheckedRay(false, m_tOcclusionChecks[i].Ray);
+            }
          }
+         /* If the blobs are capped, keep the nearest ones */
+         if(m_unMaxBlobs > 0) {
+            CCI_ColoredBlobOmnidirectionalCameraSensor::TBlobs& tBlobs = m_sReadings.Blobs;
+            size_t unKept = std::min<size_t>(m_unMaxBlobs, tBlobs.size());
+            std::partial_sort(
+               tBlobs.begin(), tBlobs.begin() + unKept, tBlobs.end(),
+               [](const CCI_ColoredBlobOmnidirectionalCameraSensor::SBlob& s_blob1,
+                  const CCI_ColoredBlobOmnidirectionalCameraSensor::SBlob& s_blob2) {
+                  return s_blob1.Distance < s_blob2.Distance;
+               });
+            tBlobs.resize(unKept);
+         }
+         m_sReadings.UpdateBlobList();
+      }
+
+      void Setup(Real f_ground_half_range) {
+         /* Erase blobs, keeping the memory for this step */
+         m_sReadings.Clear();
          m_fGroundHalfRange = f_ground_half_range;
          m_cEmbodiedEntity.GetOriginAnchor().Orientation.ToEulerAngles(m_cCameraOrient, m_cTmp1, m_cTmp2);
          m_cCameraPos = m_cEmbodiedEntity.GetOriginAnchor().Position;
          m_cCameraPos += m_cOmnicamEntity.GetOffset();
          m_cOcclusionCheckRay.SetStart(m_cCameraPos);
+         m_tOcclusionChecks.clear();
+         m_vecCandidates.clear();
       }
       
    private:
+
+      struct SCandidate {
+         CColor Color;
+         CVector2 RelativePosXY;
+
+         SCandidate(const CColor& c_color,
+                    const CVector2& c_relative_pos_xy) :
+            Color(c_color),
+            RelativePosXY(c_relative_pos_xy) {}
+      };
       
-      CCI_ColoredBlobOmnidirectionalCameraSensor::TBlobList& m_tBlobs;
+      CCI_ColoredBlobOmnidirectionalCameraSensor::SReadings& m_sReadings;
       COmnidirectionalCameraEquippedEntity& m_cOmnicamEntity;
       CEmbodiedEntity& m_cEmbodiedEntity;
       CControllableEntity& m_cControllableEntity;
@@ -110,10 +142,12 @@ namespace argos {
       CRadians m_cTmp1, m_cTmp2;
       CVector3 m_cLEDRelativePos;
       CVector2 m_cLEDRelativePosXY;
-      SEmbodiedEntityIntersectionItem m_sIntersectionItem;
       CRay3 m_cOcclusionCheckRay;
+      TEmbodiedEntityRayQueries m_tOcclusionChecks;
+      std::vector<SCandidate> m_vecCandidates;
       Real m_fDistanceNoiseStdDev;
       CRandom::CRNG* m_pcRNG;
+      UInt32 m_unMaxBlobs;
    };
 
    /****************************************/
@@ -158,18 +192,22 @@ namespace argos {
          /* Parse noise */
          Real fDistanceNoiseStdDev = 0;
          GetNodeAttributeOrDefault(t_tree, "noise_std_dev", fDistanceNoiseStdDev, fDistanceNoiseStdDev);
+         /* Parse the maximum number of blobs, 0 means no limit */
+         UInt32 unMaxBlobs = 0;
+         GetNodeAttributeOrDefault(t_tree, "max_blobs", unMaxBlobs, unMaxBlobs);
          /* Get LED medium from id specified in the XML */
          std::string strMedium;
          GetNodeAttribute(t_tree, "medium", strMedium);
          m_pcLEDIndex = &(CSimulator::GetInstance().GetMedium<CLEDMedium>(strMedium).GetIndex());
          /* Create check operation */
          m_pcOperation = new COmnidirectionalCameraLEDCheckOperation(
-            m_sReadings.BlobList,
+            m_sReadings,
             *m_pcOmnicamEntity,
             *m_pcEmbodiedEntity,
             *m_pcControllableEntity,
             m_bShowRays,
-            fDistanceNoiseStdDev);
+            fDistanceNoiseStdDev,
+            unMaxBlobs);
       }
       catch(CARGoSException& ex) {
          THROW_ARGOSEXCEPTION_NESTED("Error initializing the colored blob omnidirectional camera rotzonly sensor", ex);
@@ -202,6 +240,8 @@ namespace argos {
                   cCameraPos.GetZ() * 0.5f),
          CVector3(fGroundHalfRange, fGroundHalfRange, cCameraPos.GetZ() * 0.5f),
          *m_pcOperation);
+      /* Check occlusions and make the blobs */
+      m_pcOperation->Finish();
    }
 
    /****************************************/
@@ -209,7 +249,7 @@ namespace argos {
 
    void CColoredBlobOmnidirectionalCameraRotZOnlySensor::Reset() {
       m_sReadings.Counter = 0;
-      m_sReadings.BlobList.clear();
+      m_sReadings.Clear();
    }
 
    /****************************************/
@@ -317,6 +357,26 @@ namespace argos {
                    "    ...\n"
                    "  </controllers>\n\n"
 
+                   "It is possible to limit the number of blobs returned at each time step with\n"
+                   "the attribute \"max_blobs\". When it is set, the blobs are sorted by distance\n"
+                   "and only the nearest ones are returned. By default, all the blobs are returned\n"
+                   "in no particular order.\n\n"
+                   "  <controllers>\n"
+                   "    ...\n"
+                   "    <my_controller ...>\n"
+                   "      ...\n"
+                   "      <sensors>\n"
+                   "        ...\n"
+                   "        <colored_blob_omnidirectional_camera implementation=\"rot_z_only\"\n"
+                   "                                             medium=\"leds\"\n"
+                   "                                             max_blobs=\"10\" />\n"
+                   "        ...\n"
+                   "      </sensors>\n"
+                   "      ...\n"
+                   "    </my_controller>\n"
+                   "    ...\n"
+                   "  </controllers>\n\n"
+
                    "OPTIMIZATION HINTS\n\n"
 
                    "1. For small swarms, enabling the sensor (and therefore causing ARGoS to\n"
@@ -6,6 +6,7 @@
 #include <argos3/plugins/simulator/entities/led_entity.h>
 #include <argos3/plugins/simulator/entities/perspective_camera_equipped_entity.h>
 #include <argos3/plugins/simulator/media/led_medium.h>
+#include <algorithm>
 
 namespace argos {
 
@@ -17,30 +18,27 @@ namespace argos {
    public:
 
       CPerspectiveCameraLEDCheckOperation(
-         CCI_ColoredBlobPerspectiveCameraSensor::TBlobList& t_blobs,
+         CCI_ColoredBlobPerspectiveCameraSensor::SReadings& s_readings,
          CPerspectiveCameraEquippedEntity& c_cam_entity,
          CEmbodiedEntity& c_embodied_entity,
          CControllableEntity& c_controllable_entity,
          bool b_show_rays,
-         Real f_noise_std_dev) :
-         m_tBlobs(t_blobs),
+         Real f_noise_std_dev,
+         UInt32 un_max_blobs) :
+         m_sReadings(s_readings),
          m_cCamEntity(c_cam_entity),
          m_cEmbodiedEntity(c_embodied_entity),
          m_cControllableEntity(c_controllable_entity),
          m_bShowRays(b_show_rays),
          m_fNoiseStdDev(f_noise_std_dev),
-         m_pcRNG(nullptr) {
+         m_pcRNG(nullptr),
+         m_unMaxBlobs(un_max_blobs) {
          m_pcRootSensingEntity = &m_cEmbodiedEntity.GetRootEntity();
          if(m_fNoiseStdDev > 0.0f) {
             m_pcRNG = CRandom::CreateRNG("argos");
          }
       }
-      virtual ~CPerspectiveCameraLEDCheckOperation() {
-         while(! m_tBlobs.empty()) {
-            delete m_tBlobs.back();
-            m_tBlobs.pop_back();
-         }
-      }
+      virtual ~CPerspectiveCameraLEDCheckOperation() {}
 
       virtual bool operator()(CLEDEntity& c_led) {
          /* Process this LED only if it's lit */
@@ -60,13 +58,11 @@ namespace argos {
              * 1. It is within the distance range AND
              * 2. It is within the aperture range AND
              * 3. There are no occlusions
+             * Occlusions are checked later for all the candidate blobs at once
              */
+            Real fDistance = m_cLEDRelative.Length();
             if(fDotProd < m_cCamEntity.GetRange() &&
-               ACos(fDotProd / m_cLEDRelative.Length()) < m_cCamEntity.GetAperture() &&
-               !GetClosestEmbodiedEntityIntersectedByRay(m_sIntersectionItem,
-                                                         m_cOcclusionCheckRay,
-                                                         m_cEmbodiedEntity)) {
-               /* The LED is visibile */
+               ACos(fDotProd / fDistance) < m_cCamEntity.GetAperture()) {
                /* Calculate the intersection point between the LED ray and the image plane */
                m_cLEDRelative.Normalize();
                m_cLEDRelative *= m_cCamEntity.GetFocalLength() / m_cLEDRelative.GetX();
@@ -90,37 +86,80 @@ namespace argos {
                if((nI >= m_cCamEntity.GetImagePxWidth() || nI < 0) ||
                   (nJ >= m_cCamEntity.GetImagePxHeight() || nJ < 0))
                   return true;
-               /* Add new blob */
-               m_tBlobs.push_back(
-                  new CCI_ColoredBlobPerspectiveCameraSensor::SBlob(
-                     c_led.GetColor(), nI, nJ));
-               /* Draw ray */
-               if(m_bShowRays) {
-                  m_cControllableEntity.AddCheckedRay(
-                     false,
-                     CRay3(m_cCamEntity.GetAnchor().Position,
-                           c_led.GetPosition()));
-               }
+               /* Add new candidate blob */
+               m_tOcclusionChecks.push_back(
+                  SEmbodiedEntityRayQuery(m_cOcclusionCheckRay, &m_cEmbodiedEntity));
+               m_vecCandidates.push_back(
+                  SCandidate(c_led.GetColor(), nI, nJ, fDistance));
             }
          }
          return true;
       }
+
+      void Finish() {
+         /* Check occlusions for all the candidate blobs at once */
+         GetClosestEmbodiedEntitiesIntersectedByRays(m_tOcclusionChecks);
+         size_t unVisible = 0;
+         for(size_t i = 0; i < m_vecCandidates.size(); ++i) {
+            if(m_tOcclusionChecks[i].Closest.IntersectedEntity != nullptr) {
+               /* The LED is occluded */
+               continue;
+            }
+            /* The LED is visible */
+            m_vecCandidates[unVisible++] = m_vecCandidates[i];
+            /* Draw ray */
+            if(m_bShowRays) {
+               m_cControllableEntity.AddCheckedRay(
+                  false,
+                  m_tOcclusionChecks[i].Ray);
+            }
+         }
+         m_vecCandidates.erase(m_vecCandidates.begin() + unVisible, m_vecCandidates.end());
+         /* If the blobs are capped, keep the nearest ones */
+         if(m_unMaxBlobs > 0) {
+            size_t unKept = std::min<size_t>(m_unMaxBlobs, m_vecCandidates.size());
+            std::partial_sort(
+               m_vecCandidates.begin(), m_vecCandidates.begin() + unKept, m_vecCandidates.end(),
+               [](const SCandidate& s_candidate1,
+                  const SCandidate& s_candidate2) {
+                  return s_candidate1.Distance < s_candidate2.Distance;
+               });
+            m_vecCandidates.erase(m_vecCandidates.begin() + unKept, m_vecCandidates.end());
+         }
+         /* Make the blobs */
+         for(size_t i = 0; i < m_vecCandidates.size(); ++i) {
+            m_sReadings.Blobs.push_back(m_vecCandidates[i].Blob);
+         }
+         m_sReadings.UpdateBlobList();
+         m_vecCandidates.clear();
+      }
       
       void Setup() {
-         /* Erase blobs */
-         while(! m_tBlobs.empty()) {
-            delete m_tBlobs.back();
-            m_tBlobs.pop_back();
-         }
+         /* Erase blobs, keeping the memory for this step */
+         m_sReadings.Clear();
          /* Reset ray start */
          m_cOcclusionCheckRay.SetStart(m_cCamEntity.GetAnchor().Position);
          /* Calculate inverse of camera orientation */
          m_cInvCameraOrient = m_cCamEntity.GetAnchor().Orientation.Inverse();
+         /* Clear the occlusion checks */
+         m_tOcclusionChecks.clear();
       }
       
    private:
+
+      struct SCandidate {
+         CCI_ColoredBlobPerspectiveCameraSensor::SBlob Blob;
+         Real Distance;
+
+         SCandidate(const CColor& c_color,
+                    SInt32 n_x,
+                    SInt32 n_y,
+                    Real f_distance) :
+            Blob(c_color, n_x, n_y),
+            Distance(f_distance) {}
+      };
       
-      CCI_ColoredBlobPerspectiveCameraSensor::TBlobList& m_tBlobs;
+      CCI_ColoredBlobPerspectiveCameraSensor::SReadings& m_sReadings;
       CPerspectiveCameraEquippedEntity& m_cCamEntity;
       CEmbodiedEntity& m_cEmbodiedEntity;
       CControllableEntity& m_cControllableEntity;
@@ -129,10 +168,12 @@ namespace argos {
       CEntity* m_pcRootSensingEntity;
       CRadians m_cTmp1, m_cTmp2;
       CVector3 m_cLEDRelative;
-      SEmbodiedEntityIntersectionItem m_sIntersectionItem;
       CRay3 m_cOcclusionCheckRay;
+      TEmbodiedEntityRayQueries m_tOcclusionChecks;
+      std::vector<SCandidate> m_vecCandidates;
       Real m_fNoiseStdDev;
       CRandom::CRNG* m_pcRNG;
+      UInt32 m_unMaxBlobs;
    };
 
    /****************************************/
@@ -177,18 +218,22 @@ namespace argos {
          /* Parse noise */
          Real fNoiseStdDev = 0.0f;
          GetNodeAttributeOrDefault(t_tree, "noise_std_dev", fNoiseStdDev, fNoiseStdDev);
+         /* Parse the maximum number of blobs, 0 means no limit */
+         UInt32 unMaxBlobs = 0;
+         GetNodeAttributeOrDefault(t_tree, "max_blobs", unMaxBlobs, unMaxBlobs);
          /* Get LED medium from id specified in the XML */
          std::string strMedium;
          GetNodeAttribute(t_tree, "medium", strMedium);
          m_pcLEDIndex = &(CSimulator::GetInstance().GetMedium<CLEDMedium>(strMedium).GetIndex());
          /* Create check operation */
          m_pcOperation = new CPerspectiveCameraLEDCheckOperation(
-            m_sReadings.BlobList,
+            m_sReadings,
             *m_pcCamEntity,
             *m_pcEmbodiedEntity,
             *m_pcControllableEntity,
             m_bShowRays,
-            fNoiseStdDev);
+            fNoiseStdDev,
+            unMaxBlobs);
       }
       catch(CARGoSException& ex) {
          THROW_ARGOSEXCEPTION_NESTED("Error initializing the colored blob perspective camera default sensor", ex);
@@ -226,6 +271,8 @@ namespace argos {
       /* Go through LED entities in box range */
       m_pcLEDIndex->ForEntitiesInBoxRange(
          cCenter, cHalfSize, *m_pcOperation);
+      /* Check occlusions and make the blobs */
+      m_pcOperation->Finish();
    }
 
    /****************************************/
@@ -233,7 +280,7 @@ namespace argos {
 
    void CColoredBlobPerspectiveCameraDefaultSensor::Reset() {
       m_sReadings.Counter = 0;
-      m_sReadings.BlobList.clear();
+      m_sReadings.Clear();
    }
 
    /****************************************/
@@ -342,6 +389,26 @@ namespace argos {
                    "      ...\n"
                    "    </my_controller>\n"
                    "    ...\n"
+                   "  </controllers>\n\n"
+
+                   "It is possible to limit the number of blobs returned at each time step with\n"
+                   "the attribute \"max_blobs\". When it is set, the blobs are sorted by the\n"
+                   "distance of their LEDs from the camera and only the nearest ones are returned.\n"
+                   "By default, all the blobs are returned in no particular order.\n\n"
+                   "  <controllers>\n"
+                   "    ...\n"
+                   "    <my_controller ...>\n"
+                   "      ...\n"
+                   "      <sensors>\n"
+                   "        ...\n"
+                   "        <colored_blob_perspective_camera implementation=\"default\"\n"
+                   "                                         medium=\"leds\"\n"
+                   "                                         max_blobs=\"10\" />\n"
+                   "        ...\n"
+                   "      </sensors>\n"
+                   "      ...\n"
+                   "    </my_controller>\n"
+                   "    ...\n"
                    "  </controllers>\n",
 
                    "Usable"
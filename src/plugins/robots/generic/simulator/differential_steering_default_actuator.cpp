@@ -145,6 +145,22 @@ namespace argos {
    /****************************************/
    /****************************************/
    
+   void CDifferentialSteeringDefaultActuator::SaveState(CByteArray& c_buffer) {
+      c_buffer << m_fCurrentVelocity[LEFT_WHEEL]
+               << m_fCurrentVelocity[RIGHT_WHEEL];
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDifferentialSteeringDefaultActuator::LoadState(CByteArray& c_buffer) {
+      c_buffer >> m_fCurrentVelocity[LEFT_WHEEL]
+               >> m_fCurrentVelocity[RIGHT_WHEEL];
+   }
+
+   /****************************************/
+   /****************************************/
+
 }
 
 REGISTER_ACTUATOR(CDifferentialSteeringDefaultActuator,
@@ -62,6 +62,10 @@ namespace argos {
 
       virtual void Reset();
 
+      virtual void SaveState(CByteArray& c_buffer);
+
+      virtual void LoadState(CByteArray& c_buffer);
+
    protected:
 
       CWheeledEntity* m_pcWheeledEntity;
@@ -59,6 +59,31 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CLEDsDefaultActuator::SaveState(CByteArray& c_buffer) {
+      c_buffer << static_cast<UInt32>(m_tSettings.size());
+      for(size_t i = 0; i < m_tSettings.size(); ++i) {
+         c_buffer << m_tSettings[i];
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLEDsDefaultActuator::LoadState(CByteArray& c_buffer) {
+      UInt32 unNumLEDs;
+      c_buffer >> unNumLEDs;
+      if(unNumLEDs != m_tSettings.size()) {
+         THROW_ARGOSEXCEPTION("The saved state of the LEDs actuator has " << unNumLEDs <<
+                              " LEDs, but the robot has " << m_tSettings.size());
+      }
+      for(size_t i = 0; i < m_tSettings.size(); ++i) {
+         c_buffer >> m_tSettings[i];
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CLEDsDefaultActuator::Destroy() {
       m_pcLEDEquippedEntity->Disable();
    }
@@ -35,6 +35,8 @@ namespace argos {
       virtual void Init(TConfigurationNode& t_tree);
       virtual void Update();
       virtual void Reset();
+      virtual void SaveState(CByteArray& c_buffer);
+      virtual void LoadState(CByteArray& c_buffer);
       virtual void Destroy();
 
    private:
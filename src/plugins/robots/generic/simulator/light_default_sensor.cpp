@@ -9,6 +9,7 @@
 #include <argos3/core/simulator/entity/composable_entity.h>
 #include <argos3/plugins/simulator/entities/light_entity.h>
 #include <argos3/plugins/simulator/entities/light_sensor_equipped_entity.h>
+#include <argos3/plugins/simulator/media/light_medium.h>
 
 #include "light_default_sensor.h"
 
@@ -23,16 +24,21 @@ namespace argos {
    /****************************************/
 
    CLightDefaultSensor::CLightDefaultSensor() :
+      m_pcEmbodiedEntity(nullptr),
       m_bShowRays(false),
       m_pcRNG(nullptr),
       m_bAddNoise(false),
-      m_cSpace(CSimulator::GetInstance().GetSpace()) {}
+      m_cSpace(CSimulator::GetInstance().GetSpace()),
+      m_pcLightMedium(nullptr) {}
 
    /****************************************/
    /****************************************/
 
    void CLightDefaultSensor::SetRobot(CComposableEntity& c_entity) {
       try {
+         if(c_entity.HasComponent("body")) {
+            m_pcEmbodiedEntity = &(c_entity.GetComponent<CEmbodiedEntity>("body"));
+         }
          m_pcControllableEntity = &(c_entity.GetComponent<CControllableEntity>("controller"));
          m_pcLightEntity = &(c_entity.GetComponent<CLightSensorEquippedEntity>("light_sensors"));
          m_pcLightEntity->Enable();
@@ -62,6 +68,15 @@ namespace argos {
             m_pcRNG = CRandom::CreateRNG("argos");
          }
          m_tReadings.resize(m_pcLightEntity->GetNumSensors());
+         /* Get the light medium, if any */
+         if(NodeAttributeExists(t_tree, "medium")) {
+            if(m_pcEmbodiedEntity == nullptr) {
+               THROW_ARGOSEXCEPTION("The light medium can be used only by robots with a body");
+            }
+            std::string strMedium;
+            GetNodeAttribute(t_tree, "medium", strMedium);
+            m_pcLightMedium = &CSimulator::GetInstance().GetMedium<CLightMedium>(strMedium);
+         }
       }
       catch(CARGoSException& ex) {
          THROW_ARGOSEXCEPTION_NESTED("Initialization error in default light sensor", ex);
@@ -80,6 +95,11 @@ namespace argos {
       }
       /* Erase readings */
       for(size_t i = 0; i < m_tReadings.size(); ++i)  m_tReadings[i] = 0.0f;
+      /* Use the light medium, if any */
+      if(m_pcLightMedium != nullptr) {
+         UpdateFromMedium();
+         return;
+      }
       /* Ray used for scanning the environment for obstacles */
       CRay3 cScanningRay;
       CVector3 cRayStart;
@@ -153,6 +173,65 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CLightDefaultSensor::UpdateFromMedium() {
+      /* Get the lights in range */
+      const SAnchor& sOrigin = m_pcEmbodiedEntity->GetOriginAnchor();
+      m_pcLightMedium->GetLightsInRange(m_vecLights, sOrigin.Position);
+      /* Check the occlusion of each light once, for all the sensors */
+      m_tOcclusionChecks.resize(m_vecLights.size());
+      for(size_t j = 0; j < m_vecLights.size(); ++j) {
+         m_tOcclusionChecks[j] = SEmbodiedEntityRayQuery(
+            CRay3(sOrigin.Position, m_vecLights[j]->GetPosition()),
+            m_pcEmbodiedEntity);
+      }
+      GetClosestEmbodiedEntitiesIntersectedByRays(m_tOcclusionChecks);
+      if(m_bShowRays) {
+         for(size_t j = 0; j < m_tOcclusionChecks.size(); ++j) {
+            const SEmbodiedEntityRayQuery& sCheck = m_tOcclusionChecks[j];
+            if(sCheck.Closest.IntersectedEntity == nullptr) {
+               m_pcControllableEntity->AddCheckedRay(false, sCheck.Ray);
+            }
+            else {
+               m_pcControllableEntity->AddIntersectionPoint(sCheck.Ray,
+                                                            sCheck.Closest.TOnRay);
+               m_pcControllableEntity->AddCheckedRay(true, sCheck.Ray);
+            }
+         }
+      }
+      /* Go through the sensors */
+      CVector3 cSensorPosition;
+      CVector3 cSensorDirection;
+      CVector3 cSensorToLight;
+      for(UInt32 i = 0; i < m_tReadings.size(); ++i) {
+         const CLightSensorEquippedEntity::SSensor& sSensor = m_pcLightEntity->GetSensor(i);
+         cSensorPosition = sSensor.Position;
+         cSensorPosition.Rotate(sSensor.Anchor.Orientation);
+         cSensorPosition += sSensor.Anchor.Position;
+         cSensorDirection = sSensor.Direction;
+         cSensorDirection.Rotate(sSensor.Anchor.Orientation);
+         /* Go through the visible lights */
+         for(size_t j = 0; j < m_vecLights.size(); ++j) {
+            if(m_tOcclusionChecks[j].Closest.IntersectedEntity == nullptr) {
+               cSensorToLight = m_vecLights[j]->GetPosition() - cSensorPosition;
+               /* The body of the robot occludes the lights behind the sensor */
+               if(cSensorToLight.DotProduct(cSensorDirection) > 0.0f) {
+                  m_tReadings[i] += CalculateReading(cSensorToLight.Length(),
+                                                     m_vecLights[j]->GetIntensity());
+               }
+            }
+         }
+         /* Apply noise to the sensor */
+         if(m_bAddNoise) {
+            m_tReadings[i] += m_pcRNG->Uniform(m_cNoiseRange);
+         }
+         /* Trunc the reading between 0 and 1 */
+         UNIT.TruncValue(m_tReadings[i]);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CLightDefaultSensor::Reset() {
       for(UInt32 i = 0; i < GetReadings().size(); ++i) {
          m_tReadings[i] = 0.0f;
@@ -249,6 +328,27 @@ namespace argos {
                    "    ...\n"
                    "  </controllers>\n\n"
 
+                   "In arenas with many lights, the sensor can use a light medium to consider\n"
+                   "only the lights within range of the robot. The occlusion of each light is then\n"
+                   "checked once from the center of the robot rather than from each sensor, and a\n"
+                   "sensor perceives a light only if the light is in front of it. This requires\n"
+                   "the robot to have a body. To use a light medium, set the \"medium\" attribute\n"
+                   "to its id, and add the lights to the same light medium:\n\n"
+                   "  <controllers>\n"
+                   "    ...\n"
+                   "    <my_controller ...>\n"
+                   "      ...\n"
+                   "      <sensors>\n"
+                   "        ...\n"
+                   "        <light implementation=\"default\"\n"
+                   "                   medium=\"lights\" />\n"
+                   "        ...\n"
+                   "      </sensors>\n"
+                   "      ...\n"
+                   "    </my_controller>\n"
+                   "    ...\n"
+                   "  </controllers>\n\n"
+
                    "OPTIMIZATION HINTS\n\n"
 
                    "1. For small swarms, enabling the light sensor (and therefore causing ARGoS to\n"
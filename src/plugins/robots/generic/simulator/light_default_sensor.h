@@ -13,6 +13,8 @@
 namespace argos {
    class CLightDefaultSensor;
    class CLightSensorEquippedEntity;
+   class CLightEntity;
+   class CLightMedium;
 }
 
 #include <argos3/plugins/robots/generic/control_interface/ci_light_sensor.h>
@@ -20,6 +22,7 @@ namespace argos {
 #include <argos3/core/utility/math/rng.h>
 #include <argos3/core/simulator/space/space.h>
 #include <argos3/core/simulator/sensor.h>
+#include <argos3/core/simulator/physics_engine/physics_engine.h>
 
 namespace argos {
 
@@ -69,6 +72,19 @@ namespace argos {
 
    protected:
 
+      /**
+       * Calculates the readings using the lights indexed by the light medium.
+       * The occlusion of each light is checked once, from the origin of the
+       * robot, and shared by all the sensors. A sensor perceives a light only
+       * if the light is in front of it.
+       */
+      void UpdateFromMedium();
+
+   protected:
+
+      /** Reference to embodied entity associated to this sensor */
+      CEmbodiedEntity* m_pcEmbodiedEntity;
+
       /** Reference to light sensor equipped entity associated to this sensor */
       CLightSensorEquippedEntity* m_pcLightEntity;
 
@@ -89,6 +105,15 @@ namespace argos {
 
       /** Reference to the space */
       CSpace& m_cSpace;
+
+      /** The light medium, or nullptr if the sensor goes through all the lights */
+      CLightMedium* m_pcLightMedium;
+
+      /** The lights in range of the robot */
+      std::vector<CLightEntity*> m_vecLights;
+
+      /** The occlusion checks between the robot and the lights in range */
+      TEmbodiedEntityRayQueries m_tOcclusionChecks;
    };
 
 }
@@ -25,6 +25,7 @@ namespace argos {
       m_pcEmbodiedEntity(nullptr),
       m_bShowRays(false),
       m_pcRNG(nullptr),
+      m_pcCounterRNG(nullptr),
       m_bAddNoise(false),
       m_cSpace(CSimulator::GetInstance().GetSpace()) {}
 
@@ -60,9 +61,22 @@ namespace argos {
          else if(fNoiseLevel > 0.0f) {
             m_bAddNoise = true;
             m_cNoiseRange.Set(-fNoiseLevel, fNoiseLevel);
-            m_pcRNG = CRandom::CreateRNG("argos");
+            /* Use a counter-based RNG? */
+            bool bCounterRNG = false;
+            GetNodeAttributeOrDefault(t_tree, "counter_rng", bCounterRNG, bCounterRNG);
+            if(bCounterRNG) {
+               m_pcCounterRNG = CRandom::CreateCounterRNG("argos");
+            }
+            else {
+               m_pcRNG = CRandom::CreateRNG("argos");
+            }
          }
          m_tReadings.resize(m_pcProximityEntity->GetNumSensors());
+         if(m_pcCounterRNG != nullptr) {
+            m_vecNoise.resize(m_tReadings.size());
+         }
+         m_tScanningRays.assign(m_pcProximityEntity->GetNumSensors(),
+                                SEmbodiedEntityRayQuery(CRay3(), m_pcEmbodiedEntity));
       }
       catch(CARGoSException& ex) {
          THROW_ARGOSEXCEPTION_NESTED("Initialization error in default proximity sensor", ex);
@@ -79,14 +93,9 @@ namespace argos {
       if (IsDisabled()) {
         return;
       }
-      /* Ray used for scanning the environment for obstacles */
-      CRay3 cScanningRay;
+      /* Compute the rays of all the sensors */
       CVector3 cRayStart, cRayEnd;
-      /* Buffers to contain data about the intersection */
-      SEmbodiedEntityIntersectionItem sIntersection;
-      /* Go through the sensors */
       for(UInt32 i = 0; i < m_tReadings.size(); ++i) {
-         /* Compute ray for sensor i */
          cRayStart = m_pcProximityEntity->GetSensor(i).Offset;
          cRayStart.Rotate(m_pcProximityEntity->GetSensor(i).Anchor.Orientation);
          cRayStart += m_pcProximityEntity->GetSensor(i).Anchor.Position;
@@ -94,12 +103,22 @@ namespace argos {
          cRayEnd += m_pcProximityEntity->GetSensor(i).Direction;
          cRayEnd.Rotate(m_pcProximityEntity->GetSensor(i).Anchor.Orientation);
          cRayEnd += m_pcProximityEntity->GetSensor(i).Anchor.Position;
-         cScanningRay.Set(cRayStart,cRayEnd);
+         m_tScanningRays[i].Ray.Set(cRayStart,cRayEnd);
+      }
+      /* Get the closest intersection for all the rays at once */
+      GetClosestEmbodiedEntitiesIntersectedByRays(m_tScanningRays);
+      /* Draw the noise of all the readings at once; the draws depend only on
+         the simulation step, not on the order in which the sensors update */
+      if(m_pcCounterRNG != nullptr) {
+         m_pcCounterRNG->SetTick(m_cSpace.GetSimulationClock());
+         m_pcCounterRNG->Uniform(m_vecNoise.data(), m_vecNoise.size(), m_cNoiseRange);
+      }
+      /* Go through the sensors */
+      for(UInt32 i = 0; i < m_tReadings.size(); ++i) {
+         const CRay3& cScanningRay = m_tScanningRays[i].Ray;
+         const SEmbodiedEntityIntersectionItem& sIntersection = m_tScanningRays[i].Closest;
          /* Compute reading */
-         /* Get the closest intersection */
-         if(GetClosestEmbodiedEntityIntersectedByRay(sIntersection,
-                                                     cScanningRay,
-                                                     *m_pcEmbodiedEntity)) {
+         if(sIntersection.IntersectedEntity != nullptr) {
             /* There is an intersection */
             if(m_bShowRays) {
                m_pcControllableEntity->AddIntersectionPoint(cScanningRay,
@@ -116,7 +135,10 @@ namespace argos {
             }
          }
          /* Apply noise to the sensor */
-         if(m_bAddNoise) {
+         if(m_pcCounterRNG != nullptr) {
+            m_tReadings[i] += m_vecNoise[i];
+         }
+         else if(m_bAddNoise) {
             m_tReadings[i] += m_pcRNG->Uniform(m_cNoiseRange);
          }
          /* Trunc the reading between 0 and 1 */
@@ -216,6 +238,31 @@ namespace argos {
                    "      ...\n"
                    "    </my_controller>\n"
                    "    ...\n"
+                   "  </controllers>\n\n"
+
+                   "By default, the noise is drawn from the Mersenne Twister generator of the\n"
+                   "\"argos\" random category. Setting the attribute \"counter_rng\" to \"true\"\n"
+                   "draws it from a counter-based generator instead. The noise of a step then\n"
+                   "depends only on the random seed, on the sensor and on the step, not on the\n"
+                   "order in which the robots are updated, so runs with a different number of\n"
+                   "threads get the same noise. The generators created after the sensor get\n"
+                   "different seeds than with the default generator, so runs with the same\n"
+                   "random seed differ from runs without \"counter_rng\".\n\n"
+
+                   "  <controllers>\n"
+                   "    ...\n"
+                   "    <my_controller ...>\n"
+                   "      ...\n"
+                   "      <sensors>\n"
+                   "        ...\n"
+                   "        <proximity implementation=\"default\"\n"
+                   "                   noise_level=\"0.1\"\n"
+                   "                   counter_rng=\"true\" />\n"
+                   "        ...\n"
+                   "      </sensors>\n"
+                   "      ...\n"
+                   "    </my_controller>\n"
+                   "    ...\n"
                    "  </controllers>\n\n",
 
                    "Usable"
@@ -80,14 +80,23 @@ namespace argos {
       /** Random number generator */
       CRandom::CRNG* m_pcRNG;
 
+      /** Counter-based random number generator, used instead of m_pcRNG if requested */
+      CRandom::CCounterRNG* m_pcCounterRNG;
+
       /** Whether to add noise or not */
       bool m_bAddNoise;
 
       /** Noise range */
       CRange<Real> m_cNoiseRange;
 
+      /** Noise drawn for each reading in the current step by the counter-based RNG */
+      std::vector<Real> m_vecNoise;
+
       /** Reference to the space */
       CSpace& m_cSpace;
+
+      /** The scanning rays of the sensors, one per reading */
+      TEmbodiedEntityRayQueries m_tScanningRays;
    };
 
 }
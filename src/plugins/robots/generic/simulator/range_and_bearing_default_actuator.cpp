@@ -36,6 +36,22 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CRangeAndBearingDefaultActuator::SaveState(CByteArray& c_buffer) {
+      AddMementoBlock(c_buffer, m_cData);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRangeAndBearingDefaultActuator::LoadState(CByteArray& c_buffer) {
+      CMementoBlockReader cReader(c_buffer);
+      cReader.NextBlock(m_cData);
+      cReader.Finish();
+   }
+
+   /****************************************/
+   /****************************************/
+
    REGISTER_ACTUATOR(CRangeAndBearingDefaultActuator,
                      "range_and_bearing", "default",
                      "Carlo Pinciroli [ilpincy@gmail.com]",
@@ -30,6 +30,8 @@ namespace argos {
       virtual void SetRobot(CComposableEntity& c_entity);
       virtual void Update();
       virtual void Reset();
+      virtual void SaveState(CByteArray& c_buffer);
+      virtual void LoadState(CByteArray& c_buffer);
 
    private:
 
@@ -55,8 +55,14 @@ namespace argos {
    void CSimpleRadiosDefaultActuator::Update() {
       for(size_t i = 0; i < m_vecInterfaces.size(); ++i) {
          CSimpleRadioEntity& cRadio = m_pcSimpleRadioEquippedEntity->GetRadio(i);
+         if(m_vecInterfaces[i].Messages.empty()) continue;
+         /* Move each message into a payload shared by all the receivers */
+         m_vecPayloads.clear();
+         for(CByteArray& c_message : m_vecInterfaces[i].Messages) {
+            m_vecPayloads.push_back(std::make_shared<const CByteArray>(std::move(c_message)));
+         }
          /* Create operation instance */
-         CSendOperation cSendOperation(cRadio, m_vecInterfaces[i].Messages);
+         CSendOperation cSendOperation(cRadio, m_vecPayloads);
          /* Calculate the coarse range of the transmitting radio */
          CVector3 cRange(1.0f, 1.0f, 1.0f);
          cRange *= cRadio.GetRange();
@@ -78,6 +84,7 @@ namespace argos {
          /* Clear any messages in the interface */
          s_interface.Messages.clear();
       }
+      m_vecPayloads.clear();
    }
 
    /****************************************/
@@ -87,8 +94,8 @@ namespace argos {
       if(&c_recv_radio != &m_cRadio) {
          Real fDistance = (c_recv_radio.GetPosition() - m_cRadio.GetPosition()).Length();
          if(fDistance < m_cRadio.GetRange()) {
-            for(const CByteArray& c_message : m_cMessages) {
-               c_recv_radio.ReceiveMessage(m_cRadio.GetPosition(), c_message);
+            for(const CSimpleRadioEntity::TPayload& c_payload : m_cMessages) {
+               c_recv_radio.ReceiveMessage(m_cRadio.GetPosition(), c_payload);
             }
          }
       }
@@ -43,7 +43,7 @@ namespace argos {
       public:
 
          CSendOperation(const CSimpleRadioEntity& c_radio,
-                        const std::vector<CByteArray>& c_messages) :
+                        const std::vector<CSimpleRadioEntity::TPayload>& c_messages) :
             m_cRadio(c_radio),
             m_cMessages(c_messages) {}
 
@@ -52,8 +52,11 @@ namespace argos {
       private:
 
          const CSimpleRadioEntity& m_cRadio;
-         const std::vector<CByteArray>& m_cMessages;
+         const std::vector<CSimpleRadioEntity::TPayload>& m_cMessages;
       };
+
+      /* The payloads of the messages being sent, reused across steps */
+      std::vector<CSimpleRadioEntity::TPayload> m_vecPayloads;
    };
 }
 
@@ -70,13 +70,13 @@ namespace argos {
          CSimpleRadioEntity& cRadio = m_pcSimpleRadioEquippedEntity->GetRadio(i);
          /* Clear messages in the interface */
          m_vecInterfaces[i].Messages.clear();
-         /* Copy messages from the radio entity to the control interface */
-         for(const std::pair<CVector3, CByteArray>& c_message : cRadio.GetMessages()) {
-            m_vecInterfaces[i].Messages.emplace_back(c_message.second);
+         /* Hand the message payloads from the radio entity to the control interface */
+         for(std::pair<CVector3, CSimpleRadioEntity::TPayload>& c_message : cRadio.GetMessages()) {
             if(m_bShowRays) {
                CRay3 cRay(c_message.first, cRadio.GetPosition());
-               m_pcControllableEntity->GetCheckedRays().emplace_back(!c_message.second.Empty(), cRay);
+               m_pcControllableEntity->GetCheckedRays().emplace_back(!c_message.second->Empty(), cRay);
             }
+            m_vecInterfaces[i].Messages.emplace_back(std::move(c_message.second));
          }
          /* Clear messages in the radio entity */
          cRadio.GetMessages().clear();
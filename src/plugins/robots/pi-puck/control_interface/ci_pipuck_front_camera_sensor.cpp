@@ -153,32 +153,24 @@ namespace argos {
       lua_getfield(pt_lua_state, -1, "front_camera");
       CLuaUtility::AddToTable(pt_lua_state, "timestamp", GetTimestamp());
       lua_getfield(pt_lua_state, -1, "tags");
-      /* get the tag count from last time */
-      size_t unLastTagCount = lua_rawlen(pt_lua_state, -1);
       const STag::TVector& vecTags = GetTags();
       for(size_t i = 0; i < vecTags.size(); ++i) {
-         CLuaUtility::StartTable(pt_lua_state, i + 1);
+         CLuaUtility::OpenTable(pt_lua_state, i + 1);
          CLuaUtility::AddToTable(pt_lua_state, "id", vecTags[i].Id);
          CLuaUtility::AddToTable(pt_lua_state, "position", vecTags[i].Position);
          CLuaUtility::AddToTable(pt_lua_state, "orientation", vecTags[i].Orientation);
          CLuaUtility::AddToTable(pt_lua_state, "center", vecTags[i].Center);
-         /* start corners */
-         CLuaUtility::StartTable(pt_lua_state, "corners");
+         /* open corners */
+         CLuaUtility::OpenTable(pt_lua_state, "corners");
          for(size_t j = 0; j < vecTags[i].Corners.size(); ++j) {           
             CLuaUtility::AddToTable(pt_lua_state, j + 1, vecTags[i].Corners[j]);
          }
-         CLuaUtility::EndTable(pt_lua_state);
-         /* end corners */
-         CLuaUtility::EndTable(pt_lua_state);
-      }
-      if(vecTags.size() < unLastTagCount) {
-         /* Remove extra tags from the last update by setting them to nil */
-         for(size_t i = vecTags.size() + 1; i <= unLastTagCount; ++i) {
-            lua_pushnumber(pt_lua_state,  i);
-            lua_pushnil   (pt_lua_state    );
-            lua_settable  (pt_lua_state, -3);
-         }
+         CLuaUtility::CloseTable(pt_lua_state);
+         /* close corners */
+         CLuaUtility::CloseTable(pt_lua_state);
       }
+      /* Remove extra tags from the last update */
+      CLuaUtility::TruncateTable(pt_lua_state, vecTags.size());
       lua_pop(pt_lua_state, 1);
       lua_pop(pt_lua_state, 1);
    }
@@ -59,25 +59,13 @@ namespace argos {
          GetNodeAttributeOrDefault(t_tree, "show_frustum", m_bShowFrustum, m_bShowFrustum);
          GetNodeAttributeOrDefault(t_tree, "show_tag_rays", m_bShowTagRays, m_bShowTagRays);
          GetNodeAttributeOrDefault(t_tree, "show_led_rays", m_bShowLEDRays, m_bShowLEDRays);
-         /* set up the project matrix */
-         m_cProjectionMatrix.SetIdentityMatrix();
-         m_cProjectionMatrix(0,0) = CCI_PiPuckFrontCameraSensor::m_cFocalLength.GetX();
-         m_cProjectionMatrix(1,1) = CCI_PiPuckFrontCameraSensor::m_cFocalLength.GetY();
-         m_cProjectionMatrix(0,2) = CCI_PiPuckFrontCameraSensor::m_cPrincipalPoint.GetX();
-         m_cProjectionMatrix(1,2) = CCI_PiPuckFrontCameraSensor::m_cPrincipalPoint.GetY();
-         /* calculate fustrum constants */
-         Real fWidthToDepthRatio = (0.5 * CCI_PiPuckFrontCameraSensor::m_cResolution.GetX()) /
-            CCI_PiPuckFrontCameraSensor::m_cFocalLength.GetX();
-         Real fHeightToDepthRatio = (0.5 * CCI_PiPuckFrontCameraSensor::m_cResolution.GetY()) /
-            CCI_PiPuckFrontCameraSensor::m_cFocalLength.GetY();
-         m_fNearPlaneHeight = fHeightToDepthRatio * CAMERA_RANGE_MIN;
-         m_fNearPlaneWidth = fWidthToDepthRatio * CAMERA_RANGE_MIN;
-         m_fFarPlaneHeight = fHeightToDepthRatio * CAMERA_RANGE_MAX;
-         m_fFarPlaneWidth = fWidthToDepthRatio * CAMERA_RANGE_MAX;
-         /* transformation matrix */
-         m_cOffset.SetFromComponents(
-            CCI_PiPuckFrontCameraSensor::m_cOrientationOffset,
-            CCI_PiPuckFrontCameraSensor::POSITION_OFFSET);
+         /* set up the camera */
+         m_cFrustum.SetIntrinsics(CCI_PiPuckFrontCameraSensor::m_cFocalLength,
+                                  CCI_PiPuckFrontCameraSensor::m_cPrincipalPoint,
+                                  CCI_PiPuckFrontCameraSensor::m_cResolution,
+                                  CRange<Real>(CAMERA_RANGE_MIN, CAMERA_RANGE_MAX));
+         m_cFrustum.SetOffset(CCI_PiPuckFrontCameraSensor::m_cOrientationOffset,
+                              CCI_PiPuckFrontCameraSensor::POSITION_OFFSET);
          /* get indices */
          std::string strTagMedium;
          GetNodeAttributeOrDefault(t_tree, "tag_medium", strTagMedium, strTagMedium);
@@ -109,103 +97,77 @@ namespace argos {
       m_fTimestamp += CPhysicsEngine::GetSimulationClockTick();
       /* if the sensor is enabled */
       if(IsEnabled()) {
-         /* TODO move these sensor parameters to class wide to avoid recalling constructors */
-         CTransformationMatrix3 cWorldToAnchorTransform;
-         CTransformationMatrix3 cWorldToCameraTransform;
-         CVector3 cLookAt, cUp;
-         CVector3 cX, cY, cZ;
-         CVector3 cFarCenter, cNearCenter;
-         std::array<CVector3, 8> arrFrustumExtents;
-         CVector3& cNearTopLeft = arrFrustumExtents[0];
-         CVector3& cNearTopRight = arrFrustumExtents[1];
-         CVector3& cNearBottomLeft = arrFrustumExtents[2];
-         CVector3& cNearBottomRight = arrFrustumExtents[3];
-         CVector3& cFarTopLeft = arrFrustumExtents[4];
-         CVector3& cFarTopRight = arrFrustumExtents[5];
-         CVector3& cFarBottomLeft = arrFrustumExtents[6];
-         CVector3& cFarBottomRight = arrFrustumExtents[7];
-         /* calculate transform matrices */
-         SAnchor& s_anchor = m_pcEmbodiedEntity->GetOriginAnchor();
-         cWorldToAnchorTransform.SetFromComponents(s_anchor.Orientation, s_anchor.Position);
-         cWorldToCameraTransform = cWorldToAnchorTransform * m_cOffset;
-         m_cCameraToWorldTransform = cWorldToCameraTransform.GetInverse();
-         /* calculate camera direction vectors */
-         m_cCameraPosition = cWorldToCameraTransform.GetTranslationVector();
-         m_cCameraOrientation = s_anchor.Orientation *
-            CCI_PiPuckFrontCameraSensor::m_cOrientationOffset;
-         cLookAt = cWorldToCameraTransform * CVector3::Z;
-         cUp = -CVector3::Y;
-         cUp.Rotate(cWorldToCameraTransform.GetRotationMatrix());
-         /* calculate direction vectors */
-         cZ = m_cCameraPosition - cLookAt;
-         cZ.Normalize();
-         cX = cUp;
-         cX.CrossProduct(cZ);
-         cX.Normalize();
-         cY = cZ;
-         cY.CrossProduct(cX);
-         /* calculate frustum coordinates */
-         cNearCenter = m_cCameraPosition - cZ * CAMERA_RANGE_MIN;
-         cFarCenter = m_cCameraPosition - cZ * CAMERA_RANGE_MAX;
-         cNearTopLeft = cNearCenter + (cY * m_fNearPlaneHeight) - (cX * m_fNearPlaneWidth);
-         cNearTopRight = cNearCenter + (cY * m_fNearPlaneHeight) + (cX * m_fNearPlaneWidth);
-         cNearBottomLeft = cNearCenter - (cY * m_fNearPlaneHeight) - (cX * m_fNearPlaneWidth);
-         cNearBottomRight = cNearCenter - (cY * m_fNearPlaneHeight) + (cX * m_fNearPlaneWidth);
-         cFarTopLeft = cFarCenter + (cY * m_fFarPlaneHeight) - (cX * m_fFarPlaneWidth);
-         cFarTopRight = cFarCenter + (cY * m_fFarPlaneHeight) + (cX * m_fFarPlaneWidth);
-         cFarBottomLeft = cFarCenter - (cY * m_fFarPlaneHeight) - (cX * m_fFarPlaneWidth);
-         cFarBottomRight = cFarCenter - (cY * m_fFarPlaneHeight) + (cX * m_fFarPlaneWidth);
+         std::vector<std::pair<bool, CRay3> >& vecCheckedRays =
+            m_pcControllableEntity->GetCheckedRays();
+         /* place the camera and calculate its frustum */
+         m_cFrustum.Update(m_pcEmbodiedEntity->GetOriginAnchor());
          /* show frustum if enabled by adding outline to the checked rays vector */
          if(m_bShowFrustum) {
-            std::vector<std::pair<bool, CRay3> >& vecCheckedRays = m_pcControllableEntity->GetCheckedRays();
-            vecCheckedRays.emplace_back(false, CRay3(cNearTopLeft, cNearTopRight));
-            vecCheckedRays.emplace_back(false, CRay3(cNearTopRight, cNearBottomRight));
-            vecCheckedRays.emplace_back(false, CRay3(cNearBottomRight, cNearBottomLeft));
-            vecCheckedRays.emplace_back(false, CRay3(cNearBottomLeft, cNearTopLeft));
-            vecCheckedRays.emplace_back(false, CRay3(cFarTopLeft, cFarTopRight));
-            vecCheckedRays.emplace_back(false, CRay3(cFarTopRight, cFarBottomRight));
-            vecCheckedRays.emplace_back(false, CRay3(cFarBottomRight, cFarBottomLeft));
-            vecCheckedRays.emplace_back(false, CRay3(cFarBottomLeft, cFarTopLeft));
-            vecCheckedRays.emplace_back(false, CRay3(cNearTopLeft, cFarTopLeft));
-            vecCheckedRays.emplace_back(false, CRay3(cNearTopRight, cFarTopRight));
-            vecCheckedRays.emplace_back(false, CRay3(cNearBottomRight, cFarBottomRight));
-            vecCheckedRays.emplace_back(false, CRay3(cNearBottomLeft, cFarBottomLeft));
+            m_cFrustum.AddFrustumRays(vecCheckedRays);
          }
-         /* generate a bounding box for the frustum */
-         CVector3 cBoundingBoxMinCorner(cNearCenter);
-         CVector3 cBoundingBoxMaxCorner(cNearCenter);
-         for(const CVector3& c_point : arrFrustumExtents) {
-            if(c_point.GetX() > cBoundingBoxMaxCorner.GetX()) cBoundingBoxMaxCorner.SetX(c_point.GetX());
-            if(c_point.GetX() < cBoundingBoxMinCorner.GetX()) cBoundingBoxMinCorner.SetX(c_point.GetX());
-            if(c_point.GetY() > cBoundingBoxMaxCorner.GetY()) cBoundingBoxMaxCorner.SetY(c_point.GetY());
-            if(c_point.GetY() < cBoundingBoxMinCorner.GetY()) cBoundingBoxMinCorner.SetY(c_point.GetY());
-            if(c_point.GetZ() > cBoundingBoxMaxCorner.GetZ()) cBoundingBoxMaxCorner.SetZ(c_point.GetZ());
-            if(c_point.GetZ() < cBoundingBoxMinCorner.GetZ()) cBoundingBoxMinCorner.SetZ(c_point.GetZ());
-         }
-         cBoundingBoxMaxCorner *= 0.5f;
-         cBoundingBoxMinCorner *= 0.5f;
-         CVector3 cBoundingBoxPosition(cBoundingBoxMaxCorner + cBoundingBoxMinCorner);
-         CVector3 cBoundingBoxHalfExtents(cBoundingBoxMaxCorner - cBoundingBoxMinCorner);
-         /* generate frustum planes */
-         m_arrFrustumPlanes[0].SetFromThreePoints(cNearTopRight, cNearTopLeft, cFarTopLeft);
-         m_arrFrustumPlanes[1].SetFromThreePoints(cNearBottomLeft, cNearBottomRight, cFarBottomRight);
-         m_arrFrustumPlanes[2].SetFromThreePoints(cNearTopLeft, cNearBottomLeft, cFarBottomLeft);
-         m_arrFrustumPlanes[3].SetFromThreePoints(cNearBottomRight, cNearTopRight, cFarBottomRight);
-         m_arrFrustumPlanes[4].SetFromThreePoints(cNearTopLeft, cNearTopRight, cNearBottomRight);
-         m_arrFrustumPlanes[5].SetFromThreePoints(cFarTopRight, cFarTopLeft, cFarBottomLeft);
-         /* set the start of the ray for checking occlusions to the camera's location */
-         m_cOcclusionCheckRay.SetStart(m_cCameraPosition);
-         /* detect tags */
+         /* collect the tags and the LEDs inside the frustum */
+         m_vecTagCandidates.clear();
+         m_vecLedCandidates.clear();
          if(m_pcTagIndex) {
-            m_pcTagIndex->ForEntitiesInBoxRange(cBoundingBoxPosition,
-                                                cBoundingBoxHalfExtents,
+            m_pcTagIndex->ForEntitiesInBoxRange(m_cFrustum.GetBoundingBoxPosition(),
+                                                m_cFrustum.GetBoundingBoxHalfExtents(),
                                                 *this);
          }
-         /* detect directional LEDs */
          if(m_pcDirectionalLEDIndex) {
-            m_pcDirectionalLEDIndex->ForEntitiesInBoxRange(cBoundingBoxPosition,
-                                                         cBoundingBoxHalfExtents,
-                                                         *this);
+            m_pcDirectionalLEDIndex->ForEntitiesInBoxRange(m_cFrustum.GetBoundingBoxPosition(),
+                                                           m_cFrustum.GetBoundingBoxHalfExtents(),
+                                                           *this);
+         }
+         /* check the occlusions of all the candidates at once */
+         m_cFrustum.CheckOcclusions();
+         /* detect tags, a tag is detected only if none of its corners is occluded */
+         for(const STagCandidate& s_candidate : m_vecTagCandidates) {
+            bool bOccluded = false;
+            for(size_t i = 0; i < 4; ++i) {
+               bOccluded = m_cFrustum.IsOccluded(s_candidate.OcclusionCheck + i);
+               if(m_bShowTagRays) {
+                  vecCheckedRays.emplace_back(bOccluded,
+                                              m_cFrustum.GetOcclusionCheckRay(s_candidate.OcclusionCheck + i));
+               }
+               if(bOccluded) {
+                  break;
+               }
+            }
+            if(bOccluded) {
+               continue;
+            }
+            const CTagEntity& cTag = *s_candidate.Tag;
+            std::transform(std::begin(s_candidate.Corners),
+                           std::end(s_candidate.Corners),
+                           std::begin(m_arrTagCornerPixels),
+                           [this] (const CVector3& c_tag_corner) {
+               return m_cFrustum.ProjectOntoSensor(c_tag_corner);
+            });
+            const CVector2& cCenterPixel = m_cFrustum.ProjectOntoSensor(cTag.GetPosition());
+            /* try to convert tag payload to an unsigned integer */
+            UInt32 unId = 0;
+            try {
+               unId = std::stoul(cTag.GetPayload());
+            }
+            catch(const std::logic_error& err_logic) {}
+            CVector3 cTagPosition = m_cFrustum.ToCameraFrame(cTag.GetPosition());
+            CQuaternion cTagOrientation = m_cFrustum.GetOrientation().Inverse() * cTag.GetOrientation();
+            /* transfer readings to the control interface */
+            m_vecTags.emplace_back(unId, cTagPosition, cTagOrientation, cCenterPixel, m_arrTagCornerPixels);
+         }
+         /* detect directional LEDs */
+         for(const SLedCandidate& s_candidate : m_vecLedCandidates) {
+            bool bOccluded = m_cFrustum.IsOccluded(s_candidate.OcclusionCheck);
+            if(!bOccluded) {
+               const CVector3& cLedPosition = s_candidate.Led->GetPosition();
+               m_vecLedCache.emplace_back(s_candidate.Led->GetColor(),
+                                          cLedPosition,
+                                          m_cFrustum.ProjectOntoSensor(cLedPosition));
+            }
+            if(m_bShowLEDRays) {
+               vecCheckedRays.emplace_back(bOccluded,
+                                           m_cFrustum.GetOcclusionCheckRay(s_candidate.OcclusionCheck));
+            }
          }
       }
    }
@@ -226,7 +188,7 @@ namespace argos {
    /****************************************/
 
    bool CPiPuckFrontCameraDefaultSensor::operator()(CTagEntity& c_tag) {
-      if(GetAngleWithCamera(c_tag) > c_tag.GetObservableAngle()) {
+      if(m_cFrustum.GetAngleWithCamera(c_tag) > c_tag.GetObservableAngle()) {
          return true;
       }
       std::transform(std::begin(m_arrTagCornerOffsets),
@@ -237,47 +199,16 @@ namespace argos {
          cCorner.Rotate(c_tag.GetOrientation());
          return (cCorner + c_tag.GetPosition());
       });
-      for(const CVector3& c_corner : m_arrTagCorners) {
-         if(IsInsideFrustum(c_corner) == false) {
-            /* no more checks necessary, move on to the next tag */
-            return true;
-         }
+      if(m_cFrustum.IsInsideFrustum(m_arrTagCorners) == false) {
+         /* no more checks necessary, move on to the next tag */
+         return true;
       }
+      /* occlusions are checked for all the candidates at once, see Update() */
+      size_t unOcclusionCheck = m_cFrustum.GetNumOcclusionChecks();
       for(const CVector3& c_corner : m_arrTagCorners) {
-         m_cOcclusionCheckRay.SetEnd(c_corner);
-         if(GetClosestEmbodiedEntityIntersectedByRay(m_sIntersectionItem, m_cOcclusionCheckRay)) {
-            /* corner is occluded */
-            if(m_bShowTagRays) {
-               m_pcControllableEntity->GetCheckedRays().emplace_back(true, m_cOcclusionCheckRay);
-            }
-            /* no more checks necessary, move on to the next tag */
-            return true;
-         }
-         else {
-            /* corner not occluded */
-            if(m_bShowTagRays) {
-               m_pcControllableEntity->GetCheckedRays().emplace_back(false, m_cOcclusionCheckRay);
-            }
-         }
+         m_cFrustum.AddOcclusionCheck(c_corner);
       }
-      std::transform(std::begin(m_arrTagCorners),
-                     std::end(m_arrTagCorners),
-                     std::begin(m_arrTagCornerPixels),
-                     [this] (const CVector3& c_tag_corner) {
-         return ProjectOntoSensor(c_tag_corner);
-      });
-      const CVector2& cCenterPixel = ProjectOntoSensor(c_tag.GetPosition());
-      /* try to convert tag payload to an unsigned integer */
-      UInt32 unId = 0;
-      try {
-         unId = std::stoul(c_tag.GetPayload());
-      }
-      catch(const std::logic_error& err_logic) {}
-      /* TODO: Update the position and orientation calculations to avoid the use of matrices */
-      CVector3 cTagPosition = m_cCameraToWorldTransform * c_tag.GetPosition();
-      CQuaternion cTagOrientation = m_cCameraOrientation.Inverse() * c_tag.GetOrientation();
-      /* transfer readings to the control interface */
-      m_vecTags.emplace_back(unId, cTagPosition, cTagOrientation, cCenterPixel, m_arrTagCornerPixels);
+      m_vecTagCandidates.push_back(STagCandidate{&c_tag, m_arrTagCorners, unOcclusionCheck});
       return true;
    }
 
@@ -288,25 +219,16 @@ namespace argos {
       if(c_led.GetColor() == CColor::BLACK) {
          return true;
       }
-      if(GetAngleWithCamera(c_led) > c_led.GetObservableAngle()) {
+      if(m_cFrustum.GetAngleWithCamera(c_led) > c_led.GetObservableAngle()) {
          return true;
       }
       const CVector3& cLedPosition = c_led.GetPosition();
-      if(IsInsideFrustum(cLedPosition) == false) {
+      if(m_cFrustum.IsInsideFrustum(cLedPosition) == false) {
          return true;
       }
-      m_cOcclusionCheckRay.SetEnd(cLedPosition);
-      if(!GetClosestEmbodiedEntityIntersectedByRay(m_sIntersectionItem, m_cOcclusionCheckRay)) {
-         m_vecLedCache.emplace_back(c_led.GetColor(), cLedPosition, ProjectOntoSensor(cLedPosition));
-         if(m_bShowLEDRays) {
-            m_pcControllableEntity->GetCheckedRays().emplace_back(false, m_cOcclusionCheckRay);
-         }
-      }
-      else {
-         if(m_bShowLEDRays) {
-            m_pcControllableEntity->GetCheckedRays().emplace_back(true, m_cOcclusionCheckRay);
-         }
-      }
+      /* occlusions are checked for all the candidates at once, see Update() */
+      size_t unOcclusionCheck = m_cFrustum.AddOcclusionCheck(cLedPosition);
+      m_vecLedCandidates.push_back(SLedCandidate{&c_led, unOcclusionCheck});
       return true;
    }
 
@@ -318,8 +240,8 @@ namespace argos {
       /* c_position is the led in camera's coordinate system, 
          transfer it to global coordinate system */
       CVector3 cLedPosition(c_position);
-      cLedPosition.Rotate(m_cCameraOrientation);
-      cLedPosition += m_cCameraPosition;
+      cLedPosition.Rotate(m_cFrustum.GetOrientation());
+      cLedPosition += m_cFrustum.GetPosition();
       /* find the closest LED */
       std::vector<SLed>::const_iterator itClosestLed =
          std::min_element(std::cbegin(m_vecLedCache),
@@ -356,47 +278,6 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   CRadians CPiPuckFrontCameraDefaultSensor::GetAngleWithCamera(const CPositionalEntity& c_entity) const {
-      CVector3 cEntityToCamera(m_cCameraPosition - c_entity.GetPosition());
-      CVector3 cEntityDirection(CVector3::Z);
-      cEntityDirection.Rotate(c_entity.GetOrientation());
-      Real fDotProduct = cEntityDirection.DotProduct(cEntityToCamera);
-      return ACos(fDotProduct / (cEntityDirection.Length() * cEntityToCamera.Length()));
-   }
-
-   /****************************************/
-   /****************************************/
-
-   CVector2 CPiPuckFrontCameraDefaultSensor::ProjectOntoSensor(const CVector3& c_point) const {
-      CVector3 cCameraToEntityTranslation(m_cCameraToWorldTransform * c_point);
-      /* this could be avoided if CVector3 inherited from CMatrix<3,1> */
-      CMatrix<3,1> cCameraToEntityTranslationMatrix;
-      cCameraToEntityTranslationMatrix(0,0) =
-         cCameraToEntityTranslation.GetX() / cCameraToEntityTranslation.GetZ();
-      cCameraToEntityTranslationMatrix(1,0) =
-         cCameraToEntityTranslation.GetY() / cCameraToEntityTranslation.GetZ();
-      cCameraToEntityTranslationMatrix(2,0) = 1.0f;
-      /* get image coordinates */
-      CMatrix<3,1> cImageCoordinates(m_cProjectionMatrix * cCameraToEntityTranslationMatrix);
-      /* return as vector2 */
-      return CVector2(cImageCoordinates(0,0), cImageCoordinates(1,0));
-   }
-
-   /****************************************/
-   /****************************************/
-
-   bool CPiPuckFrontCameraDefaultSensor::IsInsideFrustum(const CVector3& c_point) const {
-      for(const CPlane& c_plane : m_arrFrustumPlanes) {
-         if(c_plane.GetNormal().DotProduct(c_point - c_plane.GetPosition()) < 0.0) {
-            return false;
-         }
-      }
-      return true;
-   }
-
-   /****************************************/
-   /****************************************/
-
    REGISTER_SENSOR(CPiPuckFrontCameraDefaultSensor,
                    "pipuck_front_camera", "default",
                    "Michael Allwright [allsey87@gmail.com]",
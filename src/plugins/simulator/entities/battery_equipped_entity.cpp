@@ -97,6 +97,22 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CBatteryEquippedEntity::SaveState(CByteArray& c_buffer) {
+      CEntity::SaveState(c_buffer);
+      c_buffer << m_fAvailableCharge;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CBatteryEquippedEntity::LoadState(CByteArray& c_buffer) {
+      CEntity::LoadState(c_buffer);
+      c_buffer >> m_fAvailableCharge;
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CBatteryEquippedEntity::SetDischargeModel(CBatteryDischargeModel* pc_model) {
       if(m_pcDischargeModel) delete m_pcDischargeModel;
       m_pcDischargeModel = pc_model;
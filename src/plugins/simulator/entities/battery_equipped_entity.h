@@ -62,6 +62,10 @@ namespace argos {
 
       virtual void Update();
 
+      virtual void SaveState(CByteArray& c_buffer);
+
+      virtual void LoadState(CByteArray& c_buffer);
+
       Real GetFullCharge() const {
          return m_fFullCharge;
       }
@@ -75,6 +75,22 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CDirectionalLEDEntity::SaveState(CByteArray& c_buffer) {
+      CPositionalEntity::SaveState(c_buffer);
+      c_buffer << m_cColor;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDirectionalLEDEntity::LoadState(CByteArray& c_buffer) {
+      CPositionalEntity::LoadState(c_buffer);
+      c_buffer >> m_cColor;
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CDirectionalLEDEntity::SetEnabled(bool b_enabled) {
       /* Perform generic enable behavior */
       CEntity::SetEnabled(b_enabled);
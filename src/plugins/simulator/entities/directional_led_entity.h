@@ -49,6 +49,10 @@ namespace argos {
 
       virtual void Destroy();
 
+      virtual void SaveState(CByteArray& c_buffer);
+
+      virtual void LoadState(CByteArray& c_buffer);
+
       virtual void SetEnabled(bool b_enabled);
 
       /**
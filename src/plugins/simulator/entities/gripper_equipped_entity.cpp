@@ -77,6 +77,22 @@ namespace argos {
    /****************************************/
    /****************************************/
          
+   void CGripperEquippedEntity::SaveState(CByteArray& c_buffer) {
+      CEntity::SaveState(c_buffer);
+      c_buffer << m_fLockState;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CGripperEquippedEntity::LoadState(CByteArray& c_buffer) {
+      CEntity::LoadState(c_buffer);
+      c_buffer >> m_fLockState;
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CGripperEquippedEntity::SetLockState(Real f_lock_state) {
       UNIT.TruncValue(f_lock_state);
       m_fLockState = f_lock_state;
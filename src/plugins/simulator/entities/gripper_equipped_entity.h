@@ -77,6 +77,10 @@ namespace argos {
        */
       virtual void Reset();
 
+      virtual void SaveState(CByteArray& c_buffer);
+
+      virtual void LoadState(CByteArray& c_buffer);
+
       /**
        * Returns the offset of the gripper with respect to the reference point.
        * @return The offset of the gripper with respect to the reference point.
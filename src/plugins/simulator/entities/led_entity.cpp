@@ -66,6 +66,22 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CLEDEntity::SaveState(CByteArray& c_buffer) {
+      CPositionalEntity::SaveState(c_buffer);
+      c_buffer << m_cColor;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLEDEntity::LoadState(CByteArray& c_buffer) {
+      CPositionalEntity::LoadState(c_buffer);
+      c_buffer >> m_cColor;
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CLEDEntity::SetEnabled(bool b_enabled) {
       /* Perform generic enable behavior */
       CEntity::SetEnabled(b_enabled);
@@ -0,0 +1,79 @@
+/**
+ * @file <argos3/plugins/simulator/entities/led_trajectory_channel.cpp>
+ */
+
+#include "led_trajectory_channel.h"
+#include <argos3/plugins/simulator/entities/led_equipped_entity.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   CEntity* CLEDTrajectoryChannel::GetSource(CComposableEntity& c_entity) {
+      if(!c_entity.HasComponent("leds")) {
+         return nullptr;
+      }
+      return dynamic_cast<CLEDEquippedEntity*>(&c_entity.GetComponent("leds"));
+   }
+
+   /****************************************/
+   /****************************************/
+
+   UInt32 CLEDTrajectoryChannel::GetNumValues(CEntity& c_source) {
+      return static_cast<CLEDEquippedEntity&>(c_source).GetLEDs().size();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLEDTrajectoryChannel::Sample(CEntity& c_source,
+                                      void* pt_values) {
+      CLEDEquippedEntity::SActuator::TList& tLEDs = static_cast<CLEDEquippedEntity&>(c_source).GetLEDs();
+      auto* punValues = static_cast<UInt32*>(pt_values);
+      for(size_t i = 0; i < tLEDs.size(); ++i) {
+         punValues[i] = EncodeColor(tLEDs[i]->LED.GetColor());
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   UInt32 CLEDTrajectoryChannel::EncodeColor(const CColor& c_color) {
+      return
+         (static_cast<UInt32>(c_color.GetRed())   << 24) |
+         (static_cast<UInt32>(c_color.GetGreen()) << 16) |
+         (static_cast<UInt32>(c_color.GetBlue())  <<  8) |
+         static_cast<UInt32>(c_color.GetAlpha());
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CColor CLEDTrajectoryChannel::DecodeColor(UInt32 un_value) {
+      return CColor((un_value >> 24) & 0xFF,
+                    (un_value >> 16) & 0xFF,
+                    (un_value >>  8) & 0xFF,
+                    un_value & 0xFF);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_TRAJECTORY_CHANNEL(CLEDTrajectoryChannel,
+                               "leds",
+                               "Carlo Pinciroli [ilpincy@gmail.com]",
+                               "1.0",
+                               "Records the color of the LEDs of an entity.",
+                               "This channel records the color of each LED of an entity equipped with LEDs,\n"
+                               "as a 32-bit integer 0xRRGGBBAA, in the order of the LEDs.\n\n"
+                               "REQUIRED XML CONFIGURATION\n\n"
+                               "  <recording file=\"trajectory.argostrj\">\n"
+                               "    <entities type=\"foot-bot\">\n"
+                               "      <leds />\n"
+                               "    </entities>\n"
+                               "  </recording>\n",
+                               "Usable"
+      );
+
+}
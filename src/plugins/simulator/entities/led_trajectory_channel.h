@@ -0,0 +1,56 @@
+/**
+ * @file <argos3/plugins/simulator/entities/led_trajectory_channel.h>
+ */
+
+#ifndef LED_TRAJECTORY_CHANNEL_H
+#define LED_TRAJECTORY_CHANNEL_H
+
+namespace argos {
+   class CLEDTrajectoryChannel;
+   class CColor;
+}
+
+#include <argos3/core/simulator/recorder/trajectory_channel.h>
+
+namespace argos {
+
+   /**
+    * Records the color of the LEDs of an entity.
+    * Each LED is recorded as a 32-bit integer, as returned by EncodeColor().
+    */
+   class CLEDTrajectoryChannel : public CTrajectoryChannel {
+
+   public:
+
+      virtual ~CLEDTrajectoryChannel() {}
+
+      virtual ETrajectoryValueType GetValueType() const {
+         return TRAJECTORY_UINT32;
+      }
+
+      virtual CEntity* GetSource(CComposableEntity& c_entity);
+
+      virtual UInt32 GetNumValues(CEntity& c_source);
+
+      virtual void Sample(CEntity& c_source,
+                          void* pt_values);
+
+      /**
+       * Encodes a color as 0xRRGGBBAA.
+       * @param c_color The color.
+       * @return The encoded color.
+       */
+      static UInt32 EncodeColor(const CColor& c_color);
+
+      /**
+       * Decodes a color encoded by EncodeColor().
+       * @param un_value The encoded color.
+       * @return The color.
+       */
+      static CColor DecodeColor(UInt32 un_value);
+
+   };
+
+}
+
+#endif
@@ -8,6 +8,7 @@
 #include <argos3/core/simulator/simulator.h>
 #include <argos3/core/simulator/space/space.h>
 #include <argos3/plugins/simulator/media/led_medium.h>
+#include <argos3/plugins/simulator/media/light_medium.h>
 
 namespace argos {
 
@@ -16,7 +17,8 @@ namespace argos {
 
    CLightEntity::CLightEntity() :
       CLEDEntity(nullptr),
-      m_fIntensity(1.0f) {}
+      m_fIntensity(1.0f),
+      m_pcLightMedium(nullptr) {}
       
    /****************************************/
    /****************************************/
@@ -29,7 +31,8 @@ namespace argos {
                  str_id,
                  c_position,
                  c_color),
-      m_fIntensity(f_intensity) {}
+      m_fIntensity(f_intensity),
+      m_pcLightMedium(nullptr) {}
 
    /****************************************/
    /****************************************/
@@ -44,6 +47,11 @@ namespace argos {
          GetNodeAttribute(t_tree, "medium", strMedium);
          auto& cLEDMedium = CSimulator::GetInstance().GetMedium<CLEDMedium>(strMedium);
          cLEDMedium.AddEntity(*this);
+         /* The light is added to the light medium when it is added to space */
+         if(NodeAttributeExists(t_tree, "light_medium")) {
+            GetNodeAttribute(t_tree, "light_medium", strMedium);
+            m_pcLightMedium = &CSimulator::GetInstance().GetMedium<CLightMedium>(strMedium);
+         }
       }
       catch(CARGoSException& ex) {
          THROW_ARGOSEXCEPTION_NESTED("Error while initializing light entity", ex);
@@ -53,6 +61,94 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CLightEntity::SaveState(CByteArray& c_buffer) {
+      CLEDEntity::SaveState(c_buffer);
+      c_buffer << m_fIntensity;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLightEntity::LoadState(CByteArray& c_buffer) {
+      CLEDEntity::LoadState(c_buffer);
+      c_buffer >> m_fIntensity;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLightEntity::SetEnabled(bool b_enabled) {
+      /* Perform LED enable behavior */
+      CLEDEntity::SetEnabled(b_enabled);
+      if(b_enabled) {
+         /* Enable entity in light medium */
+         if(m_pcLightMedium && GetIndex() >= 0)
+            m_pcLightMedium->AddEntity(*this);
+      }
+      else {
+         /* Disable entity in light medium */
+         if(m_pcLightMedium)
+            m_pcLightMedium->RemoveEntity(*this);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CLightMedium& CLightEntity::GetLightMedium() const {
+      if(m_pcLightMedium == nullptr) {
+         THROW_ARGOSEXCEPTION("Light entity \"" << GetContext() << GetId() << "\" has no light medium associated.");
+      }
+      return *m_pcLightMedium;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CLightEntityGridCellUpdater::CLightEntityGridCellUpdater(CGrid<CLightEntity>& c_grid) :
+      m_cGrid(c_grid) {}
+
+   bool CLightEntityGridCellUpdater::operator()(SInt32 n_i,
+                                                SInt32 n_j,
+                                                SInt32 n_k,
+                                                CGrid<CLightEntity>::SCell& s_cell) {
+      /* Update cell */
+      m_cGrid.UpdateCell(n_i, n_j, n_k, *m_pcEntity);
+      /* Continue with other cells */
+      return true;
+   }
+
+   void CLightEntityGridCellUpdater::SetEntity(CLightEntity& c_entity) {
+      m_pcEntity = &c_entity;
+   }
+
+   CLightEntityGridEntityUpdater::CLightEntityGridEntityUpdater(CGrid<CLightEntity>& c_grid,
+                                                                Real f_range) :
+      m_cGrid(c_grid),
+      m_cCellUpdater(c_grid),
+      m_fRange(f_range) {}
+
+   bool CLightEntityGridEntityUpdater::operator()(CLightEntity& c_entity) {
+      /* Discard lights switched off */
+      if(c_entity.GetIntensity() > 0.0f) {
+         try {
+            Real fRange = c_entity.GetIntensity() * m_fRange;
+            m_cCellUpdater.SetEntity(c_entity);
+            m_cGrid.ForCellsInBoxRange(c_entity.GetPosition(),
+                                       CVector3(fRange, fRange, fRange),
+                                       m_cCellUpdater);
+         }
+         catch(CARGoSException& ex) {
+            THROW_ARGOSEXCEPTION_NESTED("While updating the light grid for light \"" << c_entity.GetContext() << c_entity.GetId() << "\"", ex);
+         }
+      }
+      /* Continue with the other entities */
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
    REGISTER_ENTITY(CLightEntity,
                    "light",
                    "Carlo Pinciroli [ilpincy@gmail.com]",
@@ -90,14 +186,53 @@ namespace argos {
                    "those of the cameras.\n"
                    "The 'medium' attribute is used to add the light the corresponding LED medium.\n\n"
                    "OPTIONAL XML CONFIGURATION\n\n"
-                   "None.\n",
+                   "You can also add the light to a light medium, which speeds up the light\n"
+                   "sensors that are set to use it:\n\n"
+                   "  <arena ...>\n"
+                   "    ...\n"
+                   "    <light id=\"light0\"\n"
+                   "           position=\"0.4,2.3,0.25\"\n"
+                   "           orientation=\"0,0,0\"\n"
+                   "           color=\"yellow\"\n"
+                   "           intensity=\"1.0\"\n"
+                   "           medium=\"leds\"\n"
+                   "           light_medium=\"lights\"/>\n"
+                   "    ...\n"
+                   "  </arena>\n\n"
+                   "The 'light_medium' attribute is the id of the light medium.\n",
                    "Usable"
       );
 
    /****************************************/
    /****************************************/
 
-   REGISTER_STANDARD_SPACE_OPERATIONS_ON_ENTITY(CLightEntity);
+   class CSpaceOperationAddCLightEntity : public CSpaceOperationAddEntity {
+   public:
+      void ApplyTo(CSpace& c_space, CLightEntity& c_entity) {
+         /* Add entity to space - this ensures that the light entity
+          * gets an id before being added to the light medium */
+         c_space.AddEntity(c_entity);
+         /* Enable the light entity, if it's enabled - this ensures that
+          * the entity gets added to the light medium if it's enabled */
+         if(c_entity.HasLightMedium()) {
+            c_entity.SetEnabled(c_entity.IsEnabled());
+         }
+      }
+   };
+
+   class CSpaceOperationRemoveCLightEntity : public CSpaceOperationRemoveEntity {
+   public:
+      void ApplyTo(CSpace& c_space, CLightEntity& c_entity) {
+         /* Disable the entity - this ensures that the entity is
+          * removed from the light medium */
+         c_entity.Disable();
+         /* Remove the light entity from space */
+         c_space.RemoveEntity(c_entity);
+      }
+   };
+
+   REGISTER_SPACE_OPERATION(CSpaceOperationAddEntity, CSpaceOperationAddCLightEntity, CLightEntity);
+   REGISTER_SPACE_OPERATION(CSpaceOperationRemoveEntity, CSpaceOperationRemoveCLightEntity, CLightEntity);
 
    /****************************************/
    /****************************************/
@@ -10,9 +10,11 @@
 namespace argos {
    class CLightEntity;
    class CLedEquippedEntity;
+   class CLightMedium;
 }
 
 #include <argos3/core/simulator/entity/positional_entity.h>
+#include <argos3/core/simulator/space/positional_indices/grid.h>
 #include <argos3/plugins/simulator/entities/led_equipped_entity.h>
 
 namespace argos {
@@ -34,6 +36,12 @@ namespace argos {
 
       virtual void Init(TConfigurationNode& t_tree);
 
+      virtual void SaveState(CByteArray& c_buffer);
+
+      virtual void LoadState(CByteArray& c_buffer);
+
+      virtual void SetEnabled(bool b_enabled);
+
       inline Real GetIntensity() const {
          return m_fIntensity;
       }
@@ -46,11 +54,73 @@ namespace argos {
          return "light";
       }
 
+      /**
+       * Returns <tt>true</tt> if this light is associated to a light medium.
+       * @return <tt>true</tt> if this light is associated to a light medium.
+       */
+      inline bool HasLightMedium() const {
+         return m_pcLightMedium != nullptr;
+      }
+
+      /**
+       * Returns the light medium associated to this light.
+       * @return The light medium associated to this light.
+       * @throws CARGoSException if no light medium is associated to this light.
+       */
+      CLightMedium& GetLightMedium() const;
+
    protected:
 
       Real m_fIntensity;
+
+      CLightMedium* m_pcLightMedium;
    };
 
+   /****************************************/
+   /****************************************/
+
+   class CLightEntityGridCellUpdater : public CGrid<CLightEntity>::CCellOperation {
+
+   public:
+
+      CLightEntityGridCellUpdater(CGrid<CLightEntity>& c_grid);
+
+      virtual bool operator()(SInt32 n_i,
+                              SInt32 n_j,
+                              SInt32 n_k,
+                              CGrid<CLightEntity>::SCell& s_cell);
+
+      void SetEntity(CLightEntity& c_entity);
+
+   private:
+
+      CGrid<CLightEntity>& m_cGrid;
+      CLightEntity* m_pcEntity;
+   };
+
+   /**
+    * Stores a light in all the cells within its range.
+    * The range of a light is its intensity multiplied by the given range
+    * of a unit intensity light.
+    */
+   class CLightEntityGridEntityUpdater : public CGrid<CLightEntity>::COperation {
+
+   public:
+
+      CLightEntityGridEntityUpdater(CGrid<CLightEntity>& c_grid,
+                                    Real f_range);
+      virtual bool operator()(CLightEntity& c_entity);
+
+   private:
+
+      CGrid<CLightEntity>& m_cGrid;
+      CLightEntityGridCellUpdater m_cCellUpdater;
+      Real m_fRange;
+   };
+
+   /****************************************/
+   /****************************************/
+
 }
 
 #endif
@@ -58,6 +58,22 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CMagnetEntity::SaveState(CByteArray& c_buffer) {
+      CEntity::SaveState(c_buffer);
+      c_buffer << m_cField;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CMagnetEntity::LoadState(CByteArray& c_buffer) {
+      CEntity::LoadState(c_buffer);
+      c_buffer >> m_cField;
+   }
+
+   /****************************************/
+   /****************************************/
+
    REGISTER_STANDARD_SPACE_OPERATIONS_ON_ENTITY(CMagnetEntity);
 
    /****************************************/
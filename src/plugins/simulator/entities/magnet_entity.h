@@ -37,6 +37,10 @@ namespace argos {
 
       virtual void Reset();
 
+      virtual void SaveState(CByteArray& c_buffer);
+
+      virtual void LoadState(CByteArray& c_buffer);
+
       /**
        * Returns the field of the magnet.
        * @return the field of the magnet.
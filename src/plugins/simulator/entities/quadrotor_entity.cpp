@@ -59,6 +59,32 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CQuadRotorEntity::SaveState(CByteArray& c_buffer) {
+      CEntity::SaveState(c_buffer);
+      c_buffer << static_cast<UInt8>(m_eControlMethod)
+               << m_sPositionControlData.Position
+               << m_sPositionControlData.Yaw
+               << m_sSpeedControlData.Velocity
+               << m_sSpeedControlData.RotSpeed;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQuadRotorEntity::LoadState(CByteArray& c_buffer) {
+      CEntity::LoadState(c_buffer);
+      UInt8 unControlMethod;
+      c_buffer >> unControlMethod
+               >> m_sPositionControlData.Position
+               >> m_sPositionControlData.Yaw
+               >> m_sSpeedControlData.Velocity
+               >> m_sSpeedControlData.RotSpeed;
+      m_eControlMethod = static_cast<EControlMethod>(unControlMethod);
+   }
+
+   /****************************************/
+   /****************************************/
+
    REGISTER_STANDARD_SPACE_OPERATIONS_ON_ENTITY(CQuadRotorEntity);
 
    /****************************************/
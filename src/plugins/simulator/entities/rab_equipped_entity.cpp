@@ -129,6 +129,30 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CRABEquippedEntity::SaveState(CByteArray& c_buffer) {
+      CPositionalEntity::SaveState(c_buffer);
+      AddMementoBlock(c_buffer, m_cData);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRABEquippedEntity::LoadState(CByteArray& c_buffer) {
+      CPositionalEntity::LoadState(c_buffer);
+      CMementoBlockReader cReader(c_buffer);
+      CByteArray cData;
+      cReader.NextBlock(cData);
+      cReader.Finish();
+      if(cData.Size() != m_cData.Size()) {
+         THROW_ARGOSEXCEPTION("The saved state of the range-and-bearing entity \"" << GetContext() << GetId() <<
+                              "\" carries " << cData.Size() << " bytes, but the entity has " << m_cData.Size());
+      }
+      m_cData.Swap(cData);
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CRABEquippedEntity::SetEnabled(bool b_enabled) {
       /* Perform generic enable behavior */
       CEntity::SetEnabled(b_enabled);
@@ -51,6 +51,10 @@ namespace argos {
 
       virtual void Reset();
 
+      virtual void SaveState(CByteArray& c_buffer);
+
+      virtual void LoadState(CByteArray& c_buffer);
+
       virtual void Update();
 
       virtual void SetEnabled(bool b_enabled);
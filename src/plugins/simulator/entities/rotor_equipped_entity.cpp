@@ -67,6 +67,26 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CRotorEquippedEntity::SaveState(CByteArray& c_buffer) {
+      CEntity::SaveState(c_buffer);
+      for(size_t i = 0; i < m_unNumRotors; ++i) {
+         c_buffer << m_pfRotorVelocities[i];
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRotorEquippedEntity::LoadState(CByteArray& c_buffer) {
+      CEntity::LoadState(c_buffer);
+      for(size_t i = 0; i < m_unNumRotors; ++i) {
+         c_buffer >> m_pfRotorVelocities[i];
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    const CVector3& CRotorEquippedEntity::GetRotorPosition(size_t un_index) const {
       if(un_index < m_unNumRotors) {
          return m_pcRotorPositions[un_index];
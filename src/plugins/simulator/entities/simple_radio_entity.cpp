@@ -8,6 +8,7 @@
 #include <argos3/core/simulator/space/space.h>
 #include <argos3/core/simulator/simulator.h>
 #include <argos3/plugins/simulator/media/simple_radio_medium.h>
+#include <algorithm>
 
 namespace argos {
 
@@ -17,7 +18,8 @@ namespace argos {
    CSimpleRadioEntity::CSimpleRadioEntity(CComposableEntity* pc_parent) :
       CPositionalEntity(pc_parent),
       m_pcMedium(nullptr),
-      m_fRange(0.0f) {}
+      m_fRange(0.0f),
+      m_psInbox(nullptr) {}
 
    /****************************************/
    /****************************************/
@@ -28,7 +30,15 @@ namespace argos {
                                           Real f_range) :
       CPositionalEntity(pc_parent, str_id, CVector3(), CQuaternion()),
       m_pcMedium(&c_medium),
-      m_fRange(f_range) {}
+      m_fRange(f_range),
+      m_psInbox(nullptr) {}
+
+   /****************************************/
+   /****************************************/
+
+   CSimpleRadioEntity::~CSimpleRadioEntity() {
+      ClearInbox();
+   }
 
    /****************************************/
    /****************************************/
@@ -52,6 +62,7 @@ namespace argos {
 
    void CSimpleRadioEntity::Reset() {
       /* Erase received messages */
+      ClearInbox();
       m_vecMessages.clear();
    }
 
@@ -83,6 +94,38 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   std::vector<std::pair<CVector3, CSimpleRadioEntity::TPayload> >& CSimpleRadioEntity::GetMessages() {
+      /* Take the whole inbox at once */
+      SInboxNode* psNode = m_psInbox.exchange(nullptr, std::memory_order_acquire);
+      if(psNode != nullptr) {
+         /* The inbox is a stack: append its messages in reverse */
+         size_t unFirst = m_vecMessages.size();
+         while(psNode != nullptr) {
+            m_vecMessages.emplace_back(psNode->Origin, std::move(psNode->Payload));
+            SInboxNode* psNext = psNode->Next;
+            delete psNode;
+            psNode = psNext;
+         }
+         std::reverse(m_vecMessages.begin() + unFirst, m_vecMessages.end());
+      }
+      return m_vecMessages;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSimpleRadioEntity::ClearInbox() {
+      SInboxNode* psNode = m_psInbox.exchange(nullptr, std::memory_order_acquire);
+      while(psNode != nullptr) {
+         SInboxNode* psNext = psNode->Next;
+         delete psNode;
+         psNode = psNext;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    CSimpleRadioMedium& CSimpleRadioEntity::GetMedium() const {
       if(m_pcMedium == nullptr) {
          THROW_ARGOSEXCEPTION("radio entity \"" << GetContext() << GetId() <<
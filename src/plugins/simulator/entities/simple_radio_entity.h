@@ -18,7 +18,8 @@ namespace argos {
 #include <argos3/core/utility/datatypes/byte_array.h>
 #include <argos3/core/simulator/space/positional_indices/space_hash.h>
 #include <argos3/core/simulator/space/positional_indices/grid.h>
-#include <mutex>
+#include <atomic>
+#include <memory>
 
 namespace argos {
 
@@ -32,6 +33,9 @@ namespace argos {
 
       typedef std::vector<CSimpleRadioEntity*> TList;
 
+      /** An immutable message payload, shared by all its receivers */
+      typedef std::shared_ptr<const CByteArray> TPayload;
+
    public:
 
       CSimpleRadioEntity(CComposableEntity* pc_parent);
@@ -41,7 +45,7 @@ namespace argos {
                          CSimpleRadioMedium& c_medium,
                          Real f_transmit_range);
                                             
-      virtual ~CSimpleRadioEntity() {}
+      virtual ~CSimpleRadioEntity();
 
       virtual void Init(TConfigurationNode& t_tree);
 
@@ -52,42 +56,50 @@ namespace argos {
       virtual void SetEnabled(bool b_enabled);
 
       /**
-       * Returns a constant reference to the received messages.
-       * @return A constant reference to the received messages.
+       * Returns a reference to the received messages.
+       * The messages delivered since the last call are moved from the
+       * inbox to the returned vector, in the order they were received.
+       * The payloads are shared with the sender and the other receivers.
+       * @return A reference to the received messages.
        * @see ReceiveMessage()
        */
-      inline const std::vector<std::pair<CVector3, CByteArray> >& GetMessages() const {
-         return m_vecMessages;
-      }
+      std::vector<std::pair<CVector3, TPayload> >& GetMessages();
 
       /**
-       * Returns a reference to the received messages.
-       * @return A reference to the received messages.
-       * @see ReceiveMessage()
+       * Adds data received by the radio.
+       * This method can be called concurrently by several senders: the
+       * message is pushed into a lock-free inbox and the payload is not copied.
+       * @param c_origin the origin of the message in the global coordinate system.
+       * @param c_payload the actual message, shared with the other receivers.
+       * @see GetMessages()
        */
-      inline std::vector<std::pair<CVector3, CByteArray> >& GetMessages() {
-         return m_vecMessages;
+      inline void ReceiveMessage(const CVector3& c_origin, const TPayload& c_payload) {
+         SInboxNode* psNode = new SInboxNode(c_origin, c_payload);
+         psNode->Next = m_psInbox.load(std::memory_order_relaxed);
+         while(!m_psInbox.compare_exchange_weak(psNode->Next, psNode,
+                                                std::memory_order_release,
+                                                std::memory_order_relaxed));
       }
 
       /**
-       * Adds data received by the radio
+       * Adds data received by the radio.
+       * The message is copied into a new payload.
        * @param c_origin the origin of the message in the global coordinate system.
        * @param c_message a byte array containing the actual message.
        * @see GetMessages()
        */
       inline void ReceiveMessage(const CVector3& c_origin, const CByteArray& c_message) {
-         std::unique_lock<std::mutex> cLock(m_mtxMessages);
-         m_vecMessages.emplace_back(c_origin, c_message);
+         ReceiveMessage(c_origin, std::make_shared<const CByteArray>(c_message));
       }
 
       /**
        * Checks if there has been data received by the radio
        * @return A boolean value representing whether data has been received
        * @see GetMessages()
-       * @see ClearMessages()
        */
       inline bool HasMessages() const {
-         return !m_vecMessages.empty();
+         return !m_vecMessages.empty() ||
+            m_psInbox.load(std::memory_order_acquire) != nullptr;
       }
 
       /**
@@ -137,10 +149,31 @@ namespace argos {
 
    protected:
 
+      /**
+       * Deletes the messages in the inbox.
+       */
+      void ClearInbox();
+
+   protected:
+
+      /** A message waiting in the inbox */
+      struct SInboxNode {
+         CVector3 Origin;
+         TPayload Payload;
+         SInboxNode* Next;
+
+         SInboxNode(const CVector3& c_origin,
+                    const TPayload& c_payload) :
+            Origin(c_origin),
+            Payload(c_payload),
+            Next(nullptr) {}
+      };
+
       CSimpleRadioMedium* m_pcMedium;
       Real m_fRange;
-      std::vector<std::pair<CVector3, CByteArray> > m_vecMessages;
-      std::mutex m_mtxMessages;
+      std::vector<std::pair<CVector3, TPayload> > m_vecMessages;
+      /** The messages received and not yet collected, most recent first */
+      std::atomic<SInboxNode*> m_psInbox;
 
    };
 
@@ -77,6 +77,22 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CTagEntity::SaveState(CByteArray& c_buffer) {
+      CPositionalEntity::SaveState(c_buffer);
+      c_buffer << m_strPayload;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTagEntity::LoadState(CByteArray& c_buffer) {
+      CPositionalEntity::LoadState(c_buffer);
+      c_buffer >> m_strPayload;
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CTagEntity::SetEnabled(bool b_enabled) {
       /* Perform generic enable behavior */
       CEntity::SetEnabled(b_enabled);
@@ -74,6 +74,26 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CWheeledEntity::SaveState(CByteArray& c_buffer) {
+      CEntity::SaveState(c_buffer);
+      for(size_t i = 0; i < m_unNumWheels; ++i) {
+         c_buffer << m_pfWheelVelocities[i];
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CWheeledEntity::LoadState(CByteArray& c_buffer) {
+      CEntity::LoadState(c_buffer);
+      for(size_t i = 0; i < m_unNumWheels; ++i) {
+         c_buffer >> m_pfWheelVelocities[i];
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    const CVector3& CWheeledEntity::GetWheelPosition(size_t un_index) const {
       if(un_index < m_unNumWheels) {
          return m_pcWheelPositions[un_index];
@@ -29,7 +29,8 @@ namespace argos {
          GetNodeAttribute(tArena, "size", cArenaSize);
          GetNodeAttributeOrDefault(tArena, "center", cArenaCenter, cArenaCenter);
          /* Create the positional index for LED entities */
-         if(strPosIndexMethod == "grid") {
+         if(strPosIndexMethod == "grid" ||
+            strPosIndexMethod == "grid_flat") {
             size_t punGridSize[3];
             if(!NodeAttributeExists(t_tree, "grid_size")) {
                punGridSize[0] = static_cast<UInt32>(cArenaSize.GetX());
@@ -43,7 +44,8 @@ namespace argos {
             }
             CGrid<CDirectionalLEDEntity>* pcGrid = new CGrid<CDirectionalLEDEntity>(
                cArenaCenter - cArenaSize * 0.5f, cArenaCenter + cArenaSize * 0.5f,
-               punGridSize[0], punGridSize[1], punGridSize[2]);
+               punGridSize[0], punGridSize[1], punGridSize[2],
+               strPosIndexMethod == "grid_flat");
             m_pcDirectionalLEDEntityGridUpdateOperation = new CDirectionalLEDEntityGridUpdater(*pcGrid);
             pcGrid->SetUpdateEntityOperation(m_pcDirectionalLEDEntityGridUpdateOperation);
             m_pcDirectionalLEDEntityIndex = pcGrid;
@@ -92,16 +94,14 @@ namespace argos {
    /****************************************/
 
    void CDirectionalLEDMedium::AddEntity(CDirectionalLEDEntity& c_entity) {
-      m_pcDirectionalLEDEntityIndex->AddEntity(c_entity);
-      m_pcDirectionalLEDEntityIndex->Update();
+      m_pcDirectionalLEDEntityIndex->AddEntityAndUpdate(c_entity);
    }
 
    /****************************************/
    /****************************************/
 
    void CDirectionalLEDMedium::RemoveEntity(CDirectionalLEDEntity& c_entity) {
-      m_pcDirectionalLEDEntityIndex->RemoveEntity(c_entity);
-      m_pcDirectionalLEDEntityIndex->Update();
+      m_pcDirectionalLEDEntityIndex->RemoveEntityAndUpdate(c_entity);
    }
 
    /****************************************/
@@ -118,7 +118,10 @@ namespace argos {
                    "REQUIRED XML CONFIGURATION\n\n"
                    "<directional_led id=\"led\" />\n\n"
                    "OPTIONAL XML CONFIGURATION\n\n"
-                   "None for the time being\n",
+                   "The 'index' attribute sets the positional index, and can be 'grid' (the\n"
+                   "default) or 'grid_flat'. The 'grid_size' attribute sets the number of cells\n"
+                   "along each axis, as in 'grid_size=\"10,10,1\"'. By default, the grid has cells\n"
+                   "of one meter.\n",
                    "Under development"
       );
 
@@ -35,7 +35,8 @@ namespace argos {
          GetNodeAttribute(tArena, "size", cArenaSize);
          GetNodeAttributeOrDefault(tArena, "center", cArenaCenter, cArenaCenter);
          /* Create the positional index for LED entities */
-         if(strPosIndexMethod == "grid") {
+         if(strPosIndexMethod == "grid" ||
+            strPosIndexMethod == "grid_flat") {
             size_t punGridSize[3];
             if(!NodeAttributeExists(t_tree, "grid_size")) {
                punGridSize[0] = static_cast<UInt32>(cArenaSize.GetX());
@@ -49,7 +50,8 @@ namespace argos {
             }
             CGrid<CLEDEntity>* pcGrid = new CGrid<CLEDEntity>(
                cArenaCenter - cArenaSize * 0.5f, cArenaCenter + cArenaSize * 0.5f,
-               punGridSize[0], punGridSize[1], punGridSize[2]);
+               punGridSize[0], punGridSize[1], punGridSize[2],
+               strPosIndexMethod == "grid_flat");
             m_pcLEDEntityGridUpdateOperation = new CLEDEntityGridUpdater(*pcGrid);
             pcGrid->SetUpdateEntityOperation(m_pcLEDEntityGridUpdateOperation);
             m_pcLEDEntityIndex = pcGrid;
@@ -98,16 +100,14 @@ namespace argos {
    /****************************************/
 
    void CLEDMedium::AddEntity(CLEDEntity& c_entity) {
-      m_pcLEDEntityIndex->AddEntity(c_entity);
-      m_pcLEDEntityIndex->Update();
+      m_pcLEDEntityIndex->AddEntityAndUpdate(c_entity);
    }
 
    /****************************************/
    /****************************************/
 
    void CLEDMedium::RemoveEntity(CLEDEntity& c_entity) {
-      m_pcLEDEntityIndex->RemoveEntity(c_entity);
-      m_pcLEDEntityIndex->Update();
+      m_pcLEDEntityIndex->RemoveEntityAndUpdate(c_entity);
    }
 
    /****************************************/
@@ -125,7 +125,10 @@ namespace argos {
                    "REQUIRED XML CONFIGURATION\n\n"
                    "<led id=\"led\" />\n\n"
                    "OPTIONAL XML CONFIGURATION\n\n"
-                   "None for the time being\n",
+                   "The 'index' attribute sets the positional index, and can be 'grid' (the\n"
+                   "default) or 'grid_flat'. The 'grid_size' attribute sets the number of cells\n"
+                   "along each axis, as in 'grid_size=\"10,10,1\"'. By default, the grid has cells\n"
+                   "of one meter.\n",
                    "Under development"
       );
 
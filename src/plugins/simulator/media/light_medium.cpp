@@ -0,0 +1,197 @@
+#include "light_medium.h"
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/simulator/space/positional_indices/grid.h>
+#include <argos3/core/utility/configuration/argos_exception.h>
+#include <argos3/core/utility/logging/argos_log.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   CLightMedium::CLightMedium() :
+      m_fRange(10.0),
+      m_pcLightEntityIndex(nullptr),
+      m_pcLightEntityGridUpdateOperation(nullptr) {
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CLightMedium::~CLightMedium() {
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLightMedium::Init(TConfigurationNode& t_tree) {
+      try {
+         CMedium::Init(t_tree);
+         /* Get the range of a unit intensity light */
+         GetNodeAttributeOrDefault(t_tree, "range", m_fRange, m_fRange);
+         if(m_fRange <= 0.0) {
+            THROW_ARGOSEXCEPTION("The range of the light medium must be positive, got " << m_fRange);
+         }
+         /* Get the positional index method */
+         std::string strPosIndexMethod("grid");
+         GetNodeAttributeOrDefault(t_tree, "index", strPosIndexMethod, strPosIndexMethod);
+         /* Get the arena center and size */
+         CVector3 cArenaCenter;
+         CVector3 cArenaSize;
+         TConfigurationNode& tArena = GetNode(CSimulator::GetInstance().GetConfigurationRoot(), "arena");
+         GetNodeAttribute(tArena, "size", cArenaSize);
+         GetNodeAttributeOrDefault(tArena, "center", cArenaCenter, cArenaCenter);
+         /* Create the positional index for light entities */
+         if(strPosIndexMethod == "grid" ||
+            strPosIndexMethod == "grid_flat") {
+            size_t punGridSize[3];
+            if(!NodeAttributeExists(t_tree, "grid_size")) {
+               punGridSize[0] = static_cast<UInt32>(cArenaSize.GetX());
+               punGridSize[1] = static_cast<UInt32>(cArenaSize.GetY());
+               punGridSize[2] = static_cast<UInt32>(cArenaSize.GetZ());
+            }
+            else {
+               std::string strPosGridSize;
+               GetNodeAttribute(t_tree, "grid_size", strPosGridSize);
+               ParseValues<size_t>(strPosGridSize, 3, punGridSize, ',');
+            }
+            CGrid<CLightEntity>* pcGrid = new CGrid<CLightEntity>(
+               cArenaCenter - cArenaSize * 0.5f, cArenaCenter + cArenaSize * 0.5f,
+               punGridSize[0], punGridSize[1], punGridSize[2],
+               strPosIndexMethod == "grid_flat");
+            m_pcLightEntityGridUpdateOperation = new CLightEntityGridEntityUpdater(*pcGrid, m_fRange);
+            pcGrid->SetUpdateEntityOperation(m_pcLightEntityGridUpdateOperation);
+            m_pcLightEntityIndex = pcGrid;
+         }
+         else {
+            THROW_ARGOSEXCEPTION("Unknown method \"" << strPosIndexMethod << "\" for the positional index.");
+         }
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("Error in initialization of the light medium", ex);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLightMedium::PostSpaceInit() {
+      Update();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLightMedium::Reset() {
+      m_pcLightEntityIndex->Reset();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLightMedium::Destroy() {
+      delete m_pcLightEntityIndex;
+      if(m_pcLightEntityGridUpdateOperation != nullptr) {
+         delete m_pcLightEntityGridUpdateOperation;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLightMedium::Update() {
+      /* Lights can be moved and their intensity can change, so the
+         cells they cover are recalculated at every step */
+      m_pcLightEntityIndex->Update();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLightMedium::AddEntity(CLightEntity& c_entity) {
+      m_pcLightEntityIndex->AddEntityAndUpdate(c_entity);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLightMedium::RemoveEntity(CLightEntity& c_entity) {
+      m_pcLightEntityIndex->RemoveEntityAndUpdate(c_entity);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   class CLightsInRangeCollector : public CPositionalIndex<CLightEntity>::COperation {
+
+   public:
+
+      CLightsInRangeCollector(std::vector<CLightEntity*>& vec_lights,
+                              const CVector3& c_position,
+                              Real f_range) :
+         m_vecLights(vec_lights),
+         m_cPosition(c_position),
+         m_fRange(f_range) {}
+
+      virtual bool operator()(CLightEntity& c_light) {
+         /* The cells are boxes, so discard the lights in their corners.
+            The intensity might have changed since the last update. */
+         Real fLightRange = c_light.GetIntensity() * m_fRange;
+         if(fLightRange > 0.0f &&
+            SquareDistance(c_light.GetPosition(), m_cPosition) <= fLightRange * fLightRange) {
+            m_vecLights.push_back(&c_light);
+         }
+         return true;
+      }
+
+   private:
+
+      std::vector<CLightEntity*>& m_vecLights;
+      const CVector3& m_cPosition;
+      Real m_fRange;
+   };
+
+   void CLightMedium::GetLightsInRange(std::vector<CLightEntity*>& vec_lights,
+                                       const CVector3& c_position) {
+      vec_lights.clear();
+      CLightsInRangeCollector cCollector(vec_lights, c_position, m_fRange);
+      /* A zero-size box covers the cell of the position only */
+      m_pcLightEntityIndex->ForEntitiesInBoxRange(c_position, CVector3(), cCollector);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_MEDIUM(CLightMedium,
+                   "light",
+                   "Carlo Pinciroli [ilpincy@gmail.com]",
+                   "1.0",
+                   "Indexes the lights for the light sensors.",
+                   "This medium speeds up the light sensors when the arena contains many lights.\n"
+                   "Without it, every light sensor considers every light in the arena. With it,\n"
+                   "a light is considered only by the robots within its range, and the light\n"
+                   "sensors check occlusions once per robot and light rather than once per\n"
+                   "sensor and light. To use it, add this medium to the XML configuration file,\n"
+                   "set the 'light_medium' attribute of the lights to its id, and set the\n"
+                   "'medium' attribute of the light sensors to its id.\n\n"
+                   "REQUIRED XML CONFIGURATION\n\n"
+                   "<light id=\"lights\" />\n\n"
+                   "OPTIONAL XML CONFIGURATION\n\n"
+                   "The 'range' attribute sets the distance at which a light of intensity 1.0\n"
+                   "stops being perceived. The range of a light is this value multiplied by the\n"
+                   "light intensity. The default value is 10, at which the default light sensor\n"
+                   "would read 0.01 from a light of intensity 1.0. The rot_z_only foot-bot light\n"
+                   "sensor reads zero beyond 2.5, so any value above that leaves its readings\n"
+                   "unchanged. Smaller values make the sensors faster.\n\n"
+                   "The 'index' attribute sets the positional index, and can be 'grid' (the\n"
+                   "default) or 'grid_flat'. The 'grid_size' attribute sets the number of cells\n"
+                   "along each axis, as in 'grid_size=\"10,10,1\"'. By default, the grid has cells\n"
+                   "of one meter.\n",
+                   "Under development"
+      );
+
+   /****************************************/
+   /****************************************/
+
+}
@@ -0,0 +1,101 @@
+#ifndef LIGHT_MEDIUM_H
+#define LIGHT_MEDIUM_H
+
+namespace argos {
+   class CLightMedium;
+   class CLightEntity;
+}
+
+#include <argos3/core/simulator/medium/medium.h>
+#include <argos3/core/simulator/space/positional_indices/positional_index.h>
+#include <argos3/plugins/simulator/entities/light_entity.h>
+#include <vector>
+
+namespace argos {
+
+   /**
+    * Indexes the lights for the light sensors.
+    * <p>
+    * Each light is perceived up to a distance proportional to its
+    * intensity. The medium stores each light in the grid cells within
+    * that distance, so a sensor retrieves the lights that can affect it
+    * by looking at the cell it is in, rather than going through all the
+    * lights in the arena.
+    * </p>
+    */
+   class CLightMedium : public CMedium {
+
+   public:
+
+      /**
+       * Class constructor.
+       */
+      CLightMedium();
+
+      /**
+       * Class destructor.
+       */
+      virtual ~CLightMedium();
+
+      virtual void Init(TConfigurationNode& t_tree);
+      virtual void PostSpaceInit();
+      virtual void Reset();
+      virtual void Destroy();
+      virtual void Update();
+
+     /**
+      * Adds the specified entity to the list of managed entities.
+      * @param c_entity The entity to add.
+      */
+      void AddEntity(CLightEntity& c_entity);
+
+     /**
+      * Removes the specified entity from the list of managed entities.
+      * @param c_entity The entity to remove.
+      */
+      void RemoveEntity(CLightEntity& c_entity);
+
+      /**
+       * Returns the distance at which a light of unit intensity stops being perceived.
+       * The range of a light is this value multiplied by the light intensity.
+       * @return The distance at which a light of unit intensity stops being perceived.
+       */
+      inline Real GetRange() const {
+         return m_fRange;
+      }
+
+      /**
+       * Collects the lights whose range covers the given position.
+       * Lights with zero intensity are never returned.
+       * The vector is cleared before the lights are added.
+       * This method does not modify the medium, so sensors can call it concurrently.
+       * @param vec_lights The list of lights.
+       * @param c_position The position of the sensing robot.
+       */
+      void GetLightsInRange(std::vector<CLightEntity*>& vec_lights,
+                            const CVector3& c_position);
+
+      /**
+       * Returns the light positional index.
+       * @return The light positional index.
+       */
+      CPositionalIndex<CLightEntity>& GetIndex() {
+         return *m_pcLightEntityIndex;
+      }
+
+   private:
+
+      /** The distance at which a light of unit intensity stops being perceived */
+      Real m_fRange;
+
+      /** A positional index for the light entities */
+      CPositionalIndex<CLightEntity>* m_pcLightEntityIndex;
+
+      /** The update operation for the grid positional index */
+      CLightEntityGridEntityUpdater* m_pcLightEntityGridUpdateOperation;
+
+   };
+
+}
+
+#endif
@@ -5,14 +5,27 @@
 #include <argos3/core/simulator/space/positional_indices/grid.h>
 #include <argos3/core/utility/configuration/argos_exception.h>
 #include <argos3/core/utility/logging/argos_log.h>
+#include <algorithm>
 
 namespace argos {
 
    /****************************************/
    /****************************************/
 
+   /* The number of RAB entities processed by an update task */
+   static const size_t RABS_PER_TASK = 32;
+
+   /****************************************/
+   /****************************************/
+
    CRABMedium::CRABMedium() :
-      m_bCheckOcclusions(true) {
+      m_pcRABEquippedEntityIndex(nullptr),
+      m_pcGrid(nullptr),
+      m_pcRABEquippedEntityGridUpdateOperation(nullptr),
+      m_bCheckOcclusions(true),
+      m_unNumTasks(0),
+      m_bTasksPrepared(false),
+      m_fOcclusionCacheThreshold(0.0) {
    }
 
    /****************************************/
@@ -29,6 +42,15 @@ namespace argos {
          CMedium::Init(t_tree);
          /* Check occlusions? */
          GetNodeAttributeOrDefault(t_tree, "check_occlusions", m_bCheckOcclusions, m_bCheckOcclusions);
+         /* Reuse the occlusion checks of entities that barely moved? */
+         GetNodeAttributeOrDefault(t_tree, "occlusion_cache_threshold", m_fOcclusionCacheThreshold, m_fOcclusionCacheThreshold);
+         if(m_fOcclusionCacheThreshold < 0.0) {
+            THROW_ARGOSEXCEPTION("The occlusion cache threshold must be non-negative, got " << m_fOcclusionCacheThreshold);
+         }
+         /* Split the update among the threads? */
+         bool bParallel = false;
+         GetNodeAttributeOrDefault(t_tree, "parallel", bParallel, bParallel);
+         SetUpdateParallel(bParallel);
          /* Get the positional index method */
          std::string strPosIndexMethod("grid");
          GetNodeAttributeOrDefault(t_tree, "index", strPosIndexMethod, strPosIndexMethod);
@@ -39,7 +61,8 @@ namespace argos {
          GetNodeAttribute(tArena, "size", cArenaSize);
          GetNodeAttributeOrDefault(tArena, "center", cArenaCenter, cArenaCenter);
          /* Create the positional index for embodied entities */
-         if(strPosIndexMethod == "grid") {
+         if(strPosIndexMethod == "grid" ||
+            strPosIndexMethod == "grid_flat") {
             size_t punGridSize[3];
             if(!NodeAttributeExists(t_tree, "grid_size")) {
                punGridSize[0] = static_cast<size_t>(cArenaSize.GetX());
@@ -53,10 +76,12 @@ namespace argos {
             }
             CGrid<CRABEquippedEntity>* pcGrid = new CGrid<CRABEquippedEntity>(
                cArenaCenter - cArenaSize * 0.5f, cArenaCenter + cArenaSize * 0.5f,
-               punGridSize[0], punGridSize[1], punGridSize[2]);
+               punGridSize[0], punGridSize[1], punGridSize[2],
+               strPosIndexMethod == "grid_flat");
             m_pcRABEquippedEntityGridUpdateOperation = new CRABEquippedEntityGridEntityUpdater(*pcGrid);
             pcGrid->SetUpdateEntityOperation(m_pcRABEquippedEntityGridUpdateOperation);
             m_pcRABEquippedEntityIndex = pcGrid;
+            m_pcGrid = pcGrid;
          }
          else {
             THROW_ARGOSEXCEPTION("Unknown method \"" << strPosIndexMethod << "\" for the positional index.");
@@ -86,6 +111,11 @@ namespace argos {
           ++it) {
          it->second.clear();
       }
+      /* Forget the cached occlusion checks */
+      for(size_t i = 0; i < m_vecRABs.size(); ++i) {
+         m_vecRABs[i].Visibility.clear();
+      }
+      m_bTasksPrepared = false;
    }
 
    /****************************************/
@@ -101,121 +131,240 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   static size_t HashRABPair(const std::pair<CRABEquippedEntity*, CRABEquippedEntity*>& c_pair) {
-      return
-         reinterpret_cast<size_t>(c_pair.first) ^
-         reinterpret_cast<size_t>(c_pair.second);
-   }
-
    void CRABMedium::Update() {
-      /* Update positional index of RAB entities */
-      m_pcRABEquippedEntityIndex->Update();
+      /* Run the tasks, unless the space already did */
+      if(!m_bTasksPrepared) {
+         size_t unNumTasks = PrepareUpdateTasks();
+         for(size_t i = 0; i < unNumTasks; ++i) {
+            ExecuteUpdateTask(i);
+         }
+      }
+      m_bTasksPrepared = false;
       /* Delete routing table */
       for(TRoutingTable::iterator it = m_tRoutingTable.begin();
           it != m_tRoutingTable.end();
           ++it) {
          it->second.clear();
       }
-      /* This map contains the pairs that have already been checked */
-      unordered_map<ssize_t, std::pair<CRABEquippedEntity*, CRABEquippedEntity*> > mapPairsAlreadyChecked;
-      /* Iterator for the above structure */
-      unordered_map<ssize_t, std::pair<CRABEquippedEntity*, CRABEquippedEntity*> >::iterator itPair;
-      /* Used as test key */
-      std::pair<CRABEquippedEntity*, CRABEquippedEntity*> cTestKey;
-      /* Used as hash for the test key */
-      UInt64 unTestHash;
-      /* The ray to use for occlusion checking */
-      CRay3 cOcclusionCheckRay;
-      /* Buffer for the communicating entities */
-      CSet<CRABEquippedEntity*,SEntityComparator> cOtherRABs;
-      /* Buffer to store the intersection data */
-      SEmbodiedEntityIntersectionItem sIntersectionItem;
-      /* The distance between two RABs in line of sight */
-      Real fDistance;
-      /* Go through the RAB entities */
-      for(TRoutingTable::iterator it = m_tRoutingTable.begin();
-          it != m_tRoutingTable.end();
-          ++it) {
-         /* Get a reference to the current RAB entity */
-         CRABEquippedEntity& cRAB = *reinterpret_cast<CRABEquippedEntity*>(GetSpace().GetEntityVector()[it->first]);
-         /* Initialize the occlusion check ray start to the position of the robot */
-         cOcclusionCheckRay.SetStart(cRAB.GetPosition());
+      /* Fill the routing table with the pairs in line of sight */
+      for(size_t i = 0; i < m_unNumTasks; ++i) {
+         const std::vector<SPair>& vecPairs = m_vecTasks[i].Pairs;
+         for(size_t j = 0; j < vecPairs.size(); ++j) {
+            const SPair& sPair = vecPairs[j];
+            if(sPair.Visible) {
+               CRABEquippedEntity& cRAB = *m_vecRABs[sPair.First].Entity;
+               CRABEquippedEntity& cOtherRAB = *sPair.Second;
+               /* cRAB can receive cOtherRAB's message if it is in range, and viceversa */
+               if(sPair.Distance < cOtherRAB.GetRange()) {
+                  /* cRAB receives cOtherRAB's message */
+                  m_tRoutingTable[cRAB.GetIndex()].insert(&cOtherRAB);
+               }
+               if(sPair.Distance < cRAB.GetRange()) {
+                  /* cOtherRAB receives cRAB's message */
+                  m_tRoutingTable[cOtherRAB.GetIndex()].insert(&cRAB);
+               }
+            }
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   size_t CRABMedium::PrepareUpdateTasks() {
+      /* Update positional index of RAB entities */
+      m_pcRABEquippedEntityIndex->Update();
+      /* Sort the RAB entities by grid cell, so that each task works on
+         neighboring entities */
+      SInt32 nI, nJ, nK;
+      for(size_t i = 0; i < m_vecRABs.size(); ++i) {
+         m_pcGrid->PositionToCellUnsafe(nI, nJ, nK, m_vecRABs[i].Entity->GetPosition());
+         m_pcGrid->ClampCoordinates(nI, nJ, nK);
+         m_vecRABs[i].CellIndex =
+            (nK * m_pcGrid->GetSizeJ() + nJ) * m_pcGrid->GetSizeI() + nI;
+      }
+      m_vecRABOrder.resize(m_vecRABs.size());
+      for(size_t i = 0; i < m_vecRABOrder.size(); ++i) {
+         m_vecRABOrder[i] = i;
+      }
+      std::sort(m_vecRABOrder.begin(), m_vecRABOrder.end(),
+                [this](size_t un_a, size_t un_b) {
+                   return m_vecRABs[un_a].CellIndex < m_vecRABs[un_b].CellIndex;
+                });
+      /* Split the sorted entities into tasks */
+      m_unNumTasks = (m_vecRABOrder.size() + RABS_PER_TASK - 1) / RABS_PER_TASK;
+      if(m_vecTasks.size() < m_unNumTasks) {
+         m_vecTasks.resize(m_unNumTasks);
+      }
+      for(size_t i = 0; i < m_unNumTasks; ++i) {
+         m_vecTasks[i].Begin = i * RABS_PER_TASK;
+         m_vecTasks[i].End = Min(m_vecTasks[i].Begin + RABS_PER_TASK, m_vecRABOrder.size());
+      }
+      m_bTasksPrepared = true;
+      return m_unNumTasks;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CRABMedium::IsInGridCell(const CRABEquippedEntity& c_entity,
+                                 const SInt32* pn_cell) const {
+      /* This mirrors what CRABEquippedEntityGridEntityUpdater does */
+      CVector3 cHalfSize(c_entity.GetRange(), c_entity.GetRange(), c_entity.GetRange());
+      SInt32 nI1, nJ1, nK1, nI2, nJ2, nK2;
+      m_pcGrid->PositionToCellUnsafe(nI1, nJ1, nK1, c_entity.GetPosition() - cHalfSize);
+      m_pcGrid->ClampCoordinates(nI1, nJ1, nK1);
+      m_pcGrid->PositionToCellUnsafe(nI2, nJ2, nK2, c_entity.GetPosition() + cHalfSize);
+      m_pcGrid->ClampCoordinates(nI2, nJ2, nK2);
+      return
+         pn_cell[0] >= nI1 && pn_cell[0] <= nI2 &&
+         pn_cell[1] >= nJ1 && pn_cell[1] <= nJ2 &&
+         pn_cell[2] >= nK1 && pn_cell[2] <= nK2;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRABMedium::ExecuteUpdateTask(size_t un_task) {
+      STaskData& sTask = m_vecTasks[un_task];
+      sTask.Pairs.clear();
+      sTask.Queries.clear();
+      bool bUseCache = m_bCheckOcclusions && m_fOcclusionCacheThreshold > 0.0;
+      Real fCacheThreshold2 = m_fOcclusionCacheThreshold * m_fOcclusionCacheThreshold;
+      SInt32 pnOtherCell[3];
+      /* Go through the RAB entities of this task */
+      for(size_t i = sTask.Begin; i < sTask.End; ++i) {
+         size_t unRAB = m_vecRABOrder[i];
+         SRABData& sRAB = m_vecRABs[unRAB];
+         CRABEquippedEntity& cRAB = *sRAB.Entity;
+         /* The cached occlusion checks of the last step */
+         sTask.OldVisibility.swap(sRAB.Visibility);
+         sRAB.Visibility.clear();
          /* For each RAB entity, get the list of RAB entities in range */
-         cOtherRABs.clear();
-         m_pcRABEquippedEntityIndex->GetEntitiesAt(cOtherRABs, cRAB.GetPosition());
+         m_pcRABEquippedEntityIndex->GetEntitiesAt(sTask.OtherRABs, cRAB.GetPosition());
          /* Go through the RAB entities in range */
-         for(CSet<CRABEquippedEntity*>::iterator it2 = cOtherRABs.begin();
-             it2 != cOtherRABs.end();
-             ++it2) {
+         for(CSet<CRABEquippedEntity*>::iterator it = sTask.OtherRABs.begin();
+             it != sTask.OtherRABs.end();
+             ++it) {
             /* Get a reference to the RAB entity */
-            CRABEquippedEntity& cOtherRAB = **it2;
+            CRABEquippedEntity& cOtherRAB = **it;
             /* First, make sure the entities are not the same */
-            if(&cRAB != &cOtherRAB) {
-               /* Proceed if the pair has not been checked already */
-               if(&cRAB < &cOtherRAB) {
-                  cTestKey.first = &cRAB;
-                  cTestKey.second = &cOtherRAB;
+            if(&cRAB == &cOtherRAB) continue;
+            /*
+             * The pair is found from cRAB because cOtherRAB is stored in the
+             * cell of cRAB. If cRAB is also stored in the cell of cOtherRAB,
+             * the pair is found from cOtherRAB too: in that case, only the
+             * entity with the lower address handles the pair.
+             */
+            if(&cOtherRAB < &cRAB) {
+               m_pcGrid->PositionToCellUnsafe(pnOtherCell[0], pnOtherCell[1], pnOtherCell[2],
+                                              cOtherRAB.GetPosition());
+               if(IsInGridCell(cRAB, pnOtherCell)) continue;
+            }
+            /* Proceed if the message size is compatible */
+            if(cRAB.GetMsgSize() != cOtherRAB.GetMsgSize()) continue;
+            /* Proceed if at least one of the entities is in range of the other */
+            SPair sPair;
+            sPair.First = unRAB;
+            sPair.Second = &cOtherRAB;
+            sPair.Distance = Distance(cRAB.GetPosition(), cOtherRAB.GetPosition());
+            sPair.Query = -1;
+            sPair.Visible = true;
+            if(sPair.Distance >= cOtherRAB.GetRange() &&
+               sPair.Distance >= cRAB.GetRange()) continue;
+            /* Check whether the two entities are obstructed by another object */
+            if(m_bCheckOcclusions) {
+               bool bCached = false;
+               if(bUseCache) {
+                  for(size_t j = 0; j < sTask.OldVisibility.size(); ++j) {
+                     const SVisibility& sVisibility = sTask.OldVisibility[j];
+                     if(sVisibility.Other == &cOtherRAB) {
+                        if(SquareDistance(sVisibility.Position, cRAB.GetPosition()) < fCacheThreshold2 &&
+                           SquareDistance(sVisibility.OtherPosition, cOtherRAB.GetPosition()) < fCacheThreshold2) {
+                           /* Both entities barely moved, reuse the check */
+                           sPair.Visible = sVisibility.Visible;
+                           sRAB.Visibility.push_back(sVisibility);
+                           bCached = true;
+                        }
+                        break;
+                     }
+                  }
                }
-               else {
-                  cTestKey.first = &cOtherRAB;
-                  cTestKey.second = &cRAB;
+               if(!bCached) {
+                  sPair.Query = sTask.Queries.size();
+                  sTask.Queries.push_back(
+                     SEmbodiedEntityRayQuery(
+                        CRay3(cRAB.GetPosition(), cOtherRAB.GetPosition()),
+                        &cRAB.GetEntityBody()));
                }
-               unTestHash = HashRABPair(cTestKey);
-               itPair = mapPairsAlreadyChecked.find(unTestHash);
-               if(itPair == mapPairsAlreadyChecked.end() ||   /* Pair does not exist */
-                  itPair->second.first != cTestKey.first ||   /* Pair exists, but first RAB involved is different */
-                  itPair->second.second != cTestKey.second) { /* Pair exists, but second RAB involved is different */
-                  /* Mark this pair as already checked */
-                  mapPairsAlreadyChecked[unTestHash] = cTestKey;
-                  /* Proceed if the message size is compatible */
-                  if(cRAB.GetMsgSize() == cOtherRAB.GetMsgSize()) {
-                     /* Proceed if the two entities are not obstructed by another object */
-                     cOcclusionCheckRay.SetEnd(cOtherRAB.GetPosition());
-                     if((!m_bCheckOcclusions) ||
-                        (!GetClosestEmbodiedEntityIntersectedByRay(sIntersectionItem,
-                                                                   cOcclusionCheckRay,
-                                                                   cRAB.GetEntityBody())) ||
-                        (&cOtherRAB.GetEntityBody() == sIntersectionItem.IntersectedEntity)) {
-                        /* If we get here, the two RAB entities are in direct line of sight */
-                        /* cRAB can receive cOtherRAB's message if it is in range, and viceversa */
-                        /* Calculate square distance */
-                        fDistance = cOcclusionCheckRay.GetLength();
-                        if(fDistance < cOtherRAB.GetRange()) {
-                           /* cRAB receives cOtherRAB's message */
-                           m_tRoutingTable[cRAB.GetIndex()].insert(&cOtherRAB);
-                        }
-                        if(fDistance < cRAB.GetRange()) {
-                           /* cOtherRAB receives cRAB's message */
-                           m_tRoutingTable[cOtherRAB.GetIndex()].insert(&cRAB);
-                        }
-                     } // occlusion found?
-                  } // is msg size the same?
-               } // is check necessary?
-            } // are entities the same?
+            }
+            sTask.Pairs.push_back(sPair);
          } // for entities in range
-      } // for routing table
+      } // for entities of the task
+      /* Cast all the occlusion check rays at once */
+      if(!sTask.Queries.empty()) {
+         GetClosestEmbodiedEntitiesIntersectedByRays(sTask.Queries);
+         for(size_t i = 0; i < sTask.Pairs.size(); ++i) {
+            SPair& sPair = sTask.Pairs[i];
+            if(sPair.Query < 0) continue;
+            const SEmbodiedEntityRayQuery& sQuery = sTask.Queries[sPair.Query];
+            /* The two RAB entities are in direct line of sight if nothing
+               is in between, except the other entity itself */
+            sPair.Visible =
+               (sQuery.Closest.IntersectedEntity == nullptr) ||
+               (&sPair.Second->GetEntityBody() == sQuery.Closest.IntersectedEntity);
+            if(bUseCache) {
+               SVisibility sVisibility;
+               sVisibility.Other = sPair.Second;
+               sVisibility.Position = sQuery.Ray.GetStart();
+               sVisibility.OtherPosition = sQuery.Ray.GetEnd();
+               sVisibility.Visible = sPair.Visible;
+               m_vecRABs[sPair.First].Visibility.push_back(sVisibility);
+            }
+         }
+      }
    }
 
    /****************************************/
    /****************************************/
 
    void CRABMedium::AddEntity(CRABEquippedEntity& c_entity) {
+      m_mapRABIndices[&c_entity] = m_vecRABs.size();
+      m_vecRABs.push_back(SRABData());
+      m_vecRABs.back().Entity = &c_entity;
+      m_vecRABs.back().CellIndex = 0;
       m_tRoutingTable.insert(
          std::make_pair<ssize_t, CSet<CRABEquippedEntity*,SEntityComparator> >(
             c_entity.GetIndex(), CSet<CRABEquippedEntity*,SEntityComparator>()));
-      m_pcRABEquippedEntityIndex->AddEntity(c_entity);
-      m_pcRABEquippedEntityIndex->Update();
+      m_pcRABEquippedEntityIndex->AddEntityAndUpdate(c_entity);
    }
 
    /****************************************/
    /****************************************/
 
    void CRABMedium::RemoveEntity(CRABEquippedEntity& c_entity) {
-      m_pcRABEquippedEntityIndex->RemoveEntity(c_entity);
-      m_pcRABEquippedEntityIndex->Update();
+      m_pcRABEquippedEntityIndex->RemoveEntityAndUpdate(c_entity);
       TRoutingTable::iterator it = m_tRoutingTable.find(c_entity.GetIndex());
       if(it != m_tRoutingTable.end())
          m_tRoutingTable.erase(it);
+      auto itRAB = m_mapRABIndices.find(&c_entity);
+      if(itRAB != m_mapRABIndices.end()) {
+         /* Move the last entity into the freed slot */
+         size_t unIdx = itRAB->second;
+         m_mapRABIndices.erase(itRAB);
+         if(unIdx + 1 < m_vecRABs.size()) {
+            m_vecRABs[unIdx] = std::move(m_vecRABs.back());
+            m_mapRABIndices[m_vecRABs[unIdx].Entity] = unIdx;
+         }
+         m_vecRABs.pop_back();
+         /* The address of the removed entity could be reused by a new
+            entity, so forget the cached occlusion checks */
+         for(size_t i = 0; i < m_vecRABs.size(); ++i) {
+            m_vecRABs[i].Visibility.clear();
+         }
+      }
+      /* The pairs of the current step refer to the old indices */
+      m_bTasksPrepared = false;
    }
 
    /****************************************/
@@ -249,7 +398,21 @@ namespace argos {
                    "By default, the RAB medium requires two robots to be in direct line-of-sight in\n"
                    "order to be able to exchange messages. You can toggle this behavior on or off\n"
                    "through the 'check_occlusions' attribute:\n\n"
-                   "<range_and_bearing id=\"rab\" check_occlusions=\"false\" />\n\n",
+                   "<range_and_bearing id=\"rab\" check_occlusions=\"false\" />\n\n"
+                   "Checking occlusions casts a ray between each pair of robots in range. With\n"
+                   "many robots, the result of the check can be reused across steps for the pairs\n"
+                   "whose robots moved less than a threshold since the check was made, at the cost\n"
+                   "of ignoring the movement of the other objects in the meantime. To enable this\n"
+                   "behavior, set the 'occlusion_cache_threshold' attribute (in meters, by default\n"
+                   "0, which disables the cache):\n\n"
+                   "<range_and_bearing id=\"rab\" occlusion_cache_threshold=\"0.01\" />\n\n"
+                   "With a multi-threaded space, the search for the robot pairs and the occlusion\n"
+                   "checks can be split among the threads by setting the 'parallel' attribute:\n\n"
+                   "<range_and_bearing id=\"rab\" parallel=\"true\" />\n\n"
+                   "The 'index' attribute sets the positional index, and can be 'grid' (the\n"
+                   "default) or 'grid_flat'. The 'grid_size' attribute sets the number of cells\n"
+                   "along each axis, as in 'grid_size=\"10,10,1\"'. By default, the grid has cells\n"
+                   "of one meter.\n",
                    "Under development"
       );
 
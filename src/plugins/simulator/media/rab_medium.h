@@ -8,6 +8,8 @@ namespace argos {
 
 #include <argos3/core/simulator/medium/medium.h>
 #include <argos3/core/simulator/space/positional_indices/positional_index.h>
+#include <argos3/core/simulator/space/positional_indices/grid.h>
+#include <argos3/core/simulator/physics_engine/physics_engine.h>
 #include <argos3/plugins/robots/generic/control_interface/ci_range_and_bearing_sensor.h>
 #include <argos3/plugins/simulator/entities/rab_equipped_entity.h>
 
@@ -33,6 +35,9 @@ namespace argos {
       virtual void Destroy();
       virtual void Update();
 
+      virtual size_t PrepareUpdateTasks();
+      virtual void ExecuteUpdateTask(size_t un_task);
+
       /**
        * Adds the specified entity to the list of managed entities.
        * @param c_entity The entity to add.
@@ -53,6 +58,64 @@ namespace argos {
        */
       const CSet<CRABEquippedEntity*,SEntityComparator>& GetRABsCommunicatingWith(CRABEquippedEntity& c_entity) const;
 
+   private:
+
+      /** The cached visibility of a pair of RAB entities */
+      struct SVisibility {
+         /** The other RAB entity of the pair */
+         CRABEquippedEntity* Other;
+         /** The position of the RAB entity when the visibility was checked */
+         CVector3 Position;
+         /** The position of the other RAB entity when the visibility was checked */
+         CVector3 OtherPosition;
+         /** True if the two RAB entities are in line of sight */
+         bool Visible;
+      };
+
+      /** The data associated to a RAB entity */
+      struct SRABData {
+         CRABEquippedEntity* Entity;
+         /** The index of the grid cell that contains the entity */
+         UInt32 CellIndex;
+         /** The visibility of the pairs this entity checked at the last step */
+         std::vector<SVisibility> Visibility;
+      };
+
+      /** A pair of RAB entities that can communicate, if in line of sight */
+      struct SPair {
+         /** The index of the first RAB entity in m_vecRABs */
+         size_t First;
+         /** The second RAB entity */
+         CRABEquippedEntity* Second;
+         /** The distance between the two RAB entities */
+         Real Distance;
+         /** The index of the occlusion check ray, or -1 if no ray is needed */
+         SInt32 Query;
+         /** True if the two RAB entities are in line of sight */
+         bool Visible;
+      };
+
+      /** The buffers of a parallel task, reused across steps */
+      struct STaskData {
+         /** The first and last+1 index in m_vecRABOrder processed by the task */
+         size_t Begin;
+         size_t End;
+         /** The RAB entities in range */
+         CSet<CRABEquippedEntity*,SEntityComparator> OtherRABs;
+         /** The pairs found by the task */
+         std::vector<SPair> Pairs;
+         /** The occlusion check rays cast by the task */
+         TEmbodiedEntityRayQueries Queries;
+         /** Buffer for the visibility of the last step */
+         std::vector<SVisibility> OldVisibility;
+      };
+
+      /**
+       * Returns true if the given RAB entity is stored in the grid cell with the given coordinates.
+       */
+      bool IsInGridCell(const CRABEquippedEntity& c_entity,
+                        const SInt32* pn_cell) const;
+
    private:
 
       /** Defines the routing table */
@@ -64,12 +127,36 @@ namespace argos {
       /** A positional index for the RAB entities */
       CPositionalIndex<CRABEquippedEntity>* m_pcRABEquippedEntityIndex;
 
+      /** The grid used as positional index */
+      CGrid<CRABEquippedEntity>* m_pcGrid;
+
       /** The update operation for the grid positional index */
       CRABEquippedEntityGridEntityUpdater* m_pcRABEquippedEntityGridUpdateOperation;
 
       /* Whether occlusions should be considered or not */
       bool m_bCheckOcclusions;
 
+      /** The data of the RAB entities */
+      std::vector<SRABData> m_vecRABs;
+
+      /** Maps a RAB entity to its index in m_vecRABs */
+      unordered_map<CRABEquippedEntity*, size_t> m_mapRABIndices;
+
+      /** The indices in m_vecRABs, sorted by grid cell */
+      std::vector<size_t> m_vecRABOrder;
+
+      /** The tasks of the update */
+      std::vector<STaskData> m_vecTasks;
+
+      /** The number of tasks prepared for the current step */
+      size_t m_unNumTasks;
+
+      /** True if the tasks for the current step have been prepared */
+      bool m_bTasksPrepared;
+
+      /** The visibility of a pair is reused while both entities moved less than this */
+      Real m_fOcclusionCacheThreshold;
+
    };
 
 }
@@ -29,7 +29,8 @@ namespace argos {
          GetNodeAttribute(tArena, "size", cArenaSize);
          GetNodeAttributeOrDefault(tArena, "center", cArenaCenter, cArenaCenter);
          /* Create the positional index for Radio entities */
-         if(strPosIndexMethod == "grid") {
+         if(strPosIndexMethod == "grid" ||
+            strPosIndexMethod == "grid_flat") {
             size_t punGridSize[3];
             if(!NodeAttributeExists(t_tree, "grid_size")) {
                punGridSize[0] = static_cast<size_t>(cArenaSize.GetX());
@@ -43,7 +44,8 @@ namespace argos {
             }
             CGrid<CSimpleRadioEntity>* pcGrid = new CGrid<CSimpleRadioEntity>(
                cArenaCenter - cArenaSize * 0.5f, cArenaCenter + cArenaSize * 0.5f,
-               punGridSize[0], punGridSize[1], punGridSize[2]);
+               punGridSize[0], punGridSize[1], punGridSize[2],
+               strPosIndexMethod == "grid_flat");
             m_pcEntityGridUpdateOperation = new CSimpleRadioEntityGridUpdater(*pcGrid);
             pcGrid->SetUpdateEntityOperation(m_pcEntityGridUpdateOperation);
             m_pcEntityIndex = pcGrid;
@@ -93,16 +95,14 @@ namespace argos {
    /****************************************/
 
    void CSimpleRadioMedium::AddEntity(CSimpleRadioEntity& c_entity) {
-      m_pcEntityIndex->AddEntity(c_entity);
-      m_pcEntityIndex->Update();
+      m_pcEntityIndex->AddEntityAndUpdate(c_entity);
    }
 
    /****************************************/
    /****************************************/
 
    void CSimpleRadioMedium::RemoveEntity(CSimpleRadioEntity& c_entity) {
-      m_pcEntityIndex->RemoveEntity(c_entity);
-      m_pcEntityIndex->Update();
+      m_pcEntityIndex->RemoveEntityAndUpdate(c_entity);
    }
 
    /****************************************/
@@ -119,7 +119,13 @@ namespace argos {
                    "REQUIRED XML CONFIGURATION\n\n"
                    "<simple_radio id=\"simple_radios\" />\n\n"
                    "OPTIONAL XML CONFIGURATION\n\n"
-                   "None\n",
+                   "The positional index of the simple radio entities is set with the 'index'\n"
+                   "attribute. It can be 'grid' (the default), which stores a set of entities per\n"
+                   "cell, or 'grid_flat', which stores all the cells in one array rebuilt at every\n"
+                   "step. Both return the same entities, in the same order; 'grid_flat' is faster\n"
+                   "with many entities. The 'grid_size' attribute sets the number of cells along\n"
+                   "each axis. By default, the cells are one meter wide:\n\n"
+                   "<simple_radio id=\"simple_radios\" index=\"grid_flat\" grid_size=\"20,20,2\" />\n",
                    "Under development"
       );
 
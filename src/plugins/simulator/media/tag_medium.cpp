@@ -29,7 +29,8 @@ namespace argos {
          GetNodeAttribute(tArena, "size", cArenaSize);
          GetNodeAttributeOrDefault(tArena, "center", cArenaCenter, cArenaCenter);
          /* Create the positional index for tag entities */
-         if(strPosIndexMethod == "grid") {
+         if(strPosIndexMethod == "grid" ||
+            strPosIndexMethod == "grid_flat") {
             size_t punGridSize[3];
             if(!NodeAttributeExists(t_tree, "grid_size")) {
                punGridSize[0] = static_cast<size_t>(cArenaSize.GetX());
@@ -43,7 +44,8 @@ namespace argos {
             }
             CGrid<CTagEntity>* pcGrid = new CGrid<CTagEntity>(
                cArenaCenter - cArenaSize * 0.5f, cArenaCenter + cArenaSize * 0.5f,
-               punGridSize[0], punGridSize[1], punGridSize[2]);
+               punGridSize[0], punGridSize[1], punGridSize[2],
+               strPosIndexMethod == "grid_flat");
             m_pcTagEntityGridUpdateOperation = new CTagEntityGridUpdater(*pcGrid);
             pcGrid->SetUpdateEntityOperation(m_pcTagEntityGridUpdateOperation);
             m_pcTagEntityIndex = pcGrid;
@@ -92,16 +94,14 @@ namespace argos {
    /****************************************/
 
    void CTagMedium::AddEntity(CTagEntity& c_entity) {
-      m_pcTagEntityIndex->AddEntity(c_entity);
-      m_pcTagEntityIndex->Update();
+      m_pcTagEntityIndex->AddEntityAndUpdate(c_entity);
    }
 
    /****************************************/
    /****************************************/
 
    void CTagMedium::RemoveEntity(CTagEntity& c_entity) {
-      m_pcTagEntityIndex->RemoveEntity(c_entity);
-      m_pcTagEntityIndex->Update();
+      m_pcTagEntityIndex->RemoveEntityAndUpdate(c_entity);
    }
 
    /****************************************/
@@ -118,7 +118,10 @@ namespace argos {
                    "REQUIRED XML CONFIGURATION\n\n"
                    "<tag id=\"qrcodes\" />\n\n"
                    "OPTIONAL XML CONFIGURATION\n\n"
-                   "None for the time being\n",
+                   "The 'index' attribute sets the positional index, and can be 'grid' (the\n"
+                   "default) or 'grid_flat'. The 'grid_size' attribute sets the number of cells\n"
+                   "along each axis, as in 'grid_size=\"10,10,1\"'. By default, the grid has cells\n"
+                   "of one meter.\n",
                    "Under development"
       );
 
@@ -26,7 +26,30 @@ namespace argos {
       m_ptSpace(nullptr),
       m_ptGroundBody(nullptr),
       m_fGrippingRigidity(10000.0),
-      m_fElevation(0.0f) {
+      m_fElevation(0.0f),
+      m_bGhosts(true),
+      m_fGhostMargin(0.1),
+      m_bGhostNeighborsReady(false) {
+   }
+
+   /****************************************/
+   /****************************************/
+
+   /* All the ghost shapes share this group, so ghosts never collide with each other */
+   static const cpGroup GHOST_GROUP = 1;
+
+   /*
+    * Ghosts mirror objects that are simulated by another engine, and
+    * have infinite mass. A ghost must not collide with other objects with
+    * infinite mass, such as static objects.
+    */
+   static int BeginCollisionWithGhost(cpArbiter* pt_arb,
+                                      cpSpace*,
+                                      void*) {
+      CP_ARBITER_GET_BODIES(pt_arb, ptBodyA, ptBodyB);
+      return
+         cpBodyGetMass(ptBodyA) != INFINITY ||
+         cpBodyGetMass(ptBodyB) != INFINITY;
    }
 
    /****************************************/
@@ -46,6 +69,11 @@ namespace argos {
             GetNodeAttributeOrDefault(tNode, "cylinder_angular_friction", m_fCylinderAngularFriction, m_fCylinderAngularFriction);
          }
          GetNodeAttributeOrDefault(t_tree, "gripping_rigidity", m_fGrippingRigidity, m_fGrippingRigidity);
+         GetNodeAttributeOrDefault(t_tree, "ghosts", m_bGhosts, m_bGhosts);
+         GetNodeAttributeOrDefault(t_tree, "ghost_margin", m_fGhostMargin, m_fGhostMargin);
+         bool bParallelModels = false;
+         GetNodeAttributeOrDefault(t_tree, "parallel_models", bParallelModels, bParallelModels);
+         SetModelUpdateParallel(bParallelModels);
          /* Override volume top and bottom with the value of m_fElevation */
          if(!GetVolume().TopFace)    GetVolume().TopFace    = new SHorizontalFace;
          if(!GetVolume().BottomFace) GetVolume().BottomFace = new SHorizontalFace;
@@ -81,6 +109,18 @@ namespace argos {
             nullptr,
             nullptr,
             nullptr);
+         /* Ghost callback functions */
+         for(cpCollisionType tType = SHAPE_NORMAL; tType < SHAPE_GHOST; ++tType) {
+            cpSpaceAddCollisionHandler(
+               m_ptSpace,
+               SHAPE_GHOST,
+               tType,
+               BeginCollisionWithGhost,
+               nullptr,
+               nullptr,
+               nullptr,
+               nullptr);
+         }
       }
       catch(CARGoSException& ex) {
          THROW_ARGOSEXCEPTION_NESTED("Error initializing the dynamics 2D engine \"" << GetId() << "\"", ex);
@@ -91,9 +131,8 @@ namespace argos {
    /****************************************/
 
    void CDynamics2DEngine::Reset() {
-      for(auto it = m_tPhysicsModels.begin();
-          it != m_tPhysicsModels.end(); ++it) {
-         it->second->Reset();
+      for(size_t i = 0; i < m_vecPhysicsModels.size(); ++i) {
+         m_vecPhysicsModels[i]->Reset();
       }
       cpSpaceReindexStatic(m_ptSpace);
    }
@@ -101,37 +140,82 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CDynamics2DEngine::SaveState(CByteArray& c_buffer) {
+      c_buffer << static_cast<UInt32>(m_vecPhysicsModels.size());
+      for(size_t i = 0; i < m_vecPhysicsModels.size(); ++i) {
+         CByteArray cBlock;
+         cBlock << m_vecPhysicsModelIds[i];
+         m_vecPhysicsModels[i]->SaveState(cBlock);
+         AddMementoBlock(c_buffer, cBlock);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics2DEngine::LoadState(CByteArray& c_buffer) {
+      UInt32 unNumModels;
+      c_buffer >> unNumModels;
+      CMementoBlockReader cReader(c_buffer);
+      CByteArray cBlock;
+      std::string strId;
+      for(UInt32 i = 0; i < unNumModels; ++i) {
+         cReader.NextBlock(cBlock);
+         cBlock >> strId;
+         /* Skip the models whose entity was moved to another engine */
+         auto it = m_mapPhysicsModelIndices.find(strId);
+         if(it != m_mapPhysicsModelIndices.end()) {
+            m_vecPhysicsModels[it->second]->LoadState(cBlock);
+         }
+      }
+      cReader.Finish();
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CDynamics2DEngine::Update() {
-      /* Update the physics state from the entities */
-      for(auto it = m_tPhysicsModels.begin();
-          it != m_tPhysicsModels.end(); ++it) {
-         it->second->UpdateFromEntityStatus();
+      /* Update the physics state from the entities.
+         This is never done in parallel, as models can add or remove
+         constraints from the space (e.g., when gripping) */
+      for(size_t i = 0; i < m_vecPhysicsModels.size(); ++i) {
+         m_vecPhysicsModels[i]->UpdateFromEntityStatus();
       }
       /* Perform the step */
       for(size_t i = 0; i < GetIterations(); ++i) {
-         for(auto it = m_tPhysicsModels.begin();
-             it != m_tPhysicsModels.end(); ++it) {
-            it->second->UpdatePhysics();
+         for(size_t j = 0; j < m_vecPhysicsModels.size(); ++j) {
+            m_vecPhysicsModels[j]->UpdatePhysics();
          }
          cpSpaceStep(m_ptSpace, GetPhysicsClockTick());
       }
       /* Update the simulated space */
-      for(auto it = m_tPhysicsModels.begin();
-          it != m_tPhysicsModels.end(); ++it) {
-         it->second->UpdateEntityStatus();
+      if(!IsModelUpdateParallel()) {
+         for(size_t i = 0; i < m_vecPhysicsModels.size(); ++i) {
+            m_vecPhysicsModels[i]->UpdateEntityStatus();
+         }
       }
    }
 
    /****************************************/
    /****************************************/
 
+   void CDynamics2DEngine::UpdateEntityStatus(size_t un_model) {
+      m_vecPhysicsModels[un_model]->UpdateEntityStatus();
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CDynamics2DEngine::Destroy() {
-      /* Empty the physics model map */
-      for(auto it = m_tPhysicsModels.begin();
-          it != m_tPhysicsModels.end(); ++it) {
-         delete it->second;
+      /* Get rid of the ghosts */
+      ClearGhosts();
+      /* Empty the physics model vector */
+      for(size_t i = 0; i < m_vecPhysicsModels.size(); ++i) {
+         delete m_vecPhysicsModels[i];
       }
-      m_tPhysicsModels.clear();
+      m_vecPhysicsModels.clear();
+      m_vecPhysicsModelIds.clear();
+      m_mapPhysicsModelIndices.clear();
       /* Get rid of the physics space */
       cpSpaceFree(m_ptSpace);
       cpBodyFree(m_ptGroundBody);
@@ -140,8 +224,152 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CDynamics2DEngine::PostUpdate() {
+      /* Ghosts are needed only when the engine has boundaries */
+      if(!m_bGhosts || GetVolume().SideFaces.empty()) return;
+      if(!m_bGhostNeighborsReady) InitGhostNeighbors();
+      /*
+       * Rebuild the ghosts from scratch. This is executed serially, after
+       * all the engines have been updated, so the other spaces can be read
+       * safely. Only the objects close to the boundaries have ghosts, so
+       * there are few of them.
+       */
+      ClearGhosts();
+      for(size_t i = 0; i < m_vecGhostNeighbors.size(); ++i) {
+         cpSpaceBBQuery(m_vecGhostNeighbors[i]->GetPhysicsSpace(),
+                        m_tGhostArea,
+                        CP_ALL_LAYERS,
+                        CP_NO_GROUP,
+                        GhostBBQueryFunc,
+                        this);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   static cpBB CalculateVolumeBB(const CPhysicsEngine::SVolume& s_volume) {
+      cpBB tBB = cpBBNew(INFINITY, INFINITY, -INFINITY, -INFINITY);
+      for(size_t i = 0; i < s_volume.SideFaces.size(); ++i) {
+         const CVector2& cPoint = s_volume.SideFaces[i]->BaseSegment.GetStart();
+         tBB = cpBBExpand(tBB, cpv(cPoint.GetX(), cPoint.GetY()));
+      }
+      return tBB;
+   }
+
+   void CDynamics2DEngine::InitGhostNeighbors() {
+      /* Calculate the area where ghosts are needed */
+      cpBB tArea = CalculateVolumeBB(GetVolume());
+      m_tGhostArea = cpBBNew(tArea.l - m_fGhostMargin,
+                             tArea.b - m_fGhostMargin,
+                             tArea.r + m_fGhostMargin,
+                             tArea.t + m_fGhostMargin);
+      /* Look for the engines that can have objects in that area */
+      CPhysicsEngine::TVector& tEngines = CSimulator::GetInstance().GetPhysicsEngines();
+      for(size_t i = 0; i < tEngines.size(); ++i) {
+         auto* pcEngine = dynamic_cast<CDynamics2DEngine*>(tEngines[i]);
+         if(pcEngine != nullptr &&
+            pcEngine != this &&
+            pcEngine->m_bGhosts &&
+            pcEngine->GetElevation() == GetElevation() &&
+            !pcEngine->GetVolume().SideFaces.empty() &&
+            cpBBIntersects(m_tGhostArea, CalculateVolumeBB(pcEngine->GetVolume()))) {
+            m_vecGhostNeighbors.push_back(pcEngine);
+         }
+      }
+      m_bGhostNeighborsReady = true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics2DEngine::ClearGhosts() {
+      for(auto it = m_mapGhostBodies.begin();
+          it != m_mapGhostBodies.end(); ++it) {
+         cpShape* ptCurShape = it->second->shapeList;
+         cpShape* ptNextShape;
+         while(ptCurShape) {
+            ptNextShape = ptCurShape->next;
+            cpSpaceRemoveShape(m_ptSpace, ptCurShape);
+            cpShapeFree(ptCurShape);
+            ptCurShape = ptNextShape;
+         }
+         cpBodyFree(it->second);
+      }
+      m_mapGhostBodies.clear();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics2DEngine::AddGhostShape(cpShape* pt_shape) {
+      /* Get the ghost body, creating it if necessary */
+      cpBody* ptGhostBody;
+      auto it = m_mapGhostBodies.find(pt_shape->body);
+      if(it != m_mapGhostBodies.end()) {
+         ptGhostBody = it->second;
+      }
+      else {
+         /* The ghost body is not added to the space, so it is never integrated */
+         ptGhostBody = cpBodyNew(INFINITY, INFINITY);
+         ptGhostBody->p = pt_shape->body->p;
+         cpBodySetAngle(ptGhostBody, pt_shape->body->a);
+         ptGhostBody->v = pt_shape->body->v;
+         ptGhostBody->w = pt_shape->body->w;
+         /* Ray queries return the model of the mirrored body */
+         ptGhostBody->data = pt_shape->body->data;
+         m_mapGhostBodies[pt_shape->body] = ptGhostBody;
+      }
+      /* Make a copy of the shape */
+      cpShape* ptGhostShape;
+      switch(pt_shape->klass->type) {
+         case CP_CIRCLE_SHAPE:
+            ptGhostShape = cpCircleShapeNew(ptGhostBody,
+                                            cpCircleShapeGetRadius(pt_shape),
+                                            cpCircleShapeGetOffset(pt_shape));
+            break;
+         case CP_SEGMENT_SHAPE:
+            ptGhostShape = cpSegmentShapeNew(ptGhostBody,
+                                             cpSegmentShapeGetA(pt_shape),
+                                             cpSegmentShapeGetB(pt_shape),
+                                             cpSegmentShapeGetRadius(pt_shape));
+            break;
+         case CP_POLY_SHAPE: {
+            std::vector<cpVect> vecVerts(cpPolyShapeGetNumVerts(pt_shape));
+            for(size_t i = 0; i < vecVerts.size(); ++i) {
+               vecVerts[i] = cpPolyShapeGetVert(pt_shape, i);
+            }
+            ptGhostShape = cpPolyShapeNew(ptGhostBody,
+                                          vecVerts.size(),
+                                          &vecVerts[0],
+                                          cpvzero);
+            break;
+         }
+         default:
+            return;
+      }
+      ptGhostShape->e = pt_shape->e;
+      ptGhostShape->u = pt_shape->u;
+      ptGhostShape->layers = pt_shape->layers;
+      ptGhostShape->group = GHOST_GROUP;
+      ptGhostShape->collision_type = SHAPE_GHOST;
+      cpSpaceAddShape(m_ptSpace, ptGhostShape);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics2DEngine::GhostBBQueryFunc(cpShape* pt_shape, void* pt_data) {
+      /* Ghosts of ghosts are not needed */
+      if(pt_shape->collision_type == SHAPE_GHOST) return;
+      reinterpret_cast<CDynamics2DEngine*>(pt_data)->AddGhostShape(pt_shape);
+   }
+
+   /****************************************/
+   /****************************************/
+
    size_t CDynamics2DEngine::GetNumPhysicsModels() {
-      return m_tPhysicsModels.size();
+      return m_vecPhysicsModels.size();
    }
 
    /****************************************/
@@ -168,6 +396,42 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   /*
+    * Checks whether a hit returned by a 2D segment query also holds in 3D.
+    * The segment query only checks the sides of the shape, so this function
+    * checks that the hit is within the height of the model, or else whether
+    * the ray goes through the top surface of the model.
+    * On success, f_t is set to the position of the hit on the 3D ray.
+    */
+   static bool Dynamics2DRayHitsShape(Real& f_t,
+                                      cpShape* pt_shape,
+                                      const CRay3& c_ray) {
+      CDynamics2DModel& cModel = *reinterpret_cast<CDynamics2DModel*>(pt_shape->body->data);
+      CVector3 cIntersectionPoint;
+      c_ray.GetPoint(cIntersectionPoint, f_t);
+      if((cIntersectionPoint.GetZ() >= cModel.GetBoundingBox().MinCorner.GetZ()) &&
+         (cIntersectionPoint.GetZ() <= cModel.GetBoundingBox().MaxCorner.GetZ()) ) {
+         /* Side hit */
+         return true;
+      }
+      /* Check top surface */
+      if(cIntersectionPoint.GetZ() > cModel.GetBoundingBox().MaxCorner.GetZ()) {
+         Real fZDiff = c_ray.GetStart().GetZ() - cModel.GetBoundingBox().MaxCorner.GetZ();
+         Real fRayZDiff = c_ray.GetStart().GetZ() - c_ray.GetEnd().GetZ();
+         f_t = fZDiff / fRayZDiff;
+         c_ray.GetPoint(cIntersectionPoint, f_t);
+         if(cpShapePointQuery(pt_shape, cpv(cIntersectionPoint.GetX(), cIntersectionPoint.GetY()))) {
+            return true;
+         }
+      }
+      /* Technically I should check the bottom surface, too, but this case never came up so far */
+      /* TODO */
+      return false;
+   }
+
+   /****************************************/
+   /****************************************/
+
    struct SDynamics2DSegmentHitData {
       TEmbodiedEntityIntersectionData& Intersections;
       const CRay3& Ray;
@@ -181,37 +445,78 @@ namespace argos {
    static void Dynamics2DSegmentQueryFunc(cpShape* pt_shape, cpFloat f_t, cpVect, void* pt_data) {
       /* Get the data associated to this query */
       SDynamics2DSegmentHitData& sData = *reinterpret_cast<SDynamics2DSegmentHitData*>(pt_data);
-      /* Hit found, is f_t it within the limits on Z? */
-      CDynamics2DModel& cModel = *reinterpret_cast<CDynamics2DModel*>(pt_shape->body->data);
-      CVector3 cIntersectionPoint;
-      sData.Ray.GetPoint(cIntersectionPoint, f_t);
-      if((cIntersectionPoint.GetZ() >= cModel.GetBoundingBox().MinCorner.GetZ()) &&
-         (cIntersectionPoint.GetZ() <= cModel.GetBoundingBox().MaxCorner.GetZ()) ) {
-         /* Side hit */
+      /* Hit found, does it hold in 3D? */
+      Real fT = f_t;
+      if(Dynamics2DRayHitsShape(fT, pt_shape, sData.Ray)) {
          sData.Intersections.push_back(
             SEmbodiedEntityIntersectionItem(
-               &cModel.GetEmbodiedEntity(),
-               f_t));
+               &reinterpret_cast<CDynamics2DModel*>(pt_shape->body->data)->GetEmbodiedEntity(),
+               fT));
       }
-      else {
-         /* Check top surface */
-         if(cIntersectionPoint.GetZ() > cModel.GetBoundingBox().MaxCorner.GetZ()) {
-            Real fZDiff = sData.Ray.GetStart().GetZ() - cModel.GetBoundingBox().MaxCorner.GetZ();
-            Real fRayZDiff = sData.Ray.GetStart().GetZ() - sData.Ray.GetEnd().GetZ();
-            f_t = fZDiff / fRayZDiff;
-            sData.Ray.GetPoint(cIntersectionPoint, f_t);
-            if(cpShapePointQuery(pt_shape, cpv(cIntersectionPoint.GetX(), cIntersectionPoint.GetY()))) {
-               sData.Intersections.push_back(
-                  SEmbodiedEntityIntersectionItem(
-                     &cModel.GetEmbodiedEntity(),
-                     f_t));
+   }
+
+   /****************************************/
+   /****************************************/
+
+   struct SDynamics2DClosestSegmentHitData {
+      SEmbodiedEntityIntersectionItem& Closest;
+      const CRay3& Ray;
+      const CEmbodiedEntity* IgnoredEntity;
+      cpVect Start;
+      cpVect End;
+      /* The fraction of the ray covered by the segment */
+      Real SegmentLength;
+      bool Found;
+
+      SDynamics2DClosestSegmentHitData(SEmbodiedEntityIntersectionItem& s_closest,
+                                       const CRay3& c_ray,
+                                       const CEmbodiedEntity* pc_ignored_entity,
+                                       const cpVect& t_start,
+                                       const cpVect& t_end,
+                                       Real f_segment_length) :
+         Closest(s_closest),
+         Ray(c_ray),
+         IgnoredEntity(pc_ignored_entity),
+         Start(t_start),
+         End(t_end),
+         SegmentLength(f_segment_length),
+         Found(false) {}
+   };
+
+   /*
+    * Called by the spatial indices of the space for each shape whose bounding
+    * box crosses the segment. Like in cpSpaceSegmentQueryFirst(), the return
+    * value is the fraction of the segment beyond which the index can stop
+    * looking, so the query gets shorter as closer hits are found.
+    */
+   static cpFloat Dynamics2DClosestSegmentQueryFunc(SDynamics2DClosestSegmentHitData* ps_data,
+                                                    cpShape* pt_shape,
+                                                    void*) {
+      SDynamics2DClosestSegmentHitData& sData = *ps_data;
+      /* Skip the ignored entity */
+      CDynamics2DModel& cModel = *reinterpret_cast<CDynamics2DModel*>(pt_shape->body->data);
+      if(&cModel.GetEmbodiedEntity() != sData.IgnoredEntity) {
+         /* Does the segment hit the shape before the closest hit found so far? */
+         cpSegmentQueryInfo tInfo;
+         if(cpShapeSegmentQuery(pt_shape, sData.Start, sData.End, &tInfo)) {
+            /* Bring the hit back to the full ray */
+            Real fT = tInfo.t * sData.SegmentLength;
+            /* Hit found, does it hold in 3D? */
+            if(fT < sData.Closest.TOnRay &&
+               Dynamics2DRayHitsShape(fT, pt_shape, sData.Ray) &&
+               fT < sData.Closest.TOnRay) {
+               sData.Closest.IntersectedEntity = &cModel.GetEmbodiedEntity();
+               sData.Closest.TOnRay = fT;
+               sData.Found = true;
             }
          }
-         /* Technically I should check the bottom surface, too, but this case never came up so far */
-         /* TODO */
       }
+      return sData.Closest.TOnRay / sData.SegmentLength;
    }
 
+   /****************************************/
+   /****************************************/
+
    void CDynamics2DEngine::CheckIntersectionWithRay(TEmbodiedEntityIntersectionData& t_data,
                                                     const CRay3& c_ray) const {
       /* Query all hits along the ray */
@@ -229,6 +534,44 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   bool CDynamics2DEngine::CheckClosestIntersectionWithRay(SEmbodiedEntityIntersectionItem& s_item,
+                                                           const CRay3& c_ray,
+                                                           const CEmbodiedEntity* pc_ignored_entity) const {
+      /* Only look at the part of the ray before the closest hit found so far.
+         This is safe because the top surface check can only move a hit
+         further along the ray. */
+      Real fLength = s_item.TOnRay;
+      if(fLength <= 0.0) return false;
+      CVector3 cEnd;
+      c_ray.GetPoint(cEnd, fLength);
+      SDynamics2DClosestSegmentHitData sHitData(
+         s_item,
+         c_ray,
+         pc_ignored_entity,
+         cpv(c_ray.GetStart().GetX(), c_ray.GetStart().GetY()),
+         cpv(cEnd.GetX(), cEnd.GetY()),
+         fLength);
+      /* Query the static shapes first, then the active ones up to the closest hit */
+      cpSpatialIndexSegmentQuery(m_ptSpace->staticShapes,
+                                 &sHitData,
+                                 sHitData.Start,
+                                 sHitData.End,
+                                 1.0f,
+                                 (cpSpatialIndexSegmentQueryFunc)Dynamics2DClosestSegmentQueryFunc,
+                                 nullptr);
+      cpSpatialIndexSegmentQuery(m_ptSpace->activeShapes,
+                                 &sHitData,
+                                 sHitData.Start,
+                                 sHitData.End,
+                                 s_item.TOnRay / fLength,
+                                 (cpSpatialIndexSegmentQueryFunc)Dynamics2DClosestSegmentQueryFunc,
+                                 nullptr);
+      return sHitData.Found;
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CDynamics2DEngine::PositionPhysicsToSpace(CVector3& c_new_pos,
                                                   const CVector3& c_original_pos,
                                                   const cpBody* pt_body) {
@@ -250,17 +593,33 @@ namespace argos {
 
    void CDynamics2DEngine::AddPhysicsModel(const std::string& str_id,
                                            CDynamics2DModel& c_model) {
-      m_tPhysicsModels[str_id] = &c_model;
+      auto it = m_mapPhysicsModelIndices.find(str_id);
+      if(it != m_mapPhysicsModelIndices.end()) {
+         /* Replace the model with the same id */
+         m_vecPhysicsModels[it->second] = &c_model;
+      }
+      else {
+         m_mapPhysicsModelIndices[str_id] = m_vecPhysicsModels.size();
+         m_vecPhysicsModels.push_back(&c_model);
+         m_vecPhysicsModelIds.push_back(str_id);
+      }
    }
 
    /****************************************/
    /****************************************/
 
    void CDynamics2DEngine::RemovePhysicsModel(const std::string& str_id) {
-      auto it = m_tPhysicsModels.find(str_id);
-      if(it != m_tPhysicsModels.end()) {
-         delete it->second;
-         m_tPhysicsModels.erase(it);
+      auto it = m_mapPhysicsModelIndices.find(str_id);
+      if(it != m_mapPhysicsModelIndices.end()) {
+         size_t unIdx = it->second;
+         delete m_vecPhysicsModels[unIdx];
+         /* Move the last model into the freed slot */
+         m_vecPhysicsModels[unIdx] = m_vecPhysicsModels.back();
+         m_vecPhysicsModelIds[unIdx] = m_vecPhysicsModelIds.back();
+         m_mapPhysicsModelIndices[m_vecPhysicsModelIds[unIdx]] = unIdx;
+         m_vecPhysicsModels.pop_back();
+         m_vecPhysicsModelIds.pop_back();
+         m_mapPhysicsModelIndices.erase(str_id);
       }
       else {
          THROW_ARGOSEXCEPTION("Dynamics2D model id \"" << str_id << "\" not found in dynamics 2D engine \"" << GetId() << "\"");
@@ -380,6 +739,33 @@ namespace argos {
                            "assigned to the area within the arena with lower-left coordinates (0,0) and\n"
                            "upper-right coordinates (4,4) and vertices are specified in counter clockwise\n"
                            "order: south-east, south-west, north-west, north-east.\n\n"
+                           "When multiple engines are used, the objects of an engine that are close to the\n"
+                           "boundaries of another engine are mirrored into that engine as 'ghosts'. Ghosts\n"
+                           "are immovable copies of the objects, updated at each simulation step, that make\n"
+                           "it possible for objects in different engines to collide. Ghosts are created\n"
+                           "for the objects closer than 'ghost_margin' (by default 0.1m) to the boundaries.\n"
+                           "Ghosts can be disabled by setting 'ghosts' to false:\n\n"
+                           "  <physics_engines>\n"
+                           "    ...\n"
+                           "    <dynamics2d id=\"dyn2d0\" ghosts=\"true\" ghost_margin=\"0.2\">\n"
+                           "      <boundaries>\n"
+                           "        ...\n"
+                           "      </boundaries>\n"
+                           "    </dynamics2d>\n"
+                           "    ...\n"
+                           "  </physics_engines>\n\n"
+                           "Instead of specifying the boundaries of each engine by hand, the arena can be\n"
+                           "split automatically in a grid of engines, as close to square as possible. Use\n"
+                           "the 'partitions' attribute as follows:\n\n"
+                           "  <physics_engines>\n"
+                           "    ...\n"
+                           "    <dynamics2d id=\"dyn2d\" partitions=\"auto\" count=\"16\" />\n"
+                           "    ...\n"
+                           "  </physics_engines>\n\n"
+                           "This creates the engines \"dyn2d_0\" to \"dyn2d_15\". The attribute 'count' is\n"
+                           "optional; if not set, one engine per thread is created. The other attributes\n"
+                           "and nodes are applied to all the created engines. This option cannot be used\n"
+                           "together with <boundaries>.\n\n"
                            "OPTIMIZATION HINTS\n\n"
                            "1. A single physics engine is generally sufficient for small swarms (say <= 50\n"
                            "   robots) within a reasonably small arena to obtain faster than real-time\n"
@@ -423,6 +809,14 @@ namespace argos {
                            "       </spatial_hash>\n"
                            "     </dynamics2d>\n"
                            "     ...\n"
+                           "   </physics_engines>\n\n"
+                           "6. After each step, the entities are updated from the state of their models.\n"
+                           "   With a multi-threaded space and many robots per engine, this update can be\n"
+                           "   split among the threads by setting the 'parallel_models' attribute:\n\n"
+                           "   <physics_engines>\n"
+                           "     ...\n"
+                           "     <dynamics2d id=\"dyn2d\" parallel_models=\"true\" />\n"
+                           "     ...\n"
                            "   </physics_engines>\n"
                            ,
                            "Usable"
@@ -17,6 +17,8 @@ namespace argos {
 #include <argos3/core/simulator/entity/controllable_entity.h>
 #include <argos3/core/simulator/physics_engine/physics_engine.h>
 #include <argos3/plugins/simulator/physics_engines/dynamics2d/chipmunk-physics/include/chipmunk.h>
+#include <unordered_map>
+#include <vector>
 
 namespace argos {
 
@@ -46,7 +48,8 @@ namespace argos {
       enum EShapeType {
          SHAPE_NORMAL = 0,
          SHAPE_GRIPPABLE,
-         SHAPE_GRIPPER
+         SHAPE_GRIPPER,
+         SHAPE_GHOST
       };
 
       enum ELayerType {
@@ -60,8 +63,12 @@ namespace argos {
 
       virtual void Init(TConfigurationNode& t_tree);
       virtual void Reset();
+      virtual void SaveState(CByteArray& c_buffer);
+      virtual void LoadState(CByteArray& c_buffer);
       virtual void Update();
       virtual void Destroy();
+      virtual void PostUpdate();
+      virtual void UpdateEntityStatus(size_t un_model);
 
       virtual size_t GetNumPhysicsModels();
       virtual bool AddEntity(CEntity& c_entity);
@@ -70,6 +77,10 @@ namespace argos {
       virtual void CheckIntersectionWithRay(TEmbodiedEntityIntersectionData& t_data,
                                             const CRay3& c_ray) const;
 
+      virtual bool CheckClosestIntersectionWithRay(SEmbodiedEntityIntersectionItem& s_item,
+                                                   const CRay3& c_ray,
+                                                   const CEmbodiedEntity* pc_ignored_entity = nullptr) const;
+
       inline cpFloat GetBoxLinearFriction() const {
          return m_fBoxLinearFriction;
       }
@@ -137,6 +148,27 @@ namespace argos {
                             CDynamics2DModel& c_model);
       void RemovePhysicsModel(const std::string& str_id);
 
+   private:
+
+      /**
+       * Looks for the other engines whose area is close to the area of
+       * this engine, and calculates the area where ghosts are needed.
+       */
+      void InitGhostNeighbors();
+
+      /**
+       * Removes all the ghost bodies and shapes from the space.
+       */
+      void ClearGhosts();
+
+      /**
+       * Adds to the space of this engine a ghost of a shape that belongs
+       * to another engine.
+       */
+      void AddGhostShape(cpShape* pt_shape);
+
+      static void GhostBBQueryFunc(cpShape* pt_shape, void* pt_data);
+
    private:
 
       cpFloat m_fBoxLinearFriction;
@@ -149,7 +181,25 @@ namespace argos {
       Real m_fElevation;
 
       CControllableEntity::TMap m_tControllableEntities;
-      std::map<std::string, CDynamics2DModel*> m_tPhysicsModels;
+      /** The models, stored contiguously */
+      std::vector<CDynamics2DModel*> m_vecPhysicsModels;
+      /** The ids of the models, in the same order as m_vecPhysicsModels */
+      std::vector<std::string> m_vecPhysicsModelIds;
+      /** Maps a model id to its index in m_vecPhysicsModels */
+      std::unordered_map<std::string, size_t> m_mapPhysicsModelIndices;
+
+      /** True if ghosts of the objects of neighboring engines are created */
+      bool m_bGhosts;
+      /** How far from the boundaries ghosts are created */
+      Real m_fGhostMargin;
+      /** True when m_vecGhostNeighbors and m_tGhostArea are calculated */
+      bool m_bGhostNeighborsReady;
+      /** The engines whose objects can have ghosts in this engine */
+      std::vector<CDynamics2DEngine*> m_vecGhostNeighbors;
+      /** The area of this engine, enlarged by the ghost margin */
+      cpBB m_tGhostArea;
+      /** The ghost bodies, indexed by the body they mirror */
+      std::map<cpBody*, cpBody*> m_mapGhostBodies;
 
    };
 
@@ -85,6 +85,37 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CDynamics2DMultiBodyObjectModel::SaveState(CByteArray& c_buffer) {
+      for(size_t i = 0; i < m_vecBodies.size(); ++i) {
+         cpBody* ptBody = m_vecBodies[i].Body;
+         c_buffer << ptBody->p.x << ptBody->p.y
+                  << ptBody->v.x << ptBody->v.y
+                  << ptBody->a   << ptBody->w;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics2DMultiBodyObjectModel::LoadState(CByteArray& c_buffer) {
+      cpFloat fAngle;
+      for(size_t i = 0; i < m_vecBodies.size(); ++i) {
+         /* Restore position and speed */
+         cpBody* ptBody = m_vecBodies[i].Body;
+         c_buffer >> ptBody->p.x >> ptBody->p.y
+                  >> ptBody->v.x >> ptBody->v.y
+                  >> fAngle      >> ptBody->w;
+         cpBodySetAngle(ptBody, fAngle);
+         cpBodyResetForces(ptBody);
+         cpSpaceReindexShapesForBody(GetDynamics2DEngine().GetPhysicsSpace(), ptBody);
+      }
+      /* Update bounding box and entity */
+      UpdateEntityStatus();
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CDynamics2DMultiBodyObjectModel::CalculateBoundingBox() {
       if(m_vecBodies.empty()) return;
       cpBB tBoundingBox;
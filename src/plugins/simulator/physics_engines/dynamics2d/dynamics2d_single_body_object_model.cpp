@@ -82,6 +82,35 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CDynamics2DSingleBodyObjectModel::SaveState(CByteArray& c_buffer) {
+      /* Nothing to do for a static body */
+      if(cpBodyIsStatic(m_ptBody)) return;
+      c_buffer << m_ptBody->p.x << m_ptBody->p.y
+               << m_ptBody->v.x << m_ptBody->v.y
+               << m_ptBody->a   << m_ptBody->w;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics2DSingleBodyObjectModel::LoadState(CByteArray& c_buffer) {
+      /* Nothing to do for a static body */
+      if(cpBodyIsStatic(m_ptBody)) return;
+      /* Restore position and speed */
+      cpFloat fAngle;
+      c_buffer >> m_ptBody->p.x >> m_ptBody->p.y
+               >> m_ptBody->v.x >> m_ptBody->v.y
+               >> fAngle        >> m_ptBody->w;
+      cpBodySetAngle(m_ptBody, fAngle);
+      cpBodyResetForces(m_ptBody);
+      /* Update bounding box and entity */
+      cpSpaceReindexShapesForBody(GetDynamics2DEngine().GetPhysicsSpace(), m_ptBody);
+      UpdateEntityStatus();
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CDynamics2DSingleBodyObjectModel::CalculateBoundingBox() {
       cpBB tBoundingBox = cpShapeGetBB(m_ptBody->shapeList);
       for(cpShape* pt_shape = m_ptBody->shapeList->next;
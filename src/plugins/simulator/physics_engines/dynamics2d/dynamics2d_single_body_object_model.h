@@ -97,6 +97,10 @@ namespace argos {
 
       virtual void Reset();
 
+      virtual void SaveState(CByteArray& c_buffer);
+
+      virtual void LoadState(CByteArray& c_buffer);
+
       virtual void MoveTo(const CVector3& c_position,
                           const CQuaternion& c_orientation);
 
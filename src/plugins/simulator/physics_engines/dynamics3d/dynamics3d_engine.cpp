@@ -56,6 +56,10 @@ namespace argos {
       }
       GetNodeAttributeOrDefault(t_tree, "debug_file", m_strDebugFilename, m_strDebugFilename);
       GetNodeAttributeOrDefault(t_tree, "default_friction", m_fDefaultFriction, m_fDefaultFriction);
+      /* Whether the entities are updated in parallel by the space */
+      bool bParallelModels = false;
+      GetNodeAttributeOrDefault(t_tree, "parallel_models", bParallelModels, bParallelModels);
+      SetModelUpdateParallel(bParallelModels);
    }
 
    /****************************************/
@@ -71,19 +75,17 @@ namespace argos {
 
    void CDynamics3DEngine::Reset() {
       /* Remove and reset all physics models */
-      for(auto itModel = std::begin(m_tPhysicsModels);
-          itModel != std::end(m_tPhysicsModels);
-          ++itModel) {
+      for(CDynamics3DModel* pc_model : m_vecPhysicsModels) {
          /* Remove model from plugins */
          for(auto itPlugin = std::begin(m_tPhysicsPlugins);
              itPlugin != std::end(m_tPhysicsPlugins);
              ++itPlugin) {
-            itPlugin->second->UnregisterModel(*itModel->second);
+            itPlugin->second->UnregisterModel(*pc_model);
          }
          /* Remove model from world */
-         itModel->second->RemoveFromWorld(m_cWorld);
+         pc_model->RemoveFromWorld(m_cWorld);
          /* Reset the model */
-         itModel->second->Reset();
+         pc_model->Reset();
       }
       /* Run the destructors on bullet's components */
       m_cWorld.~btMultiBodyDynamicsWorld();
@@ -118,17 +120,15 @@ namespace argos {
          }
       }, static_cast<void*>(this), true);
       /* Add the models back into the engine */
-      for(auto itModel = std::begin(m_tPhysicsModels);
-          itModel != std::end(m_tPhysicsModels);
-          ++itModel) {
+      for(CDynamics3DModel* pc_model : m_vecPhysicsModels) {
          /* Add model to plugins */
          for(auto itPlugin = std::begin(m_tPhysicsPlugins);
              itPlugin != std::end(m_tPhysicsPlugins);
              ++itPlugin) {
-            itPlugin->second->RegisterModel(*itModel->second);
+            itPlugin->second->RegisterModel(*pc_model);
          }
          /* Add model to world */
-         itModel->second->AddToWorld(m_cWorld);
+         pc_model->AddToWorld(m_cWorld);
       }
       /* Initialize any multi-body constraints */
       for (SInt32 i = 0; i < m_cWorld.getNumMultiBodyConstraints(); i++) {
@@ -139,20 +139,59 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CDynamics3DEngine::SaveState(CByteArray& c_buffer) {
+      c_buffer << static_cast<UInt32>(m_cSolver.getRandSeed());
+      c_buffer << static_cast<UInt32>(m_vecPhysicsModels.size());
+      for(size_t i = 0; i < m_vecPhysicsModels.size(); ++i) {
+         CByteArray cBlock;
+         cBlock << m_vecPhysicsModelIds[i];
+         m_vecPhysicsModels[i]->SaveState(cBlock);
+         AddMementoBlock(c_buffer, cBlock);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics3DEngine::LoadState(CByteArray& c_buffer) {
+      UInt32 unRandSeed, unNumModels;
+      c_buffer >> unRandSeed;
+      m_cSolver.setRandSeed(unRandSeed);
+      c_buffer >> unNumModels;
+      CMementoBlockReader cReader(c_buffer);
+      CByteArray cBlock;
+      std::string strId;
+      for(UInt32 i = 0; i < unNumModels; ++i) {
+         cReader.NextBlock(cBlock);
+         cBlock >> strId;
+         /* Skip the models whose entity was moved to another engine */
+         auto it = m_mapPhysicsModelIndices.find(strId);
+         if(it != m_mapPhysicsModelIndices.end()) {
+            m_vecPhysicsModels[it->second]->LoadState(cBlock);
+         }
+      }
+      cReader.Finish();
+      /* The cached contacts refer to the old poses of the bodies */
+      for(int i = 0; i < m_cDispatcher.getNumManifolds(); ++i) {
+         m_cDispatcher.getManifoldByIndexInternal(i)->clearManifold();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CDynamics3DEngine::Destroy() {
       /* Destroy all physics models */
-      for(auto itModel = std::begin(m_tPhysicsModels);
-          itModel != std::end(m_tPhysicsModels);
-          ++itModel) {
+      for(CDynamics3DModel* pc_model : m_vecPhysicsModels) {
          /* Remove model from the plugins first */
          for(auto itPlugin = std::begin(m_tPhysicsPlugins);
              itPlugin != std::end(m_tPhysicsPlugins);
              ++itPlugin) {
-            itPlugin->second->UnregisterModel(*itModel->second);
+            itPlugin->second->UnregisterModel(*pc_model);
          }
          /* Destroy the model */
-         itModel->second->RemoveFromWorld(m_cWorld);
-         delete itModel->second;
+         pc_model->RemoveFromWorld(m_cWorld);
+         delete pc_model;
       }
       /* Destroy all plug-ins */
       for(auto itPlugin = std::begin(m_tPhysicsPlugins);
@@ -161,29 +200,31 @@ namespace argos {
          itPlugin->second->Destroy();
          delete itPlugin->second;
       }
-      /* Empty the maps */
+      /* Empty the containers */
       m_tPhysicsPlugins.clear();
-      m_tPhysicsModels.clear();
+      m_vecPhysicsModels.clear();
+      m_vecPhysicsModelIds.clear();
+      m_mapPhysicsModelIndices.clear();
    }
 
    /****************************************/
    /****************************************/
 
    void CDynamics3DEngine::Update() {
-      /* Update the physics state from the entities */
-      for(auto it = m_tPhysicsModels.begin();
-          it != std::end(m_tPhysicsModels); ++it) {
-         it->second->UpdateFromEntityStatus();
+      /* Update the physics state from the entities. This is never done in
+         parallel, as models can modify the shared world */
+      for(CDynamics3DModel* pc_model : m_vecPhysicsModels) {
+         pc_model->UpdateFromEntityStatus();
       }
       /* Step the simuation forwards */
       m_cWorld.stepSimulation(GetSimulationClockTick(),
                               GetIterations(),
                               GetPhysicsClockTick());
       /* Update the simulated space */
-      for(auto it = std::begin(m_tPhysicsModels);
-          it != std::end(m_tPhysicsModels);
-          ++it) {
-         it->second->UpdateEntityStatus();
+      if(!IsModelUpdateParallel()) {
+         for(CDynamics3DModel* pc_model : m_vecPhysicsModels) {
+            pc_model->UpdateEntityStatus();
+         }
       }
       /* Dump the state of the world to a bullet file (if requested) */
       if(!m_strDebugFilename.empty()) {
@@ -228,8 +269,71 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   /*
+    * A closest-hit ray callback that skips the collision objects of one entity.
+    */
+   struct SDynamics3DFilteredRayResultCallback : public btCollisionWorld::ClosestRayResultCallback {
+      const CEmbodiedEntity* IgnoredEntity;
+
+      SDynamics3DFilteredRayResultCallback(const btVector3& c_ray_start,
+                                           const btVector3& c_ray_end,
+                                           const CEmbodiedEntity* pc_ignored_entity) :
+         btCollisionWorld::ClosestRayResultCallback(c_ray_start, c_ray_end),
+         IgnoredEntity(pc_ignored_entity) {}
+
+      virtual bool needsCollision(btBroadphaseProxy* pc_proxy) const {
+         if(!btCollisionWorld::ClosestRayResultCallback::needsCollision(pc_proxy)) {
+            return false;
+         }
+         if(IgnoredEntity != nullptr) {
+            const btCollisionObject* pcObject =
+               static_cast<const btCollisionObject*>(pc_proxy->m_clientObject);
+            if(pcObject->getUserPointer() != nullptr &&
+               &static_cast<CDynamics3DModel*>(pcObject->getUserPointer())->GetEmbodiedEntity() == IgnoredEntity) {
+               return false;
+            }
+         }
+         return true;
+      }
+   };
+
+   /****************************************/
+   /****************************************/
+
+   bool CDynamics3DEngine::CheckClosestIntersectionWithRay(SEmbodiedEntityIntersectionItem& s_item,
+                                                           const CRay3& c_ray,
+                                                           const CEmbodiedEntity* pc_ignored_entity) const {
+      /* Convert the start and end ray vectors to the bullet coordinate system */
+      btVector3 cRayStart(c_ray.GetStart().GetX(), c_ray.GetStart().GetZ(), -c_ray.GetStart().GetY());
+      btVector3 cRayEnd(c_ray.GetEnd().GetX(), c_ray.GetEnd().GetZ(), -c_ray.GetEnd().GetY());
+      SDynamics3DFilteredRayResultCallback cResult(cRayStart, cRayEnd, pc_ignored_entity);
+      /* Let Bullet discard anything beyond the closest hit found so far */
+      cResult.m_closestHitFraction = s_item.TOnRay;
+      /* Run the ray test */
+      m_cWorld.rayTest(cRayStart, cRayEnd, cResult);
+      /* Examine the results */
+      if (cResult.hasHit() && cResult.m_collisionObject->getUserPointer() != nullptr) {
+         auto* pcModel =
+            static_cast<CDynamics3DModel*>(cResult.m_collisionObject->getUserPointer());
+         s_item.IntersectedEntity = &(pcModel->GetEmbodiedEntity());
+         s_item.TOnRay = cResult.m_closestHitFraction;
+         return true;
+      }
+      return false;
+   }
+
+   /****************************************/
+   /****************************************/
+
    size_t CDynamics3DEngine::GetNumPhysicsModels() {
-      return m_tPhysicsModels.size();
+      return m_vecPhysicsModels.size();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics3DEngine::UpdateEntityStatus(size_t un_model) {
+      m_vecPhysicsModels[un_model]->UpdateEntityStatus();
    }
 
    /****************************************/
@@ -265,28 +369,43 @@ namespace argos {
           ++itPlugin) {
          itPlugin->second->RegisterModel(c_model);
       }
-      /* Add a pointer to the model to the map of models */
-      m_tPhysicsModels[str_id] = &c_model;
+      /* Add a pointer to the model to the vector of models */
+      auto itModel = m_mapPhysicsModelIndices.find(str_id);
+      if(itModel != std::end(m_mapPhysicsModelIndices)) {
+         m_vecPhysicsModels[itModel->second] = &c_model;
+      }
+      else {
+         m_mapPhysicsModelIndices[str_id] = m_vecPhysicsModels.size();
+         m_vecPhysicsModels.push_back(&c_model);
+         m_vecPhysicsModelIds.push_back(str_id);
+      }
    }
 
    /****************************************/
    /****************************************/
 
    void CDynamics3DEngine::RemovePhysicsModel(const std::string& str_id) {
-      auto itModel = m_tPhysicsModels.find(str_id);
-      if(itModel != std::end(m_tPhysicsModels)) {
+      auto itModel = m_mapPhysicsModelIndices.find(str_id);
+      if(itModel != std::end(m_mapPhysicsModelIndices)) {
+         size_t unIndex = itModel->second;
+         CDynamics3DModel* pcModel = m_vecPhysicsModels[unIndex];
          /* Notify the plugins of model removal */
          for(auto itPlugin = std::begin(m_tPhysicsPlugins);
              itPlugin != std::end(m_tPhysicsPlugins);
              ++itPlugin) {
-            itPlugin->second->UnregisterModel(*(itModel->second));
+            itPlugin->second->UnregisterModel(*pcModel);
          }
          /* Remove the model from world */
-         itModel->second->RemoveFromWorld(m_cWorld);
+         pcModel->RemoveFromWorld(m_cWorld);
          /* Destroy the model */
-         delete itModel->second;
-         /* Remove the model from the map */
-         m_tPhysicsModels.erase(itModel);
+         delete pcModel;
+         /* Move the last model into the freed slot */
+         m_vecPhysicsModels[unIndex] = m_vecPhysicsModels.back();
+         m_vecPhysicsModelIds[unIndex] = m_vecPhysicsModelIds.back();
+         m_mapPhysicsModelIndices[m_vecPhysicsModelIds[unIndex]] = unIndex;
+         m_vecPhysicsModels.pop_back();
+         m_vecPhysicsModelIds.pop_back();
+         m_mapPhysicsModelIndices.erase(str_id);
       }
       else {
          THROW_ARGOSEXCEPTION("The model \"" << str_id <<
@@ -382,6 +501,16 @@ namespace argos {
                            "      <magnetism max_distance=\"0.04\" />\n"
                            "    </dynamics3d>\n"
                            "    ...\n"
+                           "  </physics_engines>\n\n"
+
+                           "After each step, the entities are updated from the state of their models.\n"
+                           "With a multi-threaded space and many robots, this update can be split among\n"
+                           "the threads by setting the 'parallel_models' attribute:\n\n"
+
+                           "  <physics_engines>\n"
+                           "    ...\n"
+                           "    <dynamics3d id=\"dyn3d\" parallel_models=\"true\"/>\n"
+                           "    ...\n"
                            "  </physics_engines>\n\n",
 
                            "Usable (multiple engines not supported)"
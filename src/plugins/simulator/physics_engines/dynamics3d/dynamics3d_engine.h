@@ -17,6 +17,8 @@ namespace argos {
 #include <argos3/core/simulator/physics_engine/physics_engine.h>
 #include <argos3/core/utility/math/ray2.h>
 #include <argos3/core/utility/math/rng.h>
+#include <unordered_map>
+#include <vector>
 
 #ifdef __APPLE__
 #pragma clang diagnostic push
@@ -54,8 +56,14 @@ namespace argos {
 
       virtual void Reset();
 
+      virtual void SaveState(CByteArray& c_buffer);
+
+      virtual void LoadState(CByteArray& c_buffer);
+
       virtual void Update();
 
+      virtual void UpdateEntityStatus(size_t un_model);
+
       virtual void Destroy();
 
       virtual void PostSpaceInit();
@@ -69,6 +77,10 @@ namespace argos {
       virtual void CheckIntersectionWithRay(TEmbodiedEntityIntersectionData& t_data,
                                             const CRay3& c_ray) const;
 
+      virtual bool CheckClosestIntersectionWithRay(SEmbodiedEntityIntersectionItem& s_item,
+                                                   const CRay3& c_ray,
+                                                   const CEmbodiedEntity* pc_ignored_entity = nullptr) const;
+
       inline btMultiBodyDynamicsWorld& GetWorld() {
          return m_cWorld;
       }
@@ -100,8 +112,12 @@ namespace argos {
       void RemovePhysicsPlugin(const std::string& str_id);
 
    private:
-      /* Maps of models and plugins */
-      std::map<std::string, CDynamics3DModel*> m_tPhysicsModels;
+      /* Models, stored contiguously, and their ids in the same order */
+      std::vector<CDynamics3DModel*> m_vecPhysicsModels;
+      std::vector<std::string> m_vecPhysicsModelIds;
+      /* Map from model id to index in the model vector */
+      std::unordered_map<std::string, size_t> m_mapPhysicsModelIndices;
+      /* Map of plugins */
       std::map<std::string, CDynamics3DPlugin*> m_tPhysicsPlugins;
       /* Random number generation */
       CRandom::CRNG* m_pcRNG;
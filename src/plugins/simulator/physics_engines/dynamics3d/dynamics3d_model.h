@@ -184,6 +184,38 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   /**
+    * Serialization of the Bullet types, used to save and restore the state of the models.
+    */
+   inline CByteArray& operator<<(CByteArray& c_buffer, const btVector3& c_vector) {
+      return c_buffer << c_vector.getX() << c_vector.getY() << c_vector.getZ();
+   }
+
+   inline CByteArray& operator>>(CByteArray& c_buffer, btVector3& c_vector) {
+      btScalar fX, fY, fZ;
+      c_buffer >> fX >> fY >> fZ;
+      c_vector.setValue(fX, fY, fZ);
+      return c_buffer;
+   }
+
+   inline CByteArray& operator<<(CByteArray& c_buffer, const btTransform& c_transform) {
+      const btQuaternion& cRotation = c_transform.getRotation();
+      return c_buffer << c_transform.getOrigin()
+                      << cRotation.getX() << cRotation.getY() << cRotation.getZ() << cRotation.getW();
+   }
+
+   inline CByteArray& operator>>(CByteArray& c_buffer, btTransform& c_transform) {
+      btVector3 cOrigin;
+      btScalar fX, fY, fZ, fW;
+      c_buffer >> cOrigin >> fX >> fY >> fZ >> fW;
+      c_transform.setOrigin(cOrigin);
+      c_transform.setRotation(btQuaternion(fX, fY, fZ, fW));
+      return c_buffer;
+   }
+
+   /****************************************/
+   /****************************************/
+
 }
 
 #endif
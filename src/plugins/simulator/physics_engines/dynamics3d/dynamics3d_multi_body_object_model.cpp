@@ -57,6 +57,61 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CDynamics3DMultiBodyObjectModel::SaveState(CByteArray& c_buffer) {
+      /* Save the state of the base */
+      c_buffer << m_cMultiBody.getBaseWorldTransform()
+               << m_cMultiBody.getBaseVel()
+               << m_cMultiBody.getBaseOmega();
+      /* Save the positions and velocities of the joints */
+      for(int i = 0; i < m_cMultiBody.getNumLinks(); ++i) {
+         const btMultibodyLink& sLink = m_cMultiBody.getLink(i);
+         const btScalar* pfPositions = m_cMultiBody.getJointPosMultiDof(i);
+         for(int j = 0; j < sLink.m_posVarCount; ++j) {
+            c_buffer << pfPositions[j];
+         }
+         const btScalar* pfVelocities = m_cMultiBody.getJointVelMultiDof(i);
+         for(int j = 0; j < sLink.m_dofCount; ++j) {
+            c_buffer << pfVelocities[j];
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics3DMultiBodyObjectModel::LoadState(CByteArray& c_buffer) {
+      /* Restore the state of the base */
+      btTransform cBaseTransform;
+      btVector3 cBaseVelocity, cBaseOmega;
+      c_buffer >> cBaseTransform >> cBaseVelocity >> cBaseOmega;
+      m_cMultiBody.setBaseWorldTransform(cBaseTransform);
+      m_cMultiBody.setBaseVel(cBaseVelocity);
+      m_cMultiBody.setBaseOmega(cBaseOmega);
+      /* Restore the positions and velocities of the joints */
+      btScalar pfPositions[7], pfVelocities[6];
+      for(int i = 0; i < m_cMultiBody.getNumLinks(); ++i) {
+         const btMultibodyLink& sLink = m_cMultiBody.getLink(i);
+         for(int j = 0; j < sLink.m_posVarCount; ++j) {
+            c_buffer >> pfPositions[j];
+         }
+         for(int j = 0; j < sLink.m_dofCount; ++j) {
+            c_buffer >> pfVelocities[j];
+         }
+         m_cMultiBody.setJointPosMultiDof(i, pfPositions);
+         m_cMultiBody.setJointVelMultiDof(i, pfVelocities);
+      }
+      m_cMultiBody.clearForcesAndTorques();
+      /* Move the colliders of the links */
+      btAlignedObjectArray<btQuaternion> vecRotations;
+      btAlignedObjectArray<btVector3> vecTranslations;
+      m_cMultiBody.updateCollisionObjectWorldTransforms(vecRotations, vecTranslations);
+      /* Synchronize with the entity in the space */
+      UpdateEntityStatus();
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CDynamics3DMultiBodyObjectModel::AddToWorld(btMultiBodyDynamicsWorld& c_world) {
       /* Prepare the multi-body (set up internal offsets, reserve memory) */
       m_cMultiBody.finalizeMultiDof();
@@ -51,6 +51,22 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CDynamics3DSingleBodyObjectModel::SaveState(CByteArray& c_buffer) {
+      static_cast<CBody&>(*m_vecBodies[0]).SaveState(c_buffer);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics3DSingleBodyObjectModel::LoadState(CByteArray& c_buffer) {
+      static_cast<CBody&>(*m_vecBodies[0]).LoadState(c_buffer);
+      /* Synchronize with the entity in the space */
+      UpdateEntityStatus();
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CDynamics3DSingleBodyObjectModel::CalculateBoundingBox() {
       btCollisionShape& cShape = m_vecBodies[0]->GetShape();
       btVector3 cAabbMin;
@@ -97,6 +113,32 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CDynamics3DSingleBodyObjectModel::CBody::SaveState(CByteArray& c_buffer) {
+      c_buffer << m_cRigidBody.getWorldTransform()
+               << m_cRigidBody.getLinearVelocity()
+               << m_cRigidBody.getAngularVelocity();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics3DSingleBodyObjectModel::CBody::LoadState(CByteArray& c_buffer) {
+      btTransform cTransform;
+      btVector3 cLinearVelocity, cAngularVelocity;
+      c_buffer >> cTransform >> cLinearVelocity >> cAngularVelocity;
+      m_cRigidBody.setWorldTransform(cTransform);
+      m_cRigidBody.setInterpolationWorldTransform(cTransform);
+      m_cRigidBody.setLinearVelocity(cLinearVelocity);
+      m_cRigidBody.setInterpolationLinearVelocity(cLinearVelocity);
+      m_cRigidBody.setAngularVelocity(cAngularVelocity);
+      m_cRigidBody.setInterpolationAngularVelocity(cAngularVelocity);
+      m_cRigidBody.clearForces();
+      m_cRigidBody.activate();
+   }
+
+   /****************************************/
+   /****************************************/
+
    CDynamics3DSingleBodyObjectModel::CBody::CBody(CDynamics3DModel& c_model,
                                                   SAnchor* ps_anchor,
                                                   const std::shared_ptr<btCollisionShape>& ptr_shape,
@@ -61,6 +61,10 @@ namespace argos {
 
          virtual btTransform& GetTransform();
 
+         void SaveState(CByteArray& c_buffer);
+
+         void LoadState(CByteArray& c_buffer);
+
       protected:
 
          btRigidBody m_cRigidBody;
@@ -76,6 +80,10 @@ namespace argos {
 
       virtual void Reset();
 
+      virtual void SaveState(CByteArray& c_buffer);
+
+      virtual void LoadState(CByteArray& c_buffer);
+
       virtual void MoveTo(const CVector3& c_position,
                           const CQuaternion& c_orientation);
 
@@ -0,0 +1,172 @@
+/**
+ * @file <argos3/plugins/simulator/physics_engines/pointmass3d/pointmass3d_broadphase.cpp>
+ */
+
+#include "pointmass3d_broadphase.h"
+#include "pointmass3d_model.h"
+#include <argos3/core/utility/configuration/argos_exception.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   const UInt32 CPointMass3DBroadphase::MAX_CELLS_PER_MODEL = 64;
+
+   /****************************************/
+   /****************************************/
+
+   CPointMass3DBroadphase::CPointMass3DBroadphase() :
+      m_fCellSize(1.0),
+      m_fInvCellSize(1.0),
+      m_vecBuckets(64),
+      m_unNumEntries(0) {}
+
+   /****************************************/
+   /****************************************/
+
+   void CPointMass3DBroadphase::SetCellSize(Real f_cell_size) {
+      if(f_cell_size <= 0.0) {
+         THROW_ARGOSEXCEPTION("The broadphase cell size must be positive, got " << f_cell_size);
+      }
+      m_fCellSize = f_cell_size;
+      m_fInvCellSize = 1.0 / f_cell_size;
+      Rehash(m_vecBuckets.size());
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CPointMass3DBroadphase::Update(CPointMass3DModel& c_model) {
+      SCellRange sRange;
+      CalculateCellRange(sRange, c_model.GetBoundingBox());
+      auto it = m_mapRanges.find(&c_model);
+      if(it == m_mapRanges.end()) {
+         /* New model */
+         it = m_mapRanges.insert(std::make_pair(&c_model, sRange)).first;
+         Insert(c_model, it->second);
+         /* Keep about one entry per bucket */
+         size_t unBuckets = m_vecBuckets.size();
+         while(unBuckets < m_unNumEntries) unBuckets *= 2;
+         if(unBuckets != m_vecBuckets.size()) {
+            Rehash(unBuckets);
+         }
+      }
+      else if(!(it->second == sRange)) {
+         /* The model moved to different cells */
+         Erase(c_model, it->second);
+         it->second = sRange;
+         Insert(c_model, it->second);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CPointMass3DBroadphase::Remove(CPointMass3DModel& c_model) {
+      auto it = m_mapRanges.find(&c_model);
+      if(it != m_mapRanges.end()) {
+         Erase(c_model, it->second);
+         m_mapRanges.erase(it);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CPointMass3DBroadphase::Clear() {
+      for(size_t i = 0; i < m_vecBuckets.size(); ++i) {
+         m_vecBuckets[i].clear();
+      }
+      m_mapRanges.clear();
+      m_vecLargeModels.clear();
+      m_unNumEntries = 0;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CPointMass3DBroadphase::CalculateCellRange(SCellRange& s_range,
+                                                   const SBoundingBox& s_box) const {
+      s_range.Min[0] = PositionToCell(s_box.MinCorner.GetX());
+      s_range.Min[1] = PositionToCell(s_box.MinCorner.GetY());
+      s_range.Min[2] = PositionToCell(s_box.MinCorner.GetZ());
+      s_range.Max[0] = PositionToCell(s_box.MaxCorner.GetX());
+      s_range.Max[1] = PositionToCell(s_box.MaxCorner.GetY());
+      s_range.Max[2] = PositionToCell(s_box.MaxCorner.GetZ());
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CPointMass3DBroadphase::Insert(CPointMass3DModel& c_model,
+                                       const SCellRange& s_range) {
+      if(s_range.GetNumCells() > MAX_CELLS_PER_MODEL) {
+         m_vecLargeModels.push_back(&c_model);
+         return;
+      }
+      SEntry sEntry = { &c_model, &s_range };
+      for(SInt32 k = s_range.Min[2]; k <= s_range.Max[2]; ++k) {
+         for(SInt32 j = s_range.Min[1]; j <= s_range.Max[1]; ++j) {
+            for(SInt32 i = s_range.Min[0]; i <= s_range.Max[0]; ++i) {
+               TBucket& tBucket = m_vecBuckets[CellToBucket(i, j, k)];
+               /* Several cells of the model might share a bucket */
+               if(tBucket.empty() || tBucket.back().Model != &c_model) {
+                  tBucket.push_back(sEntry);
+                  ++m_unNumEntries;
+               }
+            }
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CPointMass3DBroadphase::Erase(CPointMass3DModel& c_model,
+                                      const SCellRange& s_range) {
+      if(s_range.GetNumCells() > MAX_CELLS_PER_MODEL) {
+         for(size_t i = 0; i < m_vecLargeModels.size(); ++i) {
+            if(m_vecLargeModels[i] == &c_model) {
+               m_vecLargeModels[i] = m_vecLargeModels.back();
+               m_vecLargeModels.pop_back();
+               return;
+            }
+         }
+         return;
+      }
+      for(SInt32 k = s_range.Min[2]; k <= s_range.Max[2]; ++k) {
+         for(SInt32 j = s_range.Min[1]; j <= s_range.Max[1]; ++j) {
+            for(SInt32 i = s_range.Min[0]; i <= s_range.Max[0]; ++i) {
+               TBucket& tBucket = m_vecBuckets[CellToBucket(i, j, k)];
+               for(size_t n = 0; n < tBucket.size(); ++n) {
+                  if(tBucket[n].Model == &c_model) {
+                     tBucket[n] = tBucket.back();
+                     tBucket.pop_back();
+                     --m_unNumEntries;
+                     break;
+                  }
+               }
+            }
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CPointMass3DBroadphase::Rehash(size_t un_buckets) {
+      m_vecBuckets.clear();
+      m_vecBuckets.resize(un_buckets);
+      m_vecLargeModels.clear();
+      m_unNumEntries = 0;
+      for(auto it = m_mapRanges.begin(); it != m_mapRanges.end(); ++it) {
+         CalculateCellRange(it->second, it->first->GetBoundingBox());
+         Insert(*it->first, it->second);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
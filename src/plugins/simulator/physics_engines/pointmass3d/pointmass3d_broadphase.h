@@ -0,0 +1,275 @@
+/**
+ * @file <argos3/plugins/simulator/physics_engines/pointmass3d/pointmass3d_broadphase.h>
+ */
+
+#ifndef POINTMASS3D_BROADPHASE_H
+#define POINTMASS3D_BROADPHASE_H
+
+namespace argos {
+   class CPointMass3DBroadphase;
+   class CPointMass3DModel;
+}
+
+#include <argos3/core/simulator/physics_engine/physics_model.h>
+#include <argos3/core/utility/math/ray3.h>
+#include <unordered_map>
+#include <vector>
+
+namespace argos {
+
+   /**
+    * A uniform grid over the bounding boxes of the pointmass3d models.
+    * <p>
+    * Space is divided into cubic cells of the given size. The cells are
+    * not stored explicitly: they are hashed into a table of buckets, so
+    * the grid covers the whole space at a cost that depends only on the
+    * number of models. Each model is stored in the buckets of the cells
+    * its bounding box overlaps. Models that overlap too many cells are
+    * kept in a separate list and returned by every query.
+    * </p>
+    * <p>
+    * The grid is updated incrementally: when the bounding box of a model
+    * changes, Update() moves it only if the set of cells it overlaps
+    * changed. The queries do not modify the grid, so they can be run
+    * concurrently as long as no update is taking place.
+    * </p>
+    */
+   class CPointMass3DBroadphase {
+
+   public:
+
+      CPointMass3DBroadphase();
+
+      /**
+       * Sets the side of the grid cells.
+       * Any model already in the grid is rehashed.
+       * @param f_cell_size The side of the grid cells.
+       */
+      void SetCellSize(Real f_cell_size);
+
+      /**
+       * Returns the side of the grid cells.
+       */
+      inline Real GetCellSize() const {
+         return m_fCellSize;
+      }
+
+      /**
+       * Adds a model to the grid, or moves it if it is already there.
+       * This method must be called whenever the bounding box of the model changes.
+       */
+      void Update(CPointMass3DModel& c_model);
+
+      /**
+       * Removes a model from the grid.
+       */
+      void Remove(CPointMass3DModel& c_model);
+
+      /**
+       * Removes all the models from the grid.
+       */
+      void Clear();
+
+      /**
+       * Calls c_operation(model) once for each model whose bounding box
+       * overlaps the cells overlapped by the given box.
+       * The operation returns <tt>false</tt> to stop the search.
+       */
+      template<typename OPERATION>
+      void ForModelsInBox(const SBoundingBox& s_box,
+                          OPERATION c_operation) const;
+
+      /**
+       * Calls c_operation(model) once for each model whose bounding box
+       * overlaps the cells crossed by the given ray, in the order in which
+       * the ray crosses the cells.
+       * The search stops as soon as the ray enters a cell beyond f_t_stop,
+       * which the operation can lower as it finds hits.
+       */
+      template<typename OPERATION>
+      void ForModelsAlongRay(const CRay3& c_ray,
+                             const Real& f_t_stop,
+                             OPERATION c_operation) const;
+
+   private:
+
+      struct SCellRange {
+         SInt32 Min[3];
+         SInt32 Max[3];
+
+         bool Contains(const SInt32* pn_cell) const {
+            return
+               pn_cell[0] >= Min[0] && pn_cell[0] <= Max[0] &&
+               pn_cell[1] >= Min[1] && pn_cell[1] <= Max[1] &&
+               pn_cell[2] >= Min[2] && pn_cell[2] <= Max[2];
+         }
+
+         bool operator==(const SCellRange& s_range) const {
+            return
+               Min[0] == s_range.Min[0] && Min[1] == s_range.Min[1] && Min[2] == s_range.Min[2] &&
+               Max[0] == s_range.Max[0] && Max[1] == s_range.Max[1] && Max[2] == s_range.Max[2];
+         }
+
+         UInt32 GetNumCells() const {
+            return
+               (Max[0] - Min[0] + 1) *
+               (Max[1] - Min[1] + 1) *
+               (Max[2] - Min[2] + 1);
+         }
+      };
+
+      struct SEntry {
+         CPointMass3DModel* Model;
+         const SCellRange* Range;
+      };
+
+      typedef std::vector<SEntry> TBucket;
+
+   private:
+
+      void CalculateCellRange(SCellRange& s_range,
+                              const SBoundingBox& s_box) const;
+
+      inline SInt32 PositionToCell(Real f_coord) const {
+         return static_cast<SInt32>(Floor(f_coord * m_fInvCellSize));
+      }
+
+      inline UInt32 CellToBucket(SInt32 n_i, SInt32 n_j, SInt32 n_k) const {
+         return
+            ((static_cast<UInt32>(n_i) * 73856093u) ^
+             (static_cast<UInt32>(n_j) * 19349663u) ^
+             (static_cast<UInt32>(n_k) * 83492791u)) & (m_vecBuckets.size() - 1);
+      }
+
+      void Insert(CPointMass3DModel& c_model,
+                  const SCellRange& s_range);
+
+      void Erase(CPointMass3DModel& c_model,
+                 const SCellRange& s_range);
+
+      void Rehash(size_t un_buckets);
+
+   private:
+
+      /** Models spanning more cells than this are stored in the large model list */
+      static const UInt32 MAX_CELLS_PER_MODEL;
+
+      Real m_fCellSize;
+      Real m_fInvCellSize;
+      std::vector<TBucket> m_vecBuckets;
+      std::unordered_map<CPointMass3DModel*, SCellRange> m_mapRanges;
+      std::vector<CPointMass3DModel*> m_vecLargeModels;
+      size_t m_unNumEntries;
+
+   };
+
+   /****************************************/
+   /****************************************/
+
+   template<typename OPERATION>
+   void CPointMass3DBroadphase::ForModelsInBox(const SBoundingBox& s_box,
+                                               OPERATION c_operation) const {
+      /* Large models first */
+      for(size_t i = 0; i < m_vecLargeModels.size(); ++i) {
+         if(!c_operation(*m_vecLargeModels[i])) return;
+      }
+      /* Go through the cells overlapped by the box */
+      SCellRange sQuery;
+      CalculateCellRange(sQuery, s_box);
+      SInt32 pnCell[3];
+      for(pnCell[2] = sQuery.Min[2]; pnCell[2] <= sQuery.Max[2]; ++pnCell[2]) {
+         for(pnCell[1] = sQuery.Min[1]; pnCell[1] <= sQuery.Max[1]; ++pnCell[1]) {
+            for(pnCell[0] = sQuery.Min[0]; pnCell[0] <= sQuery.Max[0]; ++pnCell[0]) {
+               const TBucket& tBucket = m_vecBuckets[CellToBucket(pnCell[0], pnCell[1], pnCell[2])];
+               for(size_t i = 0; i < tBucket.size(); ++i) {
+                  const SCellRange& sRange = *tBucket[i].Range;
+                  /* Skip the models of other cells hashed into this bucket,
+                     and report each model only in the first cell it shares
+                     with the query */
+                  if(sRange.Contains(pnCell) &&
+                     pnCell[0] == Max(sRange.Min[0], sQuery.Min[0]) &&
+                     pnCell[1] == Max(sRange.Min[1], sQuery.Min[1]) &&
+                     pnCell[2] == Max(sRange.Min[2], sQuery.Min[2])) {
+                     if(!c_operation(*tBucket[i].Model)) return;
+                  }
+               }
+            }
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<typename OPERATION>
+   void CPointMass3DBroadphase::ForModelsAlongRay(const CRay3& c_ray,
+                                                  const Real& f_t_stop,
+                                                  OPERATION c_operation) const {
+      /* Large models first */
+      for(size_t i = 0; i < m_vecLargeModels.size(); ++i) {
+         c_operation(*m_vecLargeModels[i]);
+      }
+      if(m_mapRanges.size() == m_vecLargeModels.size()) return;
+      /*
+       * Walk the cells crossed by the ray (Amanatides & Woo)
+       */
+      const CVector3& cStart = c_ray.GetStart();
+      CVector3 cDelta = c_ray.GetEnd() - cStart;
+      Real pfStart[3] = { cStart.GetX(), cStart.GetY(), cStart.GetZ() };
+      Real pfDelta[3] = { cDelta.GetX(), cDelta.GetY(), cDelta.GetZ() };
+      SInt32 pnCell[3], pnEnd[3], pnStep[3];
+      Real pfTMax[3], pfTDelta[3];
+      for(UInt32 i = 0; i < 3; ++i) {
+         pnCell[i] = PositionToCell(pfStart[i]);
+         pnEnd[i] = PositionToCell(pfStart[i] + pfDelta[i]);
+         if(pfDelta[i] > 0.0) {
+            pnStep[i] = 1;
+            pfTDelta[i] = m_fCellSize / pfDelta[i];
+            pfTMax[i] = ((pnCell[i] + 1) * m_fCellSize - pfStart[i]) / pfDelta[i];
+         }
+         else if(pfDelta[i] < 0.0) {
+            pnStep[i] = -1;
+            pfTDelta[i] = -m_fCellSize / pfDelta[i];
+            pfTMax[i] = (pnCell[i] * m_fCellSize - pfStart[i]) / pfDelta[i];
+         }
+         else {
+            pnStep[i] = 0;
+            pfTDelta[i] = 2.0;
+            pfTMax[i] = 2.0;
+         }
+      }
+      SInt32 pnPrev[3] = { 0, 0, 0 };
+      bool bFirst = true;
+      Real fTEnter = 0.0;
+      while(fTEnter < f_t_stop) {
+         const TBucket& tBucket = m_vecBuckets[CellToBucket(pnCell[0], pnCell[1], pnCell[2])];
+         for(size_t i = 0; i < tBucket.size(); ++i) {
+            const SCellRange& sRange = *tBucket[i].Range;
+            /* The cells of a box crossed by a ray are consecutive, so
+               report each model only in the first of its cells */
+            if(sRange.Contains(pnCell) &&
+               (bFirst || !sRange.Contains(pnPrev))) {
+               c_operation(*tBucket[i].Model);
+            }
+         }
+         if(pnCell[0] == pnEnd[0] && pnCell[1] == pnEnd[1] && pnCell[2] == pnEnd[2]) break;
+         /* Move to the next cell along the axis whose boundary is closest */
+         pnPrev[0] = pnCell[0]; pnPrev[1] = pnCell[1]; pnPrev[2] = pnCell[2];
+         bFirst = false;
+         UInt32 unAxis =
+            (pfTMax[0] < pfTMax[1]) ?
+            ((pfTMax[0] < pfTMax[2]) ? 0 : 2) :
+            ((pfTMax[1] < pfTMax[2]) ? 1 : 2);
+         if(pfTMax[unAxis] > 1.0) break;
+         fTEnter = pfTMax[unAxis];
+         pnCell[unAxis] += pnStep[unAxis];
+         pfTMax[unAxis] += pfTDelta[unAxis];
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
+
+#endif
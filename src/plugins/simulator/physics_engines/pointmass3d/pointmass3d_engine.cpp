@@ -15,7 +15,8 @@ namespace argos {
    /****************************************/
 
    CPointMass3DEngine::CPointMass3DEngine() :
-      m_fGravity(-9.81f) {
+      m_fGravity(-9.81f),
+      m_bDeferBroadphase(false) {
    }
 
    /****************************************/
@@ -32,15 +33,68 @@ namespace argos {
       CPhysicsEngine::Init(t_tree);
       /* Set gravity */
       GetNodeAttributeOrDefault(t_tree, "gravity", m_fGravity, m_fGravity);
+      /* Set the broadphase cell size */
+      Real fCellSize = m_cBroadphase.GetCellSize();
+      GetNodeAttributeOrDefault(t_tree, "cell_size", fCellSize, fCellSize);
+      m_cBroadphase.SetCellSize(fCellSize);
+      /* Whether the models are updated in parallel by the space */
+      bool bParallelModels = false;
+      GetNodeAttributeOrDefault(t_tree, "parallel_models", bParallelModels, bParallelModels);
+      SetModelUpdateParallel(bParallelModels);
    }
 
    /****************************************/
    /****************************************/
 
    void CPointMass3DEngine::Reset() {
-      for(auto it = m_tPhysicsModels.begin();
-          it != m_tPhysicsModels.end(); ++it) {
-         it->second->Reset();
+      for(size_t i = 0; i < m_vecPhysicsModels.size(); ++i) {
+         m_vecPhysicsModels[i]->Reset();
+      }
+      /* Rebuild the broadphase with the reset bounding boxes */
+      m_bDeferBroadphase = false;
+      m_cBroadphase.Clear();
+      for(size_t i = 0; i < m_vecPhysicsModels.size(); ++i) {
+         m_cBroadphase.Update(*m_vecPhysicsModels[i]);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CPointMass3DEngine::SaveState(CByteArray& c_buffer) {
+      c_buffer << static_cast<UInt32>(m_vecPhysicsModels.size());
+      for(size_t i = 0; i < m_vecPhysicsModels.size(); ++i) {
+         CByteArray cBlock;
+         cBlock << m_vecPhysicsModelIds[i];
+         m_vecPhysicsModels[i]->SaveState(cBlock);
+         AddMementoBlock(c_buffer, cBlock);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CPointMass3DEngine::LoadState(CByteArray& c_buffer) {
+      UInt32 unNumModels;
+      c_buffer >> unNumModels;
+      CMementoBlockReader cReader(c_buffer);
+      CByteArray cBlock;
+      std::string strId;
+      for(UInt32 i = 0; i < unNumModels; ++i) {
+         cReader.NextBlock(cBlock);
+         cBlock >> strId;
+         /* Skip the models whose entity was moved to another engine */
+         auto it = m_mapPhysicsModelIndices.find(strId);
+         if(it != m_mapPhysicsModelIndices.end()) {
+            m_vecPhysicsModels[it->second]->LoadState(cBlock);
+         }
+      }
+      cReader.Finish();
+      /* Rebuild the broadphase with the restored bounding boxes */
+      m_bDeferBroadphase = false;
+      m_cBroadphase.Clear();
+      for(size_t i = 0; i < m_vecPhysicsModels.size(); ++i) {
+         m_cBroadphase.Update(*m_vecPhysicsModels[i]);
       }
    }
 
@@ -48,12 +102,14 @@ namespace argos {
    /****************************************/
 
    void CPointMass3DEngine::Destroy() {
-      /* Empty the physics entity map */
-      for(auto it = m_tPhysicsModels.begin();
-          it != m_tPhysicsModels.end(); ++it) {
-         delete it->second;
+      /* Empty the physics model vector */
+      for(size_t i = 0; i < m_vecPhysicsModels.size(); ++i) {
+         delete m_vecPhysicsModels[i];
       }
-      m_tPhysicsModels.clear();
+      m_vecPhysicsModels.clear();
+      m_vecPhysicsModelIds.clear();
+      m_mapPhysicsModelIndices.clear();
+      m_cBroadphase.Clear();
    }
 
    /****************************************/
@@ -61,33 +117,63 @@ namespace argos {
 
    void CPointMass3DEngine::Update() {
       /* Update the physics state from the entities */
-      for(auto it = m_tPhysicsModels.begin();
-          it != m_tPhysicsModels.end(); ++it) {
-         it->second->UpdateFromEntityStatus();
+      if(!IsModelUpdateParallel()) {
+         for(size_t i = 0; i < m_vecPhysicsModels.size(); ++i) {
+            m_vecPhysicsModels[i]->UpdateFromEntityStatus();
+         }
       }
       for(size_t i = 0; i < GetIterations(); ++i) {
          /* Perform the step */
-         for(auto it = m_tPhysicsModels.begin();
-             it != m_tPhysicsModels.end(); ++it) {
-            it->second->UpdatePhysics();
+         for(size_t j = 0; j < m_vecPhysicsModels.size(); ++j) {
+            m_vecPhysicsModels[j]->UpdatePhysics();
          }
       }
-      for(auto it = m_tPhysicsModels.begin();
-          it != m_tPhysicsModels.end(); ++it) {
-         it->second->Step();
+      for(size_t i = 0; i < m_vecPhysicsModels.size(); ++i) {
+         m_vecPhysicsModels[i]->Step();
       }
       /* Update the simulated space */
-      for(auto it = m_tPhysicsModels.begin();
-          it != m_tPhysicsModels.end(); ++it) {
-         it->second->UpdateEntityStatus();
+      if(!IsModelUpdateParallel()) {
+         for(size_t i = 0; i < m_vecPhysicsModels.size(); ++i) {
+            m_vecPhysicsModels[i]->UpdateEntityStatus();
+         }
+      }
+      else {
+         /* The broadphase can't be updated concurrently */
+         m_bDeferBroadphase = true;
       }
    }
 
    /****************************************/
    /****************************************/
 
+   void CPointMass3DEngine::PostUpdate() {
+      if(m_bDeferBroadphase) {
+         m_bDeferBroadphase = false;
+         for(size_t i = 0; i < m_vecPhysicsModels.size(); ++i) {
+            m_cBroadphase.Update(*m_vecPhysicsModels[i]);
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CPointMass3DEngine::UpdateFromEntityStatus(size_t un_model) {
+      m_vecPhysicsModels[un_model]->UpdateFromEntityStatus();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CPointMass3DEngine::UpdateEntityStatus(size_t un_model) {
+      m_vecPhysicsModels[un_model]->UpdateEntityStatus();
+   }
+
+   /****************************************/
+   /****************************************/
+
    size_t CPointMass3DEngine::GetNumPhysicsModels() {
-      return m_tPhysicsModels.size();
+      return m_vecPhysicsModels.size();
    }
 
    /****************************************/
@@ -136,16 +222,39 @@ namespace argos {
    void CPointMass3DEngine::CheckIntersectionWithRay(TEmbodiedEntityIntersectionData& t_data,
                                                      const CRay3& c_ray) const {
       Real fTOnRay;
-      for(auto it = m_tPhysicsModels.begin();
-          it != m_tPhysicsModels.end();
-          ++it) {
-         if(it->second->CheckIntersectionWithRay(fTOnRay, c_ray)) {
-            t_data.push_back(
-               SEmbodiedEntityIntersectionItem(
-                  &it->second->GetEmbodiedEntity(),
-                  fTOnRay));
-         }
-      }
+      m_cBroadphase.ForModelsAlongRay(
+         c_ray, 1.0,
+         [&t_data, &fTOnRay, &c_ray] (CPointMass3DModel& c_model) {
+            if(c_model.CheckIntersectionWithRay(fTOnRay, c_ray)) {
+               t_data.push_back(
+                  SEmbodiedEntityIntersectionItem(
+                     &c_model.GetEmbodiedEntity(),
+                     fTOnRay));
+            }
+         });
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CPointMass3DEngine::CheckClosestIntersectionWithRay(SEmbodiedEntityIntersectionItem& s_item,
+                                                            const CRay3& c_ray,
+                                                            const CEmbodiedEntity* pc_ignored_entity) const {
+      Real fTOnRay;
+      bool bFound = false;
+      /* The walk along the ray stops at the cell beyond the closest hit so far */
+      m_cBroadphase.ForModelsAlongRay(
+         c_ray, s_item.TOnRay,
+         [&s_item, &bFound, &fTOnRay, &c_ray, pc_ignored_entity] (CPointMass3DModel& c_model) {
+            if(&c_model.GetEmbodiedEntity() != pc_ignored_entity &&
+               c_model.CheckIntersectionWithRay(fTOnRay, c_ray) &&
+               fTOnRay < s_item.TOnRay) {
+               s_item.IntersectedEntity = &c_model.GetEmbodiedEntity();
+               s_item.TOnRay = fTOnRay;
+               bFound = true;
+            }
+         });
+      return bFound;
    }
 
    /****************************************/
@@ -153,17 +262,38 @@ namespace argos {
 
    void CPointMass3DEngine::AddPhysicsModel(const std::string& str_id,
                                             CPointMass3DModel& c_model) {
-      m_tPhysicsModels[str_id] = &c_model;
+      auto it = m_mapPhysicsModelIndices.find(str_id);
+      if(it != m_mapPhysicsModelIndices.end()) {
+         /* Replace the model with the same id */
+         m_cBroadphase.Remove(*m_vecPhysicsModels[it->second]);
+         m_vecPhysicsModels[it->second] = &c_model;
+      }
+      else {
+         m_mapPhysicsModelIndices[str_id] = m_vecPhysicsModels.size();
+         m_vecPhysicsModels.push_back(&c_model);
+         m_vecPhysicsModelIds.push_back(str_id);
+      }
+      /* Some models never update their bounding box after creation */
+      c_model.CalculateBoundingBox();
+      m_cBroadphase.Update(c_model);
    }
 
    /****************************************/
    /****************************************/
 
    void CPointMass3DEngine::RemovePhysicsModel(const std::string& str_id) {
-      auto it = m_tPhysicsModels.find(str_id);
-      if(it != m_tPhysicsModels.end()) {
-         delete it->second;
-         m_tPhysicsModels.erase(it);
+      auto it = m_mapPhysicsModelIndices.find(str_id);
+      if(it != m_mapPhysicsModelIndices.end()) {
+         size_t unIdx = it->second;
+         m_cBroadphase.Remove(*m_vecPhysicsModels[unIdx]);
+         delete m_vecPhysicsModels[unIdx];
+         /* Move the last model into the freed slot */
+         m_vecPhysicsModels[unIdx] = m_vecPhysicsModels.back();
+         m_vecPhysicsModelIds[unIdx] = m_vecPhysicsModelIds.back();
+         m_mapPhysicsModelIndices[m_vecPhysicsModelIds[unIdx]] = unIdx;
+         m_vecPhysicsModels.pop_back();
+         m_vecPhysicsModelIds.pop_back();
+         m_mapPhysicsModelIndices.erase(str_id);
       }
       else {
          THROW_ARGOSEXCEPTION("PointMass3D model id \"" << str_id << "\" not found in point-mass 3D engine \"" << GetId() << "\"");
@@ -202,6 +332,28 @@ namespace argos {
                            "    ...\n"
                            "  </physics_engines>\n\n"
 
+                           "Ray queries and collision checks use a uniform grid over the bounding boxes of\n"
+                           "the models. The side of the grid cells defaults to 1 m, and can be changed by\n"
+                           "specifying the 'cell_size' attribute. A good value is a few times the size of\n"
+                           "the robots:\n\n"
+
+                           "  <physics_engines>\n"
+                           "    ...\n"
+                           "    <pointmass3d id=\"pm3d\" cell_size=\"0.5\"/>\n"
+                           "    ...\n"
+                           "  </physics_engines>\n\n"
+
+                           "The models of the engine are updated from their entities before each step, and\n"
+                           "the entities from their models after each step. With a multi-threaded space,\n"
+                           "these updates can be split among the threads by setting the 'parallel_models'\n"
+                           "attribute. This pays off with many robots per engine:\n\n"
+
+                           "  <physics_engines>\n"
+                           "    ...\n"
+                           "    <pointmass3d id=\"pm3d\" parallel_models=\"true\"/>\n"
+                           "    ...\n"
+                           "  </physics_engines>\n\n"
+
                            "Multiple physics engines can also be used. If multiple physics engines are used,\n"
                            "the disjoint union of the 3D volumes within the arena assigned to each engine must cover\n"
                            "the entire arena without overlapping. If the entire arena is not covered, robots can\n"
@@ -16,6 +16,9 @@ namespace argos {
 #include <argos3/core/utility/math/ray2.h>
 #include <argos3/core/simulator/entity/controllable_entity.h>
 #include <argos3/core/simulator/physics_engine/physics_engine.h>
+#include <argos3/plugins/simulator/physics_engines/pointmass3d/pointmass3d_broadphase.h>
+#include <unordered_map>
+#include <vector>
 
 namespace argos {
 
@@ -28,10 +31,18 @@ namespace argos {
 
       virtual void Init(TConfigurationNode& t_tree);
       virtual void Reset();
+      virtual void SaveState(CByteArray& c_buffer);
+      virtual void LoadState(CByteArray& c_buffer);
       virtual void Destroy();
 
       virtual void Update();
 
+      virtual void PostUpdate();
+
+      virtual void UpdateFromEntityStatus(size_t un_model);
+
+      virtual void UpdateEntityStatus(size_t un_model);
+
       virtual size_t GetNumPhysicsModels();
       virtual bool AddEntity(CEntity& c_entity);
       virtual bool RemoveEntity(CEntity& c_entity);
@@ -45,27 +56,58 @@ namespace argos {
       virtual void CheckIntersectionWithRay(TEmbodiedEntityIntersectionData& t_data,
                                             const CRay3& c_ray) const;
 
+      virtual bool CheckClosestIntersectionWithRay(SEmbodiedEntityIntersectionItem& s_item,
+                                                   const CRay3& c_ray,
+                                                   const CEmbodiedEntity* pc_ignored_entity = nullptr) const;
+
       void AddPhysicsModel(const std::string& str_id,
                            CPointMass3DModel& c_model);
       void RemovePhysicsModel(const std::string& str_id);
 
-      std::map<std::string, CPointMass3DModel*>& GetPhysicsModels() {
-         return m_tPhysicsModels;
+      std::vector<CPointMass3DModel*>& GetPhysicsModels() {
+         return m_vecPhysicsModels;
       }
 
-      const std::map<std::string, CPointMass3DModel*>& GetPhysicsModels() const {
-         return m_tPhysicsModels;
+      const std::vector<CPointMass3DModel*>& GetPhysicsModels() const {
+         return m_vecPhysicsModels;
       }
 
       inline Real GetGravity() const {
          return m_fGravity;
       }
 
+      /**
+       * Returns the broadphase structure of this engine.
+       * @return The broadphase structure of this engine.
+       */
+      inline const CPointMass3DBroadphase& GetBroadphase() const {
+         return m_cBroadphase;
+      }
+
+      /**
+       * Moves the given model in the broadphase structure.
+       * This method must be called when the bounding box of the model changes.
+       * @param c_model The model.
+       */
+      inline void UpdateBroadphase(CPointMass3DModel& c_model) {
+         if(!m_bDeferBroadphase) {
+            m_cBroadphase.Update(c_model);
+         }
+      }
+
    private:
 
       CControllableEntity::TMap m_tControllableEntities;
-      std::map<std::string, CPointMass3DModel*> m_tPhysicsModels;
+      /** The models, stored contiguously */
+      std::vector<CPointMass3DModel*> m_vecPhysicsModels;
+      /** The ids of the models, in the same order as m_vecPhysicsModels */
+      std::vector<std::string> m_vecPhysicsModelIds;
+      /** Maps a model id to its index in m_vecPhysicsModels */
+      std::unordered_map<std::string, size_t> m_mapPhysicsModelIndices;
       Real m_fGravity;
+      CPointMass3DBroadphase m_cBroadphase;
+      /** True while the entities are updated in parallel: the broadphase is refit in PostUpdate() */
+      bool m_bDeferBroadphase;
 
    };
 
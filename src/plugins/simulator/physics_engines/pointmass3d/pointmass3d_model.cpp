@@ -30,6 +30,21 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CPointMass3DModel::SaveState(CByteArray& c_buffer) {
+      c_buffer << m_cPosition << m_cVelocity << m_cAcceleration;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CPointMass3DModel::LoadState(CByteArray& c_buffer) {
+      c_buffer >> m_cPosition >> m_cVelocity >> m_cAcceleration;
+      UpdateEntityStatus();
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CPointMass3DModel::MoveTo(const CVector3& c_position,
                                   const CQuaternion& c_orientation) {
       m_cPosition = c_position;
@@ -39,15 +54,28 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CPointMass3DModel::UpdateEntityStatus() {
+      CPhysicsModel::UpdateEntityStatus();
+      m_cPM3DEngine.UpdateBroadphase(*this);
+   }
+
+   /****************************************/
+   /****************************************/
+
    bool CPointMass3DModel::IsCollidingWithSomething() const {
-      /* Go through other objects and check if the BB intersect */
-      for(auto it = GetPM3DEngine().GetPhysicsModels().begin();
-          it != GetPM3DEngine().GetPhysicsModels().end(); ++it) {
-         if((it->second != this) &&
-            GetBoundingBox().Intersects(it->second->GetBoundingBox()))
+      /* Go through the nearby objects and check if the BB intersect */
+      bool bColliding = false;
+      GetPM3DEngine().GetBroadphase().ForModelsInBox(
+         GetBoundingBox(),
+         [this, &bColliding] (CPointMass3DModel& c_model) {
+            if((&c_model != this) &&
+               GetBoundingBox().Intersects(c_model.GetBoundingBox())) {
+               bColliding = true;
+               return false;
+            }
             return true;
-      }
-      return false;
+         });
+      return bColliding;
    }
 
    /****************************************/
@@ -36,6 +36,15 @@ namespace argos {
 
       virtual void Reset();
 
+      virtual void SaveState(CByteArray& c_buffer);
+
+      virtual void LoadState(CByteArray& c_buffer);
+
+      /**
+       * Updates the entity status and moves the model in the broadphase of the engine.
+       */
+      virtual void UpdateEntityStatus();
+
       virtual void Step() = 0;
       virtual void UpdateFromEntityStatus() = 0;
 
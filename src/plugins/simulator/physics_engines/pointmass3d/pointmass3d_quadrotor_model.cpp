@@ -82,6 +82,33 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CPointMass3DQuadRotorModel::SaveState(CByteArray& c_buffer) {
+      /* The base class state must come last, as restoring it updates the entity */
+      c_buffer << m_cYaw
+               << m_cRotSpeed
+               << m_pfLinearError[0]
+               << m_pfLinearError[1]
+               << m_pfLinearError[2]
+               << m_fRotError;
+      CPointMass3DModel::SaveState(c_buffer);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CPointMass3DQuadRotorModel::LoadState(CByteArray& c_buffer) {
+      c_buffer >> m_cYaw
+               >> m_cRotSpeed
+               >> m_pfLinearError[0]
+               >> m_pfLinearError[1]
+               >> m_pfLinearError[2]
+               >> m_fRotError;
+      CPointMass3DModel::LoadState(c_buffer);
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CPointMass3DQuadRotorModel::UpdateFromEntityStatus() {
       m_sDesiredPositionData = m_cQuadRotorEntity.GetPositionControlData();
    }
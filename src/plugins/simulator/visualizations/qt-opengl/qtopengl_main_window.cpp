@@ -453,6 +453,10 @@ namespace argos {
          m_pcOpenGLWidget->GetCamera().Init(tCameraNode);
       }
       m_pcOpenGLWidget->GetFrameGrabData().Init(t_tree);
+      /* Replay a trajectory file instead of simulating? */
+      if(NodeExists(t_tree, "replay")) {
+         m_pcOpenGLWidget->InitReplay(GetNode(t_tree, "replay"));
+      }
 
       /* Set headless grabbing frame size after it has been parsed */
       if (m_pcOpenGLWidget->GetFrameGrabData().HeadlessGrabbing) {
@@ -501,6 +505,7 @@ namespace argos {
       /* Create a textual window to be used as a buffer */
       m_pcDockLogBuffer = new QTextEdit();
       m_pcDockLogBuffer->setReadOnly(true);
+      LOG.DisableAsyncWriter(); /* The text widget must be written by this thread */
       LOG.Flush(); /* Write all the pending stuff */
       LOG.DisableColoredOutput(); /* Colors are not necessary */
       m_pcDockLogBuffer->append("<b>[t=0]</b> Log started."); /* Write something in the buffer */
@@ -520,6 +525,7 @@ namespace argos {
       /* Create a textual window to be used as a buffer */
       m_pcDockLogErrBuffer = new QTextEdit();
       m_pcDockLogErrBuffer->setReadOnly(true);
+      LOGERR.DisableAsyncWriter(); /* The text widget must be written by this thread */
       LOGERR.Flush(); /* Write all the pending stuff */
       LOGERR.DisableColoredOutput(); /* Colors are not necessary */
       m_pcDockLogErrBuffer->append("<b>[t=0]</b> LogErr started."); /* Write something in the buffer */
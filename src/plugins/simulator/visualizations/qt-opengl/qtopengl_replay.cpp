@@ -0,0 +1,130 @@
+/**
+ * @file <argos3/plugins/simulator/visualizations/qt-opengl/qtopengl_replay.cpp>
+ */
+
+#include "qtopengl_replay.h"
+
+#include <argos3/core/utility/logging/argos_log.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/simulator/entity/composable_entity.h>
+#include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/plugins/simulator/entities/led_equipped_entity.h>
+#include <argos3/plugins/simulator/entities/led_trajectory_channel.h>
+#include <algorithm>
+#include <cmath>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLReplay::CQTOpenGLReplay(CSpace& c_space) :
+      m_cSpace(c_space),
+      m_unStep(0),
+      m_unPoseChannel(0),
+      m_unLEDChannel(0) {}
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLReplay::Init(TConfigurationNode& t_tree) {
+      std::string strFileName;
+      GetNodeAttribute(t_tree, "file", strFileName);
+      m_cReader.Open(strFileName);
+      if(m_cReader.HasChannel("pose")) {
+         m_unPoseChannel = m_cReader.GetChannelIndex("pose");
+      }
+      else {
+         m_unPoseChannel = m_cReader.GetNumChannels();
+      }
+      if(m_cReader.HasChannel("leds")) {
+         m_unLEDChannel = m_cReader.GetChannelIndex("leds");
+      }
+      else {
+         m_unLEDChannel = m_cReader.GetNumChannels();
+      }
+      /* Match the recorded entities with those in the space */
+      m_vecBodies.assign(m_cReader.GetNumEntities(), nullptr);
+      m_vecLEDs.assign(m_cReader.GetNumEntities(), nullptr);
+      CEntity::TMap& tEntities = m_cSpace.GetEntityMapPerId();
+      for(size_t e = 0; e < m_cReader.GetNumEntities(); ++e) {
+         auto it = tEntities.find(m_cReader.GetEntityId(e));
+         auto* pcEntity = (it != tEntities.end()) ? dynamic_cast<CComposableEntity*>(it->second) : nullptr;
+         if(pcEntity == nullptr) {
+            LOGERR << "[WARNING] Recorded entity \""
+                   << m_cReader.GetEntityId(e)
+                   << "\" not found in the arena, it won't be replayed"
+                   << std::endl;
+            continue;
+         }
+         if(m_unPoseChannel < m_cReader.GetNumChannels() &&
+            m_cReader.GetNumValues(m_unPoseChannel, e) == 7 &&
+            pcEntity->HasComponent("body")) {
+            m_vecBodies[e] = &pcEntity->GetComponent<CEmbodiedEntity>("body");
+         }
+         if(m_unLEDChannel < m_cReader.GetNumChannels() &&
+            m_cReader.GetNumValues(m_unLEDChannel, e) > 0 &&
+            pcEntity->HasComponent("leds")) {
+            m_vecLEDs[e] = &pcEntity->GetComponent<CLEDEquippedEntity>("leds");
+         }
+      }
+      LOG << "[INFO] Replaying "
+          << m_cReader.GetNumSteps()
+          << " recorded steps from \""
+          << strFileName
+          << "\""
+          << std::endl;
+      Reset();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLReplay::Reset() {
+      m_unStep = 0;
+      if(m_cReader.GetNumSteps() > 0) {
+         Apply(m_unStep++);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CQTOpenGLReplay::Step() {
+      if(IsFinished()) {
+         return false;
+      }
+      Apply(m_unStep++);
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLReplay::Apply(size_t un_step) {
+      m_cSpace.SetSimulationClock(m_cReader.GetClock(un_step));
+      for(size_t e = 0; e < m_vecBodies.size(); ++e) {
+         if(m_vecBodies[e] != nullptr) {
+            const float* pfPose = m_cReader.GetFloats(m_unPoseChannel, un_step, e);
+            /* The entity was removed at this step */
+            if(std::isnan(pfPose[0])) continue;
+            m_vecBodies[e]->MoveTo(CVector3(pfPose[0], pfPose[1], pfPose[2]),
+                                   CQuaternion(pfPose[3], pfPose[4], pfPose[5], pfPose[6]),
+                                   false,
+                                   true);
+         }
+         if(m_vecLEDs[e] != nullptr) {
+            const UInt32* punColors = m_cReader.GetUInt32s(m_unLEDChannel, un_step, e);
+            UInt32 unNumLEDs = std::min<UInt32>(m_cReader.GetNumValues(m_unLEDChannel, e),
+                                                m_vecLEDs[e]->GetLEDs().size());
+            for(UInt32 i = 0; i < unNumLEDs; ++i) {
+               m_vecLEDs[e]->GetLED(i).SetColor(CLEDTrajectoryChannel::DecodeColor(punColors[i]));
+            }
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
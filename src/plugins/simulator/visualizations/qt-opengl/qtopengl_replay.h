@@ -0,0 +1,92 @@
+/**
+ * @file <argos3/plugins/simulator/visualizations/qt-opengl/qtopengl_replay.h>
+ */
+
+#ifndef QTOPENGL_REPLAY_H
+#define QTOPENGL_REPLAY_H
+
+namespace argos {
+   class CQTOpenGLReplay;
+   class CSpace;
+   class CEmbodiedEntity;
+   class CLEDEquippedEntity;
+}
+
+#include <argos3/core/utility/configuration/argos_configuration.h>
+#include <argos3/core/simulator/recorder/trajectory_reader.h>
+#include <vector>
+
+namespace argos {
+
+   /**
+    * Replays a trajectory file written by CTrajectoryRecorder.
+    * <p>
+    * Replay is enabled by adding the following node to the
+    * <tt>&lt;qt-opengl&gt;</tt> section:
+    * </p>
+    * <pre>
+    * &lt;replay file="trajectory.argostrj" /&gt;
+    * </pre>
+    * <p>
+    * The experiment is not simulated: at each step, the recorded poses and
+    * LED colors are applied to the entities with the same id, and the
+    * simulation clock is set to the recorded one. Entities that are not in
+    * the file, or channels other than <tt>pose</tt> and <tt>leds</tt>, are
+    * left untouched.
+    * </p>
+    */
+   class CQTOpenGLReplay {
+
+   public:
+
+      /**
+       * Class constructor.
+       * @param c_space The space.
+       */
+      CQTOpenGLReplay(CSpace& c_space);
+
+      /**
+       * Opens the file and matches the recorded entities with those in the space.
+       * @param t_tree The <tt>&lt;replay&gt;</tt> XML node.
+       * @throws CARGoSException if the file can't be read.
+       */
+      void Init(TConfigurationNode& t_tree);
+
+      /**
+       * Goes back to the first recorded step and applies it.
+       */
+      void Reset();
+
+      /**
+       * Applies the next recorded step.
+       * @return <tt>false</tt> if there are no more recorded steps.
+       */
+      bool Step();
+
+      /**
+       * Returns <tt>true</tt> if all the recorded steps have been applied.
+       * @return <tt>true</tt> if all the recorded steps have been applied.
+       */
+      inline bool IsFinished() const {
+         return m_unStep >= m_cReader.GetNumSteps();
+      }
+
+   private:
+
+      void Apply(size_t un_step);
+
+   private:
+
+      CSpace& m_cSpace;
+      CTrajectoryReader m_cReader;
+      size_t m_unStep;
+      size_t m_unPoseChannel;
+      size_t m_unLEDChannel;
+      std::vector<CEmbodiedEntity*> m_vecBodies;
+      std::vector<CLEDEquippedEntity*> m_vecLEDs;
+
+   };
+
+}
+
+#endif
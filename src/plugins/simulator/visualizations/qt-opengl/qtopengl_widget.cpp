@@ -7,6 +7,7 @@
 #include "qtopengl_widget.h"
 #include "qtopengl_main_window.h"
 #include "qtopengl_user_functions.h"
+#include "qtopengl_replay.h"
 
 #include <argos3/core/utility/logging/argos_log.h>
 #include <argos3/core/utility/math/plane.h>
@@ -54,7 +55,8 @@ namespace argos {
       m_bShowBoundary(true),
       m_bUsingFloorTexture(false),
       m_pcFloorTexture(nullptr),
-      m_pcGroundTexture(nullptr) {
+      m_pcGroundTexture(nullptr),
+      m_pcReplay(nullptr) {
       /* Set the widget's size policy */
       QSizePolicy cSizePolicy(QSizePolicy::Minimum, QSizePolicy::Minimum);
       cSizePolicy.setHeightForWidth(true);
@@ -82,6 +84,7 @@ namespace argos {
          delete m_pcFloorTexture;
       }
       doneCurrent();
+      delete m_pcReplay;
    }
 
    /****************************************/
@@ -510,8 +513,16 @@ namespace argos {
    /****************************************/
 
    void CQTOpenGLWidget::StepExperiment() {
-      if(!m_cSimulator.IsExperimentFinished()) {
+      /* When replaying, the recorded step replaces the simulated one */
+      bool bStepped = false;
+      if(m_pcReplay != nullptr) {
+         bStepped = m_pcReplay->Step();
+      }
+      else if(!m_cSimulator.IsExperimentFinished()) {
          m_cSimulator.UpdateSpace();
+         bStepped = true;
+      }
+      if(bStepped) {
          if(m_bFastForwarding) {
             /* Frame dropping happens only in fast-forward */
             m_nFrameCounter = m_nFrameCounter % m_nDrawFrameEvery;
@@ -536,6 +547,9 @@ namespace argos {
 
    void CQTOpenGLWidget::ResetExperiment() {
       m_cSimulator.Reset();
+      if(m_pcReplay != nullptr) {
+         m_pcReplay->Reset();
+      }
       m_cCamera.Reset();
       delete m_pcGroundTexture;
       if(m_bUsingFloorTexture) delete m_pcFloorTexture;
@@ -546,6 +560,15 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CQTOpenGLWidget::InitReplay(TConfigurationNode& t_tree) {
+      delete m_pcReplay;
+      m_pcReplay = new CQTOpenGLReplay(m_cSpace);
+      m_pcReplay->Init(t_tree);
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CQTOpenGLWidget::SetDrawFrameEvery(SInt32 n_every) {
       m_nDrawFrameEvery = n_every;
    }
@@ -17,6 +17,7 @@ namespace argos {
    class CPositionalEntity;
    class CControllableEntity;
    class CEmbodiedEntity;
+   class CQTOpenGLReplay;
 }
 
 #include <argos3/plugins/simulator/visualizations/qt-opengl/qtopengl_camera.h>
@@ -226,6 +227,14 @@ namespace argos {
          return m_sFrameGrabData;
       }
 
+      /**
+       * Switches to replay mode.
+       * Instead of simulating the experiment, the widget replays a trajectory file.
+       * @param t_tree The <tt>&lt;replay&gt;</tt> XML node.
+       * @see CQTOpenGLReplay
+       */
+      void InitReplay(TConfigurationNode& t_tree);
+
       /**
        * Sets whether the mouse should be inverted when moving.
        */
@@ -408,6 +417,8 @@ namespace argos {
       CQTOpenGLCamera m_cCamera;
       /** Data on frame grabbing */
       SFrameGrabData m_sFrameGrabData;
+      /** The replayed trajectory file, or nullptr when simulating */
+      CQTOpenGLReplay* m_pcReplay;
 
       /** Current direction of motion */
       enum EDirection {
@@ -42,7 +42,7 @@ namespace argos {
          if(itRobotInterface->Messages.size() != 1) {
             THROW_ARGOSEXCEPTION("Robot's \"nfc\" radio did not have exactly one message");
          }
-         const CByteArray& cRobotMessage = itRobotInterface->Messages[0];
+         const CByteArray& cRobotMessage = *itRobotInterface->Messages[0];
          /* Get a reference to the first message in the block's south interface */
          if(pcBlock == nullptr) {
             THROW_ARGOSEXCEPTION("Entity with identifier \"block\" was not a block");
@@ -61,7 +61,7 @@ namespace argos {
          if(itBlockInterface->Messages.size() != 1) {
             THROW_ARGOSEXCEPTION("Block's \"south\" radio did not have exactly one message");
          }
-         const CByteArray& cBlockMessage = itBlockInterface->Messages[0];
+         const CByteArray& cBlockMessage = *itBlockInterface->Messages[0];
 
          /* the robot and block are constantly sending a Lua table containing the string 'ping' or
             'pong' at index 1. At any timestep, these messages should be the same */
@@ -0,0 +1,29 @@
+# run the sweep: two jobs fail, so argos3 must exit with 1
+execute_process(
+  COMMAND ${ARGOS3} --batch sweep.txt -j 2 -o sweep.summary
+  RESULT_VARIABLE nResult)
+if(NOT nResult EQUAL 1)
+  message(FATAL_ERROR "argos3 exited with ${nResult} instead of 1")
+endif()
+# one summary line per job
+file(STRINGS sweep.summary lstJobs REGEX "^[0-9]")
+list(LENGTH lstJobs nJobs)
+if(NOT nJobs EQUAL 4)
+  message(FATAL_ERROR "The summary has ${nJobs} jobs instead of 4")
+endif()
+# the jobs end in any order
+foreach(strExpected
+    "^0\tok\t10\t[^\t]*\t[^\t]*\t[^\t]*\tseed=11\t"
+    "^1\tok\t10\t[^\t]*\t[^\t]*\t[^\t]*\tseed=12\t"
+    "^2\terror: [^\t]*nonexistent"
+    "^3\terror: [^\t]*not possible in a batch job")
+  set(bFound FALSE)
+  foreach(strJob IN LISTS lstJobs)
+    if(strJob MATCHES "${strExpected}")
+      set(bFound TRUE)
+    endif()
+  endforeach()
+  if(NOT bFound)
+    message(FATAL_ERROR "No summary line matches \"${strExpected}\":\n${lstJobs}")
+  endif()
+endforeach()
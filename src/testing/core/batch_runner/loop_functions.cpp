@@ -0,0 +1,31 @@
+#include "loop_functions.h"
+#include <argos3/core/simulator/simulator.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   void CTestLoopFunctions::Init(TConfigurationNode& t_tree) {
+      /* The random seed and the attribute are overridden together by the sweep */
+      UInt32 unSeed;
+      GetNodeAttribute(t_tree, "seed", unSeed);
+      if(CSimulator::GetInstance().GetRandomSeed() != unSeed) {
+         THROW_ARGOSEXCEPTION("The random seed is " << CSimulator::GetInstance().GetRandomSeed() <<
+                              " instead of " << unSeed);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   std::string CTestLoopFunctions::GetResult() {
+      return "seed=" + ToString(CSimulator::GetInstance().GetRandomSeed());
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_LOOP_FUNCTIONS(CTestLoopFunctions, "test_loop_functions");
+
+}
@@ -0,0 +1,60 @@
+#include "loop_functions.h"
+#include <argos3/core/simulator/simulator.h>
+
+#include <set>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   static const UInt32 BRANCHES = 3;
+   static const UInt32 STEPS = 20;
+
+   /****************************************/
+   /****************************************/
+
+   void CTestLoopFunctions::PostExperiment() {
+      CSimulator& cSimulator = CSimulator::GetInstance();
+      /* The branches are checked by the process that forked them */
+      if(cSimulator.GetBranch() != 0) {
+         return;
+      }
+      const std::vector<CSimulator::SBranchResult>& vecResults = cSimulator.GetBranchResults();
+      if(vecResults.size() != BRANCHES) {
+         THROW_ARGOSEXCEPTION(vecResults.size() << " branches reported instead of " << BRANCHES);
+      }
+      std::set<UInt32> setSeeds;
+      setSeeds.insert(cSimulator.GetRandomSeed());
+      for(size_t i = 0; i < vecResults.size(); ++i) {
+         const CSimulator::SBranchResult& sResult = vecResults[i];
+         if(!sResult.Success) {
+            THROW_ARGOSEXCEPTION("Branch " << sResult.Branch << " failed: " << sResult.Result);
+         }
+         if(sResult.Steps != STEPS) {
+            THROW_ARGOSEXCEPTION("Branch " << sResult.Branch << " ran " << sResult.Steps <<
+                                 " steps instead of " << STEPS);
+         }
+         if(sResult.Result != "branch=" + ToString(sResult.Branch)) {
+            THROW_ARGOSEXCEPTION("Branch " << sResult.Branch << " reported \"" << sResult.Result << "\"");
+         }
+         /* Each branch has its own random streams */
+         if(!setSeeds.insert(sResult.Seed).second) {
+            THROW_ARGOSEXCEPTION("Branch " << sResult.Branch << " reused the random seed " << sResult.Seed);
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   std::string CTestLoopFunctions::GetResult() {
+      return "branch=" + ToString(CSimulator::GetInstance().GetBranch());
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_LOOP_FUNCTIONS(CTestLoopFunctions, "test_loop_functions");
+
+}
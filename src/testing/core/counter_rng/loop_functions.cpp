@@ -0,0 +1,77 @@
+#include "loop_functions.h"
+#include <argos3/core/utility/math/rng.h>
+
+#include <iomanip>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   /* A key and a counter, with the block they produce */
+   struct SPhiloxVector {
+      UInt32 Key[2];
+      UInt32 Counter[4];
+      UInt32 Expected[4];
+   };
+
+   /* The philox4x32 known-answer vectors of Random123, with 10 rounds */
+   static const SPhiloxVector PHILOX_VECTORS[] = {
+      {{0x00000000, 0x00000000},
+       {0x00000000, 0x00000000, 0x00000000, 0x00000000},
+       {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}},
+      {{0xffffffff, 0xffffffff},
+       {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+       {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}},
+      {{0xa4093822, 0x299f31d0},
+       {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+       {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}}
+   };
+
+   /****************************************/
+   /****************************************/
+
+   void CTestLoopFunctions::Init(TConfigurationNode& t_tree) {
+      /* Check the block function against the reference vectors */
+      for(const SPhiloxVector& sVector : PHILOX_VECTORS) {
+         UInt32 punBlock[4] = {
+            sVector.Counter[0], sVector.Counter[1], sVector.Counter[2], sVector.Counter[3]
+         };
+         CRandom::CCounterRNG::Philox(sVector.Key, punBlock);
+         for(size_t i = 0; i < 4; ++i) {
+            if(punBlock[i] != sVector.Expected[i]) {
+               THROW_ARGOSEXCEPTION("Philox4x32-10 returned 0x" <<
+                                    std::hex << std::setw(8) << std::setfill('0') << punBlock[i] <<
+                                    " instead of 0x" <<
+                                    std::setw(8) << sVector.Expected[i] <<
+                                    " in word " << std::dec << i <<
+                                    " of a known-answer test");
+            }
+         }
+      }
+      /* The draws of a tick must not depend on the draws of the previous ticks */
+      CRandom::CCounterRNG cRNG(12345, 3);
+      cRNG.SetTick(7);
+      UInt32 unFirst = cRNG.Uniform32bit();
+      cRNG.SetTick(8);
+      cRNG.Uniform32bit();
+      cRNG.Uniform32bit();
+      cRNG.SetTick(7);
+      if(cRNG.Uniform32bit() != unFirst) {
+         THROW_ARGOSEXCEPTION("The counter-based RNG returned different numbers for the same tick");
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CTestLoopFunctions::IsExperimentFinished() {
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_LOOP_FUNCTIONS(CTestLoopFunctions, "test_loop_functions");
+
+}
@@ -0,0 +1,23 @@
+#ifndef TEST_LOOP_FUNCTIONS_H
+#define TEST_LOOP_FUNCTIONS_H
+
+#include <argos3/core/simulator/loop_functions.h>
+
+namespace argos {
+
+   class CTestLoopFunctions : public CLoopFunctions {
+
+   public:
+
+      CTestLoopFunctions() {}
+
+      virtual ~CTestLoopFunctions() {}
+
+      virtual void Init(TConfigurationNode& t_tree) override;
+
+      virtual bool IsExperimentFinished() override;
+
+   };
+}
+
+#endif
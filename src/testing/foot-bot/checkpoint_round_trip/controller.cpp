@@ -0,0 +1,34 @@
+#include "controller.h"
+
+#include <argos3/plugins/robots/generic/control_interface/ci_differential_steering_actuator.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   static const CRange<Real> WHEEL_SPEED_RANGE(-5.0, 10.0);
+
+   /****************************************/
+   /****************************************/
+
+   void CTestController::Init(TConfigurationNode& t_tree) {
+      m_pcWheels = GetActuator<CCI_DifferentialSteeringActuator>("differential_steering");
+      m_pcRNG = CRandom::CreateRNG("argos");
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTestController::ControlStep() {
+      /* The trajectory depends on the state of the random number generator */
+      m_pcWheels->SetLinearVelocity(m_pcRNG->Uniform(WHEEL_SPEED_RANGE),
+                                    m_pcRNG->Uniform(WHEEL_SPEED_RANGE));
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_CONTROLLER(CTestController, "test_controller");
+
+}
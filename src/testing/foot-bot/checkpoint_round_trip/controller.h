@@ -0,0 +1,30 @@
+#include <argos3/core/control_interface/ci_controller.h>
+#include <argos3/core/utility/math/rng.h>
+
+namespace argos {
+   class CCI_DifferentialSteeringActuator;
+}
+
+namespace argos {
+
+   class CTestController : public CCI_Controller {
+
+   public:
+
+      CTestController() :
+         m_pcWheels(nullptr),
+         m_pcRNG(nullptr) {}
+
+      virtual ~CTestController() {}
+
+      virtual void Init(TConfigurationNode& t_tree);
+
+      virtual void ControlStep();
+
+   private:
+
+      CCI_DifferentialSteeringActuator* m_pcWheels;
+      CRandom::CRNG* m_pcRNG;
+
+   };
+}
@@ -0,0 +1,87 @@
+#include "loop_functions.h"
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/plugins/robots/foot-bot/simulator/footbot_entity.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   const UInt32 CTestLoopFunctions::CHECKPOINT_CLOCK = 20;
+   const UInt32 CTestLoopFunctions::COMPARISON_CLOCK = 50;
+   const std::string CTestLoopFunctions::CHECKPOINT_FILE = "round_trip.checkpoint";
+
+   static const CRange<UInt32> RANDOM_RANGE(0, 1000000);
+
+   /****************************************/
+   /****************************************/
+
+   void CTestLoopFunctions::Init(TConfigurationNode& t_tree) {
+      m_pcRNG = CRandom::CreateRNG("argos");
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTestLoopFunctions::PostStep() {
+      CSimulator& cSimulator = CSimulator::GetInstance();
+      if(GetSpace().GetSimulationClock() == CHECKPOINT_CLOCK && !m_bRestored) {
+         cSimulator.SaveCheckpoint(CHECKPOINT_FILE);
+      }
+      else if(GetSpace().GetSimulationClock() == COMPARISON_CLOCK) {
+         if(!m_bRestored) {
+            /* Run the same steps again from the checkpoint */
+            Record(m_vecPositions, m_unRandom);
+            cSimulator.LoadCheckpoint(CHECKPOINT_FILE);
+            m_bRestored = true;
+            if(GetSpace().GetSimulationClock() != CHECKPOINT_CLOCK) {
+               THROW_ARGOSEXCEPTION("The checkpoint restored step " << GetSpace().GetSimulationClock() <<
+                                    " instead of step " << CHECKPOINT_CLOCK);
+            }
+         }
+         else {
+            std::vector<CVector3> vecPositions;
+            UInt32 unRandom;
+            Record(vecPositions, unRandom);
+            for(size_t i = 0; i < vecPositions.size(); ++i) {
+               if(vecPositions[i] != m_vecPositions[i]) {
+                  THROW_ARGOSEXCEPTION("Robot " << i << " is at " << vecPositions[i] <<
+                                       " after the restore instead of " << m_vecPositions[i]);
+               }
+            }
+            if(unRandom != m_unRandom) {
+               THROW_ARGOSEXCEPTION("The random number generators were not restored");
+            }
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CTestLoopFunctions::IsExperimentFinished() {
+      return m_bRestored && GetSpace().GetSimulationClock() >= COMPARISON_CLOCK;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTestLoopFunctions::Record(std::vector<CVector3>& vec_positions,
+                                   UInt32& un_random) {
+      CSpace::TMapPerType& tFootBots = GetSpace().GetEntitiesByType("foot-bot");
+      vec_positions.clear();
+      for(CSpace::TMapPerType::iterator it = tFootBots.begin();
+          it != tFootBots.end();
+          ++it) {
+         CFootBotEntity& cFootBot = *any_cast<CFootBotEntity*>(it->second);
+         vec_positions.push_back(cFootBot.GetEmbodiedEntity().GetOriginAnchor().Position);
+      }
+      un_random = m_pcRNG->Uniform(RANDOM_RANGE);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_LOOP_FUNCTIONS(CTestLoopFunctions, "test_loop_functions");
+
+}
@@ -0,0 +1,45 @@
+#ifndef TEST_LOOP_FUNCTIONS_H
+#define TEST_LOOP_FUNCTIONS_H
+
+#include <argos3/core/simulator/loop_functions.h>
+#include <argos3/core/utility/math/rng.h>
+
+namespace argos {
+
+   class CTestLoopFunctions : public CLoopFunctions {
+
+   public:
+
+      CTestLoopFunctions() :
+         m_pcRNG(nullptr),
+         m_bRestored(false) {}
+
+      virtual ~CTestLoopFunctions() {}
+
+      virtual void Init(TConfigurationNode& t_tree) override;
+
+      virtual void PostStep() override;
+
+      virtual bool IsExperimentFinished() override;
+
+   private:
+
+      /* Records the positions of the robots and the next random number */
+      void Record(std::vector<CVector3>& vec_positions,
+                  UInt32& un_random);
+
+   private:
+
+      const static UInt32 CHECKPOINT_CLOCK;
+      const static UInt32 COMPARISON_CLOCK;
+      const static std::string CHECKPOINT_FILE;
+
+      CRandom::CRNG* m_pcRNG;
+      bool m_bRestored;
+      std::vector<CVector3> m_vecPositions;
+      UInt32 m_unRandom;
+
+   };
+}
+
+#endif
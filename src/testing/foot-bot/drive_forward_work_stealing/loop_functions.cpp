@@ -0,0 +1,58 @@
+#include "loop_functions.h"
+#include <argos3/plugins/robots/foot-bot/simulator/footbot_entity.h>
+#include <argos3/core/simulator/entity/embodied_entity.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   void CTestLoopFunctions::PostStep() {
+      /* Visit all the robots through the threads of the space */
+      m_unVisited = 0;
+      IterateOverControllableEntities([this](CControllableEntity*) {
+            ++m_unVisited;
+         });
+      if(m_unVisited != NUM_ROBOTS) {
+         THROW_ARGOSEXCEPTION("Visited " << m_unVisited << " robots instead of " << NUM_ROBOTS);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CTestLoopFunctions::IsExperimentFinished() {
+      if(GetSpace().GetSimulationClock() < 100) {
+         return false;
+      }
+      else {
+         CSpace::TMapPerType& tFootBots = GetSpace().GetEntitiesByType("foot-bot");
+         if(tFootBots.size() != NUM_ROBOTS) {
+            THROW_ARGOSEXCEPTION("Expected " << NUM_ROBOTS << " robots, found " << tFootBots.size());
+         }
+         for(CSpace::TMapPerType::iterator it = tFootBots.begin();
+             it != tFootBots.end();
+             ++it) {
+            CFootBotEntity& cFootBot = *any_cast<CFootBotEntity*>(it->second);
+            const CVector3& cPosition = cFootBot.GetEmbodiedEntity().GetOriginAnchor().Position;
+            if(Abs(cPosition.GetX() - TARGET_X) > THRESHOLD) {
+               THROW_ARGOSEXCEPTION("Robot \"" << cFootBot.GetId() << "\" did not drive forwards to the target position");
+            }
+         }
+         return true;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   const UInt32 CTestLoopFunctions::NUM_ROBOTS = 20;
+   const Real CTestLoopFunctions::TARGET_X = 0.5;
+   const Real CTestLoopFunctions::THRESHOLD = 0.01;
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_LOOP_FUNCTIONS(CTestLoopFunctions, "test_loop_functions");
+
+}
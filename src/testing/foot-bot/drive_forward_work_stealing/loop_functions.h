@@ -0,0 +1,32 @@
+#ifndef TEST_LOOP_FUNCTIONS_H
+#define TEST_LOOP_FUNCTIONS_H
+
+#include <argos3/core/simulator/loop_functions.h>
+#include <atomic>
+
+namespace argos {
+
+   class CTestLoopFunctions : public CLoopFunctions {
+
+   public:
+
+      CTestLoopFunctions() {}
+
+      virtual ~CTestLoopFunctions() {}
+
+      virtual void PostStep() override;
+
+      virtual bool IsExperimentFinished() override;
+
+   private:
+
+      const static UInt32 NUM_ROBOTS;
+      const static Real TARGET_X;
+      const static Real THRESHOLD;
+
+      std::atomic<UInt32> m_unVisited;
+
+   };
+}
+
+#endif
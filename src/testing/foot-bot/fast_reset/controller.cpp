@@ -0,0 +1,50 @@
+#include "controller.h"
+
+#include <argos3/plugins/robots/generic/control_interface/ci_differential_steering_actuator.h>
+#include <argos3/plugins/robots/foot-bot/control_interface/ci_footbot_turret_actuator.h>
+#include <argos3/plugins/robots/foot-bot/control_interface/ci_footbot_distance_scanner_actuator.h>
+#include <argos3/plugins/robots/foot-bot/control_interface/ci_footbot_proximity_sensor.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   static const CRange<Real> WHEEL_SPEED_RANGE(-5.0, 10.0);
+   static const CRange<Real> SCANNER_RPM_RANGE(-60.0, 60.0);
+
+   /****************************************/
+   /****************************************/
+
+   void CTestController::Init(TConfigurationNode& t_tree) {
+      m_pcWheels = GetActuator<CCI_DifferentialSteeringActuator>("differential_steering");
+      m_pcTurret = GetActuator<CCI_FootBotTurretActuator>("footbot_turret");
+      m_pcDistanceScanner = GetActuator<CCI_FootBotDistanceScannerActuator>("footbot_distance_scanner");
+      m_pcProximity = GetSensor<CCI_FootBotProximitySensor>("footbot_proximity");
+      m_pcRNG = CRandom::CreateRNG("argos");
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTestController::ControlStep() {
+      /* Slow down close to the other robots */
+      Real fProximity = 0.0;
+      const CCI_FootBotProximitySensor::TReadings& tReadings = m_pcProximity->GetReadings();
+      for(size_t i = 0; i < tReadings.size(); ++i) {
+         fProximity += tReadings[i].Value;
+      }
+      m_pcWheels->SetLinearVelocity(m_pcRNG->Uniform(WHEEL_SPEED_RANGE) - fProximity,
+                                    m_pcRNG->Uniform(WHEEL_SPEED_RANGE) - fProximity);
+      /* Move the turret and the distance scanner at random */
+      m_pcTurret->SetActiveWithRotation(m_pcRNG->Uniform(CRadians::SIGNED_RANGE));
+      m_pcDistanceScanner->Enable();
+      m_pcDistanceScanner->SetRPM(m_pcRNG->Uniform(SCANNER_RPM_RANGE));
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_CONTROLLER(CTestController, "test_controller");
+
+}
@@ -0,0 +1,39 @@
+#include <argos3/core/control_interface/ci_controller.h>
+#include <argos3/core/utility/math/rng.h>
+
+namespace argos {
+   class CCI_DifferentialSteeringActuator;
+   class CCI_FootBotTurretActuator;
+   class CCI_FootBotDistanceScannerActuator;
+   class CCI_FootBotProximitySensor;
+}
+
+namespace argos {
+
+   class CTestController : public CCI_Controller {
+
+   public:
+
+      CTestController() :
+         m_pcWheels(nullptr),
+         m_pcTurret(nullptr),
+         m_pcDistanceScanner(nullptr),
+         m_pcProximity(nullptr),
+         m_pcRNG(nullptr) {}
+
+      virtual ~CTestController() {}
+
+      virtual void Init(TConfigurationNode& t_tree);
+
+      virtual void ControlStep();
+
+   private:
+
+      CCI_DifferentialSteeringActuator* m_pcWheels;
+      CCI_FootBotTurretActuator* m_pcTurret;
+      CCI_FootBotDistanceScannerActuator* m_pcDistanceScanner;
+      CCI_FootBotProximitySensor* m_pcProximity;
+      CRandom::CRNG* m_pcRNG;
+
+   };
+}
@@ -0,0 +1,79 @@
+#include "loop_functions.h"
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/plugins/robots/foot-bot/simulator/footbot_entity.h>
+#include <argos3/plugins/robots/foot-bot/simulator/footbot_turret_entity.h>
+#include <argos3/plugins/robots/foot-bot/simulator/footbot_distance_scanner_equipped_entity.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   const UInt32 CTestLoopFunctions::RUN_LENGTH = 30;
+
+   /****************************************/
+   /****************************************/
+
+   void CTestLoopFunctions::PostStep() {
+      /* Record the state of the robots, including the parts that are not in the snapshot */
+      CSpace::TMapPerType& tFootBots = GetSpace().GetEntitiesByType("foot-bot");
+      for(CSpace::TMapPerType::iterator it = tFootBots.begin();
+          it != tFootBots.end();
+          ++it) {
+         CFootBotEntity& cFootBot = *any_cast<CFootBotEntity*>(it->second);
+         const SAnchor& sOrigin = cFootBot.GetEmbodiedEntity().GetOriginAnchor();
+         CRadians cZ, cY, cX;
+         sOrigin.Orientation.ToEulerAngles(cZ, cY, cX);
+         m_tTrajectory.push_back(sOrigin.Position.GetX());
+         m_tTrajectory.push_back(sOrigin.Position.GetY());
+         m_tTrajectory.push_back(cZ.GetValue());
+         m_tTrajectory.push_back(cFootBot.GetTurretEntity().GetRotation().GetValue());
+         m_tTrajectory.push_back(cFootBot.GetDistanceScannerEquippedEntity().GetRotation().GetValue());
+      }
+      if(GetSpace().GetSimulationClock() < RUN_LENGTH) {
+         return;
+      }
+      CSimulator& cSimulator = CSimulator::GetInstance();
+      switch(m_unRun) {
+         case 0:
+            /* Run again after a full reset */
+            cSimulator.SetFastReset(false);
+            break;
+         case 1:
+            /* Run again after a fast reset */
+            m_tFullResetTrajectory.swap(m_tTrajectory);
+            cSimulator.SetFastReset(true);
+            break;
+         case 2:
+            /* The runs after the two resets must be the same */
+            if(m_tTrajectory.size() != m_tFullResetTrajectory.size()) {
+               THROW_ARGOSEXCEPTION("The run after the fast reset recorded " << m_tTrajectory.size() <<
+                                    " values instead of " << m_tFullResetTrajectory.size());
+            }
+            for(size_t i = 0; i < m_tTrajectory.size(); ++i) {
+               if(m_tTrajectory[i] != m_tFullResetTrajectory[i]) {
+                  THROW_ARGOSEXCEPTION("The run after the fast reset diverged at value " << i <<
+                                       ": " << m_tTrajectory[i] << " instead of " << m_tFullResetTrajectory[i]);
+               }
+            }
+            ++m_unRun;
+            return;
+      }
+      m_tTrajectory.clear();
+      ++m_unRun;
+      cSimulator.Reset();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CTestLoopFunctions::IsExperimentFinished() {
+      return m_unRun > 2;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_LOOP_FUNCTIONS(CTestLoopFunctions, "test_loop_functions");
+
+}
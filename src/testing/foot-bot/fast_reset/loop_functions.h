@@ -0,0 +1,38 @@
+#ifndef TEST_LOOP_FUNCTIONS_H
+#define TEST_LOOP_FUNCTIONS_H
+
+#include <argos3/core/simulator/loop_functions.h>
+
+namespace argos {
+
+   class CTestLoopFunctions : public CLoopFunctions {
+
+   public:
+
+      CTestLoopFunctions() :
+         m_unRun(0) {}
+
+      virtual ~CTestLoopFunctions() {}
+
+      virtual void PostStep() override;
+
+      virtual bool IsExperimentFinished() override;
+
+   private:
+
+      /* The state of the robots, step after step */
+      typedef std::vector<Real> TTrajectory;
+
+   private:
+
+      const static UInt32 RUN_LENGTH;
+
+      /* 0: after Init(), 1: after a full reset, 2: after a fast reset, 3: done */
+      UInt32 m_unRun;
+      TTrajectory m_tTrajectory;
+      TTrajectory m_tFullResetTrajectory;
+
+   };
+}
+
+#endif
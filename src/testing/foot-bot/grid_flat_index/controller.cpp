@@ -0,0 +1,25 @@
+#include "controller.h"
+
+#include <argos3/plugins/robots/generic/control_interface/ci_differential_steering_actuator.h>
+
+#include <functional>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   void CTestController::Init(TConfigurationNode& t_tree) {
+      /* Drive on circles of different radii, so that the robots cross the grid cells */
+      size_t unCurve = std::hash<std::string>()(GetId()) % 5;
+      CCI_DifferentialSteeringActuator* pcWheels =
+         GetActuator<CCI_DifferentialSteeringActuator>("differential_steering");
+      pcWheels->SetLinearVelocity(10.0, 6.0 + unCurve);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_CONTROLLER(CTestController, "test_controller");
+
+}
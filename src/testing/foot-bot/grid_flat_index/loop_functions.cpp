@@ -0,0 +1,140 @@
+#include "loop_functions.h"
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   /**
+    * Collects the entities visited by a range query, in the visiting order.
+    */
+   class CCollectLEDs : public CPositionalIndex<CLEDEntity>::COperation {
+
+   public:
+
+      virtual bool operator()(CLEDEntity& c_entity) {
+         Entities.push_back(&c_entity);
+         return true;
+      }
+
+      std::vector<CLEDEntity*> Entities;
+
+   };
+
+   /****************************************/
+   /****************************************/
+
+   CTestLoopFunctions::CTestLoopFunctions() :
+      m_pcGrid(nullptr),
+      m_pcGridUpdater(nullptr),
+      m_pcFlatGrid(nullptr),
+      m_pcFlatGridUpdater(nullptr) {}
+
+   /****************************************/
+   /****************************************/
+
+   void CTestLoopFunctions::Init(TConfigurationNode& t_tree) {
+      const CVector3& cArenaSize = GetSpace().GetArenaSize();
+      const CVector3& cArenaCenter = GetSpace().GetArenaCenter();
+      m_pcGrid = new CGrid<CLEDEntity>(
+         cArenaCenter - cArenaSize * 0.5, cArenaCenter + cArenaSize * 0.5,
+         8, 8, 2, false);
+      m_pcGridUpdater = new CLEDEntityGridUpdater(*m_pcGrid);
+      m_pcGrid->SetUpdateEntityOperation(m_pcGridUpdater);
+      m_pcFlatGrid = new CGrid<CLEDEntity>(
+         cArenaCenter - cArenaSize * 0.5, cArenaCenter + cArenaSize * 0.5,
+         8, 8, 2, true);
+      m_pcFlatGridUpdater = new CLEDEntityGridUpdater(*m_pcFlatGrid);
+      m_pcFlatGrid->SetUpdateEntityOperation(m_pcFlatGridUpdater);
+      /* Index the LEDs of all the robots in both grids */
+      CSpace::TMapPerType& tLEDs = GetSpace().GetEntitiesByType("led");
+      for(CSpace::TMapPerType::iterator it = tLEDs.begin(); it != tLEDs.end(); ++it) {
+         CLEDEntity* pcLED = any_cast<CLEDEntity*>(it->second);
+         m_vecLEDs.push_back(pcLED);
+         m_pcGrid->AddEntity(*pcLED);
+         m_pcFlatGrid->AddEntity(*pcLED);
+      }
+      if(m_vecLEDs.empty()) {
+         THROW_ARGOSEXCEPTION("No LED found in the arena");
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTestLoopFunctions::Destroy() {
+      delete m_pcGrid;
+      delete m_pcGridUpdater;
+      delete m_pcFlatGrid;
+      delete m_pcFlatGridUpdater;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTestLoopFunctions::PostStep() {
+      m_pcGrid->Update();
+      m_pcFlatGrid->Update();
+      /* Query around every LED, so that both crowded and empty cells are visited */
+      CVector3 cHalfSize(RANGE, RANGE, RANGE);
+      CVector2 cHalfArea(RANGE, RANGE);
+      for(size_t i = 0; i < m_vecLEDs.size(); ++i) {
+         const CVector3& cCenter = m_vecLEDs[i]->GetPosition();
+         CCollectLEDs cGrid, cFlatGrid;
+         m_pcGrid->ForEntitiesInSphereRange(cCenter, RANGE, cGrid);
+         m_pcFlatGrid->ForEntitiesInSphereRange(cCenter, RANGE, cFlatGrid);
+         CheckSameEntities("sphere", cGrid.Entities, cFlatGrid.Entities);
+         cGrid.Entities.clear();
+         cFlatGrid.Entities.clear();
+         m_pcGrid->ForEntitiesInBoxRange(cCenter, cHalfSize, cGrid);
+         m_pcFlatGrid->ForEntitiesInBoxRange(cCenter, cHalfSize, cFlatGrid);
+         CheckSameEntities("box", cGrid.Entities, cFlatGrid.Entities);
+         cGrid.Entities.clear();
+         cFlatGrid.Entities.clear();
+         m_pcGrid->ForEntitiesInCircleRange(cCenter, RANGE, cGrid);
+         m_pcFlatGrid->ForEntitiesInCircleRange(cCenter, RANGE, cFlatGrid);
+         CheckSameEntities("circle", cGrid.Entities, cFlatGrid.Entities);
+         cGrid.Entities.clear();
+         cFlatGrid.Entities.clear();
+         m_pcGrid->ForEntitiesInRectangleRange(cCenter, cHalfArea, cGrid);
+         m_pcFlatGrid->ForEntitiesInRectangleRange(cCenter, cHalfArea, cFlatGrid);
+         CheckSameEntities("rectangle", cGrid.Entities, cFlatGrid.Entities);
+      }
+      CCollectLEDs cGrid, cFlatGrid;
+      m_pcGrid->ForAllEntities(cGrid);
+      m_pcFlatGrid->ForAllEntities(cFlatGrid);
+      CheckSameEntities("all", cGrid.Entities, cFlatGrid.Entities);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CTestLoopFunctions::IsExperimentFinished() {
+      return GetSpace().GetSimulationClock() >= 50;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTestLoopFunctions::CheckSameEntities(const std::string& str_query,
+                                              const std::vector<CLEDEntity*>& vec_grid,
+                                              const std::vector<CLEDEntity*>& vec_flat_grid) {
+      if(vec_grid != vec_flat_grid) {
+         THROW_ARGOSEXCEPTION("At step " << GetSpace().GetSimulationClock() <<
+                              ", the " << str_query << " query returned " << vec_grid.size() <<
+                              " entities with the grid and " << vec_flat_grid.size() <<
+                              " with the flat grid, or in a different order");
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   const Real CTestLoopFunctions::RANGE = 0.4;
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_LOOP_FUNCTIONS(CTestLoopFunctions, "test_loop_functions");
+
+}
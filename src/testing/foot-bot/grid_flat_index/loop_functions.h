@@ -0,0 +1,48 @@
+#ifndef TEST_LOOP_FUNCTIONS_H
+#define TEST_LOOP_FUNCTIONS_H
+
+#include <argos3/core/simulator/loop_functions.h>
+#include <argos3/core/simulator/space/positional_indices/grid.h>
+#include <argos3/plugins/simulator/entities/led_entity.h>
+
+namespace argos {
+
+   class CTestLoopFunctions : public CLoopFunctions {
+
+   public:
+
+      CTestLoopFunctions();
+
+      virtual ~CTestLoopFunctions() {}
+
+      virtual void Init(TConfigurationNode& t_tree) override;
+
+      virtual void Destroy() override;
+
+      virtual void PostStep() override;
+
+      virtual bool IsExperimentFinished() override;
+
+   private:
+
+      void CheckSameEntities(const std::string& str_query,
+                             const std::vector<CLEDEntity*>& vec_grid,
+                             const std::vector<CLEDEntity*>& vec_flat_grid);
+
+   private:
+
+      /** Grid storing a set of entities per cell */
+      CGrid<CLEDEntity>* m_pcGrid;
+      CLEDEntityGridUpdater* m_pcGridUpdater;
+      /** Grid storing the cells in one array */
+      CGrid<CLEDEntity>* m_pcFlatGrid;
+      CLEDEntityGridUpdater* m_pcFlatGridUpdater;
+      /** The indexed entities */
+      std::vector<CLEDEntity*> m_vecLEDs;
+
+      const static Real RANGE;
+
+   };
+}
+
+#endif
@@ -0,0 +1,24 @@
+-- checks that the robots sharing a Lua state do not see each other
+local my_id = nil
+local local_steps = 0
+
+function init()
+   my_id = robot.id
+   local_steps = 0
+   -- a global of the script, which must be private to the robot
+   steps = 0
+end
+
+function step()
+   assert(robot.id == my_id, "robot refers to " .. robot.id .. " instead of " .. my_id)
+   local_steps = local_steps + 1
+   steps = steps + 1
+   assert(steps == local_steps, "the globals of " .. my_id .. " are shared")
+   robot.wheels.set_velocity(5, 5)
+end
+
+function reset()
+end
+
+function destroy()
+end
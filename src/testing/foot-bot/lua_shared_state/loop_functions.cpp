@@ -0,0 +1,75 @@
+#include "loop_functions.h"
+#include <argos3/plugins/robots/foot-bot/simulator/footbot_entity.h>
+#include <argos3/core/wrappers/lua/lua_controller.h>
+
+#include <set>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   void CTestLoopFunctions::Init(TConfigurationNode& t_tree) {
+      /* the scripts are loaded and initialized before the first step */
+      CheckControllers();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTestLoopFunctions::PreStep() {
+      /* a robot added during the experiment must not move the others to another thread */
+      if(GetSpace().GetSimulationClock() == 5) {
+         AddEntity(*new CFootBotEntity("fb_added",
+                                       "footbot_controller",
+                                       CVector3(0.0, 1.5, 0.0)));
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CTestLoopFunctions::IsExperimentFinished() {
+      /* wait ten ticks before evaluating the test */
+      if(GetSpace().GetSimulationClock() < 10) {
+         return false;
+      }
+      CheckControllers();
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTestLoopFunctions::CheckControllers() {
+      std::set<lua_State*> setStates;
+      CSpace::TMapPerType& tFootBots = GetSpace().GetEntitiesByType("foot-bot");
+      for(CSpace::TMapPerType::iterator it = tFootBots.begin();
+          it != tFootBots.end();
+          ++it) {
+         CFootBotEntity& cFootBot = *any_cast<CFootBotEntity*>(it->second);
+         CLuaController& cController =
+            dynamic_cast<CLuaController&>(cFootBot.GetControllableEntity().GetController());
+         if(!cController.IsOK()) {
+            THROW_ARGOSEXCEPTION("The script of \"" << cFootBot.GetId() <<
+                                 "\" failed: " << cController.GetErrorMessage());
+         }
+         if(cController.GetLuaState() == NULL) {
+            THROW_ARGOSEXCEPTION("The script of \"" << cFootBot.GetId() <<
+                                 "\" was not loaded");
+         }
+         setStates.insert(cController.GetLuaState());
+      }
+      /* one state per space thread */
+      if(setStates.size() != CSimulator::GetInstance().GetNumThreads()) {
+         THROW_ARGOSEXCEPTION("The robots use " << setStates.size() <<
+                              " Lua states instead of one per thread");
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_LOOP_FUNCTIONS(CTestLoopFunctions, "test_loop_functions");
+
+}
@@ -0,0 +1,40 @@
+-- checks how the range and bearing readings are exposed to the script
+local reuse = robot.params.reuse_readings == "true"
+local last_readings = nil
+
+checks = 0
+
+function init()
+   robot.range_and_bearing.set_data({1, 2, 3, 4, 5, 6, 7, 8, 9, 10})
+end
+
+function step()
+   local readings = robot.range_and_bearing
+   local first = readings[1]
+   if first == nil then
+      return
+   end
+   local data = first.data
+   if reuse then
+      assert(type(data) == "userdata", "data is not a byte array view")
+   else
+      assert(type(data) == "table", "data is not a table")
+      assert(table.unpack(data) == 1, "data cannot be unpacked")
+      if last_readings ~= nil then
+         assert(last_readings ~= first, "the reading table was reused")
+      end
+   end
+   assert(#data == 10, "data does not have ten bytes")
+   for i, byte in ipairs(data) do
+      assert(byte == i, "byte " .. i .. " does not match")
+   end
+   assert(data[11] == nil, "data has more than ten bytes")
+   last_readings = first
+   checks = checks + 1
+end
+
+function reset()
+end
+
+function destroy()
+end
@@ -0,0 +1,43 @@
+#include "loop_functions.h"
+#include <argos3/plugins/robots/foot-bot/simulator/footbot_entity.h>
+#include <argos3/core/wrappers/lua/lua_controller.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   bool CTestLoopFunctions::IsExperimentFinished() {
+      /* wait ten ticks before evaluating the test */
+      if(GetSpace().GetSimulationClock() < 10) {
+         return false;
+      }
+      CSpace::TMapPerType& tFootBots = GetSpace().GetEntitiesByType("foot-bot");
+      for(CSpace::TMapPerType::iterator it = tFootBots.begin();
+          it != tFootBots.end();
+          ++it) {
+         CFootBotEntity& cFootBot = *any_cast<CFootBotEntity*>(it->second);
+         CLuaController& cController =
+            dynamic_cast<CLuaController&>(cFootBot.GetControllableEntity().GetController());
+         if(!cController.IsOK()) {
+            THROW_ARGOSEXCEPTION("The script of \"" << cFootBot.GetId() <<
+                                 "\" failed: " << cController.GetErrorMessage());
+         }
+         /* the robots see each other, so the readings must have been checked */
+         lua_getglobal(cController.GetLuaState(), "checks");
+         lua_Integer nChecks = lua_tointeger(cController.GetLuaState(), -1);
+         lua_pop(cController.GetLuaState(), 1);
+         if(nChecks == 0) {
+            THROW_ARGOSEXCEPTION("The script of \"" << cFootBot.GetId() <<
+                                 "\" did not receive any message");
+         }
+      }
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_LOOP_FUNCTIONS(CTestLoopFunctions, "test_loop_functions");
+
+}
@@ -0,0 +1,25 @@
+#include "controller.h"
+
+#include <argos3/plugins/robots/generic/control_interface/ci_differential_steering_actuator.h>
+#include <argos3/plugins/robots/generic/control_interface/ci_leds_actuator.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   void CTestController::Init(TConfigurationNode& t_tree) {
+      CCI_DifferentialSteeringActuator* pcWheels =
+         GetActuator<CCI_DifferentialSteeringActuator>("differential_steering");
+      pcWheels->SetLinearVelocity(10.0, 10.0); // 10 cm per second forwards
+      CCI_LEDsActuator* pcLEDs =
+         GetActuator<CCI_LEDsActuator>("leds");
+      pcLEDs->SetAllColors(CColor::RED);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_CONTROLLER(CTestController, "test_controller");
+
+}
@@ -0,0 +1,62 @@
+#include "loop_functions.h"
+#include <argos3/core/simulator/recorder/trajectory_recorder.h>
+#include <argos3/core/simulator/recorder/trajectory_reader.h>
+#include <argos3/plugins/simulator/entities/led_trajectory_channel.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   bool CTestLoopFunctions::IsExperimentFinished() {
+      return GetSpace().GetSimulationClock() >= 100;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTestLoopFunctions::PostExperiment() {
+      /* Write the recorded steps and read them back */
+      GetSimulator().GetRecorder().Flush();
+      CTrajectoryReader cReader;
+      cReader.Open(GetSimulator().GetRecorder().GetFileName());
+      if(cReader.GetNumEntities() != 1 || cReader.GetEntityId(0) != "fb") {
+         THROW_ARGOSEXCEPTION("Robot was not recorded");
+      }
+      /* The initial state is recorded, then every step */
+      if(cReader.GetNumSteps() != 101 ||
+         cReader.GetClock(0) != 0 ||
+         cReader.GetClock(100) != 100) {
+         THROW_ARGOSEXCEPTION("Recorded " << cReader.GetNumSteps() << " steps instead of 101");
+      }
+      size_t unPose = cReader.GetChannelIndex("pose");
+      const float* pfStart = cReader.GetFloats(unPose, 0, 0);
+      const float* pfEnd = cReader.GetFloats(unPose, 100, 0);
+      if(Distance(CVector3(pfStart[0], pfStart[1], pfStart[2]), START_POSITION) > THRESHOLD ||
+         Distance(CVector3(pfEnd[0], pfEnd[1], pfEnd[2]), TARGET_POSITION) > THRESHOLD) {
+         THROW_ARGOSEXCEPTION("Recorded poses do not match the trajectory of the robot");
+      }
+      size_t unLEDs = cReader.GetChannelIndex("leds");
+      if(cReader.GetNumValues(unLEDs, 0) == 0 ||
+         CLEDTrajectoryChannel::DecodeColor(cReader.GetUInt32s(unLEDs, 100, 0)[0]) != CColor::RED) {
+         THROW_ARGOSEXCEPTION("Recorded LED colors do not match the robot");
+      }
+      size_t unProximity = cReader.GetChannelIndex("footbot_proximity");
+      if(cReader.GetNumValues(unProximity, 0) != 24) {
+         THROW_ARGOSEXCEPTION("Recorded " << cReader.GetNumValues(unProximity, 0) << " proximity readings instead of 24");
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   const CVector3 CTestLoopFunctions::START_POSITION = CVector3(-0.5, 0, 0);
+   const CVector3 CTestLoopFunctions::TARGET_POSITION = CVector3(0.5, 0, 0);
+   const Real CTestLoopFunctions::THRESHOLD = 0.01;
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_LOOP_FUNCTIONS(CTestLoopFunctions, "test_loop_functions");
+
+}
@@ -0,0 +1,29 @@
+#ifndef TEST_LOOP_FUNCTIONS_H
+#define TEST_LOOP_FUNCTIONS_H
+
+#include <argos3/core/simulator/loop_functions.h>
+
+namespace argos {
+
+   class CTestLoopFunctions : public CLoopFunctions {
+
+   public:
+
+      CTestLoopFunctions() {}
+
+      virtual ~CTestLoopFunctions() {}
+
+      virtual bool IsExperimentFinished() override;
+
+      virtual void PostExperiment() override;
+
+   private:
+
+      const static CVector3 START_POSITION;
+      const static CVector3 TARGET_POSITION;
+      const static Real THRESHOLD;
+
+   };
+}
+
+#endif